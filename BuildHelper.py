@@ -14,6 +14,7 @@ buildFlags = {}
 buildFlags['debug'] = True # True by default (at least for now)
 buildFlags['release'] = False
 buildFlags['useCef'] = True
+buildFlags['useLz4'] = False
 buildFlags['beautify'] = False
 buildFlags['clean'] = False
 buildFlags['build'] = 'debug'
@@ -39,6 +40,7 @@ def setup(ARGUMENTS):
 	
 	AddOption('--beautify', dest='beautify', action='store_true', help='Will \'beautify\' the source code using uncrustify.')
 	AddOption('--without-cef', dest='without-cef', action='store_true', help='Will compile glr without using Chromium Embedded Framework as the html gui system.')
+	AddOption('--with-lz4', dest='with-lz4', action='store_true', help='Will compile glr with LZ4 compression support for the terrain chunk store.')
 	AddOption('--build', dest='build', type='string', nargs=1, action='store', help='Set the build to compile:  release, debug (default), and release-with-debug')
 	AddOption('--compiler', dest='compiler', type='string', nargs=1, action='store', help='Set the compiler to use.')
 	
@@ -47,6 +49,8 @@ def setup(ARGUMENTS):
 	### Set and error check our build flags
 	if (GetOption('without-cef') is True):
 		buildFlags['useCef'] = False
+	if (GetOption('with-lz4') is True):
+		buildFlags['useLz4'] = True
 	if (GetOption('beautify') is True):
 		buildFlags['beautify'] = True
 	if (GetOption('clean') is True):
@@ -69,6 +73,8 @@ def setup(ARGUMENTS):
 	
 	if (buildFlags['useCef']):
 		cpp_defines.append('USE_CEF')
+	if (buildFlags['useLz4']):
+		cpp_defines.append('USE_LZ4')
 	if (buildFlags['build'] == 'debug' or buildFlags['build'] == 'release-with-debug'):
 		pass
 		#cpp_defines.append('DEBUG')
@@ -0,0 +1,15 @@
+import subprocess, sys, os
+import shlex
+
+args = ''
+for arg in sys.argv:
+	if (arg != 'benchmarks/build_and_run.py' and arg != 'build_and_run.py'):
+		args += ' ' + arg
+
+subprocess.call( 'scons ' + args, shell=True)
+
+print("Running Benchmarks")
+
+os.chdir( 'build/' )
+subprocess.call( "./glr_benchmarks" )
+
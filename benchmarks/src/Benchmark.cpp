@@ -0,0 +1,84 @@
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <cmath>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+
+std::atomic<glm::detail::uint64> allocationCount(0);
+
+}
+
+void* operator new(std::size_t size)
+{
+	allocationCount++;
+	
+	void* p = std::malloc(size == 0 ? 1 : size);
+	if (p == nullptr)
+		throw std::bad_alloc();
+	
+	return p;
+}
+
+void* operator new[](std::size_t size)
+{
+	allocationCount++;
+	
+	void* p = std::malloc(size == 0 ? 1 : size);
+	if (p == nullptr)
+		throw std::bad_alloc();
+	
+	return p;
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	std::free(p);
+}
+
+namespace benchmark
+{
+
+glm::detail::uint64 getAllocationCount()
+{
+	return allocationCount;
+}
+
+void resetAllocationCount()
+{
+	allocationCount = 0;
+}
+
+void report(const std::string& suite, const std::string& name, glm::detail::float64 value, const std::string& unit)
+{
+	std::cout << "[" << suite << "] " << name << " = " << std::fixed << std::setprecision(3) << value << " " << unit << std::endl;
+}
+
+glm::detail::float32 HillsFieldFunction::getNoise(glm::detail::float32 x, glm::detail::float32 y, glm::detail::float32 z)
+{
+	const glm::detail::float32 height = 8.0f * std::sin(x * 0.05f) + 8.0f * std::cos(z * 0.07f) + 2.0f * std::sin((x + z) * 0.21f);
+	
+	return y - height;
+}
+
+const glm::detail::float32 HillsFieldFunction::MAX_HEIGHT = 18.0f;
+
+bool HillsFieldFunction::getRange(const glm::vec3& min, const glm::vec3& max, glm::detail::float32& minValue, glm::detail::float32& maxValue)
+{
+	minValue = min.y - MAX_HEIGHT;
+	maxValue = max.y + MAX_HEIGHT;
+	
+	return true;
+}
+
+}
@@ -0,0 +1,76 @@
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <string>
+#include <chrono>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "terrain/IFieldFunction.hpp"
+
+namespace benchmark
+{
+
+/**
+ * Returns the number of calls to the global operator new since the program started (or since the last call to 
+ * resetAllocationCount()).
+ * 
+ * The global operator new is replaced in Benchmark.cpp, so this also counts allocations made inside the glr library.
+ */
+glm::detail::uint64 getAllocationCount();
+void resetAllocationCount();
+
+/**
+ * Simple wall clock timer.
+ */
+class Timer
+{
+public:
+	Timer() : start_(std::chrono::high_resolution_clock::now())
+	{
+	}
+	
+	void restart()
+	{
+		start_ = std::chrono::high_resolution_clock::now();
+	}
+	
+	glm::detail::float64 getElapsedMilliseconds() const
+	{
+		auto duration = std::chrono::high_resolution_clock::now() - start_;
+		return std::chrono::duration<glm::detail::float64, std::milli>(duration).count();
+	}
+
+private:
+	std::chrono::high_resolution_clock::time_point start_;
+};
+
+/**
+ * Prints a single benchmark result line (i.e. "[terrain] density grid: time per chunk = 0.32 ms").
+ */
+void report(const std::string& suite, const std::string& name, glm::detail::float64 value, const std::string& unit);
+
+/**
+ * A cheap, deterministic field function that produces rolling hills, with a few overhangs.  Benchmarks use this so that results
+ * don't depend on an external noise library.
+ */
+class HillsFieldFunction : public glr::terrain::IFieldFunction
+{
+public:
+	virtual ~HillsFieldFunction()
+	{
+	}
+	
+	// Defined in Benchmark.cpp, so that no benchmark gets an unfair advantage from inlining it
+	virtual glm::detail::float32 getNoise(glm::detail::float32 x, glm::detail::float32 y, glm::detail::float32 z);
+	
+	// The height of the hills is always between -MAX_HEIGHT and MAX_HEIGHT
+	virtual bool getRange(const glm::vec3& min, const glm::vec3& max, glm::detail::float32& minValue, glm::detail::float32& maxValue);
+	
+	static const glm::detail::float32 MAX_HEIGHT;
+};
+
+}
+
+#endif /* BENCHMARK_H_ */
@@ -0,0 +1,98 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "Benchmark.hpp"
+
+#include "terrain/VoxelChunk.hpp"
+#include "terrain/VoxelChunkNoiseGenerator.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+// Tall enough that most chunks are far above or below the hills
+const glm::ivec3 DIMENSIONS = glm::ivec3(8, 8, 8);
+
+}
+
+BOOST_AUTO_TEST_SUITE(chunkClassification)
+
+BOOST_AUTO_TEST_CASE(sampleVsClassify)
+{
+	auto fieldFunction = benchmark::HillsFieldFunction();
+	const glmd::int32 numberOfChunks = DIMENSIONS.x * DIMENSIONS.y * DIMENSIONS.z;
+
+	// Before: every chunk's density field is sampled, only to find out that most of them have no surface
+	glmd::uint32 sampledHomogeneousChunks = 0;
+	glmd::uint32 pointsPerChunk = 0;
+
+	auto timer = benchmark::Timer();
+	for (glmd::int32 x=0; x < DIMENSIONS.x; x++)
+	{
+		for (glmd::int32 y=0; y < DIMENSIONS.y; y++)
+		{
+			for (glmd::int32 z=0; z < DIMENSIONS.z; z++)
+			{
+				auto chunk = glr::terrain::VoxelChunk(x, y, z);
+				glr::terrain::generateNoise(chunk, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, fieldFunction);
+				pointsPerChunk = chunk.points.getNumberOfPoints();
+
+				if (glr::terrain::determineIfEmptyOrSolid(chunk))
+					sampledHomogeneousChunks++;
+			}
+		}
+	}
+	const glmd::float64 sampleTime = timer.getElapsedMilliseconds();
+
+	// After: the field function's range classifies chunks first, and only the rest are sampled
+	glmd::uint32 classifiedChunks = 0;
+	glmd::uint32 classifiedHomogeneousChunks = 0;
+	glmd::uint32 numberOfDensityGrids = 0;
+
+	timer.restart();
+	for (glmd::int32 x=0; x < DIMENSIONS.x; x++)
+	{
+		for (glmd::int32 y=0; y < DIMENSIONS.y; y++)
+		{
+			for (glmd::int32 z=0; z < DIMENSIONS.z; z++)
+			{
+				auto chunk = glr::terrain::VoxelChunk(x, y, z);
+
+				if (glr::terrain::classifyChunk(chunk, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, fieldFunction))
+				{
+					classifiedChunks++;
+					classifiedHomogeneousChunks++;
+					continue;
+				}
+
+				glr::terrain::generateNoise(chunk, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, fieldFunction);
+				numberOfDensityGrids++;
+
+				if (glr::terrain::determineIfEmptyOrSolid(chunk))
+					classifiedHomogeneousChunks++;
+			}
+		}
+	}
+	const glmd::float64 classifyTime = timer.getElapsedMilliseconds();
+
+	// Classification is conservative, so it must never change the outcome
+	BOOST_CHECK_EQUAL( sampledHomogeneousChunks, classifiedHomogeneousChunks );
+	BOOST_CHECK( classifiedChunks > 0 );
+
+	benchmark::report("chunkClassification", "chunks", (glmd::float64)numberOfChunks, "chunks");
+	benchmark::report("chunkClassification", "empty or solid chunks", (glmd::float64)sampledHomogeneousChunks, "chunks");
+	benchmark::report("chunkClassification", "sample all: time", sampleTime, "ms");
+	benchmark::report("chunkClassification", "sample all: density memory allocated", (glmd::float64)numberOfChunks * pointsPerChunk * sizeof(glmd::float32) / 1024.0, "KB");
+	benchmark::report("chunkClassification", "classify first: chunks never sampled", (glmd::float64)classifiedChunks, "chunks");
+	benchmark::report("chunkClassification", "classify first: time", classifyTime, "ms");
+	benchmark::report("chunkClassification", "classify first: density memory allocated", (glmd::float64)numberOfDensityGrids * pointsPerChunk * sizeof(glmd::float32) / 1024.0, "KB");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
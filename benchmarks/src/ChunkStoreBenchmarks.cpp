@@ -0,0 +1,124 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <cstdio>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "Benchmark.hpp"
+
+#include "terrain/ChunkStoreReader.hpp"
+#include "terrain/ChunkStoreWriter.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const std::string FILENAME = "chunk_store_benchmarks.glrs";
+
+const glmd::int32 WORLD_SIZE = 8;
+const glmd::uint32 VERTICES_PER_CHUNK = 1500;
+
+// Chunks read one at a time, in an order that jumps around the file
+const glmd::uint32 NUMBER_OF_RANDOM_READS = 64;
+
+glr::terrain::ChunkMeshData createMesh(const glm::ivec3& coordinates)
+{
+	glr::terrain::ChunkMeshData mesh = glr::terrain::ChunkMeshData();
+
+	for (glmd::uint32 i=0; i < VERTICES_PER_CHUNK; i++)
+	{
+		const glm::vec3 v = glm::vec3( (glmd::float32)(i % 16), (glmd::float32)coordinates.y + (glmd::float32)(i % 7) * 0.5f, (glmd::float32)(i / 16) );
+
+		mesh.vertices.push_back( v );
+		mesh.normals.push_back( glm::vec3(0.0f, 1.0f, 0.0f) );
+		mesh.textureBlendingValues.push_back( glm::vec4(1.0f, 0.0f, 0.0f, 0.0f) );
+		mesh.indices.push_back( i );
+		mesh.indices.push_back( (i + 1) % VERTICES_PER_CHUNK );
+	}
+
+	return mesh;
+}
+
+glm::ivec3 getCell(glmd::int32 index)
+{
+	return glm::ivec3( index / (WORLD_SIZE * WORLD_SIZE), (index / WORLD_SIZE) % WORLD_SIZE, index % WORLD_SIZE );
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(chunkStore)
+
+BOOST_AUTO_TEST_CASE(writeAndRandomAccessRead)
+{
+	const glmd::int32 numberOfChunks = WORLD_SIZE * WORLD_SIZE * WORLD_SIZE;
+
+	auto meshes = std::vector<glr::terrain::ChunkMeshData>();
+	for (glmd::int32 i=0; i < numberOfChunks; i++)
+	{
+		meshes.push_back( createMesh(getCell(i)) );
+	}
+
+	// Write every chunk
+	auto timer = benchmark::Timer();
+	{
+		glr::terrain::ChunkStoreWriter writer(FILENAME, glr::terrain::CHUNK_COMPRESSION_LZ4, false);
+
+		for (glmd::int32 i=0; i < numberOfChunks; i++)
+		{
+			writer.writeMesh( getCell(i), glr::terrain::LOD_HIGH, meshes[i] );
+		}
+	}
+	const glmd::float64 writeTime = timer.getElapsedMilliseconds();
+
+	// Load every chunk, in file order (what TerrainManager::deserialize used to have to do)
+	glmd::uint64 totalVertices = 0;
+
+	timer.restart();
+	{
+		glr::terrain::ChunkStoreReader reader(FILENAME);
+		glr::terrain::ChunkMeshData mesh = glr::terrain::ChunkMeshData();
+
+		for (glmd::int32 i=0; i < numberOfChunks; i++)
+		{
+			reader.readMesh( getCell(i), mesh );
+			totalVertices += mesh.vertices.size();
+		}
+	}
+	const glmd::float64 readAllTime = timer.getElapsedMilliseconds();
+
+	// Open the store, and read single chunks from all over the file (i.e. the chunks around the camera)
+	glmd::uint64 randomVertices = 0;
+
+	timer.restart();
+	{
+		glr::terrain::ChunkStoreReader reader(FILENAME);
+		glr::terrain::ChunkMeshData mesh = glr::terrain::ChunkMeshData();
+
+		for (glmd::uint32 i=0; i < NUMBER_OF_RANDOM_READS; i++)
+		{
+			reader.readMesh( getCell((i * 97) % numberOfChunks), mesh );
+			randomVertices += mesh.vertices.size();
+		}
+	}
+	const glmd::float64 randomReadTime = timer.getElapsedMilliseconds();
+
+	BOOST_CHECK_EQUAL( totalVertices, (glmd::uint64)numberOfChunks * VERTICES_PER_CHUNK );
+	BOOST_CHECK_EQUAL( randomVertices, (glmd::uint64)NUMBER_OF_RANDOM_READS * VERTICES_PER_CHUNK );
+
+	std::remove( FILENAME.c_str() );
+
+	benchmark::report("chunkStore", "chunks", (glmd::float64)numberOfChunks, "chunks");
+	benchmark::report("chunkStore", "write: time per chunk", writeTime / numberOfChunks, "ms");
+	benchmark::report("chunkStore", "read all: time per chunk", readAllTime / numberOfChunks, "ms");
+	benchmark::report("chunkStore", "read all: total time", readAllTime, "ms");
+	benchmark::report("chunkStore", "random access: time to first " + std::to_string(NUMBER_OF_RANDOM_READS) + " chunks", randomReadTime, "ms");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
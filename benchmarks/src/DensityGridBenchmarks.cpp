@@ -0,0 +1,184 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "Benchmark.hpp"
+
+#include "terrain/Constants.hpp"
+#include "terrain/VoxelChunk.hpp"
+#include "terrain/VoxelChunkNoiseGenerator.hpp"
+#include "terrain/marching_cubes/VoxelChunkMeshGenerator.hpp"
+
+namespace glmd = glm::detail;
+namespace constants = glr::terrain::constants;
+
+namespace
+{
+
+const glmd::int32 WORLD_SIZE = 8;
+
+// The density field layout used before DensityGrid was introduced
+typedef std::vector< std::vector< std::vector<glmd::float32> > > NestedPoints;
+
+void generateNestedNoise(NestedPoints& points, glmd::int32 gridX, glmd::int32 gridY, glmd::int32 gridZ, glr::terrain::IFieldFunction& fieldFunction)
+{
+	const glmd::int32 max = constants::SIZE + constants::POINT_FIELD_OFFSET + constants::POINT_FIELD_OVERSET;
+
+	points.resize(max);
+	for (glmd::int32 i = 0; i < max; i++)
+	{
+		points[i].resize(max);
+		for (glmd::int32 j = 0; j < max; j++)
+			points[i][j].resize(max);
+	}
+
+	const glmd::float32 center = (glmd::float32)(constants::SIZE * WORLD_SIZE/2);
+
+	for (glmd::int32 x=-constants::POINT_FIELD_OFFSET; x < constants::SIZE + constants::POINT_FIELD_OVERSET; x++)
+	{
+		for (glmd::int32 y=-constants::POINT_FIELD_OFFSET; y < constants::SIZE + constants::POINT_FIELD_OVERSET; y++)
+		{
+			for (glmd::int32 z=-constants::POINT_FIELD_OFFSET; z < constants::SIZE + constants::POINT_FIELD_OVERSET; z++)
+			{
+				const glmd::float32 fx = (glmd::float32)(gridX * constants::SIZE + x) - center;
+				const glmd::float32 fy = (glmd::float32)(gridY * constants::SIZE + y) - center;
+				const glmd::float32 fz = (glmd::float32)(gridZ * constants::SIZE + z) - center;
+
+				points[x + constants::POINT_FIELD_OFFSET][y + constants::POINT_FIELD_OFFSET][z + constants::POINT_FIELD_OFFSET] = fieldFunction.getNoise(fx, fy, fz) + constants::EPSILON_DENSITY;
+			}
+		}
+	}
+}
+
+glmd::float32 sumNestedPoints(const NestedPoints& points)
+{
+	glmd::float32 sum = 0.0f;
+
+	for (auto& i : points)
+		for (auto& j : i)
+			for (auto& k : j)
+				sum += k;
+
+	return sum;
+}
+
+glmd::float32 sumDensityGrid(const glr::terrain::DensityGrid& points)
+{
+	glmd::float32 sum = 0.0f;
+
+	for (glmd::int32 x=points.getMin(); x < points.getMax(); x++)
+		for (glmd::int32 y=points.getMin(); y < points.getMax(); y++)
+			for (glmd::int32 z=points.getMin(); z < points.getMax(); z++)
+				sum += points.get(x, y, z);
+
+	return sum;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(densityGrid)
+
+BOOST_AUTO_TEST_CASE(nestedVectorVsDensityGrid)
+{
+	auto fieldFunction = benchmark::HillsFieldFunction();
+	const glmd::int32 numberOfChunks = WORLD_SIZE * WORLD_SIZE * WORLD_SIZE;
+
+	glmd::float32 nestedSum = 0.0f;
+	glmd::float32 gridSum = 0.0f;
+
+	// Before: triple nested std::vector
+	benchmark::resetAllocationCount();
+	auto timer = benchmark::Timer();
+	for (glmd::int32 x=0; x < WORLD_SIZE; x++)
+	{
+		for (glmd::int32 y=0; y < WORLD_SIZE; y++)
+		{
+			for (glmd::int32 z=0; z < WORLD_SIZE; z++)
+			{
+				auto points = NestedPoints();
+				generateNestedNoise(points, x, y, z, fieldFunction);
+				nestedSum += sumNestedPoints(points);
+			}
+		}
+	}
+	const glmd::float64 nestedTime = timer.getElapsedMilliseconds();
+	const glmd::uint64 nestedAllocations = benchmark::getAllocationCount();
+
+	// After: DensityGrid
+	benchmark::resetAllocationCount();
+	timer.restart();
+	for (glmd::int32 x=0; x < WORLD_SIZE; x++)
+	{
+		for (glmd::int32 y=0; y < WORLD_SIZE; y++)
+		{
+			for (glmd::int32 z=0; z < WORLD_SIZE; z++)
+			{
+				auto chunk = glr::terrain::VoxelChunk(x, y, z);
+				glr::terrain::generateNoise(chunk, WORLD_SIZE, WORLD_SIZE, WORLD_SIZE, fieldFunction);
+				gridSum += sumDensityGrid(chunk.points);
+			}
+		}
+	}
+	const glmd::float64 gridTime = timer.getElapsedMilliseconds();
+	const glmd::uint64 gridAllocations = benchmark::getAllocationCount();
+
+	// Both layouts must hold the same density values
+	BOOST_CHECK_CLOSE( nestedSum, gridSum, 0.001f );
+	BOOST_CHECK( gridAllocations < nestedAllocations );
+
+	benchmark::report("densityGrid", "nested vector: allocations per chunk", (glmd::float64)nestedAllocations / numberOfChunks, "allocations");
+	benchmark::report("densityGrid", "nested vector: time per chunk", nestedTime / numberOfChunks, "ms");
+	benchmark::report("densityGrid", "density grid: allocations per chunk", (glmd::float64)gridAllocations / numberOfChunks, "allocations");
+	benchmark::report("densityGrid", "density grid: time per chunk", gridTime / numberOfChunks, "ms");
+}
+
+BOOST_AUTO_TEST_CASE(marchingCubesMeshGeneration)
+{
+	auto fieldFunction = benchmark::HillsFieldFunction();
+	auto meshGenerator = glr::terrain::marching_cubes::VoxelChunkMeshGenerator();
+
+	glmd::int32 numberOfChunks = 0;
+	glmd::uint64 numberOfVertices = 0;
+	glmd::float64 meshTime = 0.0;
+
+	for (glmd::int32 x=0; x < WORLD_SIZE; x++)
+	{
+		for (glmd::int32 y=0; y < WORLD_SIZE; y++)
+		{
+			for (glmd::int32 z=0; z < WORLD_SIZE; z++)
+			{
+				auto chunk = glr::terrain::VoxelChunk(x, y, z);
+				glr::terrain::generateNoise(chunk, WORLD_SIZE, WORLD_SIZE, WORLD_SIZE, fieldFunction);
+
+				if (glr::terrain::determineIfEmptyOrSolid(chunk))
+					continue;
+
+				auto vertices = std::vector< glm::vec3 >();
+				auto normals = std::vector< glm::vec3 >();
+				auto textureBlendingValues = std::vector< glm::vec4 >();
+
+				auto timer = benchmark::Timer();
+				meshGenerator.generateMesh(chunk, WORLD_SIZE, WORLD_SIZE, WORLD_SIZE, vertices, normals, textureBlendingValues);
+				meshTime += timer.getElapsedMilliseconds();
+
+				numberOfVertices += vertices.size();
+				numberOfChunks++;
+			}
+		}
+	}
+
+	BOOST_CHECK( numberOfChunks > 0 );
+	BOOST_CHECK( numberOfVertices > 0 );
+
+	benchmark::report("densityGrid", "marching cubes: surface chunks", (glmd::float64)numberOfChunks, "chunks");
+	benchmark::report("densityGrid", "marching cubes: time per surface chunk", meshTime / numberOfChunks, "ms");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
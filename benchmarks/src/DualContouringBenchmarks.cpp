@@ -0,0 +1,240 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "Benchmark.hpp"
+
+#include "terrain/TerrainSettings.hpp"
+#include "terrain/VoxelChunk.hpp"
+#include "terrain/VoxelChunkNoiseGenerator.hpp"
+#include "terrain/dual_contouring/Qef.hpp"
+#include "terrain/dual_contouring/QefSolver.hpp"
+#include "terrain/dual_contouring/VoxelChunkMeshGenerator.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const glm::ivec3 DIMENSIONS = glm::ivec3(8, 4, 8);
+
+const glmd::uint32 NUMBER_OF_CELLS = 100000;
+
+/**
+ * Counts the samples taken from the hills.
+ */
+class CountingFieldFunction : public glr::terrain::IFieldFunction
+{
+public:
+	CountingFieldFunction() : numberOfSamples(0)
+	{
+	}
+
+	virtual glmd::float32 getNoise(glmd::float32 x, glmd::float32 y, glmd::float32 z)
+	{
+		numberOfSamples++;
+		return hills_.getNoise(x, y, z);
+	}
+
+	virtual void getNoiseBatch(const glmd::float32* x, const glmd::float32* y, const glmd::float32* z, glmd::float32* densities, glmd::uint32 count)
+	{
+		numberOfSamples += count;
+		hills_.getNoiseBatch(x, y, z, densities, count);
+	}
+
+	glmd::uint64 numberOfSamples;
+
+private:
+	benchmark::HillsFieldFunction hills_;
+};
+
+/**
+ * The intersection points and normals of a block.
+ */
+struct Cell
+{
+	glm::vec3 points[12];
+	glm::vec3 normals[12];
+	glmd::int32 count;
+};
+
+/**
+ * Returns cells that are cut by 3 to 6 random planes through points near the center of the cell (a block that the surface passes
+ * through always has at least 3 intersections).
+ */
+std::vector<Cell> createCells()
+{
+	auto cells = std::vector<Cell>( NUMBER_OF_CELLS );
+
+	std::mt19937 generator( 12345 );
+	std::uniform_real_distribution<glmd::float32> unit( -1.0f, 1.0f );
+	std::uniform_int_distribution<glmd::int32> numberOfPlanes( 3, 6 );
+
+	for ( auto& cell : cells )
+	{
+		cell.count = numberOfPlanes(generator);
+
+		for (glmd::int32 i=0; i < cell.count; i++)
+		{
+			cell.points[i] = glm::vec3( unit(generator), unit(generator), unit(generator) ) * 0.5f + glm::vec3(0.5f);
+
+			glm::vec3 normal = glm::vec3( unit(generator), unit(generator), unit(generator) );
+
+			if (glm::length(normal) < 0.01f)
+				normal = glm::vec3(0.0f, 1.0f, 0.0f);
+
+			cell.normals[i] = glm::normalize(normal);
+		}
+	}
+
+	return cells;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(dualContouring)
+
+BOOST_AUTO_TEST_CASE(qefSolver)
+{
+	const auto cells = createCells();
+
+	auto oldResults = std::vector< glm::vec3 >( cells.size() );
+	auto newResults = std::vector< glm::vec3 >( cells.size() );
+
+	// Before: the float64 SVD (Qef.cpp), fed an (intersections x 3) matrix relative to the mass point
+	auto timer = benchmark::Timer();
+	for (glmd::uint32 c=0; c < cells.size(); c++)
+	{
+		const Cell& cell = cells[c];
+
+		glm::vec3 massPoint = glm::vec3();
+		for (glmd::int32 i=0; i < cell.count; i++)
+			massPoint += cell.points[i];
+		massPoint /= (glmd::float32)cell.count;
+
+		glmd::float64 matrix[12][3];
+		glmd::float64 vector[12];
+
+		for (glmd::int32 i=0; i < cell.count; i++)
+		{
+			matrix[i][0] = cell.normals[i].x;
+			matrix[i][1] = cell.normals[i].y;
+			matrix[i][2] = cell.normals[i].z;
+			vector[i] = (glmd::float64)glm::dot(cell.normals[i], cell.points[i] - massPoint);
+		}
+
+		oldResults[c] = glr::terrain::dual_contouring::evaluate(matrix, vector, cell.count) + massPoint;
+	}
+	const glmd::float64 oldTime = timer.getElapsedMilliseconds();
+
+	// After: the float32 Jacobi solver, accumulated on the stack
+	timer.restart();
+	for (glmd::uint32 c=0; c < cells.size(); c++)
+	{
+		const Cell& cell = cells[c];
+
+		auto qef = glr::terrain::dual_contouring::QefSolver();
+
+		for (glmd::int32 i=0; i < cell.count; i++)
+			qef.add(cell.points[i], cell.normals[i]);
+
+		newResults[c] = qef.solve();
+	}
+	const glmd::float64 newTime = timer.getElapsedMilliseconds();
+
+	// When no singular value is near the cut off, both solvers find the exact minimizer.  Otherwise, the old solver can leave part of
+	// the solution along a dropped direction, so the results aren't compared.
+	glmd::uint32 numberOfComparedCells = 0;
+	glmd::float32 maxDifference = 0.0f;
+
+	for (glmd::uint32 c=0; c < cells.size(); c++)
+	{
+		const Cell& cell = cells[c];
+
+		glmd::float64 matrix[12][3];
+		for (glmd::int32 i=0; i < cell.count; i++)
+		{
+			matrix[i][0] = cell.normals[i].x;
+			matrix[i][1] = cell.normals[i].y;
+			matrix[i][2] = cell.normals[i].z;
+		}
+
+		glmd::float64 u[12][3], v[3][3], d[3];
+		glr::terrain::dual_contouring::computeSVD(matrix, u, v, d, cell.count);
+
+		if (std::min(d[0], std::min(d[1], d[2])) < 0.2)
+			continue;
+
+		maxDifference = std::max( maxDifference, glm::length(oldResults[c] - newResults[c]) );
+		numberOfComparedCells++;
+	}
+
+	BOOST_CHECK( numberOfComparedCells > 0 );
+	BOOST_CHECK( maxDifference < 0.001f );
+
+	benchmark::report("dualContouring", "cells", (glmd::float64)cells.size(), "cells");
+	benchmark::report("dualContouring", "svd (float64): time per solve", oldTime * 1000000.0 / cells.size(), "ns");
+	benchmark::report("dualContouring", "jacobi (float32): time per solve", newTime * 1000000.0 / cells.size(), "ns");
+	benchmark::report("dualContouring", "max difference between solutions (well conditioned cells)", maxDifference, "units");
+}
+
+BOOST_AUTO_TEST_CASE(meshingTime)
+{
+	auto fieldFunction = CountingFieldFunction();
+	auto meshGenerator = glr::terrain::dual_contouring::VoxelChunkMeshGenerator( &fieldFunction, glr::terrain::TerrainSettings() );
+
+	glmd::uint32 numberOfSurfaceChunks = 0;
+	glmd::uint64 numberOfTriangles = 0;
+	glmd::uint64 numberOfMeshingSamples = 0;
+	glmd::float64 meshingTime = 0.0;
+
+	for (glmd::int32 x=0; x < DIMENSIONS.x; x++)
+	{
+		for (glmd::int32 y=0; y < DIMENSIONS.y; y++)
+		{
+			for (glmd::int32 z=0; z < DIMENSIONS.z; z++)
+			{
+				auto chunk = glr::terrain::VoxelChunk(x, y, z);
+				glr::terrain::generateNoise(chunk, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, fieldFunction);
+
+				if (glr::terrain::determineIfEmptyOrSolid(chunk))
+					continue;
+
+				auto vertices = std::vector< glm::vec3 >();
+				auto normals = std::vector< glm::vec3 >();
+				auto textureBlendingValues = std::vector< glm::vec4 >();
+				auto indices = std::vector< glmd::uint32 >();
+
+				// Only the samples taken while meshing (i.e. to find edge intersections and normals) are counted
+				const glmd::uint64 samplesBefore = fieldFunction.numberOfSamples;
+
+				auto timer = benchmark::Timer();
+				meshGenerator.generateMesh(chunk, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, vertices, normals, textureBlendingValues, indices);
+				meshingTime += timer.getElapsedMilliseconds();
+
+				numberOfMeshingSamples += fieldFunction.numberOfSamples - samplesBefore;
+				numberOfTriangles += indices.size() / 3;
+				numberOfSurfaceChunks++;
+			}
+		}
+	}
+
+	BOOST_CHECK( numberOfSurfaceChunks > 0 );
+	BOOST_CHECK( numberOfTriangles > 0 );
+
+	benchmark::report("dualContouring", "surface chunks", (glmd::float64)numberOfSurfaceChunks, "chunks");
+	benchmark::report("dualContouring", "triangles per chunk", (glmd::float64)numberOfTriangles / numberOfSurfaceChunks, "triangles");
+	benchmark::report("dualContouring", "field function samples per chunk", (glmd::float64)numberOfMeshingSamples / numberOfSurfaceChunks, "samples");
+	benchmark::report("dualContouring", "meshing time per chunk", meshingTime / numberOfSurfaceChunks, "ms");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
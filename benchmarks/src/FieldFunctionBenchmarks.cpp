@@ -0,0 +1,127 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "Benchmark.hpp"
+
+#include "terrain/SimplexNoiseFieldFunction.hpp"
+#include "terrain/VoxelChunk.hpp"
+#include "terrain/VoxelChunkNoiseGenerator.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const glmd::int32 WORLD_SIZE = 4;
+
+/**
+ * Hides the batch implementation of the field function it wraps, so that the density field is filled one virtual getNoise() call
+ * at a time (i.e. how it was done before getNoiseBatch() existed).
+ */
+class ScalarOnlyFieldFunction : public glr::terrain::IFieldFunction
+{
+public:
+	ScalarOnlyFieldFunction(glr::terrain::IFieldFunction& fieldFunction) : fieldFunction_(fieldFunction)
+	{
+	}
+
+	virtual glmd::float32 getNoise(glmd::float32 x, glmd::float32 y, glmd::float32 z)
+	{
+		return fieldFunction_.getNoise(x, y, z);
+	}
+
+private:
+	glr::terrain::IFieldFunction& fieldFunction_;
+};
+
+std::string getName(glr::terrain::SimdInstructionSet instructionSet)
+{
+	switch (instructionSet)
+	{
+		case glr::terrain::SIMD_AVX2:
+			return "avx2";
+		case glr::terrain::SIMD_SSE4_1:
+			return "sse4.1";
+		default:
+			return "scalar";
+	}
+}
+
+/**
+ * Generates the density field for WORLD_SIZE^3 chunks.
+ *
+ * @return The number of samples per second.
+ */
+glmd::float64 generateWorld(glr::terrain::IFieldFunction& fieldFunction, glmd::float64& checksum)
+{
+	auto chunk = glr::terrain::VoxelChunk();
+	glmd::uint64 numberOfSamples = 0;
+
+	auto timer = benchmark::Timer();
+	for (glmd::int32 x=0; x < WORLD_SIZE; x++)
+	{
+		for (glmd::int32 y=0; y < WORLD_SIZE; y++)
+		{
+			for (glmd::int32 z=0; z < WORLD_SIZE; z++)
+			{
+				chunk.gridX = x;
+				chunk.gridY = y;
+				chunk.gridZ = z;
+
+				glr::terrain::generateNoise(chunk, WORLD_SIZE, WORLD_SIZE, WORLD_SIZE, fieldFunction);
+
+				numberOfSamples += chunk.points.getNumberOfPoints();
+				checksum += chunk.points.getData()[numberOfSamples % chunk.points.getNumberOfPoints()];
+			}
+		}
+	}
+	const glmd::float64 time = timer.getElapsedMilliseconds();
+
+	return numberOfSamples / (time / 1000.0);
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(fieldFunction)
+
+BOOST_AUTO_TEST_CASE(scalarVsBatch)
+{
+	// Before: one virtual getNoise() call per sample
+	auto scalarFieldFunction = glr::terrain::SimplexNoiseFieldFunction(1.0f / 32.0f, 4, 0, glr::terrain::SIMD_NONE);
+	auto scalarOnly = ScalarOnlyFieldFunction(scalarFieldFunction);
+
+	glmd::float64 scalarChecksum = 0.0;
+	const glmd::float64 scalarThroughput = generateWorld(scalarOnly, scalarChecksum);
+
+	benchmark::report("fieldFunction", "getNoise loop: throughput", scalarThroughput / 1000000.0, "M samples/s");
+
+	// After: getNoiseBatch(), with each instruction set the CPU supports
+	const glr::terrain::SimdInstructionSet instructionSets[] = { glr::terrain::SIMD_NONE, glr::terrain::SIMD_SSE4_1, glr::terrain::SIMD_AVX2 };
+
+	for ( auto instructionSet : instructionSets )
+	{
+		auto fieldFunction = glr::terrain::SimplexNoiseFieldFunction(1.0f / 32.0f, 4, 0, instructionSet);
+
+		// Not supported by this CPU
+		if (fieldFunction.getInstructionSet() != instructionSet)
+			continue;
+
+		glmd::float64 checksum = 0.0;
+		const glmd::float64 throughput = generateWorld(fieldFunction, checksum);
+
+		BOOST_CHECK_CLOSE( checksum, scalarChecksum, 0.01 );
+
+		benchmark::report("fieldFunction", "getNoiseBatch (" + getName(instructionSet) + "): throughput", throughput / 1000000.0, "M samples/s");
+		benchmark::report("fieldFunction", "getNoiseBatch (" + getName(instructionSet) + "): speedup", throughput / scalarThroughput, "x");
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,162 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "Benchmark.hpp"
+
+#include "BoundingVolumeHierarchy.hpp"
+#include "Frustum.hpp"
+#include "glw/BoundingBox.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const glmd::uint32 GRID_WIDTH = 250;
+const glmd::uint32 NUMBER_OF_NODES = 50000;
+const glmd::uint32 NUMBER_OF_FRAMES = 50;
+
+/**
+ * The bounding boxes of NUMBER_OF_NODES unit sized nodes, laid out on a grid 2 units apart (500 x 400 units).
+ */
+std::vector< glr::glw::BoundingBox > createBoxes()
+{
+	std::vector< glr::glw::BoundingBox > boxes;
+
+	for ( glmd::uint32 i = 0; i < NUMBER_OF_NODES; i++ )
+	{
+		const glm::vec3 min = glm::vec3( (float)(i % GRID_WIDTH) * 2.0f, 0.0f, (float)(i / GRID_WIDTH) * 2.0f );
+		boxes.push_back( glr::glw::BoundingBox(min, min + glm::vec3(1.0f)) );
+	}
+
+	return boxes;
+}
+
+/**
+ * A box shaped frustum over x and z in [0, 100] - roughly 1 in 20 of the nodes.
+ */
+glr::Frustum createFrustum()
+{
+	glm::mat4 matrix = glm::mat4(1.0f);
+	matrix[0][0] = 1.0f / 50.0f;
+	matrix[1][1] = 1.0f / 10.0f;
+	matrix[2][2] = 1.0f / 50.0f;
+	matrix[3][0] = -1.0f;
+	matrix[3][2] = -1.0f;
+
+	return glr::Frustum( matrix );
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(frustumCulling)
+
+/**
+ * Compares testing every node against the frustum with querying the bounding volume hierarchy - including the per frame cost of
+ * keeping the hierarchy up to date, which BasicSceneManager::drawAll pays for every scene node.
+ */
+BOOST_AUTO_TEST_CASE(sceneNodes)
+{
+	const auto boxes = createBoxes();
+	const glr::Frustum frustum = createFrustum();
+
+	benchmark::report("frustum culling", "nodes", NUMBER_OF_NODES, "nodes");
+
+	// Brute force: every node is tested
+	glmd::uint32 bruteForceVisible = 0;
+
+	auto timer = benchmark::Timer();
+
+	for ( glmd::uint32 frame = 0; frame < NUMBER_OF_FRAMES; frame++ )
+	{
+		bruteForceVisible = 0;
+
+		for ( const auto& box : boxes )
+		{
+			if (frustum.isVisible( box ))
+				bruteForceVisible++;
+		}
+	}
+
+	const glmd::float64 bruteForceTime = timer.getElapsedMilliseconds() / NUMBER_OF_FRAMES;
+
+	benchmark::report("frustum culling", "brute force: frustum tests per frame", NUMBER_OF_NODES, "tests");
+	benchmark::report("frustum culling", "brute force: time per frame", bruteForceTime, "ms");
+
+	// Bounding volume hierarchy
+	auto hierarchy = glr::BoundingVolumeHierarchy();
+	std::vector< glmd::int32 > proxies;
+
+	timer.restart();
+
+	for ( glmd::uint32 i = 0; i < boxes.size(); i++ )
+		proxies.push_back( hierarchy.insert(boxes[i], nullptr) );
+
+	benchmark::report("frustum culling", "hierarchy: build time", timer.getElapsedMilliseconds(), "ms");
+	benchmark::report("frustum culling", "hierarchy: height", hierarchy.getHeight(), "levels");
+
+	glmd::uint32 numberVisited = 0;
+	auto statistics = glr::CullingStatistics();
+
+	timer.restart();
+
+	for ( glmd::uint32 frame = 0; frame < NUMBER_OF_FRAMES; frame++ )
+	{
+		numberVisited = 0;
+		statistics = hierarchy.query( frustum, [&numberVisited](void*) { numberVisited++; } );
+	}
+
+	const glmd::float64 queryTime = timer.getElapsedMilliseconds() / NUMBER_OF_FRAMES;
+
+	// The hierarchy tests fat boxes, so it may find a few more nodes than the brute force test
+	BOOST_CHECK( statistics.visible >= bruteForceVisible );
+	BOOST_CHECK_EQUAL( statistics.visible, numberVisited );
+	BOOST_CHECK_EQUAL( statistics.visible + statistics.culled, NUMBER_OF_NODES );
+
+	benchmark::report("frustum culling", "visible nodes", statistics.visible, "nodes");
+	benchmark::report("frustum culling", "culled nodes", statistics.culled, "nodes");
+	benchmark::report("frustum culling", "hierarchy: query time per frame", queryTime, "ms");
+
+	// Keeping the hierarchy up to date when nothing moves (every node is checked against its fat box)
+	timer.restart();
+
+	for ( glmd::uint32 frame = 0; frame < NUMBER_OF_FRAMES; frame++ )
+	{
+		for ( glmd::uint32 i = 0; i < boxes.size(); i++ )
+			hierarchy.synchronize( proxies[i], boxes[i], nullptr );
+	}
+
+	benchmark::report("frustum culling", "hierarchy: update time per frame (static nodes)", timer.getElapsedMilliseconds() / NUMBER_OF_FRAMES, "ms");
+
+	// 1 in 10 nodes moves a tenth of a unit every frame - they are only reinserted when they leave their fat boxes
+	auto movingBoxes = boxes;
+	glmd::uint32 numberReinserted = 0;
+
+	timer.restart();
+
+	for ( glmd::uint32 frame = 0; frame < NUMBER_OF_FRAMES; frame++ )
+	{
+		for ( glmd::uint32 i = 0; i < movingBoxes.size(); i += 10 )
+		{
+			movingBoxes[i].min.y += 0.1f;
+			movingBoxes[i].max.y += 0.1f;
+
+			if (hierarchy.update( proxies[i], movingBoxes[i] ))
+				numberReinserted++;
+		}
+	}
+
+	benchmark::report("frustum culling", "hierarchy: update time per frame (10% moving)", timer.getElapsedMilliseconds() / NUMBER_OF_FRAMES, "ms");
+	benchmark::report("frustum culling", "hierarchy: reinsertions per frame (10% moving)", numberReinserted / NUMBER_OF_FRAMES, "nodes");
+	benchmark::report("frustum culling", "hierarchy: height after moving", hierarchy.getHeight(), "levels");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,147 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "Benchmark.hpp"
+
+#include "RenderQueue.hpp"
+#include "glw/Constants.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const glmd::uint32 NUMBER_OF_NODES = 50000;
+const glmd::uint32 NUMBER_OF_FRAMES = 20;
+
+// OpenGL calls made by RenderQueue::drawItem and Mesh::render for an unskinned mesh (3 uniforms, bind vertex array, 2 generic bone
+// attributes, draw, unbind vertex array)
+const glmd::uint32 GL_CALLS_PER_DRAW = 8;
+// OpenGL calls made by RenderQueue::drawInstances and Mesh::renderInstanced (map and unmap the streaming buffer, bind vertex array, 2
+// generic bone attributes, bind buffer, 3 calls for each of the 4 matrix columns, draw, disable the 4 columns, unbind buffer and vertex
+// array)
+const glmd::uint32 GL_CALLS_PER_INSTANCED_DRAW = 26;
+
+// Stand-ins for the state objects - the render queue only compares their addresses
+struct FakeState
+{
+	char data[64];
+};
+
+/**
+ * Queues NUMBER_OF_NODES nodes that all use the same mesh, texture, material and shader program, laid out on a grid.
+ */
+void queueNodes(glr::RenderQueue& queue, std::vector< FakeState >& state)
+{
+	state.resize( 4 );
+
+	auto item = glr::DrawItem();
+	item.shaderProgram = reinterpret_cast<glr::shaders::IShaderProgram*>( &state[0] );
+	item.texture = reinterpret_cast<glr::glw::ITexture*>( &state[1] );
+	item.material = reinterpret_cast<glr::glw::IMaterial*>( &state[2] );
+	item.mesh = reinterpret_cast<glr::glw::IMesh*>( &state[3] );
+
+	const glmd::uint64 key = glr::RenderQueue::createSortKey(1, item.texture, item.material, item.mesh);
+
+	queue.clear();
+
+	for ( glmd::uint32 i = 0; i < NUMBER_OF_NODES; i++ )
+	{
+		item.modelMatrix = glm::mat4(1.0f);
+		item.modelMatrix[3] = glm::vec4( (float)(i % 250) * 2.0f, 0.0f, (float)(i / 250) * 2.0f, 1.0f );
+
+		queue.push( item, key );
+	}
+
+	queue.sort();
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(instancing)
+
+/**
+ * There's no OpenGL context in the benchmarks, so the GPU side of a frame can't be timed - instead, this times the CPU work
+ * RenderQueue::submit does for each draw (the per draw matrices, or packing the instance matrices), and reports the number of draw
+ * calls and OpenGL calls per frame.
+ */
+BOOST_AUTO_TEST_CASE(identicalNodes)
+{
+	auto queue = glr::RenderQueue( nullptr );
+	std::vector< FakeState > state;
+	queueNodes( queue, state );
+
+	const auto& items = queue.getItems();
+
+	const glm::mat4 viewMatrix = glm::mat4(1.0f);
+	const glm::mat4 projectionViewMatrix = glm::mat4(1.0f);
+
+	benchmark::report("instancing", "nodes", NUMBER_OF_NODES, "nodes");
+
+	// Without batching: a pvm and normal matrix for every node, and a draw call each
+	glmd::float64 checksum = 0.0;
+
+	auto timer = benchmark::Timer();
+
+	for ( glmd::uint32 frame = 0; frame < NUMBER_OF_FRAMES; frame++ )
+	{
+		for ( const auto& item : items )
+		{
+			const glm::mat4 pvmMatrix = projectionViewMatrix * item.modelMatrix;
+			glm::mat3 normalMatrix = glm::inverse(glm::transpose(glm::mat3(viewMatrix * item.modelMatrix)));
+
+			checksum += pvmMatrix[3][3] + normalMatrix[0][0];
+		}
+	}
+
+	const glmd::float64 unbatchedTime = timer.getElapsedMilliseconds() / NUMBER_OF_FRAMES;
+
+	BOOST_CHECK( checksum > 0.0 );
+
+	benchmark::report("instancing", "without batching: draw calls per frame", NUMBER_OF_NODES, "calls");
+	benchmark::report("instancing", "without batching: OpenGL calls per frame", NUMBER_OF_NODES * GL_CALLS_PER_DRAW, "calls");
+	benchmark::report("instancing", "without batching: CPU frame time", unbatchedTime, "ms");
+
+	// With batching: the model matrices are copied into one buffer per batch
+	std::vector< glm::mat4 > instanceModelMatrices;
+	glmd::uint32 numberOfDraws = 0;
+
+	timer.restart();
+
+	for ( glmd::uint32 frame = 0; frame < NUMBER_OF_FRAMES; frame++ )
+	{
+		numberOfDraws = 0;
+
+		for ( glmd::uint32 i = 0; i < items.size(); )
+		{
+			const glmd::uint32 numberOfInstances = glr::RenderQueue::countInstances( items, i, glr::glw::Constants::MAX_NUMBER_OF_INSTANCES_PER_DRAW );
+
+			instanceModelMatrices.resize( numberOfInstances );
+			for ( glmd::uint32 j = 0; j < numberOfInstances; j++ )
+				instanceModelMatrices[j] = items[i + j].modelMatrix;
+
+			numberOfDraws++;
+			i += numberOfInstances;
+		}
+	}
+
+	const glmd::float64 batchedTime = timer.getElapsedMilliseconds() / NUMBER_OF_FRAMES;
+
+	const glmd::uint32 expectedNumberOfDraws = (NUMBER_OF_NODES + glr::glw::Constants::MAX_NUMBER_OF_INSTANCES_PER_DRAW - 1) / glr::glw::Constants::MAX_NUMBER_OF_INSTANCES_PER_DRAW;
+	BOOST_CHECK_EQUAL( numberOfDraws, expectedNumberOfDraws );
+
+	benchmark::report("instancing", "with batching: draw calls per frame", numberOfDraws, "calls");
+	benchmark::report("instancing", "with batching: OpenGL calls per frame", numberOfDraws * GL_CALLS_PER_INSTANCED_DRAW, "calls");
+	benchmark::report("instancing", "with batching: instance data per frame", NUMBER_OF_NODES * sizeof(glm::mat4) / 1024.0, "KB");
+	benchmark::report("instancing", "with batching: CPU frame time", batchedTime, "ms");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
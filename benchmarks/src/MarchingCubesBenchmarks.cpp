@@ -0,0 +1,125 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "Benchmark.hpp"
+
+#include "terrain/VoxelChunk.hpp"
+#include "terrain/VoxelChunkNoiseGenerator.hpp"
+#include "terrain/marching_cubes/VoxelChunkMeshGenerator.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const glmd::int32 WORLD_SIZE = 8;
+
+// Bytes per vertex that we upload for terrain (position, normal, and texture blending values)
+const glmd::uint64 BYTES_PER_VERTEX = sizeof(glm::vec3) + sizeof(glm::vec3) + sizeof(glm::vec4);
+
+}
+
+BOOST_AUTO_TEST_SUITE(marchingCubes)
+
+BOOST_AUTO_TEST_CASE(indexedVsNonIndexed)
+{
+	// Skirts are only generated for indexed meshes, so they would make the two meshes different
+	auto settings = glr::terrain::TerrainSettings();
+	settings.levelOfDetailSkirts = false;
+
+	auto fieldFunction = benchmark::HillsFieldFunction();
+	auto meshGenerator = glr::terrain::marching_cubes::VoxelChunkMeshGenerator(settings);
+
+	glmd::int32 numberOfChunks = 0;
+
+	glmd::uint64 numberOfVertices = 0;
+	glmd::float64 meshTime = 0.0;
+
+	glmd::uint64 numberOfIndexedVertices = 0;
+	glmd::uint64 numberOfIndices = 0;
+	glmd::float64 indexedMeshTime = 0.0;
+
+	bool trianglesMatch = true;
+
+	for (glmd::int32 x=0; x < WORLD_SIZE; x++)
+	{
+		for (glmd::int32 y=0; y < WORLD_SIZE; y++)
+		{
+			for (glmd::int32 z=0; z < WORLD_SIZE; z++)
+			{
+				auto chunk = glr::terrain::VoxelChunk(x, y, z);
+				glr::terrain::generateNoise(chunk, WORLD_SIZE, WORLD_SIZE, WORLD_SIZE, fieldFunction);
+
+				if (glr::terrain::determineIfEmptyOrSolid(chunk))
+					continue;
+
+				// Before: 3 vertices per triangle
+				auto vertices = std::vector< glm::vec3 >();
+				auto normals = std::vector< glm::vec3 >();
+				auto textureBlendingValues = std::vector< glm::vec4 >();
+
+				auto timer = benchmark::Timer();
+				meshGenerator.generateMesh(chunk, WORLD_SIZE, WORLD_SIZE, WORLD_SIZE, vertices, normals, textureBlendingValues);
+				meshTime += timer.getElapsedMilliseconds();
+
+				// After: shared vertices and an index buffer
+				auto indexedVertices = std::vector< glm::vec3 >();
+				auto indexedNormals = std::vector< glm::vec3 >();
+				auto indexedTextureBlendingValues = std::vector< glm::vec4 >();
+				auto indices = std::vector< glmd::uint32 >();
+
+				timer.restart();
+				meshGenerator.generateMesh(chunk, WORLD_SIZE, WORLD_SIZE, WORLD_SIZE, indexedVertices, indexedNormals, indexedTextureBlendingValues, indices);
+				indexedMeshTime += timer.getElapsedMilliseconds();
+
+				// Both meshes must describe the same triangles
+				if (indices.size() != vertices.size())
+				{
+					trianglesMatch = false;
+				}
+				else
+				{
+					for (glmd::uint32 i=0; i < indices.size(); i++)
+					{
+						if (glm::length(indexedVertices[indices[i]] - vertices[i]) > 0.0001f)
+							trianglesMatch = false;
+					}
+				}
+
+				BOOST_CHECK_EQUAL( indexedNormals.size(), indexedVertices.size() );
+				BOOST_CHECK_EQUAL( indexedTextureBlendingValues.size(), indexedVertices.size() );
+
+				numberOfVertices += vertices.size();
+				numberOfIndexedVertices += indexedVertices.size();
+				numberOfIndices += indices.size();
+				numberOfChunks++;
+			}
+		}
+	}
+
+	BOOST_CHECK( numberOfChunks > 0 );
+	BOOST_CHECK( trianglesMatch );
+	BOOST_CHECK( numberOfIndexedVertices < numberOfVertices );
+
+	const glmd::uint64 bytes = numberOfVertices * BYTES_PER_VERTEX;
+	const glmd::uint64 indexedBytes = numberOfIndexedVertices * BYTES_PER_VERTEX + numberOfIndices * sizeof(glmd::uint32);
+
+	benchmark::report("marchingCubes", "surface chunks", (glmd::float64)numberOfChunks, "chunks");
+	benchmark::report("marchingCubes", "triangles per chunk", (glmd::float64)(numberOfIndices / 3) / numberOfChunks, "triangles");
+	benchmark::report("marchingCubes", "non-indexed: vertices per chunk", (glmd::float64)numberOfVertices / numberOfChunks, "vertices");
+	benchmark::report("marchingCubes", "non-indexed: mesh size per chunk", (glmd::float64)bytes / numberOfChunks / 1024.0, "KiB");
+	benchmark::report("marchingCubes", "non-indexed: time per chunk", meshTime / numberOfChunks, "ms");
+	benchmark::report("marchingCubes", "indexed: vertices per chunk", (glmd::float64)numberOfIndexedVertices / numberOfChunks, "vertices");
+	benchmark::report("marchingCubes", "indexed: mesh size per chunk", (glmd::float64)indexedBytes / numberOfChunks / 1024.0, "KiB");
+	benchmark::report("marchingCubes", "indexed: time per chunk", indexedMeshTime / numberOfChunks, "ms");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,118 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <cmath>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "Benchmark.hpp"
+
+#include "glw/VertexFormat.hpp"
+
+#include "models/MeshOptimizer.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+// A 128x128 grid of quads - about the size of a detailed character mesh
+const glmd::uint32 GRID_SIZE = 128;
+
+glm::vec3 getSpherePoint(glmd::uint32 i, glmd::uint32 j)
+{
+	const glmd::float32 theta = (glmd::float32)i / GRID_SIZE * 6.2831853f;
+	const glmd::float32 phi = (glmd::float32)j / GRID_SIZE * 3.1415927f;
+
+	return glm::vec3( std::cos(theta) * std::sin(phi), std::cos(phi), std::sin(theta) * std::sin(phi) );
+}
+
+/**
+ * Returns a skinned, textured sphere the way ModelLoader used to load meshes - 3 vertices per triangle, with no index list.
+ */
+glr::models::MeshData createUnindexedSphere()
+{
+	auto data = glr::models::MeshData();
+
+	for (glmd::uint32 i=0; i < GRID_SIZE; i++)
+	{
+		for (glmd::uint32 j=0; j < GRID_SIZE; j++)
+		{
+			const glmd::uint32 corners[6][2] = { {i, j}, {i + 1, j}, {i + 1, j + 1}, {i, j}, {i + 1, j + 1}, {i, j + 1} };
+
+			for (glmd::uint32 k=0; k < 6; k++)
+			{
+				const glmd::uint32 u = corners[k][0] % GRID_SIZE;
+				const glmd::uint32 v = corners[k][1];
+				const glm::vec3 normal = getSpherePoint(u, v);
+
+				data.vertices.push_back( normal * 2.0f );
+				data.normals.push_back( normal );
+				data.textureCoordinates.push_back( glm::vec2((glmd::float32)u / GRID_SIZE, (glmd::float32)v / GRID_SIZE) );
+				data.colors.push_back( glm::vec4(1.0f) );
+
+				auto bone = glr::glw::VertexBoneData();
+				bone.addBoneWeight(u % 64, 0.75f);
+				bone.addBoneWeight(v % 64, 0.25f);
+				data.bones.push_back( bone );
+			}
+		}
+	}
+
+	return data;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(meshOptimizer)
+
+BOOST_AUTO_TEST_CASE(importedMesh)
+{
+	const auto format = glr::glw::createPackedVertexFormat();
+
+	auto data = createUnindexedSphere();
+	const glmd::uint32 numberOfTriangles = data.vertices.size() / 3;
+
+	benchmark::report("meshOptimizer", "triangles", (glmd::float64)numberOfTriangles, "triangles");
+
+	// Before: every triangle has its own 3 vertices, drawn with glDrawArrays
+	benchmark::report("meshOptimizer", "unindexed: vertices", (glmd::float64)data.vertices.size(), "vertices");
+	benchmark::report("meshOptimizer", "unindexed: video memory", data.vertices.size() * format.getStride() / 1024.0, "KB");
+	benchmark::report("meshOptimizer", "unindexed: vertex shader invocations per triangle", 3.0, "vertices");
+
+	// Welded, with the triangles still in the order they were imported
+	auto timer = benchmark::Timer();
+	glr::models::weldVertices(data);
+	const glmd::float64 weldTime = timer.getElapsedMilliseconds();
+
+	const glmd::uint32 indexSize = (data.vertices.size() <= 65536 ? sizeof(glmd::uint16) : sizeof(glmd::uint32));
+	const glmd::float64 indexedMemory = (data.vertices.size() * format.getStride() + data.indices.size() * indexSize) / 1024.0;
+
+	benchmark::report("meshOptimizer", "welded: vertices", (glmd::float64)data.vertices.size(), "vertices");
+	benchmark::report("meshOptimizer", "welded: video memory (vertices and indices)", indexedMemory, "KB");
+	benchmark::report("meshOptimizer", "welded: bytes per index", (glmd::float64)indexSize, "bytes");
+	benchmark::report("meshOptimizer", "welded: average cache miss ratio (16 vertex FIFO)", glr::models::calculateAverageCacheMissRatio(data.indices, data.vertices.size()), "vertices");
+	benchmark::report("meshOptimizer", "welded: weld time", weldTime, "ms");
+
+	// Welded, and reordered for the vertex cache
+	timer.restart();
+	glr::models::optimizeVertexCache(data.indices, data.vertices.size());
+	glr::models::optimizeVertexFetch(data);
+	const glmd::float64 optimizeTime = timer.getElapsedMilliseconds();
+
+	const glmd::float32 acmr = glr::models::calculateAverageCacheMissRatio(data.indices, data.vertices.size());
+
+	BOOST_CHECK( acmr < 1.0f );
+	BOOST_CHECK_EQUAL( data.indices.size(), numberOfTriangles * 3 );
+
+	benchmark::report("meshOptimizer", "optimized: average cache miss ratio (16 vertex FIFO)", acmr, "vertices");
+	benchmark::report("meshOptimizer", "optimized: average cache miss ratio (32 vertex FIFO)", glr::models::calculateAverageCacheMissRatio(data.indices, data.vertices.size(), 32), "vertices");
+	benchmark::report("meshOptimizer", "optimized: vertex cache and fetch optimization time", optimizeTime, "ms");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,136 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "Benchmark.hpp"
+
+#include "models/ModelLoader.hpp"
+#include "models/ModelCache.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const std::string MODEL_FILENAME = "model_cache_benchmarks.obj";
+const std::string CACHE_DIRECTORY = "./";
+
+// A grid of GRID_SIZE x GRID_SIZE quads
+const glmd::uint32 GRID_SIZE = 200;
+
+/**
+ * Writes a wavy grid as a Wavefront obj file - a stand in for a large model, that doesn't need any assets.
+ */
+void writeModel(const std::string& filename)
+{
+	std::ofstream file(filename, std::ios::out | std::ios::trunc);
+
+	for (glmd::uint32 z=0; z <= GRID_SIZE; z++)
+	{
+		for (glmd::uint32 x=0; x <= GRID_SIZE; x++)
+		{
+			const glmd::float32 height = std::sin((glmd::float32)x * 0.1f) * std::cos((glmd::float32)z * 0.1f);
+
+			file << "v " << x << " " << height << " " << z << "\n";
+			file << "vt " << (glmd::float32)x / GRID_SIZE << " " << (glmd::float32)z / GRID_SIZE << "\n";
+			file << "vn 0 1 0\n";
+		}
+	}
+
+	for (glmd::uint32 z=0; z < GRID_SIZE; z++)
+	{
+		for (glmd::uint32 x=0; x < GRID_SIZE; x++)
+		{
+			// obj indices start at 1
+			const glmd::uint32 a = z * (GRID_SIZE + 1) + x + 1;
+			const glmd::uint32 b = a + 1;
+			const glmd::uint32 c = a + GRID_SIZE + 1;
+			const glmd::uint32 d = c + 1;
+
+			file << "f " << a << "/" << a << "/" << a << " " << c << "/" << c << "/" << c << " " << b << "/" << b << "/" << b << "\n";
+			file << "f " << b << "/" << b << "/" << b << " " << c << "/" << c << "/" << c << " " << d << "/" << d << "/" << d << "\n";
+		}
+	}
+}
+
+glmd::uint64 countVertices(const std::vector< glr::models::ModelData >& modelData)
+{
+	glmd::uint64 numberOfVertices = 0;
+
+	for ( const auto& d : modelData )
+	{
+		numberOfVertices += d.meshData.vertices.size();
+	}
+
+	return numberOfVertices;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(modelCache)
+
+/**
+ * Compares importing a model with Assimp (a cold load) with reading it back from the model cache (a warm load).
+ */
+BOOST_AUTO_TEST_CASE(coldAndWarmLoads)
+{
+	writeModel( MODEL_FILENAME );
+
+	const glmd::uint64 sourceHash = glr::models::model_cache::calculateSourceHash( "model", MODEL_FILENAME );
+	const std::string cacheFilename = glr::models::ModelCache( CACHE_DIRECTORY ).getCacheFilename( sourceHash );
+	std::remove( cacheFilename.c_str() );
+
+	// The loaders never touch OpenGL while loading model data
+	glr::models::ModelLoader uncachedLoader( nullptr );
+	glr::models::ModelLoader cachedLoader( nullptr, CACHE_DIRECTORY );
+
+	auto timer = benchmark::Timer();
+	const auto imported = uncachedLoader.loadModelData( "model", MODEL_FILENAME );
+	const glmd::float64 coldTime = timer.getElapsedMilliseconds();
+
+	// Imports the model, and writes the cache file
+	timer.restart();
+	cachedLoader.loadModelData( "model", MODEL_FILENAME );
+	const glmd::float64 coldCachingTime = timer.getElapsedMilliseconds();
+
+	timer.restart();
+	const auto cached = cachedLoader.loadModelData( "model", MODEL_FILENAME );
+	const glmd::float64 warmTime = timer.getElapsedMilliseconds();
+
+	BOOST_REQUIRE_EQUAL( cached.first.size(), imported.first.size() );
+	BOOST_CHECK_EQUAL( countVertices(cached.first), countVertices(imported.first) );
+
+	// The cost of a warm load, without the file system and hashing the model file
+	auto data = std::vector<glmd::uint8>();
+	glr::models::model_cache::write( sourceHash, imported.first, imported.second, data );
+
+	auto modelData = std::vector< glr::models::ModelData >();
+	auto animationSet = glr::models::AnimationSet();
+
+	timer.restart();
+	BOOST_CHECK( glr::models::model_cache::read(&data[0], data.size(), sourceHash, modelData, animationSet) );
+	const glmd::float64 readTime = timer.getElapsedMilliseconds();
+
+	benchmark::report("model cache", "vertices", countVertices(imported.first), "vertices");
+	benchmark::report("model cache", "cache file size", data.size() / 1024.0, "KB");
+	benchmark::report("model cache", "cold load (Assimp import)", coldTime, "ms");
+	benchmark::report("model cache", "cold load (Assimp import, writing the cache file)", coldCachingTime, "ms");
+	benchmark::report("model cache", "warm load (cache file)", warmTime, "ms");
+	benchmark::report("model cache", "warm load (reading from memory)", readTime, "ms");
+	benchmark::report("model cache", "speed up", coldTime / warmTime, "x");
+
+	std::remove( cacheFilename.c_str() );
+	std::remove( MODEL_FILENAME.c_str() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,142 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <random>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "Benchmark.hpp"
+
+#include "RenderQueue.hpp"
+#include "RenderStateTracker.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const glmd::uint32 NUMBER_OF_ITEMS = 10000;
+const glmd::uint32 NUMBER_OF_SHADER_PROGRAMS = 4;
+const glmd::uint32 NUMBER_OF_TEXTURES = 64;
+const glmd::uint32 NUMBER_OF_MATERIALS = 32;
+const glmd::uint32 NUMBER_OF_FRAMES = 100;
+
+// Stand-ins for the state objects - the queue and the tracker only compare their addresses
+struct FakeState
+{
+	char data[64];
+};
+
+/**
+ * Creates a scene in the order scene nodes are typically created in (i.e. models placed around a level), which has no relation to the
+ * state they use.
+ */
+std::vector< glr::DrawItem > createItems(std::vector< FakeState >& state)
+{
+	state.resize( NUMBER_OF_SHADER_PROGRAMS + NUMBER_OF_TEXTURES + NUMBER_OF_MATERIALS );
+
+	std::mt19937 generator = std::mt19937( 42 );
+	auto items = std::vector< glr::DrawItem >( NUMBER_OF_ITEMS );
+
+	for ( auto& item : items )
+	{
+		item.shaderProgram = reinterpret_cast<glr::shaders::IShaderProgram*>( &state[ generator() % NUMBER_OF_SHADER_PROGRAMS ] );
+		item.texture = reinterpret_cast<glr::glw::ITexture*>( &state[ NUMBER_OF_SHADER_PROGRAMS + generator() % NUMBER_OF_TEXTURES ] );
+		item.material = reinterpret_cast<glr::glw::IMaterial*>( &state[ NUMBER_OF_SHADER_PROGRAMS + NUMBER_OF_TEXTURES + generator() % NUMBER_OF_MATERIALS ] );
+	}
+
+	return items;
+}
+
+glr::glw::StreamingBufferRange identityBones()
+{
+	auto bones = glr::glw::StreamingBufferRange();
+	bones.bufferId = 1;
+	bones.size = 100 * sizeof(glm::mat4);
+
+	return bones;
+}
+
+/**
+ * Runs the items through a state tracker, the way RenderQueue::submit does (without the OpenGL calls).
+ */
+glr::RenderStatistics track(const std::vector< glr::DrawItem >& items)
+{
+	auto tracker = glr::RenderStateTracker();
+	const auto bones = identityBones();
+
+	for ( const auto& item : items )
+	{
+		tracker.setShaderProgram( item.shaderProgram );
+		tracker.setTexture( item.texture );
+		tracker.setMaterial( item.material );
+		tracker.setBones( bones );
+		tracker.draw();
+	}
+
+	return tracker.getStatistics();
+}
+
+void reportStatistics(const std::string& name, const glr::RenderStatistics& statistics)
+{
+	benchmark::report("renderQueue", name + ": draw calls", statistics.drawCalls, "calls");
+	benchmark::report("renderQueue", name + ": shader program changes", statistics.shaderProgramChanges, "binds");
+	benchmark::report("renderQueue", name + ": texture changes", statistics.textureChanges, "binds");
+	benchmark::report("renderQueue", name + ": material changes", statistics.materialChanges, "binds");
+	benchmark::report("renderQueue", name + ": bone changes", statistics.boneChanges, "binds");
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(renderQueue)
+
+/**
+ * There's no OpenGL context in the benchmarks, so the binds can't be timed - instead, this reports how many state changes a frame
+ * needs with and without sorting, and times the sort itself.
+ */
+BOOST_AUTO_TEST_CASE(stateChanges)
+{
+	std::vector< FakeState > state;
+	const auto items = createItems( state );
+
+	benchmark::report("renderQueue", "items", NUMBER_OF_ITEMS, "items");
+
+	// Before: every node rendered in scene order, binding all of its state (GlslShaderProgram::bind only skipped the program itself)
+	const auto unsorted = track( items );
+	const glmd::uint32 bindsBefore = unsorted.drawCalls * 3 + unsorted.shaderProgramChanges;
+	benchmark::report("renderQueue", "before: state binds per frame", bindsBefore, "binds");
+	reportStatistics("unsorted", unsorted);
+
+	// After: sorted, and redundant binds skipped
+	auto queue = glr::RenderQueue( nullptr );
+	glmd::float64 sortTime = 0.0;
+
+	for ( glmd::uint32 frame = 0; frame < NUMBER_OF_FRAMES; frame++ )
+	{
+		queue.clear();
+		for ( const auto& item : items )
+			queue.push( item, glr::RenderQueue::createSortKey((glmd::uint32)(reinterpret_cast<FakeState*>(item.shaderProgram) - &state[0]), item.texture, item.material, item.mesh) );
+
+		auto timer = benchmark::Timer();
+		queue.sort();
+		sortTime += timer.getElapsedMilliseconds();
+	}
+
+	const auto sorted = track( queue.getItems() );
+	const glmd::uint32 bindsAfter = sorted.shaderProgramChanges + sorted.textureChanges + sorted.materialChanges + sorted.boneChanges;
+	benchmark::report("renderQueue", "after: state binds per frame", bindsAfter, "binds");
+	reportStatistics("sorted", sorted);
+
+	benchmark::report("renderQueue", "sort time per frame", sortTime / NUMBER_OF_FRAMES, "ms");
+
+	BOOST_CHECK_EQUAL( sorted.drawCalls, NUMBER_OF_ITEMS );
+	BOOST_CHECK_EQUAL( sorted.shaderProgramChanges, NUMBER_OF_SHADER_PROGRAMS );
+	BOOST_CHECK_LT( bindsAfter, bindsBefore );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
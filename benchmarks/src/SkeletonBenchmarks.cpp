@@ -0,0 +1,877 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <map>
+#include <string>
+#include <cmath>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <memory>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include "Benchmark.hpp"
+
+#include "glw/Skeleton.hpp"
+#include "glw/AnimationTracks.hpp"
+#include "glw/SampledAnimationTracks.hpp"
+#include "glw/Animation.hpp"
+#include "glw/BlendTree.hpp"
+
+#include "ThreadPool.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const glmd::uint32 NUMBER_OF_CHARACTERS = 100;
+const glmd::uint32 NUMBER_OF_FRAMES = 100;
+const glmd::uint32 NUMBER_OF_KEYS = 30;
+const glmd::uint32 NUMBER_OF_MESHES = 10;
+const glmd::uint32 NUMBER_OF_INSTANCES = 1000;
+const glmd::uint32 NUMBER_OF_CAPTURED_KEYS = 300;
+const glmd::uint32 NUMBER_OF_CLIPS = 20;
+const glmd::uint32 NUMBER_OF_LOCOMOTION_CLIPS = 4;
+
+/**
+ * Returns a chain of length nodes (named name + the number of nodes left in the chain), with ends as the children of the last node.
+ */
+glr::glw::BoneNode createChain(const std::string& name, glmd::uint32 length, std::vector< glr::glw::BoneNode > ends = std::vector< glr::glw::BoneNode >())
+{
+	auto node = glr::glw::BoneNode();
+	node.name = name + std::to_string(length);
+	node.transformation = glm::translate( glm::mat4(1.0f), glm::vec3(0.0f, 1.0f, 0.0f) );
+
+	if (length > 1)
+	{
+		node.children.push_back( createChain(name, length - 1, std::move(ends)) );
+	}
+	else
+	{
+		node.children = std::move(ends);
+	}
+
+	return node;
+}
+
+glr::glw::BoneNode createArm(const std::string& side)
+{
+	auto fingers = std::vector< glr::glw::BoneNode >();
+	for (glmd::uint32 i=0; i < 5; i++)
+	{
+		fingers.push_back( createChain(side + "Finger" + std::to_string(i) + "_", 3) );
+	}
+
+	return createChain( side + "Arm", 3, { createChain(side + "Hand", 1, fingers) } );
+}
+
+/**
+ * A humanoid skeleton of 54 nodes - a spine, head, legs, and arms with five fingers each.
+ */
+glr::glw::BoneNode createHumanoid()
+{
+	auto hips = createChain( "hips", 1, {
+		createChain( "spine", 4, { createChain("head", 2), createArm("left"), createArm("right") } ),
+		createChain( "leftLeg", 4 ),
+		createChain( "rightLeg", 4 )
+	} );
+
+	return createChain( "root", 1, { hips } );
+}
+
+void createAnimatedBoneNodes(const glr::glw::BoneNode& node, std::map< std::string, glr::glw::AnimatedBoneNode >& animatedBoneNodes)
+{
+	auto abn = glr::glw::AnimatedBoneNode();
+	abn.name = node.name;
+
+	const glm::vec3 axis = glm::normalize( glm::vec3(1.0f, (glmd::float32)node.name.size(), 0.5f) );
+
+	for (glmd::uint32 i=0; i < NUMBER_OF_KEYS; i++)
+	{
+		abn.positionTimes.push_back( i );
+		abn.rotationTimes.push_back( i );
+		abn.scalingTimes.push_back( i );
+		abn.positions.push_back( glm::vec3(0.0f, 1.0f, 0.01f * i) );
+		abn.rotations.push_back( glm::angleAxis(0.1f * i, axis) );
+		abn.scalings.push_back( glm::vec3(1.0f) );
+	}
+
+	animatedBoneNodes[ node.name ] = abn;
+
+	for ( auto& child : node.children )
+	{
+		createAnimatedBoneNodes( child, animatedBoneNodes );
+	}
+}
+
+/**
+ * Returns a clip like a motion capture - a key every tick for every node, with smooth non-linear rotations.  Only the hips move, and nothing
+ * is scaled.
+ */
+std::map< std::string, glr::glw::AnimatedBoneNode > createCapturedAnimatedBoneNodes(const glr::glw::Skeleton& skeleton, glmd::uint32 clip)
+{
+	auto animatedBoneNodes = std::map< std::string, glr::glw::AnimatedBoneNode >();
+
+	for ( glmd::uint32 n = 0; n < skeleton.getNumberOfNodes(); n++ )
+	{
+		auto abn = glr::glw::AnimatedBoneNode();
+		abn.name = skeleton.getNames()[n];
+
+		const glm::vec3 axis = glm::normalize( glm::vec3(1.0f, 0.1f * n, 0.5f) );
+		const bool isHips = (abn.name.compare(0, 4, "hips") == 0);
+
+		for (glmd::uint32 i=0; i < NUMBER_OF_CAPTURED_KEYS; i++)
+		{
+			const glmd::float32 t = 0.08f * i + 0.3f * n + 0.7f * clip;
+
+			abn.positionTimes.push_back( i );
+			abn.rotationTimes.push_back( i );
+			abn.scalingTimes.push_back( i );
+			abn.positions.push_back( isHips ? glm::vec3(0.2f * std::sin(t), 1.0f + 0.05f * std::sin(2.0f * t), 0.01f * i) : glm::vec3(0.0f, 1.0f, 0.0f) );
+			abn.rotations.push_back( glm::angleAxis(0.6f * std::sin(t) + 0.2f * std::sin(3.1f * t), axis) );
+			abn.scalings.push_back( glm::vec3(1.0f) );
+		}
+
+		animatedBoneNodes[ abn.name ] = abn;
+	}
+
+	return animatedBoneNodes;
+}
+
+glmd::uint32 getMemoryUsage(const std::map< std::string, glr::glw::AnimatedBoneNode >& animatedBoneNodes)
+{
+	glmd::uint32 memoryUsage = 0;
+
+	for ( auto& kv : animatedBoneNodes )
+	{
+		const glr::glw::AnimatedBoneNode& abn = kv.second;
+
+		memoryUsage += (abn.positionTimes.size() + abn.rotationTimes.size() + abn.scalingTimes.size()) * sizeof(glmd::float64);
+		memoryUsage += abn.positions.size() * sizeof(glm::vec3) + abn.rotations.size() * sizeof(glm::quat) + abn.scalings.size() * sizeof(glm::vec3);
+	}
+
+	return memoryUsage;
+}
+
+/**
+ * Every node but the root is a bone, in name order.
+ */
+glr::glw::BoneData createBoneData(const std::map< std::string, glr::glw::AnimatedBoneNode >& animatedBoneNodes)
+{
+	auto boneData = glr::glw::BoneData();
+
+	for ( auto& kv : animatedBoneNodes )
+	{
+		if (kv.first != "root1")
+		{
+			auto bone = glr::glw::Bone();
+			bone.name = kv.first;
+			bone.boneOffset = glm::translate( glm::mat4(1.0f), glm::vec3(0.0f, -1.0f, 0.0f) );
+
+			boneData.boneIndexMap[ kv.first ] = boneData.boneTransform.size();
+			boneData.boneTransform.push_back( bone );
+		}
+	}
+
+	return boneData;
+}
+
+/**
+ * The tree walk Animation used before skeletons were compiled - a map lookup for the track and the bone of every node, a linear key
+ * search (starting from an index cache shared by all of the tracks), and three matrices multiplied together for each local
+ * transformation.  All of the tracks here have their keys at the same times, so one search serves all three channels.
+ */
+class TreeWalk
+{
+public:
+	TreeWalk(const std::map< std::string, glr::glw::AnimatedBoneNode >& animatedBoneNodes) : animatedBoneNodes_(animatedBoneNodes), indexCache_(0)
+	{
+	}
+
+	void calculate(std::vector< glm::mat4 >& transformations, glmd::float32 animationTime, const glm::mat4& globalInverseTransform, const glr::glw::BoneNode& node, const glr::glw::BoneData& boneData, const glm::mat4& parentTransform)
+	{
+		glm::mat4 nodeTransformation = node.transformation;
+
+		auto it = animatedBoneNodes_.find( node.name );
+		if ( it != animatedBoneNodes_.end() )
+		{
+			const auto& abn = it->second;
+
+			const glmd::uint32 key = findKey( abn.positionTimes, animationTime );
+			const glmd::float32 factor = (animationTime - (glmd::float32)abn.positionTimes[key]) / (glmd::float32)(abn.positionTimes[key + 1] - abn.positionTimes[key]);
+
+			const glm::vec3 scaling = abn.scalings[key] + factor * (abn.scalings[key + 1] - abn.scalings[key]);
+			const glm::quat rotation = glm::normalize( glm::slerp(abn.rotations[key], abn.rotations[key + 1], factor) );
+			const glm::vec3 translation = abn.positions[key] + factor * (abn.positions[key + 1] - abn.positions[key]);
+
+			nodeTransformation = glm::translate( glm::mat4(1.0f), translation ) * glm::mat4_cast( rotation ) * glm::scale( glm::mat4(1.0f), scaling );
+		}
+
+		const glm::mat4 globalTransformation = parentTransform * nodeTransformation;
+
+		auto boneIt = boneData.boneIndexMap.find( node.name );
+		if ( boneIt != boneData.boneIndexMap.end() )
+		{
+			transformations[ boneIt->second ] = globalInverseTransform * globalTransformation * boneData.boneTransform[ boneIt->second ].boneOffset;
+		}
+
+		for ( auto& child : node.children )
+		{
+			calculate( transformations, animationTime, globalInverseTransform, child, boneData, globalTransformation );
+		}
+	}
+
+private:
+	const std::map< std::string, glr::glw::AnimatedBoneNode >& animatedBoneNodes_;
+	glmd::uint32 indexCache_;
+
+	glmd::uint32 findKey(const std::vector< glmd::float64 >& times, glmd::float32 animationTime)
+	{
+		for (glmd::uint32 i = indexCache_; i < times.size() - 1; i++)
+		{
+			if (animationTime < (glmd::float32)times[i + 1])
+			{
+				indexCache_ = i;
+				return i;
+			}
+		}
+
+		for (glmd::uint32 i = 0; i < times.size() - 1; i++)
+		{
+			if (animationTime < (glmd::float32)times[i + 1])
+			{
+				indexCache_ = i;
+				return i;
+			}
+		}
+
+		return times.size() - 2;
+	}
+};
+
+/**
+ * The bones of one of the meshes of a character - the first half of the meshes have every bone (like createBoneData()), the others each
+ * have a different subset of the bones (picked by name length), in reverse name order.
+ */
+glr::glw::BoneData createMeshBoneData(const std::map< std::string, glr::glw::AnimatedBoneNode >& animatedBoneNodes, glmd::uint32 mesh)
+{
+	if (mesh < NUMBER_OF_MESHES / 2)
+	{
+		return createBoneData( animatedBoneNodes );
+	}
+
+	auto boneData = glr::glw::BoneData();
+
+	for ( auto it = animatedBoneNodes.rbegin(); it != animatedBoneNodes.rend(); ++it )
+	{
+		if (it->first != "root1" && it->first.size() % NUMBER_OF_MESHES <= mesh - NUMBER_OF_MESHES / 2 + 1)
+		{
+			auto bone = glr::glw::Bone();
+			bone.name = it->first;
+			bone.boneOffset = glm::translate( glm::mat4(1.0f), glm::vec3(0.0f, -1.0f, 0.0f) );
+
+			boneData.boneIndexMap[ it->first ] = boneData.boneTransform.size();
+			boneData.boneTransform.push_back( bone );
+		}
+	}
+
+	return boneData;
+}
+
+glmd::float32 getAnimationTime(glmd::uint32 character, glmd::uint32 frame)
+{
+	// Characters are spread through the animation, and play it at 60 frames per second (at 25 ticks per second)
+	return std::fmod( character * 0.37f + frame * (25.0f / 60.0f), (glmd::float32)(NUMBER_OF_KEYS - 1) );
+}
+
+glmd::float32 getCapturedAnimationTime(glmd::uint32 character, glmd::uint32 frame)
+{
+	return std::fmod( character * 2.93f + frame * (25.0f / 60.0f), (glmd::float32)(NUMBER_OF_CAPTURED_KEYS - 1) );
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(skeleton)
+
+/**
+ * Calculates the bones of a crowd of characters, all playing the same animation at different times, by walking the bone node tree and
+ * with a compiled skeleton.
+ */
+BOOST_AUTO_TEST_CASE(crowdOfCharacters)
+{
+	const auto tree = createHumanoid();
+
+	auto animatedBoneNodes = std::map< std::string, glr::glw::AnimatedBoneNode >();
+	createAnimatedBoneNodes( tree, animatedBoneNodes );
+
+	const auto boneData = createBoneData( animatedBoneNodes );
+	const glm::mat4 globalInverseTransformation = glm::translate( glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -1.0f) );
+
+	// Before: walking the tree
+	auto treeWalk = TreeWalk( animatedBoneNodes );
+	auto expected = std::vector< std::vector< glm::mat4 > >( NUMBER_OF_CHARACTERS, std::vector< glm::mat4 >(boneData.boneTransform.size()) );
+
+	auto timer = benchmark::Timer();
+	for (glmd::uint32 frame = 0; frame < NUMBER_OF_FRAMES; frame++)
+	{
+		for (glmd::uint32 c = 0; c < NUMBER_OF_CHARACTERS; c++)
+		{
+			treeWalk.calculate( expected[c], getAnimationTime(c, frame), globalInverseTransformation, tree, boneData, glm::mat4(1.0f) );
+		}
+	}
+	const glmd::float64 treeWalkTime = timer.getElapsedMilliseconds();
+
+	// After: compiled once (when the model is loaded), then a single pass over the nodes
+	timer.restart();
+	const auto skeleton = glr::glw::Skeleton( tree );
+	const auto bones = skeleton.bindBones( boneData );
+	const auto tracks = glr::glw::AnimationTracks( animatedBoneNodes );
+	const auto nodeTracks = tracks.bindNodes( skeleton );
+	const glmd::float64 compileTime = timer.getElapsedMilliseconds();
+
+	auto globalTransformations = std::vector< glm::mat4 >( skeleton.getNumberOfNodes() );
+	auto transformations = std::vector< std::vector< glm::mat4 > >( NUMBER_OF_CHARACTERS, std::vector< glm::mat4 >(bones.numberOfBones) );
+
+	timer.restart();
+	for (glmd::uint32 frame = 0; frame < NUMBER_OF_FRAMES; frame++)
+	{
+		for (glmd::uint32 c = 0; c < NUMBER_OF_CHARACTERS; c++)
+		{
+			tracks.calculateGlobalTransformations( globalTransformations, skeleton, nodeTracks, getAnimationTime(c, frame), 0, 0, globalInverseTransformation );
+			glr::glw::Skeleton::calculateBoneTransformations( transformations[c], globalTransformations, bones );
+		}
+	}
+	const glmd::float64 compiledTime = timer.getElapsedMilliseconds();
+
+	// Both give the same bones for the last frame
+	for (glmd::uint32 c = 0; c < NUMBER_OF_CHARACTERS; c++)
+	{
+		for (glmd::uint32 b = 0; b < bones.numberOfBones; b++)
+		{
+			for (glmd::uint32 i = 0; i < 4; i++)
+			{
+				for (glmd::uint32 j = 0; j < 4; j++)
+				{
+					BOOST_CHECK_SMALL( transformations[c][b][i][j] - expected[c][b][i][j], 1e-3f );
+				}
+			}
+		}
+	}
+
+	benchmark::report("skeleton", "characters", NUMBER_OF_CHARACTERS, "characters");
+	benchmark::report("skeleton", "nodes per character", skeleton.getNumberOfNodes(), "nodes");
+	benchmark::report("skeleton", "compiling the skeleton and tracks", compileTime, "ms");
+	benchmark::report("skeleton", "before (tree walk): time per frame", treeWalkTime / NUMBER_OF_FRAMES, "ms");
+	benchmark::report("skeleton", "after (compiled skeleton): time per frame", compiledTime / NUMBER_OF_FRAMES, "ms");
+	benchmark::report("skeleton", "speed up", treeWalkTime / compiledTime, "x");
+}
+
+/**
+ * Calculates the bones of a crowd of characters made of several meshes - once for each mesh, and once for each character (into a bone
+ * palette shared by all of its meshes).
+ */
+BOOST_AUTO_TEST_CASE(multiMeshCharacters)
+{
+	const auto tree = createHumanoid();
+
+	auto animatedBoneNodes = std::map< std::string, glr::glw::AnimatedBoneNode >();
+	createAnimatedBoneNodes( tree, animatedBoneNodes );
+
+	const glm::mat4 globalInverseTransformation = glm::translate( glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -1.0f) );
+
+	const auto skeleton = glr::glw::Skeleton( tree );
+	const auto tracks = glr::glw::AnimationTracks( animatedBoneNodes );
+	const auto nodeTracks = tracks.bindNodes( skeleton );
+
+	auto meshBones = std::vector< glr::glw::SkeletonBones >();
+	for (glmd::uint32 m = 0; m < NUMBER_OF_MESHES; m++)
+	{
+		meshBones.push_back( skeleton.bindBones( createMeshBoneData(animatedBoneNodes, m) ) );
+	}
+
+	auto globalTransformations = std::vector< glm::mat4 >( skeleton.getNumberOfNodes() );
+
+	// Before: the pose is calculated for every mesh
+	auto expected = std::vector< std::vector< glm::mat4 > >();
+	for ( auto& bones : meshBones )
+	{
+		expected.push_back( std::vector< glm::mat4 >(bones.numberOfBones) );
+	}
+
+	auto timer = benchmark::Timer();
+	for (glmd::uint32 frame = 0; frame < NUMBER_OF_FRAMES; frame++)
+	{
+		for (glmd::uint32 c = 0; c < NUMBER_OF_CHARACTERS; c++)
+		{
+			for (glmd::uint32 m = 0; m < NUMBER_OF_MESHES; m++)
+			{
+				tracks.calculateGlobalTransformations( globalTransformations, skeleton, nodeTracks, getAnimationTime(c, frame), 0, 0, globalInverseTransformation );
+				glr::glw::Skeleton::calculateBoneTransformations( expected[m], globalTransformations, meshBones[m] );
+			}
+		}
+	}
+	const glmd::float64 perMeshTime = timer.getElapsedMilliseconds();
+
+	// After: the pose is calculated once into the palette, and the meshes that don't use it as is gather their bones from it
+	const auto palette = glr::glw::Skeleton::createPalette( meshBones );
+
+	auto paletteTransformations = std::vector< glm::mat4 >( palette.bones.numberOfBones, glm::mat4() );
+	auto meshTransformations = std::vector< std::vector< glm::mat4 > >();
+	for ( auto& bones : meshBones )
+	{
+		meshTransformations.push_back( std::vector< glm::mat4 >(bones.numberOfBones) );
+	}
+
+	timer.restart();
+	for (glmd::uint32 frame = 0; frame < NUMBER_OF_FRAMES; frame++)
+	{
+		for (glmd::uint32 c = 0; c < NUMBER_OF_CHARACTERS; c++)
+		{
+			tracks.calculateGlobalTransformations( globalTransformations, skeleton, nodeTracks, getAnimationTime(c, frame), 0, 0, globalInverseTransformation );
+			glr::glw::Skeleton::calculateBoneTransformations( paletteTransformations, globalTransformations, palette.bones );
+
+			for (glmd::uint32 m = 0; m < NUMBER_OF_MESHES; m++)
+			{
+				if ( !palette.remaps[m].empty() )
+				{
+					glr::glw::Skeleton::remapBoneTransformations( meshTransformations[m], paletteTransformations, palette.remaps[m] );
+				}
+			}
+		}
+	}
+	const glmd::float64 paletteTime = timer.getElapsedMilliseconds();
+
+	// Both give the same bones for the last frame
+	glmd::uint32 numberOfRemappedMeshes = 0;
+	for (glmd::uint32 m = 0; m < NUMBER_OF_MESHES; m++)
+	{
+		const bool isRemapped = !palette.remaps[m].empty();
+		numberOfRemappedMeshes += (isRemapped ? 1 : 0);
+
+		for (glmd::uint32 b = 0; b < meshBones[m].numberOfBones; b++)
+		{
+			const glm::mat4& transformation = (isRemapped ? meshTransformations[m][b] : paletteTransformations[b]);
+
+			for (glmd::uint32 i = 0; i < 4; i++)
+			{
+				for (glmd::uint32 j = 0; j < 4; j++)
+				{
+					BOOST_CHECK_SMALL( transformation[i][j] - expected[m][b][i][j], 1e-3f );
+				}
+			}
+		}
+	}
+
+	benchmark::report("skeleton", "meshes per character", NUMBER_OF_MESHES, "meshes");
+	benchmark::report("skeleton", "meshes sharing the bone palette as is", NUMBER_OF_MESHES - numberOfRemappedMeshes, "meshes");
+	benchmark::report("skeleton", "bone palette slots", palette.bones.numberOfBones, "bones");
+	benchmark::report("skeleton", "before (pose per mesh): time per frame", perMeshTime / NUMBER_OF_FRAMES, "ms");
+	benchmark::report("skeleton", "after (pose per model): time per frame", paletteTime / NUMBER_OF_FRAMES, "ms");
+	benchmark::report("skeleton", "cpu time saved per frame", (perMeshTime - paletteTime) / NUMBER_OF_FRAMES, "ms");
+	benchmark::report("skeleton", "speed up", perMeshTime / paletteTime, "x");
+}
+
+/**
+ * Calculates the bones of a crowd of 1000 characters each frame, spread across a thread pool the way AnimationManager::update() spreads
+ * its animation instances (a few chunks of instances per thread, with the calling thread running chunks too).
+ */
+BOOST_AUTO_TEST_CASE(parallelCrowdUpdate)
+{
+	const auto tree = createHumanoid();
+
+	auto animatedBoneNodes = std::map< std::string, glr::glw::AnimatedBoneNode >();
+	createAnimatedBoneNodes( tree, animatedBoneNodes );
+
+	const glm::mat4 globalInverseTransformation = glm::translate( glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -1.0f) );
+
+	const auto skeleton = glr::glw::Skeleton( tree );
+	const auto bones = skeleton.bindBones( createBoneData(animatedBoneNodes) );
+	const auto tracks = glr::glw::AnimationTracks( animatedBoneNodes );
+	const auto nodeTracks = tracks.bindNodes( skeleton );
+
+	// Each instance has its own pose (and scratch space), like each model does
+	struct Instance
+	{
+		std::vector< glm::mat4 > globalTransformations;
+		std::vector< glm::mat4 > transformations;
+	};
+
+	auto instances = std::vector< Instance >( NUMBER_OF_INSTANCES );
+	for ( auto& instance : instances )
+	{
+		instance.globalTransformations.resize( skeleton.getNumberOfNodes() );
+		instance.transformations.resize( bones.numberOfBones );
+	}
+
+	auto updateInstances = [&](glmd::uint32 frame, glmd::uint32 begin, glmd::uint32 end) {
+		for (glmd::uint32 i = begin; i < end; i++)
+		{
+			tracks.calculateGlobalTransformations( instances[i].globalTransformations, skeleton, nodeTracks, getAnimationTime(i, frame), 0, 0, globalInverseTransformation );
+			glr::glw::Skeleton::calculateBoneTransformations( instances[i].transformations, instances[i].globalTransformations, bones );
+		}
+	};
+
+	// Before: every instance is updated on the rendering thread
+	auto timer = benchmark::Timer();
+	for (glmd::uint32 frame = 0; frame < NUMBER_OF_FRAMES; frame++)
+	{
+		updateInstances( frame, 0, NUMBER_OF_INSTANCES );
+	}
+	const glmd::float64 serialTime = timer.getElapsedMilliseconds();
+
+	const auto expected = instances;
+
+	benchmark::report("skeleton", "animation instances", NUMBER_OF_INSTANCES, "instances");
+	benchmark::report("skeleton", "before (1 thread): time per frame", serialTime / NUMBER_OF_FRAMES, "ms");
+
+	// After: the instances are spread across a thread pool (the calling thread makes one more thread) - thread counts past the number of
+	// hardware threads show the cost of the scheduling, rather than any speed up
+	const glmd::uint32 numberOfHardwareThreads = std::max( std::thread::hardware_concurrency(), 1u );
+	benchmark::report("skeleton", "hardware threads", numberOfHardwareThreads, "threads");
+
+	auto threadCounts = std::vector< glmd::uint32 >( { 2, 4 } );
+	if (numberOfHardwareThreads > 4)
+	{
+		threadCounts.push_back( numberOfHardwareThreads );
+	}
+
+	for ( auto numberOfThreads : threadCounts )
+	{
+		glr::ThreadPool pool( numberOfThreads - 1 );
+		const glmd::uint32 chunkSize = std::max( NUMBER_OF_INSTANCES / (numberOfThreads * 4), 1u );
+
+		timer.restart();
+		for (glmd::uint32 frame = 0; frame < NUMBER_OF_FRAMES; frame++)
+		{
+			pool.parallelFor( NUMBER_OF_INSTANCES, chunkSize, [&updateInstances, frame](glmd::uint32 begin, glmd::uint32 end) {
+				updateInstances( frame, begin, end );
+			} );
+		}
+		const glmd::float64 parallelTime = timer.getElapsedMilliseconds();
+
+		// The same bones as the serial update
+		for (glmd::uint32 i = 0; i < NUMBER_OF_INSTANCES; i++)
+		{
+			BOOST_CHECK( instances[i].transformations == expected[i].transformations );
+		}
+
+		const std::string threads = std::to_string(numberOfThreads) + " threads";
+		benchmark::report("skeleton", "after (" + threads + "): time per frame", parallelTime / NUMBER_OF_FRAMES, "ms");
+		benchmark::report("skeleton", "after (" + threads + "): speed up", serialTime / parallelTime, "x");
+	}
+}
+
+/**
+ * Calculates the bones of a crowd of characters playing motion capture clips (a different clip for each group of characters, so the keys
+ * don't all stay in the cache), with the clips as imported, and resampled and quantized (with and without key reduction).
+ */
+BOOST_AUTO_TEST_CASE(compressedClips)
+{
+	const auto tree = createHumanoid();
+	const auto skeleton = glr::glw::Skeleton( tree );
+
+	const glmd::float64 duration = NUMBER_OF_CAPTURED_KEYS - 1;
+	const glm::mat4 globalInverseTransformation = glm::translate( glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -1.0f) );
+
+	// Resampled at the rate the clips were captured at
+	auto settings = glr::glw::AnimationCompressionSettings();
+	settings.isEnabled = true;
+	settings.sampleRate = 25.0f;
+
+	auto tracks = std::vector< glr::glw::AnimationTracks >();
+	auto sampledTracks = std::vector< glr::glw::SampledAnimationTracks >();
+	auto reducedTracks = std::vector< glr::glw::SampledAnimationTracks >();
+
+	glmd::uint32 animatedBoneNodesMemoryUsage = 0;
+	glmd::uint32 numberOfKeys = 0;
+	glmd::float64 compressTime = 0.0;
+
+	for (glmd::uint32 clip = 0; clip < NUMBER_OF_CLIPS; clip++)
+	{
+		const auto animatedBoneNodes = createCapturedAnimatedBoneNodes( skeleton, clip );
+
+		animatedBoneNodesMemoryUsage += getMemoryUsage( animatedBoneNodes );
+		for ( auto& kv : animatedBoneNodes )
+		{
+			numberOfKeys += kv.second.positionTimes.size() + kv.second.rotationTimes.size() + kv.second.scalingTimes.size();
+		}
+
+		tracks.push_back( glr::glw::AnimationTracks(animatedBoneNodes) );
+
+		settings.isKeyReductionEnabled = false;
+		sampledTracks.push_back( glr::glw::SampledAnimationTracks(animatedBoneNodes, duration, 25.0, settings) );
+
+		settings.isKeyReductionEnabled = true;
+
+		auto timer = benchmark::Timer();
+		reducedTracks.push_back( glr::glw::SampledAnimationTracks(animatedBoneNodes, duration, 25.0, settings) );
+		compressTime += timer.getElapsedMilliseconds();
+	}
+
+	// Every clip animates the same nodes
+	const auto nodeTracks = tracks[0].bindNodes( skeleton );
+	const auto bones = skeleton.bindBones( createBoneData(createCapturedAnimatedBoneNodes(skeleton, 0)) );
+
+	BOOST_REQUIRE( sampledTracks[0].bindNodes(skeleton) == nodeTracks );
+	BOOST_REQUIRE( reducedTracks[0].bindNodes(skeleton) == nodeTracks );
+
+	auto globalTransformations = std::vector< glm::mat4 >( skeleton.getNumberOfNodes() );
+	auto transformations = std::vector< std::vector< glm::mat4 > >( NUMBER_OF_CHARACTERS, std::vector< glm::mat4 >(bones.numberOfBones) );
+
+	auto calculateCrowd = [&](const std::function<void(glmd::uint32, glmd::float32)>& calculateGlobalTransformations) {
+		auto timer = benchmark::Timer();
+		for (glmd::uint32 frame = 0; frame < NUMBER_OF_FRAMES; frame++)
+		{
+			for (glmd::uint32 c = 0; c < NUMBER_OF_CHARACTERS; c++)
+			{
+				calculateGlobalTransformations( c % NUMBER_OF_CLIPS, getCapturedAnimationTime(c, frame) );
+				glr::glw::Skeleton::calculateBoneTransformations( transformations[c], globalTransformations, bones );
+			}
+		}
+
+		return timer.getElapsedMilliseconds();
+	};
+
+	// The largest difference from the bones of the imported clips, for the last frame
+	auto getMaximumError = [&](const std::vector< std::vector< glm::mat4 > >& expected) {
+		glmd::float32 maximumError = 0.0f;
+		for (glmd::uint32 c = 0; c < NUMBER_OF_CHARACTERS; c++)
+		{
+			for (glmd::uint32 b = 0; b < bones.numberOfBones; b++)
+			{
+				for (glmd::uint32 i = 0; i < 4; i++)
+				{
+					for (glmd::uint32 j = 0; j < 4; j++)
+					{
+						maximumError = std::max( maximumError, std::abs(transformations[c][b][i][j] - expected[c][b][i][j]) );
+					}
+				}
+			}
+		}
+
+		return maximumError;
+	};
+
+	// Before: the clips as imported
+	const glmd::float64 tracksTime = calculateCrowd( [&](glmd::uint32 clip, glmd::float32 time) {
+		tracks[clip].calculateGlobalTransformations( globalTransformations, skeleton, nodeTracks, time, 0, 0, globalInverseTransformation );
+	} );
+	const auto expected = transformations;
+
+	// After: resampled and quantized
+	const glmd::float64 sampledTime = calculateCrowd( [&](glmd::uint32 clip, glmd::float32 time) {
+		sampledTracks[clip].calculateGlobalTransformations( globalTransformations, skeleton, nodeTracks, time, 0, 0, globalInverseTransformation );
+	} );
+	const glmd::float32 sampledError = getMaximumError( expected );
+
+	const glmd::float64 reducedTime = calculateCrowd( [&](glmd::uint32 clip, glmd::float32 time) {
+		reducedTracks[clip].calculateGlobalTransformations( globalTransformations, skeleton, nodeTracks, time, 0, 0, globalInverseTransformation );
+	} );
+	const glmd::float32 reducedError = getMaximumError( expected );
+
+	// The error of each node adds up along the bone chains
+	BOOST_CHECK_SMALL( sampledError, 0.01f );
+	BOOST_CHECK_SMALL( reducedError, 0.01f );
+
+	auto getTotalMemoryUsage = [](const std::vector< glr::glw::SampledAnimationTracks >& clips) {
+		glmd::uint32 memoryUsage = 0;
+		for ( auto& clip : clips )
+		{
+			memoryUsage += clip.getMemoryUsage();
+		}
+
+		return memoryUsage;
+	};
+
+	glmd::uint32 tracksMemoryUsage = 0;
+	glmd::uint32 sampledNumberOfKeys = 0;
+	glmd::uint32 reducedNumberOfKeys = 0;
+	for (glmd::uint32 clip = 0; clip < NUMBER_OF_CLIPS; clip++)
+	{
+		tracksMemoryUsage += tracks[clip].getMemoryUsage();
+		sampledNumberOfKeys += sampledTracks[clip].getNumberOfKeys();
+		reducedNumberOfKeys += reducedTracks[clip].getNumberOfKeys();
+	}
+
+	benchmark::report("skeleton", "clips", NUMBER_OF_CLIPS, "clips");
+	benchmark::report("skeleton", "clip length", NUMBER_OF_CAPTURED_KEYS, "keys");
+	benchmark::report("skeleton", "memory: animated bone nodes", animatedBoneNodesMemoryUsage / 1024.0, "KiB");
+	benchmark::report("skeleton", "memory: before (tracks)", tracksMemoryUsage / 1024.0, "KiB");
+	benchmark::report("skeleton", "memory: after (sampled tracks)", getTotalMemoryUsage(sampledTracks) / 1024.0, "KiB");
+	benchmark::report("skeleton", "memory: after (sampled tracks, key reduction)", getTotalMemoryUsage(reducedTracks) / 1024.0, "KiB");
+	benchmark::report("skeleton", "keys: before", numberOfKeys, "keys");
+	benchmark::report("skeleton", "keys: after", sampledNumberOfKeys, "keys");
+	benchmark::report("skeleton", "keys: after (key reduction)", reducedNumberOfKeys, "keys");
+	benchmark::report("skeleton", "compressing a clip", compressTime / NUMBER_OF_CLIPS, "ms");
+	benchmark::report("skeleton", "before (tracks): time per frame", tracksTime / NUMBER_OF_FRAMES, "ms");
+	benchmark::report("skeleton", "after (sampled tracks): time per frame", sampledTime / NUMBER_OF_FRAMES, "ms");
+	benchmark::report("skeleton", "after (sampled tracks, key reduction): time per frame", reducedTime / NUMBER_OF_FRAMES, "ms");
+	benchmark::report("skeleton", "after (sampled tracks): maximum bone error", sampledError, "model units");
+	benchmark::report("skeleton", "after (sampled tracks, key reduction): maximum bone error", reducedError, "model units");
+}
+
+/**
+ * Calculates the bones of a crowd of characters, each with its own blend tree - an N-way blend of locomotion clips, with an additive lean
+ * on top and a wave layered over the upper body - for an increasing number of active locomotion clips.
+ */
+BOOST_AUTO_TEST_CASE(blendedCharacters)
+{
+	const auto tree = createHumanoid();
+	const auto skeleton = glr::glw::Skeleton( tree );
+	const auto bones = skeleton.bindBones( createBoneData(createCapturedAnimatedBoneNodes(skeleton, 0)) );
+
+	const glmd::float64 duration = NUMBER_OF_CAPTURED_KEYS - 1;
+	const glm::mat4 globalInverseTransformation = glm::translate( glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -1.0f) );
+
+	// Locomotion clips, then the lean and the wave
+	auto animations = std::vector< std::unique_ptr<glr::glw::Animation> >();
+	for (glmd::uint32 clip = 0; clip < NUMBER_OF_LOCOMOTION_CLIPS + 2; clip++)
+	{
+		animations.push_back( std::unique_ptr<glr::glw::Animation>(
+			new glr::glw::Animation( nullptr, "clip" + std::to_string(clip), duration, 25.0, createCapturedAnimatedBoneNodes(skeleton, clip), false )
+		) );
+	}
+
+	auto getStartTime = [](glmd::uint32 character) {
+		return character * 2.93f / 25.0f;
+	};
+
+	// Every character has the same tree
+	auto blendTrees = std::vector< glr::glw::BlendTree >( NUMBER_OF_CHARACTERS );
+	auto clips = std::vector< glmd::uint32 >();
+	auto locomotion = glmd::uint32();
+	auto lean = glmd::uint32();
+	auto wave = glmd::uint32();
+
+	for (glmd::uint32 c = 0; c < NUMBER_OF_CHARACTERS; c++)
+	{
+		auto& blendTree = blendTrees[c];
+
+		clips.clear();
+		for (glmd::uint32 clip = 0; clip < NUMBER_OF_LOCOMOTION_CLIPS; clip++)
+		{
+			clips.push_back( blendTree.addClip(animations[clip].get(), getStartTime(c)) );
+		}
+
+		locomotion = blendTree.addBlend( clips );
+
+		clips.push_back( blendTree.addClip(animations[NUMBER_OF_LOCOMOTION_CLIPS].get(), getStartTime(c)) );
+		lean = blendTree.addAdditive( locomotion, clips.back(), -1, 0.0f );
+
+		clips.push_back( blendTree.addClip(animations[NUMBER_OF_LOCOMOTION_CLIPS + 1].get(), getStartTime(c)) );
+		wave = blendTree.addLayer( lean, clips.back(), { "spine4" }, 0.0f );
+
+		// Allocates the scratch poses - nothing is allocated per frame
+		blendTree.bind( skeleton );
+	}
+
+	auto globalTransformations = std::vector< glm::mat4 >( skeleton.getNumberOfNodes() );
+	auto transformations = std::vector< std::vector< glm::mat4 > >( NUMBER_OF_CHARACTERS, std::vector< glm::mat4 >(bones.numberOfBones) );
+
+	auto calculateCrowd = [&]() {
+		// The clips start where the single animation did, so the bones of a single clip match
+		for (glmd::uint32 c = 0; c < NUMBER_OF_CHARACTERS; c++)
+		{
+			for ( auto clip : clips )
+			{
+				blendTrees[c].setAnimationTime( clip, getStartTime(c) );
+			}
+		}
+
+		auto timer = benchmark::Timer();
+		for (glmd::uint32 frame = 0; frame < NUMBER_OF_FRAMES; frame++)
+		{
+			for (glmd::uint32 c = 0; c < NUMBER_OF_CHARACTERS; c++)
+			{
+				blendTrees[c].calculatePose( transformations[c], globalTransformations, globalInverseTransformation, skeleton, bones );
+				blendTrees[c].advance( 1.0f / 60.0f );
+			}
+		}
+
+		return timer.getElapsedMilliseconds();
+	};
+
+	// Before: a single animation, without a blend tree
+	auto timer = benchmark::Timer();
+	const auto nodeTracks = animations[0]->bindNodes( skeleton );
+	for (glmd::uint32 frame = 0; frame < NUMBER_OF_FRAMES; frame++)
+	{
+		for (glmd::uint32 c = 0; c < NUMBER_OF_CHARACTERS; c++)
+		{
+			const glmd::float32 runningTime = getStartTime(c) + frame / 60.0f;
+			animations[0]->calculatePose( transformations[c], globalTransformations, globalInverseTransformation, skeleton, nodeTracks, bones, runningTime, 0, 0 );
+		}
+	}
+	const glmd::float64 singleClipTime = timer.getElapsedMilliseconds();
+	const auto expected = transformations;
+
+	benchmark::report("skeleton", "characters", NUMBER_OF_CHARACTERS, "characters");
+	benchmark::report("skeleton", "blend tree nodes per character", blendTrees[0].getNumberOfNodes(), "nodes");
+	benchmark::report("skeleton", "scratch poses per character", blendTrees[0].getNumberOfNodes() * skeleton.getNumberOfNodes() * 10 * sizeof(glmd::float32) / 1024.0, "KiB");
+	benchmark::report("skeleton", "before (single animation): time per frame", singleClipTime / NUMBER_OF_FRAMES, "ms");
+
+	// After: the blend tree, with 1 to NUMBER_OF_LOCOMOTION_CLIPS locomotion clips weighted in (clips with no weight cost nothing)
+	for (glmd::uint32 numberOfActiveClips = 1; numberOfActiveClips <= NUMBER_OF_LOCOMOTION_CLIPS; numberOfActiveClips *= 2)
+	{
+		auto weights = std::vector< glmd::float32 >( NUMBER_OF_LOCOMOTION_CLIPS, 0.0f );
+		std::fill( weights.begin(), weights.begin() + numberOfActiveClips, 1.0f );
+
+		for ( auto& blendTree : blendTrees )
+		{
+			blendTree.setWeights( locomotion, weights );
+		}
+
+		const glmd::float64 blendTime = calculateCrowd();
+		BOOST_CHECK_EQUAL( blendTrees[0].getNumberOfActiveClips(), numberOfActiveClips );
+
+		if (numberOfActiveClips == 1)
+		{
+			glmd::float32 maximumError = 0.0f;
+			for (glmd::uint32 c = 0; c < NUMBER_OF_CHARACTERS; c++)
+			{
+				for (glmd::uint32 b = 0; b < bones.numberOfBones; b++)
+				{
+					for (glmd::uint32 i = 0; i < 4; i++)
+					{
+						for (glmd::uint32 j = 0; j < 4; j++)
+						{
+							maximumError = std::max( maximumError, std::abs(transformations[c][b][i][j] - expected[c][b][i][j]) );
+						}
+					}
+				}
+			}
+
+			// The clip times are advanced a frame at a time, so they round differently - and the error adds up along the bone chains
+			BOOST_CHECK_SMALL( maximumError, 0.01f );
+		}
+
+		const std::string label = std::to_string( numberOfActiveClips ) + (numberOfActiveClips == 1 ? " clip" : " clips");
+		benchmark::report("skeleton", "after (blend tree, " + label + "): time per frame", blendTime / NUMBER_OF_FRAMES, "ms");
+		benchmark::report("skeleton", "after (blend tree, " + label + "): time per active clip", blendTime / NUMBER_OF_FRAMES / numberOfActiveClips, "ms");
+	}
+
+	// The lean and the wave on top of the blend of every locomotion clip
+	for ( auto& blendTree : blendTrees )
+	{
+		blendTree.setWeight( lean, 0.5f );
+		blendTree.setWeight( wave, 1.0f );
+	}
+
+	const glmd::float64 layeredTime = calculateCrowd();
+	BOOST_CHECK_EQUAL( blendTrees[0].getNumberOfActiveClips(), NUMBER_OF_LOCOMOTION_CLIPS + 2 );
+
+	const std::string label = std::to_string( NUMBER_OF_LOCOMOTION_CLIPS ) + " clips, additive and layer";
+	benchmark::report("skeleton", "after (blend tree, " + label + "): time per frame", layeredTime / NUMBER_OF_FRAMES, "ms");
+	benchmark::report("skeleton", "after (blend tree, " + label + "): time per active clip", layeredTime / NUMBER_OF_FRAMES / (NUMBER_OF_LOCOMOTION_CLIPS + 2), "ms");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,150 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "Benchmark.hpp"
+
+#include "terrain/TerrainEdit.hpp"
+#include "terrain/TerrainSettings.hpp"
+#include "terrain/VoxelChunk.hpp"
+#include "terrain/VoxelChunkNoiseGenerator.hpp"
+#include "terrain/marching_cubes/VoxelChunkMeshGenerator.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const glm::ivec3 DIMENSIONS = glm::ivec3(8, 4, 8);
+
+// Digging with a 4 unit sphere, along a line across the hills
+const glmd::uint32 NUMBER_OF_EDITS = 32;
+const glmd::float32 EDIT_RADIUS = 4.0f;
+
+/**
+ * Generates the mesh for the chunk, using the edited density values (if any).
+ *
+ * @return The number of triangles in the mesh.
+ */
+glmd::uint64 generateMesh(const glr::terrain::marching_cubes::VoxelChunkMeshGenerator& meshGenerator, glr::terrain::IFieldFunction& fieldFunction, const glm::ivec3& coordinates, const glr::terrain::DensityGrid* editedDensities)
+{
+	auto vertices = std::vector< glm::vec3 >();
+	auto normals = std::vector< glm::vec3 >();
+	auto textureBlendingValues = std::vector< glm::vec4 >();
+	auto indices = std::vector< glmd::uint32 >();
+
+	auto chunk = glr::terrain::VoxelChunk(coordinates.x, coordinates.y, coordinates.z);
+	glr::terrain::generateNoise(chunk, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, fieldFunction);
+
+	if (editedDensities != nullptr)
+	{
+		glr::terrain::copyEditedDensities(*editedDensities, chunk);
+	}
+
+	if (!glr::terrain::determineIfEmptyOrSolid(chunk))
+	{
+		meshGenerator.generateMesh(chunk, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, vertices, normals, textureBlendingValues, indices);
+	}
+
+	return indices.size() / 3;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(terrainEdit)
+
+BOOST_AUTO_TEST_CASE(editLatency)
+{
+	const auto settings = glr::terrain::TerrainSettings();
+
+	auto fieldFunction = benchmark::HillsFieldFunction();
+	auto meshGenerator = glr::terrain::marching_cubes::VoxelChunkMeshGenerator(settings);
+
+	const glmd::int32 numberOfChunks = DIMENSIONS.x * DIMENSIONS.y * DIMENSIONS.z;
+
+	// Before: the only way to change the terrain was to generate all of it again
+	auto timer = benchmark::Timer();
+
+	glmd::uint64 numberOfTriangles = 0;
+
+	for (glmd::int32 x=0; x < DIMENSIONS.x; x++)
+	{
+		for (glmd::int32 y=0; y < DIMENSIONS.y; y++)
+		{
+			for (glmd::int32 z=0; z < DIMENSIONS.z; z++)
+			{
+				numberOfTriangles += generateMesh(meshGenerator, fieldFunction, glm::ivec3(x, y, z), nullptr);
+			}
+		}
+	}
+
+	const glmd::float64 fullRegenerationTime = timer.getElapsedMilliseconds();
+
+	// After: each edit updates the density values of the chunks it touches, and only those chunks are remeshed (this is the work
+	// TerrainManager::applyEdit() hands to the worker threads)
+	auto editedChunks = std::vector< glr::terrain::VoxelChunk >( numberOfChunks );
+	auto isEdited = std::vector< bool >( numberOfChunks, false );
+
+	glmd::uint64 numberOfChunksRemeshed = 0;
+	glmd::float64 totalEditTime = 0.0;
+	glmd::float64 maxEditTime = 0.0;
+
+	for (glmd::uint32 i=0; i < NUMBER_OF_EDITS; i++)
+	{
+		const glmd::float32 x = -60.0f + 120.0f * (glmd::float32)i / (glmd::float32)NUMBER_OF_EDITS;
+		const glmd::float32 z = 0.5f * x;
+		const glmd::float32 height = fieldFunction.getNoise(x, 0.0f, z) * -1.0f;
+
+		const auto edit = glr::terrain::TerrainEdit(glr::terrain::EDIT_SHAPE_SPHERE, glr::terrain::EDIT_OPERATION_REMOVE, glm::vec3(x, height, z), glm::vec3(EDIT_RADIUS));
+
+		timer.restart();
+
+		for ( auto& coordinates : glr::terrain::getChunksAffectedByEdit(edit, DIMENSIONS) )
+		{
+			const glmd::int32 index = (coordinates.x * DIMENSIONS.y + coordinates.y) * DIMENSIONS.z + coordinates.z;
+			auto& chunk = editedChunks[index];
+
+			if (!isEdited[index])
+			{
+				chunk = glr::terrain::VoxelChunk(coordinates.x, coordinates.y, coordinates.z);
+				glr::terrain::generateNoise(chunk, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, fieldFunction);
+			}
+
+			const glm::vec3 origin = glr::terrain::getChunkOrigin(coordinates.x, coordinates.y, coordinates.z, DIMENSIONS);
+
+			if ( glr::terrain::applyEdit(edit, chunk.points, origin) )
+			{
+				isEdited[index] = true;
+
+				generateMesh(meshGenerator, fieldFunction, coordinates, &chunk.points);
+				numberOfChunksRemeshed++;
+			}
+		}
+
+		const glmd::float64 editTime = timer.getElapsedMilliseconds();
+
+		totalEditTime += editTime;
+		maxEditTime = std::max(maxEditTime, editTime);
+	}
+
+	BOOST_CHECK( numberOfTriangles > 0 );
+	BOOST_CHECK( numberOfChunksRemeshed > 0 );
+	BOOST_CHECK( numberOfChunksRemeshed < (glmd::uint64)NUMBER_OF_EDITS * numberOfChunks );
+
+	benchmark::report("terrainEdit", "chunks", (glmd::float64)numberOfChunks, "chunks");
+	benchmark::report("terrainEdit", "full regeneration: time", fullRegenerationTime, "ms");
+	benchmark::report("terrainEdit", "incremental: chunks remeshed per edit", (glmd::float64)numberOfChunksRemeshed / NUMBER_OF_EDITS, "chunks");
+	benchmark::report("terrainEdit", "incremental: average time per edit", totalEditTime / NUMBER_OF_EDITS, "ms");
+	benchmark::report("terrainEdit", "incremental: worst time per edit", maxEditTime, "ms");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
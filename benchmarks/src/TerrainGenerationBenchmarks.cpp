@@ -0,0 +1,109 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <atomic>
+#include <functional>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "Benchmark.hpp"
+
+#include "ThreadPool.hpp"
+#include "MpscQueue.hpp"
+
+#include "terrain/VoxelChunk.hpp"
+#include "terrain/VoxelChunkNoiseGenerator.hpp"
+#include "terrain/marching_cubes/VoxelChunkMeshGenerator.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const glmd::int32 WORLD_SIZE = 8;
+
+/**
+ * The work TerrainManager does on a worker thread for each chunk: noise, the empty/solid test, and meshing.
+ *
+ * @return True if the chunk has a mesh; false if it is empty or solid.
+ */
+bool generateChunk(glmd::int32 x, glmd::int32 y, glmd::int32 z, glr::terrain::IFieldFunction& fieldFunction, const glr::terrain::IVoxelChunkMeshGenerator& meshGenerator)
+{
+	auto chunk = glr::terrain::VoxelChunk(x, y, z);
+	glr::terrain::generateNoise(chunk, WORLD_SIZE, WORLD_SIZE, WORLD_SIZE, fieldFunction);
+
+	if (glr::terrain::determineIfEmptyOrSolid(chunk))
+		return false;
+
+	auto vertices = std::vector< glm::vec3 >();
+	auto normals = std::vector< glm::vec3 >();
+	auto textureBlendingValues = std::vector< glm::vec4 >();
+	auto indices = std::vector< glmd::uint32 >();
+
+	meshGenerator.generateMesh(chunk, WORLD_SIZE, WORLD_SIZE, WORLD_SIZE, vertices, normals, textureBlendingValues, indices);
+
+	return true;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(terrainGeneration)
+
+BOOST_AUTO_TEST_CASE(serialVsThreadPool)
+{
+	auto fieldFunction = benchmark::HillsFieldFunction();
+	auto meshGenerator = glr::terrain::marching_cubes::VoxelChunkMeshGenerator();
+	const glmd::int32 numberOfChunks = WORLD_SIZE * WORLD_SIZE * WORLD_SIZE;
+
+	// Before: every chunk generated in turn on the calling thread
+	glmd::uint32 serialSurfaceChunks = 0;
+
+	auto timer = benchmark::Timer();
+	for (glmd::int32 x=0; x < WORLD_SIZE; x++)
+		for (glmd::int32 y=0; y < WORLD_SIZE; y++)
+			for (glmd::int32 z=0; z < WORLD_SIZE; z++)
+				if (generateChunk(x, y, z, fieldFunction, meshGenerator))
+					serialSurfaceChunks++;
+	const glmd::float64 serialTime = timer.getElapsedMilliseconds();
+
+	// After: chunks generated by the thread pool, and handed back to the 'OpenGL' thread through an MPSC queue
+	glr::ThreadPool pool;
+	glr::MpscQueue< std::function<void()> > finishedChunks;
+	glmd::uint32 pooledSurfaceChunks = 0;
+
+	timer.restart();
+	for (glmd::int32 x=0; x < WORLD_SIZE; x++)
+	{
+		for (glmd::int32 y=0; y < WORLD_SIZE; y++)
+		{
+			for (glmd::int32 z=0; z < WORLD_SIZE; z++)
+			{
+				auto job = [x, y, z, &fieldFunction, &meshGenerator, &finishedChunks, &pooledSurfaceChunks] {
+					if (generateChunk(x, y, z, fieldFunction, meshGenerator))
+						finishedChunks.push( [&pooledSurfaceChunks] { pooledSurfaceChunks++; } );
+				};
+
+				pool.enqueue(0, 0.0f, job);
+			}
+		}
+	}
+	pool.waitForAll();
+
+	auto work = std::function<void()>();
+	while (finishedChunks.pop(work))
+		work();
+	const glmd::float64 pooledTime = timer.getElapsedMilliseconds();
+
+	BOOST_CHECK_EQUAL( serialSurfaceChunks, pooledSurfaceChunks );
+
+	benchmark::report("terrainGeneration", "worker threads", (glmd::float64)pool.getNumberOfThreads(), "threads");
+	benchmark::report("terrainGeneration", "serial: throughput", numberOfChunks / (serialTime / 1000.0), "chunks/s");
+	benchmark::report("terrainGeneration", "thread pool: throughput", numberOfChunks / (pooledTime / 1000.0), "chunks/s");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,155 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "Benchmark.hpp"
+
+#include "terrain/TerrainSettings.hpp"
+#include "terrain/VoxelChunk.hpp"
+#include "terrain/VoxelChunkNoiseGenerator.hpp"
+#include "terrain/marching_cubes/VoxelChunkMeshGenerator.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+// Enough chunks to fill TerrainSettings::maxViewDistance (256) around the origin
+const glmd::int32 WORLD_LENGTH = 32;
+const glmd::int32 WORLD_WIDTH = 4;
+const glmd::int32 WORLD_HEIGHT = 32;
+
+// Bytes per vertex that we upload for terrain (position, normal, and texture blending values)
+const glmd::uint64 BYTES_PER_VERTEX = sizeof(glm::vec3) + sizeof(glm::vec3) + sizeof(glm::vec4);
+
+struct MeshTotals
+{
+	MeshTotals() : numberOfVertices(0), numberOfIndices(0), time(0.0)
+	{
+	}
+
+	glmd::uint64 numberOfVertices;
+	glmd::uint64 numberOfIndices;
+	glmd::float64 time;
+
+	glmd::uint64 getBytes() const
+	{
+		return numberOfVertices * BYTES_PER_VERTEX + numberOfIndices * sizeof(glmd::uint32);
+	}
+};
+
+/**
+ * Returns the distance between the center of the chunk and the origin (where the camera is).
+ */
+glmd::float32 getDistance(glmd::int32 x, glmd::int32 y, glmd::int32 z, const glr::terrain::TerrainSettings& settings)
+{
+	const glmd::float32 chunkSize = (glmd::float32)settings.chunkSize;
+
+	const glm::vec3 center = glm::vec3(
+		(glmd::float32)(x - WORLD_LENGTH/2) * chunkSize + chunkSize/2.0f,
+		(glmd::float32)(y - WORLD_WIDTH/2) * chunkSize + chunkSize/2.0f,
+		(glmd::float32)(z - WORLD_HEIGHT/2) * chunkSize + chunkSize/2.0f
+	);
+
+	return glm::length(center);
+}
+
+/**
+ * The same rings as TerrainManager::getNewTerrainLod().
+ */
+glr::terrain::LevelOfDetail getLevelOfDetail(glmd::float32 distance, const glr::terrain::TerrainSettings& settings)
+{
+	if (distance <= settings.lodHighestRadius)
+		return glr::terrain::LOD_HIGHEST;
+	if (distance <= settings.lodHighRadius)
+		return glr::terrain::LOD_HIGH;
+	if (distance <= settings.lodMediumRadius)
+		return glr::terrain::LOD_MEDIUM;
+	if (distance <= settings.lodLowRadius)
+		return glr::terrain::LOD_LOW;
+
+	return glr::terrain::LOD_LOWEST;
+}
+
+void generateMesh(const glr::terrain::marching_cubes::VoxelChunkMeshGenerator& meshGenerator, glr::terrain::IFieldFunction& fieldFunction, glmd::int32 x, glmd::int32 y, glmd::int32 z, glmd::int32 stride, MeshTotals& totals)
+{
+	auto vertices = std::vector< glm::vec3 >();
+	auto normals = std::vector< glm::vec3 >();
+	auto textureBlendingValues = std::vector< glm::vec4 >();
+	auto indices = std::vector< glmd::uint32 >();
+
+	// Includes generating the density field, since that is also done at the lower resolution
+	auto timer = benchmark::Timer();
+
+	auto chunk = glr::terrain::VoxelChunk(x, y, z, stride);
+	glr::terrain::generateNoise(chunk, WORLD_LENGTH, WORLD_WIDTH, WORLD_HEIGHT, fieldFunction);
+
+	if (!glr::terrain::determineIfEmptyOrSolid(chunk))
+	{
+		meshGenerator.generateMesh(chunk, WORLD_LENGTH, WORLD_WIDTH, WORLD_HEIGHT, vertices, normals, textureBlendingValues, indices);
+	}
+
+	totals.time += timer.getElapsedMilliseconds();
+	totals.numberOfVertices += vertices.size();
+	totals.numberOfIndices += indices.size();
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(terrainLod)
+
+BOOST_AUTO_TEST_CASE(fullResolutionVsLevelOfDetail)
+{
+	const auto settings = glr::terrain::TerrainSettings();
+
+	auto fieldFunction = benchmark::HillsFieldFunction();
+	auto meshGenerator = glr::terrain::marching_cubes::VoxelChunkMeshGenerator(settings);
+
+	glmd::int32 numberOfChunks = 0;
+
+	// Before: every chunk in view is meshed at full resolution
+	auto fullResolution = MeshTotals();
+	// After: each chunk is meshed at the level of detail of the ring it is in (with skirts)
+	auto levelOfDetail = MeshTotals();
+
+	for (glmd::int32 x=0; x < WORLD_LENGTH; x++)
+	{
+		for (glmd::int32 y=0; y < WORLD_WIDTH; y++)
+		{
+			for (glmd::int32 z=0; z < WORLD_HEIGHT; z++)
+			{
+				const glmd::float32 distance = getDistance(x, y, z, settings);
+
+				if (distance > settings.maxViewDistance)
+					continue;
+
+				const glmd::int32 stride = glr::terrain::getLevelOfDetailStride( getLevelOfDetail(distance, settings) );
+
+				generateMesh(meshGenerator, fieldFunction, x, y, z, 1, fullResolution);
+				generateMesh(meshGenerator, fieldFunction, x, y, z, stride, levelOfDetail);
+
+				numberOfChunks++;
+			}
+		}
+	}
+
+	BOOST_CHECK( numberOfChunks > 0 );
+	BOOST_CHECK( levelOfDetail.numberOfIndices * 10 < fullResolution.numberOfIndices );
+
+	benchmark::report("terrainLod", "chunks in view", (glmd::float64)numberOfChunks, "chunks");
+	benchmark::report("terrainLod", "full resolution: triangles", (glmd::float64)(fullResolution.numberOfIndices / 3), "triangles");
+	benchmark::report("terrainLod", "full resolution: mesh size", (glmd::float64)fullResolution.getBytes() / (1024.0 * 1024.0), "MiB");
+	benchmark::report("terrainLod", "full resolution: generation time", fullResolution.time, "ms");
+	benchmark::report("terrainLod", "level of detail: triangles", (glmd::float64)(levelOfDetail.numberOfIndices / 3), "triangles");
+	benchmark::report("terrainLod", "level of detail: mesh size", (glmd::float64)levelOfDetail.getBytes() / (1024.0 * 1024.0), "MiB");
+	benchmark::report("terrainLod", "level of detail: generation time", levelOfDetail.time, "ms");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
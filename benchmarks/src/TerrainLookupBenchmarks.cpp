@@ -0,0 +1,120 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <unordered_map>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "Benchmark.hpp"
+
+#include "terrain/ChunkCoordinates.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const glmd::int32 WORLD_LENGTH = 64;
+const glmd::int32 WORLD_HEIGHT = 16;
+const glmd::int32 WORLD_WIDTH = 64;
+
+// The vector lookup is O(n), so it is only timed for a sample of the grid cells
+const glmd::int32 SAMPLE_STEP = 97;
+
+/**
+ * Stands in for a Terrain object - the lookups only need its grid coordinates.
+ */
+struct Chunk
+{
+	Chunk(glmd::int32 x, glmd::int32 y, glmd::int32 z) : x(x), y(y), z(z)
+	{
+	}
+	
+	glmd::int32 getGridX() const { return x; }
+	glmd::int32 getGridY() const { return y; }
+	glmd::int32 getGridZ() const { return z; }
+	
+	glmd::int32 x, y, z;
+};
+
+glm::ivec3 getCell(glmd::int32 index)
+{
+	return glm::ivec3( index / (WORLD_HEIGHT * WORLD_WIDTH), (index / WORLD_WIDTH) % WORLD_HEIGHT, index % WORLD_WIDTH );
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(terrainLookup)
+
+BOOST_AUTO_TEST_CASE(vectorVsHashMap)
+{
+	const glmd::int32 numberOfChunks = WORLD_LENGTH * WORLD_HEIGHT * WORLD_WIDTH;
+	
+	auto chunkVector = std::vector< std::unique_ptr<Chunk> >();
+	auto chunkMap = std::unordered_map< glm::ivec3, std::unique_ptr<Chunk>, glr::terrain::ChunkCoordinatesHash >();
+	
+	for (glmd::int32 i=0; i < numberOfChunks; i++)
+	{
+		const glm::ivec3 cell = getCell(i);
+		
+		chunkVector.push_back( std::unique_ptr<Chunk>( new Chunk(cell.x, cell.y, cell.z) ) );
+		chunkMap[cell] = std::unique_ptr<Chunk>( new Chunk(cell.x, cell.y, cell.z) );
+	}
+	
+	// Before: std::find_if over a vector (what TerrainManager::getTerrain used to do)
+	glmd::uint64 vectorFound = 0;
+	glmd::int32 numberOfSamples = 0;
+	
+	auto timer = benchmark::Timer();
+	for (glmd::int32 i=0; i < numberOfChunks; i += SAMPLE_STEP)
+	{
+		const glm::ivec3 cell = getCell(i);
+		
+		auto findFunction = [&cell](const std::unique_ptr<Chunk>& node) { return (node->getGridX() == cell.x && node->getGridY() == cell.y && node->getGridZ() == cell.z); };
+		auto it = std::find_if(chunkVector.begin(), chunkVector.end(), findFunction);
+		
+		if (it != chunkVector.end())
+			vectorFound += (*it)->getGridX() + (*it)->getGridY() + (*it)->getGridZ();
+		
+		numberOfSamples++;
+	}
+	const glmd::float64 vectorTimePerLookup = timer.getElapsedMilliseconds() / numberOfSamples;
+	
+	// After: hashed lookup by grid coordinates, for every cell in the world (i.e. one TerrainManager::updateTerrainLod() pass)
+	glmd::uint64 mapFound = 0;
+	glmd::uint64 mapFoundSampled = 0;
+	
+	timer.restart();
+	for (glmd::int32 i=0; i < numberOfChunks; i++)
+	{
+		auto it = chunkMap.find( getCell(i) );
+		
+		if (it != chunkMap.end())
+		{
+			const glmd::uint64 value = it->second->getGridX() + it->second->getGridY() + it->second->getGridZ();
+			
+			mapFound++;
+			if (i % SAMPLE_STEP == 0)
+				mapFoundSampled += value;
+		}
+	}
+	const glmd::float64 mapTime = timer.getElapsedMilliseconds();
+	
+	BOOST_CHECK_EQUAL( mapFound, (glmd::uint64)numberOfChunks );
+	BOOST_CHECK_EQUAL( vectorFound, mapFoundSampled );
+	
+	benchmark::report("terrainLookup", "chunks", (glmd::float64)numberOfChunks, "chunks");
+	benchmark::report("terrainLookup", "vector: time per lookup", vectorTimePerLookup * 1000000.0, "ns");
+	benchmark::report("terrainLookup", "vector: time per LOD pass (extrapolated)", vectorTimePerLookup * numberOfChunks, "ms");
+	benchmark::report("terrainLookup", "hash map: time per lookup", mapTime / numberOfChunks * 1000000.0, "ns");
+	benchmark::report("terrainLookup", "hash map: time per LOD pass", mapTime, "ms");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,79 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "Benchmark.hpp"
+
+#include "glw/shaders/IShader.hpp"
+#include "glw/shaders/UniformLocationCache.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const glmd::uint32 NUMBER_OF_NODES = 10000;
+
+// The uniforms in glr_basic (glr.glsl and shader.frag)
+glr::shaders::UniformLocationCache createBasicShaderCache()
+{
+	auto cache = glr::shaders::UniformLocationCache();
+	cache.addUniform( glr::shaders::UNIFORM_PROJECTION_MATRIX, 0 );
+	cache.addUniform( glr::shaders::UNIFORM_VIEW_MATRIX, 1 );
+	cache.addUniform( glr::shaders::UNIFORM_MODEL_MATRIX, 2 );
+	cache.addUniform( glr::shaders::UNIFORM_PVM_MATRIX, 3 );
+	cache.addUniform( glr::shaders::UNIFORM_NORMAL_MATRIX, 4 );
+	cache.addUniform( std::string("tex2D"), 5 );
+	cache.addUniformBlock( std::string("Lights"), 0 );
+	cache.addUniformBlock( std::string("Bones"), 1 );
+	cache.addUniformBlock( std::string("Materials"), 2 );
+
+	return cache;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(uniformLocationCache)
+
+/**
+ * There's no OpenGL context in the benchmarks, so the driver calls can't be timed - instead, this reports how many calls the per frame
+ * uniform lookups used to make, and times the cached lookups that replace them.
+ */
+BOOST_AUTO_TEST_CASE(drawCalls)
+{
+	const auto cache = createBasicShaderCache();
+
+	// BasicSceneNode::render used to look up 3 uniforms per node, and every shader bind looked up 5 uniforms and 3 uniform blocks
+	const glmd::uint32 driverCallsPerNode = 3;
+	const glmd::uint32 driverCallsPerShaderBind = 5 + 3;
+
+	benchmark::report("uniformLocationCache", "nodes", NUMBER_OF_NODES, "nodes");
+	benchmark::report("uniformLocationCache", "before: location lookups sent to the driver per frame", NUMBER_OF_NODES * driverCallsPerNode + driverCallsPerShaderBind, "calls");
+	benchmark::report("uniformLocationCache", "after: location lookups sent to the driver per frame", 0.0, "calls");
+
+	glmd::int64 handleSum = 0;
+
+	auto timer = benchmark::Timer();
+
+	for (glmd::uint32 i=0; i < NUMBER_OF_NODES; i++)
+	{
+		handleSum += cache.getUniformLocation( glr::shaders::UNIFORM_MODEL_MATRIX );
+		handleSum += cache.getUniformLocation( glr::shaders::UNIFORM_PVM_MATRIX );
+		handleSum += cache.getUniformLocation( glr::shaders::UNIFORM_NORMAL_MATRIX );
+	}
+
+	const glmd::float64 lookupTime = timer.getElapsedMilliseconds();
+
+	BOOST_CHECK_EQUAL( handleSum, (glmd::int64)NUMBER_OF_NODES * (2 + 3 + 4) );
+
+	benchmark::report("uniformLocationCache", "after: cached lookups per frame", lookupTime, "ms");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
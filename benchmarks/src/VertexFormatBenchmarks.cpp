@@ -0,0 +1,335 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <cstring>
+#include <cmath>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "Benchmark.hpp"
+
+#include "glw/VertexFormat.hpp"
+
+#include "terrain/TerrainMesh.hpp"
+#include "terrain/TerrainSettings.hpp"
+#include "terrain/VoxelChunk.hpp"
+#include "terrain/VoxelChunkNoiseGenerator.hpp"
+#include "terrain/dual_contouring/VoxelChunkMeshGenerator.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const glmd::uint32 NUMBER_OF_UPLOADS = 200;
+
+// A 256x256 grid of vertices - about the size of a detailed character mesh
+const glmd::uint32 GRID_SIZE = 256;
+
+// Mesh::packVertices() writes the vertices in blocks of this many
+const glmd::uint32 VERTICES_PER_BLOCK = 1024;
+
+const glm::ivec3 DIMENSIONS = glm::ivec3(8, 4, 8);
+
+struct ModelMesh
+{
+	std::vector< glm::vec3 > vertices;
+	std::vector< glm::vec3 > normals;
+	std::vector< glm::vec2 > textureCoordinates;
+	std::vector< glm::vec4 > colors;
+	std::vector< glr::glw::VertexBoneData > bones;
+};
+
+/**
+ * Returns a skinned, textured sphere.
+ */
+ModelMesh createModelMesh()
+{
+	auto mesh = ModelMesh();
+
+	for (glmd::uint32 i=0; i < GRID_SIZE; i++)
+	{
+		for (glmd::uint32 j=0; j < GRID_SIZE; j++)
+		{
+			const glmd::float32 u = (glmd::float32)i / (GRID_SIZE - 1);
+			const glmd::float32 v = (glmd::float32)j / (GRID_SIZE - 1);
+			const glmd::float32 theta = u * 6.2831853f;
+			const glmd::float32 phi = v * 3.1415927f;
+
+			const glm::vec3 normal = glm::vec3( std::cos(theta) * std::sin(phi), std::cos(phi), std::sin(theta) * std::sin(phi) );
+
+			mesh.vertices.push_back( normal * 2.0f );
+			mesh.normals.push_back( normal );
+			mesh.textureCoordinates.push_back( glm::vec2(u, v) );
+			mesh.colors.push_back( glm::vec4(u, v, 0.5f, 1.0f) );
+
+			auto bone = glr::glw::VertexBoneData();
+			bone.addBoneWeight(i % 64, 0.75f);
+			bone.addBoneWeight(j % 64, 0.25f);
+			mesh.bones.push_back( bone );
+		}
+	}
+
+	return mesh;
+}
+
+struct TerrainChunkMesh
+{
+	std::vector< glm::vec3 > vertices;
+	std::vector< glm::vec3 > normals;
+	std::vector< glm::vec4 > textureBlendingValues;
+};
+
+/**
+ * Returns the meshes of every chunk in a DIMENSIONS sized world that has a surface.
+ */
+std::vector< TerrainChunkMesh > createTerrainMeshes()
+{
+	auto fieldFunction = benchmark::HillsFieldFunction();
+	auto meshGenerator = glr::terrain::dual_contouring::VoxelChunkMeshGenerator( &fieldFunction, glr::terrain::TerrainSettings() );
+
+	auto meshes = std::vector< TerrainChunkMesh >();
+
+	for (glmd::int32 x=0; x < DIMENSIONS.x; x++)
+	{
+		for (glmd::int32 y=0; y < DIMENSIONS.y; y++)
+		{
+			for (glmd::int32 z=0; z < DIMENSIONS.z; z++)
+			{
+				auto chunk = glr::terrain::VoxelChunk(x, y, z);
+				glr::terrain::generateNoise(chunk, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, fieldFunction);
+
+				if (glr::terrain::determineIfEmptyOrSolid(chunk))
+					continue;
+
+				auto mesh = TerrainChunkMesh();
+				auto indices = std::vector< glmd::uint32 >();
+
+				meshGenerator.generateMesh(chunk, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, mesh.vertices, mesh.normals, mesh.textureBlendingValues, indices);
+
+				if (!mesh.vertices.empty())
+					meshes.push_back( std::move(mesh) );
+			}
+		}
+	}
+
+	return meshes;
+}
+
+/**
+ * Copies data into the buffer at offset - this stands in for glBufferSubData, which copies the data into driver memory before returning.
+ */
+template<typename T> void upload(std::vector< glmd::uint8 >& buffer, glmd::uint32 offset, const std::vector< T >& data)
+{
+	std::memcpy(&buffer[offset], &data[0], data.size() * sizeof(T));
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(vertexFormat)
+
+BOOST_AUTO_TEST_CASE(modelUpload)
+{
+	const auto mesh = createModelMesh();
+	const glmd::uint32 numberOfVertices = mesh.vertices.size();
+
+	// Before: five buffers (positions, texture coordinates, normals, colors, and bone data), each uploaded with its own call
+	const glmd::uint32 separateBytesPerVertex = sizeof(glm::vec3) + sizeof(glm::vec2) + sizeof(glm::vec3) + sizeof(glm::vec4) + sizeof(glr::glw::VertexBoneData);
+	auto buffers = std::vector< glmd::uint8 >( numberOfVertices * separateBytesPerVertex );
+
+	auto timer = benchmark::Timer();
+	for (glmd::uint32 i=0; i < NUMBER_OF_UPLOADS; i++)
+	{
+		glmd::uint32 offset = 0;
+
+		upload(buffers, offset, mesh.vertices);
+		offset += numberOfVertices * sizeof(glm::vec3);
+		upload(buffers, offset, mesh.textureCoordinates);
+		offset += numberOfVertices * sizeof(glm::vec2);
+		upload(buffers, offset, mesh.normals);
+		offset += numberOfVertices * sizeof(glm::vec3);
+		upload(buffers, offset, mesh.colors);
+		offset += numberOfVertices * sizeof(glm::vec4);
+		upload(buffers, offset, mesh.bones);
+	}
+	const glmd::float64 separateTime = timer.getElapsedMilliseconds() / NUMBER_OF_UPLOADS;
+
+	benchmark::report("vertexFormat", "model vertices", (glmd::float64)numberOfVertices, "vertices");
+	benchmark::report("vertexFormat", "separate buffers: bytes per vertex", (glmd::float64)separateBytesPerVertex, "bytes");
+	benchmark::report("vertexFormat", "separate buffers: buffer uploads per mesh", 5.0, "uploads");
+	benchmark::report("vertexFormat", "separate buffers: upload time per mesh", separateTime, "ms");
+
+	// After: the vertices are interleaved into a single buffer (as Mesh::packVertices() does), and uploaded with one call
+	const glr::glw::VertexFormat formats[2] = { glr::glw::createDefaultVertexFormat(), glr::glw::createPackedVertexFormat() };
+	const std::string names[2] = { "interleaved (default format)", "interleaved (packed format)" };
+
+	for (glmd::uint32 f=0; f < 2; f++)
+	{
+		const auto& format = formats[f];
+		auto vertices = std::vector< glmd::uint8 >();
+		auto buffer = std::vector< glmd::uint8 >( numberOfVertices * format.getStride() );
+
+		timer.restart();
+		for (glmd::uint32 i=0; i < NUMBER_OF_UPLOADS; i++)
+		{
+			vertices.assign( numberOfVertices * format.getStride(), 0 );
+
+			for (glmd::uint32 j=0; j < numberOfVertices; j += VERTICES_PER_BLOCK)
+			{
+				format.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_POSITION, mesh.vertices, vertices, j, VERTICES_PER_BLOCK);
+				format.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_TEXTURE, mesh.textureCoordinates, vertices, j, VERTICES_PER_BLOCK);
+				format.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_NORMAL, mesh.normals, vertices, j, VERTICES_PER_BLOCK);
+				format.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_COLOR, mesh.colors, vertices, j, VERTICES_PER_BLOCK);
+				format.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_BONE_IDS, glr::glw::VERTEX_ATTRIBUTE_LOCATION_BONE_WEIGHTS, mesh.bones, vertices, j, VERTICES_PER_BLOCK);
+			}
+
+			upload(buffer, 0, vertices);
+		}
+		const glmd::float64 interleavedTime = timer.getElapsedMilliseconds() / NUMBER_OF_UPLOADS;
+
+		BOOST_CHECK( format.getStride() <= separateBytesPerVertex );
+
+		benchmark::report("vertexFormat", names[f] + ": bytes per vertex", (glmd::float64)format.getStride(), "bytes");
+		benchmark::report("vertexFormat", names[f] + ": buffer uploads per mesh", 1.0, "uploads");
+		benchmark::report("vertexFormat", names[f] + ": pack and upload time per mesh", interleavedTime, "ms");
+	}
+}
+
+BOOST_AUTO_TEST_CASE(terrainUpload)
+{
+	const auto meshes = createTerrainMeshes();
+
+	// in_texBlend is bound to location 6 in voxel.vert
+	const auto format = glr::terrain::TerrainMesh::createVertexFormat(6);
+
+	glmd::uint64 numberOfVertices = 0;
+	glmd::uint64 separateBytes = 0;
+	glmd::uint64 interleavedBytes = 0;
+	glmd::float64 separateTime = 0.0;
+	glmd::float64 interleavedTime = 0.0;
+
+	for (const auto& mesh : meshes)
+	{
+		const auto& vertices = mesh.vertices;
+
+		// Before: positions, normals and blending values went up in separate buffers - along with placeholder bone data (as terrain has
+		// no bones)
+		const auto bones = std::vector< glr::glw::VertexBoneData >( vertices.size() );
+		const glmd::uint32 bytes = vertices.size() * (sizeof(glm::vec3) + sizeof(glm::vec3) + sizeof(glm::vec4) + sizeof(glr::glw::VertexBoneData));
+		auto buffers = std::vector< glmd::uint8 >( bytes );
+
+		auto timer = benchmark::Timer();
+		upload(buffers, 0, vertices);
+		upload(buffers, vertices.size() * sizeof(glm::vec3), mesh.normals);
+		upload(buffers, vertices.size() * 2 * sizeof(glm::vec3), mesh.textureBlendingValues);
+		upload(buffers, vertices.size() * (2 * sizeof(glm::vec3) + sizeof(glm::vec4)), bones);
+		separateTime += timer.getElapsedMilliseconds();
+
+		// After: a single interleaved buffer, in the terrain format
+		auto interleaved = std::vector< glmd::uint8 >();
+		auto buffer = std::vector< glmd::uint8 >( vertices.size() * format.getStride() );
+
+		timer.restart();
+		interleaved.assign( vertices.size() * format.getStride(), 0 );
+		for (glmd::uint32 i=0; i < vertices.size(); i += VERTICES_PER_BLOCK)
+		{
+			format.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_POSITION, vertices, interleaved, i, VERTICES_PER_BLOCK);
+			format.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_NORMAL, mesh.normals, interleaved, i, VERTICES_PER_BLOCK);
+			format.write(6, mesh.textureBlendingValues, interleaved, i, VERTICES_PER_BLOCK);
+		}
+		upload(buffer, 0, interleaved);
+		interleavedTime += timer.getElapsedMilliseconds();
+
+		numberOfVertices += vertices.size();
+		separateBytes += bytes;
+		interleavedBytes += interleaved.size();
+	}
+
+	BOOST_CHECK( numberOfVertices > 0 );
+	BOOST_CHECK( interleavedBytes < separateBytes );
+
+	benchmark::report("vertexFormat", "terrain vertices", (glmd::float64)numberOfVertices, "vertices");
+	benchmark::report("vertexFormat", "terrain separate buffers: bytes per vertex", (glmd::float64)separateBytes / numberOfVertices, "bytes");
+	benchmark::report("vertexFormat", "terrain separate buffers: upload time", separateTime, "ms");
+	benchmark::report("vertexFormat", "terrain interleaved: bytes per vertex", (glmd::float64)interleavedBytes / numberOfVertices, "bytes");
+	benchmark::report("vertexFormat", "terrain interleaved: pack and upload time", interleavedTime, "ms");
+}
+
+BOOST_AUTO_TEST_CASE(staticMeshMemory)
+{
+	const auto meshes = createTerrainMeshes();
+
+	// Before: meshes without bones were given placeholder bone data (bone 0, with weights of 0.25) before every upload, and had bone
+	// attributes in their vertex buffer
+	auto skinnedFormat = glr::terrain::TerrainMesh::createVertexFormat(6);
+	skinnedFormat.addAttribute(glr::glw::VERTEX_ATTRIBUTE_LOCATION_BONE_IDS, 4, glr::glw::VERTEX_ATTRIBUTE_TYPE_INT32);
+	skinnedFormat.addAttribute(glr::glw::VERTEX_ATTRIBUTE_LOCATION_BONE_WEIGHTS, 4, glr::glw::VERTEX_ATTRIBUTE_TYPE_FLOAT32);
+
+	// After: no bone data, and no bone attributes
+	const auto staticFormat = glr::terrain::TerrainMesh::createVertexFormat(6);
+
+	glmd::uint64 numberOfVertices = 0;
+	glmd::uint64 boneDataBytes = 0;
+	glmd::float64 skinnedTime = 0.0;
+	glmd::float64 staticTime = 0.0;
+
+	auto interleaved = std::vector< glmd::uint8 >();
+
+	for (const auto& mesh : meshes)
+	{
+		auto timer = benchmark::Timer();
+		auto bones = std::vector< glr::glw::VertexBoneData >( mesh.vertices.size() );
+		for (auto& b : bones)
+			b.weights = glm::vec4(0.25f);
+
+		interleaved.assign( mesh.vertices.size() * skinnedFormat.getStride(), 0 );
+		for (glmd::uint32 i=0; i < mesh.vertices.size(); i += VERTICES_PER_BLOCK)
+		{
+			skinnedFormat.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_POSITION, mesh.vertices, interleaved, i, VERTICES_PER_BLOCK);
+			skinnedFormat.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_NORMAL, mesh.normals, interleaved, i, VERTICES_PER_BLOCK);
+			skinnedFormat.write(6, mesh.textureBlendingValues, interleaved, i, VERTICES_PER_BLOCK);
+			skinnedFormat.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_BONE_IDS, glr::glw::VERTEX_ATTRIBUTE_LOCATION_BONE_WEIGHTS, bones, interleaved, i, VERTICES_PER_BLOCK);
+		}
+		skinnedTime += timer.getElapsedMilliseconds();
+
+		timer.restart();
+		interleaved.assign( mesh.vertices.size() * staticFormat.getStride(), 0 );
+		for (glmd::uint32 i=0; i < mesh.vertices.size(); i += VERTICES_PER_BLOCK)
+		{
+			staticFormat.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_POSITION, mesh.vertices, interleaved, i, VERTICES_PER_BLOCK);
+			staticFormat.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_NORMAL, mesh.normals, interleaved, i, VERTICES_PER_BLOCK);
+			staticFormat.write(6, mesh.textureBlendingValues, interleaved, i, VERTICES_PER_BLOCK);
+		}
+		staticTime += timer.getElapsedMilliseconds();
+
+		numberOfVertices += mesh.vertices.size();
+		boneDataBytes += bones.size() * sizeof(glr::glw::VertexBoneData);
+	}
+
+	BOOST_CHECK( numberOfVertices > 0 );
+	BOOST_CHECK( staticFormat.getStride() < skinnedFormat.getStride() );
+	BOOST_CHECK( !staticFormat.isSkinned() );
+
+	const glmd::float64 megabyte = 1024.0 * 1024.0;
+
+	benchmark::report("vertexFormat", "terrain world vertices", (glmd::float64)numberOfVertices, "vertices");
+	benchmark::report("vertexFormat", "with bone data: placeholder bone data in system memory", boneDataBytes / megabyte, "MB");
+	benchmark::report("vertexFormat", "with bone data: video memory", numberOfVertices * skinnedFormat.getStride() / megabyte, "MB");
+	benchmark::report("vertexFormat", "with bone data: pack time", skinnedTime, "ms");
+	benchmark::report("vertexFormat", "without bone data: placeholder bone data in system memory", 0.0, "MB");
+	benchmark::report("vertexFormat", "without bone data: video memory", numberOfVertices * staticFormat.getStride() / megabyte, "MB");
+	benchmark::report("vertexFormat", "without bone data: pack time", staticTime, "ms");
+
+	// Models without bones drop the bone attributes too
+	benchmark::report("vertexFormat", "default format: bytes per vertex (skinned)", (glmd::float64)glr::glw::createDefaultVertexFormat().getStride(), "bytes");
+	benchmark::report("vertexFormat", "default format: bytes per vertex (static)", (glmd::float64)glr::glw::createDefaultVertexFormat(false).getStride(), "bytes");
+	benchmark::report("vertexFormat", "packed format: bytes per vertex (skinned)", (glmd::float64)glr::glw::createPackedVertexFormat().getStride(), "bytes");
+	benchmark::report("vertexFormat", "packed format: bytes per vertex (static)", (glmd::float64)glr::glw::createPackedVertexFormat(false).getStride(), "bytes");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -17,8 +17,17 @@ in vec3 in_Position;
 in vec2 in_Texture;
 in vec4 in_Color;
 in vec3 in_Normal;
+
+// Static meshes (built with STATIC_MESH defined) have no bone attributes
+#ifndef STATIC_MESH
 in ivec4 in_BoneIds;
 in vec4 in_BoneWeights;
+#endif
+
+// Instanced shaders (built with INSTANCED defined) read the model matrix of each instance from a vertex attribute
+#ifdef INSTANCED
+in mat4 in_InstanceModelMatrix;
+#endif
 
 out vec2 textureCoord;
 out vec3 normalDirection;
@@ -32,19 +41,25 @@ layout(std140) uniform Lights
 	Light lights[ NUM_LIGHTS ];
 };
 
+#ifndef STATIC_MESH
 @bind Bone
 layout(std140) uniform Bones 
 {
 	mat4 bones[ MAX_BONES ];
 };
+#endif
 
 void main()
 {
+#ifdef STATIC_MESH
+	mat4 boneTransform = mat4(1.0);
+#else
 	// Calculate the transformation on the vertex position based on the bone weightings
 	mat4 boneTransform = bones[ in_BoneIds[0] ] * in_BoneWeights[0];
     boneTransform     += bones[ in_BoneIds[1] ] * in_BoneWeights[1];
     boneTransform     += bones[ in_BoneIds[2] ] * in_BoneWeights[2];
     boneTransform     += bones[ in_BoneIds[3] ] * in_BoneWeights[3];
+#endif
     
     // Temporary - this will cease all animation (and show just the model) - this works if you want to just show the model
     //mat4 tempM = mat4(1.0);
@@ -52,14 +67,23 @@ void main()
     
     // This is for animating the model
     vec4 tempPosition = boneTransform * vec4(in_Position, 1.0);
+#ifdef INSTANCED
+	gl_Position = projectionMatrix * viewMatrix * in_InstanceModelMatrix * tempPosition;
+#else
 	gl_Position = pvmMatrix * tempPosition;
+#endif
 	
 	// Assign texture coordinates
 	textureCoord = in_Texture;
 	
 	// Calculate normal
 	vec4 normalDirTemp = boneTransform * vec4(in_Normal, 0.0);
+#ifdef INSTANCED
+	mat3 instanceNormalMatrix = transpose(inverse(mat3(viewMatrix * in_InstanceModelMatrix)));
+	normalDirection = normalize(instanceNormalMatrix * normalDirTemp.xyz);
+#else
 	normalDirection = normalize(normalMatrix * normalDirTemp.xyz);
+#endif
 	//normalDirection = normalize(normalMatrix * in_Normal);
 	
 	// Calculate light direction
@@ -71,11 +95,13 @@ void main()
 	
 	// If we have any bugs, should highlight the vertex red or green
 	bug = 0.0;
+#ifndef STATIC_MESH
 	float sum = in_BoneWeights[0] + in_BoneWeights[1] + in_BoneWeights[2] + in_BoneWeights[3];
 	if (sum > 1.05f)
 		bug = 1.0;
 	else if (sum < 0.95f)
 		bug = 2.0;
+#endif
 	//else if (in_BoneIds[0] > 32 || in_BoneIds[1] > 32 || in_BoneIds[2] > 32 || in_BoneIds[3] > 32)
 	//	bug = 3.0;
 	// disable bug highlighting
@@ -6,6 +6,8 @@
 
 #include "Camera.hpp"
 #include "IdManager.hpp"
+#include "RenderQueue.hpp"
+#include "BoundingVolumeHierarchy.hpp"
 #include "glw/shaders/ShaderProgramManager.hpp"
 
 namespace glr
@@ -25,6 +27,8 @@ public:
 	virtual void setCamera(std::unique_ptr<ICamera> camera);
 	
 	virtual void drawAll();
+	virtual const RenderStatistics& getRenderStatistics() const;
+	virtual const CullingStatistics& getCullingStatistics() const;
 	
 	virtual ISceneNode* getSceneNode(Id id) const;
 	virtual ISceneNode* getSceneNode(const std::string& name) const;
@@ -78,12 +82,25 @@ protected:
 	
 	shaders::IShaderProgramManager* shaderProgramManager_;
 	glw::IOpenGlDevice* openGlDevice_;
+	
+	RenderQueue renderQueue_;
+	
+	// The bounding boxes of the scene nodes, for view frustum culling - sceneNodeProxies_[i] is the proxy of sceneNodes_[i] (or
+	// BoundingVolumeHierarchy::NULL_PROXY if the scene node has no bounding box)
+	BoundingVolumeHierarchy sceneNodeHierarchy_;
+	std::vector< glmd::int32 > sceneNodeProxies_;
+	CullingStatistics cullingStatistics_;
 
 	std::vector<LightData> lightData_;
 	
 	shaders::IShaderProgram* defaultShaderProgram_;
 
 	glm::mat4 modelMatrix_;
+	
+	/**
+	 * Destroys the scene node at index in sceneNodes_, and removes it from the bounding volume hierarchy.
+	 */
+	void eraseSceneNode(glmd::uint32 index);
 };
 
 }
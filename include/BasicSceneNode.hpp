@@ -55,6 +55,8 @@ public:
 	virtual shaders::IShaderProgram* getShaderProgram() const;
 	
 	virtual void render();
+	virtual void queue(RenderQueue& renderQueue);
+	virtual glw::BoundingBox getBoundingBox() const;
 
 protected:
 	models::IRenderable* renderable_;
@@ -70,6 +72,11 @@ protected:
 	glw::IOpenGlDevice* openGlDevice_;
 
 	bool active_;
+	
+	/**
+	 * Returns the model matrix for this scene node (its position, orientation and scale, on top of the OpenGlDevice's model matrix).
+	 */
+	glm::mat4 calculateModelMatrix() const;
 
 private:
 	// We don't copy straight up, since we need a new id for the copy
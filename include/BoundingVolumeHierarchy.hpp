@@ -0,0 +1,147 @@
+#ifndef BOUNDINGVOLUMEHIERARCHY_H_
+#define BOUNDINGVOLUMEHIERARCHY_H_
+
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include "glw/BoundingBox.hpp"
+#include "Frustum.hpp"
+
+namespace glr
+{
+
+namespace glmd = glm::detail;
+
+/**
+ * How many objects a frustum query found visible, and how many it culled.
+ */
+struct CullingStatistics
+{
+	CullingStatistics() : visible(0), culled(0)
+	{
+	}
+
+	glmd::uint32 visible;
+	glmd::uint32 culled;
+};
+
+/**
+ * A dynamic bounding volume hierarchy - a binary tree of bounding boxes, for finding the objects inside of a view frustum without
+ * testing every one of them.
+ *
+ * Each object (a 'proxy') is stored in a leaf with a 'fat' bounding box - its bounding box grown by a margin.  Moving an object only
+ * changes the tree if it moves outside of its fat box; then the leaf is removed and reinserted, and the tree is rebalanced on the way
+ * up (so it stays balanced however the objects move).  New leaves are inserted where they increase the surface area of the tree the
+ * least.
+ *
+ * **Not Thread Safe**: This class should only be used from a single thread at a time.
+ */
+class BoundingVolumeHierarchy
+{
+public:
+	static const glmd::int32 NULL_PROXY = -1;
+
+	/**
+	 * @param margin How far to grow the bounding box of each object by, in each direction.
+	 */
+	BoundingVolumeHierarchy(glmd::float32 margin = 1.0f);
+
+	/**
+	 * Adds an object with bounding box box, and returns its proxy id.
+	 *
+	 * @param box
+	 * @param userData Returned by queries that find the object.
+	 */
+	glmd::int32 insert(const glw::BoundingBox& box, void* userData);
+	void remove(glmd::int32 proxy);
+
+	/**
+	 * Sets the bounding box of proxy.  Returns true if the proxy had to be reinserted (i.e. box is not inside of its fat box).
+	 */
+	bool update(glmd::int32 proxy, const glw::BoundingBox& box);
+	
+	/**
+	 * Keeps an object that may not always have a bounding box in the tree: inserts it if proxy is NULL_PROXY, updates it otherwise, and
+	 * removes it if box is empty (objects without a bounding box can't be culled, so they aren't stored).
+	 *
+	 * @return The proxy id of the object, or NULL_PROXY if box is empty.
+	 */
+	glmd::int32 synchronize(glmd::int32 proxy, const glw::BoundingBox& box, void* userData);
+
+	void clear();
+
+	void* getUserData(glmd::int32 proxy) const;
+	const glw::BoundingBox& getFatBoundingBox(glmd::int32 proxy) const;
+
+	/**
+	 * Calls visitor (with the user data of the object) for every object whose fat bounding box may be inside of frustum.  Subtrees that
+	 * are entirely inside of the frustum are visited without testing their objects.
+	 *
+	 * @return The number of objects visited and culled.
+	 */
+	template<class Visitor> CullingStatistics query(const Frustum& frustum, Visitor visitor) const;
+
+	glmd::uint32 getNumberOfProxies() const;
+
+	/**
+	 * Returns the height of the tree (0 if it is empty, 1 if it holds a single proxy).
+	 */
+	glmd::uint32 getHeight() const;
+
+private:
+	static const glmd::int32 NULL_NODE = -1;
+
+	struct Node
+	{
+		glw::BoundingBox box;
+		void* userData;
+
+		// The next free node, if this node is in the free list
+		glmd::int32 parent;
+		glmd::int32 child1;
+		glmd::int32 child2;
+
+		// Leaves have a height of 0 (and free nodes -1)
+		glmd::int32 height;
+
+		bool isLeaf() const
+		{
+			return (child1 == NULL_NODE);
+		}
+	};
+
+	glmd::float32 margin_;
+
+	std::vector< Node > nodes_;
+	glmd::int32 root_;
+	glmd::int32 freeList_;
+	glmd::uint32 numberOfProxies_;
+
+	// Reused between queries
+	mutable std::vector< glmd::int32 > stack_;
+
+	glmd::int32 allocateNode();
+	void freeNode(glmd::int32 node);
+
+	void insertLeaf(glmd::int32 leaf);
+	void removeLeaf(glmd::int32 leaf);
+
+	/**
+	 * Recalculates the boxes and heights of the ancestors of node (inclusive), rebalancing them as it goes.
+	 */
+	void refit(glmd::int32 node);
+
+	/**
+	 * If node is unbalanced (the heights of its children differ by more than 1), rotates the taller child up.  Returns the node now
+	 * at node's position.
+	 */
+	glmd::int32 balance(glmd::int32 node);
+};
+
+}
+
+#include "BoundingVolumeHierarchy.inl"
+
+#endif /* BOUNDINGVOLUMEHIERARCHY_H_ */
@@ -0,0 +1,54 @@
+namespace glr
+{
+
+template<class Visitor>
+CullingStatistics BoundingVolumeHierarchy::query(const Frustum& frustum, Visitor visitor) const
+{
+	CullingStatistics statistics = CullingStatistics();
+
+	if (root_ == NULL_NODE)
+	{
+		return statistics;
+	}
+
+	// Each entry is a node index shifted left by 1, with the lowest bit set if the node is known to be inside of the frustum
+	stack_.clear();
+	stack_.push_back( root_ << 1 );
+
+	while ( !stack_.empty() )
+	{
+		const glmd::int32 entry = stack_.back();
+		stack_.pop_back();
+
+		const Node& node = nodes_[entry >> 1];
+		bool isInside = ((entry & 1) != 0);
+
+		if (!isInside)
+		{
+			const Frustum::Intersection intersection = frustum.intersect( node.box );
+
+			if (intersection == Frustum::INTERSECTION_OUTSIDE)
+			{
+				continue;
+			}
+
+			isInside = (intersection == Frustum::INTERSECTION_INSIDE);
+		}
+
+		if (node.isLeaf())
+		{
+			visitor( node.userData );
+			statistics.visible++;
+			continue;
+		}
+
+		stack_.push_back( (node.child1 << 1) | (isInside ? 1 : 0) );
+		stack_.push_back( (node.child2 << 1) | (isInside ? 1 : 0) );
+	}
+
+	statistics.culled = numberOfProxies_ - statistics.visible;
+
+	return statistics;
+}
+
+}
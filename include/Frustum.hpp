@@ -0,0 +1,77 @@
+#ifndef FRUSTUM_H_
+#define FRUSTUM_H_
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include "glw/BoundingBox.hpp"
+
+namespace glr
+{
+
+namespace glmd = glm::detail;
+
+/**
+ * A view frustum - the 6 planes bounding what a camera can see.
+ *
+ * The planes are stored a component at a time (all of the x components, then all of the y components, etc), so that a bounding box can
+ * be tested against 4 planes at once with SSE.  Without SSE, the planes are tested one at a time.
+ */
+class Frustum
+{
+public:
+	enum Intersection
+	{
+		INTERSECTION_OUTSIDE = 0,
+		INTERSECTION_INTERSECTS,
+		INTERSECTION_INSIDE
+	};
+
+	/**
+	 * Creates a frustum that contains everything.
+	 */
+	Frustum();
+
+	/**
+	 * Creates the frustum of the given projection * view matrix.
+	 */
+	Frustum(const glm::mat4& projectionViewMatrix);
+
+	/**
+	 * Extracts the planes of the frustum from the given projection * view matrix (Gribb & Hartmann, 2001).
+	 */
+	void setProjectionViewMatrix(const glm::mat4& projectionViewMatrix);
+
+	/**
+	 * Returns whether box is outside of, intersects, or is inside of the frustum.  The test is conservative - a box near a corner of the
+	 * frustum may be reported as intersecting when it is actually outside.
+	 *
+	 * Empty boxes are always reported as intersecting (they have no bounds to test).
+	 */
+	Intersection intersect(const glw::BoundingBox& box) const;
+
+	/**
+	 * Returns true if any part of box may be inside of the frustum.
+	 */
+	bool isVisible(const glw::BoundingBox& box) const;
+
+	/**
+	 * Returns plane i (0 - 5: left, right, bottom, top, near, far) as (normal, distance), with the normal pointing into the frustum.
+	 */
+	glm::vec4 getPlane(glmd::uint32 i) const;
+
+private:
+	// 6 planes, and 2 planes that everything is in front of (so the planes can be tested 4 at a time)
+	static const glmd::uint32 NUMBER_OF_PLANES = 8;
+
+	alignas(16) glmd::float32 planeX_[NUMBER_OF_PLANES];
+	alignas(16) glmd::float32 planeY_[NUMBER_OF_PLANES];
+	alignas(16) glmd::float32 planeZ_[NUMBER_OF_PLANES];
+	alignas(16) glmd::float32 planeW_[NUMBER_OF_PLANES];
+
+	void setPlane(glmd::uint32 i, const glm::vec4& plane);
+};
+
+}
+
+#endif /* FRUSTUM_H_ */
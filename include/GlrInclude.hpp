@@ -21,6 +21,7 @@
 #include "glw/IOpenGlDevice.hpp"
 
 #include "terrain/IFieldFunction.hpp"
+#include "terrain/SimplexNoiseFieldFunction.hpp"
 #include "terrain/ITerrainManager.hpp"
 #include "terrain/ITerrain.hpp"
 
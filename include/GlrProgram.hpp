@@ -68,8 +68,6 @@ public:
 	virtual void shaderBindCallback(shaders::IShaderProgram* shader);
 
 private:
-	glm::detail::uint32 numLights_;
-	std::map<std::string, std::vector<GLuint> > lightUbos_;
 	std::map<std::string, std::vector<GLuint> > materialUbos_;
 
 	// Should this be IOpenGlDevice instead of OpenGlDevice?
@@ -84,9 +82,6 @@ private:
 	
 	ProgramSettings settings_;
 
-	void setupUniformBufferObjectBindings(shaders::IShaderProgram* shader);
-	void setupLightUbo(std::string name, shaders::IShaderProgram* shader);
-	void releaseLightUbo(std::string name);
 	void bindUniformBufferObjects(shaders::IShaderProgram* shader);
 
 	void initialize(ProgramSettings settings);
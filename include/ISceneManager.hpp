@@ -2,6 +2,8 @@
 #define ISCENEMANAGER_H_
 
 #include "ISceneNode.hpp"
+#include "RenderStateTracker.hpp"
+#include "BoundingVolumeHierarchy.hpp"
 #include "ICamera.hpp"
 #include "ILight.hpp"
 #include "environment/IEnvironmentManager.hpp"
@@ -52,6 +54,18 @@ public:
 
 	virtual void drawAll() = 0;
 	
+	/**
+	 * Returns the number of draw calls and state changes made by the last call to drawAll (for the scene nodes only - the terrain and
+	 * environment are not included).
+	 */
+	virtual const RenderStatistics& getRenderStatistics() const = 0;
+	
+	/**
+	 * Returns the number of scene nodes that were inside of the camera's view frustum (and drawn) and outside of it (and culled) in the
+	 * last call to drawAll.
+	 */
+	virtual const CullingStatistics& getCullingStatistics() const = 0;
+	
 	virtual void setDefaultShaderProgram(shaders::IShaderProgram* shaderProgram) = 0;
 	
 	virtual const glm::mat4& getModelMatrix() const = 0;
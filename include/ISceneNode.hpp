@@ -14,6 +14,8 @@
 namespace glr
 {
 
+class RenderQueue;
+
 class ISceneNode
 {
 public:
@@ -61,6 +63,17 @@ public:
 	
 	virtual void render() = 0;
 	
+	/**
+	 * Add the draw items needed to render this scene node to the render queue, instead of rendering it immediately.
+	 */
+	virtual void queue(RenderQueue& renderQueue) = 0;
+	
+	/**
+	 * Returns the bounding box of the attached renderable, in world space.  The bounding box is empty if nothing is attached, or if the
+	 * renderable's bounds aren't known (i.e. the scene node should never be culled).
+	 */
+	virtual glw::BoundingBox getBoundingBox() const = 0;
+	
 };
 
 }
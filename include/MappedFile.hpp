@@ -0,0 +1,60 @@
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <string>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace glr
+{
+
+/**
+ * A read only memory mapping of a whole file.
+ *
+ * **Thread Safe**: The mapped data may be read from multiple threads at the same time.  The file must not be written to while it is
+ * mapped.
+ */
+class MappedFile
+{
+public:
+	/**
+	 * Opens and maps the file.
+	 *
+	 * Throws an exception::IoException if the file can't be opened or mapped.
+	 */
+	MappedFile(const std::string& filename);
+	~MappedFile();
+
+	const std::string& getFilename() const;
+
+	/**
+	 * Returns the contents of the file, or nullptr if the file is empty.
+	 */
+	const glm::detail::uint8* getData() const;
+
+	/**
+	 * Returns the size of the file, in bytes.
+	 */
+	glm::detail::uint64 getSize() const;
+
+private:
+	std::string filename_;
+
+	const glm::detail::uint8* data_;
+	glm::detail::uint64 size_;
+
+	// Platform specific handles for the memory mapping
+	void* fileHandle_;
+	void* mappingHandle_;
+
+	void map();
+	void unmap();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+};
+
+}
+
+#endif /* MAPPEDFILE_H_ */
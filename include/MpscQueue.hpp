@@ -0,0 +1,81 @@
+#ifndef MPSCQUEUE_H_
+#define MPSCQUEUE_H_
+
+#include <atomic>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace glr
+{
+
+/**
+ * A lock-free, unbounded, multiple producer single consumer queue.
+ *
+ * Any number of threads may call push() concurrently.  Only one thread at a time may call pop() (i.e. the OpenGL thread).
+ *
+ * Producers never block - a push is one allocation, one atomic exchange, and one atomic store.  The consumer never blocks either,
+ * although an item that is in the middle of being pushed may not be visible to pop() until the push completes.
+ *
+ * T must be default constructible and move assignable.
+ */
+template<typename T>
+class MpscQueue
+{
+public:
+	MpscQueue();
+	~MpscQueue();
+
+	/**
+	 * Adds value to the end of the queue.
+	 *
+	 * **Thread Safe**: This method is safe to call from any number of threads at the same time.
+	 */
+	void push(T value);
+
+	/**
+	 * Removes the item at the front of the queue and moves it into value.
+	 *
+	 * **Not Thread Safe**: This method must only be called from the (single) consumer thread.
+	 *
+	 * @return True if an item was removed from the queue; false if the queue was empty.
+	 */
+	bool pop(T& value);
+
+	/**
+	 * Returns the number of items in the queue.  If producers are pushing at the same time, the value is approximate.
+	 */
+	glm::detail::uint32 size() const;
+	bool empty() const;
+
+private:
+	struct Node
+	{
+		Node() : next(nullptr)
+		{
+		}
+
+		explicit Node(T v) : next(nullptr), value(std::move(v))
+		{
+		}
+
+		std::atomic<Node*> next;
+		T value;
+	};
+
+	// Producers push onto the head
+	std::atomic<Node*> head_;
+	// The consumer pops from the tail - the tail is always a 'stub' node whose value has already been consumed
+	Node* tail_;
+
+	std::atomic<glm::detail::uint32> size_;
+
+	MpscQueue(const MpscQueue&) = delete;
+	MpscQueue& operator=(const MpscQueue&) = delete;
+};
+
+}
+
+#include "MpscQueue.inl"
+
+#endif /* MPSCQUEUE_H_ */
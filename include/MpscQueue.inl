@@ -0,0 +1,72 @@
+#include <utility>
+
+namespace glr
+{
+
+template<typename T>
+MpscQueue<T>::MpscQueue() : size_(0)
+{
+	Node* stub = new Node();
+	head_.store(stub, std::memory_order_relaxed);
+	tail_ = stub;
+}
+
+template<typename T>
+MpscQueue<T>::~MpscQueue()
+{
+	Node* node = tail_;
+
+	while (node != nullptr)
+	{
+		Node* next = node->next.load(std::memory_order_relaxed);
+		delete node;
+		node = next;
+	}
+}
+
+template<typename T>
+void MpscQueue<T>::push(T value)
+{
+	Node* node = new Node(std::move(value));
+
+	// Claim our place in the queue, then link the previous head to us
+	Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+	previous->next.store(node, std::memory_order_release);
+
+	size_.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename T>
+bool MpscQueue<T>::pop(T& value)
+{
+	Node* tail = tail_;
+	Node* next = tail->next.load(std::memory_order_acquire);
+
+	if (next == nullptr)
+	{
+		return false;
+	}
+
+	// 'next' becomes the new stub node
+	value = std::move(next->value);
+	tail_ = next;
+	delete tail;
+
+	size_.fetch_sub(1, std::memory_order_relaxed);
+
+	return true;
+}
+
+template<typename T>
+glm::detail::uint32 MpscQueue<T>::size() const
+{
+	return size_.load(std::memory_order_relaxed);
+}
+
+template<typename T>
+bool MpscQueue<T>::empty() const
+{
+	return (size() == 0);
+}
+
+}
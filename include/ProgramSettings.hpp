@@ -3,6 +3,8 @@
 
 #include <string>
 
+#include "glw/AnimationCompressionSettings.hpp"
+
 namespace glr
 {
 
@@ -11,11 +13,15 @@ namespace glr
  */
 struct ProgramSettings
 {
-	ProgramSettings() : defaultTextureDir("")
+	ProgramSettings() : defaultTextureDir(""), modelCacheDir("")
 	{
 	}
 	
 	std::string defaultTextureDir;
+	// See glw::OpenGlDeviceSettings::modelCacheDir
+	std::string modelCacheDir;
+	// See glw::OpenGlDeviceSettings::animationCompression
+	glw::AnimationCompressionSettings animationCompression;
 };
 
 }
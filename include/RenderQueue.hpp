@@ -0,0 +1,209 @@
+#ifndef RENDERQUEUE_H_
+#define RENDERQUEUE_H_
+
+#include <vector>
+#include <unordered_map>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include "glw/StreamingBuffer.hpp"
+
+#include "RenderStateTracker.hpp"
+
+namespace glr
+{
+
+namespace shaders
+{
+class IShaderProgram;
+}
+
+namespace glw
+{
+class IOpenGlDevice;
+class IMesh;
+class ITexture;
+class IMaterial;
+}
+
+namespace glmd = glm::detail;
+
+/**
+ * Everything needed to draw a single mesh.
+ */
+struct DrawItem
+{
+	DrawItem() : shaderProgram(nullptr), texture(nullptr), material(nullptr), mesh(nullptr), firstBone(0), numberOfBones(0), modelMatrix(1.0f)
+	{
+	}
+
+	shaders::IShaderProgram* shaderProgram;
+	glw::ITexture* texture;
+	glw::IMaterial* material;
+	glw::IMesh* mesh;
+
+	// The bone transformations, added to the render queue with pushBones.  If numberOfBones is 0, the mesh is drawn with identity bones.
+	glmd::uint32 firstBone;
+	glmd::uint32 numberOfBones;
+
+	glm::mat4 modelMatrix;
+};
+
+/**
+ * Collects the draw items for a frame, sorts them so that items sharing state are drawn together, and then draws them - binding only the
+ * state that changes from one item to the next.
+ *
+ * Items are sorted by a 64 bit key - the shader program in the highest 16 bits, then the texture, the material, and the mesh.  The sort
+ * is a radix sort, and is stable, so items with the same key are drawn in the order they were added.
+ *
+ * If a shader program has an instanced variant (see setInstancedShaderProgram), consecutive items that share all of their state and
+ * have no bones are drawn with a single instanced draw call - their model matrices are streamed into video memory, and read by the
+ * instanced shader program as a vertex attribute.
+ *
+ * Bone transformations are copied into the render queue when an item is added (see pushBones), and only streamed into video memory
+ * right before the item is drawn - a range of the streaming buffer can be reused once the draw calls issued before it are done, so data
+ * streamed when the item was added could be overwritten by the time it is drawn (if a lot of bones are streamed in a frame).
+ *
+ * Typical usage looks like this (once per frame):
+ *
+ * renderQueue.clear();
+ * for ( auto& node : sceneNodes )
+ * 		node->queue( renderQueue );
+ * renderQueue.sort();
+ * renderQueue.submit();
+ */
+class RenderQueue
+{
+public:
+	RenderQueue(glw::IOpenGlDevice* openGlDevice);
+	virtual ~RenderQueue();
+
+	void clear();
+
+	/**
+	 * Adds an item, with a key created from its state by createSortKey.
+	 */
+	void push(const DrawItem& item);
+
+	/**
+	 * Adds an item with the given sort key (i.e. to sort transparent items back to front).
+	 */
+	void push(const DrawItem& item, glmd::uint64 key);
+
+	/**
+	 * Copies the first numberOfBones bone transformations in bones into the render queue, and returns the index of the first one (for
+	 * DrawItem::firstBone).  Items may share bones.
+	 *
+	 * @param bones
+	 * @param numberOfBones At most Constants::MAX_NUMBER_OF_BONES_PER_MESH.
+	 */
+	glmd::uint32 pushBones(const std::vector< glm::mat4 >& bones, glmd::uint32 numberOfBones);
+
+	/**
+	 * Sorts the items by their keys.
+	 */
+	void sort();
+
+	/**
+	 * Draws all of the items, in their current order.
+	 *
+	 * **Not Thread Safe**: This method should only be called from the OpenGL thread.
+	 */
+	void submit();
+
+	/**
+	 * Sets the shader program used to draw batches of items that use shaderProgram.  The instanced shader program must read the model
+	 * matrix of each instance from the 'in_InstanceModelMatrix' vertex attribute (i.e. 'glr_basic_instanced').
+	 *
+	 * Instancing is only used if the OpenGlDevice supports it.
+	 *
+	 * @param shaderProgram
+	 * @param instancedShaderProgram The instanced variant of shaderProgram, or nullptr to stop instancing items that use shaderProgram.
+	 */
+	void setInstancedShaderProgram(shaders::IShaderProgram* shaderProgram, shaders::IShaderProgram* instancedShaderProgram);
+
+	/**
+	 * Returns the items (in sorted order, if sort has been called since the last item was added).
+	 */
+	const std::vector< DrawItem >& getItems() const;
+	glmd::uint32 getNumberOfItems() const;
+
+	/**
+	 * Returns the statistics of the last call to submit.
+	 */
+	const RenderStatistics& getStatistics() const;
+
+	/**
+	 * Creates a sort key from the given state.  Only the lowest 16 bits of the shader program id are used, and the texture, material and
+	 * mesh are hashed to 16 bits each - so different objects may share a key (which only costs a redundant bind, never a wrong one).
+	 */
+	static glmd::uint64 createSortKey(glmd::uint32 shaderProgramId, const void* texture, const void* material, const void* mesh);
+
+	/**
+	 * Returns the number of consecutive items, starting at first, that can be drawn as instances of items[first] - they have the same
+	 * shader program, texture, material and mesh, and no bones.  Always returns at least 1 (if first is a valid index).
+	 *
+	 * @param items
+	 * @param first
+	 * @param maximumNumberOfInstances The largest batch to return.
+	 */
+	static glmd::uint32 countInstances(const std::vector< DrawItem >& items, glmd::uint32 first, glmd::uint32 maximumNumberOfInstances);
+
+private:
+	struct SortEntry
+	{
+		glmd::uint64 key;
+		glmd::uint32 index;
+	};
+
+	/**
+	 * The uniforms and bind points of the currently bound shader program.
+	 */
+	struct ShaderProgramState
+	{
+		shaders::IShaderProgram* shaderProgram;
+		GLint modelMatrixHandle;
+		GLint pvmMatrixHandle;
+		GLint normalMatrixHandle;
+		GLint materialBindPoint;
+		GLint boneBindPoint;
+	};
+
+	glw::IOpenGlDevice* openGlDevice_;
+
+	std::vector< DrawItem > items_;
+	std::vector< SortEntry > entries_;
+
+	// Reused between frames, so that sorting doesn't allocate
+	std::vector< DrawItem > sortedItems_;
+	std::vector< SortEntry > sortBuffer_;
+
+	// The bones of all of the items
+	std::vector< glm::mat4 > bones_;
+	// The bones last streamed into video memory (reused if the next item has the same bones)
+	glmd::uint32 streamedFirstBone_;
+	glw::StreamingBufferRange streamedBonesRange_;
+
+	// Bound for items that have no bones (never changes, so it isn't streamed)
+	GLuint identityBonesBufferId_;
+	glw::StreamingBufferRange identityBonesRange_;
+
+	std::unordered_map< shaders::IShaderProgram*, shaders::IShaderProgram* > instancedShaderPrograms_;
+	// The model matrices of the current batch of instances (reused between batches)
+	std::vector< glm::mat4 > instanceModelMatrices_;
+
+	ShaderProgramState shaderProgramState_;
+	RenderStateTracker stateTracker_;
+
+	/**
+	 * Binds the state of item (that isn't already bound), drawing it with shaderProgram.  The bones of the item are streamed here.
+	 */
+	void bindState(const DrawItem& item, shaders::IShaderProgram* shaderProgram);
+	void drawItem(const DrawItem& item, const glm::mat4& viewMatrix, const glm::mat4& projectionViewMatrix);
+	void drawInstances(glmd::uint32 first, glmd::uint32 numberOfInstances);
+};
+
+}
+
+#endif /* RENDERQUEUE_H_ */
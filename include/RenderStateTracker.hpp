@@ -0,0 +1,93 @@
+#ifndef RENDERSTATETRACKER_H_
+#define RENDERSTATETRACKER_H_
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include "glw/StreamingBuffer.hpp"
+
+namespace glr
+{
+
+namespace shaders
+{
+class IShaderProgram;
+}
+
+namespace glw
+{
+class ITexture;
+class IMaterial;
+}
+
+namespace glmd = glm::detail;
+
+/**
+ * Counts of the work done to render a frame.
+ */
+struct RenderStatistics
+{
+	RenderStatistics() : drawCalls(0), instancedDrawCalls(0), instances(0), shaderProgramChanges(0), textureChanges(0), materialChanges(0), boneChanges(0), redundantChangesSkipped(0)
+	{
+	}
+
+	// All draw calls, including the instanced ones
+	glmd::uint32 drawCalls;
+	glmd::uint32 instancedDrawCalls;
+	// The number of instances drawn by the instanced draw calls
+	glmd::uint32 instances;
+
+	glmd::uint32 shaderProgramChanges;
+	glmd::uint32 textureChanges;
+	glmd::uint32 materialChanges;
+	glmd::uint32 boneChanges;
+
+	// The number of binds that were skipped because the state was already bound
+	glmd::uint32 redundantChangesSkipped;
+};
+
+/**
+ * Keeps track of the state that is bound while a frame is rendered, so that binds of state that is already bound can be skipped.
+ *
+ * Each of the set methods returns true if the state changed (and so has to be bound), and false if it is already bound.  Changing the
+ * shader program forgets the bound material and bones, as they are bound to bind points of the shader program.
+ */
+class RenderStateTracker
+{
+public:
+	RenderStateTracker();
+
+	/**
+	 * Forgets all of the bound state, and resets the statistics.
+	 */
+	void reset();
+
+	bool setShaderProgram(shaders::IShaderProgram* shaderProgram);
+	bool setTexture(glw::ITexture* texture);
+	bool setMaterial(glw::IMaterial* material);
+	bool setBones(const glw::StreamingBufferRange& bones);
+
+	/**
+	 * Records a draw call.
+	 */
+	void draw();
+
+	/**
+	 * Records an instanced draw call, drawing numberOfInstances instances.
+	 */
+	void drawInstanced(glmd::uint32 numberOfInstances);
+
+	const RenderStatistics& getStatistics() const;
+
+private:
+	shaders::IShaderProgram* shaderProgram_;
+	glw::ITexture* texture_;
+	glw::IMaterial* material_;
+	glw::StreamingBufferRange bones_;
+
+	RenderStatistics statistics_;
+};
+
+}
+
+#endif /* RENDERSTATETRACKER_H_ */
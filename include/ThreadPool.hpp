@@ -0,0 +1,126 @@
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace glr
+{
+
+/**
+ * A fixed size pool of worker threads that run jobs in priority order.
+ *
+ * Every job has a key, which can be used to cancel the job or update its priority while it is waiting to run.  Jobs with a lower
+ * priority value are run first.
+ */
+class ThreadPool
+{
+public:
+	/**
+	 * Creates the pool and starts the worker threads.
+	 *
+	 * @param numberOfThreads The number of worker threads to start.  If 0, std::thread::hardware_concurrency() threads are started
+	 * (or 1, if the number of hardware threads is unknown).
+	 */
+	ThreadPool(glm::detail::uint32 numberOfThreads = 0);
+
+	/**
+	 * Stops the pool.  Jobs that are already running are allowed to finish - jobs that are still waiting to run are discarded.
+	 */
+	~ThreadPool();
+
+	/**
+	 * Adds a job to the pool.
+	 *
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment.
+	 *
+	 * @param key A value identifying the job (used by cancel() and reprioritize()).  Keys do not have to be unique.
+	 * @param priority The priority of the job - jobs with lower values are run first.
+	 * @param job The work to run.
+	 */
+	void enqueue(glm::detail::uint64 key, glm::detail::float32 priority, std::function<void()> job);
+
+	/**
+	 * Removes all jobs with the given key that have not started running yet.
+	 *
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment.
+	 *
+	 * @return The number of jobs that were removed.  If 0, the job is either already running, already finished, or was never added.
+	 */
+	glm::detail::uint32 cancel(glm::detail::uint64 key);
+
+	/**
+	 * Recalculates the priority of every job that has not started running yet.
+	 *
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment.  Note that priorityFunction is called while the
+	 * pool is locked, so it must not call back into the pool.
+	 *
+	 * @param priorityFunction Returns the new priority for a job, given its key.
+	 */
+	void reprioritize(const std::function<glm::detail::float32(glm::detail::uint64)>& priorityFunction);
+
+	/**
+	 * Runs job over the items [0, count), split into chunks of at most chunkSize items, and blocks until every chunk has finished.  The
+	 * chunks are spread across the worker threads and the calling thread - they are queued ahead of every other job, as the calling
+	 * thread is waiting on them.
+	 *
+	 * If a chunk throws an exception, the rest of the chunks are still run - then the first exception is rethrown.
+	 *
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment (but must not be called from a job).
+	 *
+	 * @param count The number of items.
+	 * @param chunkSize The most items to run in a single call to job.
+	 * @param job Runs the items [begin, end).
+	 *
+	 * @return The number of chunks the items were split into.
+	 */
+	glm::detail::uint32 parallelFor(glm::detail::uint32 count, glm::detail::uint32 chunkSize, const std::function<void(glm::detail::uint32, glm::detail::uint32)>& job);
+
+	/**
+	 * Blocks until every job in the pool has finished running.
+	 *
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment (but must not be called from a job).
+	 */
+	void waitForAll();
+
+	glm::detail::uint32 getNumberOfThreads() const;
+
+	/**
+	 * Returns the number of jobs that are waiting to run (not including jobs that are currently running).
+	 */
+	glm::detail::uint32 getNumberOfQueuedJobs() const;
+
+private:
+	struct Job
+	{
+		glm::detail::uint64 key;
+		glm::detail::float32 priority;
+		std::function<void()> work;
+	};
+
+	std::vector<std::thread> threads_;
+
+	// A binary heap, with the job with the lowest priority value at the front
+	std::vector<Job> jobs_;
+	glm::detail::uint32 numberOfRunningJobs_;
+	bool isStopping_;
+
+	mutable std::mutex mutex_;
+	std::condition_variable jobAvailable_;
+	std::condition_variable jobsFinished_;
+
+	void run();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+};
+
+}
+
+#endif /* THREADPOOL_H_ */
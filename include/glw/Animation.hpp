@@ -14,6 +14,9 @@
 #include "IMesh.hpp"
 
 #include "AnimatedBoneNode.hpp"
+#include "AnimationTracks.hpp"
+#include "SampledAnimationTracks.hpp"
+#include "Skeleton.hpp"
 
 #include "IOpenGlDevice.hpp"
 
@@ -27,8 +30,20 @@ namespace glmd = glm::detail;
 class Animation : public IAnimation
 {
 public:
-	Animation(IOpenGlDevice* openGlDevice, std::string name, bool initialize = true);
-	Animation(IOpenGlDevice* openGlDevice, std::string name, glm::detail::float64 duration, glm::detail::float64 ticksPerSecond, std::map< std::string, AnimatedBoneNode > animatedBoneNodes, bool initialize = true);
+	/**
+	 * @param compression If compression is enabled, the animated bone nodes are resampled and quantized when they are compiled (see
+	 * SampledAnimationTracks).
+	 */
+	Animation(IOpenGlDevice* openGlDevice, std::string name, bool initialize = true, const AnimationCompressionSettings& compression = AnimationCompressionSettings());
+	Animation(
+		IOpenGlDevice* openGlDevice,
+		std::string name,
+		glm::detail::float64 duration,
+		glm::detail::float64 ticksPerSecond,
+		std::map< std::string, AnimatedBoneNode > animatedBoneNodes,
+		bool initialize = true,
+		const AnimationCompressionSettings& compression = AnimationCompressionSettings()
+	);
 	
 	/**
 	 * Copy constructor.
@@ -56,6 +71,7 @@ public:
 	virtual bool isDirty() const;
 
 	virtual GLuint getBufferId() const;
+	virtual const StreamingBufferRange& getBufferRange() const;
 	GLuint getBindPoint() const;
 
 	virtual void setAnimationTime(glmd::float32 runningTime);
@@ -65,6 +81,28 @@ public:
 	virtual void calculate(const glm::mat4& globalInverseTransformation, const BoneNode& rootBoneNode, const BoneData& boneData, std::vector<glmd::uint32>& indexCache);
 	virtual void calculate(std::vector< glm::mat4 >& transformations, const glm::mat4& globalInverseTransformation, const BoneNode& rootBoneNode, const BoneData& boneData);
 	virtual void calculate(std::vector< glm::mat4 >& transformations, const glm::mat4& globalInverseTransformation, const BoneNode& rootBoneNode, const BoneData& boneData, std::vector<glmd::uint32>& indexCache);
+	virtual void calculate(const glm::mat4& globalInverseTransformation, const Skeleton& skeleton, const SkeletonBones& bones);
+	virtual void calculate(std::vector< glm::mat4 >& transformations, const glm::mat4& globalInverseTransformation, const Skeleton& skeleton, const SkeletonBones& bones);
+	
+	virtual std::vector< glmd::int32 > bindNodes(const Skeleton& skeleton) const;
+	virtual void calculatePose(
+		std::vector< glm::mat4 >& transformations,
+		std::vector< glm::mat4 >& globalTransformations,
+		const glm::mat4& globalInverseTransformation,
+		const Skeleton& skeleton,
+		const std::vector< glmd::int32 >& nodeTracks,
+		const SkeletonBones& bones,
+		glmd::float32 runningTime,
+		glmd::uint32 startFrame,
+		glmd::uint32 endFrame
+	) const;
+	virtual void calculateLocalPose(
+		SkeletonPose& pose,
+		const std::vector< glmd::int32 >& nodeTracks,
+		glmd::float32 runningTime,
+		glmd::uint32 startFrame,
+		glmd::uint32 endFrame
+	) const;
 	
 	void generateIdentityBoneTransforms(glmd::uint32 numBones);
 	
@@ -86,7 +124,7 @@ private:
 	 */
 	Animation();
 
-	GLuint bufferId_;
+	StreamingBufferRange bufferRange_;
 	GLuint bindPoint_;
 
 	IOpenGlDevice* openGlDevice_;
@@ -102,8 +140,16 @@ private:
 	glmd::uint32 startFrame_;
 	glmd::uint32 endFrame_;
 	
-	// A temporary cache to hold previous rotation, position, and scaling node search indices
-	std::vector<glmd::uint32> indexCache_;
+	// The animated bone nodes, compiled for sampling - into sampledTracks_ instead of tracks_ if compression is enabled
+	AnimationCompressionSettings compression_;
+	AnimationTracks tracks_;
+	SampledAnimationTracks sampledTracks_;
+	
+	// The track that animates each node of the skeletons this animation has been calculated for, by skeleton id
+	std::map< glmd::uint32, std::vector< glmd::int32 > > skeletonNodeTracks_;
+	
+	// Scratch space for the global transformation of each skeleton node
+	std::vector< glm::mat4 > globalTransformations_;
 	
 	// The current transformation matrices generated by this animation from the information provided through calling the calculate(..) method
 	std::vector< glm::mat4 > currentTransforms_;
@@ -114,14 +160,20 @@ private:
 
 	void setupAnimationUbo();
 
-	glmd::uint32 findPosition(glmd::float32 animationTime, const AnimatedBoneNode& animatedBoneNode);
-	glmd::uint32 findRotation(glmd::float32 animationTime, const AnimatedBoneNode& animatedBoneNode);
-	glmd::uint32 findScaling(glmd::float32 animationTime, const AnimatedBoneNode& animatedBoneNode);
-
-	void calcInterpolatedPosition(glm::vec3& Out, glmd::float32 animationTime, const AnimatedBoneNode& animatedBoneNode);
-	void calcInterpolatedRotation(glm::quat& Out, glmd::float32 animationTime, const AnimatedBoneNode& animatedBoneNode);
-	void calcInterpolatedScaling(glm::vec3& Out, glmd::float32 animationTime, const AnimatedBoneNode& animatedBoneNode);
-	void readNodeHeirarchy(std::vector< glm::mat4 >& transformations, glmd::float32 animationTime, const glm::mat4& globalInverseTransform, const BoneNode& rootBoneNode, const BoneData& boneData, const glm::mat4& parentTransform);
+	/**
+	 * Compiles the animated bone nodes into tracks_ or sampledTracks_ (and forgets the tracks bound to any skeletons).
+	 */
+	void compileTracks();
+	
+	/**
+	 * Returns the track that animates each node of skeleton - the tracks are matched to the skeleton's nodes the first time it is used.
+	 */
+	const std::vector< glmd::int32 >& getNodeTracks(const Skeleton& skeleton);
+	
+	/**
+	 * Returns the time within the animation, in ticks, for the given running time.
+	 */
+	glmd::float32 getAnimationTime(glmd::float32 runningTime) const;
 	
 	/**
 	 * Will validate the Animated Bone Nodes that are set for this Animation.
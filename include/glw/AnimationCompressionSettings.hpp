@@ -0,0 +1,40 @@
+#ifndef ANIMATIONCOMPRESSIONSETTINGS_H_
+#define ANIMATIONCOMPRESSIONSETTINGS_H_
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace glr
+{
+namespace glw
+{
+
+/**
+ * How animations are resampled and quantized when they are loaded (see SampledAnimationTracks).
+ */
+struct AnimationCompressionSettings
+{
+	AnimationCompressionSettings() : isEnabled(false), sampleRate(30.0f), translationTolerance(0.001f), rotationTolerance(0.001f), scalingTolerance(0.001f), isKeyReductionEnabled(true)
+	{
+	}
+
+	// If false (the default), animations keep their keys as they were imported
+	bool isEnabled;
+
+	// The number of keys per second the animations are resampled at - the most detail a compressed animation can have
+	glm::detail::float32 sampleRate;
+
+	// The largest error key reduction is allowed to introduce (translations and scalings in model units, rotations in radians)
+	glm::detail::float32 translationTolerance;
+	glm::detail::float32 rotationTolerance;
+	glm::detail::float32 scalingTolerance;
+
+	// If true, channels that can be played at a lower rate (or that don't change at all) without going over the tolerance are stored with
+	// fewer keys
+	bool isKeyReductionEnabled;
+};
+
+}
+}
+
+#endif /* ANIMATIONCOMPRESSIONSETTINGS_H_ */
@@ -4,11 +4,15 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <vector>
 #include <mutex>
 
 #include "IAnimationManager.hpp"
 
 #include "IOpenGlDevice.hpp"
+#include "AnimationCompressionSettings.hpp"
+
+#include "ThreadPool.hpp"
 
 #include "serialize/SplitMember.hpp"
 
@@ -22,12 +26,22 @@ class Animation;
 class AnimationManager : public IAnimationManager
 {
 public:
-	AnimationManager(IOpenGlDevice* openGlDevice);
+	/**
+	 * @param numberOfThreads The number of worker threads used by update() (started the first time there is something to update).  If
+	 * 0, there is one for each hardware thread.
+	 * @param compression How the animations added to the manager are compressed.
+	 */
+	AnimationManager(IOpenGlDevice* openGlDevice, glm::detail::uint32 numberOfThreads = 0, const AnimationCompressionSettings& compression = AnimationCompressionSettings());
 	virtual ~AnimationManager();
 
 	virtual IAnimation* getAnimation(const std::string& name) const;
 	virtual IAnimation* addAnimation(const std::string& name, bool initialize = true);
 	virtual IAnimation* addAnimation(const std::string& name, glm::detail::float64 duration, glm::detail::float64 ticksPerSecond, std::map< std::string, AnimatedBoneNode > animatedBoneNodes, bool initialize = true);
+	
+	virtual void addAnimationInstance(IAnimationInstance* instance);
+	virtual void removeAnimationInstance(IAnimationInstance* instance);
+	virtual void update(glm::detail::float32 timeDelta);
+	virtual AnimationStatistics getStatistics() const;
 
 	virtual void serialize(const std::string& filename);
 	virtual void serialize(serialize::TextOutArchive& outArchive);
@@ -42,11 +56,25 @@ private:
 	AnimationManager();
 
 	IOpenGlDevice* openGlDevice_;
+	AnimationCompressionSettings compression_;
 	
 	std::map< std::string, std::unique_ptr<Animation> > animations_;
 	
+	std::vector< IAnimationInstance* > animationInstances_;
+	AnimationStatistics statistics_;
+	
 	mutable std::mutex accessMutex_;
 	
+	// Held for the whole of update() - removing an instance waits on it, so an instance is never removed while it's being updated
+	std::mutex updateMutex_;
+	
+	glm::detail::uint32 numberOfThreads_;
+	std::unique_ptr<ThreadPool> threadPool_;
+	
+	// The instances being updated, and the time each job took (only used by update())
+	std::vector< IAnimationInstance* > updateInstances_;
+	std::vector< glm::detail::float64 > jobTimes_;
+	
 	friend class boost::serialization::access;
 	
 	template<class Archive> void serialize(Archive& ar, const unsigned int version);
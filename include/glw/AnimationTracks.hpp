@@ -0,0 +1,141 @@
+#ifndef ANIMATIONTRACKS_H_
+#define ANIMATIONTRACKS_H_
+
+#include <string>
+#include <vector>
+#include <map>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include "AnimatedBoneNode.hpp"
+#include "Skeleton.hpp"
+
+namespace glr
+{
+namespace glw
+{
+
+namespace glmd = glm::detail;
+
+/**
+ * The animated bone nodes of an animation, compiled into flat arrays of keys - one track per animated bone node.
+ *
+ * Keys are stored as structures of arrays (a times array, and an array for each component), with the keys of each track stored
+ * contiguously, so sampling a track only touches the memory it needs.
+ *
+ * Tracks are matched to the nodes of a skeleton by name once, with bindNodes() - after that, calculating a pose is a single pass over the
+ * skeleton's nodes.
+ */
+class AnimationTracks
+{
+public:
+	/**
+	 * Creates an animation without any tracks.
+	 */
+	AnimationTracks();
+	AnimationTracks(const std::map< std::string, AnimatedBoneNode >& animatedBoneNodes);
+
+	glmd::uint32 getNumberOfTracks() const;
+	const std::vector< std::string >& getNames() const;
+
+	/**
+	 * Returns the number of bytes used by the tracks (not counting the names).
+	 */
+	glmd::uint32 getMemoryUsage() const;
+
+	/**
+	 * Returns the index of the track that animates each node of skeleton (-1 for nodes that aren't animated).
+	 */
+	std::vector< glmd::int32 > bindNodes(const Skeleton& skeleton) const;
+
+	/**
+	 * Calculates the transformation of a node animated by the given track, relative to its parent.
+	 *
+	 * @param transformation Receives the transformation.
+	 * @param track The index of the track.
+	 * @param animationTime The time within the animation, in ticks.
+	 * @param startFrame If startFrame or endFrame is not 0, only the keys from startFrame to endFrame are played.
+	 * @param endFrame
+	 */
+	void calculateLocalTransformation(glm::mat4& transformation, glmd::uint32 track, glmd::float32 animationTime, glmd::uint32 startFrame, glmd::uint32 endFrame) const;
+
+	/**
+	 * Samples the tracks that animate the nodes of a skeleton into a local space pose.  Nodes that aren't animated are left untouched.
+	 *
+	 * @param pose Receives the transformations - must hold a transformation for each node of the skeleton.
+	 * @param nodeTracks The track that animates each node of the skeleton (see bindNodes()).
+	 * @param animationTime The time within the animation, in ticks.
+	 * @param startFrame If startFrame or endFrame is not 0, only the keys from startFrame to endFrame are played.
+	 * @param endFrame
+	 */
+	void calculateLocalPose(SkeletonPose& pose, const std::vector< glmd::int32 >& nodeTracks, glmd::float32 animationTime, glmd::uint32 startFrame, glmd::uint32 endFrame) const;
+
+	/**
+	 * Calculates the transformation of every node of skeleton, relative to rootParentTransformation.
+	 *
+	 * @param globalTransformations Receives the transformations - must hold at least skeleton.getNumberOfNodes() transformations.
+	 * @param skeleton
+	 * @param nodeTracks The track that animates each node of skeleton (see bindNodes()).
+	 * @param animationTime The time within the animation, in ticks.
+	 * @param startFrame If startFrame or endFrame is not 0, only the keys from startFrame to endFrame are played.
+	 * @param endFrame
+	 * @param rootParentTransformation The transformation the root node is relative to - passing the model's global inverse
+	 * transformation here saves applying it to every bone.
+	 */
+	void calculateGlobalTransformations(
+		std::vector< glm::mat4 >& globalTransformations,
+		const Skeleton& skeleton,
+		const std::vector< glmd::int32 >& nodeTracks,
+		glmd::float32 animationTime,
+		glmd::uint32 startFrame,
+		glmd::uint32 endFrame,
+		const glm::mat4& rootParentTransformation = glm::mat4(1.0f)
+	) const;
+
+private:
+	// Sorted, so tracks can be found with a binary search (the animated bone nodes come from a std::map)
+	std::vector< std::string > names_;
+
+	// The keys of track i are keys [keyOffsets[i], keyOffsets[i + 1]) of each channel
+	struct Vec3Keys
+	{
+		std::vector< glmd::uint32 > keyOffsets;
+		std::vector< glmd::float32 > times;
+		std::vector< glmd::float32 > x;
+		std::vector< glmd::float32 > y;
+		std::vector< glmd::float32 > z;
+	};
+
+	struct QuatKeys
+	{
+		std::vector< glmd::uint32 > keyOffsets;
+		std::vector< glmd::float32 > times;
+		std::vector< glmd::float32 > x;
+		std::vector< glmd::float32 > y;
+		std::vector< glmd::float32 > z;
+		std::vector< glmd::float32 > w;
+	};
+
+	Vec3Keys positions_;
+	QuatKeys rotations_;
+	Vec3Keys scalings_;
+
+	// Whether the rotation and scaling keys of each track are at the same times as its position keys
+	std::vector< bool > hasSharedKeyTimes_;
+
+	/**
+	 * Returns the time to sample a track at, once frame clamping is applied.
+	 */
+	glmd::float32 clampToFrames(glmd::uint32 track, glmd::float32 animationTime, glmd::uint32 startFrame, glmd::uint32 endFrame) const;
+
+	/**
+	 * Interpolates the keys of a track, at a time that has already been clamped.
+	 */
+	void sampleTrack(glmd::uint32 track, glmd::float32 animationTime, glm::vec3& translation, glm::quat& rotation, glm::vec3& scaling) const;
+};
+
+}
+}
+
+#endif /* ANIMATIONTRACKS_H_ */
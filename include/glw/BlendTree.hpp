@@ -0,0 +1,234 @@
+#ifndef BLENDTREE_H_
+#define BLENDTREE_H_
+
+#include <string>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include "IAnimation.hpp"
+#include "Skeleton.hpp"
+
+namespace glr
+{
+namespace glw
+{
+
+namespace glmd = glm::detail;
+
+/**
+ * Blends any number of animations into a single pose - a tree of clip, blend (N-way), lerp, additive and layer nodes, evaluated on local
+ * space poses (see SkeletonPose), and turned into one set of bone transformations at the root.
+ *
+ * Each node has its own scratch pose, allocated when the tree is bound to a skeleton - evaluating the tree doesn't allocate.  Children
+ * with no weight are skipped (clips that aren't playing cost nothing), so the cost of a pose is linear in the number of nodes of the
+ * skeleton times the number of active clips.
+ *
+ * A blend tree belongs to a single model (it holds the playing time of each of its clips) - the animations it plays can be shared.
+ *
+ * **Not Thread Safe**: Nodes and parameters should not be changed while the tree is being evaluated.
+ */
+class BlendTree
+{
+public:
+	BlendTree();
+
+	/**
+	 * Adds a node that plays an animation.
+	 *
+	 * @param animation
+	 * @param animationTime The time within the animation to start at, in seconds.
+	 * @param speed How fast the animation plays (the time within the animation advances by speed * timeDelta - see advance()).
+	 *
+	 * @return The index of the node.
+	 */
+	glmd::uint32 addClip(IAnimation* animation, glmd::float32 animationTime = 0.0f, glmd::float32 speed = 1.0f);
+
+	/**
+	 * Adds a node that plays an animation, only playing the frames from startFrame to endFrame (see IAnimation::setFrameClampping()).
+	 */
+	glmd::uint32 addClip(IAnimation* animation, glmd::uint32 startFrame, glmd::uint32 endFrame, glmd::float32 animationTime = 0.0f, glmd::float32 speed = 1.0f);
+
+	/**
+	 * Adds a node that blends any number of nodes, by weight (see setWeights()).  The weights are normalized, and nodes with no weight
+	 * aren't evaluated.
+	 *
+	 * @param children
+	 * @param weights The weight of each child - if empty, the children start with equal weights.
+	 *
+	 * @return The index of the node.
+	 */
+	glmd::uint32 addBlend(const std::vector< glmd::uint32 >& children, const std::vector< glmd::float32 >& weights = std::vector< glmd::float32 >());
+
+	/**
+	 * Adds a node that blends from node a (at factor 0) to node b (at factor 1) - set the factor with setWeight().
+	 *
+	 * @return The index of the node.
+	 */
+	glmd::uint32 addLerp(glmd::uint32 a, glmd::uint32 b, glmd::float32 factor = 0.0f);
+
+	/**
+	 * Adds a node that adds the difference between node additive and node reference on top of node base - set how much of the difference
+	 * is added with setWeight().
+	 *
+	 * @param base
+	 * @param additive
+	 * @param reference The pose additive is relative to - if -1, the skeleton's bind pose.
+	 * @param weight
+	 *
+	 * @return The index of the node.
+	 */
+	glmd::uint32 addAdditive(glmd::uint32 base, glmd::uint32 additive, glmd::int32 reference = -1, glmd::float32 weight = 1.0f);
+
+	/**
+	 * Adds a node that plays node layer over node base, for the masked nodes only - set how much of layer is blended in with setWeight().
+	 *
+	 * @param base
+	 * @param layer
+	 * @param maskNodeNames The names of the skeleton nodes the layer is played on - along with all of their descendants.
+	 * @param weight
+	 *
+	 * @return The index of the node.
+	 */
+	glmd::uint32 addLayer(glmd::uint32 base, glmd::uint32 layer, const std::vector< std::string >& maskNodeNames, glmd::float32 weight = 1.0f);
+
+	glmd::uint32 getNumberOfNodes() const;
+
+	/**
+	 * Sets the node the pose is calculated from.  By default, it is the last node added.
+	 */
+	void setRoot(glmd::uint32 node);
+
+	/**
+	 * Sets the factor of a lerp node, or the weight of an additive or layer node.
+	 */
+	void setWeight(glmd::uint32 node, glmd::float32 weight);
+
+	/**
+	 * Sets the weight of each child of a blend node - there must be a weight for each child.
+	 */
+	void setWeights(glmd::uint32 node, const std::vector< glmd::float32 >& weights);
+
+	/**
+	 * Sets the time within the animation of a clip node, in seconds.
+	 */
+	void setAnimationTime(glmd::uint32 clip, glmd::float32 animationTime);
+	void setSpeed(glmd::uint32 clip, glmd::float32 speed);
+
+	/**
+	 * Advances every clip by timeDelta seconds (times the speed of the clip).
+	 */
+	void advance(glmd::float32 timeDelta);
+
+	/**
+	 * Returns true if the pose may have changed since it was last calculated.
+	 */
+	bool isDirty() const;
+
+	/**
+	 * Returns the number of clips evaluated the last time the pose was calculated.
+	 */
+	glmd::uint32 getNumberOfActiveClips() const;
+
+	/**
+	 * Matches the animations of the clips to the nodes of skeleton, resolves the masks of the layers, and allocates the scratch poses.
+	 * calculatePose() binds the tree if it isn't bound to the skeleton it's given, so this only needs to be called to control when the
+	 * allocation happens.
+	 */
+	void bind(const Skeleton& skeleton);
+
+	/**
+	 * Evaluates the tree, and calculates the bone transformations of the pose.
+	 *
+	 * @param transformations Receives the bone transformations - must hold at least bones.numberOfBones transformations.
+	 * @param globalTransformations Scratch space for the transformation of each skeleton node (resized if it is too small).
+	 * @param globalInverseTransformation The inverse of the transformation of the root of the model.
+	 * @param skeleton The compiled bone node tree of the model.
+	 * @param bones The bones to calculate, bound to skeleton.
+	 */
+	void calculatePose(
+		std::vector< glm::mat4 >& transformations,
+		std::vector< glm::mat4 >& globalTransformations,
+		const glm::mat4& globalInverseTransformation,
+		const Skeleton& skeleton,
+		const SkeletonBones& bones
+	);
+
+	/**
+	 * Evaluates the tree into a local space pose.
+	 *
+	 * @return The pose of the root node - valid until the tree is next evaluated or bound.
+	 */
+	const SkeletonPose& calculateLocalPose(const Skeleton& skeleton);
+
+private:
+	enum NodeType
+	{
+		CLIP = 0,
+		BLEND,
+		LERP,
+		ADDITIVE,
+		LAYER
+	};
+
+	struct Node
+	{
+		NodeType type;
+
+		// Clips only
+		IAnimation* animation;
+		glmd::float32 animationTime;
+		glmd::float32 speed;
+		glmd::uint32 startFrame;
+		glmd::uint32 endFrame;
+		std::vector< glmd::int32 > nodeTracks;
+
+		// Blend and lerp nodes blend all of their children by weight - additive nodes are (base, additive) and layers are (base, layer)
+		std::vector< glmd::uint32 > children;
+		std::vector< glmd::float32 > weights;
+
+		// Additive and layer nodes only
+		glmd::float32 weight;
+		glmd::int32 reference;
+		std::vector< std::string > maskNodeNames;
+		std::vector< glmd::float32 > mask;
+
+		// The pose of the node, and the evaluation it was calculated in (nodes used more than once are only evaluated once)
+		SkeletonPose pose;
+		glmd::uint32 evaluation;
+	};
+
+	std::vector< Node > nodes_;
+	glmd::int32 root_;
+
+	// The skeleton the tree is bound to (0 if it isn't bound)
+	glmd::uint32 skeletonId_;
+
+	glmd::uint32 evaluation_;
+	glmd::uint32 numberOfActiveClips_;
+	bool isDirty_;
+
+	glmd::uint32 addNode(Node node);
+
+	/**
+	 * Returns the node at the given index.
+	 *
+	 * @exception Will throw an InvalidArgumentException if there is no node at the given index.
+	 */
+	Node& getNode(glmd::uint32 node);
+
+	/**
+	 * Evaluates a node (and the children it needs) into the node's pose.
+	 */
+	const SkeletonPose& evaluate(glmd::uint32 node, const Skeleton& skeleton);
+
+	void evaluateBlend(Node& node, const Skeleton& skeleton);
+	void evaluateAdditive(Node& node, const Skeleton& skeleton);
+	void evaluateLayer(Node& node, const Skeleton& skeleton);
+};
+
+}
+}
+
+#endif /* BLENDTREE_H_ */
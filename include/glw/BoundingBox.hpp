@@ -0,0 +1,66 @@
+#ifndef BOUNDINGBOX_H_
+#define BOUNDINGBOX_H_
+
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace glr
+{
+namespace glw
+{
+
+namespace glmd = glm::detail;
+
+/**
+ * An axis aligned bounding box.
+ *
+ * A default constructed bounding box is empty (min is greater than max) - expanding it by a point gives a box holding just that point.
+ */
+struct BoundingBox
+{
+	BoundingBox();
+	BoundingBox(const glm::vec3& min, const glm::vec3& max);
+
+	glm::vec3 min;
+	glm::vec3 max;
+
+	/**
+	 * Returns true if the box holds no points.
+	 */
+	bool isEmpty() const;
+
+	void expand(const glm::vec3& point);
+	void expand(const BoundingBox& other);
+
+	glm::vec3 getCenter() const;
+
+	/**
+	 * Returns the half size of the box along each axis.
+	 */
+	glm::vec3 getExtents() const;
+
+	glmd::float32 getSurfaceArea() const;
+
+	/**
+	 * Returns true if other is entirely inside this box.
+	 */
+	bool contains(const BoundingBox& other) const;
+
+	/**
+	 * Returns the bounding box of this box after it has been transformed by matrix (which may be bigger than the transformed box, if the
+	 * matrix rotates it).  An empty box stays empty.
+	 */
+	BoundingBox transform(const glm::mat4& matrix) const;
+
+	/**
+	 * Returns the bounding box of points (an empty box if there are no points).
+	 */
+	static BoundingBox fromPoints(const std::vector< glm::vec3 >& points);
+};
+
+}
+}
+
+#endif /* BOUNDINGBOX_H_ */
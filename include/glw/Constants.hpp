@@ -19,6 +19,11 @@ public:
 	
 	static const glmd::uint32 MAX_NUMBER_OF_BONES_PER_MESH;
 	
+	static const glmd::uint32 STREAMING_BUFFER_REGION_SIZE;
+	static const glmd::uint32 STREAMING_BUFFER_NUMBER_OF_REGIONS;
+	
+	static const glmd::uint32 MAX_NUMBER_OF_INSTANCES_PER_DRAW;
+	
 	static const std::string GLR_IDENTITY_BONES;
 };
 
@@ -10,9 +10,11 @@
 #include "IMesh.hpp"
 
 #include "IGraphicsObject.hpp"
+#include "StreamingBuffer.hpp"
 
 #include "AnimatedBoneNode.hpp"
 #include "BoneNode.hpp"
+#include "Skeleton.hpp"
 
 #include "common/utilities/Macros.hpp"
 
@@ -37,14 +39,18 @@ namespace glw
  * 		// Only play frames within this range
  * 		animation->setFrameClampping( startFrame_, endFrame_ );
  * 
- * 		// Calculate the transformations that are used to animation the mesh
- * 		animation->calculate(globalInverseTransformation, mesh.getSkeleton(), mesh.getBones());
+ * 		// Calculate the transformations that are used to animation the mesh - the skeleton is compiled from the model's bone node tree,
+ * 		// and the bones are the mesh's bone data bound to it, when the model is loaded
+ * 		animation->calculate(globalInverseTransformation, skeleton, bones);
  * 
- * 		// Bind the transformations into OpenGL
- * 		animation->bind();
+ * 		// Stream the transformations into OpenGL
+ * 		animation->pushToVideoMemory();
  * 
- * 		openGlDevice->bindBuffer( animation->getBufferId(), bindPoint );
+ * 		openGlDevice->bindBuffer( animation->getBufferRange(), bindPoint );
  * }
+ * 
+ * Models playing an animation don't need any of this - their poses are calculated by IAnimationManager::update(), which
+ * GlrProgram::render() calls every frame (see IAnimationManager::update() for how to advance their animation times).
  */
 class IAnimation : public virtual IGraphicsObject, public virtual serialize::ITextSerializable
 {
@@ -91,11 +97,22 @@ public:
 	 * @return The OpenGL Buffer Id.
 	 */
 	virtual GLuint getBufferId() const = 0;
+	
+	/**
+	 * Returns the range of the OpenGL buffer that the transformations were last pushed to.  The range is only valid until the end of the
+	 * frame.
+	 * 
+	 * @return The range of the OpenGL buffer.
+	 */
+	virtual const StreamingBufferRange& getBufferRange() const = 0;
 
 	// TODO: Should we have this in the interface?
 	/**
 	 * Will generate the transformation matrices to be used to animate the model with the given bone data.
 	 * 
+	 * **Note**: The bone node tree is compiled into a Skeleton (and the bone data bound to it) on every call - prefer the Skeleton overloads
+	 * for anything that is calculated more than once.
+	 * 
 	 * @param globalInverseTransformation - Not sure what this is...
 	 * @param rootBoneNode - Root node of the skeleton used for the current animation.
 	 * @param boneData - Data about the bones we are generating the animation on.
@@ -108,9 +125,7 @@ public:
 	 * @param globalInverseTransformation - Not sure what this is...
 	 * @param rootBoneNode - Root node of the skeleton used for the current animation.
 	 * @param boneData - Data about the bones we are generating the animation on.
-	 * @param indexCache - If passed in, represents a cache of previous rotation, position, and scaling node search indices.  The algorithm to find
-	 * the correct indices for the animation will use the indexCache index values to determine where to begin the search for the next
-	 * rotation, position, and scaling index.
+	 * @param indexCache - Unused - keys are found with a binary search of each track.
 	 */
 	virtual void calculate(const glm::mat4& globalInverseTransformation, const BoneNode& rootBoneNode, const BoneData& boneData, std::vector<glm::detail::uint32>& indexCache) = 0;
 	
@@ -139,11 +154,88 @@ public:
 	 * @param globalInverseTransformation - Not sure what this is...
 	 * @param rootBoneNode - Root node of the skeleton used for the current animation.
 	 * @param boneData - Data about the bones we are generating the animation on.
-	 * @param indexCache - If passed in, represents a cache of previous rotation, position, and scaling node search indices.  The algorithm to find
-	 * the correct indices for the animation will use the indexCache index values to determine where to begin the search for the next
-	 * rotation, position, and scaling index.
+	 * @param indexCache - Unused - keys are found with a binary search of each track.
 	 */
 	virtual void calculate(std::vector< glm::mat4 >& transformations, const glm::mat4& globalInverseTransformation, const BoneNode& rootBoneNode, const BoneData& boneData, std::vector<glm::detail::uint32>& indexCache) = 0;
+	
+	/**
+	 * Will generate the transformation matrices to be used to animate a mesh.
+	 * 
+	 * The skeleton's nodes are evaluated in a single pass, in order - the tracks of this animation are matched to the skeleton's nodes
+	 * the first time it is used with this animation.
+	 * 
+	 * @param globalInverseTransformation - The inverse of the transformation of the root of the model.
+	 * @param skeleton - The compiled bone node tree of the model.
+	 * @param bones - The bones of the mesh we are generating the animation on, bound to skeleton.
+	 */
+	virtual void calculate(const glm::mat4& globalInverseTransformation, const Skeleton& skeleton, const SkeletonBones& bones) = 0;
+	
+	/**
+	 * Will generate the transformation matrices to be used to animate a mesh.  It will store these transformations in the 'transformations' parameter.
+	 * 
+	 * @param transformations The container to store the animations transformations in - must hold at least bones.numberOfBones transformations.
+	 * @param globalInverseTransformation - The inverse of the transformation of the root of the model.
+	 * @param skeleton - The compiled bone node tree of the model.
+	 * @param bones - The bones of the mesh we are generating the animation on, bound to skeleton.
+	 */
+	virtual void calculate(std::vector< glm::mat4 >& transformations, const glm::mat4& globalInverseTransformation, const Skeleton& skeleton, const SkeletonBones& bones) = 0;
+	
+	/**
+	 * Returns the track of this animation that animates each node of skeleton (-1 for nodes that aren't animated), for use with
+	 * calculatePose().
+	 * 
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment.
+	 */
+	virtual std::vector< glm::detail::int32 > bindNodes(const Skeleton& skeleton) const = 0;
+	
+	/**
+	 * Will generate the transformation matrices to be used to animate a mesh, at the given running time.  Unlike calculate(), this
+	 * doesn't use (or change) the animation time, frame clamping or any other state of the animation - so any number of threads can
+	 * calculate poses of the same animation at once (each with their own transformations and scratch space).
+	 * 
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment.
+	 * 
+	 * @param transformations The container to store the animations transformations in - must hold at least bones.numberOfBones transformations.
+	 * @param globalTransformations Scratch space for the transformation of each skeleton node (resized if it is too small).
+	 * @param globalInverseTransformation - The inverse of the transformation of the root of the model.
+	 * @param skeleton - The compiled bone node tree of the model.
+	 * @param nodeTracks - The tracks bound to the skeleton's nodes (see bindNodes()).
+	 * @param bones - The bones we are generating the animation on, bound to skeleton.
+	 * @param runningTime - The time within the animation (see setAnimationTime()).
+	 * @param startFrame - Only play frames within this range (see setFrameClampping()).
+	 * @param endFrame
+	 */
+	virtual void calculatePose(
+		std::vector< glm::mat4 >& transformations,
+		std::vector< glm::mat4 >& globalTransformations,
+		const glm::mat4& globalInverseTransformation,
+		const Skeleton& skeleton,
+		const std::vector< glm::detail::int32 >& nodeTracks,
+		const SkeletonBones& bones,
+		glm::detail::float32 runningTime,
+		glm::detail::uint32 startFrame,
+		glm::detail::uint32 endFrame
+	) const = 0;
+	
+	/**
+	 * Samples this animation into a local space pose (the transformation of each skeleton node, relative to its parent), at the given
+	 * running time - for blending with other poses (see BlendTree).  Nodes that this animation doesn't animate are left untouched.
+	 * 
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment.
+	 * 
+	 * @param pose Receives the transformations - must hold a transformation for each node of the skeleton.
+	 * @param nodeTracks - The tracks bound to the skeleton's nodes (see bindNodes()).
+	 * @param runningTime - The time within the animation (see setAnimationTime()).
+	 * @param startFrame - Only play frames within this range (see setFrameClampping()).
+	 * @param endFrame
+	 */
+	virtual void calculateLocalPose(
+		SkeletonPose& pose,
+		const std::vector< glm::detail::int32 >& nodeTracks,
+		glm::detail::float32 runningTime,
+		glm::detail::uint32 startFrame,
+		glm::detail::uint32 endFrame
+	) const = 0;
 
 	/**
 	 * Will set the animation time to runningTime.
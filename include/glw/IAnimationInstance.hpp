@@ -0,0 +1,38 @@
+#ifndef IANIMATIONINSTANCE_H_
+#define IANIMATIONINSTANCE_H_
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace glr
+{
+namespace glw
+{
+
+/**
+ * Something that plays animations (like a model), and has its pose calculated by IAnimationManager::update().
+ */
+class IAnimationInstance
+{
+public:
+	virtual ~IAnimationInstance()
+	{
+	}
+	;
+
+	/**
+	 * Advances the playing animation (if there is one) by timeDelta seconds, and calculates its pose - ready to be streamed into video
+	 * memory when it is rendered.
+	 * 
+	 * **Thread Safe**: This method is called from the animation manager's worker threads - different instances are updated at the same
+	 * time.
+	 * 
+	 * @param timeDelta The time, in seconds, since the last update.
+	 */
+	virtual void updateAnimation(glm::detail::float32 timeDelta) = 0;
+};
+
+}
+}
+
+#endif /* IANIMATIONINSTANCE_H_ */
@@ -4,6 +4,7 @@
 #include <string>
 
 #include "Animation.hpp"
+#include "IAnimationInstance.hpp"
 
 #include "serialize/ITextSerializable.hpp"
 
@@ -14,6 +15,30 @@ namespace glw
 
 class IAnimation;
 
+/**
+ * Timings of the last IAnimationManager::update() (all times are in milliseconds).
+ */
+struct AnimationStatistics
+{
+	AnimationStatistics() : numberOfInstances(0), numberOfJobs(0), numberOfThreads(0), gatherTime(0.0), evaluateTime(0.0), workerTime(0.0), updateTime(0.0)
+	{
+	}
+	
+	glm::detail::uint32 numberOfInstances;
+	// The number of chunks the instances were split into, and the number of threads that could run them (including the calling thread)
+	glm::detail::uint32 numberOfJobs;
+	glm::detail::uint32 numberOfThreads;
+	
+	// Collecting the instances to update
+	glm::detail::float64 gatherTime;
+	// Calculating the pose of every instance (wall clock time)
+	glm::detail::float64 evaluateTime;
+	// The time each job took, added together - workerTime / evaluateTime is how many threads were busy, on average
+	glm::detail::float64 workerTime;
+	// The whole update
+	glm::detail::float64 updateTime;
+};
+
 class IAnimationManager : public virtual serialize::ITextSerializable
 {
 public:
@@ -68,6 +93,51 @@ public:
 	 * @return An Animation object.
 	 */
 	virtual IAnimation* addAnimation(const std::string& name, glm::detail::float64 duration, glm::detail::float64 ticksPerSecond, std::map< std::string, AnimatedBoneNode > animatedBoneNodes, bool initialize = true) = 0;
+	
+	/**
+	 * Adds an instance to be updated by update().  Adding an instance that has already been added does nothing.
+	 * 
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment (including while update() is running - the instance
+	 * is updated from the next update() on).
+	 */
+	virtual void addAnimationInstance(IAnimationInstance* instance) = 0;
+	
+	/**
+	 * Removes an instance, so that it is no longer updated.  If update() is running, this waits for it to finish - so the instance can
+	 * be destroyed as soon as this returns.
+	 * 
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment (but must not be called from
+	 * IAnimationInstance::updateAnimation(), or while holding a lock that updateAnimation() takes).
+	 */
+	virtual void removeAnimationInstance(IAnimationInstance* instance) = 0;
+	
+	/**
+	 * Advances every animation instance by timeDelta seconds, and calculates their poses.  The instances are spread across a pool of
+	 * worker threads (and the calling thread), and this blocks until all of them are done - after that, rendering an instance only
+	 * has to stream its pose into video memory.
+	 * 
+	 * Instances that aren't updated still calculate their pose when they are rendered - update() just moves that work out of rendering,
+	 * and onto all of the cores.
+	 * 
+	 * GlrProgram::render() calls update(0) every frame, before the scene is drawn - so poses are always calculated in parallel, but the
+	 * animation times are left alone.  To play animations in real time, the application calls update() with the frame time before
+	 * GlrProgram::render() (the pose is then already up to date, and render's update only checks that).  Applications that set the times
+	 * themselves (i.e. with IModel::setAnimationTime()) don't need to call it.
+	 * 
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment (but only one update runs at a time).  It should
+	 * be called at most once per frame (besides the call in GlrProgram::render()), before rendering.
+	 * 
+	 * @param timeDelta The time, in seconds, since the last update.  Pass 0 if the animation times are set some other way (i.e. with
+	 * IModel::setAnimationTime()).
+	 */
+	virtual void update(glm::detail::float32 timeDelta) = 0;
+	
+	/**
+	 * Returns the timings of the last update().
+	 * 
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment.
+	 */
+	virtual AnimationStatistics getStatistics() const = 0;
 };
 
 }
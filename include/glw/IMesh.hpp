@@ -2,6 +2,7 @@
 #define IMESH_H_
 
 #include <map>
+#include <vector>
 #include <iostream>
 #include <sstream>
 
@@ -13,6 +14,8 @@
 #include "Bone.hpp"
 
 #include "IGraphicsObject.hpp"
+#include "StreamingBuffer.hpp"
+#include "BoundingBox.hpp"
 
 #include "common/logger/Logger.hpp"
 
@@ -42,11 +45,37 @@ public:
 	 */
 	virtual void render() = 0;
 	
+	/**
+	 * Will render numberOfInstances copies of this mesh in a single draw call.  The model matrix of each instance is read from instances
+	 * (a range of the vertex streaming buffer holding numberOfInstances glm::mat4s) into the 'in_InstanceModelMatrix' vertex attribute.
+	 * 
+	 * Requires instancing support (see IOpenGlDevice::isInstancingSupported()).
+	 * 
+	 * **Not Thread Safe**: This method is *not* safe to call in a multi-threaded environment, and should only be called from the 
+	 * OpenGL thread.
+	 */
+	virtual void renderInstanced(const StreamingBufferRange& instances, glm::detail::uint32 numberOfInstances) = 0;
+	
 	/**
 	 * Returns a reference to the bone data.
 	 */
 	virtual BoneData& getBoneData() = 0;
 	
+	/**
+	 * Sets the (optional) index list for this mesh.  If a mesh has indices, every 3 consecutive indices reference the vertices of a
+	 * triangle, and the mesh is drawn with an indexed draw call.  Otherwise, every 3 consecutive vertices make up a triangle.
+	 * 
+	 * The index buffer in video memory holds 16 bit indices if the mesh has 65536 vertices or less, and 32 bit indices otherwise.
+	 */
+	virtual void setIndices(std::vector< glm::detail::uint32 > indices) = 0;
+	virtual std::vector< glm::detail::uint32 >& getIndices() = 0;
+	
+	/**
+	 * Returns the bounding box of the vertices of this mesh (in model space).  It is calculated when the mesh is pushed to video memory,
+	 * so it is still available after the local data is freed.  Meshes that haven't been pushed to video memory have an empty bounding box.
+	 */
+	virtual const BoundingBox& getBoundingBox() const = 0;
+	
 	/**
 	 * Returns the name of this mesh.
 	 * 
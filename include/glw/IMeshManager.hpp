@@ -78,6 +78,39 @@ public:
 		bool initialize = true
 	) = 0;
 	
+	/**
+	 * Creates a mesh with the given name and using the provided mesh data, with its vertices laid out as described by vertexFormat.
+	 * 
+	 * If a mesh already exists with the given name, it will return that mesh.
+	 * 
+	 * **Partially Thread Safe**: If initialize is false, this method is safe to call in a multi-threaded environment.  However, 
+	 * if initialize is true, this method is *not* thread safe, and should only be called from the OpenGL thread.
+	 * 
+	 * @param name The name to use for the new mesh.
+	 * @param vertices
+	 * @param normals
+	 * @param textureCoordinates
+	 * @param colors
+	 * @param bones
+	 * @param vertexFormat The layout to use for the mesh's vertex buffer.  If it has no attributes, createDefaultVertexFormat() is used
+	 * (with bone attributes only if bones isn't empty).
+	 * @param initialize If true, will initialize all of the resources required for this mesh.  Otherwise, it will
+	 * just create the mesh and return it (without initializing it).
+	 * 
+	 * @return A Mesh object.
+	 */
+	virtual IMesh* addMesh(
+		const std::string& name, 
+		std::vector< glm::vec3 > vertices, 
+		std::vector< glm::vec3 > normals,
+		std::vector< glm::vec2 > textureCoordinates,
+		std::vector< glm::vec4 > colors,
+		std::vector< VertexBoneData > bones,
+		BoneData boneData,
+		VertexFormat vertexFormat,
+		bool initialize = true
+	) = 0;
+	
 	/**
 	 * Creates a mesh with the given name and using the provided mesh data.
 	 * 
@@ -16,6 +16,7 @@
 
 #include "glw/OpenGlDeviceSettings.hpp"
 #include "glw/Constants.hpp"
+#include "glw/StreamingBuffer.hpp"
 
 namespace glr
 {
@@ -65,6 +66,11 @@ public:
 	virtual GLuint createFrameBufferObject(GLenum target, glm::detail::uint32 totalSize, const void* dataPointer) = 0;
 	virtual void releaseFrameBufferObject(GLuint bufferId) = 0;
 	virtual void bindBuffer(GLuint bufferId, GLuint bindPoint) = 0;
+	
+	/**
+	 * Binds the range of a buffer (i.e. one returned by `streamUniformData`) to the given uniform buffer bind point.
+	 */
+	virtual void bindBuffer(const StreamingBufferRange& range, GLuint bindPoint) = 0;
 	virtual void unbindBuffer(GLuint bufferId) = 0;
 	virtual GLuint getBindPoint() = 0;
 	
@@ -83,6 +89,41 @@ public:
 	
 	virtual GlError getGlError() = 0;
 	
+	/**
+	 * Copies data that changes every frame (bone transformations, lights, etc) into the uniform streaming buffer, and returns the range
+	 * it was copied into.  The range is valid until the end of the frame, and should be bound with `bindBuffer(range, bindPoint)`.
+	 * 
+	 * **Not Thread Safe**: This method should only be called from the OpenGL thread.
+	 * 
+	 * @param data
+	 * @param size The number of bytes to copy.
+	 * @param rangeSize The size of the range to allocate, if it should be larger than size (i.e. to cover the whole uniform block).
+	 */
+	virtual StreamingBufferRange streamUniformData(const void* data, glm::detail::uint32 size, glm::detail::uint32 rangeSize = 0) = 0;
+	
+	/**
+	 * Copies per frame vertex data (i.e. the model matrices of instances) into the vertex streaming buffer, and returns the range it was
+	 * copied into.  The range is valid until the end of the frame.
+	 * 
+	 * **Not Thread Safe**: This method should only be called from the OpenGL thread.
+	 * 
+	 * @param data
+	 * @param size The number of bytes to copy.
+	 */
+	virtual StreamingBufferRange streamVertexData(const void* data, glm::detail::uint32 size) = 0;
+	
+	/**
+	 * Returns true if instanced vertex attributes (OpenGL 3.3 or ARB_instanced_arrays) are available.
+	 */
+	virtual bool isInstancingSupported() const = 0;
+	
+	/**
+	 * Marks the end of a frame.  Data streamed during the frame won't be overwritten until the GPU is done with it.
+	 * 
+	 * This method should be called once per frame, after all of the frame's draw calls have been issued.
+	 */
+	virtual void endFrame() = 0;
+	
 	/* Getters */
 	virtual glr::shaders::IShaderProgramManager* getShaderProgramManager() = 0;
 	
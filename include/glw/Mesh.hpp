@@ -11,6 +11,7 @@
 #include <assimp/postprocess.h>
 
 #include "IMesh.hpp"
+#include "VertexFormat.hpp"
 
 #include "shaders/IShaderProgram.hpp"
 
@@ -24,6 +25,8 @@ class IOpenGlDevice;
 /**
  * A class that contains mesh data, and can load this data into OpenGL, as well as render that data
  * once it has been transferred.
+ * 
+ * The vertex data is interleaved into a single vertex buffer, laid out as described by the mesh's VertexFormat.
  */
 class Mesh : public IMesh
 {
@@ -51,6 +54,26 @@ public:
 		bool initialize = true
 	);
 	
+	/**
+	 * Standard constructor.
+	 * 
+	 * @param vertexFormat The layout to use for the vertex buffer.  If it has no attributes, createDefaultVertexFormat() is used (with bone
+	 * attributes only if vertexBoneData isn't empty).
+	 * @param initialize If true, will initialize all of the resources required for this mesh.  Otherwise, it will
+	 * just create the mesh and return it (without initializing it).
+	 */
+	Mesh(IOpenGlDevice* openGlDevice,
+		std::string name,
+		std::vector< glm::vec3 > vertices,
+		std::vector< glm::vec3 > normals,
+		std::vector< glm::vec2 > textureCoordinates,
+		std::vector< glm::vec4 > colors,
+		std::vector< VertexBoneData > vertexBoneData,
+		BoneData boneData,
+		VertexFormat vertexFormat,
+		bool initialize = true
+	);
+	
 	/**
 	 * Standard constructor.
 	 * 
@@ -70,6 +93,7 @@ public:
 	virtual ~Mesh();
 
 	virtual void render();
+	virtual void renderInstanced(const StreamingBufferRange& instances, glm::detail::uint32 numberOfInstances);
 	
 	virtual BoneData& getBoneData();
 	
@@ -92,11 +116,34 @@ public:
 	void setColors(std::vector< glm::vec4 > colors);
 	void setVertexBoneData(std::vector< VertexBoneData > vertexBoneData);
 	
+	virtual void setIndices(std::vector< glm::detail::uint32 > indices);
+	
+	/**
+	 * Sets the layout of the vertex buffer (by default, createDefaultVertexFormat() - with bone attributes only if the mesh was created with
+	 * bone data).  Attributes the format doesn't have aren't uploaded - except for bone data: if the mesh has bone data (i.e. it is given
+	 * bone data later, or is deserialized), any missing bone attributes are added to the format when video memory is allocated.
+	 * 
+	 * Meshes without bone attributes can be rendered with the 'glr_basic_static' shader program, which doesn't do any skinning.  Skinned
+	 * shader programs still work - every vertex is given bone 0 with a weight of 1.
+	 * 
+	 * If video memory has already been allocated, it is re-allocated (with the new layout) the next time the mesh is pushed to video memory.
+	 */
+	void setVertexFormat(VertexFormat vertexFormat);
+	const VertexFormat& getVertexFormat() const;
+	
+	/**
+	 * Interleaves the local vertex data into vertices, in the layout of the mesh's vertex format.  Vertex attributes that have less
+	 * data than there are vertices are padded with zeros.
+	 */
+	void packVertices(std::vector< glm::detail::uint8 >& vertices) const;
+	
 	std::vector< glm::vec3 >& getVertices();
 	std::vector< glm::vec3 >& getNormals();
 	std::vector< glm::vec2 >& getTextureCoordinates();
 	std::vector< glm::vec4 >& getColors();
 	std::vector< VertexBoneData >& getVertexBoneData();
+	virtual std::vector< glm::detail::uint32 >& getIndices();
+	virtual const BoundingBox& getBoundingBox() const;
 	
 	virtual void serialize(const std::string& filename);
 	virtual void serialize(serialize::TextOutArchive& outArchive);
@@ -112,11 +159,18 @@ protected:
 	std::vector< glm::vec2 > textureCoordinates_;
 	std::vector< glm::vec4 > colors_;
 	std::vector< VertexBoneData > vertexBoneData_;
+	std::vector< glm::detail::uint32 > indices_;
 
 	BoneData boneData_;
+	
+	VertexFormat vertexFormat_ = createDefaultVertexFormat(false);
+	bool hasVertexFormatChanged_ = false;
 
 	glm::detail::uint32 vaoId_;
-	glm::detail::uint32 vboIds_[5];
+	glm::detail::uint32 vboId_ = 0;
+	glm::detail::uint32 indexBufferId_ = 0;
+	// GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+	GLenum indexType_ = GL_UNSIGNED_INT;
 	
 	std::atomic<bool> isLocalDataLoaded_;
 	std::atomic<bool> isVideoMemoryAllocated_;
@@ -124,8 +178,20 @@ protected:
 	
 	glm::detail::uint32 currentNumberOfVertices_ = 0;
 	glm::detail::uint32 currentVerticesSpaceAllocated_ = 0;
+	glm::detail::uint32 currentNumberOfIndices_ = 0;
+	glm::detail::uint32 currentIndicesSpaceAllocated_ = 0;
 	
 	std::string textureFileName_;
+	
+	BoundingBox boundingBox_;
+	
+	/**
+	 * Writes every attribute of numberOfVertices vertices, starting at firstVertex, into the interleaved buffer vertices.  packVertices()
+	 * calls this a block of vertices at a time.
+	 * 
+	 * Subclasses with extra vertex attributes should extend this to write them.
+	 */
+	virtual void writeVertices(std::vector< glm::detail::uint8 >& vertices, glm::detail::uint32 firstVertex, glm::detail::uint32 numberOfVertices) const;
 
 private:
 	/**
@@ -133,6 +199,11 @@ private:
 	 */
 	Mesh();
 
+	/**
+	 * Adds the bone attributes to our vertex format, if we have bone data and the format is missing either of them.
+	 */
+	void addMissingBoneAttributes();
+
 	friend class boost::serialization::access;
 	
 	template<class Archive> void inline serialize(Archive& ar, const unsigned int version);
@@ -16,6 +16,7 @@ template<class Archive> void Mesh::serialize(Archive& ar, const unsigned int ver
 	ar & textureCoordinates_;
 	ar & colors_;
 	ar & vertexBoneData_;
+	ar & indices_;
 	ar & boneData_;
 }
 
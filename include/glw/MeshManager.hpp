@@ -37,6 +37,17 @@ public:
 		BoneData boneData,
 		bool initialize = true
 	);
+	virtual IMesh* addMesh(
+		const std::string& name, 
+		std::vector< glm::vec3 > vertices, 
+		std::vector< glm::vec3 > normals,
+		std::vector< glm::vec2 > textureCoordinates,
+		std::vector< glm::vec4 > colors,
+		std::vector< VertexBoneData > bones,
+		BoneData boneData,
+		VertexFormat vertexFormat,
+		bool initialize = true
+	);
 	virtual IMesh* addMesh(
 		const std::string& name, 
 		std::vector< glm::vec3 > vertices, 
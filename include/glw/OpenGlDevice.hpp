@@ -11,6 +11,7 @@
 #endif
 
 #include "IOpenGlDevice.hpp"
+#include "StreamingBuffer.hpp"
 
 #include "shaders/ShaderProgramManager.hpp"
 #include "shaders/IShaderProgramBindListener.hpp"
@@ -47,6 +48,7 @@ public:
 	virtual GLuint createFrameBufferObject(GLenum target, glm::detail::uint32 totalSize, const void* dataPointer);
 	virtual void releaseFrameBufferObject(GLuint bufferId);
 	virtual void bindBuffer(GLuint bufferId, GLuint bindPoint);
+	virtual void bindBuffer(const StreamingBufferRange& range, GLuint bindPoint);
 	virtual void unbindBuffer(GLuint bufferId);
 	virtual GLuint getBindPoint();
 	
@@ -55,6 +57,11 @@ public:
 	
 	virtual GlError getGlError();
 	
+	virtual StreamingBufferRange streamUniformData(const void* data, glm::detail::uint32 size, glm::detail::uint32 rangeSize = 0);
+	virtual StreamingBufferRange streamVertexData(const void* data, glm::detail::uint32 size);
+	virtual bool isInstancingSupported() const;
+	virtual void endFrame();
+	
 	virtual shaders::IShaderProgramManager* getShaderProgramManager();
 	
 	virtual IMaterialManager* getMaterialManager();
@@ -96,6 +103,9 @@ private:
 	glmd::uint32 currentBindPoint_;
 	//std::vector< glmd::int32 > bindings_;
 	
+	std::unique_ptr<StreamingBuffer> uniformStreamingBuffer_;
+	std::unique_ptr<StreamingBuffer> vertexStreamingBuffer_;
+	
 	std::unique_ptr<IMaterialManager> materialManager_;
 	std::unique_ptr<ITextureManager> textureManager_;
 	std::unique_ptr<IMeshManager> meshManager_;
@@ -4,6 +4,7 @@
 #include <string>
 
 #include "glw/Constants.hpp"
+#include "glw/AnimationCompressionSettings.hpp"
 
 namespace glr
 {
@@ -15,11 +16,24 @@ namespace glw
  */
 struct OpenGlDeviceSettings
 {
-	OpenGlDeviceSettings() : defaultTextureDir(glr::glw::Constants::MODEL_DIRECTORY)
+	OpenGlDeviceSettings() : defaultTextureDir(glr::glw::Constants::MODEL_DIRECTORY), streamingBufferRegionSize(glr::glw::Constants::STREAMING_BUFFER_REGION_SIZE), numberOfAnimationThreads(0)
 	{
 	}
 	
 	std::string defaultTextureDir;
+	// The directory to keep model cache files in, so that models don't have to be imported again on later runs (see
+	// models/ModelCache.hpp).  If empty (the default), models are not cached.
+	std::string modelCacheDir;
+	
+	// The size, in bytes, of each of the regions of the uniform streaming buffer (there is one region per frame in flight)
+	glm::detail::uint32 streamingBufferRegionSize;
+	
+	// The number of worker threads the animation manager calculates poses with (see IAnimationManager::update()).  If 0 (the default),
+	// there is one for each hardware thread.
+	glm::detail::uint32 numberOfAnimationThreads;
+	
+	// How animations are compressed when they are loaded (see SampledAnimationTracks).  Animations aren't compressed by default.
+	AnimationCompressionSettings animationCompression;
 };
 
 }
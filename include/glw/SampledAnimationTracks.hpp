@@ -0,0 +1,142 @@
+#ifndef SAMPLEDANIMATIONTRACKS_H_
+#define SAMPLEDANIMATIONTRACKS_H_
+
+#include <string>
+#include <vector>
+#include <map>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include "AnimatedBoneNode.hpp"
+#include "AnimationCompressionSettings.hpp"
+#include "Skeleton.hpp"
+
+namespace glr
+{
+namespace glw
+{
+
+namespace glmd = glm::detail;
+
+/**
+ * The animated bone nodes of an animation, resampled at a fixed rate and quantized - a compact alternative to AnimationTracks.
+ *
+ * Every channel (the translations, rotations or scalings of a track) has evenly spaced keys, so the key to sample is found with a
+ * multiply rather than a search.  Translations and scalings are stored as 16 bits per component (relative to the range of the channel),
+ * and rotations as 48 bit 'smallest three' quaternions - 6 bytes per key, with no key times.
+ *
+ * With key reduction, each channel is stored at the lowest rate (halving the sample rate each time) that stays within the tolerance of the
+ * imported keys - channels that don't change are stored as a single key.
+ *
+ * Frame clamping uses the key times of the track with the most position keys, rather than the keys of each track.
+ */
+class SampledAnimationTracks
+{
+public:
+	/**
+	 * Creates an animation without any tracks.
+	 */
+	SampledAnimationTracks();
+
+	/**
+	 * @param animatedBoneNodes
+	 * @param duration The duration of the animation, in ticks - keys are sampled over the duration (or up to the last key, if it is later).
+	 * @param ticksPerSecond
+	 * @param settings
+	 */
+	SampledAnimationTracks(const std::map< std::string, AnimatedBoneNode >& animatedBoneNodes, glmd::float64 duration, glmd::float64 ticksPerSecond, const AnimationCompressionSettings& settings);
+
+	glmd::uint32 getNumberOfTracks() const;
+	const std::vector< std::string >& getNames() const;
+
+	/**
+	 * Returns the number of keys stored, across all of the channels of all of the tracks.
+	 */
+	glmd::uint32 getNumberOfKeys() const;
+
+	/**
+	 * Returns the number of bytes used by the tracks (not counting the names).
+	 */
+	glmd::uint32 getMemoryUsage() const;
+
+	/**
+	 * Returns the index of the track that animates each node of skeleton (-1 for nodes that aren't animated).
+	 */
+	std::vector< glmd::int32 > bindNodes(const Skeleton& skeleton) const;
+
+	/**
+	 * Calculates the transformation of a node animated by the given track, relative to its parent.
+	 *
+	 * @param transformation Receives the transformation.
+	 * @param track The index of the track.
+	 * @param animationTime The time within the animation, in ticks.
+	 * @param startFrame If startFrame or endFrame is not 0, only the frames from startFrame to endFrame are played.
+	 * @param endFrame
+	 */
+	void calculateLocalTransformation(glm::mat4& transformation, glmd::uint32 track, glmd::float32 animationTime, glmd::uint32 startFrame, glmd::uint32 endFrame) const;
+
+	/**
+	 * Samples the tracks that animate the nodes of a skeleton into a local space pose (see AnimationTracks::calculateLocalPose()).
+	 */
+	void calculateLocalPose(SkeletonPose& pose, const std::vector< glmd::int32 >& nodeTracks, glmd::float32 animationTime, glmd::uint32 startFrame, glmd::uint32 endFrame) const;
+
+	/**
+	 * Calculates the transformation of every node of skeleton, relative to rootParentTransformation (see
+	 * AnimationTracks::calculateGlobalTransformations()).
+	 */
+	void calculateGlobalTransformations(
+		std::vector< glm::mat4 >& globalTransformations,
+		const Skeleton& skeleton,
+		const std::vector< glmd::int32 >& nodeTracks,
+		glmd::float32 animationTime,
+		glmd::uint32 startFrame,
+		glmd::uint32 endFrame,
+		const glm::mat4& rootParentTransformation = glm::mat4(1.0f)
+	) const;
+
+private:
+	// Sorted, so tracks can be found with a binary search (the animated bone nodes come from a std::map)
+	std::vector< std::string > names_;
+
+	// The keys of a channel are keys [keyOffset, keyOffset + numberOfKeys) of the channel type, evenly spaced from time 0 - key i is at
+	// time i / keysPerTick.  Channels without any keys can't be sampled.
+	struct Channel
+	{
+		glmd::uint32 keyOffset;
+		glmd::uint32 numberOfKeys;
+		glmd::float32 keysPerTick;
+
+		// Translations and scalings only - a component is minimum + key * step
+		glm::vec3 minimum;
+		glm::vec3 step;
+	};
+
+	std::vector< Channel > translations_;
+	std::vector< Channel > rotations_;
+	std::vector< Channel > scalings_;
+
+	// 3 values per key
+	std::vector< glmd::uint16 > translationKeys_;
+	std::vector< glmd::uint16 > rotationKeys_;
+	std::vector< glmd::uint16 > scalingKeys_;
+
+	// The times of the frames used by frame clamping
+	std::vector< glmd::float32 > frameTimes_;
+
+	/**
+	 * Returns the time to sample at, once frame clamping is applied.
+	 */
+	glmd::float32 clampToFrames(glmd::float32 animationTime, glmd::uint32 startFrame, glmd::uint32 endFrame) const;
+
+	/**
+	 * Calculates the transformation of a track, at a time that has already been clamped.
+	 */
+	void sampleTrack(glm::mat4& transformation, glmd::uint32 track, glmd::float32 animationTime) const;
+	void sampleTrack(glmd::uint32 track, glmd::float32 animationTime, glm::vec3& translation, glm::quat& rotation, glm::vec3& scaling) const;
+};
+
+}
+}
+
+#endif /* SAMPLEDANIMATIONTRACKS_H_ */
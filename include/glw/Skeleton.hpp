@@ -0,0 +1,187 @@
+#ifndef SKELETON_H_
+#define SKELETON_H_
+
+#include <string>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "BoneNode.hpp"
+#include "BoneData.hpp"
+
+namespace glr
+{
+namespace glw
+{
+
+namespace glmd = glm::detail;
+
+/**
+ * The bones of a mesh (its BoneData), resolved against the nodes of a Skeleton.
+ *
+ * Entry i says that the bone transformation at boneIndices[i] is calculated from the global transformation of skeleton node
+ * nodeIndices[i], using the bone offset boneOffsets[i].  Entries are in skeleton order.
+ */
+struct SkeletonBones
+{
+	// The number of bone transformations of the mesh (the size of BoneData::boneTransform)
+	glmd::uint32 numberOfBones;
+
+	std::vector< glmd::uint32 > nodeIndices;
+	std::vector< glmd::uint32 > boneIndices;
+	std::vector< glm::mat4 > boneOffsets;
+};
+
+/**
+ * A bone palette shared by all of the meshes of a model - a pose is calculated into the palette once, rather than once for each mesh.
+ *
+ * The palette is laid out like the bones of the mesh with the most bones, so that mesh (and every other mesh with the same bones in the
+ * same order) uses the first numberOfSharedBones slots of the palette as is.  Other meshes have a remap table - bone i of the mesh is
+ * slot remaps[mesh][i] of the palette.  Bones that only those meshes have (or that have a different bone offset) get slots after the
+ * shared ones.
+ */
+struct SkeletonPalette
+{
+	// The bones of the palette - the bone indices are palette slots
+	SkeletonBones bones;
+	glmd::uint32 numberOfSharedBones;
+
+	// Empty for the meshes that use the palette as is
+	std::vector< std::vector< glmd::uint32 > > remaps;
+};
+
+/**
+ * The transformation of each node of a skeleton relative to its parent (a local space pose), as separate translations, rotations and
+ * scalings - stored as structures of arrays, so that poses can be sampled and blended a component at a time.
+ */
+struct SkeletonPose
+{
+	// Translations
+	std::vector< glmd::float32 > tx;
+	std::vector< glmd::float32 > ty;
+	std::vector< glmd::float32 > tz;
+	
+	// Rotations (unit quaternions)
+	std::vector< glmd::float32 > rx;
+	std::vector< glmd::float32 > ry;
+	std::vector< glmd::float32 > rz;
+	std::vector< glmd::float32 > rw;
+	
+	// Scalings
+	std::vector< glmd::float32 > sx;
+	std::vector< glmd::float32 > sy;
+	std::vector< glmd::float32 > sz;
+	
+	glmd::uint32 getNumberOfNodes() const;
+	void resize(glmd::uint32 numberOfNodes);
+	
+	void setTransformation(glmd::uint32 node, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scaling);
+	
+	/**
+	 * Returns translation * rotation * scaling for the given node.
+	 */
+	glm::mat4 getTransformation(glmd::uint32 node) const;
+};
+
+/**
+ * A BoneNode tree, flattened into arrays in topological order - every node comes after its parent, so a pose can be calculated with a
+ * single pass over the nodes, rather than by walking the tree.
+ *
+ * Compiling a skeleton (and resolving names against it) is done when a model is loaded - calculating a pose never touches a node name.
+ *
+ * Each skeleton has an id, which identifies its contents - copies of a skeleton share its id.  Animations use the id to cache which of
+ * their tracks animate which nodes.
+ */
+class Skeleton
+{
+public:
+	/**
+	 * Creates an empty skeleton.
+	 */
+	Skeleton();
+	Skeleton(const BoneNode& rootBoneNode);
+
+	glmd::uint32 getId() const;
+	glmd::uint32 getNumberOfNodes() const;
+
+	/**
+	 * Returns the index of the parent of each node (-1 for the root node).
+	 */
+	const std::vector< glmd::int32 >& getParents() const;
+
+	/**
+	 * Returns the transformation of each node, relative to its parent.
+	 */
+	const std::vector< glm::mat4 >& getTransformations() const;
+
+	const std::vector< std::string >& getNames() const;
+	
+	/**
+	 * Returns the transformation of each node, relative to its parent, split into translations, rotations and scalings (node
+	 * transformations are assumed to have no shear).
+	 */
+	const SkeletonPose& getBindPose() const;
+
+	/**
+	 * Returns the index of the first node with the given name, or -1 if there is no such node.
+	 */
+	glmd::int32 findNode(const std::string& name) const;
+
+	/**
+	 * Resolves the bones in boneData against the nodes of this skeleton.  Bones that don't name a node are left out (their transformations
+	 * are never calculated).
+	 */
+	SkeletonBones bindBones(const BoneData& boneData) const;
+	
+	/**
+	 * Calculates the transformation of every node, relative to rootParentTransformation, from a local space pose.
+	 * 
+	 * @param globalTransformations Receives the transformations - must hold at least getNumberOfNodes() transformations.
+	 * @param pose The transformation of each node, relative to its parent.
+	 * @param rootParentTransformation The transformation the root node is relative to (see
+	 * AnimationTracks::calculateGlobalTransformations()).
+	 */
+	void calculateGlobalTransformations(std::vector< glm::mat4 >& globalTransformations, const SkeletonPose& pose, const glm::mat4& rootParentTransformation = glm::mat4(1.0f)) const;
+
+	/**
+	 * Calculates the bone transformations of a mesh, from the global transformations of the skeleton's nodes.
+	 *
+	 * @param transformations Receives the bone transformations - must hold at least bones.numberOfBones transformations.  Bones that
+	 * don't name a node are left untouched.
+	 * @param globalTransformations The transformation of each node, relative to the model (see
+	 * AnimationTracks::calculateGlobalTransformations()).
+	 * @param bones The bones of the mesh.
+	 */
+	static void calculateBoneTransformations(std::vector< glm::mat4 >& transformations, const std::vector< glm::mat4 >& globalTransformations, const SkeletonBones& bones);
+
+	/**
+	 * Creates a bone palette for meshes with the given bones (all bound to the same skeleton).
+	 */
+	static SkeletonPalette createPalette(const std::vector< SkeletonBones >& meshBones);
+
+	/**
+	 * Gathers the bone transformations of a mesh from a palette, using the mesh's remap table.
+	 *
+	 * @param transformations Receives the bone transformations - must hold at least remap.size() transformations.
+	 * @param paletteTransformations The bone transformations of the palette.
+	 * @param remap The remap table of the mesh (see SkeletonPalette).
+	 */
+	static void remapBoneTransformations(std::vector< glm::mat4 >& transformations, const std::vector< glm::mat4 >& paletteTransformations, const std::vector< glmd::uint32 >& remap);
+
+private:
+	glmd::uint32 id_;
+
+	std::vector< glmd::int32 > parents_;
+	std::vector< glm::mat4 > transformations_;
+	std::vector< std::string > names_;
+	SkeletonPose bindPose_;
+
+	static glmd::uint32 generateId();
+};
+
+}
+}
+
+#endif /* SKELETON_H_ */
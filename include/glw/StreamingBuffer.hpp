@@ -0,0 +1,114 @@
+#ifndef STREAMINGBUFFER_H_
+#define STREAMINGBUFFER_H_
+
+#include <vector>
+
+#include <GL/glew.h>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace glr
+{
+namespace glw
+{
+
+namespace glmd = glm::detail;
+
+class IOpenGlDevice;
+
+/**
+ * A range of a buffer object that data has been streamed into.
+ */
+struct StreamingBufferRange
+{
+	GLuint bufferId;
+	GLintptr offset;
+	GLsizeiptr size;
+
+	StreamingBufferRange() : bufferId(0), offset(0), size(0)
+	{
+	}
+};
+
+/**
+ * A buffer object for data that changes every frame (bone palettes, light arrays, etc).
+ *
+ * The buffer is split into a ring of regions (3 by default - one being written by the CPU, and up to two still being read by the GPU).
+ * Data is suballocated linearly from the current region; once a region is full (or the frame ends), a fence is placed after the
+ * commands that read it, and we move on to the next region.  A region is only written to again once its fence has been signaled, so
+ * data is never overwritten while a draw call may still be using it - and no draw call has to wait for a write.
+ *
+ * If ARB_buffer_storage is available, the buffer is persistently (and coherently) mapped, so streaming data is just a memcpy.  Otherwise
+ * each range is mapped unsynchronized, and if the next region is still in use by the GPU the buffer is orphaned rather than waited on.
+ *
+ * **Not Thread Safe**: This class should only be used from the OpenGL thread.
+ */
+class StreamingBuffer
+{
+public:
+	/**
+	 * @param openGlDevice
+	 * @param target The buffer target the ranges will be bound to (i.e. GL_UNIFORM_BUFFER).  Ranges are aligned to the offset alignment
+	 * this target requires.
+	 * @param regionSize The size of each region, in bytes.  This is the most data that can be streamed in a single call.
+	 * @param numberOfRegions
+	 */
+	StreamingBuffer(IOpenGlDevice* openGlDevice, GLenum target, glmd::uint32 regionSize, glmd::uint32 numberOfRegions = 3);
+	~StreamingBuffer();
+
+	/**
+	 * Copies size bytes of data into the next free range of the buffer.
+	 *
+	 * Will throw an InvalidArgumentException if the range doesn't fit in a region, and a GlException if the data couldn't be written.
+	 *
+	 * @param data The data to copy.  May be nullptr if size is 0.
+	 * @param size The number of bytes to copy.
+	 * @param rangeSize The size of the range to allocate, if it should be larger than size (i.e. if the shader block is larger than the
+	 * data).  The bytes past size are left undefined.
+	 *
+	 * @return The range the data was copied into.
+	 */
+	StreamingBufferRange stream(const void* data, glmd::uint32 size, glmd::uint32 rangeSize = 0);
+
+	/**
+	 * Marks the end of a frame - the data streamed so far is fenced, and the next call to stream will start in the next region.
+	 *
+	 * Should be called once all of the draw calls using the data have been issued.
+	 */
+	void endFrame();
+
+	GLuint getBufferId() const;
+	glmd::uint32 getRegionSize() const;
+	glmd::uint32 getNumberOfRegions() const;
+
+	/**
+	 * Returns true if the buffer is persistently mapped (i.e. ARB_buffer_storage is available).
+	 */
+	bool isPersistentlyMapped() const;
+
+private:
+	IOpenGlDevice* openGlDevice_;
+	GLenum target_;
+	GLuint bufferId_;
+	glmd::uint32 regionSize_;
+	glmd::uint32 numberOfRegions_;
+	glmd::uint32 alignment_;
+
+	glmd::uint32 currentRegion_;
+	glmd::uint32 currentOffset_;
+	std::vector< GLsync > fences_;
+
+	// Only set if the buffer is persistently mapped
+	glmd::uint8* data_;
+
+	void nextRegion();
+	void waitForFence(GLsync fence);
+	void orphan();
+	void deleteFences();
+};
+
+}
+}
+
+#endif /* STREAMINGBUFFER_H_ */
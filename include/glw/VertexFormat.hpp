@@ -0,0 +1,171 @@
+#ifndef VERTEXFORMAT_H_
+#define VERTEXFORMAT_H_
+
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include "VertexBoneData.hpp"
+
+namespace glr
+{
+namespace glw
+{
+
+namespace glmd = glm::detail;
+
+/**
+ * The attribute locations Mesh writes its data to (these match the reserved vertex attribute locations in shaders/IShader.hpp).
+ */
+enum VertexAttributeLocation
+{
+	VERTEX_ATTRIBUTE_LOCATION_POSITION = 0,
+	VERTEX_ATTRIBUTE_LOCATION_TEXTURE = 1,
+	VERTEX_ATTRIBUTE_LOCATION_NORMAL = 2,
+	VERTEX_ATTRIBUTE_LOCATION_COLOR = 3,
+	VERTEX_ATTRIBUTE_LOCATION_BONE_IDS = 4,
+	VERTEX_ATTRIBUTE_LOCATION_BONE_WEIGHTS = 5,
+	// The model matrix of each instance, for instanced draws (a mat4 - uses this location and the next 3)
+	VERTEX_ATTRIBUTE_LOCATION_INSTANCE_MODEL_MATRIX = 6
+};
+
+/**
+ * How the components of a vertex attribute are stored in the vertex buffer.  Every attribute is padded to a multiple of 4 bytes.
+ */
+enum VertexAttributeType
+{
+	VERTEX_ATTRIBUTE_TYPE_FLOAT32 = 0,
+	// 16 bit floats - about 3 significant digits
+	VERTEX_ATTRIBUTE_TYPE_HALF_FLOAT,
+	// x, y and z as signed normalized 10 bit integers, and w as a signed 2 bit integer, in 4 bytes (requires OpenGL 3.3)
+	VERTEX_ATTRIBUTE_TYPE_INT_2_10_10_10,
+	// Unsigned normalized bytes - values are clamped to [0, 1]
+	VERTEX_ATTRIBUTE_TYPE_UNORM8,
+	// Integers, read in the shader with an ivec
+	VERTEX_ATTRIBUTE_TYPE_INT32,
+	// Integers in [0, 255], read in the shader with an ivec
+	VERTEX_ATTRIBUTE_TYPE_UINT8
+};
+
+struct VertexAttribute
+{
+	glmd::uint32 location;
+	glmd::uint32 numberOfComponents;
+	VertexAttributeType type;
+
+	// The offset of the attribute from the start of each vertex, in bytes
+	glmd::uint32 offset;
+};
+
+/**
+ * Describes the layout of an interleaved vertex buffer - the attributes each vertex holds, what type each attribute is stored as, and
+ * where in the vertex it is.
+ *
+ * Attributes are laid out in the order they are added.  The write methods convert float32 (or int32) data to the attribute's type, and
+ * copy it into an interleaved buffer; data for a location the format doesn't have is ignored.
+ */
+class VertexFormat
+{
+public:
+	static const glmd::uint32 ALL_VERTICES = 0xFFFFFFFF;
+
+	VertexFormat();
+
+	/**
+	 * Appends an attribute to the end of each vertex.
+	 *
+	 * @param location The shader attribute location.
+	 * @param numberOfComponents The number of components (1 to 4).  Attributes of type VERTEX_ATTRIBUTE_TYPE_INT_2_10_10_10 must have 3
+	 * or 4.
+	 * @param type
+	 */
+	void addAttribute(glmd::uint32 location, glmd::uint32 numberOfComponents, VertexAttributeType type);
+
+	/**
+	 * Returns the attribute at the given location, or nullptr if this format doesn't have one.
+	 */
+	const VertexAttribute* getAttribute(glmd::uint32 location) const;
+	const std::vector< VertexAttribute >& getAttributes() const;
+
+	/**
+	 * Returns the size of a vertex, in bytes.
+	 */
+	glmd::uint32 getStride() const;
+
+	/**
+	 * Returns true if this format has both bone attributes (VERTEX_ATTRIBUTE_LOCATION_BONE_IDS and VERTEX_ATTRIBUTE_LOCATION_BONE_WEIGHTS).
+	 */
+	bool isSkinned() const;
+
+	/**
+	 * Enables each attribute, and points it at its offset in the buffer currently bound to GL_ARRAY_BUFFER.
+	 *
+	 * **Not Thread Safe**: This method should only be called from the OpenGL thread, with the vertex array object bound.
+	 */
+	void setVertexAttributePointers() const;
+
+	/**
+	 * Writes values to the attribute at location, in the interleaved buffer vertices (value i goes to vertex i).  Only vertices that fit in
+	 * vertices are written.
+	 *
+	 * A range of vertices can be given, so that a large buffer can be filled a block at a time - writing every attribute of a block
+	 * before moving on to the next keeps the block in cache.
+	 *
+	 * @param firstVertex The first vertex to write.
+	 * @param numberOfVertices The maximum number of vertices to write.
+	 */
+	void write(glmd::uint32 location, const std::vector< glm::vec2 >& values, std::vector< glmd::uint8 >& vertices, glmd::uint32 firstVertex = 0, glmd::uint32 numberOfVertices = ALL_VERTICES) const;
+	void write(glmd::uint32 location, const std::vector< glm::vec3 >& values, std::vector< glmd::uint8 >& vertices, glmd::uint32 firstVertex = 0, glmd::uint32 numberOfVertices = ALL_VERTICES) const;
+	void write(glmd::uint32 location, const std::vector< glm::vec4 >& values, std::vector< glmd::uint8 >& vertices, glmd::uint32 firstVertex = 0, glmd::uint32 numberOfVertices = ALL_VERTICES) const;
+
+	/**
+	 * Writes the bone ids to the attribute at boneIdsLocation, and the weights to the attribute at boneWeightsLocation.
+	 *
+	 * Will throw an InvalidArgumentException if a bone id doesn't fit in a VERTEX_ATTRIBUTE_TYPE_UINT8 attribute.
+	 */
+	void write(glmd::uint32 boneIdsLocation, glmd::uint32 boneWeightsLocation, const std::vector< VertexBoneData >& values, std::vector< glmd::uint8 >& vertices,
+		glmd::uint32 firstVertex = 0, glmd::uint32 numberOfVertices = ALL_VERTICES) const;
+
+private:
+	std::vector< VertexAttribute > attributes_;
+	glmd::uint32 stride_;
+};
+
+/**
+ * Returns the layout Mesh uses by default - every attribute at full precision (80 bytes per vertex, or 48 bytes without the bone
+ * attributes).
+ *
+ * @param skinned If false, the format has no bone attributes - for meshes that have no bone data.
+ */
+VertexFormat createDefaultVertexFormat(bool skinned = true);
+
+/**
+ * Returns a compact layout (44 bytes per vertex, or 24 bytes without the bone attributes) - half float texture coordinates, 10:10:10:2
+ * normals, unorm8 colors and uint8 bone ids.  Positions and bone weights are kept at full precision.
+ *
+ * @param skinned If false, the format has no bone attributes - for meshes that have no bone data.
+ */
+VertexFormat createPackedVertexFormat(bool skinned = true);
+
+/**
+ * Converts value to a 16 bit float (rounding to the nearest representable value).  Values too large for a half float become infinity.
+ */
+glmd::uint16 packHalfFloat(glmd::float32 value);
+glmd::float32 unpackHalfFloat(glmd::uint16 value);
+
+/**
+ * Packs value into the layout of GL_INT_2_10_10_10_REV - x in the lowest 10 bits, then y, z, and w in the highest 2 bits.  x, y and z
+ * are clamped to [-1, 1] and w is rounded to -1, 0 or 1.
+ */
+glmd::uint32 packInt2_10_10_10(const glm::vec4& value);
+
+/**
+ * Converts value (clamped to [0, 1]) to an unsigned normalized byte.
+ */
+glmd::uint8 packUnorm8(glmd::float32 value);
+
+}
+}
+
+#endif /* VERTEXFORMAT_H_ */
@@ -12,6 +12,7 @@
 #include "../IOpenGlDevice.hpp"
 
 #include "GlslShader.hpp"
+#include "UniformLocationCache.hpp"
 
 namespace glr
 {
@@ -37,6 +38,16 @@ public:
 	
 	virtual GLint getVertexAttributeLocationByName(const std::string& varName) const;
 	
+	virtual UniformHandle getUniformHandle(const std::string& varName) const;
+	
+	virtual void setUniform(UniformHandle handle, glmd::int32 value);
+	virtual void setUniform(UniformHandle handle, glmd::float32 value);
+	virtual void setUniform(UniformHandle handle, const glm::vec2& value);
+	virtual void setUniform(UniformHandle handle, const glm::vec3& value);
+	virtual void setUniform(UniformHandle handle, const glm::vec4& value);
+	virtual void setUniform(UniformHandle handle, const glm::mat3& value);
+	virtual void setUniform(UniformHandle handle, const glm::mat4& value);
+	
 	const std::string& getName() const;
 	
 	virtual void addBindListener(IShaderProgramBindListener* bindListener);
@@ -54,10 +65,17 @@ private:
 	glw::IOpenGlDevice* openGlDevice_;
 
 	IShader::BindingsMap bindings_;
+	// The uniform block index of each binding (GL_INVALID_INDEX for location bindings, and for blocks that aren't active)
+	std::vector< GLuint > uniformBlockIndices_;
+	// The bind point each uniform block was last bound to (-1 if it hasn't been bound yet)
+	std::vector< GLint > uniformBlockBindPoints_;
+	
+	UniformLocationCache uniformLocationCache_;
 	
 	std::vector<IShaderProgramBindListener*> bindListeners_;
 	
 	void generateBindings();
+	void cacheUniformLocations();
 };
 
 }
@@ -27,9 +27,17 @@ const static std::vector< std::pair< std::string, glmd::uint32> > reservedVertex
 	std::pair< std::string, glmd::uint32>( std::string("in_Normal"), 		2),
 	std::pair< std::string, glmd::uint32>( std::string("in_Color"), 		3),
 	std::pair< std::string, glmd::uint32>( std::string("in_BoneIds"), 		4),
-	std::pair< std::string, glmd::uint32>( std::string("in_BoneWeights"), 	5)
+	std::pair< std::string, glmd::uint32>( std::string("in_BoneWeights"), 	5),
+	std::pair< std::string, glmd::uint32>( std::string("in_InstanceModelMatrix"), 	6)
 };
 
+// Names of the uniforms glr sets on every shader program that uses them
+const static std::string UNIFORM_PROJECTION_MATRIX = std::string("projectionMatrix");
+const static std::string UNIFORM_VIEW_MATRIX = std::string("viewMatrix");
+const static std::string UNIFORM_MODEL_MATRIX = std::string("modelMatrix");
+const static std::string UNIFORM_PVM_MATRIX = std::string("pvmMatrix");
+const static std::string UNIFORM_NORMAL_MATRIX = std::string("normalMatrix");
+
 class IShader
 {
 public:
@@ -18,6 +18,12 @@ namespace glmd = glm::detail;
 
 // Forward declaration due to circular dependency IShaderProgramBindListener
 class IShaderProgramBindListener;
+
+/**
+ * A handle to a uniform variable of a shader program, as returned by IShaderProgram::getUniformHandle.  A handle of -1 refers to a uniform
+ * that isn't active in the shader program - setting it does nothing.
+ */
+typedef GLint UniformHandle;
 	
 class IShaderProgram
 {
@@ -90,6 +96,27 @@ public:
 	 */
 	virtual GLint getVertexAttributeLocationByName(const std::string& varName) const = 0;
 	
+	/**
+	 * Get a handle to the uniform variable with the given name.  The uniforms of a shader program are looked up once, when it is linked,
+	 * so this doesn't call into OpenGL.
+	 * 
+	 * If no active uniform exists with name varName, -1 is returned.
+	 */
+	virtual UniformHandle getUniformHandle(const std::string& varName) const = 0;
+	
+	/**
+	 * Sets the value of the uniform variable with the given handle.  The shader program must be bound.
+	 * 
+	 * **Not Thread Safe**: These methods should only be called from the OpenGL thread.
+	 */
+	virtual void setUniform(UniformHandle handle, glmd::int32 value) = 0;
+	virtual void setUniform(UniformHandle handle, glmd::float32 value) = 0;
+	virtual void setUniform(UniformHandle handle, const glm::vec2& value) = 0;
+	virtual void setUniform(UniformHandle handle, const glm::vec3& value) = 0;
+	virtual void setUniform(UniformHandle handle, const glm::vec4& value) = 0;
+	virtual void setUniform(UniformHandle handle, const glm::mat3& value) = 0;
+	virtual void setUniform(UniformHandle handle, const glm::mat4& value) = 0;
+	
 	/**
 	 * Add a listener, which will be notified when this shader gets bound.
 	 * 
@@ -0,0 +1,58 @@
+#ifndef UNIFORMLOCATIONCACHE_H_
+#define UNIFORMLOCATIONCACHE_H_
+
+#include <string>
+#include <unordered_map>
+
+#include <GL/glew.h>
+
+namespace glr
+{
+namespace shaders
+{
+
+/**
+ * Holds the locations of the active uniforms, and the indices of the active uniform blocks, of a linked shader program - so that they
+ * can be looked up without asking the OpenGL driver.
+ */
+class UniformLocationCache
+{
+public:
+	UniformLocationCache();
+
+	void clear();
+
+	/**
+	 * Adds an active uniform, with the name OpenGL reports for it.  Arrays are reported as 'name[0]' - they can be looked up either with
+	 * or without the '[0]'.
+	 */
+	void addUniform(const std::string& name, GLint location);
+	void addUniformBlock(const std::string& name, GLuint index);
+
+	/**
+	 * Returns the location of the uniform with the given name, or -1 if the shader program has no active uniform with that name.
+	 */
+	GLint getUniformLocation(const std::string& name) const;
+
+	/**
+	 * Returns the index of the uniform block with the given name, or GL_INVALID_INDEX if the shader program has no active uniform block
+	 * with that name.
+	 */
+	GLuint getUniformBlockIndex(const std::string& name) const;
+
+	/**
+	 * Fills the cache with the active uniforms and uniform blocks of the (linked) OpenGL shader program programId.
+	 *
+	 * **Not Thread Safe**: This method should only be called from the OpenGL thread.
+	 */
+	void load(GLuint programId);
+
+private:
+	std::unordered_map< std::string, GLint > uniformLocations_;
+	std::unordered_map< std::string, GLuint > uniformBlockIndices_;
+};
+
+}
+}
+
+#endif /* UNIFORMLOCATIONCACHE_H_ */
@@ -27,6 +27,8 @@ public:
 	virtual const std::string& getName() const;
 
 	virtual void render(shaders::IShaderProgram& shader);
+	virtual void queue(RenderQueue& renderQueue, shaders::IShaderProgram& shader, const glm::mat4& modelMatrix);
+	virtual glw::BoundingBox getBoundingBox() const;
 
 private:
 	Id id_;
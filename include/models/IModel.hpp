@@ -1,12 +1,15 @@
 #ifndef IMODEL_H_
 #define IMODEL_H_
 
+#include <memory>
+
 #include "IRenderable.hpp"
 #include "glw/shaders/IShaderProgram.hpp"
 
 #include "glw/IMesh.hpp"
 #include "glw/ITexture.hpp"
 #include "glw/IAnimation.hpp"
+#include "glw/BlendTree.hpp"
 
 #include "Id.hpp"
 
@@ -96,6 +99,26 @@ public:
 	 * @return A list of the animations associated with this model.
 	 */
 	virtual std::vector<glw::IAnimation*> getAnimations() const = 0;
+	
+	/**
+	 * Plays the given blend tree for this model, instead of a single animation (see glw::BlendTree).  The model takes ownership of the
+	 * blend tree.  Playing an animation, or stopping the animation, stops the blend tree.
+	 * 
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment.
+	 * 
+	 * @param blendTree
+	 */
+	virtual void playBlendTree(std::unique_ptr<glw::BlendTree> blendTree) = 0;
+	
+	/**
+	 * Returns the blend tree playing for this model - its weights and clip times can be changed through it.
+	 * 
+	 * **Not Thread Safe**: The blend tree should only be changed between updates of the animation manager (see
+	 * glw::IAnimationManager::update()), and not while the model is being rendered.
+	 * 
+	 * @return A pointer to the blend tree playing for this model, or nullptr if there is no blend tree playing.
+	 */
+	virtual glw::BlendTree* getBlendTree() const = 0;
 };
 
 }
@@ -2,6 +2,10 @@
 #define IMODELMANAGER_H_
 
 #include <string>
+#include <future>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
 
 #include "Id.hpp"
 
@@ -66,6 +70,53 @@ public:
 	 */
 	virtual void loadModel(const std::string& name, const std::string& filename, bool initialize = true) = 0;
 	
+	/**
+	 * Loads the model from the given filename in the background, and gives it an alias 'name'.
+	 * 
+	 * The file is imported (and the images of its textures decoded) on worker threads.  The meshes, textures, materials and animations
+	 * are then created and pushed to video memory on the OpenGL thread by update(), a mesh at a time.
+	 * 
+	 * The model template is created straight away - until the load completes, it (and any instances created from it) renders the
+	 * placeholder model (see setPlaceholderModel()).  When the load completes, the template and its instances are given the loaded
+	 * model.
+	 * 
+	 * If a model with this name already exists (or is already being loaded), no new load is started.
+	 * 
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment.
+	 * 
+	 * @param name
+	 * @param filename
+	 * 
+	 * @return A future that becomes ready (holding the model template) once the model has been loaded, or that holds the exception that
+	 * was thrown if the model couldn't be loaded.
+	 */
+	virtual std::shared_future<IModel*> loadModelAsync(const std::string& name, const std::string& filename) = 0;
+	
+	/**
+	 * Sets the model template that models being loaded asynchronously render until their load completes.  If name is empty (the
+	 * default), they render nothing.
+	 * 
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment.
+	 */
+	virtual void setPlaceholderModel(const std::string& name) = 0;
+	
+	/**
+	 * Does the OpenGL work for the models being loaded asynchronously - creating their resources and pushing them to video memory - until
+	 * timeBudget milliseconds have passed.  At least one step of work is done every call, so loading always makes progress.
+	 * 
+	 * **Not Thread Safe**: This method should only be called from the OpenGL thread.
+	 * 
+	 * @param timeBudget The time (in milliseconds) to spend each call.
+	 */
+	virtual void update(glm::detail::float32 timeBudget = 2.0f) = 0;
+	
+	/**
+	 * Returns the number of models that are being loaded asynchronously.
+	 * 
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment.
+	 */
+	virtual glm::detail::uint32 getNumberOfModelsLoading() const = 0;
+	
 	/**
 	 * Destroys the template of the IModel object with id 'id'.  Any pointers or references to this model will
 	 * become defunct.
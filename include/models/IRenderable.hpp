@@ -1,10 +1,17 @@
 #ifndef IRENDERABLE_H_
 #define IRENDERABLE_H_
 
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
 #include "glw/shaders/IShaderProgram.hpp"
+#include "glw/BoundingBox.hpp"
 
 namespace glr
 {
+
+class RenderQueue;
+
 namespace models
 {
 
@@ -22,6 +29,21 @@ public:
 	 * @param shader The shader to use to render this object to the scene.
 	 */
 	virtual void render(shaders::IShaderProgram& shader) = 0;
+	
+	/**
+	 * Add the draw items needed to render this object to the render queue, instead of rendering it immediately.
+	 * 
+	 * @param renderQueue The render queue to add the draw items to.
+	 * @param shader The shader to use to render this object.
+	 * @param modelMatrix The transformation of this object.
+	 */
+	virtual void queue(RenderQueue& renderQueue, shaders::IShaderProgram& shader, const glm::mat4& modelMatrix) = 0;
+	
+	/**
+	 * Returns the bounding box of this object (in model space).  An empty bounding box means the bounds of the object aren't known, and
+	 * the object should never be culled.
+	 */
+	virtual glw::BoundingBox getBoundingBox() const = 0;
 };
 
 }
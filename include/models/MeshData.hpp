@@ -5,6 +5,7 @@
 #include <string>
 
 #include "glw/VertexBoneData.hpp"
+#include "glw/VertexFormat.hpp"
 
 namespace glr
 {
@@ -19,6 +20,12 @@ struct MeshData
 	std::vector< glm::vec2 > textureCoordinates;
 	std::vector< glm::vec4 > colors;
 	std::vector< glw::VertexBoneData > bones;
+	
+	// Every 3 indices make up a triangle (if empty, every 3 vertices make up a triangle)
+	std::vector< glm::detail::uint32 > indices;
+	
+	// The layout to upload the vertices with (an empty format means the mesh's default format)
+	glw::VertexFormat vertexFormat;
 };
 
 }
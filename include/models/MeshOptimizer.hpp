@@ -0,0 +1,55 @@
+#ifndef MESHOPTIMIZER_H_
+#define MESHOPTIMIZER_H_
+
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include "models/MeshData.hpp"
+
+namespace glr
+{
+namespace models
+{
+
+namespace glmd = glm::detail;
+
+/**
+ * Merges vertices that are identical in every attribute (position, normal, texture coordinates, color, and bone data), and sets the
+ * indices of data to reference the vertices that are left.  If data has no indices, every 3 consecutive vertices are taken to be a
+ * triangle.
+ */
+void weldVertices(MeshData& data);
+
+/**
+ * Reorders the triangles in indices so that they make better use of the GPU's post-transform vertex cache, using Tom Forsyth's 'Linear-Speed
+ * Vertex Cache Optimisation'.  Triangles are picked one at a time - each time, the triangle whose vertices score highest (vertices that are
+ * recently used, or are used by few remaining triangles, score high) is emitted next.
+ *
+ * @param indices The triangle list to reorder.
+ * @param numberOfVertices The number of vertices the indices reference.
+ */
+void optimizeVertexCache(std::vector< glmd::uint32 >& indices, glmd::uint32 numberOfVertices);
+
+/**
+ * Reorders the vertices of data into the order the indices first use them in, so that vertex fetches move through the vertex buffer in
+ * order.  Vertices that aren't referenced by any index are removed.
+ */
+void optimizeVertexFetch(MeshData& data);
+
+/**
+ * Welds the vertices of data, then optimizes it for the vertex cache and for vertex fetches.
+ */
+void optimizeMesh(MeshData& data);
+
+/**
+ * Returns the average cache miss ratio (ACMR) of indices - the average number of vertices that have to be transformed per triangle - for a
+ * FIFO vertex cache holding cacheSize vertices.  An unindexed mesh has an ACMR of 3; a well ordered regular grid approaches 0.5.
+ */
+glmd::float32 calculateAverageCacheMissRatio(const std::vector< glmd::uint32 >& indices, glmd::uint32 numberOfVertices, glmd::uint32 cacheSize = 16);
+
+}
+}
+
+#endif /* MESHOPTIMIZER_H_ */
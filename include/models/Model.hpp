@@ -16,12 +16,16 @@
 #include "Id.hpp"
 
 #include "glw/IOpenGlDevice.hpp"
+#include "glw/IAnimationInstance.hpp"
+#include "glw/Skeleton.hpp"
 
 #include "serialize/SplitMember.hpp"
 
 namespace glr
 {
 
+struct DrawItem;
+
 namespace glw
 {
 class IMaterialManager;
@@ -38,7 +42,7 @@ class IAnimation;
 namespace models
 {
 
-class Model : public IModel
+class Model : public IModel, public glw::IAnimationInstance
 {
 public:
 	/**
@@ -93,6 +97,14 @@ public:
 	virtual void stopAnimation();
 	virtual glw::IAnimation* getPlayingAnimation() const;
 	virtual std::vector<glw::IAnimation*> getAnimations() const;
+	virtual void playBlendTree(std::unique_ptr<glw::BlendTree> blendTree);
+	virtual glw::BlendTree* getBlendTree() const;
+	
+	/**
+	 * Advances the playing animation by timeDelta seconds, and calculates its pose.  Models add themselves to the animation manager when
+	 * they first play an animation - the animation manager calls this from IAnimationManager::update().
+	 */
+	virtual void updateAnimation(glm::detail::float32 timeDelta);
 	
 	virtual void allocateVideoMemory();
 	virtual void pushToVideoMemory();
@@ -123,6 +135,33 @@ public:
 	 */
 	virtual void render(shaders::IShaderProgram& shader);
 	
+	/**
+	 * Will add a draw item for each mesh to the render queue.
+	 * 
+	 * If an animation is playing, its pose is streamed into video memory now (and calculated, if IAnimationManager::update() hasn't
+	 * already).
+	 * 
+	 * @param renderQueue The render queue to add the draw items to.
+	 * @param shader The shader to use to render this model.
+	 * @param modelMatrix The transformation of this model.
+	 */
+	virtual void queue(RenderQueue& renderQueue, shaders::IShaderProgram& shader, const glm::mat4& modelMatrix);
+	
+	/**
+	 * Returns the bounding box of all of the meshes of this model.
+	 * 
+	 * While an animation is playing, the bounding box is empty - skinning can move vertices anywhere, so animated models are never culled.
+	 */
+	virtual glw::BoundingBox getBoundingBox() const;
+	
+	/**
+	 * Replaces the meshes, textures, materials, animations and bones of this model with those of other (this model keeps its id and
+	 * name).  Any animation that is playing is stopped.
+	 * 
+	 * Used to swap the placeholder of a model that is being loaded asynchronously for the loaded model.
+	 */
+	void replaceResources(const Model& other);
+	
 	virtual void serialize(const std::string& filename);
 	virtual void serialize(serialize::TextOutArchive& outArchive);
 
@@ -141,6 +180,11 @@ protected:
 	/* 	All meshes in this model use this bone node tree for animations.
 		Any animations that manipulate bone nodes will be manipulating bones in this bone node tree. */
 	glw::BoneNode rootBoneNode_;
+	// The bone node tree, compiled for calculating animations
+	glw::Skeleton skeleton_;
+	// The bones of all of the meshes, bound to skeleton_ - created the first time an animation is calculated after the meshes change
+	glw::SkeletonPalette bonePalette_;
+	bool isBonePaletteDirty_;
 	
 	glm::mat4 globalInverseTransformation_;
 
@@ -149,18 +193,34 @@ protected:
 	std::map< std::string, glw::IAnimation* > animations_;
 
 	// Animation specific member variables
-	std::vector<glmd::uint32> indexCache_;
 	glm::detail::float32 animationTime_;
 	// Only play frames within this range
 	glmd::uint32 startFrame_;
 	glmd::uint32 endFrame_;
 	
+	// The pose of the playing animation, calculated into the bone palette once per frame (and only recalculated when the animation, or its
+	// time, changes)
+	std::vector< glm::mat4 > boneTransformations_;
+	bool isPoseDirty_;
+	glw::StreamingBufferRange bonePaletteRange_;
+	// The track of the playing animation that animates each node of skeleton_
+	std::vector< glmd::int32 > nodeTracks_;
+	bool isNodeTracksDirty_;
+	// Scratch space for the global transformation of each node of skeleton_
+	std::vector< glm::mat4 > globalTransformations_;
+	// Whether this model has been added to the animation manager (it is removed when the model is destroyed)
+	bool isAnimationInstanceAdded_;
+	// Scratch space for the bones of meshes that don't use the bone palette as is
+	std::vector< glm::mat4 > meshBoneTransformations_;
+	
 	std::atomic<bool> isLocalDataLoaded_;
 	
 	mutable std::mutex accessMutex_;
 	
 	glw::IAnimation* currentAnimation_;
 	glw::IAnimation* emptyAnimation_;
+	// Played instead of currentAnimation_, if set
+	std::unique_ptr<glw::BlendTree> blendTree_;
 
 	glw::IMeshManager* meshManager_;
 	glw::IMaterialManager* materialManager_;
@@ -190,6 +250,58 @@ private:
 	
 	void copy(const Model& other);
 	
+	/**
+	 * Compiles rootBoneNode_ into skeleton_ - call whenever rootBoneNode_ changes.
+	 */
+	void compileSkeleton();
+	
+	/**
+	 * Adds this model to the animation manager, if it hasn't been added already.
+	 * 
+	 * **Not Thread Safe**: accessMutex_ must be locked.
+	 */
+	void addAnimationInstance();
+	
+	/**
+	 * Returns true if an animation or a blend tree is playing.
+	 * 
+	 * **Not Thread Safe**: accessMutex_ must be locked.
+	 */
+	bool isAnimationPlaying() const;
+	
+	/**
+	 * Calculates the pose of the playing animation (or blend tree) into the bone palette, if it has changed.
+	 * 
+	 * **Not Thread Safe**: accessMutex_ must be locked, and an animation (or blend tree) must be playing.
+	 */
+	void calculatePose();
+	
+	/**
+	 * Calculates the pose of the playing animation (if the animation manager hasn't already), and streams the bone palette into video
+	 * memory.  Called once per render, before any of the meshes.
+	 * 
+	 * **Not Thread Safe**: accessMutex_ must be locked, and an animation must be playing.
+	 */
+	void updateBonePalette();
+	
+	/**
+	 * Returns the range of video memory holding the bones of the mesh at index - the bone palette itself, or the mesh's bones gathered
+	 * from the palette with its remap table.
+	 * 
+	 * **Not Thread Safe**: accessMutex_ must be locked, and updateBonePalette() must have been called.
+	 */
+	glw::StreamingBufferRange getBonesRange(glmd::uint32 index);
+	
+	glw::StreamingBufferRange streamBones(const std::vector< glm::mat4 >& transformations, glmd::uint32 numberOfBones);
+	
+	/**
+	 * Sets the bones of item (for the mesh at index) - the bone palette, which has already been added to renderQueue at firstSharedBone,
+	 * or the mesh's bones gathered from the palette with its remap table (which are added to renderQueue).
+	 * 
+	 * **Not Thread Safe**: accessMutex_ must be locked, and calculatePose() must have been called.
+	 */
+	void queueBones(RenderQueue& renderQueue, DrawItem& item, glmd::uint32 index, glmd::uint32 firstSharedBone);
+	
 	friend class boost::serialization::access;
 	
 	//template<class Archive> void serialize(Archive& ar, const unsigned int version);
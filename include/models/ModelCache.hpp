@@ -0,0 +1,147 @@
+#ifndef MODELCACHE_H_
+#define MODELCACHE_H_
+
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include "models/ModelData.hpp"
+#include "models/AnimationSet.hpp"
+
+namespace glmd = glm::detail;
+
+namespace glr
+{
+namespace models
+{
+
+/**
+ * The on-disk layout of a model cache file - the model data and animations that ModelLoader imports with Assimp, stored so that they
+ * can be read back without going through Assimp again:
+ *
+ *   ModelCacheFileHeader
+ *   ModelData                      (one per mesh - its mesh streams, material, texture reference and bone data)
+ *   AnimationSet                   (the BoneNode hierarchy, in depth first order, and the tracks of each animation)
+ *
+ * Every array (vertex streams, indices, animation keys, strings, ...) is stored as a ModelCacheArrayHeader followed by its elements,
+ * exactly as they are laid out in memory, starting on a 16 byte boundary.  Reading an array is a single copy out of the (memory mapped)
+ * file - there is no per element parsing.
+ *
+ * All values are stored in the byte order of the machine that wrote them (little endian on every platform we support).
+ */
+namespace model_cache
+{
+
+static const glmd::uint32 FILE_MAGIC = 0x4D524C47;		// 'GLRM'
+// Bump this whenever the layout changes, or the data ModelLoader imports changes (i.e. different Assimp post processing) - cache files
+// from older versions are then ignored, and the models are imported again
+static const glmd::uint32 VERSION = 1;
+static const glmd::uint32 ALIGNMENT = 16;
+
+}
+
+struct ModelCacheFileHeader
+{
+	glmd::uint32 magic;
+	glmd::uint32 version;
+	// The hash of the model file the cache was created from (see model_cache::calculateSourceHash())
+	glmd::uint64 sourceHash;
+	// The size of the whole file, in bytes
+	glmd::uint64 size;
+	glmd::uint32 numberOfMeshes;
+	glmd::uint32 reserved;
+};
+
+struct ModelCacheArrayHeader
+{
+	glmd::uint32 numberOfElements;
+	// The size of each element, in bytes (checked against the type being read)
+	glmd::uint32 elementSize;
+	glmd::uint32 reserved[2];
+};
+
+static_assert(sizeof(ModelCacheFileHeader) == 32, "Unexpected model cache file header size.");
+static_assert(sizeof(ModelCacheArrayHeader) == 16, "Unexpected model cache array header size.");
+
+namespace model_cache
+{
+
+/**
+ * Returns the (64 bit) FNV-1a hash of the given data, continuing from hash.
+ */
+glmd::uint64 calculateHash(const glmd::uint8* data, glmd::uint64 size, glmd::uint64 hash = 14695981039346656037ull);
+
+/**
+ * Returns the hash that a model's cache file is keyed by - the hash of the model file's contents, the name the model is loaded with (the
+ * names of its meshes, materials and animations are derived from it), and VERSION.
+ *
+ * The material libraries an .obj file imports ('mtllib') are hashed as well.  Other files a model imports (i.e. external files of other
+ * formats) are not - delete the model's cache file after editing them.  Textures are not part of the cache (only their filenames are),
+ * so editing them doesn't matter.
+ *
+ * Throws an exception::IoException if the model file can't be read.
+ */
+glmd::uint64 calculateSourceHash(const std::string& name, const std::string& filename);
+
+/**
+ * Writes the model data and animation set into data, in the model cache layout.
+ */
+void write(glmd::uint64 sourceHash, const std::vector< ModelData >& modelData, const AnimationSet& animationSet, std::vector<glmd::uint8>& data);
+
+/**
+ * Reads the model data and animation set from data, which is in the model cache layout.
+ *
+ * @return True if successful; false if data is not a model cache (or is from another version), was created from a different source,
+ * or is truncated.
+ */
+bool read(const glmd::uint8* data, glmd::uint64 size, glmd::uint64 sourceHash, std::vector< ModelData >& modelData, AnimationSet& animationSet);
+
+}
+
+/**
+ * A directory of model cache files, named after the source hash of the model they were created from - editing a model file gives it a
+ * new cache file, rather than using a stale one.
+ *
+ * **Thread Safe**: This class has no mutable state - models may be loaded from (and saved to) the cache from multiple threads at the
+ * same time.
+ */
+class ModelCache
+{
+public:
+	/**
+	 * @param directory The directory the cache files are kept in (a trailing separator is added if it is missing).  It must already
+	 * exist.
+	 */
+	ModelCache(std::string directory);
+
+	const std::string& getDirectory() const;
+
+	std::string getCacheFilename(glmd::uint64 sourceHash) const;
+
+	/**
+	 * Reads the cache file for the given source hash, if there is one.
+	 *
+	 * @return True if the model was read from the cache; false if there is no cache file for it, or the cache file is invalid.
+	 */
+	bool load(glmd::uint64 sourceHash, std::vector< ModelData >& modelData, AnimationSet& animationSet) const;
+
+	/**
+	 * Writes the cache file for the given source hash.  The file is written under a temporary name first, and then renamed - so a
+	 * partially written cache file is never read.
+	 *
+	 * Throws an exception::IoException if the file can't be written.
+	 */
+	void save(glmd::uint64 sourceHash, const std::vector< ModelData >& modelData, const AnimationSet& animationSet) const;
+
+private:
+	std::string directory_;
+};
+
+}
+}
+
+#endif /* MODELCACHE_H_ */
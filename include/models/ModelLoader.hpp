@@ -10,6 +10,8 @@
 
 #include "IdManager.hpp"
 
+#include "common/utilities/ImageLoader.hpp"
+
 namespace glmd = glm::detail;
 
 namespace glr
@@ -20,6 +22,9 @@ namespace glw
 class IOpenGlDevice;
 class BoneData;
 class BoneNode;
+class IMesh;
+class ITexture;
+class IMaterial;
 }
 
 namespace models
@@ -31,11 +36,17 @@ class ModelData;
 class MeshData;
 class TextureData;
 class MaterialData;
+class ModelCache;
 
 class ModelLoader
 {
 public:
-	ModelLoader(glw::IOpenGlDevice* openGlDevice);
+	/**
+	 * @param openGlDevice
+	 * @param modelCacheDirectory The directory to keep model cache files in (see models/ModelCache.hpp).  If empty, models are always
+	 * imported with Assimp.
+	 */
+	ModelLoader(glw::IOpenGlDevice* openGlDevice, const std::string& modelCacheDirectory = std::string());
 	virtual ~ModelLoader();
 
 	std::unique_ptr<Model> loadModel(const std::string& name, const std::string& filename, IdManager& idManager);
@@ -52,15 +63,56 @@ public:
 	std::unique_ptr<Model> loadModel(const std::string& filename, IdManager& idManager);
 	
 	/**
+	 * Loads the model data and animations from the file specified by filename.  This doesn't use OpenGL, so it can be called from any
+	 * thread.
 	 * 
+	 * If there is a model cache, the data is read from the model's cache file when it has one (a warm load) - otherwise the file is
+	 * imported with Assimp, and the cache file is written (a cold load).  Both are logged with the time they took.
 	 */
 	std::pair<std::vector< ModelData >, AnimationSet> loadModelData(const std::string& name, const std::string& filename);
 	
+	/**
+	 * Decodes the image of the texture in textureData (relative to the default texture directory).  This doesn't use OpenGL, so it can be
+	 * called from any thread.
+	 * 
+	 * @return The decoded image, or an empty pointer if textureData has no texture.
+	 */
+	std::unique_ptr<utilities::Image> loadImage(const TextureData& textureData);
+	
+	/**
+	 * Creates the mesh, texture and material of a single element of the model data (or finds them, if they have already been created),
+	 * and pushes them to video memory.
+	 * 
+	 * **Not Thread Safe**: This method should only be called from the OpenGL thread.
+	 * 
+	 * @param modelData
+	 * @param image The decoded image of the texture (from loadImage()).  If null, the texture is loaded from its file.
+	 * @param mesh Set to the mesh.
+	 * @param texture Set to the texture (or nullptr if the model data has no texture).
+	 * @param material Set to the material.
+	 */
+	void generateResources(const ModelData& modelData, utilities::Image* image, glw::IMesh*& mesh, glw::ITexture*& texture, glw::IMaterial*& material);
+	
+	/**
+	 * Creates the animations in animationSet, and a model made up of the given meshes, textures and materials (from generateResources()).
+	 * 
+	 * **Not Thread Safe**: This method should only be called from the OpenGL thread.
+	 */
+	std::unique_ptr<Model> generateModel(const std::string& name, std::vector<glw::IMesh*> meshes, std::vector<glw::ITexture*> textures, std::vector<glw::IMaterial*> materials, const AnimationSet& animationSet, IdManager& idManager);
+	
 private:
 	aiLogStream stream;
 	
 	glw::IOpenGlDevice* openGlDevice_;
 	
+	// Null if model caching is disabled
+	std::unique_ptr<ModelCache> modelCache_;
+	
+	/**
+	 * Imports the model data and animations from the file specified by filename with Assimp.
+	 */
+	std::pair<std::vector< ModelData >, AnimationSet> importModelData(const std::string& name, const std::string& filename);
+	
 	/**
 	 * Will initialize a model with data given through the modelData object.
 	 * 
@@ -5,6 +5,8 @@
 #include <string>
 #include <map>
 #include <mutex>
+#include <future>
+#include <functional>
 
 #include <GL/glew.h>
 
@@ -16,6 +18,13 @@
 #include "models/IModelManager.hpp"
 
 #include "IdManager.hpp"
+#include "ThreadPool.hpp"
+#include "MpscQueue.hpp"
+
+#include "models/ModelData.hpp"
+#include "models/AnimationSet.hpp"
+
+#include "common/utilities/ImageLoader.hpp"
 
 #include "serialize/SplitMember.hpp"
 
@@ -25,6 +34,9 @@ namespace glr
 namespace glw
 {
 class IOpenGlDevice;
+class IMesh;
+class ITexture;
+class IMaterial;
 }
 
 namespace models
@@ -36,13 +48,21 @@ class Model;
 class ModelManager : public IModelManager
 {
 public:
-	ModelManager(glw::IOpenGlDevice* openGlDevice);
+	/**
+	 * @param openGlDevice
+	 * @param numberOfLoaderThreads The number of worker threads used by loadModelAsync().
+	 */
+	ModelManager(glw::IOpenGlDevice* openGlDevice, glm::detail::uint32 numberOfLoaderThreads = 2);
 	virtual ~ModelManager();
 
 	virtual IModel* getModelTemplate(Id id) const;
 	virtual IModel* getModelTemplate(const std::string& name) const;
 
 	virtual void loadModel(const std::string& name, const std::string& filename, bool initialize = true);
+	virtual std::shared_future<IModel*> loadModelAsync(const std::string& name, const std::string& filename);
+	virtual void setPlaceholderModel(const std::string& name);
+	virtual void update(glm::detail::float32 timeBudget = 2.0f);
+	virtual glm::detail::uint32 getNumberOfModelsLoading() const;
 
 	virtual void destroyModelTemplate(Id id);
 	virtual void destroyModelTemplate(const std::string& name);
@@ -80,9 +100,61 @@ private:
 	
 	mutable std::recursive_mutex accessMutex_;
 	
+	// A model being loaded by loadModelAsync()
+	struct AsyncLoad
+	{
+		std::string name;
+		std::string filename;
+		
+		// The template that was created for the model (rendering the placeholder), and the instances created from it while loading
+		Id templateId;
+		std::vector< Id > instanceIds;
+		
+		// Loaded by a worker thread
+		std::vector< ModelData > modelData;
+		AnimationSet animationSet;
+		std::vector< std::unique_ptr<utilities::Image> > images;
+		
+		// Created on the OpenGL thread, a mesh at a time
+		std::vector< glw::IMesh* > meshes;
+		std::vector< glw::ITexture* > textures;
+		std::vector< glw::IMaterial* > materials;
+		
+		std::promise< IModel* > promise;
+		std::shared_future< IModel* > future;
+	};
+	
+	// Models being loaded asynchronously, by name (guarded by accessMutex_)
+	std::map< std::string, std::shared_ptr<AsyncLoad> > asyncLoads_;
+	std::string placeholderModelName_;
+	
+	// Loads are started in the order they were requested
+	glm::detail::uint64 numberOfAsyncLoadsStarted_;
+	
+	// Worker threads post work for the OpenGL thread here - it is consumed in update()
+	MpscQueue< std::function<void()> > openGlWork_;
+	
+	std::unique_ptr<ThreadPool> threadPool_;
+	
 	Model* getModel(Id id) const;
 	Model* getModel(const std::string& name) const;
 	
+	/**
+	 * Imports the model file and decodes its textures (on a worker thread), and then posts the OpenGL work for the load.
+	 */
+	void loadModelData(std::shared_ptr<AsyncLoad> load);
+	
+	/**
+	 * Creates the resources of the next mesh of the load (on the OpenGL thread).  Once every mesh has been created, the model is
+	 * created, and given to the template and its instances.
+	 */
+	void generateModel(std::shared_ptr<AsyncLoad> load);
+	
+	/**
+	 * Ends the load with the exception that is currently being handled.
+	 */
+	void failAsyncLoad(std::shared_ptr<AsyncLoad> load);
+	
 	friend class boost::serialization::access;
 	
 	template<class Archive> void serialize(Archive& ar, const unsigned int version);
@@ -0,0 +1,42 @@
+#ifndef CHUNKCOORDINATES_H_
+#define CHUNKCOORDINATES_H_
+
+#include <cstddef>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace glmd = glm::detail;
+
+namespace glr
+{
+namespace terrain
+{
+
+/**
+ * Packs the grid coordinates of a terrain chunk into a single 64 bit key (21 bits per coordinate).
+ *
+ * Coordinates must be in the range [-2^20, 2^20) - anything outside of this range will collide with another chunk.
+ */
+inline glmd::uint64 getChunkKey(glmd::int32 x, glmd::int32 y, glmd::int32 z);
+inline glmd::uint64 getChunkKey(const glm::ivec3& coordinates);
+
+/**
+ * Unpacks a key created by getChunkKey() back into grid coordinates.
+ */
+inline glm::ivec3 getChunkCoordinates(glmd::uint64 key);
+
+/**
+ * Hash function for chunk grid coordinates, so that they can be used as the key of an std::unordered_map (or std::unordered_set).
+ */
+struct ChunkCoordinatesHash
+{
+	inline std::size_t operator()(const glm::ivec3& coordinates) const;
+};
+
+}
+}
+
+#include "ChunkCoordinates.inl"
+
+#endif /* CHUNKCOORDINATES_H_ */
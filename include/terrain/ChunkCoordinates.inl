@@ -0,0 +1,44 @@
+namespace glr
+{
+namespace terrain
+{
+
+glmd::uint64 getChunkKey(glmd::int32 x, glmd::int32 y, glmd::int32 z)
+{
+	const glmd::uint64 mask = 0x1FFFFF;
+	
+	return (((glmd::uint64)x & mask) << 42) | (((glmd::uint64)y & mask) << 21) | ((glmd::uint64)z & mask);
+}
+
+glmd::uint64 getChunkKey(const glm::ivec3& coordinates)
+{
+	return getChunkKey(coordinates.x, coordinates.y, coordinates.z);
+}
+
+glm::ivec3 getChunkCoordinates(glmd::uint64 key)
+{
+	// Shift each coordinate to the top of the 64 bits and back down again, so that negative coordinates are sign extended
+	const glmd::int32 x = (glmd::int32)((glmd::int64)(key << 1) >> 43);
+	const glmd::int32 y = (glmd::int32)((glmd::int64)(key << 22) >> 43);
+	const glmd::int32 z = (glmd::int32)((glmd::int64)(key << 43) >> 43);
+	
+	return glm::ivec3(x, y, z);
+}
+
+std::size_t ChunkCoordinatesHash::operator()(const glm::ivec3& coordinates) const
+{
+	// Neighbouring chunks have keys that differ only in their low bits, so mix the key (MurmurHash3 finalizer) before it is
+	// reduced to a bucket index
+	glmd::uint64 h = getChunkKey(coordinates);
+	
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	
+	return (std::size_t)h;
+}
+
+}
+}
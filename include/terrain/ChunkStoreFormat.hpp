@@ -0,0 +1,149 @@
+#ifndef CHUNKSTOREFORMAT_H_
+#define CHUNKSTOREFORMAT_H_
+
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace glmd = glm::detail;
+
+namespace glr
+{
+namespace terrain
+{
+
+/**
+ * The on-disk layout of a chunk store file.
+ *
+ * A chunk store is an append-only file of chunk records, followed by an index:
+ *
+ *   ChunkStoreFileHeader
+ *   ChunkHeader, payload          (one record per chunk write)
+ *   ...
+ *   ChunkStoreIndexEntry[]        (the offset of the latest record for each chunk and payload type)
+ *   ChunkStoreTrailer             (where the index starts)
+ *
+ * Writing a chunk that is already in the store appends a new record - the index always points at the newest one.  New records are
+ * written over the old index, and a new index and trailer are written when the store is closed.  If the trailer is missing (i.e.
+ * the program crashed while writing), the index is rebuilt by walking the chunk headers.
+ *
+ * All values are stored in the byte order of the machine that wrote them (little endian on every platform we support).
+ */
+namespace chunk_store
+{
+
+static const glmd::uint32 FILE_MAGIC = 0x53524C47;		// 'GLRS'
+static const glmd::uint32 CHUNK_MAGIC = 0x4B4E4843;		// 'CHNK'
+static const glmd::uint32 INDEX_MAGIC = 0x58444E49;		// 'INDX'
+static const glmd::uint32 VERSION = 1;
+
+}
+
+enum ChunkPayloadType
+{
+	// The density field of the chunk (a DensityGrid)
+	CHUNK_PAYLOAD_DENSITY = 0,
+	// The mesh of the chunk (vertices, normals, texture blending values and indices)
+	CHUNK_PAYLOAD_MESH,
+	CHUNK_PAYLOAD_COUNT
+};
+
+enum ChunkCompression
+{
+	CHUNK_COMPRESSION_NONE = 0,
+	// Only available if glr was built with lz4 support (USE_LZ4)
+	CHUNK_COMPRESSION_LZ4
+};
+
+struct ChunkStoreFileHeader
+{
+	glmd::uint32 magic;
+	glmd::uint32 version;
+};
+
+struct ChunkHeader
+{
+	glmd::uint32 magic;
+	glmd::int32 gridX;
+	glmd::int32 gridY;
+	glmd::int32 gridZ;
+	glmd::uint32 payloadType;
+	glmd::uint32 levelOfDetail;
+	glmd::uint32 compression;
+	// Mesh payloads: the number of vertices, normals, texture blending values and indices
+	// Density payloads: the grid size, the low border and the high border (the last value is unused)
+	glmd::uint32 counts[4];
+	glmd::uint32 uncompressedSize;
+	glmd::uint32 storedSize;
+	// Checksum of the uncompressed payload
+	glmd::uint32 checksum;
+	glmd::uint32 reserved[2];
+};
+
+struct ChunkStoreIndexEntry
+{
+	glmd::int32 gridX;
+	glmd::int32 gridY;
+	glmd::int32 gridZ;
+	glmd::uint32 payloadType;
+	// Offset of the ChunkHeader from the start of the file
+	glmd::uint64 offset;
+};
+
+struct ChunkStoreTrailer
+{
+	glmd::uint64 indexOffset;
+	glmd::uint32 numberOfEntries;
+	glmd::uint32 magic;
+};
+
+static_assert(sizeof(ChunkStoreFileHeader) == 8, "Unexpected chunk store file header size.");
+static_assert(sizeof(ChunkHeader) == 64, "Unexpected chunk header size.");
+static_assert(sizeof(ChunkStoreIndexEntry) == 24, "Unexpected chunk store index entry size.");
+static_assert(sizeof(ChunkStoreTrailer) == 16, "Unexpected chunk store trailer size.");
+
+/**
+ * The mesh of a single chunk, as it is stored in a chunk store.
+ */
+struct ChunkMeshData
+{
+	std::vector<glm::vec3> vertices;
+	std::vector<glm::vec3> normals;
+	std::vector<glm::vec4> textureBlendingValues;
+	std::vector<glmd::uint32> indices;
+};
+
+namespace chunk_store
+{
+
+/**
+ * Returns the FNV-1a hash of the given data.
+ */
+glmd::uint32 calculateChecksum(const glmd::uint8* data, glmd::uint32 size);
+
+/**
+ * Returns true if the given compression is available in this build.
+ */
+bool isCompressionSupported(ChunkCompression compression);
+
+/**
+ * Compresses data into stored.  If the data doesn't get any smaller, it is stored uncompressed instead.
+ *
+ * @return The compression that was actually used.
+ */
+ChunkCompression compress(ChunkCompression compression, const std::vector<glmd::uint8>& data, std::vector<glmd::uint8>& stored);
+
+/**
+ * Decompresses storedSize bytes of stored into data (which must already be the uncompressed size).
+ *
+ * @return True if successful; false if the stored data is corrupt, or the compression is not supported in this build.
+ */
+bool decompress(ChunkCompression compression, const glmd::uint8* stored, glmd::uint32 storedSize, std::vector<glmd::uint8>& data);
+
+}
+
+}
+}
+
+#endif /* CHUNKSTOREFORMAT_H_ */
@@ -0,0 +1,117 @@
+#ifndef CHUNKSTOREREADER_H_
+#define CHUNKSTOREREADER_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include "MappedFile.hpp"
+
+#include "ChunkStoreFormat.hpp"
+#include "ChunkCoordinates.hpp"
+#include "TerrainSettings.hpp"
+
+namespace glr
+{
+namespace terrain
+{
+
+class DensityGrid;
+
+/**
+ * Reads chunks from a chunk store file (see ChunkStoreFormat.hpp).
+ *
+ * The file is memory mapped, and only the index is read up front - each chunk is read (and decompressed) when it is asked for.
+ *
+ * **Thread Safe**: The read methods are const, and may be called from multiple threads at the same time.  The file must not be
+ * written to while it is open in a reader.
+ */
+class ChunkStoreReader
+{
+public:
+	/**
+	 * Opens and maps the chunk store.
+	 *
+	 * Throws an exception::IoException if the file can't be opened, or an exception::FormatException if it is not a chunk store.
+	 */
+	ChunkStoreReader(const std::string& filename);
+	~ChunkStoreReader();
+
+	bool hasChunk(const glm::ivec3& coordinates, ChunkPayloadType payloadType) const;
+
+	/**
+	 * Returns the grid coordinates of every chunk in the store that has a payload of the given type.
+	 */
+	std::vector<glm::ivec3> getChunkCoordinates(ChunkPayloadType payloadType) const;
+
+	/**
+	 * Reads the header of a single chunk.
+	 *
+	 * @return True if the chunk is in the store; false otherwise.
+	 */
+	bool readHeader(const glm::ivec3& coordinates, ChunkPayloadType payloadType, ChunkHeader& header) const;
+
+	/**
+	 * Reads the mesh of a single chunk.
+	 *
+	 * Throws an exception::FormatException if the chunk is corrupt (i.e. its checksum doesn't match), or is compressed in a way this
+	 * build doesn't support.
+	 *
+	 * @return True if the chunk is in the store; false otherwise.
+	 */
+	bool readMesh(const glm::ivec3& coordinates, ChunkMeshData& mesh, LevelOfDetail* levelOfDetail = nullptr) const;
+
+	/**
+	 * Reads the density field of a single chunk.  Throws the same exceptions as readMesh().
+	 *
+	 * @return True if the chunk is in the store; false otherwise.
+	 */
+	bool readDensity(const glm::ivec3& coordinates, DensityGrid& densities) const;
+
+	/**
+	 * Returns the index - the offset of the newest record for each chunk and payload type.
+	 */
+	std::vector<ChunkStoreIndexEntry> getIndexEntries() const;
+
+	/**
+	 * Returns the offset just past the last chunk record in the file (i.e. where new chunk records should be appended).
+	 */
+	glmd::uint64 getEndOfChunks() const;
+
+	/**
+	 * Returns true if the file had no valid index, and the index had to be rebuilt from the chunk headers.
+	 */
+	bool isIndexRebuilt() const;
+
+private:
+	typedef std::unordered_map< glm::ivec3, glmd::uint64, ChunkCoordinatesHash > Index;
+
+	std::string filename_;
+
+	MappedFile file_;
+	const glmd::uint8* data_;
+	glmd::uint64 size_;
+
+	Index index_[CHUNK_PAYLOAD_COUNT];
+	glmd::uint64 endOfChunks_;
+	bool isIndexRebuilt_;
+
+	bool readIndex();
+	void rebuildIndex();
+
+	/**
+	 * Validates and decompresses the payload of a chunk.
+	 */
+	bool readPayload(const glm::ivec3& coordinates, ChunkPayloadType payloadType, ChunkHeader& header, std::vector<glmd::uint8>& payload) const;
+
+	ChunkStoreReader(const ChunkStoreReader&) = delete;
+	ChunkStoreReader& operator=(const ChunkStoreReader&) = delete;
+};
+
+}
+}
+
+#endif /* CHUNKSTOREREADER_H_ */
@@ -0,0 +1,89 @@
+#ifndef CHUNKSTOREWRITER_H_
+#define CHUNKSTOREWRITER_H_
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <unordered_map>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include "ChunkStoreFormat.hpp"
+#include "ChunkCoordinates.hpp"
+#include "TerrainSettings.hpp"
+
+namespace glr
+{
+namespace terrain
+{
+
+class DensityGrid;
+
+/**
+ * Appends chunks to a chunk store file (see ChunkStoreFormat.hpp).
+ *
+ * Chunk records are never modified once they are written - writing a chunk again appends a new record, and the index is updated to
+ * point at it.  The index is written when the writer is closed (or destroyed).
+ *
+ * **Not Thread Safe**: Only one thread may use a writer at a time, and a file must only be open in one writer at a time.
+ */
+class ChunkStoreWriter
+{
+public:
+	/**
+	 * Opens the chunk store for writing, creating it if it doesn't exist.
+	 *
+	 * Throws an exception::IoException if the file can't be opened, or an exception::FormatException if append is true and the existing
+	 * file is not a chunk store.
+	 *
+	 * @param filename The chunk store file.
+	 * @param compression How to compress chunk payloads.  If the compression is not supported by this build, payloads are stored
+	 * uncompressed.
+	 * @param append If true, the chunks already in the store are kept; if false, the store is emptied.
+	 */
+	ChunkStoreWriter(const std::string& filename, ChunkCompression compression = CHUNK_COMPRESSION_NONE, bool append = true);
+
+	/**
+	 * Closes the store (see close()).
+	 */
+	~ChunkStoreWriter();
+
+	void writeMesh(const glm::ivec3& coordinates, LevelOfDetail levelOfDetail, const ChunkMeshData& mesh);
+	void writeDensity(const glm::ivec3& coordinates, const DensityGrid& densities);
+
+	/**
+	 * Writes the index, and closes the file.  Does nothing if the writer is already closed.
+	 */
+	void close();
+
+	/**
+	 * Returns the number of chunks in the store that have a payload of the given type.
+	 */
+	glmd::uint32 getNumberOfChunks(ChunkPayloadType payloadType) const;
+
+private:
+	typedef std::unordered_map< glm::ivec3, glmd::uint64, ChunkCoordinatesHash > Index;
+
+	std::string filename_;
+	std::fstream stream_;
+	ChunkCompression compression_;
+
+	Index index_[CHUNK_PAYLOAD_COUNT];
+	glmd::uint64 writeOffset_;
+
+	// Reused between writes, so that writing a chunk doesn't allocate (once the buffers are big enough)
+	std::vector<glmd::uint8> payload_;
+	std::vector<glmd::uint8> stored_;
+
+	void writeChunk(ChunkHeader& header);
+	void write(const void* data, glmd::uint64 size);
+
+	ChunkStoreWriter(const ChunkStoreWriter&) = delete;
+	ChunkStoreWriter& operator=(const ChunkStoreWriter&) = delete;
+};
+
+}
+}
+
+#endif /* CHUNKSTOREWRITER_H_ */
@@ -0,0 +1,122 @@
+#ifndef DENSITYGRID_H_
+#define DENSITYGRID_H_
+
+#include <memory>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace glmd = glm::detail;
+
+namespace glr
+{
+namespace terrain
+{
+
+/**
+ * A dense 3 dimensional field of density values, stored in a single contiguous block of memory.
+ *
+ * The grid holds 'size' points in each dimension for the chunk itself, plus a border of 'borderLow' points before and
+ * 'borderHigh' points after the chunk.  The smoothing algorithms use the border when they need to look outside of the chunk
+ * (i.e. when calculating normals).
+ *
+ * All accessors take *local* coordinates - (0, 0, 0) is always the first point of the chunk, and the valid range in each
+ * dimension is [getMin(), getMax()).  This means callers never have to add the border offset themselves.
+ *
+ * Values are stored with z as the fastest changing dimension (i.e. index = x * getStrideX() + y * getStrideY() + z), and the
+ * start of the data is aligned to ALIGNMENT bytes.
+ */
+class DensityGrid
+{
+public:
+	static const glmd::uint32 ALIGNMENT = 64;
+
+	DensityGrid();
+	DensityGrid(glmd::int32 size, glmd::int32 borderLow, glmd::int32 borderHigh);
+	DensityGrid(const DensityGrid& other);
+	DensityGrid(DensityGrid&& other);
+	~DensityGrid();
+
+	DensityGrid& operator=(const DensityGrid& other);
+	DensityGrid& operator=(DensityGrid&& other);
+
+	/**
+	 * Will resize the grid to hold (size + borderLow + borderHigh)^3 points.  If the grid already has these dimensions, the existing
+	 * memory is reused.
+	 *
+	 * Note: The values of the density field are undefined after a resize.
+	 */
+	void resize(glmd::int32 size, glmd::int32 borderLow, glmd::int32 borderHigh);
+
+	/**
+	 * Sets every point in the grid (including the border) to value.
+	 */
+	void fill(glmd::float32 value);
+
+	inline glmd::float32 get(glmd::int32 x, glmd::int32 y, glmd::int32 z) const;
+	inline void set(glmd::int32 x, glmd::int32 y, glmd::int32 z, glmd::float32 value);
+	inline glmd::float32& at(glmd::int32 x, glmd::int32 y, glmd::int32 z);
+
+	/**
+	 * Returns the offset into the data array for the point at local coordinates (x, y, z).
+	 */
+	inline glmd::int32 getIndex(glmd::int32 x, glmd::int32 y, glmd::int32 z) const;
+
+	/**
+	 * Returns true if the local coordinates (x, y, z) lie inside the grid (including the border); false otherwise.
+	 */
+	inline bool isInBounds(glmd::int32 x, glmd::int32 y, glmd::int32 z) const;
+
+	bool isEmpty() const;
+
+	glmd::int32 getSize() const;
+	glmd::int32 getBorderLow() const;
+	glmd::int32 getBorderHigh() const;
+
+	/**
+	 * The smallest valid local coordinate (inclusive) in any dimension.
+	 */
+	glmd::int32 getMin() const;
+
+	/**
+	 * The largest valid local coordinate (exclusive) in any dimension.
+	 */
+	glmd::int32 getMax() const;
+
+	/**
+	 * The number of points along one dimension, including the border.
+	 */
+	glmd::int32 getDimension() const;
+
+	glmd::int32 getStrideX() const;
+	glmd::int32 getStrideY() const;
+	glmd::int32 getStrideZ() const;
+
+	glmd::uint32 getNumberOfPoints() const;
+
+	glmd::float32* getData();
+	const glmd::float32* getData() const;
+
+private:
+	glmd::int32 size_;
+	glmd::int32 borderLow_;
+	glmd::int32 borderHigh_;
+	glmd::int32 dimension_;
+
+	glmd::int32 strideX_;
+	glmd::int32 strideY_;
+
+	// The allocated memory (over-allocated so that data_ can be aligned)
+	std::unique_ptr<glmd::uint8[]> memory_;
+	// The aligned start of the density values inside memory_
+	glmd::float32* data_;
+
+	void allocate();
+};
+
+}
+}
+
+#include "DensityGrid.inl"
+
+#endif /* DENSITYGRID_H_ */
@@ -0,0 +1,35 @@
+namespace glr
+{
+namespace terrain
+{
+
+glmd::float32 DensityGrid::get(glmd::int32 x, glmd::int32 y, glmd::int32 z) const
+{
+	return data_[getIndex(x, y, z)];
+}
+
+void DensityGrid::set(glmd::int32 x, glmd::int32 y, glmd::int32 z, glmd::float32 value)
+{
+	data_[getIndex(x, y, z)] = value;
+}
+
+glmd::float32& DensityGrid::at(glmd::int32 x, glmd::int32 y, glmd::int32 z)
+{
+	return data_[getIndex(x, y, z)];
+}
+
+glmd::int32 DensityGrid::getIndex(glmd::int32 x, glmd::int32 y, glmd::int32 z) const
+{
+	return (x + borderLow_) * strideX_ + (y + borderLow_) * strideY_ + (z + borderLow_);
+}
+
+bool DensityGrid::isInBounds(glmd::int32 x, glmd::int32 y, glmd::int32 z) const
+{
+	const glmd::int32 min = -borderLow_;
+	const glmd::int32 max = size_ + borderHigh_;
+
+	return (x >= min && x < max && y >= min && y < max && z >= min && z < max);
+}
+
+}
+}
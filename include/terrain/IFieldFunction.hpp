@@ -21,6 +21,51 @@ public:
 	 * 
 	 */
 	virtual glm::detail::float32 getNoise(glm::detail::float32 x, glm::detail::float32 y, glm::detail::float32 z) = 0;
+	
+	/**
+	 * Evaluates the field function at count points, given as separate arrays of x, y and z coordinates, and writes the results to
+	 * densities (i.e. densities[i] = getNoise(x[i], y[i], z[i])).
+	 * 
+	 * The terrain generator fills the density field through this method, a batch of points at a time.  The default implementation
+	 * simply calls getNoise() for each point - field functions can override it to evaluate several points at once (i.e. using SIMD
+	 * instructions).
+	 * 
+	 * @param x The x coordinates of the points.
+	 * @param y The y coordinates of the points.
+	 * @param z The z coordinates of the points.
+	 * @param densities Receives the value of the field function at each point.  Must have room for count values.
+	 * @param count The number of points.
+	 */
+	virtual void getNoiseBatch(const glm::detail::float32* x, const glm::detail::float32* y, const glm::detail::float32* z, glm::detail::float32* densities, glm::detail::uint32 count)
+	{
+		for (glm::detail::uint32 i=0; i < count; i++)
+		{
+			densities[i] = getNoise(x[i], y[i], z[i]);
+		}
+	}
+	
+	/**
+	 * Returns a conservative range for the values of the field function inside the axis aligned box from min to max - every value
+	 * getNoise() returns for a point inside the box must be between minValue and maxValue.  The range doesn't need to be tight, but it
+	 * must never be too small.
+	 * 
+	 * The terrain generator uses this to find chunks that are entirely air (minValue > 0) or entirely solid (maxValue < 0) without
+	 * sampling their density field (see classifyChunk()).  Field functions that are mostly a function of height (i.e. a height map with
+	 * some noise added to it) can usually bound their values very cheaply.
+	 * 
+	 * The default implementation returns false, which means the range is unknown (and every chunk is sampled).
+	 * 
+	 * @param min The corner of the box with the smallest coordinates.
+	 * @param max The corner of the box with the largest coordinates.
+	 * @param minValue Receives the lower bound of the field function inside the box.
+	 * @param maxValue Receives the upper bound of the field function inside the box.
+	 * 
+	 * @return True if minValue and maxValue were set; false if the range is unknown.
+	 */
+	virtual bool getRange(const glm::vec3& min, const glm::vec3& max, glm::detail::float32& minValue, glm::detail::float32& maxValue)
+	{
+		return false;
+	}
 };
 
 }
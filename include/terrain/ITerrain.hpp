@@ -79,8 +79,10 @@ public:
 	 * Will set and update the level of detail of the terrain.  If the lod passed in is the same as the current lod, this method
 	 * will do nothing.
 	 * 
-	 * If the level of detail is different than the current value, this method will do any preparation necessary for the lod change, and
-	 * then mark the terrain as dirty.
+	 * If the level of detail is different than the current value, the new value is recorded - the terrain's owner (i.e. the TerrainManager)
+	 * is responsible for generating a new mesh at that level of detail.
+	 * 
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment.
 	 */
 	virtual void updateLod(LevelOfDetail lod) = 0;
 	
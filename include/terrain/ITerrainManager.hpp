@@ -6,6 +6,8 @@
 #define GLM_FORCE_RADIANS
 #include <glm/glm.hpp>
 
+#include "BoundingVolumeHierarchy.hpp"
+
 namespace glr
 {
 
@@ -16,6 +18,24 @@ namespace terrain
 
 class ITerrain;
 class ITerrainManagerEventListener;
+struct TerrainEdit;
+
+/**
+ * How the terrain chunks created since generate() was last called turned out.
+ */
+struct ChunkStatistics
+{
+	ChunkStatistics() : numberOfEmptyChunks(0), numberOfSolidChunks(0), numberOfSurfaceChunks(0), numberOfChunksSkipped(0)
+	{
+	}
+	
+	glm::detail::uint32 numberOfEmptyChunks;
+	glm::detail::uint32 numberOfSolidChunks;
+	glm::detail::uint32 numberOfSurfaceChunks;
+	// The empty and solid chunks that were classified by IFieldFunction::getRange() alone - they were never sampled, and no Terrain
+	// was created for them
+	glm::detail::uint32 numberOfChunksSkipped;
+};
 
 class ITerrainManager
 {
@@ -81,6 +101,10 @@ public:
 	/**
 	 * Generates (or regenerates) the terrain using the data loaded from disk or passed in as parameters.
 	 * 
+	 * If initialize is true, the chunks are generated by a pool of worker threads (closest to the follow target first), and are
+	 * uploaded to the graphics card during calls to update().  Note that this means the field function must be safe to call from
+	 * multiple threads at the same time.
+	 * 
 	 * **Partially Thread Safe**: If initialize is false, this method is safe to call in a multi-threaded environment.  However, 
 	 * if initialize is true, this method is *not* thread safe, and should only be called from the OpenGL thread.
 	 */
@@ -93,6 +117,20 @@ public:
 	
 	virtual void moveTerrainFromProcessedToReady(ITerrain* terrain) = 0;
 	
+	/**
+	 * Will add solid terrain to (or remove it from) the region covered by the edit.
+	 * 
+	 * Only the chunks whose density values the edit changes are remeshed - this includes neighbouring chunks whose border reaches into
+	 * the edit.  They are remeshed by the worker threads ahead of other queued terrain, and are uploaded to the graphics card during
+	 * calls to update().  Chunks that were empty or solid before the edit are created as needed.
+	 * 
+	 * The density values of edited chunks are kept (and saved by serialize()), so that later edits and level of detail changes build on them.
+	 * 
+	 * **Not Thread Safe**: This method is *not* safe to call in a multi-threaded environment, and should only be called from the 
+	 * OpenGL thread.
+	 */
+	virtual void applyEdit(const TerrainEdit& edit) = 0;
+	
 	virtual void serialize(const std::string& filename) = 0;
 	virtual void deserialize(const std::string& filename) = 0;
 	
@@ -101,6 +139,35 @@ public:
 	virtual glm::detail::int32 getLength() const = 0;
 	
 	virtual glm::detail::int32 getBlockSize() const = 0;
+	
+	/**
+	 * Returns the number of terrain chunks that have been generated since generate() was last called.
+	 * 
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment.
+	 */
+	virtual glm::detail::uint32 getNumberOfChunksGenerated() const = 0;
+	
+	/**
+	 * Returns the rate (in chunks per second) at which the worker threads have generated terrain chunks since generate() was last called.
+	 * 
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment.
+	 */
+	virtual glm::detail::float32 getChunksPerSecond() const = 0;
+	
+	/**
+	 * Returns how many of the terrain chunks created since generate() was last called were empty, solid, or had a surface.
+	 * 
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment.
+	 */
+	virtual ChunkStatistics getChunkStatistics() const = 0;
+	
+	/**
+	 * Returns the number of terrain chunks that were inside of the camera's view frustum (and rendered) and outside of it (and culled) in
+	 * the last call to render().
+	 * 
+	 * **Thread Safe**: This method is safe to call in a multi-threaded environment.
+	 */
+	virtual CullingStatistics getCullingStatistics() const = 0;
 };
 
 }
@@ -17,6 +17,13 @@ public:
 	 * Will generate a mesh of the provided VoxelChunk, and put the data in the provided vectors (vertices, normals, and textureBlendingValues).
 	 */
 	virtual void generateMesh(VoxelChunk& chunk, glm::detail::int32 length, glm::detail::int32 width, glm::detail::int32 height, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, std::vector<glm::vec4>& textureBlendingValues) const = 0;
+	
+	/**
+	 * Will generate an indexed mesh of the provided VoxelChunk, and put the data in the provided vectors (vertices, normals, textureBlendingValues, and indices).
+	 * 
+	 * Vertices that are shared between triangles are only emitted once - every 3 consecutive values in indices define a triangle.
+	 */
+	virtual void generateMesh(VoxelChunk& chunk, glm::detail::int32 length, glm::detail::int32 width, glm::detail::int32 height, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, std::vector<glm::vec4>& textureBlendingValues, std::vector<glm::detail::uint32>& indices) const = 0;
 };
 
 }
@@ -0,0 +1,69 @@
+#ifndef SIMPLEXNOISEFIELDFUNCTION_H_
+#define SIMPLEXNOISEFIELDFUNCTION_H_
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include "IFieldFunction.hpp"
+
+namespace glr
+{
+namespace terrain
+{
+
+enum SimdInstructionSet
+{
+	SIMD_NONE = 0,
+	SIMD_SSE4_1,
+	SIMD_AVX2
+};
+
+/**
+ * Returns the best SIMD instruction set supported by the CPU we are running on (that SimplexNoiseFieldFunction knows how to use).
+ */
+SimdInstructionSet getSupportedSimdInstructionSet();
+
+/**
+ * A field function that returns fractal 3d simplex noise (the sum of 'octaves' layers of noise, each with double the frequency and
+ * half the amplitude of the previous layer).
+ *
+ * getNoiseBatch() evaluates 8 points at a time using AVX2, or 4 points at a time using SSE4.1, depending on what the CPU supports.  The
+ * gradients are chosen by hashing the lattice coordinates (rather than with a permutation table), so that every step can be done
+ * in SIMD registers.  getNoise() and the scalar fallback use the same algorithm, and return the same values.
+ *
+ * The noise is roughly in the range [-1, 1].  This class has no mutable state, so it is safe to use from multiple threads.
+ */
+class SimplexNoiseFieldFunction : public IFieldFunction
+{
+public:
+	/**
+	 * @param frequency The frequency of the first octave (i.e. 1/32 gives features roughly 32 units across).
+	 * @param octaves The number of layers of noise to add together.  Must be at least 1.
+	 * @param seed Different seeds give different noise.
+	 * @param maxInstructionSet The best instruction set to use - the instruction set actually used is the best one that is supported
+	 * by both the CPU and this value.  Mostly useful for testing and benchmarking.
+	 */
+	SimplexNoiseFieldFunction(glm::detail::float32 frequency = 1.0f / 32.0f, glm::detail::uint32 octaves = 4, glm::detail::uint32 seed = 0, SimdInstructionSet maxInstructionSet = SIMD_AVX2);
+	virtual ~SimplexNoiseFieldFunction();
+
+	virtual glm::detail::float32 getNoise(glm::detail::float32 x, glm::detail::float32 y, glm::detail::float32 z);
+	virtual void getNoiseBatch(const glm::detail::float32* x, const glm::detail::float32* y, const glm::detail::float32* z, glm::detail::float32* densities, glm::detail::uint32 count);
+
+	/**
+	 * Returns the instruction set that getNoiseBatch() uses.
+	 */
+	SimdInstructionSet getInstructionSet() const;
+
+private:
+	glm::detail::float32 frequency_;
+	glm::detail::uint32 octaves_;
+	glm::detail::uint32 seed_;
+	// Scales the sum of the octaves back to roughly [-1, 1]
+	glm::detail::float32 normalization_;
+	SimdInstructionSet instructionSet_;
+};
+
+}
+}
+
+#endif /* SIMPLEXNOISEFIELDFUNCTION_H_ */
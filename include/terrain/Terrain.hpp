@@ -5,6 +5,7 @@
 
 #include "ITerrain.hpp"
 #include "BasicSceneNode.hpp"
+#include "VoxelChunk.hpp"
 
 namespace glr
 {
@@ -13,6 +14,7 @@ namespace terrain
 
 class TerrainMesh;
 class IVoxelChunkMeshGenerator;
+class DensityGrid;
 
 class Terrain : public virtual ITerrain, public BasicSceneNode
 {
@@ -34,8 +36,58 @@ public:
 	virtual void updateLod(LevelOfDetail lod);
 	virtual LevelOfDetail getLod() const;
 	
+	/**
+	 * Generates the terrain's mesh, at the terrain's current level of detail.
+	 */
 	virtual void generate(TerrainSettings settings = TerrainSettings());
 	
+	/**
+	 * Generates the terrain's mesh, at the terrain's current level of detail, using the edited density values (if any) in place of
+	 * the field function's values.
+	 */
+	void generate(const TerrainSettings& settings, const DensityGrid* editedDensities);
+	
+	/**
+	 * Generates the mesh for the chunk at the given grid coordinates, at the given level of detail.  Only indexed Marching Cubes
+	 * meshes have lower levels of detail - other meshes are always generated at full resolution.
+	 * 
+	 * If editedDensities is not null, it holds the full resolution density grid of the chunk (see TerrainEdit), which is used instead
+	 * of the values from the field function.
+	 * 
+	 * Unedited chunks are first classified with classifyChunk() - if the field function can show that the chunk is entirely empty or
+	 * solid, its density field is never sampled.
+	 * 
+	 * This only uses its arguments (and not a Terrain object), so it is safe to call on a worker thread while the chunk's Terrain is
+	 * being rendered.
+	 * 
+	 * @param chunkType If not null, receives whether the chunk is empty, solid, or has a surface.
+	 * 
+	 * @return True if the chunk has a surface; false if it is entirely empty or solid.
+	 */
+	static bool generateMesh(glmd::int32 gridX, glmd::int32 gridY, glmd::int32 gridZ, const glm::ivec3& dimensions, IFieldFunction& fieldFunction,
+		const IVoxelChunkMeshGenerator& voxelChunkMeshGenerator, LevelOfDetail lod, const TerrainSettings& settings, ChunkMeshData& mesh,
+		const DensityGrid* editedDensities = nullptr, ChunkType* chunkType = nullptr);
+	
+	/**
+	 * Returns the stride that generateMesh() samples the density field at for the given level of detail (1 means full resolution).
+	 */
+	static glmd::int32 getMeshStride(LevelOfDetail lod, const TerrainSettings& settings);
+	
+	/**
+	 * Replaces the mesh of terrain that has already been prepared (i.e. with a mesh generated at a different level of detail), and
+	 * pushes it to video memory.  Does nothing if the terrain has no mesh yet, or the new mesh is empty.
+	 * 
+	 * **Not Thread Safe**: This method should only be called from the OpenGL thread.
+	 */
+	void updateMesh(ChunkMeshData mesh);
+	
+	/**
+	 * Sets the mesh of the terrain without generating it (i.e. when the mesh was loaded from a chunk store).  Like generate(), this
+	 * may be called outside of the OpenGL thread - prepareOrUpdateGraphics() must be called on the OpenGL thread afterwards.
+	 */
+	void setMeshData(std::vector< glm::vec3 > vertices, std::vector< glm::vec3 > normals, std::vector< glm::vec4 > textureBlendingValues,
+		std::vector< glm::detail::uint32 > indices, TerrainSettings settings = TerrainSettings());
+	
 	void freeVideoMemory();
 	
 	bool isActive() const;
@@ -43,6 +95,12 @@ public:
 	
 	virtual bool isEmptyOrSolid() const;
 	
+	/**
+	 * Returns whether the terrain was found to be empty, solid, or to have a surface the last time it was generated (or CHUNK_TYPE_UNKNOWN
+	 * if it hasn't been generated).
+	 */
+	ChunkType getChunkType() const;
+	
 	virtual glm::detail::int32 getGridX() const;
 	virtual glm::detail::int32 getGridY() const;
 	virtual glm::detail::int32 getGridZ() const;
@@ -70,7 +128,8 @@ private:
 	
 	std::atomic<bool> isActive_;
 	std::atomic<bool> isEmptyOrSolid_;
-	LevelOfDetail levelOfDetail_;
+	std::atomic<ChunkType> chunkType_;
+	std::atomic<LevelOfDetail> levelOfDetail_;
 
 	std::atomic<bool> isDirty_;
 
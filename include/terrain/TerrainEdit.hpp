@@ -0,0 +1,93 @@
+#ifndef TERRAINEDIT_H_
+#define TERRAINEDIT_H_
+
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace glr
+{
+namespace terrain
+{
+
+class DensityGrid;
+struct VoxelChunk;
+
+enum EditShape
+{
+	EDIT_SHAPE_SPHERE = 0,
+	EDIT_SHAPE_BOX
+};
+
+enum EditOperation
+{
+	// Fills the shape with solid terrain (i.e. build)
+	EDIT_OPERATION_ADD = 0,
+	// Fills the shape with air (i.e. dig)
+	EDIT_OPERATION_REMOVE
+};
+
+/**
+ * An edit to the terrain - a shape, in world coordinates, that is either filled with solid terrain or carved out of it.
+ */
+struct TerrainEdit
+{
+	TerrainEdit() : shape(EDIT_SHAPE_SPHERE), operation(EDIT_OPERATION_REMOVE), center(glm::vec3()), halfExtents(glm::vec3(1.0f))
+	{
+	}
+
+	/**
+	 * @param shape The shape of the edit.
+	 * @param operation Whether to fill the shape with solid terrain or with air.
+	 * @param center The center of the shape (in world coordinates).
+	 * @param halfExtents For a box, half of its size along each axis.  For a sphere, the radius is halfExtents.x.
+	 */
+	TerrainEdit(EditShape shape, EditOperation operation, const glm::vec3& center, const glm::vec3& halfExtents)
+		: shape(shape), operation(operation), center(center), halfExtents(halfExtents)
+	{
+	}
+
+	EditShape shape;
+	EditOperation operation;
+	glm::vec3 center;
+	glm::vec3 halfExtents;
+
+	/**
+	 * Returns the corners of the axis aligned box that contains the shape.
+	 */
+	glm::vec3 getMin() const;
+	glm::vec3 getMax() const;
+
+	/**
+	 * Returns the signed distance from the point to the surface of the shape (negative inside the shape, and positive outside of it).
+	 */
+	glm::detail::float32 getDistance(const glm::vec3& point) const;
+};
+
+/**
+ * Returns the grid coordinates of every chunk whose density grid (including its border) contains at least one point that the edit can
+ * change.  This includes neighbouring chunks whose border reaches into the edit, since their meshes depend on those points too.
+ *
+ * @param dimensions The number of chunks in the world along each axis (i.e. TerrainSettings::length, width, and height).
+ */
+std::vector<glm::ivec3> getChunksAffectedByEdit(const TerrainEdit& edit, const glm::ivec3& dimensions);
+
+/**
+ * Applies the edit to a full resolution density grid, whose point at local coordinates (0, 0, 0) is at origin (in world coordinates).
+ * Only the points inside the edit's bounding box are visited.
+ *
+ * @return True if any density value changed; false otherwise.
+ */
+bool applyEdit(const TerrainEdit& edit, DensityGrid& densities, const glm::vec3& origin);
+
+/**
+ * Copies the points of a full resolution (edited) density grid into the chunk's density grid, which may have been sampled at a lower level
+ * of detail (see VoxelChunk::stride).  Points of the chunk that are outside of editedDensities are left as they are.
+ */
+void copyEditedDensities(const DensityGrid& editedDensities, VoxelChunk& chunk);
+
+}
+}
+
+#endif /* TERRAINEDIT_H_ */
@@ -4,16 +4,23 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
 #include <functional>
-#include <deque>
 #include <mutex>
+#include <atomic>
 
 #define GLM_FORCE_RADIANS
 #include <glm/glm.hpp>
 
 #include "TerrainSettings.hpp"
+#include "ChunkCoordinates.hpp"
+#include "DensityGrid.hpp"
+#include "VoxelChunk.hpp"
 
 #include "IdManager.hpp"
+#include "ThreadPool.hpp"
+#include "MpscQueue.hpp"
 #include "terrain/ITerrainManager.hpp"
 
 namespace glr
@@ -30,6 +37,7 @@ namespace terrain
 class IFieldFunction;
 class IVoxelChunkMeshGenerator;
 class Terrain;
+class ChunkStoreReader;
 
 class TerrainManager : public ITerrainManager
 {
@@ -59,8 +67,15 @@ public:
 	virtual glm::detail::int32 getLength() const;
 	
 	virtual glm::detail::int32 getBlockSize() const;
+	
+	virtual glm::detail::uint32 getNumberOfChunksGenerated() const;
+	virtual glm::detail::float32 getChunksPerSecond() const;
+	virtual ChunkStatistics getChunkStatistics() const;
+	virtual CullingStatistics getCullingStatistics() const;
 
 	virtual void moveTerrainFromProcessedToReady(ITerrain* terrain);
+	
+	virtual void applyEdit(const TerrainEdit& edit);
 
 private:	
 	glw::IOpenGlDevice* openGlDevice_;
@@ -73,30 +88,192 @@ private:
 	TerrainSettings terrainSettings_;
 	std::unique_ptr<IVoxelChunkMeshGenerator> voxelChunkMeshGenerator_;
 	
-	std::vector< std::unique_ptr<Terrain> > terrain_;
-	std::vector< std::unique_ptr<Terrain> > terrainToBeProcessed_;
-	std::mutex terrainMutex_;
-	std::mutex terrainToBeProcessedMutex_;
+	// Terrain is indexed by its grid coordinates, so that finding the terrain in a given grid cell is O(1)
+	typedef std::unordered_map< glm::ivec3, std::unique_ptr<Terrain>, ChunkCoordinatesHash > TerrainMap;
+	
+	TerrainMap terrain_;
+	TerrainMap terrainToBeProcessed_;
+	mutable std::mutex terrainMutex_;
+	
+	// The bounding boxes of the terrain that is ready to render, for view frustum culling (guarded by terrainMutex_)
+	BoundingVolumeHierarchy terrainHierarchy_;
+	std::unordered_map< glm::ivec3, glm::detail::int32, ChunkCoordinatesHash > terrainProxies_;
+	CullingStatistics cullingStatistics_;
+	mutable std::mutex terrainToBeProcessedMutex_;
+	
+	// The grid coordinates of terrain that was discarded because it went out of range before it was generated - it is created again
+	// if it comes back into range (guarded by terrainToBeProcessedMutex_)
+	std::unordered_set< glm::ivec3, ChunkCoordinatesHash > cancelledTerrain_;
+	// Set when terrain is discarded, so that the next tick() checks whether it is back in range
+	std::atomic<bool> hasNewCancelledTerrain_;
+	
+	// The full resolution density field of each chunk that has been edited - every other chunk can be generated again from the field function
+	struct EditedChunk
+	{
+		EditedChunk() : version(0)
+		{
+		}
+		
+		DensityGrid densities;
+		// Incremented on every edit, so that meshes generated from older density values can be recognized and discarded
+		glm::detail::uint32 version;
+	};
+	
+	std::unordered_map< glm::ivec3, EditedChunk, ChunkCoordinatesHash > editedChunks_;
+	mutable std::mutex editedChunksMutex_;
 	
 	std::vector<ITerrainManagerEventListener*> eventListeners_;
 	
-	mutable std::mutex openGlWorkMutex_;
-	std::deque< std::function<void()> > openGlWork_;
+	// Worker threads post work for the OpenGL thread here - it is consumed in update()
+	MpscQueue< std::function<void()> > openGlWork_;
+	
+	std::unique_ptr<ThreadPool> threadPool_;
+	
+	// Throughput of the worker threads (times are in microseconds, measured with std::chrono::steady_clock)
+	std::atomic<glm::detail::uint32> numberOfChunksGenerated_;
+	std::atomic<glm::detail::int64> generationStartTime_;
+	std::atomic<glm::detail::int64> lastChunkGeneratedTime_;
+	
+	// See getChunkStatistics()
+	std::atomic<glm::detail::uint32> numberOfEmptyChunks_;
+	std::atomic<glm::detail::uint32> numberOfSolidChunks_;
+	std::atomic<glm::detail::uint32> numberOfSurfaceChunks_;
+	std::atomic<glm::detail::uint32> numberOfChunksSkipped_;
 	
 	IdManager idManager_;
 	
 	void initialize();
 	void postOpenGlWork(std::function<void()> work);
+	void countChunk(ChunkType chunkType);
+	void resetStatistics();
 	glm::ivec3 getTargetGridLocation();
+	
+	/**
+	 * Removes the terrain at coordinates from the bounding volume hierarchy.  terrainMutex_ must be locked.
+	 */
+	void removeTerrainProxy(const glm::ivec3& coordinates);
+	
+	/**
+	 * Updates the level of detail of all of the terrain that is ready to render, based on its distance from the follow target.
+	 */
 	void updateTerrainLod();
+	
+	/**
+	 * Sets the level of detail of the terrain, and queues the generation of a new mesh for it on the thread pool.
+	 */
+	void changeTerrainLod(Terrain* terrain, LevelOfDetail lod);
+	
+	/**
+	 * Queues the generation of a new mesh (at the terrain's current level of detail) for terrain that is ready to render.
+	 */
+	void remeshTerrain(Terrain* terrain, glm::detail::float32 priority);
+	
+	/**
+	 * Runs on a worker thread - generates the mesh of the terrain at the given grid coordinates at the given level of detail, and then
+	 * hands it over to the OpenGL thread.  The mesh is discarded if, by then, the terrain is gone, or its level of detail or density
+	 * values have changed again.
+	 */
+	void regenerateTerrainMesh(const glm::ivec3& coordinates, LevelOfDetail lod);
+	
+	/**
+	 * Runs on a worker thread - generates the density field and mesh for the terrain, and then hands it over to the OpenGL thread.
+	 */
+	void generateTerrain(Terrain* terrain);
+	
+	/**
+	 * Runs on a worker thread - reads the mesh for the terrain from the chunk store, and then hands it over to the OpenGL thread.
+	 * 
+	 * @param editVersion The version of the edited density values that the stored mesh was generated from (0 if the chunk isn't edited).
+	 */
+	void loadTerrain(Terrain* terrain, std::shared_ptr<ChunkStoreReader> chunkStore, glm::detail::uint32 editVersion);
+	
+	/**
+	 * Runs on a worker thread, once the terrain has its mesh - discards the terrain if it is empty, solid, or no longer active, and
+	 * otherwise hands it over to the OpenGL thread.
+	 * 
+	 * @param editVersion The version of the edited density values that the mesh was generated from (0 if the chunk isn't edited).
+	 */
+	void finishTerrain(Terrain* terrain, glm::detail::uint32 editVersion);
+	
+	/**
+	 * Applies the edit to the density values of the chunk at the given grid coordinates (starting from the field function's values if
+	 * the chunk hasn't been edited before).
+	 * 
+	 * @return True if any density value changed; false otherwise.
+	 */
+	bool editChunkDensities(const TerrainEdit& edit, const glm::ivec3& coordinates);
+	
+	/**
+	 * Applies the edit to the density values of an already edited chunk, and bumps its version if anything changed.  Must be called
+	 * while holding editedChunksMutex_.
+	 * 
+	 * @return True if any density value changed; false otherwise.
+	 */
+	bool applyEditToEditedChunk(const TerrainEdit& edit, EditedChunk& editedChunk, const glm::vec3& origin);
+	
+	/**
+	 * Queues the generation of a new mesh for the chunk at the given grid coordinates after its density values were edited.
+	 */
+	void remeshEditedTerrain(const glm::ivec3& coordinates);
+	
+	/**
+	 * Returns a copy of the edited density values of the chunk at the given grid coordinates, or nullptr if the chunk hasn't been edited.
+	 * 
+	 * **Thread Safe**: This method is safe to call from the worker threads.
+	 */
+	std::unique_ptr<DensityGrid> getEditedDensities(const glm::ivec3& coordinates, glm::detail::uint32& version) const;
+	
+	/**
+	 * Returns the version of the edited density values of the chunk at the given grid coordinates, or 0 if the chunk hasn't been edited.
+	 */
+	glm::detail::uint32 getEditVersion(const glm::ivec3& coordinates) const;
+	
+	glm::ivec3 getDimensions() const;
+	
+	/**
+	 * Cancels the generation of any terrain that is no longer within the maximum view distance of the follow target.
+	 */
+	void cancelOutOfRangeTerrain();
+	
+	/**
+	 * Creates (and queues the generation of) any cancelled terrain that is back within the maximum view distance of the follow target.
+	 */
+	void createBackInRangeTerrain();
+	
+	/**
+	 * Removes terrain that went out of range from the 'to be processed' list, and remembers its grid coordinates so that it can be created
+	 * again if it comes back into range.
+	 * 
+	 * **Thread Safe**: This method is safe to call from the worker threads.
+	 */
+	void discardCancelledTerrain(Terrain* terrain);
+	
+	/**
+	 * Returns the priority of the terrain at the given grid coordinates - terrain closer to the follow target has a lower value, and
+	 * is generated first.
+	 */
+	glm::detail::float32 getTerrainPriority(const glm::ivec3& coordinates) const;
+	bool isInRange(const glm::ivec3& coordinates) const;
+	glm::vec3 getTerrainCenter(const glm::ivec3& coordinates) const;
+	
+	/**
+	 * Returns the grid coordinates of the terrain that contains the given point (in world coordinates).
+	 */
+	glm::ivec3 getGridCoordinates(const glm::vec3& position) const;
 
-	LevelOfDetail getNewTerrainLod(Terrain& t);
-	bool isWithinRadius(Terrain& t, ISceneNode& n, glm::detail::float32 radius);
+	LevelOfDetail getNewTerrainLod(const glm::ivec3& coordinates) const;
 
 	void createTerrain(glm::detail::float32 x, glm::detail::float32 y, glm::detail::float32 z, bool initialize = true);
 	void createTerrain(glm::detail::int32 x, glm::detail::int32 y, glm::detail::int32 z, bool initialize = true);
 	void createTerrain(const glm::ivec3& coordinates, bool initialize = true);
 	
+	/**
+	 * Creates the terrain at the given grid coordinates, and adds it to the 'to be processed' list.
+	 * 
+	 * @return The new terrain, or nullptr if terrain already exists at the given grid coordinates.
+	 */
+	Terrain* createTerrainToBeProcessed(glm::detail::int32 x, glm::detail::int32 y, glm::detail::int32 z);
+	
 	void addTerrain(Terrain* terrain);
 	void addTerrain(std::unique_ptr<Terrain> terrain);
 	
@@ -114,8 +291,11 @@ private:
 	void removeAllTerrain();
 	
 	Terrain* getTerrain(glm::detail::float32 x, glm::detail::float32 y, glm::detail::float32 z);
-	Terrain* getTerrain(glm::detail::int32 x, glm::detail::int32 y, glm::detail::int32 z);
-	Terrain* getTerrain(const glm::ivec3& coordinates);
+	/**
+	 * Returns the terrain in the given grid cell (unlike getTerrain(), which takes world coordinates).
+	 */
+	Terrain* getTerrainAtGrid(glm::detail::int32 x, glm::detail::int32 y, glm::detail::int32 z);
+	Terrain* getTerrainAtGrid(const glm::ivec3& coordinates);
 	
 	Terrain* getTerrainToBeProcessed(glm::detail::float32 x, glm::detail::float32 y, glm::detail::float32 z);
 	Terrain* getTerrainToBeProcessed(const glm::ivec3& coordinates);
@@ -10,6 +10,8 @@ namespace terrain
 
 /*
  * This extends the glw Mesh class to include texture blending data for voxel terrain.
+ * 
+ * Terrain only has positions, normals and texture blending values, so its vertices use a compact layout (see createVertexFormat()).
  */
 class TerrainMesh : public glr::glw::Mesh
 {
@@ -36,23 +38,26 @@ public:
 	);
 	virtual ~TerrainMesh();
 	
-	virtual void pushToVideoMemory();
 	virtual void pullFromVideoMemory();
 	virtual void freeLocalData();
-	virtual void freeVideoMemory();
-	virtual void allocateVideoMemory();
 	
 	void setTextureBlendingData(std::vector< glm::vec4 > texBlendingData);
 	void setShaderVariableLocation(GLint shaderVariableLocation);
 	
 	std::vector< glm::vec4 >& getTextureBlendingData();
 	GLint getShaderVariableLocation() const;
+	
+	/**
+	 * Returns the vertex layout used for terrain - float32 positions, 10:10:10:2 normals, and unorm8 texture blending values at
+	 * textureBlendingLocation (20 bytes per vertex).  If textureBlendingLocation is negative, the texture blending values are left out.
+	 */
+	static glw::VertexFormat createVertexFormat(GLint textureBlendingLocation);
 
 protected:
 	std::vector< glm::vec4 > texBlendingData_;
 	GLint shaderVariableLocation_;
-
-	glm::detail::uint32 texBlendVboId_;
+	
+	virtual void writeVertices(std::vector< glm::detail::uint8 >& vertices, glm::detail::uint32 firstVertex, glm::detail::uint32 numberOfVertices) const;
 };
 
 }
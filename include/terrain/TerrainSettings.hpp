@@ -1,6 +1,8 @@
 #ifndef TERRAINSETTINGS_H_
 #define TERRAINSETTINGS_H_
 
+#include "ChunkStoreFormat.hpp"
+
 namespace glr
 {
 namespace terrain
@@ -23,6 +25,20 @@ enum LevelOfDetail
 	LOD_HIGHEST
 };
 
+/**
+ * Returns the distance (in density grid points) between the samples used to mesh a chunk at the given level of detail - 1 for
+ * LOD_HIGHEST, doubling for each level down to 16 for LOD_LOWEST.
+ */
+inline glm::detail::int32 getLevelOfDetailStride(LevelOfDetail lod)
+{
+	if (lod == LOD_UNKNOWN || lod >= LOD_HIGHEST)
+	{
+		return 1;
+	}
+	
+	return 1 << (LOD_HIGHEST - lod);
+}
+
 /**
  * Used to pass in Terrain settings.
  */
@@ -31,7 +47,8 @@ struct TerrainSettings
 	TerrainSettings() 
 		: smoothingAlgorithm(ALGORITHM_MARCHING_CUBES), length(8), width(8), height(8),
 		maxViewDistance(256.0f), maxLevelOfDetail(LOD_HIGHEST), minLevelOfDetail(LOD_LOWEST),
-		lodHighestRadius(32.0f), lodHighRadius(64.0f), lodMediumRadius(128.0f), lodLowRadius(256.0f), resolution(1.0f), chunkSize(16), blockSize((glm::detail::int32)(chunkSize / resolution))
+		lodHighestRadius(32.0f), lodHighRadius(64.0f), lodMediumRadius(128.0f), lodLowRadius(256.0f), resolution(1.0f), chunkSize(16), blockSize((glm::detail::int32)(chunkSize / resolution)),
+		indexedMeshes(true), levelOfDetailSkirts(true), numberOfThreads(0), chunkStoreCompression(CHUNK_COMPRESSION_NONE)
 	{
 	}
 	
@@ -51,6 +68,18 @@ struct TerrainSettings
 	glm::detail::float32 resolution;
 	glm::detail::int32 chunkSize;
 	glm::detail::int32 blockSize;
+	
+	// If true, terrain meshes share vertices between triangles and are rendered using an index buffer
+	bool indexedMeshes;
+	
+	// If true, indexed Marching Cubes meshes get 'skirts' along the chunk faces, which hide the cracks between chunks with different levels of detail
+	bool levelOfDetailSkirts;
+	
+	// The number of worker threads used to generate terrain (0 means use std::thread::hardware_concurrency())
+	glm::detail::uint32 numberOfThreads;
+	
+	// How chunk payloads are compressed when the terrain is serialized (see ChunkStoreWriter)
+	ChunkCompression chunkStoreCompression;
 };
 
 }
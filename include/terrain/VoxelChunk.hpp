@@ -1,11 +1,11 @@
 #ifndef VOXELCHUNK_H_
 #define VOXELCHUNK_H_
 
-#include <vector>
-
 #define GLM_FORCE_RADIANS
 #include <glm/glm.hpp>
 
+#include "DensityGrid.hpp"
+
 namespace glmd = glm::detail;
 
 namespace glr
@@ -13,18 +13,32 @@ namespace glr
 namespace terrain
 {
 
-typedef std::vector< std::vector< std::vector<glmd::float32> > > Points;
+enum ChunkType
+{
+	// Not classified yet (or the classification was inconclusive)
+	CHUNK_TYPE_UNKNOWN = 0,
+	// Every point of the density field is air
+	CHUNK_TYPE_EMPTY,
+	// Every point of the density field is solid
+	CHUNK_TYPE_SOLID,
+	// The density field contains both air and solid points, so the chunk has a surface
+	CHUNK_TYPE_SURFACE
+};
 
 struct VoxelChunk
 {
 	glmd::int32 gridX;
 	glmd::int32 gridY;
 	glmd::int32 gridZ;
-	Points points;
-	
-	VoxelChunk() : gridX(0), gridY(0), gridZ(0)
+	// The distance (in density grid points at full resolution) between neighbouring points - see getLevelOfDetailStride()
+	glmd::int32 stride;
+	// Set by classifyChunk() and determineIfEmptyOrSolid() - empty and solid chunks don't need their density field at all
+	ChunkType type;
+	DensityGrid points;
+
+	VoxelChunk() : gridX(0), gridY(0), gridZ(0), stride(1), type(CHUNK_TYPE_UNKNOWN)
 	{};
-	VoxelChunk(glmd::int32 gridX, glmd::int32 gridY, glmd::int32 gridZ) : gridX(gridX), gridY(gridY), gridZ(gridZ)
+	VoxelChunk(glmd::int32 gridX, glmd::int32 gridY, glmd::int32 gridZ, glmd::int32 stride = 1) : gridX(gridX), gridY(gridY), gridZ(gridZ), stride(stride), type(CHUNK_TYPE_UNKNOWN)
 	{};
 };
 
@@ -10,22 +10,46 @@ namespace terrain
 {
 
 class IFieldFunction;
-class VoxelChunk;
+struct VoxelChunk;
+
+/**
+ * Returns the world position of the point at local coordinates (0, 0, 0) of the chunk at the given grid coordinates.
+ * 
+ * Chunks are laid out so that, globally, the terrain is centered at the origin ((0, 0, 0) in world coordinates).
+ */
+glm::vec3 getChunkOrigin(glm::detail::int32 gridX, glm::detail::int32 gridY, glm::detail::int32 gridZ, const glm::ivec3& dimensions);
 
 /**
  * Will fill the VoxelChunk with noise generated using the field function.
  * 
- * Once the method is finished, the VoxelChunk will have the following dimensions:
- * (SIZE + POINT_FIELD_OFFSET + POINT_FIELD_OVERSET) x (SIZE + POINT_FIELD_OFFSET + POINT_FIELD_OVERSET)
+ * Once the method is finished, the VoxelChunk's DensityGrid will have SIZE points per dimension, with a border of POINT_FIELD_OFFSET
+ * points before and POINT_FIELD_OVERSET points after the chunk (i.e. local coordinates -POINT_FIELD_OFFSET to SIZE + POINT_FIELD_OVERSET).
  * 
  * We generate 'extra' dimensions of density data for the benefit of the smoothing functions - it allows them to use the extra data
  * for interpolation, etc.
  * 
+ * If the chunk's stride is bigger than 1 (i.e. for a lower level of detail), only every stride'th point is sampled - the grid has
+ * SIZE / stride points per dimension, and the border is measured in (stride sized) steps.
+ * 
  */
 void generateNoise(VoxelChunk& chunk, glm::detail::int32 length, glm::detail::int32 width, glm::detail::int32 height, glr::terrain::IFieldFunction& fieldFunction);
 
 /**
+ * Uses IFieldFunction::getRange() to determine whether the chunk is entirely empty or entirely solid, *without* generating its density
+ * field (the chunk's DensityGrid is left untouched).  The test covers the full resolution density field, including the border, so the
+ * result holds at every level of detail.
+ * 
+ * The test is conservative - a chunk whose range can't be bounded (or that may have a surface) is left as CHUNK_TYPE_UNKNOWN, and has
+ * to be generated to find out.
+ * 
+ * @return True if the chunk is totally empty or solid (chunk.type is set to CHUNK_TYPE_EMPTY or CHUNK_TYPE_SOLID); false otherwise.
+ */
+bool classifyChunk(VoxelChunk& chunk, glm::detail::int32 length, glm::detail::int32 width, glm::detail::int32 height, glr::terrain::IFieldFunction& fieldFunction);
+
+/**
+ * Determines whether the density field of the chunk (including the border) is entirely empty or entirely solid, and sets chunk.type.
  * 
+ * @return True if the chunk is totally empty or solid; false otherwise.
  */
 bool determineIfEmptyOrSolid(VoxelChunk& chunk);
 
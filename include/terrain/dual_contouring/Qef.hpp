@@ -26,6 +26,9 @@ namespace glmd = glm::detail;
  * Given at least three points Pi, each with its respective
  * normal vector Ni, that describe at least two planes,
  * the QEF evalulates to the point x.
+ *
+ * Note: The Dual Contouring VoxelChunkMeshGenerator uses QefSolver (QefSolver.hpp) instead - this general SVD is kept for comparison
+ * (see benchmarks/src/DualContouringBenchmarks.cpp).
  */
 
 glm::vec3 evaluate(glmd::float64 mat[][3], glmd::float64 *vec, glmd::int32 rows);
@@ -0,0 +1,69 @@
+#ifndef QEFSOLVER_H_
+#define QEFSOLVER_H_
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace glr
+{
+namespace terrain
+{
+namespace dual_contouring
+{
+
+namespace glmd = glm::detail;
+
+/**
+ * Finds the point that minimizes the quadric error function
+ *
+ *   E[x] = sum( (Ni . (x - Pi))^2 )
+ *
+ * for a set of intersection points Pi with normals Ni (i.e. the Hermite data of a Dual Contouring block).
+ *
+ * Instead of keeping a row per intersection (as evaluate() in Qef.hpp does), the solver only accumulates the symmetric 3x3 matrix
+ * A^T A, the vector A^T b, and b^T b, so it has a fixed size and lives on the stack.  solve() diagonalizes A^T A with Jacobi rotations
+ * (in float32), and uses the pseudo inverse - directions the normals don't constrain (i.e. along a flat surface or a sharp edge) are
+ * resolved towards the mass point of the intersections.
+ */
+class QefSolver
+{
+public:
+	QefSolver();
+
+	/**
+	 * Adds the plane through point with the given (unit length) normal.
+	 */
+	void add(const glm::vec3& point, const glm::vec3& normal);
+
+	/**
+	 * Returns the point that minimizes the error (or the mass point, if no planes were added).
+	 */
+	glm::vec3 solve() const;
+
+	/**
+	 * Returns the error at position - the sum of the squared distances from position to each plane.
+	 */
+	glmd::float32 getError(const glm::vec3& position) const;
+
+	/**
+	 * Returns the average of the points that were added.
+	 */
+	glm::vec3 getMassPoint() const;
+
+	glmd::int32 getNumberOfPoints() const;
+
+private:
+	// A^T A - symmetric, so only the upper triangle is stored: xx, xy, xz, yy, yz, zz
+	glmd::float32 ata_[6];
+	glm::vec3 atb_;
+	glmd::float32 btb_;
+
+	glm::vec3 massPointSum_;
+	glmd::int32 numberOfPoints_;
+};
+
+}
+}
+}
+
+#endif /* QEFSOLVER_H_ */
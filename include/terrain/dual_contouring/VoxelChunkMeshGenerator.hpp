@@ -34,6 +34,13 @@ public:
 	 */
 	virtual void generateMesh(VoxelChunk& chunk, glm::detail::int32 length, glm::detail::int32 width, glm::detail::int32 height, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, std::vector<glm::vec4>& textureBlendingValues) const;
 	
+	/**
+	 * Will generate an indexed mesh of the provided VoxelChunk using the Dual Contouring algorithm.
+	 * 
+	 * Each block that intersects the surface generates exactly one vertex, which is shared by all of the triangles that use it.
+	 */
+	virtual void generateMesh(VoxelChunk& chunk, glm::detail::int32 length, glm::detail::int32 width, glm::detail::int32 height, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, std::vector<glm::vec4>& textureBlendingValues, std::vector<glm::detail::uint32>& indices) const;
+	
 private:
 	IFieldFunction* fieldFunction_;
 	
@@ -49,51 +56,86 @@ private:
 		glmd::int32 index;
 		glm::vec3 meshPoint;
 		glm::vec3 meshPointNormal;
+		// The index of meshPoint in the vertex list of an indexed mesh (or -1 if it hasn't been added yet)
+		glmd::int32 vertexIndex;
 	};
 	
 	typedef std::vector< std::vector< std::vector<Block> > > Blocks;
 	
+	/**
+	 * The intersection of the isosurface with an edge of the density grid, and the surface normal there.
+	 */
+	struct HermiteData
+	{
+		glm::vec3 pos;
+		glm::vec3 normal;
+	};
+	
+	/**
+	 * Every edge of the density grid is shared by up to four blocks - the cache makes sure that each edge is only intersected (and has its
+	 * normal calculated) once per chunk.
+	 */
+	struct HermiteEdgeCache
+	{
+		// For each grid point and axis, the index of the edge's HermiteData in edges (or -1 if the edge hasn't been intersected yet)
+		std::vector<glmd::int32> indices;
+		std::vector<HermiteData> edges;
+		glmd::int32 dimension;
+	};
+	
 	/**
 	 * Determines whether the points provided define a a fully solid space or a totally empty space.
 	 * 
 	 * @return True if space is totally empty or solid; false otherwise.
 	 */
-	bool isEmptyOrSolid(const Points& points) const;
+	bool isEmptyOrSolid(const DensityGrid& points) const;
 	
 	/**
 	 * Get noise at the point x, y, z on the grid with the given coordinates.
 	 */
-	glmd::float32 getInterpolatedNoise(const Points& points, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, glmd::float32 x, glmd::float32 y, glmd::float32 z) const;
+	glmd::float32 getInterpolatedNoise(const DensityGrid& points, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, glmd::float32 x, glmd::float32 y, glmd::float32 z) const;
 	
 	/**
-	 * Calculate the normal for the provided point.
+	 * Calculate the normal for the provided point.  The four samples it needs are taken with a single IFieldFunction::getNoiseBatch() call.
 	 */
-	glm::vec3 calculateNormal(const glm::vec3& point, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const Points& densityValues) const;
+	glm::vec3 calculateNormal(const glm::vec3& point, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const DensityGrid& densityValues) const;
+	
+	/**
+	 * Returns the Hermite data for the edge of block (x, y, z) between the given corners of the block, intersecting the edge if it isn't
+	 * in the cache yet.
+	 */
+	const HermiteData& getEdgeIntersection(Block& block, glmd::int32 x, glmd::int32 y, glmd::int32 z, const glmd::int32* corner0, const glmd::int32* corner1,
+		HermiteEdgeCache& hermiteEdges, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const DensityGrid& densityValues) const;
+	
+	/**
+	 * Will clear the provided cache, and size it for the grid points of the blocks.
+	 */
+	void resetHermiteEdges(HermiteEdgeCache& hermiteEdges) const;
 	
 	/**
 	 * Find the intersection along the x-axis where the line segment between p0 and p1 would intersect with the isosurface.
 	 */
-	void intersectXAxis(Point& p0, Point& p1, Point& out, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const Points& densityValues) const;
+	void intersectXAxis(Point& p0, Point& p1, Point& out, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const DensityGrid& densityValues) const;
 	
 	/**
 	 * Find the intersection along the y-axis where the line segment between p0 and p1 would intersect with the isosurface.
 	 */
-	void intersectYAxis(Point& p0, Point& p1, Point& out, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const Points& densityValues) const;
+	void intersectYAxis(Point& p0, Point& p1, Point& out, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const DensityGrid& densityValues) const;
 	
 	/**
 	 * Find the intersection along the z-axis where the line segment between p0 and p1 would intersect with the isosurface.
 	 */
-	void intersectZAxis(Point& p0, Point& p1, Point& out, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const Points& densityValues) const;
+	void intersectZAxis(Point& p0, Point& p1, Point& out, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const DensityGrid& densityValues) const;
 	
 	/**
 	 * Generate the vertex for the given block at position x, y, z.
 	 */
-	void generateVertex(Blocks& blocks, glmd::int32 x, glmd::int32 y, glmd::int32 z, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const Points& densityValues) const;
+	void generateVertex(Blocks& blocks, HermiteEdgeCache& hermiteEdges, glmd::int32 x, glmd::int32 y, glmd::int32 z, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const DensityGrid& densityValues) const;
 	
 	/**
 	 * Determine if the cubes along the xz plane at point y have an intersection.  If a cube does, generate the vertex for that block.
 	 */
-	void computeCubes(Blocks& blocks, glmd::int32 y, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const Points& densityValues) const;
+	void computeCubes(Blocks& blocks, HermiteEdgeCache& hermiteEdges, glmd::int32 y, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const DensityGrid& densityValues) const;
 	
 	/**
 	 * Generate the 3 points for a triangle along the y coordinate (will move along the xz plane at point y).  Will generate
@@ -101,10 +143,26 @@ private:
 	 */
 	void generateTriangles(Blocks& blocks, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, glmd::int32 y) const;
 	
+	/**
+	 * Generate the indexed triangles along the y coordinate (will move along the xz plane at point y).  The mesh point of each block is only
+	 * added to the vertex list once.
+	 */
+	void generateIndexedTriangles(Blocks& blocks, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, std::vector<glm::detail::uint32>& indices, glmd::int32 y) const;
+	
+	/**
+	 * Returns the index of the mesh point of the given block, adding it to the vertex list if required.
+	 */
+	glm::detail::uint32 getBlockVertex(Block& block, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals) const;
+	
+	/**
+	 * Calculate the texture blending values for the provided normals.
+	 */
+	void calculateTextureBlendingValues(const std::vector<glm::vec3>& normals, std::vector<glm::vec4>& textureBlendingValues) const;
+	
 	/**
 	 * Set the densities and positions for the blocks, using the provided points (density values) and the grid coordinates.
 	 */
-	void setDensitiesAndPositions(Blocks& blocks, const Points& points, const glm::ivec3& gridCoords, const glm::ivec3& dimensions) const;
+	void setDensitiesAndPositions(Blocks& blocks, const DensityGrid& points, const glm::ivec3& gridCoords, const glm::ivec3& dimensions) const;
 	
 	/**
 	 * Will resize the provided Blocks 3D vector to the appropriate size.
@@ -31,6 +31,17 @@ public:
 	 */
 	virtual void generateMesh(VoxelChunk& chunk, glm::detail::int32 length, glm::detail::int32 width, glm::detail::int32 height, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, std::vector<glm::vec4>& textureBlendingValues) const;
 	
+	/**
+	 * Will generate an indexed mesh of the provided VoxelChunk using the Marching Cubes algorithm.
+	 * 
+	 * Each edge of the density grid that intersects the surface generates exactly one vertex, which is shared by all of the
+	 * triangles that touch that edge.
+	 * 
+	 * The chunk may have been sampled at a lower level of detail (see VoxelChunk::stride) - the cubes are then stride times bigger.  If
+	 * TerrainSettings::levelOfDetailSkirts is set, skirts are added along the chunk faces (see generateSkirts()).
+	 */
+	virtual void generateMesh(VoxelChunk& chunk, glm::detail::int32 length, glm::detail::int32 width, glm::detail::int32 height, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, std::vector<glm::vec4>& textureBlendingValues, std::vector<glm::detail::uint32>& indices) const;
+	
 private:
 	struct Point
 	{
@@ -46,33 +57,68 @@ private:
 	
 	typedef std::vector< std::vector< std::vector<Block> > > Blocks;
 	
+	/**
+	 * Holds the index of the vertex generated for each edge of two consecutive y slices of the density grid (or -1 if no vertex has
+	 * been generated yet).  Edges are identified by their lower end point and their axis.
+	 */
+	typedef std::vector<glmd::int32> EdgeCache;
+	
 	glm::vec3 vertexInterp(double isolevel, const glm::vec3& p1, const glm::vec3& p2, double valp1, double valp2) const;
-	glm::vec3 calculateNormal(int x1, int y1, int z1, int x2, int y2, int z2, const Points& densityValues) const;
-	glm::vec3 calculateGradientVector(int x, int y, int z, const Points& densityValues) const;
-	//glm::vec3 calculateNormal(int x, int y, int z, const Points& densityValues) const;
+	glm::vec3 calculateNormal(int x1, int y1, int z1, int x2, int y2, int z2, const DensityGrid& densityValues) const;
+	glm::vec3 calculateGradientVector(int x, int y, int z, const DensityGrid& densityValues) const;
+	//glm::vec3 calculateNormal(int x, int y, int z, const DensityGrid& densityValues) const;
 	glm::vec3 calculateSimpleNormal(const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3) const;
 	/**
 	 * Determines whether the points provided define a a fully solid space or a totally empty space.
 	 * 
 	 * @return True if space is totally empty or solid; false otherwise.
 	 */
-	bool isEmptyOrSolid(const Points& points) const;
+	bool isEmptyOrSolid(const DensityGrid& points) const;
 	
 	/**
 	 * Calculate the normal for the provided point.
 	 */
-	glm::vec3 calculateNormal(const glm::vec3& point, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, Points& densityValues) const;
+	glm::vec3 calculateNormal(const glm::vec3& point, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, DensityGrid& densityValues) const;
 	
 	/**
 	 * Generate the 3 points for a triangle along the y coordinate (will move along the xz plane at point y).  Will generate
 	 * up to 3 points per block.
 	 */
-	void generateTriangles(Blocks& blocks, const Points& points, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, glmd::int32 y) const;
+	void generateTriangles(Blocks& blocks, const DensityGrid& points, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, glmd::int32 y) const;
+	
+	/**
+	 * Generate the indexed triangles for the cubes along the xz plane at point y.  Vertices are looked up in (or added to) the edge cache, so
+	 * that a vertex is only generated once for each edge.
+	 */
+	void generateIndexedTriangles(const DensityGrid& points, const glm::vec3& origin, glmd::float32 spacing, EdgeCache& edgeCache, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, std::vector<glm::detail::uint32>& indices, glmd::int32 y) const;
+	
+	/**
+	 * Returns the index of the vertex on the edge starting at grid point (x, y, z) and going along the given axis (0 = x, 1 = y, 2 = z).  If
+	 * the vertex has not been generated yet, it is generated and added to the edge cache.
+	 */
+	glm::detail::uint32 getEdgeVertex(const DensityGrid& points, const glm::vec3& origin, glmd::float32 spacing, EdgeCache& edgeCache, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, glmd::int32 x, glmd::int32 y, glmd::int32 z, glmd::int32 axis) const;
+	
+	/**
+	 * Adds a 'skirt' below every edge of the mesh that lies on a face of the chunk (i.e. the box from min to max).  A skirt is a strip of
+	 * triangles that hangs depth units into the surface (along the negative vertex normals).  Where a neighbouring chunk was meshed at a
+	 * different level of detail, the two surfaces don't quite meet along the shared face - the skirts fill in the gap.
+	 */
+	void generateSkirts(const glm::vec3& min, const glm::vec3& max, glmd::float32 depth, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, std::vector<glm::detail::uint32>& indices) const;
+	
+	/**
+	 * Calculate the world position of the density grid point at local coordinates (0, 0, 0).
+	 */
+	glm::vec3 getOrigin(const glm::ivec3& gridCoords, const glm::ivec3& dimensions) const;
+	
+	/**
+	 * Calculate the texture blending values for the provided normals.
+	 */
+	void calculateTextureBlendingValues(const std::vector<glm::vec3>& normals, std::vector<glm::vec4>& textureBlendingValues) const;
 	
 	/**
 	 * Set the densities and positions for the blocks, using the provided points (density values) and the grid coordinates.
 	 */
-	void setDensitiesAndPositions(Blocks& blocks, const Points& points, const glm::ivec3& gridCoords, const glm::ivec3& dimensions) const;
+	void setDensitiesAndPositions(Blocks& blocks, const DensityGrid& points, const glm::ivec3& gridCoords, const glm::ivec3& dimensions) const;
 	
 	/**
 	 * Will resize the provided Blocks 3D vector to the appropriate size.
@@ -23,7 +23,7 @@ namespace glr
 
 BasicSceneManager::BasicSceneManager(shaders::IShaderProgramManager* shaderProgramManager, glw::IOpenGlDevice* openGlDevice, 
 	models::IModelManager* modelManager, models::IBillboardManager* billboardManager) 
-	: shaderProgramManager_(shaderProgramManager), openGlDevice_(openGlDevice), modelManager_(modelManager), billboardManager_(billboardManager)
+	: shaderProgramManager_(shaderProgramManager), openGlDevice_(openGlDevice), renderQueue_(openGlDevice), modelManager_(modelManager), billboardManager_(billboardManager)
 {
 	modelMatrix_ = glm::scale(glm::mat4(1.0f), glm::vec3(0.5f));
 
@@ -35,6 +35,20 @@ BasicSceneManager::BasicSceneManager(shaders::IShaderProgramManager* shaderProgr
 	
 	terrainManager_ = std::unique_ptr< terrain::ITerrainManager >();
 	environmentManager_ = std::unique_ptr< env::IEnvironmentManager >();
+	
+	// Unanimated scene nodes using the basic shader programs are drawn with instanced draw calls where they can be
+	shaders::IShaderProgram* instancedShaderProgram = shaderProgramManager_->getShaderProgram( std::string("glr_basic_instanced") );
+	
+	if (instancedShaderProgram != nullptr)
+	{
+		for ( const auto& name : { std::string("glr_basic"), std::string("glr_basic_static") } )
+		{
+			shaders::IShaderProgram* shaderProgram = shaderProgramManager_->getShaderProgram( name );
+			
+			if (shaderProgram != nullptr)
+				renderQueue_.setInstancedShaderProgram( shaderProgram, instancedShaderProgram );
+		}
+	}
 }
 
 BasicSceneManager::~BasicSceneManager()
@@ -44,6 +58,8 @@ BasicSceneManager::~BasicSceneManager()
 ISceneNode* BasicSceneManager::createSceneNode(const std::string& name)
 {
 	sceneNodes_.push_back( std::unique_ptr<ISceneNode>(new BasicSceneNode(idManager_.createId(), name, openGlDevice_)) );
+	// The scene node is added to the bounding volume hierarchy once it has a bounding box
+	sceneNodeProxies_.push_back( BoundingVolumeHierarchy::NULL_PROXY );
 	
 	auto node = sceneNodes_.back().get();
 	node->attach(defaultShaderProgram_);
@@ -93,8 +109,38 @@ void BasicSceneManager::drawAll()
 	if (terrainManager_.get() != nullptr)
 		terrainManager_->render();
 
-	for ( auto& node : sceneNodes_ )
-		node->render();
+	// Queue the scene nodes, so that nodes sharing shader programs, textures and materials can be drawn together
+	renderQueue_.clear();
+	
+	// Scene nodes are only reinserted into the bounding volume hierarchy when they move outside of their fat bounding box
+	for ( glmd::uint32 i = 0; i < sceneNodes_.size(); i++ )
+	{
+		ISceneNode* node = sceneNodes_[i].get();
+		sceneNodeProxies_[i] = sceneNodeHierarchy_.synchronize( sceneNodeProxies_[i], node->getBoundingBox(), node );
+		
+		// Scene nodes without a bounding box can't be culled
+		if (sceneNodeProxies_[i] == BoundingVolumeHierarchy::NULL_PROXY)
+			node->queue( renderQueue_ );
+	}
+	
+	// Only the scene nodes inside of the camera's view frustum are queued
+	const Frustum frustum = Frustum( openGlDevice_->getProjectionMatrix() * openGlDevice_->getViewMatrix() );
+	
+	cullingStatistics_ = sceneNodeHierarchy_.query( frustum, [this](void* node) { static_cast<ISceneNode*>(node)->queue( renderQueue_ ); } );
+	cullingStatistics_.visible += sceneNodes_.size() - sceneNodeHierarchy_.getNumberOfProxies();
+	
+	renderQueue_.sort();
+	renderQueue_.submit();
+}
+
+const RenderStatistics& BasicSceneManager::getRenderStatistics() const
+{
+	return renderQueue_.getStatistics();
+}
+
+const CullingStatistics& BasicSceneManager::getCullingStatistics() const
+{
+	return cullingStatistics_;
 }
 
 void BasicSceneManager::setCamera(std::unique_ptr<ICamera> camera)
@@ -204,7 +250,7 @@ void BasicSceneManager::destroySceneNode(Id id)
 	auto it = std::find_if(sceneNodes_.begin(), sceneNodes_.end(), findFunction);
 	
 	if (it != sceneNodes_.end())
-		sceneNodes_.erase( it );
+		eraseSceneNode( it - sceneNodes_.begin() );
 }
 
 void BasicSceneManager::destroySceneNode(const std::string& name)
@@ -214,7 +260,7 @@ void BasicSceneManager::destroySceneNode(const std::string& name)
 	auto it = std::find_if(sceneNodes_.begin(), sceneNodes_.end(), findFunction);
 	
 	if (it != sceneNodes_.end())
-		sceneNodes_.erase( it );
+		eraseSceneNode( it - sceneNodes_.begin() );
 }
 
 void BasicSceneManager::destroySceneNode(ISceneNode* node)
@@ -224,12 +270,23 @@ void BasicSceneManager::destroySceneNode(ISceneNode* node)
 	auto it = std::find_if(sceneNodes_.begin(), sceneNodes_.end(), findFunction);
 	
 	if (it != sceneNodes_.end())
-		sceneNodes_.erase( it );
+		eraseSceneNode( it - sceneNodes_.begin() );
+}
+
+void BasicSceneManager::eraseSceneNode(glmd::uint32 index)
+{
+	if (sceneNodeProxies_[index] != BoundingVolumeHierarchy::NULL_PROXY)
+		sceneNodeHierarchy_.remove( sceneNodeProxies_[index] );
+	
+	sceneNodeProxies_.erase( sceneNodeProxies_.begin() + index );
+	sceneNodes_.erase( sceneNodes_.begin() + index );
 }
 
 void BasicSceneManager::destroyAllSceneNodes()
 {
 	sceneNodes_.clear();
+	sceneNodeProxies_.clear();
+	sceneNodeHierarchy_.clear();
 }
 
 void BasicSceneManager::destroyCamera()
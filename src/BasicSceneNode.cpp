@@ -14,6 +14,7 @@
 #include "common/logger/Logger.hpp"
 
 #include "BasicSceneNode.hpp"
+#include "RenderQueue.hpp"
 
 #include "glw/shaders/GlslShaderProgram.hpp"
 #include "exceptions/Exception.hpp"
@@ -230,30 +231,53 @@ void BasicSceneNode::render()
 			//GLint bindPoint = shaderProgram_->getBindPointByBindingName( shaders::IShader::BIND_TYPE_MATERIAL );
 			shaderProgram_->bind();
 
-			int modelMatrixLocation = glGetUniformLocation(shaderProgram_->getGLShaderProgramId(), "modelMatrix");
-			int pvmMatrixLocation = glGetUniformLocation(shaderProgram_->getGLShaderProgramId(), "pvmMatrix");
-			int normalMatrixLocation = glGetUniformLocation(shaderProgram_->getGLShaderProgramId(), "normalMatrix");
+			shaders::UniformHandle modelMatrixHandle = shaderProgram_->getUniformHandle(shaders::UNIFORM_MODEL_MATRIX);
+			shaders::UniformHandle pvmMatrixHandle = shaderProgram_->getUniformHandle(shaders::UNIFORM_PVM_MATRIX);
+			shaders::UniformHandle normalMatrixHandle = shaderProgram_->getUniformHandle(shaders::UNIFORM_NORMAL_MATRIX);
 
-			const glm::mat4 modelMatrix = openGlDevice_->getModelMatrix();
 			const glm::mat4 projectionMatrix = openGlDevice_->getProjectionMatrix();
 			const glm::mat4 viewMatrix = openGlDevice_->getViewMatrix();
 			
-			glm::mat4 newModel = glm::translate(modelMatrix, pos_);
-			newModel = newModel * glm::mat4_cast( orientationQuaternion_ );
-			newModel = glm::scale(newModel, scale_);
+			const glm::mat4 newModel = calculateModelMatrix();
 
 			// Send uniform variable values to the shader		
 			glm::mat4 pvmMatrix(projectionMatrix * viewMatrix * newModel);
-			glUniformMatrix4fv(pvmMatrixLocation, 1, GL_FALSE, &pvmMatrix[0][0]);
+			shaderProgram_->setUniform(pvmMatrixHandle, pvmMatrix);
 
 			glm::mat3 normalMatrix = glm::inverse(glm::transpose(glm::mat3(viewMatrix * newModel)));
-			glUniformMatrix3fv(normalMatrixLocation, 1, GL_FALSE, &normalMatrix[0][0]);
+			shaderProgram_->setUniform(normalMatrixHandle, normalMatrix);
 
-			glUniformMatrix4fv(modelMatrixLocation, 1, GL_FALSE, &newModel[0][0]);
+			shaderProgram_->setUniform(modelMatrixHandle, newModel);
 			
 			renderable_->render(*shaderProgram_);
 		}
 	}
 }
 
+void BasicSceneNode::queue(RenderQueue& renderQueue)
+{
+	if ( renderable_ != nullptr && shaderProgram_ != nullptr )
+	{
+		renderable_->queue( renderQueue, *shaderProgram_, calculateModelMatrix() );
+	}
+}
+
+glw::BoundingBox BasicSceneNode::getBoundingBox() const
+{
+	if ( renderable_ == nullptr )
+	{
+		return glw::BoundingBox();
+	}
+	
+	return renderable_->getBoundingBox().transform( calculateModelMatrix() );
+}
+
+glm::mat4 BasicSceneNode::calculateModelMatrix() const
+{
+	glm::mat4 modelMatrix = glm::translate(openGlDevice_->getModelMatrix(), pos_);
+	modelMatrix = modelMatrix * glm::mat4_cast( orientationQuaternion_ );
+	
+	return glm::scale(modelMatrix, scale_);
+}
+
 }
@@ -0,0 +1,364 @@
+#include <algorithm>
+#include <cassert>
+
+#include "BoundingVolumeHierarchy.hpp"
+
+namespace glr
+{
+
+/** Anonymous helper functions. */
+namespace
+{
+
+glw::BoundingBox combine(const glw::BoundingBox& a, const glw::BoundingBox& b)
+{
+	glw::BoundingBox box = a;
+	box.expand( b );
+	
+	return box;
+}
+
+}
+
+const glmd::int32 BoundingVolumeHierarchy::NULL_PROXY;
+const glmd::int32 BoundingVolumeHierarchy::NULL_NODE;
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(glmd::float32 margin) : margin_(margin)
+{
+	clear();
+}
+
+void BoundingVolumeHierarchy::clear()
+{
+	nodes_.clear();
+	root_ = NULL_NODE;
+	freeList_ = NULL_NODE;
+	numberOfProxies_ = 0;
+}
+
+glmd::int32 BoundingVolumeHierarchy::allocateNode()
+{
+	if (freeList_ == NULL_NODE)
+	{
+		nodes_.push_back( Node() );
+		nodes_.back().parent = NULL_NODE;
+		freeList_ = (glmd::int32) nodes_.size() - 1;
+	}
+	
+	const glmd::int32 node = freeList_;
+	freeList_ = nodes_[node].parent;
+	
+	nodes_[node].box = glw::BoundingBox();
+	nodes_[node].userData = nullptr;
+	nodes_[node].parent = NULL_NODE;
+	nodes_[node].child1 = NULL_NODE;
+	nodes_[node].child2 = NULL_NODE;
+	nodes_[node].height = 0;
+	
+	return node;
+}
+
+void BoundingVolumeHierarchy::freeNode(glmd::int32 node)
+{
+	nodes_[node].parent = freeList_;
+	nodes_[node].height = -1;
+	freeList_ = node;
+}
+
+glmd::int32 BoundingVolumeHierarchy::insert(const glw::BoundingBox& box, void* userData)
+{
+	assert( !box.isEmpty() );
+	
+	const glmd::int32 proxy = allocateNode();
+	
+	const glm::vec3 margin = glm::vec3( margin_ );
+	nodes_[proxy].box = glw::BoundingBox( box.min - margin, box.max + margin );
+	nodes_[proxy].userData = userData;
+	
+	insertLeaf( proxy );
+	numberOfProxies_++;
+	
+	return proxy;
+}
+
+void BoundingVolumeHierarchy::remove(glmd::int32 proxy)
+{
+	assert( proxy >= 0 && proxy < (glmd::int32) nodes_.size() && nodes_[proxy].isLeaf() );
+	
+	removeLeaf( proxy );
+	freeNode( proxy );
+	numberOfProxies_--;
+}
+
+bool BoundingVolumeHierarchy::update(glmd::int32 proxy, const glw::BoundingBox& box)
+{
+	assert( proxy >= 0 && proxy < (glmd::int32) nodes_.size() && nodes_[proxy].isLeaf() );
+	
+	if ( nodes_[proxy].box.contains(box) )
+	{
+		return false;
+	}
+	
+	removeLeaf( proxy );
+	
+	const glm::vec3 margin = glm::vec3( margin_ );
+	nodes_[proxy].box = glw::BoundingBox( box.min - margin, box.max + margin );
+	
+	insertLeaf( proxy );
+	
+	return true;
+}
+
+glmd::int32 BoundingVolumeHierarchy::synchronize(glmd::int32 proxy, const glw::BoundingBox& box, void* userData)
+{
+	if (box.isEmpty())
+	{
+		if (proxy != NULL_PROXY)
+		{
+			remove( proxy );
+		}
+		
+		return NULL_PROXY;
+	}
+	
+	if (proxy == NULL_PROXY)
+	{
+		return insert( box, userData );
+	}
+	
+	nodes_[proxy].userData = userData;
+	update( proxy, box );
+	
+	return proxy;
+}
+
+void* BoundingVolumeHierarchy::getUserData(glmd::int32 proxy) const
+{
+	return nodes_[proxy].userData;
+}
+
+const glw::BoundingBox& BoundingVolumeHierarchy::getFatBoundingBox(glmd::int32 proxy) const
+{
+	return nodes_[proxy].box;
+}
+
+glmd::uint32 BoundingVolumeHierarchy::getNumberOfProxies() const
+{
+	return numberOfProxies_;
+}
+
+glmd::uint32 BoundingVolumeHierarchy::getHeight() const
+{
+	if (root_ == NULL_NODE)
+	{
+		return 0;
+	}
+	
+	return (glmd::uint32) nodes_[root_].height + 1;
+}
+
+void BoundingVolumeHierarchy::insertLeaf(glmd::int32 leaf)
+{
+	if (root_ == NULL_NODE)
+	{
+		root_ = leaf;
+		nodes_[root_].parent = NULL_NODE;
+		return;
+	}
+	
+	// Find the best sibling for the leaf - walk down the tree, choosing the child that increases the surface area the least, until it's
+	// cheaper to make the leaf a sibling of the current node than to descend any further
+	const glw::BoundingBox leafBox = nodes_[leaf].box;
+	glmd::int32 index = root_;
+	
+	while ( !nodes_[index].isLeaf() )
+	{
+		const glmd::int32 child1 = nodes_[index].child1;
+		const glmd::int32 child2 = nodes_[index].child2;
+		
+		const glmd::float32 area = nodes_[index].box.getSurfaceArea();
+		const glmd::float32 combinedArea = combine(nodes_[index].box, leafBox).getSurfaceArea();
+		
+		// The cost of creating a new parent for this node and the leaf
+		const glmd::float32 cost = 2.0f * combinedArea;
+		
+		// The minimum cost of pushing the leaf further down the tree
+		const glmd::float32 inheritanceCost = 2.0f * (combinedArea - area);
+		
+		glmd::float32 costs[2];
+		const glmd::int32 children[2] = { child1, child2 };
+		
+		for ( glmd::uint32 i = 0; i < 2; i++ )
+		{
+			const glw::BoundingBox box = combine(leafBox, nodes_[ children[i] ].box);
+			
+			if ( nodes_[ children[i] ].isLeaf() )
+			{
+				costs[i] = box.getSurfaceArea() + inheritanceCost;
+			}
+			else
+			{
+				costs[i] = (box.getSurfaceArea() - nodes_[ children[i] ].box.getSurfaceArea()) + inheritanceCost;
+			}
+		}
+		
+		if (cost < costs[0] && cost < costs[1])
+		{
+			break;
+		}
+		
+		index = (costs[0] < costs[1] ? child1 : child2);
+	}
+	
+	const glmd::int32 sibling = index;
+	
+	// Create a new parent for the leaf and its sibling
+	const glmd::int32 oldParent = nodes_[sibling].parent;
+	const glmd::int32 newParent = allocateNode();
+	nodes_[newParent].parent = oldParent;
+	nodes_[newParent].box = combine(leafBox, nodes_[sibling].box);
+	nodes_[newParent].height = nodes_[sibling].height + 1;
+	nodes_[newParent].child1 = sibling;
+	nodes_[newParent].child2 = leaf;
+	nodes_[sibling].parent = newParent;
+	nodes_[leaf].parent = newParent;
+	
+	if (oldParent == NULL_NODE)
+	{
+		root_ = newParent;
+	}
+	else if (nodes_[oldParent].child1 == sibling)
+	{
+		nodes_[oldParent].child1 = newParent;
+	}
+	else
+	{
+		nodes_[oldParent].child2 = newParent;
+	}
+	
+	refit( nodes_[leaf].parent );
+}
+
+void BoundingVolumeHierarchy::removeLeaf(glmd::int32 leaf)
+{
+	if (leaf == root_)
+	{
+		root_ = NULL_NODE;
+		return;
+	}
+	
+	// Replace the leaf's parent with the leaf's sibling
+	const glmd::int32 parent = nodes_[leaf].parent;
+	const glmd::int32 grandParent = nodes_[parent].parent;
+	const glmd::int32 sibling = (nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1);
+	
+	if (grandParent == NULL_NODE)
+	{
+		root_ = sibling;
+		nodes_[sibling].parent = NULL_NODE;
+		freeNode( parent );
+		return;
+	}
+	
+	if (nodes_[grandParent].child1 == parent)
+	{
+		nodes_[grandParent].child1 = sibling;
+	}
+	else
+	{
+		nodes_[grandParent].child2 = sibling;
+	}
+	
+	nodes_[sibling].parent = grandParent;
+	freeNode( parent );
+	
+	refit( grandParent );
+}
+
+void BoundingVolumeHierarchy::refit(glmd::int32 node)
+{
+	glmd::int32 index = node;
+	
+	while (index != NULL_NODE)
+	{
+		index = balance( index );
+		
+		const glmd::int32 child1 = nodes_[index].child1;
+		const glmd::int32 child2 = nodes_[index].child2;
+		
+		nodes_[index].height = 1 + std::max( nodes_[child1].height, nodes_[child2].height );
+		nodes_[index].box = combine( nodes_[child1].box, nodes_[child2].box );
+		
+		index = nodes_[index].parent;
+	}
+}
+
+glmd::int32 BoundingVolumeHierarchy::balance(glmd::int32 a)
+{
+	if (nodes_[a].isLeaf() || nodes_[a].height < 2)
+	{
+		return a;
+	}
+	
+	const glmd::int32 b = nodes_[a].child1;
+	const glmd::int32 c = nodes_[a].child2;
+	const glmd::int32 difference = nodes_[c].height - nodes_[b].height;
+	
+	if (difference >= -1 && difference <= 1)
+	{
+		return a;
+	}
+	
+	// Rotate the taller child (up) into a's position, and a down into its place
+	const glmd::int32 up = (difference > 1 ? c : b);
+	const glmd::int32 other = (difference > 1 ? b : c);
+	
+	const glmd::int32 f = nodes_[up].child1;
+	const glmd::int32 g = nodes_[up].child2;
+	
+	nodes_[up].child1 = a;
+	nodes_[up].parent = nodes_[a].parent;
+	nodes_[a].parent = up;
+	
+	if (nodes_[up].parent == NULL_NODE)
+	{
+		root_ = up;
+	}
+	else if (nodes_[ nodes_[up].parent ].child1 == a)
+	{
+		nodes_[ nodes_[up].parent ].child1 = up;
+	}
+	else
+	{
+		nodes_[ nodes_[up].parent ].child2 = up;
+	}
+	
+	// a keeps its shorter child, and takes the shorter of up's children - up keeps the taller one
+	const glmd::int32 taller = (nodes_[f].height > nodes_[g].height ? f : g);
+	const glmd::int32 shorter = (taller == f ? g : f);
+	
+	nodes_[up].child2 = taller;
+	
+	if (difference > 1)
+	{
+		nodes_[a].child1 = other;
+		nodes_[a].child2 = shorter;
+	}
+	else
+	{
+		nodes_[a].child1 = shorter;
+		nodes_[a].child2 = other;
+	}
+	
+	nodes_[shorter].parent = a;
+	
+	nodes_[a].box = combine( nodes_[ nodes_[a].child1 ].box, nodes_[ nodes_[a].child2 ].box );
+	nodes_[a].height = 1 + std::max( nodes_[ nodes_[a].child1 ].height, nodes_[ nodes_[a].child2 ].height );
+	
+	nodes_[up].box = combine( nodes_[a].box, nodes_[taller].box );
+	nodes_[up].height = 1 + std::max( nodes_[a].height, nodes_[taller].height );
+	
+	return up;
+}
+
+}
@@ -0,0 +1,142 @@
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define GLR_FRUSTUM_SSE
+#include <emmintrin.h>
+#endif
+
+#include "Frustum.hpp"
+
+namespace glr
+{
+
+Frustum::Frustum()
+{
+	// Every point is in front of a plane with a zero normal and a positive distance
+	for ( glmd::uint32 i = 0; i < NUMBER_OF_PLANES; i++ )
+	{
+		setPlane( i, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f) );
+	}
+}
+
+Frustum::Frustum(const glm::mat4& projectionViewMatrix) : Frustum()
+{
+	setProjectionViewMatrix( projectionViewMatrix );
+}
+
+void Frustum::setProjectionViewMatrix(const glm::mat4& projectionViewMatrix)
+{
+	const glm::mat4& m = projectionViewMatrix;
+	
+	// glm matrices are column major - row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+	const glm::vec4 row0 = glm::vec4( m[0][0], m[1][0], m[2][0], m[3][0] );
+	const glm::vec4 row1 = glm::vec4( m[0][1], m[1][1], m[2][1], m[3][1] );
+	const glm::vec4 row2 = glm::vec4( m[0][2], m[1][2], m[2][2], m[3][2] );
+	const glm::vec4 row3 = glm::vec4( m[0][3], m[1][3], m[2][3], m[3][3] );
+	
+	setPlane( 0, row3 + row0 );
+	setPlane( 1, row3 - row0 );
+	setPlane( 2, row3 + row1 );
+	setPlane( 3, row3 - row1 );
+	setPlane( 4, row3 + row2 );
+	setPlane( 5, row3 - row2 );
+}
+
+void Frustum::setPlane(glmd::uint32 i, const glm::vec4& plane)
+{
+	glmd::float32 length = std::sqrt( plane.x * plane.x + plane.y * plane.y + plane.z * plane.z );
+	
+	if (length == 0.0f)
+	{
+		length = 1.0f;
+	}
+	
+	planeX_[i] = plane.x / length;
+	planeY_[i] = plane.y / length;
+	planeZ_[i] = plane.z / length;
+	planeW_[i] = plane.w / length;
+}
+
+glm::vec4 Frustum::getPlane(glmd::uint32 i) const
+{
+	return glm::vec4( planeX_[i], planeY_[i], planeZ_[i], planeW_[i] );
+}
+
+Frustum::Intersection Frustum::intersect(const glw::BoundingBox& box) const
+{
+	if (box.isEmpty())
+	{
+		return INTERSECTION_INTERSECTS;
+	}
+	
+	const glm::vec3 center = box.getCenter();
+	const glm::vec3 extents = box.getExtents();
+	
+	// For each plane, the distance from the plane to the center of the box (d), and the furthest any corner of the box is from its center
+	// along the plane's normal (r).  If d + r < 0, the whole box is behind the plane; if d - r < 0, part of it is.
+#ifdef GLR_FRUSTUM_SSE
+	const __m128 signMask = _mm_set1_ps( -0.0f );
+	
+	const __m128 cx = _mm_set1_ps( center.x );
+	const __m128 cy = _mm_set1_ps( center.y );
+	const __m128 cz = _mm_set1_ps( center.z );
+	const __m128 ex = _mm_set1_ps( extents.x );
+	const __m128 ey = _mm_set1_ps( extents.y );
+	const __m128 ez = _mm_set1_ps( extents.z );
+	
+	int outside = 0;
+	int intersects = 0;
+	
+	for ( glmd::uint32 i = 0; i < NUMBER_OF_PLANES; i += 4 )
+	{
+		const __m128 nx = _mm_load_ps( &planeX_[i] );
+		const __m128 ny = _mm_load_ps( &planeY_[i] );
+		const __m128 nz = _mm_load_ps( &planeZ_[i] );
+		const __m128 nw = _mm_load_ps( &planeW_[i] );
+		
+		const __m128 d = _mm_add_ps( _mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)), _mm_add_ps(_mm_mul_ps(nz, cz), nw) );
+		
+		const __m128 r = _mm_add_ps(
+			_mm_add_ps( _mm_mul_ps(_mm_andnot_ps(signMask, nx), ex), _mm_mul_ps(_mm_andnot_ps(signMask, ny), ey) ),
+			_mm_mul_ps( _mm_andnot_ps(signMask, nz), ez )
+		);
+		
+		outside |= _mm_movemask_ps( _mm_cmplt_ps(_mm_add_ps(d, r), _mm_setzero_ps()) );
+		intersects |= _mm_movemask_ps( _mm_cmplt_ps(_mm_sub_ps(d, r), _mm_setzero_ps()) );
+	}
+	
+	if (outside != 0)
+	{
+		return INTERSECTION_OUTSIDE;
+	}
+	
+	return (intersects != 0 ? INTERSECTION_INTERSECTS : INTERSECTION_INSIDE);
+#else
+	Intersection result = INTERSECTION_INSIDE;
+	
+	for ( glmd::uint32 i = 0; i < NUMBER_OF_PLANES; i++ )
+	{
+		const glmd::float32 d = planeX_[i] * center.x + planeY_[i] * center.y + planeZ_[i] * center.z + planeW_[i];
+		const glmd::float32 r = std::abs(planeX_[i]) * extents.x + std::abs(planeY_[i]) * extents.y + std::abs(planeZ_[i]) * extents.z;
+		
+		if (d + r < 0.0f)
+		{
+			return INTERSECTION_OUTSIDE;
+		}
+		
+		if (d - r < 0.0f)
+		{
+			result = INTERSECTION_INTERSECTS;
+		}
+	}
+	
+	return result;
+#endif
+}
+
+bool Frustum::isVisible(const glw::BoundingBox& box) const
+{
+	return (intersect(box) != INTERSECTION_OUTSIDE);
+}
+
+}
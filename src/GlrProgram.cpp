@@ -63,6 +63,13 @@ void GlrProgram::initializeProperties(ProgramSettings settings)
 	{
 		settings_.defaultTextureDir = settings.defaultTextureDir;
 	}
+	
+	if ( !settings.modelCacheDir.empty() )
+	{
+		settings_.modelCacheDir = settings.modelCacheDir;
+	}
+	
+	settings_.animationCompression = settings.animationCompression;
 }
 
 /**
@@ -97,6 +104,9 @@ IWindow* GlrProgram::createWindow(std::string name, std::string title,
 	glr::glw::OpenGlDeviceSettings settings = glr::glw::OpenGlDeviceSettings();
 	if ( !settings_.defaultTextureDir.empty() )
 		settings.defaultTextureDir = settings_.defaultTextureDir;
+	if ( !settings_.modelCacheDir.empty() )
+		settings.modelCacheDir = settings_.modelCacheDir;
+	settings.animationCompression = settings_.animationCompression;
 	openGlDevice_ = std::unique_ptr< glw::OpenGlDevice >( new glw::OpenGlDevice(settings) );
 	
 	modelManager_ = std::unique_ptr<models::IModelManager>(new models::ModelManager(openGlDevice_.get()));
@@ -160,6 +170,9 @@ void GlrProgram::endRender()
 {
 	glDisable(GL_BLEND);
 	
+	// All of the draw calls for this frame have been issued - anything streamed this frame is now in use by the GPU
+	openGlDevice_->endFrame();
+	
 	// Display any changes we've made
 	window_->render();
 }
@@ -177,7 +190,13 @@ void GlrProgram::render()
 	}
 	openGlDevice_->setProjectionMatrix( window_->getProjectionMatrix() );
 
-	//setupUniformBufferObjectBindings(shader);
+	// Finish (a frame's worth of) the models being loaded in the background
+	modelManager_->update();
+	
+	// Calculate the poses of the animated models on all of the cores, rather than one at a time as they are drawn.  The animation times
+	// aren't changed - the application advances them (see IAnimationManager::update())
+	openGlDevice_->getAnimationManager()->update( 0.0f );
+	
 	//bindUniformBufferObjects(shader);
 	sMgr_->drawAll();
 	
@@ -203,34 +222,13 @@ void GlrProgram::bindUniformBufferObjects(shaders::IShaderProgram* shader)
 
 	if ( lightData.size() > 0 )
 	{
-		if (numLights_ != lightData.size())
+		GLint bindPoint = shader->getBindPointByBindingName( shaders::IShader::BIND_TYPE_LIGHT );
+		if ( bindPoint >= 0 )
 		{
-			if (lightUbos_.begin() != lightUbos_.end())
-			{
-				releaseLightUbo(lightUbos_.begin()->first);
-			}
-			setupUniformBufferObjectBindings(shader);
-		}
-		
-		numLights_ = lightData.size();
-		
-		for ( auto it = lightUbos_.begin(); it != lightUbos_.end(); ++it )
-		{
-			std::vector<GLuint> ubos = it->second;
-			for ( auto ubo : ubos )
-			{
-				GLint bindPoint = shader->getBindPointByBindingName( shaders::IShader::BIND_TYPE_LIGHT );
-				if ( bindPoint >= 0 )
-				{
-					glBindBuffer(GL_UNIFORM_BUFFER, ubo);
-					glBufferSubData(GL_UNIFORM_BUFFER, 0, lightData.size() * sizeof(LightData), &lightData[0]);
-				
-					openGlDevice_->bindBuffer( ubo, bindPoint );
-				}
-				
-				//GLuint bindPoint = openGlDevice_->bindBuffer( ubo );
-				//shader->bindVariableByBindingName(shaders::IShader::BIND_TYPE_LIGHT, bindPoint);
-			}
+			// The lights are streamed every time a shader is bound, so each shader gets its own range of the streaming buffer
+			glw::StreamingBufferRange range = openGlDevice_->streamUniformData( &lightData[0], lightData.size() * sizeof(LightData) );
+			
+			openGlDevice_->bindBuffer( range, bindPoint );
 		}
 	}
 
@@ -239,12 +237,12 @@ void GlrProgram::bindUniformBufferObjects(shaders::IShaderProgram* shader)
 	// TODO: bind number of lights, etc (We'll want to let the GLSL shader know how many lights to
 	// iterate through - we don't want it to use garbage data
 
-	// Get uniform variable locations
-	int projectionMatrixLocation = glGetUniformLocation(shader->getGLShaderProgramId(), "projectionMatrix");
-	int viewMatrixLocation = glGetUniformLocation(shader->getGLShaderProgramId(), "viewMatrix");
-	int modelMatrixLocation = glGetUniformLocation(shader->getGLShaderProgramId(), "modelMatrix");
-	int pvmMatrixLocation = glGetUniformLocation(shader->getGLShaderProgramId(), "pvmMatrix");
-	int normalMatrixLocation = glGetUniformLocation(shader->getGLShaderProgramId(), "normalMatrix");
+	// Get uniform variable handles
+	shaders::UniformHandle projectionMatrixHandle = shader->getUniformHandle(shaders::UNIFORM_PROJECTION_MATRIX);
+	shaders::UniformHandle viewMatrixHandle = shader->getUniformHandle(shaders::UNIFORM_VIEW_MATRIX);
+	shaders::UniformHandle modelMatrixHandle = shader->getUniformHandle(shaders::UNIFORM_MODEL_MATRIX);
+	shaders::UniformHandle pvmMatrixHandle = shader->getUniformHandle(shaders::UNIFORM_PVM_MATRIX);
+	shaders::UniformHandle normalMatrixHandle = shader->getUniformHandle(shaders::UNIFORM_NORMAL_MATRIX);
 
 	glm::mat4 modelMatrix = sMgr_->getModelMatrix();
 	glm::mat4 projectionMatrix = window_->getProjectionMatrix();
@@ -254,62 +252,17 @@ void GlrProgram::bindUniformBufferObjects(shaders::IShaderProgram* shader)
 	{
 		const glm::mat4 viewMatrix = camera->getViewMatrix();
 		// Send uniform variable values to the shader
-		glUniformMatrix4fv(viewMatrixLocation, 1, GL_FALSE, &viewMatrix[0][0]);
+		shader->setUniform(viewMatrixHandle, viewMatrix);
 
 		glm::mat4 pvmMatrix(projectionMatrix * viewMatrix * modelMatrix);
-		glUniformMatrix4fv(pvmMatrixLocation, 1, GL_FALSE, &pvmMatrix[0][0]);
+		shader->setUniform(pvmMatrixHandle, pvmMatrix);
 
 		glm::mat3 normalMatrix = glm::inverse(glm::transpose(glm::mat3(viewMatrix * modelMatrix)));
-		glUniformMatrix3fv(normalMatrixLocation, 1, GL_FALSE, &normalMatrix[0][0]);
-	}
-
-	glUniformMatrix4fv(projectionMatrixLocation, 1, GL_FALSE, &projectionMatrix[0][0]);
-	glUniformMatrix4fv(modelMatrixLocation, 1, GL_FALSE, &modelMatrix[0][0]);
-}
-
-void GlrProgram::setupUniformBufferObjectBindings(shaders::IShaderProgram* shader)
-{
-	shaders::IShader::BindingsMap bindings = shader->getBindings();
-	
-	for ( auto& b : bindings )
-	{
-		//std::cout << "'" << it->second << "' annotated with name '" << it->first << "'\n";
-
-		switch ( b.type )
-		{
-		case shaders::IShader::BIND_TYPE_LIGHT:
-			if ( lightUbos_.find(b.variableName) == lightUbos_.end())
-				setupLightUbo(b.variableName, shader);
-			break;
-
-		// TODO: implement other bindings (materials, etc)
-
-		default:
-			break;
-		}
+		shader->setUniform(normalMatrixHandle, normalMatrix);
 	}
-}
 
-void GlrProgram::setupLightUbo(std::string name, shaders::IShaderProgram* shader)
-{
-	// TODO: Will we want to add multiple Ubos in a single shader for light sources
-	
-	const std::vector<LightData> lightData = sMgr_->getLightData();
-
-	lightUbos_[name] = std::vector<GLuint>();
-	lightUbos_[name].push_back(0);
-
-	lightUbos_[name][0] = openGlDevice_->createBufferObject(GL_UNIFORM_BUFFER, lightData.size() * sizeof(LightData), &lightData[0]);
-}
-
-void GlrProgram::releaseLightUbo(std::string name)
-{
-	if (lightUbos_.find(name) == lightUbos_.end())
-		return;
-	
-	glDeleteBuffers(1, &lightUbos_[name][0]);
-	
-	lightUbos_.erase(name);
+	shader->setUniform(projectionMatrixHandle, projectionMatrix);
+	shader->setUniform(modelMatrixHandle, modelMatrix);
 }
 
 ISceneManager* GlrProgram::getSceneManager()
@@ -350,7 +303,6 @@ models::IModelManager* GlrProgram::getModelManager() const
 
 void GlrProgram::shaderBindCallback(shaders::IShaderProgram* shader)
 {
-	setupUniformBufferObjectBindings(shader);
 	bindUniformBufferObjects(shader);
 }
 
@@ -0,0 +1,171 @@
+#include "Configure.hpp"
+
+#ifdef OS_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "MappedFile.hpp"
+
+#include "exceptions/IoException.hpp"
+
+#include "common/logger/Logger.hpp"
+
+namespace glr
+{
+
+MappedFile::MappedFile(const std::string& filename)
+	: filename_(filename), data_(nullptr), size_(0), fileHandle_(nullptr), mappingHandle_(nullptr)
+{
+	map();
+}
+
+MappedFile::~MappedFile()
+{
+	unmap();
+}
+
+const std::string& MappedFile::getFilename() const
+{
+	return filename_;
+}
+
+const glm::detail::uint8* MappedFile::getData() const
+{
+	return data_;
+}
+
+glm::detail::uint64 MappedFile::getSize() const
+{
+	return size_;
+}
+
+void MappedFile::map()
+{
+#ifdef OS_WINDOWS
+	HANDLE file = CreateFileA(filename_.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		const std::string message = std::string("Unable to open file: ") + filename_;
+		LOG_ERROR(message);
+		throw exception::IoException(message);
+	}
+
+	fileHandle_ = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		unmap();
+
+		const std::string message = std::string("Unable to get size of file: ") + filename_;
+		LOG_ERROR(message);
+		throw exception::IoException(message);
+	}
+
+	size_ = (glm::detail::uint64)size.QuadPart;
+
+	// An empty file can't be mapped
+	if (size_ == 0)
+	{
+		return;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void* data = (mapping != nullptr) ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+	mappingHandle_ = mapping;
+
+	if (data == nullptr)
+	{
+		unmap();
+
+		const std::string message = std::string("Unable to map file: ") + filename_;
+		LOG_ERROR(message);
+		throw exception::IoException(message);
+	}
+
+	data_ = (const glm::detail::uint8*)data;
+#else
+	const int fd = ::open(filename_.c_str(), O_RDONLY);
+
+	if (fd < 0)
+	{
+		const std::string message = std::string("Unable to open file: ") + filename_;
+		LOG_ERROR(message);
+		throw exception::IoException(message);
+	}
+
+	struct stat status;
+	if (::fstat(fd, &status) != 0)
+	{
+		::close(fd);
+
+		const std::string message = std::string("Unable to get size of file: ") + filename_;
+		LOG_ERROR(message);
+		throw exception::IoException(message);
+	}
+
+	size_ = (glm::detail::uint64)status.st_size;
+
+	// An empty file can't be mapped
+	if (size_ == 0)
+	{
+		::close(fd);
+		return;
+	}
+
+	void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// The mapping keeps its own reference to the file
+	::close(fd);
+
+	if (data == MAP_FAILED)
+	{
+		size_ = 0;
+
+		const std::string message = std::string("Unable to map file: ") + filename_;
+		LOG_ERROR(message);
+		throw exception::IoException(message);
+	}
+
+	data_ = (const glm::detail::uint8*)data;
+#endif
+}
+
+void MappedFile::unmap()
+{
+#ifdef OS_WINDOWS
+	if (data_ != nullptr)
+	{
+		UnmapViewOfFile(data_);
+	}
+
+	if (mappingHandle_ != nullptr)
+	{
+		CloseHandle((HANDLE)mappingHandle_);
+	}
+
+	if (fileHandle_ != nullptr)
+	{
+		CloseHandle((HANDLE)fileHandle_);
+	}
+#else
+	if (data_ != nullptr)
+	{
+		::munmap((void*)data_, size_);
+	}
+#endif
+
+	data_ = nullptr;
+	size_ = 0;
+	fileHandle_ = nullptr;
+	mappingHandle_ = nullptr;
+}
+
+}
@@ -0,0 +1,336 @@
+#include <cstdint>
+
+#include "RenderQueue.hpp"
+
+#include "glw/IOpenGlDevice.hpp"
+#include "glw/IMesh.hpp"
+#include "glw/ITexture.hpp"
+#include "glw/IMaterial.hpp"
+#include "glw/Constants.hpp"
+
+#include "glw/shaders/IShaderProgram.hpp"
+
+#include "common/logger/Logger.hpp"
+
+#include "exceptions/InvalidArgumentException.hpp"
+
+namespace glr
+{
+
+/** Anonymous helper functions. */
+namespace
+{
+
+/**
+ * Hashes the address p to 16 bits.  nullptr hashes to 0.
+ */
+glmd::uint64 hashPointer(const void* p)
+{
+	const glmd::uint64 address = (glmd::uint64) reinterpret_cast<std::uintptr_t>(p);
+	
+	// The lowest bits are always 0, due to alignment
+	return ((address >> 4) ^ (address >> 20) ^ (address >> 36)) & 0xFFFF;
+}
+
+/**
+ * Sorts entries by key, with a least significant digit radix sort (one byte per pass).  Passes where every key has the same byte are
+ * skipped - so keys that only use a few distinct values in each byte sort quickly.
+ */
+template<class Entry> void radixSort(std::vector< Entry >& entries, std::vector< Entry >& buffer)
+{
+	buffer.resize( entries.size() );
+	
+	for ( glmd::uint32 shift = 0; shift < 64; shift += 8 )
+	{
+		glmd::uint32 offsets[256] = { 0 };
+		
+		for ( const auto& e : entries )
+		{
+			offsets[ (e.key >> shift) & 0xFF ]++;
+		}
+		
+		if ( entries.empty() || offsets[ (entries[0].key >> shift) & 0xFF ] == entries.size() )
+		{
+			continue;
+		}
+		
+		glmd::uint32 total = 0;
+		for ( glmd::uint32 i = 0; i < 256; i++ )
+		{
+			const glmd::uint32 count = offsets[i];
+			offsets[i] = total;
+			total += count;
+		}
+		
+		for ( const auto& e : entries )
+		{
+			buffer[ offsets[(e.key >> shift) & 0xFF]++ ] = e;
+		}
+		
+		entries.swap( buffer );
+	}
+}
+
+}
+
+RenderQueue::RenderQueue(glw::IOpenGlDevice* openGlDevice) : openGlDevice_(openGlDevice), streamedFirstBone_(0), identityBonesBufferId_(0)
+{
+}
+
+RenderQueue::~RenderQueue()
+{
+	if (identityBonesBufferId_ != 0)
+	{
+		openGlDevice_->releaseBufferObject( identityBonesBufferId_ );
+	}
+}
+
+void RenderQueue::clear()
+{
+	items_.clear();
+	entries_.clear();
+	bones_.clear();
+}
+
+void RenderQueue::push(const DrawItem& item)
+{
+	const glmd::uint32 shaderProgramId = (item.shaderProgram != nullptr ? item.shaderProgram->getGLShaderProgramId() : 0);
+	
+	push( item, createSortKey(shaderProgramId, item.texture, item.material, item.mesh) );
+}
+
+void RenderQueue::push(const DrawItem& item, glmd::uint64 key)
+{
+	SortEntry entry = SortEntry();
+	entry.key = key;
+	entry.index = items_.size();
+	
+	items_.push_back( item );
+	entries_.push_back( entry );
+}
+
+glmd::uint32 RenderQueue::pushBones(const std::vector< glm::mat4 >& bones, glmd::uint32 numberOfBones)
+{
+	if (numberOfBones > bones.size() || numberOfBones > glw::Constants::MAX_NUMBER_OF_BONES_PER_MESH)
+	{
+		std::string msg = std::string("Cannot add more bones to the render queue than a mesh can have (or than were given).");
+		LOG_ERROR( msg );
+		throw exception::InvalidArgumentException( msg );
+	}
+	
+	const glmd::uint32 firstBone = bones_.size();
+	bones_.insert( bones_.end(), bones.begin(), bones.begin() + numberOfBones );
+	
+	return firstBone;
+}
+
+void RenderQueue::sort()
+{
+	radixSort( entries_, sortBuffer_ );
+	
+	sortedItems_.resize( items_.size() );
+	
+	for ( glmd::uint32 i = 0; i < entries_.size(); i++ )
+	{
+		sortedItems_[i] = items_[ entries_[i].index ];
+		entries_[i].index = i;
+	}
+	
+	items_.swap( sortedItems_ );
+}
+
+void RenderQueue::submit()
+{
+	stateTracker_.reset();
+	shaderProgramState_ = ShaderProgramState();
+	
+	streamedBonesRange_ = glw::StreamingBufferRange();
+	
+	const glm::mat4& viewMatrix = openGlDevice_->getViewMatrix();
+	const glm::mat4 projectionViewMatrix = openGlDevice_->getProjectionMatrix() * viewMatrix;
+	
+	const bool isInstancingSupported = (!instancedShaderPrograms_.empty() && openGlDevice_->isInstancingSupported());
+	
+	for ( glmd::uint32 i = 0; i < items_.size(); )
+	{
+		const auto& item = items_[i];
+	
+		if (item.shaderProgram == nullptr || item.mesh == nullptr)
+		{
+			i++;
+			continue;
+		}
+		
+		glmd::uint32 numberOfInstances = 1;
+		
+		if ( isInstancingSupported )
+		{
+			const auto it = instancedShaderPrograms_.find( item.shaderProgram );
+			
+			if ( it != instancedShaderPrograms_.end() )
+			{
+				numberOfInstances = countInstances( items_, i, glw::Constants::MAX_NUMBER_OF_INSTANCES_PER_DRAW );
+		
+				if ( numberOfInstances > 1 )
+				{
+					bindState( item, it->second );
+					drawInstances( i, numberOfInstances );
+				}
+			}
+		}
+		
+		if ( numberOfInstances == 1 )
+		{
+			bindState( item, item.shaderProgram );
+			drawItem( item, viewMatrix, projectionViewMatrix );
+		}
+		
+		i += numberOfInstances;
+	}
+}
+		
+void RenderQueue::bindState(const DrawItem& item, shaders::IShaderProgram* shaderProgram)
+{
+	if ( stateTracker_.setShaderProgram(shaderProgram) )
+	{
+		shaderProgram->bind();
+		
+		shaderProgramState_.shaderProgram = shaderProgram;
+		shaderProgramState_.modelMatrixHandle = shaderProgram->getUniformHandle(shaders::UNIFORM_MODEL_MATRIX);
+		shaderProgramState_.pvmMatrixHandle = shaderProgram->getUniformHandle(shaders::UNIFORM_PVM_MATRIX);
+		shaderProgramState_.normalMatrixHandle = shaderProgram->getUniformHandle(shaders::UNIFORM_NORMAL_MATRIX);
+		shaderProgramState_.materialBindPoint = shaderProgram->getBindPointByBindingName( shaders::IShader::BIND_TYPE_MATERIAL );
+		shaderProgramState_.boneBindPoint = shaderProgram->getBindPointByBindingName( shaders::IShader::BIND_TYPE_BONE );
+	}
+	
+	if ( item.texture != nullptr && stateTracker_.setTexture(item.texture) )
+	{
+		item.texture->bind();
+	}
+	
+	if ( item.material != nullptr && shaderProgramState_.materialBindPoint >= 0 && stateTracker_.setMaterial(item.material) )
+	{
+		item.material->bind();
+		openGlDevice_->bindBuffer( item.material->getBufferId(), shaderProgramState_.materialBindPoint );
+	}
+	
+	if ( shaderProgramState_.boneBindPoint >= 0 )
+	{
+		const glmd::uint32 bonesSize = glw::Constants::MAX_NUMBER_OF_BONES_PER_MESH * sizeof(glm::mat4);
+		
+		if ( item.numberOfBones == 0 && identityBonesBufferId_ == 0 )
+		{
+			const auto identityBones = std::vector< glm::mat4 >( glw::Constants::MAX_NUMBER_OF_BONES_PER_MESH, glm::mat4(1.0f) );
+			identityBonesBufferId_ = openGlDevice_->createBufferObject( GL_UNIFORM_BUFFER, bonesSize, &identityBones[0], GL_STATIC_DRAW );
+			
+			identityBonesRange_.bufferId = identityBonesBufferId_;
+			identityBonesRange_.size = bonesSize;
+		}
+		
+		// Streamed right before the draw - so the range can't be reused by the streaming buffer before the draw call is issued
+		if ( item.numberOfBones > 0 && (streamedBonesRange_.bufferId == 0 || streamedFirstBone_ != item.firstBone) )
+		{
+			streamedBonesRange_ = openGlDevice_->streamUniformData( &bones_[item.firstBone], item.numberOfBones * sizeof(glm::mat4), bonesSize );
+			streamedFirstBone_ = item.firstBone;
+		}
+		
+		const glw::StreamingBufferRange& bones = (item.numberOfBones > 0 ? streamedBonesRange_ : identityBonesRange_);
+		
+		if ( stateTracker_.setBones(bones) )
+		{
+			openGlDevice_->bindBuffer( bones, shaderProgramState_.boneBindPoint );
+		}
+	}
+}
+
+void RenderQueue::drawItem(const DrawItem& item, const glm::mat4& viewMatrix, const glm::mat4& projectionViewMatrix)
+{
+	shaders::IShaderProgram* shaderProgram = shaderProgramState_.shaderProgram;
+	
+	// Send the per draw uniforms to the shader
+	const glm::mat4 pvmMatrix = projectionViewMatrix * item.modelMatrix;
+	const glm::mat3 normalMatrix = glm::inverse(glm::transpose(glm::mat3(viewMatrix * item.modelMatrix)));
+	
+	shaderProgram->setUniform(shaderProgramState_.pvmMatrixHandle, pvmMatrix);
+	shaderProgram->setUniform(shaderProgramState_.normalMatrixHandle, normalMatrix);
+	shaderProgram->setUniform(shaderProgramState_.modelMatrixHandle, item.modelMatrix);
+	
+	item.mesh->render();
+	
+	stateTracker_.draw();
+}
+
+void RenderQueue::drawInstances(glmd::uint32 first, glmd::uint32 numberOfInstances)
+{
+	instanceModelMatrices_.resize( numberOfInstances );
+	
+	for ( glmd::uint32 i = 0; i < numberOfInstances; i++ )
+	{
+		instanceModelMatrices_[i] = items_[first + i].modelMatrix;
+	}
+	
+	const glw::StreamingBufferRange instances = openGlDevice_->streamVertexData( &instanceModelMatrices_[0], numberOfInstances * sizeof(glm::mat4) );
+	
+	items_[first].mesh->renderInstanced( instances, numberOfInstances );
+	
+	stateTracker_.drawInstanced( numberOfInstances );
+}
+
+const std::vector< DrawItem >& RenderQueue::getItems() const
+{
+	return items_;
+}
+
+glmd::uint32 RenderQueue::getNumberOfItems() const
+{
+	return items_.size();
+}
+
+const RenderStatistics& RenderQueue::getStatistics() const
+{
+	return stateTracker_.getStatistics();
+}
+
+void RenderQueue::setInstancedShaderProgram(shaders::IShaderProgram* shaderProgram, shaders::IShaderProgram* instancedShaderProgram)
+{
+	if (instancedShaderProgram == nullptr)
+	{
+		instancedShaderPrograms_.erase( shaderProgram );
+		return;
+	}
+	
+	instancedShaderPrograms_[shaderProgram] = instancedShaderProgram;
+}
+
+glmd::uint64 RenderQueue::createSortKey(glmd::uint32 shaderProgramId, const void* texture, const void* material, const void* mesh)
+{
+	return ((glmd::uint64)(shaderProgramId & 0xFFFF) << 48) | (hashPointer(texture) << 32) | (hashPointer(material) << 16) | hashPointer(mesh);
+}
+
+glmd::uint32 RenderQueue::countInstances(const std::vector< DrawItem >& items, glmd::uint32 first, glmd::uint32 maximumNumberOfInstances)
+{
+	const DrawItem& item = items[first];
+	
+	if (item.numberOfBones != 0)
+	{
+		return 1;
+	}
+	
+	glmd::uint32 last = first + 1;
+	
+	while ( last < items.size() && last - first < maximumNumberOfInstances )
+	{
+		const DrawItem& other = items[last];
+		
+		if (other.shaderProgram != item.shaderProgram || other.texture != item.texture || other.material != item.material || other.mesh != item.mesh || other.numberOfBones != 0)
+		{
+			break;
+		}
+		
+		last++;
+	}
+	
+	return last - first;
+}
+
+}
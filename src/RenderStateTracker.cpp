@@ -0,0 +1,98 @@
+#include "RenderStateTracker.hpp"
+
+namespace glr
+{
+
+RenderStateTracker::RenderStateTracker()
+{
+	reset();
+}
+
+void RenderStateTracker::reset()
+{
+	shaderProgram_ = nullptr;
+	texture_ = nullptr;
+	material_ = nullptr;
+	bones_ = glw::StreamingBufferRange();
+	
+	statistics_ = RenderStatistics();
+}
+
+bool RenderStateTracker::setShaderProgram(shaders::IShaderProgram* shaderProgram)
+{
+	if (shaderProgram == shaderProgram_)
+	{
+		statistics_.redundantChangesSkipped++;
+		return false;
+	}
+	
+	shaderProgram_ = shaderProgram;
+	
+	// The material and bones are bound to the previous shader program's bind points
+	material_ = nullptr;
+	bones_ = glw::StreamingBufferRange();
+	
+	statistics_.shaderProgramChanges++;
+	return true;
+}
+
+bool RenderStateTracker::setTexture(glw::ITexture* texture)
+{
+	if (texture == texture_)
+	{
+		statistics_.redundantChangesSkipped++;
+		return false;
+	}
+	
+	texture_ = texture;
+	
+	statistics_.textureChanges++;
+	return true;
+}
+
+bool RenderStateTracker::setMaterial(glw::IMaterial* material)
+{
+	if (material == material_)
+	{
+		statistics_.redundantChangesSkipped++;
+		return false;
+	}
+	
+	material_ = material;
+	
+	statistics_.materialChanges++;
+	return true;
+}
+
+bool RenderStateTracker::setBones(const glw::StreamingBufferRange& bones)
+{
+	if (bones.bufferId == bones_.bufferId && bones.offset == bones_.offset && bones.size == bones_.size)
+	{
+		statistics_.redundantChangesSkipped++;
+		return false;
+	}
+	
+	bones_ = bones;
+	
+	statistics_.boneChanges++;
+	return true;
+}
+
+void RenderStateTracker::draw()
+{
+	statistics_.drawCalls++;
+}
+
+void RenderStateTracker::drawInstanced(glmd::uint32 numberOfInstances)
+{
+	statistics_.drawCalls++;
+	statistics_.instancedDrawCalls++;
+	statistics_.instances += numberOfInstances;
+}
+
+const RenderStatistics& RenderStateTracker::getStatistics() const
+{
+	return statistics_;
+}
+
+}
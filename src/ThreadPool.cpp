@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <utility>
+
+#include "ThreadPool.hpp"
+
+#include "common/logger/Logger.hpp"
+
+namespace glr
+{
+
+namespace
+{
+
+// Orders the heap so that the job with the lowest priority value is at the front
+struct JobPriorityComparator
+{
+	template<typename JobType>
+	bool operator()(const JobType& a, const JobType& b) const
+	{
+		return a.priority > b.priority;
+	}
+};
+
+}
+
+ThreadPool::ThreadPool(glm::detail::uint32 numberOfThreads) : numberOfRunningJobs_(0), isStopping_(false)
+{
+	if (numberOfThreads == 0)
+	{
+		numberOfThreads = std::max( std::thread::hardware_concurrency(), 1u );
+	}
+
+	for (glm::detail::uint32 i=0; i < numberOfThreads; i++)
+	{
+		threads_.push_back( std::thread(&ThreadPool::run, this) );
+	}
+
+	LOG_DEBUG( "Thread pool started with " << numberOfThreads << " threads." );
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		isStopping_ = true;
+		jobs_.clear();
+	}
+
+	jobAvailable_.notify_all();
+
+	for ( auto& t : threads_ )
+	{
+		t.join();
+	}
+}
+
+void ThreadPool::enqueue(glm::detail::uint64 key, glm::detail::float32 priority, std::function<void()> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		Job j = Job();
+		j.key = key;
+		j.priority = priority;
+		j.work = std::move(job);
+
+		jobs_.push_back( std::move(j) );
+		std::push_heap(jobs_.begin(), jobs_.end(), JobPriorityComparator());
+	}
+
+	jobAvailable_.notify_one();
+}
+
+glm::detail::uint32 ThreadPool::cancel(glm::detail::uint64 key)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	const auto size = jobs_.size();
+
+	jobs_.erase( std::remove_if(jobs_.begin(), jobs_.end(), [key](const Job& j) { return j.key == key; }), jobs_.end() );
+
+	const glm::detail::uint32 numberRemoved = (glm::detail::uint32)(size - jobs_.size());
+
+	if (numberRemoved > 0)
+	{
+		std::make_heap(jobs_.begin(), jobs_.end(), JobPriorityComparator());
+
+		if (jobs_.empty() && numberOfRunningJobs_ == 0)
+		{
+			jobsFinished_.notify_all();
+		}
+	}
+
+	return numberRemoved;
+}
+
+void ThreadPool::reprioritize(const std::function<glm::detail::float32(glm::detail::uint64)>& priorityFunction)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	for ( auto& j : jobs_ )
+	{
+		j.priority = priorityFunction(j.key);
+	}
+
+	std::make_heap(jobs_.begin(), jobs_.end(), JobPriorityComparator());
+}
+
+glm::detail::uint32 ThreadPool::parallelFor(glm::detail::uint32 count, glm::detail::uint32 chunkSize, const std::function<void(glm::detail::uint32, glm::detail::uint32)>& job)
+{
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	chunkSize = std::max( chunkSize, 1u );
+	const glm::detail::uint32 numberOfChunks = (count - 1) / chunkSize + 1;
+
+	std::mutex chunkMutex;
+	std::condition_variable chunksFinished;
+	glm::detail::uint32 numberOfChunksLeft = numberOfChunks - 1;
+	std::exception_ptr exception = nullptr;
+
+	auto runChunk = [&](glm::detail::uint32 chunk) {
+		try
+		{
+			job( chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize) );
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(chunkMutex);
+
+			if (exception == nullptr)
+			{
+				exception = std::current_exception();
+			}
+		}
+	};
+
+	for (glm::detail::uint32 chunk=1; chunk < numberOfChunks; chunk++)
+	{
+		enqueue( std::numeric_limits<glm::detail::uint64>::max(), -std::numeric_limits<glm::detail::float32>::max(), [&, chunk] {
+			runChunk( chunk );
+
+			// Notify while locked - once the count reaches 0, the calling thread may return (destroying chunksFinished)
+			std::lock_guard<std::mutex> lock(chunkMutex);
+			numberOfChunksLeft--;
+			chunksFinished.notify_all();
+		} );
+	}
+
+	// The calling thread would only be waiting otherwise
+	runChunk( 0 );
+
+	{
+		std::unique_lock<std::mutex> lock(chunkMutex);
+
+		chunksFinished.wait(lock, [&numberOfChunksLeft] { return (numberOfChunksLeft == 0); });
+	}
+
+	if (exception != nullptr)
+	{
+		std::rethrow_exception( exception );
+	}
+
+	return numberOfChunks;
+}
+
+void ThreadPool::waitForAll()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	jobsFinished_.wait(lock, [this] { return (jobs_.empty() && numberOfRunningJobs_ == 0); });
+}
+
+glm::detail::uint32 ThreadPool::getNumberOfThreads() const
+{
+	return (glm::detail::uint32)threads_.size();
+}
+
+glm::detail::uint32 ThreadPool::getNumberOfQueuedJobs() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	return (glm::detail::uint32)jobs_.size();
+}
+
+void ThreadPool::run()
+{
+	while (true)
+	{
+		auto work = std::function<void()>();
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+
+			jobAvailable_.wait(lock, [this] { return (isStopping_ || !jobs_.empty()); });
+
+			if (isStopping_)
+			{
+				return;
+			}
+
+			std::pop_heap(jobs_.begin(), jobs_.end(), JobPriorityComparator());
+			work = std::move(jobs_.back().work);
+			jobs_.pop_back();
+
+			numberOfRunningJobs_++;
+		}
+
+		try
+		{
+			work();
+		}
+		catch (const std::exception& e)
+		{
+			LOG_ERROR( "Exception thrown from thread pool job: " << e.what() );
+		}
+		catch (...)
+		{
+			LOG_ERROR( "Unknown exception thrown from thread pool job." );
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			numberOfRunningJobs_--;
+
+			if (jobs_.empty() && numberOfRunningJobs_ == 0)
+			{
+				jobsFinished_.notify_all();
+			}
+		}
+	}
+}
+
+}
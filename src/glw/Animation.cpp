@@ -28,7 +28,7 @@ Animation::Animation()
 	animatedBoneNodes_ = std::map< std::string, AnimatedBoneNode >();
 	runningTime_ = 0.0f;
 	
-	bufferId_ = 0;
+	bufferRange_ = StreamingBufferRange();
 	
 	startFrame_ = 0;
 	endFrame_ = 0;
@@ -42,14 +42,15 @@ Animation::Animation()
 	loadLocalData();
 }
 
-Animation::Animation(IOpenGlDevice* openGlDevice, std::string name, bool initialize) : openGlDevice_(openGlDevice), name_(std::move(name))
+Animation::Animation(IOpenGlDevice* openGlDevice, std::string name, bool initialize, const AnimationCompressionSettings& compression)
+	: openGlDevice_(openGlDevice), name_(std::move(name)), compression_(compression)
 {
 	duration_ = 0.0f;
 	ticksPerSecond_ = 0.0f;
 	animatedBoneNodes_ = std::map< std::string, AnimatedBoneNode >();
 	runningTime_ = 0.0f;
 	
-	bufferId_ = 0;
+	bufferRange_ = StreamingBufferRange();
 	
 	startFrame_ = 0;
 	endFrame_ = 0;
@@ -74,14 +75,15 @@ Animation::Animation(
 		glm::detail::float64 duration, 
 		glm::detail::float64 ticksPerSecond, 
 		std::map< std::string, AnimatedBoneNode > animatedBoneNodes,
-		bool initialize
-	) : openGlDevice_(openGlDevice), name_(std::move(name)), duration_(duration), ticksPerSecond_(ticksPerSecond), animatedBoneNodes_(std::move(animatedBoneNodes)), runningTime_(0.0f)
+		bool initialize,
+		const AnimationCompressionSettings& compression
+	) : openGlDevice_(openGlDevice), name_(std::move(name)), duration_(duration), ticksPerSecond_(ticksPerSecond), animatedBoneNodes_(std::move(animatedBoneNodes)), runningTime_(0.0f), compression_(compression)
 {
 	// We probably shouldn't have an animation object at all if it has no animated bone nodes...
 	assert( animatedBoneNodes_.size() != 0 );
 	
 	//LOG_DEBUG( "loading animation." );
-	bufferId_ = 0;
+	bufferRange_ = StreamingBufferRange();
 	
 	startFrame_ = 0;
 	endFrame_ = 0;
@@ -89,6 +91,8 @@ Animation::Animation(
 	// Error check - default to 25 ticks per second
 	ticksPerSecond_ = ( ticksPerSecond_ != 0.0f ? ticksPerSecond_ : 25.0f );
 	
+	compileTracks();
+	
 	currentTransforms_ = std::vector< glm::mat4 >();
 	
 	isLocalDataLoaded_ = false;
@@ -105,7 +109,7 @@ Animation::Animation(
 
 Animation::Animation(const Animation& other, bool initialize)
 {
-	bufferId_ = 0;
+	bufferRange_ = StreamingBufferRange();
 	
 	startFrame_ = 0;
 	endFrame_ = 0;
@@ -117,8 +121,10 @@ Animation::Animation(const Animation& other, bool initialize)
 	name_ = other.name_;
 	duration_ = other.duration_;
 	animatedBoneNodes_ = other.animatedBoneNodes_;
+	compression_ = other.compression_;
 	
 	checkAnimatedBonesNodes();
+	compileTracks();
 	
 	currentTransforms_ = std::vector< glm::mat4 >();
 	
@@ -136,12 +142,11 @@ Animation::Animation(const Animation& other, bool initialize)
 
 Animation::~Animation()
 {
-	openGlDevice_->releaseBufferObject( bufferId_ );
 }
 
 void Animation::bind() const
 {
-	glBindBuffer(GL_UNIFORM_BUFFER, bufferId_);
+	glBindBuffer(GL_UNIFORM_BUFFER, bufferRange_.bufferId);
 }
 
 void Animation::pushToVideoMemory()
@@ -174,55 +179,26 @@ void Animation::freeVideoMemory()
 
 void Animation::allocateVideoMemory()
 {
-	bufferId_ = openGlDevice_->createBufferObject(GL_UNIFORM_BUFFER, Constants::MAX_NUMBER_OF_BONES_PER_MESH * sizeof(glm::mat4), &currentTransforms_[0], GL_STREAM_DRAW);
-	
+	// Nothing to allocate - the transformations are streamed into the OpenGlDevice's streaming buffer when they are pushed
 	isVideoMemoryAllocated_ = true;
-	
-	OPENGL_CHECK_ERRORS(openGlDevice_)
-	
-	LOG_DEBUG( "Successfully loaded animation.  Buffer id: " << bufferId_ );
 }
 
-// TODO: Look at making this more efficient?
-// Note: I couldn't just use glBufferSubData, as it didn't seem to synchronize when the previous buffer data was to be used for a draw call.
-// Furthermore, it appears 'buffer orphaning' is not working either. That is, when I added 
-// `glBufferData(GL_UNIFORM_BUFFER, currentTransforms_.size() * sizeof(glm::mat4), NULL, GL_DYNAMIC_DRAW);` before my call to `glBufferSubData`, 
-// I get the same results.
-// StackOverflow Question: http://stackoverflow.com/questions/19897461/glbuffersubdata-between-gldrawarrays-calls-mangling-data#19897905
+/**
+ * The transformations are streamed into the OpenGlDevice's uniform streaming buffer, rather than a buffer of our own - an animation can be
+ * pushed many times per frame (models share animations), and the GPU may still be using the transformations from the previous push.
+ * Each push gets its own range of the streaming buffer, so there's nothing to synchronize.
+ * 
+ * Note: Before the streaming buffer, I couldn't just use glBufferSubData, as it didn't seem to synchronize when the previous buffer data was
+ * to be used for a draw call.  Buffer orphaning didn't work either.
+ * StackOverflow Question: http://stackoverflow.com/questions/19897461/glbuffersubdata-between-gldrawarrays-calls-mangling-data#19897905
+ */
 void Animation::pushToVideoMemory(const std::vector< glm::mat4 >& transformations)
 {
 	assert( transformations.size() <= Constants::MAX_NUMBER_OF_BONES_PER_MESH );
-
-	bind();
-
-	if (transformations.size() > 0)
-	{
-		void* d = glMapBufferRange(GL_UNIFORM_BUFFER, 0, transformations.size() * sizeof(glm::mat4), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
-		
-		if (d != nullptr)
-		{
-			memcpy( d, &transformations[0], transformations.size() * sizeof(glm::mat4) );
-			GLboolean r = glUnmapBuffer(GL_UNIFORM_BUFFER);
-			
-			if (r == GL_FALSE)
-			{
-				GlError err = openGlDevice_->getGlError();
-				
-				std::string msg = std::string("Call to 'glUnmapBuffer' failed with error: ") + err.name;
-				LOG_ERROR( msg );
-				throw exception::GlException( msg );
-				
-			}
-		}
-		else
-		{
-			GlError err = openGlDevice_->getGlError();
-			
-			std::string msg = std::string("Call to 'glMapBufferRange' failed with error: ") + err.name;
-			LOG_ERROR( msg );
-			throw exception::GlException( msg );
-		}
-	}
+	
+	// The range always covers the whole bone block in the shader
+	const void* data = (transformations.size() > 0 ? &transformations[0] : nullptr);
+	bufferRange_ = openGlDevice_->streamUniformData( data, transformations.size() * sizeof(glm::mat4), Constants::MAX_NUMBER_OF_BONES_PER_MESH * sizeof(glm::mat4) );
 	
 	isDirty_ = false;
 }
@@ -244,7 +220,12 @@ bool Animation::isDirty() const
 
 GLuint Animation::getBufferId() const
 {
-	return bufferId_;
+	return bufferRange_.bufferId;
+}
+
+const StreamingBufferRange& Animation::getBufferRange() const
+{
+	return bufferRange_;
 }
 
 GLuint Animation::getBindPoint() const
@@ -269,11 +250,23 @@ void Animation::setFrameClampping(glm::detail::uint32 startFrame, glm::detail::u
 void Animation::setDuration(glm::detail::float64 duration)
 {
 	duration_ = duration;
+	
+	// Compressed tracks are sampled over the duration
+	if ( compression_.isEnabled )
+	{
+		compileTracks();
+	}
 }
 
 void Animation::setTicksPerSecond(glm::detail::float64 ticksPerSecond)
 {
 	ticksPerSecond_ = ticksPerSecond;
+	
+	// Compressed tracks are sampled at a rate in keys per second
+	if ( compression_.isEnabled )
+	{
+		compileTracks();
+	}
 }
 
 void Animation::setAnimatedBoneNodes(std::map< std::string, AnimatedBoneNode > animatedBoneNodes)
@@ -281,6 +274,7 @@ void Animation::setAnimatedBoneNodes(std::map< std::string, AnimatedBoneNode > a
 	animatedBoneNodes_ = std::move(animatedBoneNodes);
 	
 	checkAnimatedBonesNodes();
+	compileTracks();
 }
 
 const std::string& Animation::getName() const
@@ -288,281 +282,135 @@ const std::string& Animation::getName() const
 	return name_;
 }
 
-glmd::uint32 Animation::findPosition(glmd::float32 animationTime, const AnimatedBoneNode& animatedBoneNode)
+void Animation::calculate(const glm::mat4& globalInverseTransformation, const BoneNode& rootBoneNode, const BoneData& boneData)
 {
-	assert(animatedBoneNode.positionTimes.size() > 0);
-	
-	//if (indexCache_[0] >= animatedBoneNode.positionTimes.size())
-	//{
-	//	indexCache_[0] = 0;
-	//}
-	
-	// Not all animated bone nodes have the same number of 'times', so sometimes the cache index value can
-	// be larger than the size, but that's ok, it will reset to a valid value once the second for loop runs.
-	//assert( indexCache_[0] >= 0 && indexCache_[0] < animatedBoneNode.positionTimes.size() );
-	
-	// Search first from cache position
-	for (glmd::uint32 i = indexCache_[0]; i < animatedBoneNode.positionTimes.size() - 1; i++)
-	{
-		if (animationTime < (glmd::float32)animatedBoneNode.positionTimes[i + 1])
-		{
-			indexCache_[0] = i;
-			return i;
-		}
-	}
+	currentTransforms_ = std::vector< glm::mat4 >( boneData.boneTransform.size(), glm::mat4() );
 	
-	// If not found, search from the beginning
-	for (glmd::uint32 i = 0; i < animatedBoneNode.positionTimes.size() - 1; i++)
-	{
-		if (animationTime < (glmd::float32)animatedBoneNode.positionTimes[i + 1])
-		{
-			indexCache_[0] = i;
-			return i;
-		}
-	}
-
-	std::string msg = std::string("Unable to find appropriate position time - this shouldn't happen.");
-	LOG_ERROR( msg );
-	throw exception::Exception( msg );
+	calculate( currentTransforms_, globalInverseTransformation, rootBoneNode, boneData );
 }
 
-glmd::uint32 Animation::findRotation(glmd::float32 animationTime, const AnimatedBoneNode& animatedBoneNode)
+void Animation::calculate(const glm::mat4& globalInverseTransformation, const BoneNode& rootBoneNode, const BoneData& boneData, std::vector<glmd::uint32>& indexCache)
 {
-	assert(animatedBoneNode.rotationTimes.size() > 0);
-	
-	//if (indexCache_[1] >= animatedBoneNode.rotationTimes.size())
-	//{
-	//	indexCache_[1] = 0;
-	//}
-	
-	// Not all animated bone nodes have the same number of 'times', so sometimes the cache index value can
-	// be larger than the size, but that's ok, it will reset to a valid value once the second for loop runs.
-	//assert( indexCache_[1] >= 0 && indexCache_[1] < animatedBoneNode.rotationTimes.size() );
-	
-	// Search first from cache position
-	for (glmd::uint32 i = indexCache_[1]; i < animatedBoneNode.rotationTimes.size() - 1; i++)
-	{
-		if (animationTime < (glmd::float32)animatedBoneNode.rotationTimes[i + 1])
-		{
-			indexCache_[1] = i;
-			return i;
-		}
-	}
-	
-	// If not found, search from the beginning
-	for (glmd::uint32 i = 0; i < animatedBoneNode.rotationTimes.size() - 1; i++)
-	{
-		if (animationTime < (glmd::float32)animatedBoneNode.rotationTimes[i + 1])
-		{
-			indexCache_[1] = i;
-			return i;
-		}
-	}
-	
-	std::string msg = std::string("Unable to find appropriate rotation time - this shouldn't happen.");
-	LOG_ERROR( msg );
-	throw exception::Exception( msg );
+	calculate( globalInverseTransformation, rootBoneNode, boneData );
 }
 
-
-glmd::uint32 Animation::findScaling(glmd::float32 animationTime, const AnimatedBoneNode& animatedBoneNode)
+void Animation::calculate(std::vector< glm::mat4 >& transformations, const glm::mat4& globalInverseTransformation, const BoneNode& rootBoneNode, const BoneData& boneData)
 {
-	assert(animatedBoneNode.scalingTimes.size() > 0);
-	
-	//if (indexCache_[2] >= animatedBoneNode.scalingTimes.size())
-	//{
-	//	indexCache_[2] = 0;
-	//}
-	
-	// Not all animated bone nodes have the same number of 'times', so sometimes the cache index value can
-	// be larger than the size, but that's ok, it will reset to a valid value once the second for loop runs.
-	//assert( indexCache_[2] >= 0 && indexCache_[2] < animatedBoneNode.scalingTimes.size() );
+	// A one off skeleton - its tracks aren't cached, as its id is never seen again
+	const Skeleton skeleton = Skeleton( rootBoneNode );
 	
-	// Search first from cache position
-	for (glmd::uint32 i = indexCache_[2]; i < animatedBoneNode.scalingTimes.size() - 1; i++)
-	{
-		if (animationTime < (glmd::float32)animatedBoneNode.scalingTimes[i + 1])
-		{
-			indexCache_[2] = i;
-			return i;
-		}
-	}
-	
-	// If not found, search from the beginning
-	for (glmd::uint32 i = 0; i < animatedBoneNode.scalingTimes.size() - 1; i++)
-	{
-		if (animationTime < (glmd::float32)animatedBoneNode.scalingTimes[i + 1])
-		{
-			indexCache_[2] = i;
-			return i;
-		}
-	}
-	
-	std::string msg = std::string("Unable to find appropriate scaling time - this shouldn't happen.");
-	LOG_ERROR( msg );
-	throw exception::Exception( msg );
+	calculatePose( transformations, globalTransformations_, globalInverseTransformation, skeleton, bindNodes(skeleton), skeleton.bindBones(boneData), runningTime_, startFrame_, endFrame_ );
 }
 
-void Animation::calcInterpolatedPosition(glm::vec3& out, glmd::float32 animationTime, const AnimatedBoneNode& animatedBoneNode)
+void Animation::calculate(std::vector< glm::mat4 >& transformations, const glm::mat4& globalInverseTransformation, const BoneNode& rootBoneNode, const BoneData& boneData, std::vector<glmd::uint32>& indexCache)
 {
-	if (animatedBoneNode.positionTimes.size() == 1)
-	{
-		out = animatedBoneNode.positions[0];
-		return;
-	}
-			
-	glmd::uint32 positionIndex = findPosition(animationTime, animatedBoneNode);
-	glmd::uint32 nextPositionIndex = (positionIndex + 1);
-	
-	assert(nextPositionIndex < animatedBoneNode.positionTimes.size());
-	
-	glmd::float32 deltaTime = (glmd::float32)(animatedBoneNode.positionTimes[nextPositionIndex] - animatedBoneNode.positionTimes[positionIndex]);
-	glmd::float32 factor = (animationTime - (glmd::float32)animatedBoneNode.positionTimes[positionIndex]) / deltaTime;
-	
-	assert(factor >= 0.0f && factor <= 1.0f);
-	const glm::vec3& start = animatedBoneNode.positions[positionIndex];
-	const glm::vec3& end = animatedBoneNode.positions[nextPositionIndex];
-	glm::vec3 delta = end - start;
-	out = start + factor * delta;
+	calculate( transformations, globalInverseTransformation, rootBoneNode, boneData );
 }
 
-
-void Animation::calcInterpolatedRotation(glm::quat& out, glmd::float32 animationTime, const AnimatedBoneNode& animatedBoneNode)
+void Animation::calculate(const glm::mat4& globalInverseTransformation, const Skeleton& skeleton, const SkeletonBones& bones)
 {
-	// we need at least two values to interpolate...
-	if (animatedBoneNode.rotationTimes.size() == 1)
-	{
-		out = animatedBoneNode.rotations[0];
-		return;
-	}
-
-	glmd::uint32 rotationIndex = findRotation(animationTime, animatedBoneNode);
-	glmd::uint32 nextRotationIndex = (rotationIndex + 1);
-	
-	assert(nextRotationIndex < animatedBoneNode.rotationTimes.size());
+	// Bones that don't name a skeleton node keep the identity transformation
+	currentTransforms_.assign( bones.numberOfBones, glm::mat4() );
 	
-	glmd::float32 deltaTime = (glmd::float32)(animatedBoneNode.rotationTimes[nextRotationIndex] - animatedBoneNode.rotationTimes[rotationIndex]);
-	glmd::float32 factor = (animationTime - (glmd::float32)animatedBoneNode.rotationTimes[rotationIndex]) / deltaTime;
-	assert(factor >= 0.0f && factor <= 1.0f);
-	const glm::quat& startRotationQuat = animatedBoneNode.rotations[rotationIndex];
-	const glm::quat& endRotationQuat   = animatedBoneNode.rotations[nextRotationIndex];
-	
-	out = glm::slerp(startRotationQuat, endRotationQuat, factor);
-	// TODO: I might not need to normalize the quaternion here...might already have been done in glm::mix??
-	out = glm::normalize( out );
+	calculate( currentTransforms_, globalInverseTransformation, skeleton, bones );
 }
 
+void Animation::calculate(std::vector< glm::mat4 >& transformations, const glm::mat4& globalInverseTransformation, const Skeleton& skeleton, const SkeletonBones& bones)
+{
+	calculatePose( transformations, globalTransformations_, globalInverseTransformation, skeleton, getNodeTracks(skeleton), bones, runningTime_, startFrame_, endFrame_ );
+}
 
-void Animation::calcInterpolatedScaling(glm::vec3& out, glmd::float32 animationTime, const AnimatedBoneNode& animatedBoneNode)
+std::vector< glmd::int32 > Animation::bindNodes(const Skeleton& skeleton) const
 {
-	if (animatedBoneNode.scalingTimes.size() == 1)
+	if ( compression_.isEnabled )
 	{
-		out = animatedBoneNode.scalings[0];
-		return;
+		return sampledTracks_.bindNodes( skeleton );
 	}
-
-	glmd::uint32 scalingIndex = findScaling(animationTime, animatedBoneNode);
-	glmd::uint32 nextScalingIndex = (scalingIndex + 1);
 	
-	assert(nextScalingIndex < animatedBoneNode.scalingTimes.size());
-	
-	glmd::float32 deltaTime = (glmd::float32)(animatedBoneNode.scalingTimes[nextScalingIndex] - animatedBoneNode.scalingTimes[scalingIndex]);
-	glmd::float32 factor = (animationTime - (glmd::float32)animatedBoneNode.scalingTimes[scalingIndex]) / deltaTime;
-	assert(factor >= 0.0f && factor <= 1.0f);
-	const glm::vec3& start = animatedBoneNode.scalings[scalingIndex];
-	const glm::vec3& end   = animatedBoneNode.scalings[nextScalingIndex];
-	glm::vec3 delta = end - start;
-	out = start + factor * delta;
+	return tracks_.bindNodes( skeleton );
 }
 
-void Animation::readNodeHeirarchy(std::vector< glm::mat4 >& transformations, glmd::float32 animationTime, const glm::mat4& globalInverseTransform, const BoneNode& rootBoneNode, const BoneData& boneData, const glm::mat4& parentTransform)
+void Animation::calculatePose(
+	std::vector< glm::mat4 >& transformations,
+	std::vector< glm::mat4 >& globalTransformations,
+	const glm::mat4& globalInverseTransformation,
+	const Skeleton& skeleton,
+	const std::vector< glmd::int32 >& nodeTracks,
+	const SkeletonBones& bones,
+	glmd::float32 runningTime,
+	glmd::uint32 startFrame,
+	glmd::uint32 endFrame
+) const
 {
-	glm::mat4 nodeTransformation = glm::mat4( rootBoneNode.transformation );
+	assert( transformations.size() >= bones.numberOfBones );
 	
+	if ( globalTransformations.size() < skeleton.getNumberOfNodes() )
 	{
-		auto it = animatedBoneNodes_.find( rootBoneNode.name );
-
-		if ( it != animatedBoneNodes_.end() )
-		{
-			const AnimatedBoneNode& animatedBoneNode = it->second;
-
-			// Clamp animation time between start and end frame
-			if ( startFrame_ > 0 || endFrame_ > 0)
-			{
-				glmd::float32 st = (glmd::float32)animatedBoneNode.positionTimes[startFrame_];
-				glmd::float32 et = (glmd::float32)animatedBoneNode.positionTimes[endFrame_];
-
-				animationTime = fmod(animationTime, et) + st;
-			}
-			
-			// Interpolate scaling and generate scaling transformation matrix
-			glm::vec3 scaling;
-			calcInterpolatedScaling(scaling, animationTime, animatedBoneNode);
-			glm::mat4 scalingM = glm::scale( glm::mat4(1.0f), glm::vec3(scaling.x, scaling.y, scaling.z) );
-			
-			// Interpolate rotation and generate rotation transformation matrix
-			glm::quat rotationQ;
-			calcInterpolatedRotation(rotationQ, animationTime, animatedBoneNode);
-			glm::mat4 rotationM = glm::mat4_cast(rotationQ);
-	
-			// Interpolate translation and generate translation transformation matrix
-			glm::vec3 translation;
-			calcInterpolatedPosition(translation, animationTime, animatedBoneNode);
-			glm::mat4 translationM = glm::translate( glm::mat4(1.0f), glm::vec3(translation.x, translation.y, translation.z) );
-			
-			// Combine the above transformations
-			nodeTransformation = translationM * rotationM * scalingM;
-		}
+		globalTransformations.resize( skeleton.getNumberOfNodes() );
 	}
-
-	glm::mat4 globalTransformation = parentTransform * nodeTransformation;
 	
+	if ( compression_.isEnabled )
 	{
-		auto it = boneData.boneIndexMap.find( rootBoneNode.name );
-		
-		if ( it != boneData.boneIndexMap.end() )
-		{
-			glmd::uint32 boneIndex = it->second;
-			transformations[boneIndex] = globalInverseTransform * globalTransformation * boneData.boneTransform[boneIndex].boneOffset;
-		}
+		sampledTracks_.calculateGlobalTransformations( globalTransformations, skeleton, nodeTracks, getAnimationTime(runningTime), startFrame, endFrame, globalInverseTransformation );
 	}
-	
-	for (glmd::uint32 i = 0; i < rootBoneNode.children.size(); i++)
+	else
 	{
-		readNodeHeirarchy(transformations, animationTime, globalInverseTransform, rootBoneNode.children[i], boneData, globalTransformation);
+		tracks_.calculateGlobalTransformations( globalTransformations, skeleton, nodeTracks, getAnimationTime(runningTime), startFrame, endFrame, globalInverseTransformation );
 	}
+	Skeleton::calculateBoneTransformations( transformations, globalTransformations, bones );
 }
 
-void Animation::calculate(const glm::mat4& globalInverseTransformation, const BoneNode& rootBoneNode, const BoneData& boneData)
+void Animation::calculateLocalPose(
+	SkeletonPose& pose,
+	const std::vector< glmd::int32 >& nodeTracks,
+	glmd::float32 runningTime,
+	glmd::uint32 startFrame,
+	glmd::uint32 endFrame
+) const
 {
-	std::vector<glmd::uint32> indexCache = std::vector<glmd::uint32>( 3 );
-	calculate( globalInverseTransformation, rootBoneNode, boneData, indexCache);
+	if ( compression_.isEnabled )
+	{
+		sampledTracks_.calculateLocalPose( pose, nodeTracks, getAnimationTime(runningTime), startFrame, endFrame );
+	}
+	else
+	{
+		tracks_.calculateLocalPose( pose, nodeTracks, getAnimationTime(runningTime), startFrame, endFrame );
+	}
 }
 
-void Animation::calculate(const glm::mat4& globalInverseTransformation, const BoneNode& rootBoneNode, const BoneData& boneData, std::vector<glmd::uint32>& indexCache)
+const std::vector< glmd::int32 >& Animation::getNodeTracks(const Skeleton& skeleton)
 {
-	currentTransforms_ = std::vector< glm::mat4 >( boneData.boneTransform.size(), glm::mat4() );
-
-	calculate( currentTransforms_, globalInverseTransformation, rootBoneNode, boneData, indexCache);
+	auto it = skeletonNodeTracks_.find( skeleton.getId() );
+	
+	if ( it == skeletonNodeTracks_.end() )
+	{
+		it = skeletonNodeTracks_.insert( std::make_pair(skeleton.getId(), bindNodes(skeleton)) ).first;
+	}
+	
+	return it->second;
 }
 
-void Animation::calculate(std::vector< glm::mat4 >& transformations, const glm::mat4& globalInverseTransformation, const BoneNode& rootBoneNode, const BoneData& boneData)
+glmd::float32 Animation::getAnimationTime(glmd::float32 runningTime) const
 {
-	std::vector<glmd::uint32> indexCache = std::vector<glmd::uint32>( 3 );
-	calculate( transformations, globalInverseTransformation, rootBoneNode, boneData, indexCache );
+	glmd::float32 timeInTicks = runningTime * ticksPerSecond_;
+	
+	return (duration_ > 0.0 ? fmod(timeInTicks, (glmd::float32)duration_) : 0.0f);
 }
 
-void Animation::calculate(std::vector< glm::mat4 >& transformations, const glm::mat4& globalInverseTransformation, const BoneNode& rootBoneNode, const BoneData& boneData, std::vector<glmd::uint32>& indexCache)
+void Animation::compileTracks()
 {
-	assert(transformations.size() >= boneData.boneTransform.size());
-	assert( indexCache.size() == 3 );
-
-	indexCache_ = indexCache;
-	
-	glmd::float32 timeInTicks = runningTime_ * ticksPerSecond_;
-	glmd::float32 animationTime = fmod(timeInTicks, (glmd::float32)duration_);
+	if ( compression_.isEnabled )
+	{
+		tracks_ = AnimationTracks();
+		sampledTracks_ = SampledAnimationTracks( animatedBoneNodes_, duration_, ticksPerSecond_, compression_ );
+	}
+	else
+	{
+		tracks_ = AnimationTracks( animatedBoneNodes_ );
+		sampledTracks_ = SampledAnimationTracks();
+	}
 	
-	readNodeHeirarchy( transformations, animationTime, globalInverseTransformation, rootBoneNode, boneData, glm::mat4() );
+	skeletonNodeTracks_.clear();
 }
 
 void Animation::checkAnimatedBonesNodes() const
@@ -631,6 +479,7 @@ void Animation::deserialize(const std::string& filename)
 void Animation::deserialize(serialize::TextInArchive& inArchive)
 {
 	inArchive >> *this;
+	compileTracks();
 	loadLocalData();
 }
 
@@ -1,4 +1,6 @@
 #include <utility>
+#include <algorithm>
+#include <chrono>
 
 #include "Configure.hpp"
 
@@ -17,7 +19,7 @@ namespace glr
 namespace glw
 {
 
-AnimationManager::AnimationManager()
+AnimationManager::AnimationManager() : numberOfThreads_(0)
 {
 	openGlDevice_ = nullptr;
 	
@@ -25,7 +27,8 @@ AnimationManager::AnimationManager()
 	addAnimation(glw::Constants::GLR_IDENTITY_BONES);
 }
 	
-AnimationManager::AnimationManager(IOpenGlDevice* openGlDevice) : openGlDevice_(openGlDevice)
+AnimationManager::AnimationManager(IOpenGlDevice* openGlDevice, glm::detail::uint32 numberOfThreads, const AnimationCompressionSettings& compression)
+	: openGlDevice_(openGlDevice), compression_(compression), numberOfThreads_(numberOfThreads)
 {
 	// Create and add GLR_IDENTITY_BONES animation
 	addAnimation(glw::Constants::GLR_IDENTITY_BONES);
@@ -65,7 +68,7 @@ IAnimation* AnimationManager::addAnimation(const std::string& name, bool initial
 	}
 
 	LOG_DEBUG( "Creating Animation." );
-	auto animation = std::unique_ptr<Animation>(new Animation(openGlDevice_, name, initialize));
+	auto animation = std::unique_ptr<Animation>(new Animation(openGlDevice_, name, initialize, compression_));
 	auto animationPointer = animation.get();
 	
 	animations_[name] = std::move(animation);
@@ -87,7 +90,7 @@ IAnimation* AnimationManager::addAnimation(const std::string& name, glm::detail:
 	}
 
 	LOG_DEBUG( "Creating Animation." );
-	auto animation = std::unique_ptr<Animation>(new Animation(openGlDevice_, name, duration, ticksPerSecond, animatedBoneNodes, initialize));
+	auto animation = std::unique_ptr<Animation>(new Animation(openGlDevice_, name, duration, ticksPerSecond, animatedBoneNodes, initialize, compression_));
 	auto animationPointer = animation.get();
 	
 	animations_[name] = std::move(animation);
@@ -95,6 +98,98 @@ IAnimation* AnimationManager::addAnimation(const std::string& name, glm::detail:
 	return animationPointer;
 }
 
+void AnimationManager::addAnimationInstance(IAnimationInstance* instance)
+{
+	std::lock_guard<std::mutex> lock(accessMutex_);
+	
+	if ( std::find(animationInstances_.begin(), animationInstances_.end(), instance) == animationInstances_.end() )
+	{
+		animationInstances_.push_back( instance );
+	}
+}
+
+void AnimationManager::removeAnimationInstance(IAnimationInstance* instance)
+{
+	std::lock_guard<std::mutex> updateLock(updateMutex_);
+	std::lock_guard<std::mutex> lock(accessMutex_);
+	
+	auto it = std::find(animationInstances_.begin(), animationInstances_.end(), instance);
+	if ( it != animationInstances_.end() )
+	{
+		// Order doesn't matter
+		*it = animationInstances_.back();
+		animationInstances_.pop_back();
+	}
+}
+
+void AnimationManager::update(glm::detail::float32 timeDelta)
+{
+	std::lock_guard<std::mutex> updateLock(updateMutex_);
+	
+	typedef std::chrono::duration<glm::detail::float64, std::milli> Milliseconds;
+	const auto start = std::chrono::steady_clock::now();
+	
+	{
+		std::lock_guard<std::mutex> lock(accessMutex_);
+		
+		updateInstances_.assign( animationInstances_.begin(), animationInstances_.end() );
+	}
+	
+	const auto gatherEnd = std::chrono::steady_clock::now();
+	
+	auto statistics = AnimationStatistics();
+	statistics.numberOfInstances = updateInstances_.size();
+	
+	if ( !updateInstances_.empty() )
+	{
+		if (threadPool_ == nullptr)
+		{
+			threadPool_ = std::unique_ptr<ThreadPool>( new ThreadPool(numberOfThreads_) );
+		}
+		
+		// The calling thread runs jobs too
+		statistics.numberOfThreads = threadPool_->getNumberOfThreads() + 1;
+		
+		// A few jobs per thread, so threads that finish early can take work from the others (instances can take very different
+		// amounts of time to update)
+		const glm::detail::uint32 chunkSize = std::max( statistics.numberOfInstances / (statistics.numberOfThreads * 4), 1u );
+		
+		jobTimes_.assign( (statistics.numberOfInstances - 1) / chunkSize + 1, 0.0 );
+		
+		statistics.numberOfJobs = threadPool_->parallelFor( statistics.numberOfInstances, chunkSize, [this, timeDelta, chunkSize](glm::detail::uint32 begin, glm::detail::uint32 end) {
+			const auto jobStart = std::chrono::steady_clock::now();
+			
+			for (glm::detail::uint32 i = begin; i < end; i++)
+			{
+				updateInstances_[i]->updateAnimation( timeDelta );
+			}
+			
+			jobTimes_[begin / chunkSize] = Milliseconds( std::chrono::steady_clock::now() - jobStart ).count();
+		} );
+		
+		for ( auto t : jobTimes_ )
+		{
+			statistics.workerTime += t;
+		}
+	}
+	
+	const auto end = std::chrono::steady_clock::now();
+	
+	statistics.gatherTime = Milliseconds( gatherEnd - start ).count();
+	statistics.evaluateTime = Milliseconds( end - gatherEnd ).count();
+	statistics.updateTime = Milliseconds( end - start ).count();
+	
+	std::lock_guard<std::mutex> lock(accessMutex_);
+	statistics_ = statistics;
+}
+
+AnimationStatistics AnimationManager::getStatistics() const
+{
+	std::lock_guard<std::mutex> lock(accessMutex_);
+	
+	return statistics_;
+}
+
 void AnimationManager::serialize(const std::string& filename)
 {
 	std::ofstream ofs(filename.c_str());
@@ -156,7 +251,7 @@ template<class Archive> void AnimationManager::load(Archive& ar, const unsigned
 		auto s = std::string();
 		ar & s;
 		
-		auto animation = std::unique_ptr<Animation>( new Animation(openGlDevice_, s) );
+		auto animation = std::unique_ptr<Animation>( new Animation(openGlDevice_, s, true, compression_) );
 		ar & *(animation.get());
 		
 		animations_[s] = std::move(animation);
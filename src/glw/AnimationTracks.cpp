@@ -0,0 +1,299 @@
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+#include "glw/AnimationTracks.hpp"
+
+namespace glr
+{
+namespace glw
+{
+
+/** Anonymous helper functions. */
+namespace
+{
+
+/**
+ * Finds the pair of keys in [begin, end) to interpolate between at the given time, and how far between them the time is.  Times before
+ * the first key, or after the last key, hold the first or last key.
+ *
+ * @return The index of the first key of the pair (the second is the next key, unless there is only one key).
+ */
+glmd::uint32 findKey(const std::vector< glmd::float32 >& times, glmd::uint32 begin, glmd::uint32 end, glmd::float32 animationTime, glmd::float32& factor)
+{
+	assert( end > begin );
+	
+	factor = 0.0f;
+	
+	if (end - begin == 1 || animationTime <= times[begin])
+	{
+		return begin;
+	}
+	
+	if (animationTime >= times[end - 1])
+	{
+		factor = 1.0f;
+		return end - 2;
+	}
+	
+	// The first key after the time - there is always one before it
+	const glmd::uint32 next = std::upper_bound( times.begin() + begin, times.begin() + end, animationTime ) - times.begin();
+	const glmd::uint32 key = next - 1;
+	
+	const glmd::float32 deltaTime = times[next] - times[key];
+	factor = (deltaTime > 0.0f ? (animationTime - times[key]) / deltaTime : 0.0f);
+	
+	return key;
+}
+
+template<class Keys> void append(Keys& keys, const std::vector< glmd::float64 >& times)
+{
+	for ( auto t : times )
+	{
+		keys.times.push_back( (glmd::float32)t );
+	}
+	
+	keys.keyOffsets.push_back( keys.times.size() );
+}
+
+}
+
+AnimationTracks::AnimationTracks()
+{
+	positions_.keyOffsets.push_back( 0 );
+	rotations_.keyOffsets.push_back( 0 );
+	scalings_.keyOffsets.push_back( 0 );
+}
+
+AnimationTracks::AnimationTracks(const std::map< std::string, AnimatedBoneNode >& animatedBoneNodes) : AnimationTracks()
+{
+	for ( auto& kv : animatedBoneNodes )
+	{
+		const AnimatedBoneNode& abn = kv.second;
+		
+		assert( abn.positionTimes.size() == abn.positions.size() );
+		assert( abn.rotationTimes.size() == abn.rotations.size() );
+		assert( abn.scalingTimes.size() == abn.scalings.size() );
+		
+		// Tracks are looked up by the key in the map - that's what the bone node tree was matched against
+		names_.push_back( kv.first );
+		
+		for ( auto& p : abn.positions )
+		{
+			positions_.x.push_back( p.x );
+			positions_.y.push_back( p.y );
+			positions_.z.push_back( p.z );
+		}
+		
+		for ( auto& r : abn.rotations )
+		{
+			rotations_.x.push_back( r.x );
+			rotations_.y.push_back( r.y );
+			rotations_.z.push_back( r.z );
+			rotations_.w.push_back( r.w );
+		}
+		
+		for ( auto& s : abn.scalings )
+		{
+			scalings_.x.push_back( s.x );
+			scalings_.y.push_back( s.y );
+			scalings_.z.push_back( s.z );
+		}
+		
+		append( positions_, abn.positionTimes );
+		append( rotations_, abn.rotationTimes );
+		append( scalings_, abn.scalingTimes );
+		
+		hasSharedKeyTimes_.push_back( abn.rotationTimes == abn.positionTimes && abn.scalingTimes == abn.positionTimes );
+	}
+}
+
+glmd::uint32 AnimationTracks::getNumberOfTracks() const
+{
+	return names_.size();
+}
+
+const std::vector< std::string >& AnimationTracks::getNames() const
+{
+	return names_;
+}
+
+glmd::uint32 AnimationTracks::getMemoryUsage() const
+{
+	auto keysMemoryUsage = [](const std::vector< glmd::uint32 >& keyOffsets, glmd::uint32 numberOfKeys, glmd::uint32 numberOfComponents) {
+		return keyOffsets.size() * sizeof(glmd::uint32) + numberOfKeys * (numberOfComponents + 1) * sizeof(glmd::float32);
+	};
+	
+	return keysMemoryUsage( positions_.keyOffsets, positions_.times.size(), 3 )
+		+ keysMemoryUsage( rotations_.keyOffsets, rotations_.times.size(), 4 )
+		+ keysMemoryUsage( scalings_.keyOffsets, scalings_.times.size(), 3 )
+		+ (hasSharedKeyTimes_.size() + 7) / 8;
+}
+
+std::vector< glmd::int32 > AnimationTracks::bindNodes(const Skeleton& skeleton) const
+{
+	auto nodeTracks = std::vector< glmd::int32 >( skeleton.getNumberOfNodes(), -1 );
+	
+	const auto& names = skeleton.getNames();
+	
+	for ( glmd::uint32 i = 0; i < names.size(); i++ )
+	{
+		auto it = std::lower_bound( names_.begin(), names_.end(), names[i] );
+		
+		// Tracks without any keys can't be sampled - they leave the node at its bind transformation
+		if ( it != names_.end() && *it == names[i] )
+		{
+			const glmd::uint32 track = it - names_.begin();
+			
+			if ( positions_.keyOffsets[track + 1] > positions_.keyOffsets[track]
+				&& rotations_.keyOffsets[track + 1] > rotations_.keyOffsets[track]
+				&& scalings_.keyOffsets[track + 1] > scalings_.keyOffsets[track] )
+			{
+				nodeTracks[i] = (glmd::int32)track;
+			}
+		}
+	}
+	
+	return nodeTracks;
+}
+
+void AnimationTracks::calculateLocalTransformation(glm::mat4& transformation, glmd::uint32 track, glmd::float32 animationTime, glmd::uint32 startFrame, glmd::uint32 endFrame) const
+{
+	assert( track < names_.size() );
+	
+	glm::vec3 translation;
+	glm::quat rotation;
+	glm::vec3 scaling;
+	sampleTrack( track, clampToFrames(track, animationTime, startFrame, endFrame), translation, rotation, scaling );
+	
+	// translation * rotation * scaling, without building (and multiplying) the three matrices
+	transformation = glm::mat4_cast( rotation );
+	transformation[0] = transformation[0] * scaling.x;
+	transformation[1] = transformation[1] * scaling.y;
+	transformation[2] = transformation[2] * scaling.z;
+	transformation[3] = glm::vec4( translation.x, translation.y, translation.z, 1.0f );
+}
+
+void AnimationTracks::calculateLocalPose(SkeletonPose& pose, const std::vector< glmd::int32 >& nodeTracks, glmd::float32 animationTime, glmd::uint32 startFrame, glmd::uint32 endFrame) const
+{
+	assert( pose.getNumberOfNodes() == nodeTracks.size() );
+	
+	glm::vec3 translation;
+	glm::quat rotation;
+	glm::vec3 scaling;
+	
+	for ( glmd::uint32 i = 0; i < nodeTracks.size(); i++ )
+	{
+		if ( nodeTracks[i] >= 0 )
+		{
+			sampleTrack( nodeTracks[i], clampToFrames(nodeTracks[i], animationTime, startFrame, endFrame), translation, rotation, scaling );
+			pose.setTransformation( i, translation, rotation, scaling );
+		}
+	}
+}
+
+glmd::float32 AnimationTracks::clampToFrames(glmd::uint32 track, glmd::float32 animationTime, glmd::uint32 startFrame, glmd::uint32 endFrame) const
+{
+	// Clamp animation time between start and end frame (the frames are position keys)
+	if ( startFrame > 0 || endFrame > 0 )
+	{
+		const glmd::uint32 begin = positions_.keyOffsets[track];
+		const glmd::uint32 last = positions_.keyOffsets[track + 1] - 1;
+		
+		const glmd::float32 st = positions_.times[ std::min(begin + startFrame, last) ];
+		const glmd::float32 et = positions_.times[ std::min(begin + endFrame, last) ];
+		
+		animationTime = (et > 0.0f ? std::fmod(animationTime, et) : 0.0f) + st;
+	}
+	
+	return animationTime;
+}
+
+void AnimationTracks::sampleTrack(glmd::uint32 track, glmd::float32 animationTime, glm::vec3& translation, glm::quat& rotation, glm::vec3& scaling) const
+{
+	const glmd::uint32 begin = positions_.keyOffsets[track];
+	const glmd::uint32 end = positions_.keyOffsets[track + 1];
+	
+	// Interpolate translation
+	glmd::float32 factor = 0.0f;
+	glmd::uint32 key = findKey( positions_.times, begin, end, animationTime, factor );
+	glmd::uint32 next = std::min( key + 1, end - 1 );
+	
+	translation.x = positions_.x[key] + factor * (positions_.x[next] - positions_.x[key]);
+	translation.y = positions_.y[key] + factor * (positions_.y[next] - positions_.y[key]);
+	translation.z = positions_.z[key] + factor * (positions_.z[next] - positions_.z[key]);
+	
+	// The keys found within the track - each channel has its own offsets, since tracks can have a different number of keys per channel
+	const glmd::uint32 trackKey = key - begin;
+	const glmd::uint32 trackNext = next - begin;
+	
+	// Interpolate rotation (usually at the same times as the translation - then there's no need to search again)
+	if ( hasSharedKeyTimes_[track] )
+	{
+		key = rotations_.keyOffsets[track] + trackKey;
+		next = rotations_.keyOffsets[track] + trackNext;
+	}
+	else
+	{
+		key = findKey( rotations_.times, rotations_.keyOffsets[track], rotations_.keyOffsets[track + 1], animationTime, factor );
+		next = std::min( key + 1, rotations_.keyOffsets[track + 1] - 1 );
+	}
+	
+	const glm::quat startRotation = glm::quat( rotations_.w[key], rotations_.x[key], rotations_.y[key], rotations_.z[key] );
+	const glm::quat endRotation = glm::quat( rotations_.w[next], rotations_.x[next], rotations_.y[next], rotations_.z[next] );
+	rotation = glm::normalize( glm::slerp(startRotation, endRotation, factor) );
+	
+	// Interpolate scaling
+	if ( hasSharedKeyTimes_[track] )
+	{
+		key = scalings_.keyOffsets[track] + trackKey;
+		next = scalings_.keyOffsets[track] + trackNext;
+	}
+	else
+	{
+		key = findKey( scalings_.times, scalings_.keyOffsets[track], scalings_.keyOffsets[track + 1], animationTime, factor );
+		next = std::min( key + 1, scalings_.keyOffsets[track + 1] - 1 );
+	}
+	
+	scaling.x = scalings_.x[key] + factor * (scalings_.x[next] - scalings_.x[key]);
+	scaling.y = scalings_.y[key] + factor * (scalings_.y[next] - scalings_.y[key]);
+	scaling.z = scalings_.z[key] + factor * (scalings_.z[next] - scalings_.z[key]);
+}
+
+void AnimationTracks::calculateGlobalTransformations(
+	std::vector< glm::mat4 >& globalTransformations,
+	const Skeleton& skeleton,
+	const std::vector< glmd::int32 >& nodeTracks,
+	glmd::float32 animationTime,
+	glmd::uint32 startFrame,
+	glmd::uint32 endFrame,
+	const glm::mat4& rootParentTransformation
+) const
+{
+	const glmd::uint32 numberOfNodes = skeleton.getNumberOfNodes();
+	const auto& parents = skeleton.getParents();
+	const auto& transformations = skeleton.getTransformations();
+	
+	assert( globalTransformations.size() >= numberOfNodes );
+	assert( nodeTracks.size() == numberOfNodes );
+	
+	glm::mat4 local = glm::mat4();
+	
+	// Parents come before their children, so their global transformation is always ready
+	for ( glmd::uint32 i = 0; i < numberOfNodes; i++ )
+	{
+		const glm::mat4* nodeTransformation = &transformations[i];
+		
+		if ( nodeTracks[i] >= 0 )
+		{
+			calculateLocalTransformation( local, nodeTracks[i], animationTime, startFrame, endFrame );
+			nodeTransformation = &local;
+		}
+		
+		const glm::mat4& parentTransformation = (parents[i] >= 0 ? globalTransformations[ parents[i] ] : rootParentTransformation);
+		globalTransformations[i] = parentTransformation * (*nodeTransformation);
+	}
+}
+
+}
+}
@@ -0,0 +1,567 @@
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+
+#include "glw/BlendTree.hpp"
+
+#include "common/logger/Logger.hpp"
+
+#include "exceptions/InvalidArgumentException.hpp"
+
+namespace glr
+{
+namespace glw
+{
+
+/** Anonymous helper functions. */
+namespace
+{
+
+/**
+ * Copies a pose into a pose of the same size - without allocating.
+ */
+void copyPose(SkeletonPose& pose, const SkeletonPose& other)
+{
+	assert( pose.getNumberOfNodes() == other.getNumberOfNodes() );
+	
+	std::copy( other.tx.begin(), other.tx.end(), pose.tx.begin() );
+	std::copy( other.ty.begin(), other.ty.end(), pose.ty.begin() );
+	std::copy( other.tz.begin(), other.tz.end(), pose.tz.begin() );
+	
+	std::copy( other.rx.begin(), other.rx.end(), pose.rx.begin() );
+	std::copy( other.ry.begin(), other.ry.end(), pose.ry.begin() );
+	std::copy( other.rz.begin(), other.rz.end(), pose.rz.begin() );
+	std::copy( other.rw.begin(), other.rw.end(), pose.rw.begin() );
+	
+	std::copy( other.sx.begin(), other.sx.end(), pose.sx.begin() );
+	std::copy( other.sy.begin(), other.sy.end(), pose.sy.begin() );
+	std::copy( other.sz.begin(), other.sz.end(), pose.sz.begin() );
+}
+
+/**
+ * Blends node i of pose towards node i of other by factor - a lerp of the translation and scaling, and a normalized lerp (along the
+ * shortest path) of the rotation.
+ */
+void blendNode(SkeletonPose& pose, const SkeletonPose& other, glmd::uint32 i, glmd::float32 factor)
+{
+	pose.tx[i] += factor * (other.tx[i] - pose.tx[i]);
+	pose.ty[i] += factor * (other.ty[i] - pose.ty[i]);
+	pose.tz[i] += factor * (other.tz[i] - pose.tz[i]);
+	
+	const glmd::float32 dot = pose.rx[i] * other.rx[i] + pose.ry[i] * other.ry[i] + pose.rz[i] * other.rz[i] + pose.rw[i] * other.rw[i];
+	const glmd::float32 sign = (dot < 0.0f ? -1.0f : 1.0f);
+	
+	const glmd::float32 x = pose.rx[i] + factor * (sign * other.rx[i] - pose.rx[i]);
+	const glmd::float32 y = pose.ry[i] + factor * (sign * other.ry[i] - pose.ry[i]);
+	const glmd::float32 z = pose.rz[i] + factor * (sign * other.rz[i] - pose.rz[i]);
+	const glmd::float32 w = pose.rw[i] + factor * (sign * other.rw[i] - pose.rw[i]);
+	const glmd::float32 inverseLength = 1.0f / std::sqrt( x * x + y * y + z * z + w * w );
+	
+	pose.rx[i] = x * inverseLength;
+	pose.ry[i] = y * inverseLength;
+	pose.rz[i] = z * inverseLength;
+	pose.rw[i] = w * inverseLength;
+	
+	pose.sx[i] += factor * (other.sx[i] - pose.sx[i]);
+	pose.sy[i] += factor * (other.sy[i] - pose.sy[i]);
+	pose.sz[i] += factor * (other.sz[i] - pose.sz[i]);
+}
+
+/**
+ * Returns how much to scale a component by, to add the difference between an additive scaling and its reference.
+ */
+glmd::float32 getAdditiveScaling(glmd::float32 additive, glmd::float32 reference, glmd::float32 weight)
+{
+	return (reference != 0.0f ? 1.0f + weight * (additive / reference - 1.0f) : 1.0f);
+}
+
+}
+
+BlendTree::BlendTree() : root_(-1), skeletonId_(0), evaluation_(0), numberOfActiveClips_(0), isDirty_(true)
+{
+}
+
+glmd::uint32 BlendTree::addClip(IAnimation* animation, glmd::float32 animationTime, glmd::float32 speed)
+{
+	return addClip( animation, 0, 0, animationTime, speed );
+}
+
+glmd::uint32 BlendTree::addClip(IAnimation* animation, glmd::uint32 startFrame, glmd::uint32 endFrame, glmd::float32 animationTime, glmd::float32 speed)
+{
+	if (animation == nullptr)
+	{
+		std::string msg = std::string("Cannot add a clip without an animation to a blend tree.");
+		LOG_ERROR( msg );
+		throw exception::InvalidArgumentException( msg );
+	}
+	
+	Node node = Node();
+	node.type = CLIP;
+	node.animation = animation;
+	node.animationTime = animationTime;
+	node.speed = speed;
+	node.startFrame = startFrame;
+	node.endFrame = endFrame;
+	
+	return addNode( std::move(node) );
+}
+
+glmd::uint32 BlendTree::addBlend(const std::vector< glmd::uint32 >& children, const std::vector< glmd::float32 >& weights)
+{
+	if (children.empty() || (!weights.empty() && weights.size() != children.size()))
+	{
+		std::string msg = std::string("A blend node must have at least one child, and a weight for each child.");
+		LOG_ERROR( msg );
+		throw exception::InvalidArgumentException( msg );
+	}
+	
+	Node node = Node();
+	node.type = BLEND;
+	node.children = children;
+	node.weights = (weights.empty() ? std::vector< glmd::float32 >( children.size(), 1.0f ) : weights);
+	
+	return addNode( std::move(node) );
+}
+
+glmd::uint32 BlendTree::addLerp(glmd::uint32 a, glmd::uint32 b, glmd::float32 factor)
+{
+	Node node = Node();
+	node.type = LERP;
+	node.children = { a, b };
+	node.weights = { 1.0f - factor, factor };
+	
+	return addNode( std::move(node) );
+}
+
+glmd::uint32 BlendTree::addAdditive(glmd::uint32 base, glmd::uint32 additive, glmd::int32 reference, glmd::float32 weight)
+{
+	Node node = Node();
+	node.type = ADDITIVE;
+	node.children = { base, additive };
+	node.reference = reference;
+	node.weight = weight;
+	
+	if (reference >= 0)
+	{
+		node.children.push_back( (glmd::uint32)reference );
+	}
+	
+	return addNode( std::move(node) );
+}
+
+glmd::uint32 BlendTree::addLayer(glmd::uint32 base, glmd::uint32 layer, const std::vector< std::string >& maskNodeNames, glmd::float32 weight)
+{
+	Node node = Node();
+	node.type = LAYER;
+	node.children = { base, layer };
+	node.maskNodeNames = maskNodeNames;
+	node.weight = weight;
+	
+	return addNode( std::move(node) );
+}
+
+glmd::uint32 BlendTree::addNode(Node node)
+{
+	// Children have to be added first, so the tree can't have any cycles
+	for ( auto child : node.children )
+	{
+		if (child >= nodes_.size())
+		{
+			std::string msg = std::string("Blend tree nodes can only have nodes that have already been added as children.");
+			LOG_ERROR( msg );
+			throw exception::InvalidArgumentException( msg );
+		}
+	}
+	
+	node.reference = (node.type == ADDITIVE ? node.reference : -1);
+	node.evaluation = 0;
+	
+	nodes_.push_back( std::move(node) );
+	root_ = nodes_.size() - 1;
+	
+	// The new node hasn't been bound
+	skeletonId_ = 0;
+	isDirty_ = true;
+	
+	return root_;
+}
+
+BlendTree::Node& BlendTree::getNode(glmd::uint32 node)
+{
+	if (node >= nodes_.size())
+	{
+		std::string msg = std::string("Blend tree node does not exist.");
+		LOG_ERROR( msg );
+		throw exception::InvalidArgumentException( msg );
+	}
+	
+	return nodes_[node];
+}
+
+glmd::uint32 BlendTree::getNumberOfNodes() const
+{
+	return nodes_.size();
+}
+
+void BlendTree::setRoot(glmd::uint32 node)
+{
+	getNode( node );
+	
+	root_ = node;
+	isDirty_ = true;
+}
+
+void BlendTree::setWeight(glmd::uint32 node, glmd::float32 weight)
+{
+	Node& n = getNode( node );
+	
+	if (n.type == LERP)
+	{
+		n.weights[0] = 1.0f - weight;
+		n.weights[1] = weight;
+	}
+	else if (n.type == ADDITIVE || n.type == LAYER)
+	{
+		n.weight = weight;
+	}
+	else
+	{
+		std::string msg = std::string("Only lerp, additive and layer blend tree nodes have a weight.");
+		LOG_ERROR( msg );
+		throw exception::InvalidArgumentException( msg );
+	}
+	
+	isDirty_ = true;
+}
+
+void BlendTree::setWeights(glmd::uint32 node, const std::vector< glmd::float32 >& weights)
+{
+	Node& n = getNode( node );
+	
+	if (n.type != BLEND || weights.size() != n.weights.size())
+	{
+		std::string msg = std::string("Only blend nodes have weights, and they must have a weight for each child.");
+		LOG_ERROR( msg );
+		throw exception::InvalidArgumentException( msg );
+	}
+	
+	// Copied into the existing weights, so setting the weights every frame doesn't allocate
+	std::copy( weights.begin(), weights.end(), n.weights.begin() );
+	isDirty_ = true;
+}
+
+void BlendTree::setAnimationTime(glmd::uint32 clip, glmd::float32 animationTime)
+{
+	Node& n = getNode( clip );
+	
+	if (n.type != CLIP)
+	{
+		std::string msg = std::string("Only clip blend tree nodes have an animation time.");
+		LOG_ERROR( msg );
+		throw exception::InvalidArgumentException( msg );
+	}
+	
+	n.animationTime = animationTime;
+	isDirty_ = true;
+}
+
+void BlendTree::setSpeed(glmd::uint32 clip, glmd::float32 speed)
+{
+	Node& n = getNode( clip );
+	
+	if (n.type != CLIP)
+	{
+		std::string msg = std::string("Only clip blend tree nodes have a speed.");
+		LOG_ERROR( msg );
+		throw exception::InvalidArgumentException( msg );
+	}
+	
+	n.speed = speed;
+}
+
+void BlendTree::advance(glmd::float32 timeDelta)
+{
+	if (timeDelta == 0.0f)
+	{
+		return;
+	}
+	
+	for ( auto& node : nodes_ )
+	{
+		if (node.type == CLIP)
+		{
+			node.animationTime += timeDelta * node.speed;
+		}
+	}
+	
+	isDirty_ = true;
+}
+
+bool BlendTree::isDirty() const
+{
+	return isDirty_;
+}
+
+glmd::uint32 BlendTree::getNumberOfActiveClips() const
+{
+	return numberOfActiveClips_;
+}
+
+void BlendTree::bind(const Skeleton& skeleton)
+{
+	const auto& parents = skeleton.getParents();
+	const auto& names = skeleton.getNames();
+	
+	for ( auto& node : nodes_ )
+	{
+		node.pose = skeleton.getBindPose();
+		node.evaluation = 0;
+		
+		if (node.type == CLIP)
+		{
+			node.nodeTracks = node.animation->bindNodes( skeleton );
+		}
+		else if (node.type == LAYER)
+		{
+			// Parents come before their children, so a node is masked if it's named in the mask, or its parent is masked
+			node.mask.assign( skeleton.getNumberOfNodes(), 0.0f );
+			
+			for ( glmd::uint32 i = 0; i < skeleton.getNumberOfNodes(); i++ )
+			{
+				const bool isNamed = std::find( node.maskNodeNames.begin(), node.maskNodeNames.end(), names[i] ) != node.maskNodeNames.end();
+				
+				node.mask[i] = (isNamed || (parents[i] >= 0 && node.mask[ parents[i] ] > 0.0f) ? 1.0f : 0.0f);
+			}
+		}
+	}
+	
+	evaluation_ = 0;
+	skeletonId_ = skeleton.getId();
+	isDirty_ = true;
+}
+
+void BlendTree::calculatePose(
+	std::vector< glm::mat4 >& transformations,
+	std::vector< glm::mat4 >& globalTransformations,
+	const glm::mat4& globalInverseTransformation,
+	const Skeleton& skeleton,
+	const SkeletonBones& bones
+)
+{
+	assert( transformations.size() >= bones.numberOfBones );
+	
+	const SkeletonPose& pose = calculateLocalPose( skeleton );
+	
+	if ( globalTransformations.size() < skeleton.getNumberOfNodes() )
+	{
+		globalTransformations.resize( skeleton.getNumberOfNodes() );
+	}
+	
+	skeleton.calculateGlobalTransformations( globalTransformations, pose, globalInverseTransformation );
+	Skeleton::calculateBoneTransformations( transformations, globalTransformations, bones );
+}
+
+const SkeletonPose& BlendTree::calculateLocalPose(const Skeleton& skeleton)
+{
+	isDirty_ = false;
+	numberOfActiveClips_ = 0;
+	
+	if (root_ < 0)
+	{
+		return skeleton.getBindPose();
+	}
+	
+	if (skeletonId_ != skeleton.getId())
+	{
+		bind( skeleton );
+		isDirty_ = false;
+	}
+	
+	evaluation_++;
+	
+	return evaluate( root_, skeleton );
+}
+
+const SkeletonPose& BlendTree::evaluate(glmd::uint32 node, const Skeleton& skeleton)
+{
+	Node& n = nodes_[node];
+	
+	if (n.evaluation == evaluation_)
+	{
+		return n.pose;
+	}
+	
+	n.evaluation = evaluation_;
+	
+	switch (n.type)
+	{
+		case CLIP:
+			// Nodes the animation doesn't animate keep their bind transformation
+			copyPose( n.pose, skeleton.getBindPose() );
+			n.animation->calculateLocalPose( n.pose, n.nodeTracks, n.animationTime, n.startFrame, n.endFrame );
+			numberOfActiveClips_++;
+			break;
+		
+		case BLEND:
+		case LERP:
+			evaluateBlend( n, skeleton );
+			break;
+		
+		case ADDITIVE:
+			evaluateAdditive( n, skeleton );
+			break;
+		
+		case LAYER:
+			evaluateLayer( n, skeleton );
+			break;
+	}
+	
+	return n.pose;
+}
+
+void BlendTree::evaluateBlend(Node& node, const Skeleton& skeleton)
+{
+	glmd::float32 totalWeight = 0.0f;
+	for ( auto w : node.weights )
+	{
+		totalWeight += std::max( w, 0.0f );
+	}
+	
+	if (totalWeight <= 0.0f)
+	{
+		copyPose( node.pose, skeleton.getBindPose() );
+		return;
+	}
+	
+	SkeletonPose& pose = node.pose;
+	const glmd::uint32 numberOfNodes = pose.getNumberOfNodes();
+	
+	bool isFirstChild = true;
+	
+	for ( glmd::uint32 c = 0; c < node.children.size(); c++ )
+	{
+		// Children with no weight aren't evaluated at all
+		if (node.weights[c] <= 0.0f)
+		{
+			continue;
+		}
+		
+		const glmd::float32 weight = node.weights[c] / totalWeight;
+		const SkeletonPose& child = evaluate( node.children[c], skeleton );
+		
+		if (isFirstChild)
+		{
+			for ( glmd::uint32 i = 0; i < numberOfNodes; i++ )
+			{
+				pose.tx[i] = weight * child.tx[i];
+				pose.ty[i] = weight * child.ty[i];
+				pose.tz[i] = weight * child.tz[i];
+				pose.rx[i] = weight * child.rx[i];
+				pose.ry[i] = weight * child.ry[i];
+				pose.rz[i] = weight * child.rz[i];
+				pose.rw[i] = weight * child.rw[i];
+				pose.sx[i] = weight * child.sx[i];
+				pose.sy[i] = weight * child.sy[i];
+				pose.sz[i] = weight * child.sz[i];
+			}
+			
+			isFirstChild = false;
+			continue;
+		}
+		
+		for ( glmd::uint32 i = 0; i < numberOfNodes; i++ )
+		{
+			pose.tx[i] += weight * child.tx[i];
+			pose.ty[i] += weight * child.ty[i];
+			pose.tz[i] += weight * child.tz[i];
+			
+			// Rotations are accumulated along the shortest path from the rotations accumulated so far
+			const glmd::float32 dot = pose.rx[i] * child.rx[i] + pose.ry[i] * child.ry[i] + pose.rz[i] * child.rz[i] + pose.rw[i] * child.rw[i];
+			const glmd::float32 rotationWeight = (dot < 0.0f ? -weight : weight);
+			
+			pose.rx[i] += rotationWeight * child.rx[i];
+			pose.ry[i] += rotationWeight * child.ry[i];
+			pose.rz[i] += rotationWeight * child.rz[i];
+			pose.rw[i] += rotationWeight * child.rw[i];
+			
+			pose.sx[i] += weight * child.sx[i];
+			pose.sy[i] += weight * child.sy[i];
+			pose.sz[i] += weight * child.sz[i];
+		}
+	}
+	
+	for ( glmd::uint32 i = 0; i < numberOfNodes; i++ )
+	{
+		const glmd::float32 inverseLength = 1.0f / std::sqrt( pose.rx[i] * pose.rx[i] + pose.ry[i] * pose.ry[i] + pose.rz[i] * pose.rz[i] + pose.rw[i] * pose.rw[i] );
+		
+		pose.rx[i] *= inverseLength;
+		pose.ry[i] *= inverseLength;
+		pose.rz[i] *= inverseLength;
+		pose.rw[i] *= inverseLength;
+	}
+}
+
+void BlendTree::evaluateAdditive(Node& node, const Skeleton& skeleton)
+{
+	SkeletonPose& pose = node.pose;
+	copyPose( pose, evaluate(node.children[0], skeleton) );
+	
+	if (node.weight <= 0.0f)
+	{
+		return;
+	}
+	
+	const SkeletonPose& additive = evaluate( node.children[1], skeleton );
+	const SkeletonPose& reference = (node.reference >= 0 ? evaluate(node.reference, skeleton) : skeleton.getBindPose());
+	const glmd::float32 weight = node.weight;
+	
+	for ( glmd::uint32 i = 0; i < pose.getNumberOfNodes(); i++ )
+	{
+		pose.tx[i] += weight * (additive.tx[i] - reference.tx[i]);
+		pose.ty[i] += weight * (additive.ty[i] - reference.ty[i]);
+		pose.tz[i] += weight * (additive.tz[i] - reference.tz[i]);
+		
+		// The rotation from the reference to the additive rotation, scaled by the weight (a normalized lerp from the identity)
+		glm::quat delta = glm::conjugate( glm::quat(reference.rw[i], reference.rx[i], reference.ry[i], reference.rz[i]) ) * glm::quat( additive.rw[i], additive.rx[i], additive.ry[i], additive.rz[i] );
+		
+		const glmd::float32 sign = (delta.w < 0.0f ? -1.0f : 1.0f);
+		delta = glm::normalize( glm::quat(1.0f + weight * (sign * delta.w - 1.0f), weight * sign * delta.x, weight * sign * delta.y, weight * sign * delta.z) );
+		
+		const glm::quat rotation = glm::quat( pose.rw[i], pose.rx[i], pose.ry[i], pose.rz[i] ) * delta;
+		
+		pose.rx[i] = rotation.x;
+		pose.ry[i] = rotation.y;
+		pose.rz[i] = rotation.z;
+		pose.rw[i] = rotation.w;
+		
+		pose.sx[i] *= getAdditiveScaling( additive.sx[i], reference.sx[i], weight );
+		pose.sy[i] *= getAdditiveScaling( additive.sy[i], reference.sy[i], weight );
+		pose.sz[i] *= getAdditiveScaling( additive.sz[i], reference.sz[i], weight );
+	}
+}
+
+void BlendTree::evaluateLayer(Node& node, const Skeleton& skeleton)
+{
+	SkeletonPose& pose = node.pose;
+	copyPose( pose, evaluate(node.children[0], skeleton) );
+	
+	if (node.weight <= 0.0f)
+	{
+		return;
+	}
+	
+	const SkeletonPose& layer = evaluate( node.children[1], skeleton );
+	const glmd::float32 weight = std::min( node.weight, 1.0f );
+	
+	for ( glmd::uint32 i = 0; i < pose.getNumberOfNodes(); i++ )
+	{
+		if (node.mask[i] > 0.0f)
+		{
+			blendNode( pose, layer, i, weight * node.mask[i] );
+		}
+	}
+}
+
+}
+}
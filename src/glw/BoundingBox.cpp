@@ -0,0 +1,109 @@
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "glw/BoundingBox.hpp"
+
+namespace glr
+{
+namespace glw
+{
+
+BoundingBox::BoundingBox()
+	: min( glm::vec3(std::numeric_limits<glmd::float32>::max()) ), max( glm::vec3(-std::numeric_limits<glmd::float32>::max()) )
+{
+}
+
+BoundingBox::BoundingBox(const glm::vec3& min, const glm::vec3& max) : min(min), max(max)
+{
+}
+
+bool BoundingBox::isEmpty() const
+{
+	return (min.x > max.x || min.y > max.y || min.z > max.z);
+}
+
+void BoundingBox::expand(const glm::vec3& point)
+{
+	min = glm::vec3( std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z) );
+	max = glm::vec3( std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z) );
+}
+
+void BoundingBox::expand(const BoundingBox& other)
+{
+	if (other.isEmpty())
+	{
+		return;
+	}
+	
+	expand( other.min );
+	expand( other.max );
+}
+
+glm::vec3 BoundingBox::getCenter() const
+{
+	return (min + max) * 0.5f;
+}
+
+glm::vec3 BoundingBox::getExtents() const
+{
+	return (max - min) * 0.5f;
+}
+
+glmd::float32 BoundingBox::getSurfaceArea() const
+{
+	if (isEmpty())
+	{
+		return 0.0f;
+	}
+	
+	const glm::vec3 size = max - min;
+	
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+bool BoundingBox::contains(const BoundingBox& other) const
+{
+	return (min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z && other.max.x <= max.x && other.max.y <= max.y && other.max.z <= max.z);
+}
+
+BoundingBox BoundingBox::transform(const glm::mat4& matrix) const
+{
+	if (isEmpty())
+	{
+		return BoundingBox();
+	}
+	
+	// Transform the center, and find the extents of the rotated and scaled box along each axis (Arvo, Graphics Gems 1990)
+	const glm::vec3 center = getCenter();
+	const glm::vec3 extents = getExtents();
+	
+	glm::vec3 newCenter = glm::vec3( matrix[3][0], matrix[3][1], matrix[3][2] );
+	glm::vec3 newExtents = glm::vec3( 0.0f );
+	
+	for ( glmd::uint32 i = 0; i < 3; i++ )
+	{
+		for ( glmd::uint32 j = 0; j < 3; j++ )
+		{
+			newCenter[i] += matrix[j][i] * center[j];
+			newExtents[i] += std::abs( matrix[j][i] ) * extents[j];
+		}
+	}
+	
+	return BoundingBox( newCenter - newExtents, newCenter + newExtents );
+}
+
+BoundingBox BoundingBox::fromPoints(const std::vector< glm::vec3 >& points)
+{
+	BoundingBox box = BoundingBox();
+	
+	for ( const auto& p : points )
+	{
+		box.expand( p );
+	}
+	
+	return box;
+}
+
+}
+}
@@ -9,6 +9,13 @@ const std::string Constants::MODEL_DIRECTORY = std::string(".");
 
 const glmd::uint32 Constants::MAX_NUMBER_OF_BONES_PER_MESH = 100;
 
+// Room for about 600 bone palettes per frame
+const glmd::uint32 Constants::STREAMING_BUFFER_REGION_SIZE = 4 * 1024 * 1024;
+const glmd::uint32 Constants::STREAMING_BUFFER_NUMBER_OF_REGIONS = 3;
+
+// 1 MB of model matrices - a quarter of a streaming buffer region
+const glmd::uint32 Constants::MAX_NUMBER_OF_INSTANCES_PER_DRAW = 16384;
+
 const std::string Constants::GLR_IDENTITY_BONES = std::string("GLR_IDENTITY_BONES");
 
 }
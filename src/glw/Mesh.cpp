@@ -10,6 +10,42 @@
 
 #include "exceptions/GlException.hpp"
 
+/**
+ * Anonymous helper functions.
+ */
+namespace
+{
+
+/**
+ * Returns the smallest index type that can reference every one of numberOfVertices vertices.
+ */
+GLenum getIndexType(glm::detail::uint32 numberOfVertices)
+{
+	return (numberOfVertices <= 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT);
+}
+
+glm::detail::uint32 getIndexSize(GLenum indexType)
+{
+	return (indexType == GL_UNSIGNED_SHORT ? sizeof(glm::detail::uint16) : sizeof(glm::detail::uint32));
+}
+
+/**
+ * glVertexAttribDivisor is core in OpenGL 3.3 - in OpenGL 3.2 contexts, the ARB_instanced_arrays version has to be used.
+ */
+void setVertexAttributeDivisor(GLuint location, GLuint divisor)
+{
+	if (GLEW_VERSION_3_3)
+	{
+		glVertexAttribDivisor(location, divisor);
+	}
+	else
+	{
+		glVertexAttribDivisorARB(location, divisor);
+	}
+}
+
+}
+
 namespace glr
 {
 namespace glw
@@ -56,7 +92,22 @@ Mesh::Mesh(IOpenGlDevice* openGlDevice,
 		BoneData boneData,
 		bool initialize
 	)
-	: openGlDevice_(openGlDevice), name_(std::move(name)), vertices_(std::move(vertices)), normals_(std::move(normals)), textureCoordinates_(std::move(textureCoordinates)), colors_(std::move(colors)), vertexBoneData_(std::move(vertexBoneData)), boneData_(std::move(boneData))
+	: Mesh(openGlDevice, std::move(name), std::move(vertices), std::move(normals), std::move(textureCoordinates), std::move(colors), std::move(vertexBoneData), std::move(boneData), VertexFormat(), initialize)
+{
+}
+
+Mesh::Mesh(IOpenGlDevice* openGlDevice,
+		std::string name,
+		std::vector< glm::vec3 > vertices, 
+		std::vector< glm::vec3 > normals,
+		std::vector< glm::vec2 > textureCoordinates,
+		std::vector< glm::vec4 > colors,
+		std::vector<VertexBoneData > vertexBoneData,
+		BoneData boneData,
+		VertexFormat vertexFormat,
+		bool initialize
+	)
+	: openGlDevice_(openGlDevice), name_(std::move(name)), vertices_(std::move(vertices)), normals_(std::move(normals)), textureCoordinates_(std::move(textureCoordinates)), colors_(std::move(colors)), vertexBoneData_(std::move(vertexBoneData)), boneData_(std::move(boneData)), vertexFormat_(std::move(vertexFormat))
 {
 	vaoId_ = 0;
 	
@@ -67,6 +118,10 @@ Mesh::Mesh(IOpenGlDevice* openGlDevice,
 	currentNumberOfVertices_ = 0;
 	currentVerticesSpaceAllocated_ = 0;
 	
+	// Meshes without bone data don't get bone attributes
+	if (vertexFormat_.getAttributes().empty())
+		vertexFormat_ = createDefaultVertexFormat( !vertexBoneData_.empty() );
+	
 	if (initialize)
 	{
 		loadLocalData();
@@ -117,55 +172,50 @@ void Mesh::pushToVideoMemory()
 		throw exception::GlException( msg );
 	}
 	
-	// Re-allocate memory if we need more
-	if (currentVerticesSpaceAllocated_ < vertices_.size())
+	addMissingBoneAttributes();
+	
+	// Re-allocate memory if we need more (or if the vertex layout or index type has changed)
+	const bool hasIndexTypeChanged = (indices_.size() > 0 && getIndexType(vertices_.size()) != indexType_);
+	
+	if (currentVerticesSpaceAllocated_ < vertices_.size() || currentIndicesSpaceAllocated_ < indices_.size() || hasVertexFormatChanged_ || hasIndexTypeChanged)
 	{
 		this->freeVideoMemory();
 		this->allocateVideoMemory();
 	}
 	
-	glBindVertexArray(vaoId_);
-	
-	OPENGL_CHECK_ERRORS(openGlDevice_)
+	auto vertices = std::vector< glm::detail::uint8 >();
+	packVertices( vertices );
 	
-	glBindBuffer(GL_ARRAY_BUFFER, vboIds_[0]);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, vertices_.size() * sizeof(glm::vec3), &vertices_[0]);
-
-	OPENGL_CHECK_ERRORS(openGlDevice_)
-
-	glBindBuffer(GL_ARRAY_BUFFER, vboIds_[1]);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, textureCoordinates_.size() * sizeof(glm::vec2), &textureCoordinates_[0]);
-
-	OPENGL_CHECK_ERRORS(openGlDevice_)
-
-	glBindBuffer(GL_ARRAY_BUFFER, vboIds_[2]);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, normals_.size() * sizeof(glm::vec3), &normals_[0]);
-	
-	OPENGL_CHECK_ERRORS(openGlDevice_)
-	
-	glBindBuffer(GL_ARRAY_BUFFER, vboIds_[3]);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, colors_.size() * sizeof(glm::vec4), &colors_[0]);
+	glBindVertexArray(vaoId_);
 	
 	OPENGL_CHECK_ERRORS(openGlDevice_)
 	
-	//std::cout << "SIZE: " << vertices_.size() << " " << sizeof(glm::ivec4) << " " << vertexBoneData_.size() << " " << sizeof(VertexBoneData) << std::endl;
+	// All of the vertex attributes go up in a single upload
+	if (vertices.size() > 0)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, vboId_);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size(), &vertices[0]);
+		
+		OPENGL_CHECK_ERRORS(openGlDevice_)
+	}
 	
-	// TODO: We might want to not load any bone data (if there is none) and use a different shader?  Not sure best way to handle this.....?
-	// Deal with not having any bones
-	if (vertexBoneData_.size() == 0)
+	if (indices_.size() > 0)
 	{
-		vertexBoneData_.resize( vertices_.size() );
-		for (auto& b : vertexBoneData_)
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferId_);
+		
+		if (indexType_ == GL_UNSIGNED_SHORT)
 		{
-			b.weights = glm::vec4(0.25f);
+			const auto indices = std::vector< glm::detail::uint16 >( indices_.begin(), indices_.end() );
+			glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(glm::detail::uint16), &indices[0]);
 		}
+		else
+		{
+			glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices_.size() * sizeof(glm::detail::uint32), &indices_[0]);
+		}
+		
+		OPENGL_CHECK_ERRORS(openGlDevice_)
 	}
 	
-	glBindBuffer(GL_ARRAY_BUFFER, vboIds_[4]);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, vertexBoneData_.size() * sizeof(VertexBoneData), &vertexBoneData_[0]);
-	
-	OPENGL_CHECK_ERRORS(openGlDevice_)
-	
 	glBindVertexArray(0);
 	
 	GlError err = openGlDevice_->getGlError();
@@ -180,8 +230,10 @@ void Mesh::pushToVideoMemory()
 		LOG_DEBUG( "Successfully pushed data for mesh '" + name_ + "' to video memory." );
 	}
 
-	// Save a backup of the number of vertices (in case the user frees local data)
+	// Save a backup of the number of vertices and indices, and the bounds of the vertices (in case the user frees local data)
 	currentNumberOfVertices_ = vertices_.size();
+	currentNumberOfIndices_ = indices_.size();
+	boundingBox_ = BoundingBox::fromPoints( vertices_ );
 
 	isDirty_ = false;
 }
@@ -203,6 +255,7 @@ void Mesh::freeLocalData()
 	textureCoordinates_ = std::vector< glm::vec2 >();
 	colors_ = std::vector< glm::vec4 >();
 	vertexBoneData_ = std::vector< VertexBoneData >();
+	indices_ = std::vector< glm::detail::uint32 >();
 	
 	isLocalDataLoaded_ = false;
 }
@@ -217,9 +270,17 @@ void Mesh::freeVideoMemory()
 	glBindVertexArray(0);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glDeleteVertexArrays(1, &vaoId_);
-	glDeleteBuffers(5, &vboIds_[0]);
+	glDeleteBuffers(1, &vboId_);
+	vboId_ = 0;
+	
+	if (indexBufferId_ > 0)
+	{
+		glDeleteBuffers(1, &indexBufferId_);
+		indexBufferId_ = 0;
+	}
 	
 	vaoId_ = 0;
+	currentIndicesSpaceAllocated_ = 0;
 }
 
 void Mesh::allocateVideoMemory()
@@ -231,6 +292,9 @@ void Mesh::allocateVideoMemory()
 		throw exception::GlException( msg );
 	}
 	
+	// Bone data may have been set (or deserialized) after our vertex format was chosen
+	addMissingBoneAttributes();
+	
 	// create our vao
 	glGenVertexArrays(1, &vaoId_);
 	
@@ -238,60 +302,28 @@ void Mesh::allocateVideoMemory()
 
 	OPENGL_CHECK_ERRORS(openGlDevice_)
 
-	// create our vbos
-	glGenBuffers(5, &vboIds_[0]);
+	// create our vbo - every vertex attribute is interleaved in it, as laid out by our vertex format
+	glGenBuffers(1, &vboId_);
 	
 	OPENGL_CHECK_ERRORS(openGlDevice_)
 	
-	glBindBuffer(GL_ARRAY_BUFFER, vboIds_[0]);
-	glBufferData(GL_ARRAY_BUFFER, vertices_.size() * sizeof(glm::vec3), nullptr, GL_STATIC_DRAW);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
-
-	OPENGL_CHECK_ERRORS(openGlDevice_)
-
-	glBindBuffer(GL_ARRAY_BUFFER, vboIds_[1]);
-	glBufferData(GL_ARRAY_BUFFER, textureCoordinates_.size() * sizeof(glm::vec2), nullptr, GL_STATIC_DRAW);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, 0);
+	glBindBuffer(GL_ARRAY_BUFFER, vboId_);
+	glBufferData(GL_ARRAY_BUFFER, vertices_.size() * vertexFormat_.getStride(), nullptr, GL_STATIC_DRAW);
+	vertexFormat_.setVertexAttributePointers();
 
-	OPENGL_CHECK_ERRORS(openGlDevice_)
-
-	glBindBuffer(GL_ARRAY_BUFFER, vboIds_[2]);
-	glBufferData(GL_ARRAY_BUFFER, normals_.size() * sizeof(glm::vec3), nullptr, GL_STATIC_DRAW);
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, 0);
-	
 	OPENGL_CHECK_ERRORS(openGlDevice_)
 	
-	glBindBuffer(GL_ARRAY_BUFFER, vboIds_[3]);
-	glBufferData(GL_ARRAY_BUFFER, colors_.size() * sizeof(glm::vec4), nullptr, GL_STATIC_DRAW);
-	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, 0, 0);
-	
-	OPENGL_CHECK_ERRORS(openGlDevice_)
-	
-	//std::cout << "SIZE: " << vertices_.size() << " " << sizeof(glm::ivec4) << " " << vertexBoneData_.size() << " " << sizeof(VertexBoneData) << std::endl;
-	
-	// TODO: We might want to not load any bone data (if there is none) and use a different shader?  Not sure best way to handle this.....?
-	// Deal with not having any bones
-	if (vertexBoneData_.size() == 0)
+	// The index buffer binding is part of the vao state, so it needs to be bound while our vao is bound
+	if (indices_.size() > 0)
 	{
-		vertexBoneData_.resize( vertices_.size() );
-		for (auto& b : vertexBoneData_)
-		{
-			b.weights = glm::vec4(0.25f);
-		}
+		indexType_ = getIndexType(vertices_.size());
+		
+		glGenBuffers(1, &indexBufferId_);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferId_);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices_.size() * getIndexSize(indexType_), nullptr, GL_STATIC_DRAW);
+		
+		OPENGL_CHECK_ERRORS(openGlDevice_)
 	}
-	
-	glBindBuffer(GL_ARRAY_BUFFER, vboIds_[4]);
-	glBufferData(GL_ARRAY_BUFFER, vertexBoneData_.size() * sizeof(VertexBoneData), nullptr, GL_STATIC_DRAW);
-	glEnableVertexAttribArray(4);
-	glVertexAttribIPointer(4, 4, GL_INT, sizeof(VertexBoneData), (const GLvoid*)0);
-	glEnableVertexAttribArray(5);
-	glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(VertexBoneData), (const GLvoid*)(sizeof(glm::ivec4)));
-
-	OPENGL_CHECK_ERRORS(openGlDevice_)
 
 	glBindVertexArray(0);
 	
@@ -312,6 +344,8 @@ void Mesh::allocateVideoMemory()
 	
 	// Set the current number of vertices allocated (so we know how much space we've taken up)
 	currentVerticesSpaceAllocated_ = vertices_.size();
+	currentIndicesSpaceAllocated_ = indices_.size();
+	hasVertexFormatChanged_ = false;
 	
 	isVideoMemoryAllocated_ = true;
 }
@@ -335,9 +369,66 @@ void Mesh::render()
 {
 	//glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 	glBindVertexArray(vaoId_);
+	
+	// Without bone attributes, a skinned shader reads the current generic attribute values instead - give every vertex bone 0, with
+	// a weight of 1
+	if (!vertexFormat_.isSkinned())
+	{
+		glVertexAttribI4i(VERTEX_ATTRIBUTE_LOCATION_BONE_IDS, 0, 0, 0, 0);
+		glVertexAttrib4f(VERTEX_ATTRIBUTE_LOCATION_BONE_WEIGHTS, 1.0f, 0.0f, 0.0f, 0.0f);
+	}
+
+	if (currentNumberOfIndices_ > 0)
+	{
+		glDrawElements(GL_TRIANGLES, currentNumberOfIndices_, indexType_, 0);
+	}
+	else
+	{
+		glDrawArrays(GL_TRIANGLES, 0, currentNumberOfVertices_);
+	}
+	
+	glBindVertexArray(0);
+}
 
-	glDrawArrays(GL_TRIANGLES, 0, currentNumberOfVertices_);
+void Mesh::renderInstanced(const StreamingBufferRange& instances, glm::detail::uint32 numberOfInstances)
+{
+	glBindVertexArray(vaoId_);
+	
+	if (!vertexFormat_.isSkinned())
+	{
+		glVertexAttribI4i(VERTEX_ATTRIBUTE_LOCATION_BONE_IDS, 0, 0, 0, 0);
+		glVertexAttrib4f(VERTEX_ATTRIBUTE_LOCATION_BONE_WEIGHTS, 1.0f, 0.0f, 0.0f, 0.0f);
+	}
+	
+	// The instance data moves around the streaming buffer from draw to draw, so the instance attributes are pointed at it every time
+	glBindBuffer(GL_ARRAY_BUFFER, instances.bufferId);
+	
+	for ( glm::detail::uint32 i = 0; i < 4; i++ )
+	{
+		const GLuint location = VERTEX_ATTRIBUTE_LOCATION_INSTANCE_MODEL_MATRIX + i;
+		const GLintptr offset = instances.offset + i * sizeof(glm::vec4);
+		
+		glEnableVertexAttribArray(location);
+		glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (const GLvoid*) offset);
+		setVertexAttributeDivisor(location, 1);
+	}
+	
+	if (currentNumberOfIndices_ > 0)
+	{
+		glDrawElementsInstanced(GL_TRIANGLES, currentNumberOfIndices_, indexType_, 0, numberOfInstances);
+	}
+	else
+	{
+		glDrawArraysInstanced(GL_TRIANGLES, 0, currentNumberOfVertices_, numberOfInstances);
+	}
+	
+	// Don't leave the vertex array pointing at a range that is only valid for this frame
+	for ( glm::detail::uint32 i = 0; i < 4; i++ )
+	{
+		glDisableVertexAttribArray(VERTEX_ATTRIBUTE_LOCATION_INSTANCE_MODEL_MATRIX + i);
+	}
 	
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
 }
 
@@ -386,6 +477,64 @@ void Mesh::setVertexBoneData(std::vector< VertexBoneData > vertexBoneData)
 	isDirty_ = true;
 }
 
+void Mesh::setIndices(std::vector< glm::detail::uint32 > indices)
+{
+	indices_ = std::move(indices);
+	isDirty_ = true;
+}
+
+void Mesh::setVertexFormat(VertexFormat vertexFormat)
+{
+	vertexFormat_ = std::move(vertexFormat);
+	hasVertexFormatChanged_ = true;
+	isDirty_ = true;
+}
+
+void Mesh::addMissingBoneAttributes()
+{
+	if (vertexBoneData_.empty() || vertexFormat_.isSkinned())
+		return;
+	
+	// Keep the rest of the layout (i.e. a packed format) - the bone attributes are laid out after the other attributes
+	VertexFormat vertexFormat = vertexFormat_;
+	
+	if (vertexFormat.getAttribute(VERTEX_ATTRIBUTE_LOCATION_BONE_IDS) == nullptr)
+		vertexFormat.addAttribute(VERTEX_ATTRIBUTE_LOCATION_BONE_IDS, 4, VERTEX_ATTRIBUTE_TYPE_INT32);
+	
+	if (vertexFormat.getAttribute(VERTEX_ATTRIBUTE_LOCATION_BONE_WEIGHTS) == nullptr)
+		vertexFormat.addAttribute(VERTEX_ATTRIBUTE_LOCATION_BONE_WEIGHTS, 4, VERTEX_ATTRIBUTE_TYPE_FLOAT32);
+	
+	setVertexFormat( std::move(vertexFormat) );
+}
+
+const VertexFormat& Mesh::getVertexFormat() const
+{
+	return vertexFormat_;
+}
+
+void Mesh::packVertices(std::vector< glm::detail::uint8 >& vertices) const
+{
+	// A block of vertices stays in the cache while each of its attributes is written (writing an attribute at a time across the whole
+	// buffer would stream the buffer through the cache once per attribute)
+	const glm::detail::uint32 verticesPerBlock = 1024;
+	
+	vertices.assign( vertices_.size() * vertexFormat_.getStride(), 0 );
+	
+	for ( glm::detail::uint32 i = 0; i < vertices_.size(); i += verticesPerBlock )
+	{
+		writeVertices( vertices, i, verticesPerBlock );
+	}
+}
+
+void Mesh::writeVertices(std::vector< glm::detail::uint8 >& vertices, glm::detail::uint32 firstVertex, glm::detail::uint32 numberOfVertices) const
+{
+	vertexFormat_.write( VERTEX_ATTRIBUTE_LOCATION_POSITION, vertices_, vertices, firstVertex, numberOfVertices );
+	vertexFormat_.write( VERTEX_ATTRIBUTE_LOCATION_TEXTURE, textureCoordinates_, vertices, firstVertex, numberOfVertices );
+	vertexFormat_.write( VERTEX_ATTRIBUTE_LOCATION_NORMAL, normals_, vertices, firstVertex, numberOfVertices );
+	vertexFormat_.write( VERTEX_ATTRIBUTE_LOCATION_COLOR, colors_, vertices, firstVertex, numberOfVertices );
+	vertexFormat_.write( VERTEX_ATTRIBUTE_LOCATION_BONE_IDS, VERTEX_ATTRIBUTE_LOCATION_BONE_WEIGHTS, vertexBoneData_, vertices, firstVertex, numberOfVertices );
+}
+
 std::vector< glm::vec3 >& Mesh::getVertices()
 {
 	return vertices_;
@@ -411,6 +560,16 @@ std::vector< VertexBoneData >& Mesh::getVertexBoneData()
 	return vertexBoneData_;
 }
 
+std::vector< glm::detail::uint32 >& Mesh::getIndices()
+{
+	return indices_;
+}
+
+const BoundingBox& Mesh::getBoundingBox() const
+{
+	return boundingBox_;
+}
+
 void Mesh::serialize(const std::string& filename)
 {
 	std::ofstream ofs(filename.c_str());
@@ -78,6 +78,21 @@ IMesh* MeshManager::addMesh(
 		BoneData boneData,
 		bool initialize
 	)
+{
+	return addMesh(name, std::move(vertices), std::move(normals), std::move(textureCoordinates), std::move(colors), std::move(bones), std::move(boneData), VertexFormat(), initialize);
+}
+
+IMesh* MeshManager::addMesh(
+		const std::string& name, 
+		std::vector< glm::vec3 > vertices, 
+		std::vector< glm::vec3 > normals,
+		std::vector< glm::vec2 > textureCoordinates,
+		std::vector< glm::vec4 > colors,
+		std::vector< VertexBoneData > bones,
+		BoneData boneData,
+		VertexFormat vertexFormat,
+		bool initialize
+	)
 {
 	std::lock_guard<std::mutex> lock(accessMutex_);
 	
@@ -91,7 +106,7 @@ IMesh* MeshManager::addMesh(
 	}
 
 	LOG_DEBUG( "Creating Mesh." );
-	auto mesh = std::unique_ptr<Mesh>(new Mesh(openGlDevice_, name, vertices, normals, textureCoordinates, colors, bones, boneData, initialize));
+	auto mesh = std::unique_ptr<Mesh>(new Mesh(openGlDevice_, name, vertices, normals, textureCoordinates, colors, bones, boneData, vertexFormat, initialize));
 	auto meshPointer = mesh.get();
 	
 	meshes_[name] = std::move(mesh);
@@ -73,12 +73,15 @@ void OpenGlDevice::initialize(const OpenGlDeviceSettings& settings)
 	
 	//bindings_ = std::vector< glmd::int32 >( 1000, -1 );
 	
+	uniformStreamingBuffer_ = std::unique_ptr<StreamingBuffer>( new StreamingBuffer(this, GL_UNIFORM_BUFFER, settings_.streamingBufferRegionSize, Constants::STREAMING_BUFFER_NUMBER_OF_REGIONS) );
+	vertexStreamingBuffer_ = std::unique_ptr<StreamingBuffer>( new StreamingBuffer(this, GL_ARRAY_BUFFER, settings_.streamingBufferRegionSize, Constants::STREAMING_BUFFER_NUMBER_OF_REGIONS) );
+	
 	shaderProgramManager_ = std::unique_ptr< shaders::ShaderProgramManager >(new shaders::ShaderProgramManager(this, true));
 	
 	materialManager_ = std::unique_ptr<IMaterialManager>( new MaterialManager(this) );
 	textureManager_ = std::unique_ptr<ITextureManager>( new TextureManager(this) );
 	meshManager_ = std::unique_ptr<IMeshManager>( new MeshManager(this) );
-	animationManager_ = std::unique_ptr<IAnimationManager>( new AnimationManager(this) );
+	animationManager_ = std::unique_ptr<IAnimationManager>( new AnimationManager(this, settings_.numberOfAnimationThreads, settings_.animationCompression) );
 }
 
 /**
@@ -92,6 +95,19 @@ void OpenGlDevice::initializeSettings(const OpenGlDeviceSettings& settings)
 	{
 		settings_.defaultTextureDir = settings.defaultTextureDir;
 	}
+	
+	if ( !settings.modelCacheDir.empty() )
+	{
+		settings_.modelCacheDir = settings.modelCacheDir;
+	}
+	
+	if ( settings.streamingBufferRegionSize > 0 )
+	{
+		settings_.streamingBufferRegionSize = settings.streamingBufferRegionSize;
+	}
+	
+	settings_.numberOfAnimationThreads = settings.numberOfAnimationThreads;
+	settings_.animationCompression = settings.animationCompression;
 }
 
 void OpenGlDevice::destroy()
@@ -307,6 +323,13 @@ void OpenGlDevice::bindBuffer(GLuint bufferId, GLuint bindPoint)
 	*/
 }
 
+void OpenGlDevice::bindBuffer(const StreamingBufferRange& range, GLuint bindPoint)
+{
+	assert(bindPoint < maxNumBindPoints_);
+	
+	glBindBufferRange(GL_UNIFORM_BUFFER, bindPoint, range.bufferId, range.offset, range.size);
+}
+
 // Do I need this function any more?
 void OpenGlDevice::unbindBuffer(GLuint bufferId)
 {
@@ -399,6 +422,27 @@ GlError OpenGlDevice::getGlError()
 	return glErrorObj;
 }
 
+StreamingBufferRange OpenGlDevice::streamUniformData(const void* data, glmd::uint32 size, glmd::uint32 rangeSize)
+{
+	return uniformStreamingBuffer_->stream(data, size, rangeSize);
+}
+
+StreamingBufferRange OpenGlDevice::streamVertexData(const void* data, glmd::uint32 size)
+{
+	return vertexStreamingBuffer_->stream(data, size);
+}
+
+bool OpenGlDevice::isInstancingSupported() const
+{
+	return (GLEW_VERSION_3_3 || GLEW_ARB_instanced_arrays);
+}
+
+void OpenGlDevice::endFrame()
+{
+	uniformStreamingBuffer_->endFrame();
+	vertexStreamingBuffer_->endFrame();
+}
+
 shaders::IShaderProgramManager* OpenGlDevice::getShaderProgramManager()
 {
 	return shaderProgramManager_.get();
@@ -0,0 +1,578 @@
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+#include "glw/SampledAnimationTracks.hpp"
+
+namespace glr
+{
+namespace glw
+{
+
+/** Anonymous helper functions. */
+namespace
+{
+
+// The components of a 'smallest three' quaternion are never larger than this
+const glmd::float32 MAX_SMALLEST_COMPONENT = 0.70710678f;
+const glmd::float32 ROTATION_STEP = 2.0f * MAX_SMALLEST_COMPONENT / 32767.0f;
+
+/**
+ * Samples the keys of an animated bone node at the given time, the way AnimationTracks does - times before the first key, or after the
+ * last key, hold the first or last key.
+ */
+template<class T, class Interpolate> T sampleKeys(const std::vector< glmd::float64 >& times, const std::vector< T >& values, glmd::float64 time, Interpolate interpolate)
+{
+	assert( !times.empty() && times.size() == values.size() );
+	
+	if (times.size() == 1 || time <= times.front())
+	{
+		return values.front();
+	}
+	
+	if (time >= times.back())
+	{
+		return values.back();
+	}
+	
+	const glmd::uint32 next = std::upper_bound( times.begin(), times.end(), time ) - times.begin();
+	const glmd::uint32 key = next - 1;
+	
+	const glmd::float64 deltaTime = times[next] - times[key];
+	const glmd::float32 factor = (glmd::float32)(deltaTime > 0.0 ? (time - times[key]) / deltaTime : 0.0);
+	
+	return interpolate( values[key], values[next], factor );
+}
+
+glm::vec3 lerp(const glm::vec3& a, const glm::vec3& b, glmd::float32 factor)
+{
+	return a + factor * (b - a);
+}
+
+glm::quat slerp(const glm::quat& a, const glm::quat& b, glmd::float32 factor)
+{
+	return glm::normalize( glm::slerp(a, b, factor) );
+}
+
+/**
+ * Stores a unit quaternion in 48 bits - the index of its largest component (which is dropped, and recalculated when decoding) in the top
+ * bits of the first two values, and the other three components in the remaining 15 bits of each value.
+ */
+void encodeRotation(const glm::quat& rotation, glmd::uint16* values)
+{
+	const glmd::float32 components[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+	
+	glmd::uint32 largest = 0;
+	for (glmd::uint32 i = 1; i < 4; i++)
+	{
+		if (std::abs(components[i]) > std::abs(components[largest]))
+		{
+			largest = i;
+		}
+	}
+	
+	// q and -q are the same rotation - flip it so the dropped component is positive
+	const glmd::float32 sign = (components[largest] < 0.0f ? -1.0f : 1.0f);
+	
+	glmd::uint32 j = 0;
+	for (glmd::uint32 i = 0; i < 4; i++)
+	{
+		if (i != largest)
+		{
+			const glmd::float32 c = std::min( std::max(components[i] * sign, -MAX_SMALLEST_COMPONENT), MAX_SMALLEST_COMPONENT );
+			values[j++] = (glmd::uint16)std::lround( (c + MAX_SMALLEST_COMPONENT) / ROTATION_STEP );
+		}
+	}
+	
+	values[0] |= (glmd::uint16)((largest & 1) << 15);
+	values[1] |= (glmd::uint16)((largest >> 1) << 15);
+}
+
+void decodeRotation(const glmd::uint16* values, glmd::float32* components)
+{
+	// The components stored for each largest component, in order
+	static const glmd::uint32 SMALLEST_COMPONENTS[4][3] = { { 1, 2, 3 }, { 0, 2, 3 }, { 0, 1, 3 }, { 0, 1, 2 } };
+	
+	const glmd::uint32 largest = (values[0] >> 15) | ((values[1] >> 15) << 1);
+	
+	const glmd::float32 a = (values[0] & 0x7FFF) * ROTATION_STEP - MAX_SMALLEST_COMPONENT;
+	const glmd::float32 b = (values[1] & 0x7FFF) * ROTATION_STEP - MAX_SMALLEST_COMPONENT;
+	const glmd::float32 c = values[2] * ROTATION_STEP - MAX_SMALLEST_COMPONENT;
+	
+	components[ SMALLEST_COMPONENTS[largest][0] ] = a;
+	components[ SMALLEST_COMPONENTS[largest][1] ] = b;
+	components[ SMALLEST_COMPONENTS[largest][2] ] = c;
+	components[largest] = std::sqrt( std::max(1.0f - a * a - b * b - c * c, 0.0f) );
+}
+
+/**
+ * Finds the pair of keys of a channel to interpolate between at the given time, and how far between them the time is.
+ */
+template<class Channel> glmd::float32 findKey(const Channel& channel, glmd::float32 animationTime, glmd::uint32& key)
+{
+	if (channel.numberOfKeys == 1)
+	{
+		key = 0;
+		return 0.0f;
+	}
+	
+	const glmd::float32 k = std::max( animationTime * channel.keysPerTick, 0.0f );
+	key = std::min( (glmd::uint32)k, channel.numberOfKeys - 2 );
+	
+	return std::min( k - (glmd::float32)key, 1.0f );
+}
+
+template<class Channel> glm::vec3 sampleVec3(const Channel& channel, const std::vector< glmd::uint16 >& keys, glmd::float32 animationTime)
+{
+	glmd::uint32 key = 0;
+	const glmd::float32 factor = findKey( channel, animationTime, key );
+	
+	const glmd::uint16* a = &keys[ (channel.keyOffset + key) * 3 ];
+	const glmd::uint16* b = (channel.numberOfKeys > 1 ? a + 3 : a);
+	
+	return glm::vec3(
+		channel.minimum.x + channel.step.x * ((glmd::float32)a[0] + factor * ((glmd::float32)b[0] - (glmd::float32)a[0])),
+		channel.minimum.y + channel.step.y * ((glmd::float32)a[1] + factor * ((glmd::float32)b[1] - (glmd::float32)a[1])),
+		channel.minimum.z + channel.step.z * ((glmd::float32)a[2] + factor * ((glmd::float32)b[2] - (glmd::float32)a[2]))
+	);
+}
+
+/**
+ * Interpolates between the keys with a normalized lerp - the keys are close enough together that it's indistinguishable from a slerp.
+ */
+template<class Channel> glm::quat sampleQuat(const Channel& channel, const std::vector< glmd::uint16 >& keys, glmd::float32 animationTime)
+{
+	glmd::uint32 key = 0;
+	const glmd::float32 factor = findKey( channel, animationTime, key );
+	
+	glmd::float32 a[4];
+	decodeRotation( &keys[ (channel.keyOffset + key) * 3 ], a );
+	
+	if (channel.numberOfKeys == 1)
+	{
+		return glm::quat( a[3], a[0], a[1], a[2] );
+	}
+	
+	glmd::float32 b[4];
+	decodeRotation( &keys[ (channel.keyOffset + key + 1) * 3 ], b );
+	
+	// Take the shortest path
+	const glmd::float32 dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+	const glmd::float32 sign = (dot < 0.0f ? -1.0f : 1.0f);
+	
+	glmd::float32 q[4];
+	glmd::float32 lengthSquared = 0.0f;
+	for (glmd::uint32 i = 0; i < 4; i++)
+	{
+		q[i] = a[i] + factor * (sign * b[i] - a[i]);
+		lengthSquared += q[i] * q[i];
+	}
+	
+	const glmd::float32 inverseLength = 1.0f / std::sqrt( lengthSquared );
+	
+	return glm::quat( q[3] * inverseLength, q[0] * inverseLength, q[1] * inverseLength, q[2] * inverseLength );
+}
+
+glmd::float32 getRotationError(const glm::quat& a, const glm::quat& b)
+{
+	const glmd::float32 dot = std::abs( a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w );
+	
+	return 2.0f * std::acos( std::min(dot, 1.0f) );
+}
+
+/**
+ * The times a channel is checked against the imported keys at - every key of the full sample rate.
+ */
+std::vector< glmd::float64 > getSampleTimes(glmd::float64 span, glmd::uint32 numberOfIntervals)
+{
+	auto times = std::vector< glmd::float64 >();
+	
+	for (glmd::uint32 i = 0; i <= numberOfIntervals; i++)
+	{
+		times.push_back( (numberOfIntervals > 0 ? span * i / numberOfIntervals : 0.0) );
+	}
+	
+	return times;
+}
+
+/**
+ * Resamples a channel with numberOfIntervals evenly spaced intervals, using sample to get the value at a time, and encode to store it.
+ */
+template<class Channel, class Sample, class Encode> void resample(Channel& channel, std::vector< glmd::uint16 >& keys, glmd::float64 span, glmd::uint32 numberOfIntervals, Sample sample, Encode encode)
+{
+	channel.keyOffset = keys.size() / 3;
+	channel.numberOfKeys = numberOfIntervals + 1;
+	channel.keysPerTick = (span > 0.0 ? (glmd::float32)(numberOfIntervals / span) : 0.0f);
+	
+	auto values = std::vector< decltype( sample(0.0) ) >();
+	for ( auto t : getSampleTimes(span, numberOfIntervals) )
+	{
+		values.push_back( sample(t) );
+	}
+	
+	encode( channel, keys, values );
+}
+
+/**
+ * Stores translations or scalings in 16 bits per component, relative to the range of the values.
+ */
+template<class Channel> void encodeVec3(Channel& channel, std::vector< glmd::uint16 >& keys, const std::vector< glm::vec3 >& values)
+{
+	glm::vec3 minimum = values.front();
+	glm::vec3 maximum = values.front();
+	
+	for ( auto& v : values )
+	{
+		minimum = glm::min( minimum, v );
+		maximum = glm::max( maximum, v );
+	}
+	
+	channel.minimum = minimum;
+	channel.step = (maximum - minimum) / 65535.0f;
+	
+	for ( auto& v : values )
+	{
+		for (glmd::uint32 i = 0; i < 3; i++)
+		{
+			const glmd::float32 quantized = (channel.step[i] > 0.0f ? (v[i] - minimum[i]) / channel.step[i] : 0.0f);
+			keys.push_back( (glmd::uint16)std::min( std::lround(quantized), 65535l ) );
+		}
+	}
+}
+
+template<class Channel> void encodeQuat(Channel& channel, std::vector< glmd::uint16 >& keys, const std::vector< glm::quat >& values)
+{
+	channel.minimum = glm::vec3( 0.0f );
+	channel.step = glm::vec3( 0.0f );
+	
+	for ( auto& v : values )
+	{
+		keys.resize( keys.size() + 3 );
+		encodeRotation( v, &keys[ keys.size() - 3 ] );
+	}
+}
+
+/**
+ * Compresses a channel - at the full sample rate, or with key reduction, at the lowest rate whose error at every full rate sample is
+ * within the tolerance (down to a single key, for channels that don't change).
+ */
+template<class Channel, class Sample, class Encode, class Decode, class Error> void compressChannel(
+	Channel& channel,
+	std::vector< glmd::uint16 >& keys,
+	glmd::float64 span,
+	glmd::uint32 numberOfIntervals,
+	glmd::float32 tolerance,
+	bool isKeyReductionEnabled,
+	Sample sample,
+	Encode encode,
+	Decode decode,
+	Error error
+)
+{
+	const glmd::uint32 end = keys.size();
+	
+	resample( channel, keys, span, numberOfIntervals, sample, encode );
+	
+	if (!isKeyReductionEnabled || numberOfIntervals == 0)
+	{
+		return;
+	}
+	
+	const auto sampleTimes = getSampleTimes( span, numberOfIntervals );
+	
+	auto reference = std::vector< decltype( sample(0.0) ) >();
+	for ( auto t : sampleTimes )
+	{
+		reference.push_back( sample(t) );
+	}
+	
+	auto isWithinTolerance = [&](const Channel& c, const std::vector< glmd::uint16 >& k) {
+		for (glmd::uint32 i = 0; i < sampleTimes.size(); i++)
+		{
+			if ( error( decode(c, k, (glmd::float32)sampleTimes[i]), reference[i] ) > tolerance )
+			{
+				return false;
+			}
+		}
+		
+		return true;
+	};
+	
+	// Try a single key first, then keep halving the rate while the error stays within the tolerance
+	auto candidate = Channel();
+	auto candidateKeys = std::vector< glmd::uint16 >();
+	
+	glmd::uint32 bestNumberOfIntervals = numberOfIntervals;
+	
+	resample( candidate, candidateKeys, span, 0, sample, encode );
+	if ( isWithinTolerance(candidate, candidateKeys) )
+	{
+		bestNumberOfIntervals = 0;
+	}
+	
+	for (glmd::uint32 n = (numberOfIntervals + 1) / 2; bestNumberOfIntervals > 0 && n < bestNumberOfIntervals; n = (n + 1) / 2)
+	{
+		candidateKeys.clear();
+		resample( candidate, candidateKeys, span, n, sample, encode );
+		
+		if ( !isWithinTolerance(candidate, candidateKeys) )
+		{
+			break;
+		}
+		
+		bestNumberOfIntervals = n;
+		
+		if (n == 1)
+		{
+			break;
+		}
+	}
+	
+	if (bestNumberOfIntervals != numberOfIntervals)
+	{
+		keys.resize( end );
+		resample( channel, keys, span, bestNumberOfIntervals, sample, encode );
+	}
+}
+
+}
+
+SampledAnimationTracks::SampledAnimationTracks()
+{
+}
+
+SampledAnimationTracks::SampledAnimationTracks(const std::map< std::string, AnimatedBoneNode >& animatedBoneNodes, glmd::float64 duration, glmd::float64 ticksPerSecond, const AnimationCompressionSettings& settings)
+{
+	ticksPerSecond = (ticksPerSecond > 0.0 ? ticksPerSecond : 25.0);
+	
+	// Keys are sampled over the whole animation, even if some keys are past its duration
+	glmd::float64 span = std::max( duration, 0.0 );
+	glmd::uint32 mostPositionKeys = 0;
+	
+	for ( auto& kv : animatedBoneNodes )
+	{
+		const AnimatedBoneNode& abn = kv.second;
+		
+		for ( auto times : { &abn.positionTimes, &abn.rotationTimes, &abn.scalingTimes } )
+		{
+			if ( !times->empty() )
+			{
+				span = std::max( span, times->back() );
+			}
+		}
+		
+		if ( abn.positionTimes.size() > mostPositionKeys )
+		{
+			mostPositionKeys = abn.positionTimes.size();
+			
+			frameTimes_.clear();
+			for ( auto t : abn.positionTimes )
+			{
+				frameTimes_.push_back( (glmd::float32)t );
+			}
+		}
+	}
+	
+	const glmd::uint32 numberOfIntervals = (span > 0.0 ? std::max( (glmd::uint32)std::ceil(span * settings.sampleRate / ticksPerSecond), 1u ) : 0);
+	
+	auto vec3Error = [](const glm::vec3& a, const glm::vec3& b) { return glm::length( a - b ); };
+	
+	for ( auto& kv : animatedBoneNodes )
+	{
+		const AnimatedBoneNode& abn = kv.second;
+		
+		assert( abn.positionTimes.size() == abn.positions.size() );
+		assert( abn.rotationTimes.size() == abn.rotations.size() );
+		assert( abn.scalingTimes.size() == abn.scalings.size() );
+		
+		// Tracks are looked up by the key in the map - that's what the bone node tree was matched against
+		names_.push_back( kv.first );
+		
+		auto translation = Channel();
+		auto rotation = Channel();
+		auto scaling = Channel();
+		
+		translation.keyOffset = translationKeys_.size() / 3;
+		rotation.keyOffset = rotationKeys_.size() / 3;
+		scaling.keyOffset = scalingKeys_.size() / 3;
+		
+		// Tracks without any keys can't be sampled - they leave the node at its bind transformation
+		if ( !abn.positionTimes.empty() && !abn.rotationTimes.empty() && !abn.scalingTimes.empty() )
+		{
+			compressChannel(
+				translation, translationKeys_, span, numberOfIntervals, settings.translationTolerance, settings.isKeyReductionEnabled,
+				[&abn](glmd::float64 t) { return sampleKeys( abn.positionTimes, abn.positions, t, lerp ); },
+				encodeVec3<Channel>, sampleVec3<Channel>, vec3Error
+			);
+			
+			compressChannel(
+				rotation, rotationKeys_, span, numberOfIntervals, settings.rotationTolerance, settings.isKeyReductionEnabled,
+				[&abn](glmd::float64 t) { return sampleKeys( abn.rotationTimes, abn.rotations, t, slerp ); },
+				encodeQuat<Channel>, sampleQuat<Channel>, getRotationError
+			);
+			
+			compressChannel(
+				scaling, scalingKeys_, span, numberOfIntervals, settings.scalingTolerance, settings.isKeyReductionEnabled,
+				[&abn](glmd::float64 t) { return sampleKeys( abn.scalingTimes, abn.scalings, t, lerp ); },
+				encodeVec3<Channel>, sampleVec3<Channel>, vec3Error
+			);
+		}
+		
+		translations_.push_back( translation );
+		rotations_.push_back( rotation );
+		scalings_.push_back( scaling );
+	}
+}
+
+glmd::uint32 SampledAnimationTracks::getNumberOfTracks() const
+{
+	return names_.size();
+}
+
+const std::vector< std::string >& SampledAnimationTracks::getNames() const
+{
+	return names_;
+}
+
+glmd::uint32 SampledAnimationTracks::getNumberOfKeys() const
+{
+	return (translationKeys_.size() + rotationKeys_.size() + scalingKeys_.size()) / 3;
+}
+
+glmd::uint32 SampledAnimationTracks::getMemoryUsage() const
+{
+	return (translations_.size() + rotations_.size() + scalings_.size()) * sizeof(Channel)
+		+ (translationKeys_.size() + rotationKeys_.size() + scalingKeys_.size()) * sizeof(glmd::uint16)
+		+ frameTimes_.size() * sizeof(glmd::float32);
+}
+
+std::vector< glmd::int32 > SampledAnimationTracks::bindNodes(const Skeleton& skeleton) const
+{
+	auto nodeTracks = std::vector< glmd::int32 >( skeleton.getNumberOfNodes(), -1 );
+	
+	const auto& names = skeleton.getNames();
+	
+	for ( glmd::uint32 i = 0; i < names.size(); i++ )
+	{
+		auto it = std::lower_bound( names_.begin(), names_.end(), names[i] );
+		
+		if ( it != names_.end() && *it == names[i] )
+		{
+			const glmd::uint32 track = it - names_.begin();
+			
+			// Tracks without any keys can't be sampled - they leave the node at its bind transformation
+			if ( translations_[track].numberOfKeys > 0 )
+			{
+				nodeTracks[i] = (glmd::int32)track;
+			}
+		}
+	}
+	
+	return nodeTracks;
+}
+
+glmd::float32 SampledAnimationTracks::clampToFrames(glmd::float32 animationTime, glmd::uint32 startFrame, glmd::uint32 endFrame) const
+{
+	if ( (startFrame > 0 || endFrame > 0) && !frameTimes_.empty() )
+	{
+		const glmd::uint32 last = frameTimes_.size() - 1;
+		
+		const glmd::float32 st = frameTimes_[ std::min(startFrame, last) ];
+		const glmd::float32 et = frameTimes_[ std::min(endFrame, last) ];
+		
+		animationTime = (et > 0.0f ? std::fmod(animationTime, et) : 0.0f) + st;
+	}
+	
+	return animationTime;
+}
+
+void SampledAnimationTracks::sampleTrack(glmd::uint32 track, glmd::float32 animationTime, glm::vec3& translation, glm::quat& rotation, glm::vec3& scaling) const
+{
+	translation = sampleVec3( translations_[track], translationKeys_, animationTime );
+	rotation = sampleQuat( rotations_[track], rotationKeys_, animationTime );
+	scaling = sampleVec3( scalings_[track], scalingKeys_, animationTime );
+}
+
+void SampledAnimationTracks::sampleTrack(glm::mat4& transformation, glmd::uint32 track, glmd::float32 animationTime) const
+{
+	glm::vec3 translation;
+	glm::quat rotation;
+	glm::vec3 scaling;
+	sampleTrack( track, animationTime, translation, rotation, scaling );
+	
+	// translation * rotation * scaling, without building (and multiplying) the three matrices
+	transformation = glm::mat4_cast( rotation );
+	transformation[0] = transformation[0] * scaling.x;
+	transformation[1] = transformation[1] * scaling.y;
+	transformation[2] = transformation[2] * scaling.z;
+	transformation[3] = glm::vec4( translation.x, translation.y, translation.z, 1.0f );
+}
+
+void SampledAnimationTracks::calculateLocalTransformation(glm::mat4& transformation, glmd::uint32 track, glmd::float32 animationTime, glmd::uint32 startFrame, glmd::uint32 endFrame) const
+{
+	assert( track < names_.size() );
+	
+	sampleTrack( transformation, track, clampToFrames(animationTime, startFrame, endFrame) );
+}
+
+void SampledAnimationTracks::calculateLocalPose(SkeletonPose& pose, const std::vector< glmd::int32 >& nodeTracks, glmd::float32 animationTime, glmd::uint32 startFrame, glmd::uint32 endFrame) const
+{
+	assert( pose.getNumberOfNodes() == nodeTracks.size() );
+	
+	// Every track is clamped to the same frames, so the time only has to be clamped once
+	animationTime = clampToFrames( animationTime, startFrame, endFrame );
+	
+	glm::vec3 translation;
+	glm::quat rotation;
+	glm::vec3 scaling;
+	
+	for ( glmd::uint32 i = 0; i < nodeTracks.size(); i++ )
+	{
+		if ( nodeTracks[i] >= 0 )
+		{
+			sampleTrack( nodeTracks[i], animationTime, translation, rotation, scaling );
+			pose.setTransformation( i, translation, rotation, scaling );
+		}
+	}
+}
+
+void SampledAnimationTracks::calculateGlobalTransformations(
+	std::vector< glm::mat4 >& globalTransformations,
+	const Skeleton& skeleton,
+	const std::vector< glmd::int32 >& nodeTracks,
+	glmd::float32 animationTime,
+	glmd::uint32 startFrame,
+	glmd::uint32 endFrame,
+	const glm::mat4& rootParentTransformation
+) const
+{
+	const glmd::uint32 numberOfNodes = skeleton.getNumberOfNodes();
+	const auto& parents = skeleton.getParents();
+	const auto& transformations = skeleton.getTransformations();
+	
+	assert( globalTransformations.size() >= numberOfNodes );
+	assert( nodeTracks.size() == numberOfNodes );
+	
+	// Every track is clamped to the same frames, so the time only has to be clamped once
+	animationTime = clampToFrames( animationTime, startFrame, endFrame );
+	
+	glm::mat4 local = glm::mat4();
+	
+	// Parents come before their children, so their global transformation is always ready
+	for ( glmd::uint32 i = 0; i < numberOfNodes; i++ )
+	{
+		const glm::mat4* nodeTransformation = &transformations[i];
+		
+		if ( nodeTracks[i] >= 0 )
+		{
+			sampleTrack( local, nodeTracks[i], animationTime );
+			nodeTransformation = &local;
+		}
+		
+		const glm::mat4& parentTransformation = (parents[i] >= 0 ? globalTransformations[ parents[i] ] : rootParentTransformation);
+		globalTransformations[i] = parentTransformation * (*nodeTransformation);
+	}
+}
+
+}
+}
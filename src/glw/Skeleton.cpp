@@ -0,0 +1,303 @@
+#include <cassert>
+#include <atomic>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+
+#include "glw/Skeleton.hpp"
+
+namespace glr
+{
+namespace glw
+{
+
+glmd::uint32 SkeletonPose::getNumberOfNodes() const
+{
+	return tx.size();
+}
+
+void SkeletonPose::resize(glmd::uint32 numberOfNodes)
+{
+	for ( auto component : { &tx, &ty, &tz, &rx, &ry, &rz, &rw, &sx, &sy, &sz } )
+	{
+		component->resize( numberOfNodes );
+	}
+}
+
+void SkeletonPose::setTransformation(glmd::uint32 node, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scaling)
+{
+	tx[node] = translation.x;
+	ty[node] = translation.y;
+	tz[node] = translation.z;
+	
+	rx[node] = rotation.x;
+	ry[node] = rotation.y;
+	rz[node] = rotation.z;
+	rw[node] = rotation.w;
+	
+	sx[node] = scaling.x;
+	sy[node] = scaling.y;
+	sz[node] = scaling.z;
+}
+
+glm::mat4 SkeletonPose::getTransformation(glmd::uint32 node) const
+{
+	// translation * rotation * scaling, without building (and multiplying) the three matrices
+	glm::mat4 transformation = glm::mat4_cast( glm::quat(rw[node], rx[node], ry[node], rz[node]) );
+	transformation[0] = transformation[0] * sx[node];
+	transformation[1] = transformation[1] * sy[node];
+	transformation[2] = transformation[2] * sz[node];
+	transformation[3] = glm::vec4( tx[node], ty[node], tz[node], 1.0f );
+	
+	return transformation;
+}
+
+Skeleton::Skeleton() : id_(0)
+{
+}
+
+Skeleton::Skeleton(const BoneNode& rootBoneNode) : id_(generateId())
+{
+	// Depth first (pre-order) walk of the tree, so that every node comes after its parent - using our own stack, as bone trees can be deep
+	auto stack = std::vector< std::pair<const BoneNode*, glmd::int32> >();
+	stack.push_back( std::make_pair(&rootBoneNode, -1) );
+	
+	while ( !stack.empty() )
+	{
+		const BoneNode* node = stack.back().first;
+		const glmd::int32 parent = stack.back().second;
+		stack.pop_back();
+		
+		const glmd::int32 index = (glmd::int32)parents_.size();
+		
+		parents_.push_back( parent );
+		transformations_.push_back( node->transformation );
+		names_.push_back( node->name );
+		
+		// Push the children in reverse, so that they come off the stack in order
+		for ( auto it = node->children.rbegin(); it != node->children.rend(); ++it )
+		{
+			stack.push_back( std::make_pair(&(*it), index) );
+		}
+	}
+	
+	bindPose_.resize( transformations_.size() );
+	
+	for ( glmd::uint32 i = 0; i < transformations_.size(); i++ )
+	{
+		const glm::mat4& transformation = transformations_[i];
+		
+		const glm::vec3 scaling = glm::vec3( glm::length(glm::vec3(transformation[0])), glm::length(glm::vec3(transformation[1])), glm::length(glm::vec3(transformation[2])) );
+		
+		glm::mat3 rotation = glm::mat3( transformation );
+		for ( glmd::uint32 j = 0; j < 3; j++ )
+		{
+			rotation[j] = (scaling[j] > 0.0f ? rotation[j] / scaling[j] : rotation[j]);
+		}
+		
+		bindPose_.setTransformation( i, glm::vec3(transformation[3]), glm::normalize(glm::quat_cast(rotation)), scaling );
+	}
+}
+
+glmd::uint32 Skeleton::getId() const
+{
+	return id_;
+}
+
+glmd::uint32 Skeleton::getNumberOfNodes() const
+{
+	return parents_.size();
+}
+
+const std::vector< glmd::int32 >& Skeleton::getParents() const
+{
+	return parents_;
+}
+
+const std::vector< glm::mat4 >& Skeleton::getTransformations() const
+{
+	return transformations_;
+}
+
+const std::vector< std::string >& Skeleton::getNames() const
+{
+	return names_;
+}
+
+const SkeletonPose& Skeleton::getBindPose() const
+{
+	return bindPose_;
+}
+
+glmd::int32 Skeleton::findNode(const std::string& name) const
+{
+	for ( glmd::uint32 i = 0; i < names_.size(); i++ )
+	{
+		if ( names_[i] == name )
+		{
+			return (glmd::int32)i;
+		}
+	}
+	
+	return -1;
+}
+
+SkeletonBones Skeleton::bindBones(const BoneData& boneData) const
+{
+	SkeletonBones bones = SkeletonBones();
+	bones.numberOfBones = boneData.boneTransform.size();
+	
+	// Every node named after a bone is bound (not just the first), so that duplicate names behave as they did when walking the tree
+	for ( glmd::uint32 i = 0; i < names_.size(); i++ )
+	{
+		auto it = boneData.boneIndexMap.find( names_[i] );
+		
+		if ( it != boneData.boneIndexMap.end() && it->second < boneData.boneTransform.size() )
+		{
+			bones.nodeIndices.push_back( i );
+			bones.boneIndices.push_back( it->second );
+			bones.boneOffsets.push_back( boneData.boneTransform[it->second].boneOffset );
+		}
+	}
+	
+	return bones;
+}
+
+void Skeleton::calculateGlobalTransformations(std::vector< glm::mat4 >& globalTransformations, const SkeletonPose& pose, const glm::mat4& rootParentTransformation) const
+{
+	assert( globalTransformations.size() >= parents_.size() );
+	assert( pose.getNumberOfNodes() == parents_.size() );
+	
+	// Parents come before their children, so their global transformation is always ready
+	for ( glmd::uint32 i = 0; i < parents_.size(); i++ )
+	{
+		const glm::mat4& parentTransformation = (parents_[i] >= 0 ? globalTransformations[ parents_[i] ] : rootParentTransformation);
+		globalTransformations[i] = parentTransformation * pose.getTransformation( i );
+	}
+}
+
+void Skeleton::calculateBoneTransformations(std::vector< glm::mat4 >& transformations, const std::vector< glm::mat4 >& globalTransformations, const SkeletonBones& bones)
+{
+	assert( transformations.size() >= bones.numberOfBones );
+	
+	for ( glmd::uint32 i = 0; i < bones.nodeIndices.size(); i++ )
+	{
+		transformations[ bones.boneIndices[i] ] = globalTransformations[ bones.nodeIndices[i] ] * bones.boneOffsets[i];
+	}
+}
+
+SkeletonPalette Skeleton::createPalette(const std::vector< SkeletonBones >& meshBones)
+{
+	SkeletonPalette palette = SkeletonPalette();
+	palette.bones.numberOfBones = 0;
+	palette.numberOfSharedBones = 0;
+	palette.remaps.resize( meshBones.size() );
+	
+	if ( meshBones.empty() )
+	{
+		return palette;
+	}
+	
+	// Lay the palette out like the mesh with the most bones
+	auto largest = std::max_element( meshBones.begin(), meshBones.end(), [](const SkeletonBones& a, const SkeletonBones& b) {
+		return a.numberOfBones < b.numberOfBones;
+	});
+	
+	palette.bones = *largest;
+	palette.numberOfSharedBones = largest->numberOfBones;
+	
+	// Shared slots that aren't calculated from a node keep the identity transformation
+	auto isSharedSlotUnbound = std::vector< bool >( palette.numberOfSharedBones, true );
+	for ( auto slot : palette.bones.boneIndices )
+	{
+		isSharedSlotUnbound[slot] = false;
+	}
+	
+	// A slot for the unbound bones of meshes that can't use an unbound shared slot
+	glmd::int32 identitySlot = -1;
+	
+	for ( glmd::uint32 m = 0; m < meshBones.size(); m++ )
+	{
+		const SkeletonBones& bones = meshBones[m];
+		
+		auto remap = std::vector< glmd::uint32 >( bones.numberOfBones );
+		auto isBound = std::vector< bool >( bones.numberOfBones, false );
+		
+		for ( glmd::uint32 i = 0; i < bones.nodeIndices.size(); i++ )
+		{
+			glmd::int32 slot = -1;
+			
+			for ( glmd::uint32 j = 0; j < palette.bones.nodeIndices.size() && slot < 0; j++ )
+			{
+				if ( palette.bones.nodeIndices[j] == bones.nodeIndices[i] && palette.bones.boneOffsets[j] == bones.boneOffsets[i] )
+				{
+					slot = palette.bones.boneIndices[j];
+				}
+			}
+			
+			if ( slot < 0 )
+			{
+				slot = palette.bones.numberOfBones++;
+				
+				palette.bones.nodeIndices.push_back( bones.nodeIndices[i] );
+				palette.bones.boneIndices.push_back( slot );
+				palette.bones.boneOffsets.push_back( bones.boneOffsets[i] );
+			}
+			
+			remap[ bones.boneIndices[i] ] = slot;
+			isBound[ bones.boneIndices[i] ] = true;
+		}
+		
+		bool isShared = true;
+		
+		for ( glmd::uint32 i = 0; i < bones.numberOfBones; i++ )
+		{
+			if ( !isBound[i] )
+			{
+				if ( i < palette.numberOfSharedBones && isSharedSlotUnbound[i] )
+				{
+					remap[i] = i;
+				}
+				else
+				{
+					if ( identitySlot < 0 )
+					{
+						identitySlot = palette.bones.numberOfBones++;
+					}
+					
+					remap[i] = identitySlot;
+				}
+			}
+			
+			isShared = isShared && (remap[i] == i);
+		}
+		
+		if ( !isShared )
+		{
+			palette.remaps[m] = std::move(remap);
+		}
+	}
+	
+	return palette;
+}
+
+void Skeleton::remapBoneTransformations(std::vector< glm::mat4 >& transformations, const std::vector< glm::mat4 >& paletteTransformations, const std::vector< glmd::uint32 >& remap)
+{
+	assert( transformations.size() >= remap.size() );
+	
+	for ( glmd::uint32 i = 0; i < remap.size(); i++ )
+	{
+		transformations[i] = paletteTransformations[ remap[i] ];
+	}
+}
+
+glmd::uint32 Skeleton::generateId()
+{
+	// Id 0 is the empty skeleton
+	static std::atomic<glmd::uint32> nextId( 1 );
+	
+	return nextId++;
+}
+
+}
+}
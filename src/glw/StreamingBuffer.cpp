@@ -0,0 +1,275 @@
+#include <sstream>
+#include <cstring>
+
+#include "glw/StreamingBuffer.hpp"
+#include "glw/IOpenGlDevice.hpp"
+
+#include "common/logger/Logger.hpp"
+
+#include "exceptions/GlException.hpp"
+#include "exceptions/InvalidArgumentException.hpp"
+
+namespace glr
+{
+namespace glw
+{
+
+/** Anonymous helper functions. */
+namespace
+{
+
+glmd::uint32 alignUp(glmd::uint32 value, glmd::uint32 alignment)
+{
+	return ((value + alignment - 1) / alignment) * alignment;
+}
+
+// How long to wait on a fence before checking it again, in nanoseconds
+const GLuint64 FENCE_TIMEOUT = 1000000000;
+
+}
+
+StreamingBuffer::StreamingBuffer(IOpenGlDevice* openGlDevice, GLenum target, glmd::uint32 regionSize, glmd::uint32 numberOfRegions)
+	: openGlDevice_(openGlDevice), target_(target), bufferId_(0), regionSize_(regionSize), numberOfRegions_(numberOfRegions), alignment_(16), currentRegion_(0), currentOffset_(0), data_(nullptr)
+{
+	if (regionSize_ == 0 || numberOfRegions_ == 0)
+	{
+		std::string msg = std::string("Streaming buffer must have at least one region, and the regions must not be empty.");
+		LOG_ERROR( msg );
+		throw exception::InvalidArgumentException( msg );
+	}
+	
+	if (target_ == GL_UNIFORM_BUFFER)
+	{
+		GLint alignment = 0;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		
+		if (alignment > 0)
+		{
+			alignment_ = (glmd::uint32) alignment;
+		}
+	}
+	
+	// Every region has to start on an aligned offset
+	regionSize_ = alignUp(regionSize_, alignment_);
+	fences_ = std::vector< GLsync >( numberOfRegions_, nullptr );
+	
+	const GLsizeiptr totalSize = (GLsizeiptr) regionSize_ * numberOfRegions_;
+	
+	glGenBuffers(1, &bufferId_);
+	glBindBuffer(target_, bufferId_);
+	
+	if (GLEW_ARB_buffer_storage)
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		
+		glBufferStorage(target_, totalSize, nullptr, flags);
+		data_ = static_cast< glmd::uint8* >( glMapBufferRange(target_, 0, totalSize, flags) );
+	}
+	else
+	{
+		glBufferData(target_, totalSize, nullptr, GL_STREAM_DRAW);
+	}
+	
+	glBindBuffer(target_, 0);
+	
+	GlError err = openGlDevice_->getGlError();
+	if (err.type != GL_NONE || (GLEW_ARB_buffer_storage && data_ == nullptr))
+	{
+		glDeleteBuffers(1, &bufferId_);
+		
+		std::string msg = std::string("Error while creating streaming buffer in OpenGl: ") + err.name;
+		LOG_ERROR( msg );
+		throw exception::GlException( msg );
+	}
+	
+	LOG_DEBUG( "Created streaming buffer with " << numberOfRegions_ << " regions of " << regionSize_ << " bytes (persistently mapped: " << isPersistentlyMapped() << ").  Buffer id: " << bufferId_ );
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+	deleteFences();
+	
+	if (data_ != nullptr)
+	{
+		glBindBuffer(target_, bufferId_);
+		glUnmapBuffer(target_);
+		glBindBuffer(target_, 0);
+	}
+	
+	glDeleteBuffers(1, &bufferId_);
+}
+
+StreamingBufferRange StreamingBuffer::stream(const void* data, glmd::uint32 size, glmd::uint32 rangeSize)
+{
+	if (rangeSize < size)
+	{
+		rangeSize = size;
+	}
+	
+	if (rangeSize > regionSize_)
+	{
+		std::stringstream ss;
+		ss << "Cannot stream " << rangeSize << " bytes - the regions of the streaming buffer are only " << regionSize_ << " bytes.";
+		LOG_ERROR( ss.str() );
+		throw exception::InvalidArgumentException( ss.str() );
+	}
+	
+	glmd::uint32 offset = alignUp(currentOffset_, alignment_);
+	
+	if (offset + rangeSize > (currentRegion_ + 1) * regionSize_)
+	{
+		nextRegion();
+		offset = currentOffset_;
+	}
+	
+	if (size > 0)
+	{
+		if (data_ != nullptr)
+		{
+			std::memcpy( data_ + offset, data, size );
+		}
+		else
+		{
+			// The fences guarantee the GPU is done with this range, so there's no need for OpenGL to synchronize
+			glBindBuffer(target_, bufferId_);
+			void* d = glMapBufferRange(target_, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+			
+			if (d == nullptr)
+			{
+				GlError err = openGlDevice_->getGlError();
+				
+				std::string msg = std::string("Call to 'glMapBufferRange' failed with error: ") + err.name;
+				LOG_ERROR( msg );
+				throw exception::GlException( msg );
+			}
+			
+			std::memcpy( d, data, size );
+			
+			if (glUnmapBuffer(target_) == GL_FALSE)
+			{
+				GlError err = openGlDevice_->getGlError();
+				
+				std::string msg = std::string("Call to 'glUnmapBuffer' failed with error: ") + err.name;
+				LOG_ERROR( msg );
+				throw exception::GlException( msg );
+			}
+		}
+	}
+	
+	currentOffset_ = offset + rangeSize;
+	
+	StreamingBufferRange range = StreamingBufferRange();
+	range.bufferId = bufferId_;
+	range.offset = offset;
+	range.size = rangeSize;
+	
+	return range;
+}
+
+void StreamingBuffer::endFrame()
+{
+	// Nothing has been streamed into the current region - we can keep using it
+	if (currentOffset_ == currentRegion_ * regionSize_)
+	{
+		return;
+	}
+	
+	nextRegion();
+}
+
+/**
+ * Fences the current region, and moves on to the next one - waiting for the GPU to finish with it if it is still in use (or orphaning the
+ * buffer if it isn't persistently mapped).
+ */
+void StreamingBuffer::nextRegion()
+{
+	fences_[currentRegion_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	
+	currentRegion_ = (currentRegion_ + 1) % numberOfRegions_;
+	currentOffset_ = currentRegion_ * regionSize_;
+	
+	GLsync fence = fences_[currentRegion_];
+	
+	if (fence == nullptr)
+	{
+		return;
+	}
+	
+	if (data_ == nullptr && glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+	{
+		orphan();
+		return;
+	}
+	
+	waitForFence(fence);
+	
+	glDeleteSync(fence);
+	fences_[currentRegion_] = nullptr;
+}
+
+void StreamingBuffer::waitForFence(GLsync fence)
+{
+	GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+	
+	while (result == GL_TIMEOUT_EXPIRED)
+	{
+		LOG_WARN( "Still waiting for the GPU to finish with a region of streaming buffer " << bufferId_ << "." );
+		result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+	}
+	
+	if (result == GL_WAIT_FAILED)
+	{
+		GlError err = openGlDevice_->getGlError();
+		
+		std::string msg = std::string("Call to 'glClientWaitSync' failed with error: ") + err.name;
+		LOG_ERROR( msg );
+		throw exception::GlException( msg );
+	}
+}
+
+/**
+ * Gives the buffer new storage - the old storage is released by OpenGL once the GPU is done with it, so every region is free again.
+ */
+void StreamingBuffer::orphan()
+{
+	deleteFences();
+	
+	glBindBuffer(target_, bufferId_);
+	glBufferData(target_, (GLsizeiptr) regionSize_ * numberOfRegions_, nullptr, GL_STREAM_DRAW);
+	glBindBuffer(target_, 0);
+}
+
+void StreamingBuffer::deleteFences()
+{
+	for ( auto& fence : fences_ )
+	{
+		if (fence != nullptr)
+		{
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+	}
+}
+
+GLuint StreamingBuffer::getBufferId() const
+{
+	return bufferId_;
+}
+
+glmd::uint32 StreamingBuffer::getRegionSize() const
+{
+	return regionSize_;
+}
+
+glmd::uint32 StreamingBuffer::getNumberOfRegions() const
+{
+	return numberOfRegions_;
+}
+
+bool StreamingBuffer::isPersistentlyMapped() const
+{
+	return data_ != nullptr;
+}
+
+}
+}
@@ -0,0 +1,412 @@
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <string>
+
+#include <GL/glew.h>
+
+#include "glw/VertexFormat.hpp"
+
+#include "common/logger/Logger.hpp"
+
+#include "exceptions/InvalidArgumentException.hpp"
+
+/**
+ * Anonymous helper functions.
+ */
+namespace
+{
+
+namespace glmd = glm::detail;
+
+/**
+ * Returns the number of bytes an attribute takes up in a vertex (rounded up to a multiple of 4, so that every attribute is aligned).
+ */
+glmd::uint32 getSize(glr::glw::VertexAttributeType type, glmd::uint32 numberOfComponents)
+{
+	glmd::uint32 size = 0;
+
+	switch (type)
+	{
+		case glr::glw::VERTEX_ATTRIBUTE_TYPE_FLOAT32:
+		case glr::glw::VERTEX_ATTRIBUTE_TYPE_INT32:
+			size = numberOfComponents * 4;
+			break;
+
+		case glr::glw::VERTEX_ATTRIBUTE_TYPE_HALF_FLOAT:
+			size = numberOfComponents * 2;
+			break;
+
+		case glr::glw::VERTEX_ATTRIBUTE_TYPE_INT_2_10_10_10:
+			size = 4;
+			break;
+
+		case glr::glw::VERTEX_ATTRIBUTE_TYPE_UNORM8:
+		case glr::glw::VERTEX_ATTRIBUTE_TYPE_UINT8:
+			size = numberOfComponents;
+			break;
+	}
+
+	return (size + 3) & ~3u;
+}
+
+/**
+ * Calls pack(components, destination) for vertices first to end, with the first numberOfComponents components of the vertex's value
+ * (fetched with component(value, i)) and the address of the attribute in the vertex.
+ */
+template<typename Component, typename T, typename Accessor, typename Packer>
+void packValues(const glr::glw::VertexAttribute& attribute, glmd::uint32 stride, glmd::uint32 numberOfComponents, const std::vector< T >& values, Accessor component, Packer pack, std::vector< glmd::uint8 >& vertices, glmd::uint32 first, glmd::uint32 end)
+{
+	Component components[4] = { 0, 0, 0, 0 };
+	glmd::uint8* destination = &vertices[0] + first * stride + attribute.offset;
+
+	for (glmd::uint32 v=first; v < end; v++)
+	{
+		for (glmd::uint32 i=0; i < numberOfComponents; i++)
+			components[i] = component(values[v], i);
+
+		pack(components, destination);
+		destination += stride;
+	}
+}
+
+/**
+ * Writes numberOfComponents components of each value (fetched with component(value, i)) to the attribute, converted to the attribute's
+ * type, for each vertex in vertices.
+ *
+ * The type is switched on once per attribute (rather than once per vertex), so that the conversion inlines into the loop over the
+ * vertices.
+ */
+template<typename Component, typename T, typename Accessor>
+void writeValues(const glr::glw::VertexAttribute* attribute, glmd::uint32 stride, glmd::uint32 numberOfComponents, const std::vector< T >& values, Accessor component, std::vector< glmd::uint8 >& vertices, glmd::uint32 firstVertex, glmd::uint32 numberOfVertices)
+{
+	if (attribute == nullptr)
+		return;
+
+	// Only vertices that have a value, and fit in vertices, are written
+	const glmd::uint64 requestedEnd = (glmd::uint64)firstVertex + numberOfVertices;
+	const glmd::uint32 first = firstVertex;
+	const glmd::uint32 end = (glmd::uint32)std::min( requestedEnd, (glmd::uint64)std::min( values.size(), vertices.size() / stride ) );
+
+	if (first >= end)
+		return;
+
+	const glmd::uint32 n = std::min( numberOfComponents, attribute->numberOfComponents );
+	const glmd::uint32 location = attribute->location;
+
+	switch (attribute->type)
+	{
+		case glr::glw::VERTEX_ATTRIBUTE_TYPE_FLOAT32:
+			packValues<Component>(*attribute, stride, n, values, component, [n](const Component* components, glmd::uint8* destination) {
+				for (glmd::uint32 i=0; i < n; i++)
+				{
+					const glmd::float32 value = (glmd::float32)components[i];
+					std::memcpy(destination + i * sizeof(glmd::float32), &value, sizeof(glmd::float32));
+				}
+			}, vertices, first, end);
+			break;
+
+		case glr::glw::VERTEX_ATTRIBUTE_TYPE_HALF_FLOAT:
+			packValues<Component>(*attribute, stride, n, values, component, [n](const Component* components, glmd::uint8* destination) {
+				for (glmd::uint32 i=0; i < n; i++)
+				{
+					const glmd::uint16 value = glr::glw::packHalfFloat( (glmd::float32)components[i] );
+					std::memcpy(destination + i * sizeof(glmd::uint16), &value, sizeof(glmd::uint16));
+				}
+			}, vertices, first, end);
+			break;
+
+		case glr::glw::VERTEX_ATTRIBUTE_TYPE_INT_2_10_10_10:
+			packValues<Component>(*attribute, stride, n, values, component, [](const Component* components, glmd::uint8* destination) {
+				const glmd::uint32 value = glr::glw::packInt2_10_10_10(
+					glm::vec4( (glmd::float32)components[0], (glmd::float32)components[1], (glmd::float32)components[2], (glmd::float32)components[3] )
+				);
+				std::memcpy(destination, &value, sizeof(glmd::uint32));
+			}, vertices, first, end);
+			break;
+
+		case glr::glw::VERTEX_ATTRIBUTE_TYPE_UNORM8:
+			packValues<Component>(*attribute, stride, n, values, component, [n](const Component* components, glmd::uint8* destination) {
+				for (glmd::uint32 i=0; i < n; i++)
+					destination[i] = glr::glw::packUnorm8( (glmd::float32)components[i] );
+			}, vertices, first, end);
+			break;
+
+		case glr::glw::VERTEX_ATTRIBUTE_TYPE_INT32:
+			packValues<Component>(*attribute, stride, n, values, component, [n](const Component* components, glmd::uint8* destination) {
+				for (glmd::uint32 i=0; i < n; i++)
+				{
+					const glmd::int32 value = (glmd::int32)components[i];
+					std::memcpy(destination + i * sizeof(glmd::int32), &value, sizeof(glmd::int32));
+				}
+			}, vertices, first, end);
+			break;
+
+		case glr::glw::VERTEX_ATTRIBUTE_TYPE_UINT8:
+			packValues<Component>(*attribute, stride, n, values, component, [n, location](const Component* components, glmd::uint8* destination) {
+				for (glmd::uint32 i=0; i < n; i++)
+				{
+					const glmd::int32 value = (glmd::int32)components[i];
+
+					if (value < 0 || value > 255)
+					{
+						std::string message = std::string("Value ") + std::to_string(value) + " does not fit in the uint8 vertex attribute at location " + std::to_string(location) + ".";
+						LOG_ERROR(message);
+						throw glr::exception::InvalidArgumentException(message);
+					}
+
+					destination[i] = (glmd::uint8)value;
+				}
+			}, vertices, first, end);
+			break;
+	}
+}
+
+}
+
+namespace glr
+{
+namespace glw
+{
+
+VertexFormat::VertexFormat() : stride_(0)
+{
+}
+
+void VertexFormat::addAttribute(glmd::uint32 location, glmd::uint32 numberOfComponents, VertexAttributeType type)
+{
+	if (numberOfComponents < 1 || numberOfComponents > 4 || (type == VERTEX_ATTRIBUTE_TYPE_INT_2_10_10_10 && numberOfComponents < 3))
+	{
+		std::string message = std::string("Invalid number of components (") + std::to_string(numberOfComponents) + ") for the vertex attribute at location " + std::to_string(location) + ".";
+		LOG_ERROR(message);
+		throw exception::InvalidArgumentException(message);
+	}
+
+	if (getAttribute(location) != nullptr)
+	{
+		std::string message = std::string("Vertex format already has an attribute at location ") + std::to_string(location) + ".";
+		LOG_ERROR(message);
+		throw exception::InvalidArgumentException(message);
+	}
+
+	VertexAttribute attribute = VertexAttribute();
+	attribute.location = location;
+	attribute.numberOfComponents = numberOfComponents;
+	attribute.type = type;
+	attribute.offset = stride_;
+
+	attributes_.push_back(attribute);
+
+	stride_ += getSize(type, numberOfComponents);
+}
+
+const VertexAttribute* VertexFormat::getAttribute(glmd::uint32 location) const
+{
+	for (const auto& attribute : attributes_)
+	{
+		if (attribute.location == location)
+			return &attribute;
+	}
+
+	return nullptr;
+}
+
+const std::vector< VertexAttribute >& VertexFormat::getAttributes() const
+{
+	return attributes_;
+}
+
+glmd::uint32 VertexFormat::getStride() const
+{
+	return stride_;
+}
+
+bool VertexFormat::isSkinned() const
+{
+	return (getAttribute(VERTEX_ATTRIBUTE_LOCATION_BONE_IDS) != nullptr && getAttribute(VERTEX_ATTRIBUTE_LOCATION_BONE_WEIGHTS) != nullptr);
+}
+
+void VertexFormat::setVertexAttributePointers() const
+{
+	for (const auto& attribute : attributes_)
+	{
+		const GLvoid* offset = (const GLvoid*)(size_t)attribute.offset;
+
+		glEnableVertexAttribArray(attribute.location);
+
+		switch (attribute.type)
+		{
+			case VERTEX_ATTRIBUTE_TYPE_FLOAT32:
+				glVertexAttribPointer(attribute.location, attribute.numberOfComponents, GL_FLOAT, GL_FALSE, stride_, offset);
+				break;
+
+			case VERTEX_ATTRIBUTE_TYPE_HALF_FLOAT:
+				glVertexAttribPointer(attribute.location, attribute.numberOfComponents, GL_HALF_FLOAT, GL_FALSE, stride_, offset);
+				break;
+
+			case VERTEX_ATTRIBUTE_TYPE_INT_2_10_10_10:
+				glVertexAttribPointer(attribute.location, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride_, offset);
+				break;
+
+			case VERTEX_ATTRIBUTE_TYPE_UNORM8:
+				glVertexAttribPointer(attribute.location, attribute.numberOfComponents, GL_UNSIGNED_BYTE, GL_TRUE, stride_, offset);
+				break;
+
+			case VERTEX_ATTRIBUTE_TYPE_INT32:
+				glVertexAttribIPointer(attribute.location, attribute.numberOfComponents, GL_INT, stride_, offset);
+				break;
+
+			case VERTEX_ATTRIBUTE_TYPE_UINT8:
+				glVertexAttribIPointer(attribute.location, attribute.numberOfComponents, GL_UNSIGNED_BYTE, stride_, offset);
+				break;
+		}
+	}
+}
+
+void VertexFormat::write(glmd::uint32 location, const std::vector< glm::vec2 >& values, std::vector< glmd::uint8 >& vertices, glmd::uint32 firstVertex, glmd::uint32 numberOfVertices) const
+{
+	writeValues<glmd::float32>(getAttribute(location), stride_, 2, values, [](const glm::vec2& value, glmd::uint32 i) { return value[i]; }, vertices, firstVertex, numberOfVertices);
+}
+
+void VertexFormat::write(glmd::uint32 location, const std::vector< glm::vec3 >& values, std::vector< glmd::uint8 >& vertices, glmd::uint32 firstVertex, glmd::uint32 numberOfVertices) const
+{
+	writeValues<glmd::float32>(getAttribute(location), stride_, 3, values, [](const glm::vec3& value, glmd::uint32 i) { return value[i]; }, vertices, firstVertex, numberOfVertices);
+}
+
+void VertexFormat::write(glmd::uint32 location, const std::vector< glm::vec4 >& values, std::vector< glmd::uint8 >& vertices, glmd::uint32 firstVertex, glmd::uint32 numberOfVertices) const
+{
+	writeValues<glmd::float32>(getAttribute(location), stride_, 4, values, [](const glm::vec4& value, glmd::uint32 i) { return value[i]; }, vertices, firstVertex, numberOfVertices);
+}
+
+void VertexFormat::write(glmd::uint32 boneIdsLocation, glmd::uint32 boneWeightsLocation, const std::vector< VertexBoneData >& values, std::vector< glmd::uint8 >& vertices,
+	glmd::uint32 firstVertex, glmd::uint32 numberOfVertices) const
+{
+	writeValues<glmd::int32>(getAttribute(boneIdsLocation), stride_, 4, values, [](const VertexBoneData& value, glmd::uint32 i) { return value.boneIds[i]; }, vertices, firstVertex, numberOfVertices);
+	writeValues<glmd::float32>(getAttribute(boneWeightsLocation), stride_, 4, values, [](const VertexBoneData& value, glmd::uint32 i) { return value.weights[i]; }, vertices, firstVertex, numberOfVertices);
+}
+
+VertexFormat createDefaultVertexFormat(bool skinned)
+{
+	auto format = VertexFormat();
+	format.addAttribute(VERTEX_ATTRIBUTE_LOCATION_POSITION, 3, VERTEX_ATTRIBUTE_TYPE_FLOAT32);
+	format.addAttribute(VERTEX_ATTRIBUTE_LOCATION_TEXTURE, 2, VERTEX_ATTRIBUTE_TYPE_FLOAT32);
+	format.addAttribute(VERTEX_ATTRIBUTE_LOCATION_NORMAL, 3, VERTEX_ATTRIBUTE_TYPE_FLOAT32);
+	format.addAttribute(VERTEX_ATTRIBUTE_LOCATION_COLOR, 4, VERTEX_ATTRIBUTE_TYPE_FLOAT32);
+
+	if (skinned)
+	{
+		format.addAttribute(VERTEX_ATTRIBUTE_LOCATION_BONE_IDS, 4, VERTEX_ATTRIBUTE_TYPE_INT32);
+		format.addAttribute(VERTEX_ATTRIBUTE_LOCATION_BONE_WEIGHTS, 4, VERTEX_ATTRIBUTE_TYPE_FLOAT32);
+	}
+
+	return format;
+}
+
+VertexFormat createPackedVertexFormat(bool skinned)
+{
+	auto format = VertexFormat();
+	format.addAttribute(VERTEX_ATTRIBUTE_LOCATION_POSITION, 3, VERTEX_ATTRIBUTE_TYPE_FLOAT32);
+	format.addAttribute(VERTEX_ATTRIBUTE_LOCATION_TEXTURE, 2, VERTEX_ATTRIBUTE_TYPE_HALF_FLOAT);
+	format.addAttribute(VERTEX_ATTRIBUTE_LOCATION_NORMAL, 3, VERTEX_ATTRIBUTE_TYPE_INT_2_10_10_10);
+	format.addAttribute(VERTEX_ATTRIBUTE_LOCATION_COLOR, 4, VERTEX_ATTRIBUTE_TYPE_UNORM8);
+
+	if (skinned)
+	{
+		format.addAttribute(VERTEX_ATTRIBUTE_LOCATION_BONE_IDS, 4, VERTEX_ATTRIBUTE_TYPE_UINT8);
+		format.addAttribute(VERTEX_ATTRIBUTE_LOCATION_BONE_WEIGHTS, 4, VERTEX_ATTRIBUTE_TYPE_FLOAT32);
+	}
+
+	return format;
+}
+
+glmd::uint16 packHalfFloat(glmd::float32 value)
+{
+	glmd::uint32 bits;
+	std::memcpy(&bits, &value, sizeof(glmd::uint32));
+
+	const glmd::uint32 sign = (bits >> 16) & 0x8000;
+	const glmd::int32 floatExponent = (bits >> 23) & 0xFF;
+	glmd::uint32 mantissa = bits & 0x7FFFFF;
+
+	// Infinity and NaN
+	if (floatExponent == 0xFF)
+		return (glmd::uint16)(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+
+	const glmd::int32 exponent = floatExponent - 127 + 15;
+
+	if (exponent >= 31)
+		return (glmd::uint16)(sign | 0x7C00);
+
+	// Too small for a normal half float - shift the mantissa (with its implicit leading 1) down into a subnormal
+	if (exponent <= 0)
+	{
+		if (exponent < -10)
+			return (glmd::uint16)sign;
+
+		mantissa |= 0x800000;
+
+		const glmd::uint32 shift = (glmd::uint32)(14 - exponent);
+		const glmd::uint32 remainder = mantissa & ((1u << shift) - 1);
+		const glmd::uint32 halfway = 1u << (shift - 1);
+
+		glmd::uint32 half = mantissa >> shift;
+
+		// Round to nearest, ties to even
+		if (remainder > halfway || (remainder == halfway && (half & 1) != 0))
+			half++;
+
+		return (glmd::uint16)(sign | half);
+	}
+
+	glmd::uint32 half = ((glmd::uint32)exponent << 10) | (mantissa >> 13);
+	const glmd::uint32 remainder = mantissa & 0x1FFF;
+
+	// Round to nearest, ties to even (a carry out of the mantissa correctly bumps the exponent, and rounds up to infinity if needed)
+	if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1) != 0))
+		half++;
+
+	return (glmd::uint16)(sign | half);
+}
+
+glmd::float32 unpackHalfFloat(glmd::uint16 value)
+{
+	const glmd::uint32 sign = ((glmd::uint32)value & 0x8000) << 16;
+	const glmd::uint32 exponent = (value >> 10) & 0x1F;
+	const glmd::uint32 mantissa = value & 0x3FF;
+
+	if (exponent == 0)
+	{
+		const glmd::float32 subnormal = std::ldexp((glmd::float32)mantissa, -24);
+		return (sign != 0 ? -subnormal : subnormal);
+	}
+
+	glmd::uint32 bits;
+
+	if (exponent == 31)
+		bits = sign | 0x7F800000 | (mantissa << 13);
+	else
+		bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+
+	glmd::float32 result;
+	std::memcpy(&result, &bits, sizeof(glmd::float32));
+
+	return result;
+}
+
+glmd::uint32 packInt2_10_10_10(const glm::vec4& value)
+{
+	const glmd::int32 x = (glmd::int32)std::floor( std::max(-1.0f, std::min(1.0f, value.x)) * 511.0f + 0.5f );
+	const glmd::int32 y = (glmd::int32)std::floor( std::max(-1.0f, std::min(1.0f, value.y)) * 511.0f + 0.5f );
+	const glmd::int32 z = (glmd::int32)std::floor( std::max(-1.0f, std::min(1.0f, value.z)) * 511.0f + 0.5f );
+	const glmd::int32 w = (glmd::int32)std::floor( std::max(-1.0f, std::min(1.0f, value.w)) + 0.5f );
+
+	return ((glmd::uint32)x & 0x3FF) | (((glmd::uint32)y & 0x3FF) << 10) | (((glmd::uint32)z & 0x3FF) << 20) | (((glmd::uint32)w & 0x3) << 30);
+}
+
+glmd::uint8 packUnorm8(glmd::float32 value)
+{
+	return (glmd::uint8)std::floor( std::max(0.0f, std::min(1.0f, value)) * 255.0f + 0.5f );
+}
+
+}
+}
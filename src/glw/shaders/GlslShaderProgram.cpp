@@ -101,6 +101,8 @@ void GlslShaderProgram::compile()
 		LOG_ERROR( ss.str() );
 		throw exception::GlException(ss.str());
 	}
+	
+	cacheUniformLocations();
 
 	LOG_DEBUG( "Done initializing shader program '" + name_ + "'." );
 }
@@ -127,22 +129,22 @@ void GlslShaderProgram::bind()
 	openGlDevice_->invalidateBindPoints();
 	
 	// Bind all the variables to bind points
-	for ( auto& b : bindings_ )
+	for ( glmd::uint32 i = 0; i < bindings_.size(); i++ )
 	{
+		auto& b = bindings_[i];
+		
 		// Ignore location bind types (they are set before the shader program is linked)
 		if (b.type == IShader::BindType::BIND_TYPE_LOCATION)
 			continue;
 
 		b.bindPoint = openGlDevice_->getBindPoint();
 
-		GLuint uniformBlockIndex = glGetUniformBlockIndex(programId_,  b.variableName.c_str());
-		if ( uniformBlockIndex != GL_INVALID_INDEX )
+		// Blocks that couldn't be found were already warned about when the shader program was linked.  The block binding is part of the
+		// program object's state, so it only needs to be set again if the bind point changed since this program was last bound.
+		if ( uniformBlockIndices_[i] != GL_INVALID_INDEX && uniformBlockBindPoints_[i] != (GLint) b.bindPoint )
 		{
-			glUniformBlockBinding(programId_, uniformBlockIndex, b.bindPoint);
-		}
-		else
-		{
-			LOG_WARN( std::string("Unable to find block index for variable '" + b.variableName + "' in shader program '" + name_ + "'.") );
+			glUniformBlockBinding(programId_, uniformBlockIndices_[i], b.bindPoint);
+			uniformBlockBindPoints_[i] = (GLint) b.bindPoint;
 		}
 	}
 	
@@ -186,6 +188,46 @@ GLint GlslShaderProgram::getVertexAttributeLocationByName(const std::string& var
 	return pos;
 }
 
+UniformHandle GlslShaderProgram::getUniformHandle(const std::string& varName) const
+{
+	return uniformLocationCache_.getUniformLocation(varName);
+}
+
+void GlslShaderProgram::setUniform(UniformHandle handle, glmd::int32 value)
+{
+	glUniform1i(handle, value);
+}
+
+void GlslShaderProgram::setUniform(UniformHandle handle, glmd::float32 value)
+{
+	glUniform1f(handle, value);
+}
+
+void GlslShaderProgram::setUniform(UniformHandle handle, const glm::vec2& value)
+{
+	glUniform2fv(handle, 1, &value[0]);
+}
+
+void GlslShaderProgram::setUniform(UniformHandle handle, const glm::vec3& value)
+{
+	glUniform3fv(handle, 1, &value[0]);
+}
+
+void GlslShaderProgram::setUniform(UniformHandle handle, const glm::vec4& value)
+{
+	glUniform4fv(handle, 1, &value[0]);
+}
+
+void GlslShaderProgram::setUniform(UniformHandle handle, const glm::mat3& value)
+{
+	glUniformMatrix3fv(handle, 1, GL_FALSE, &value[0][0]);
+}
+
+void GlslShaderProgram::setUniform(UniformHandle handle, const glm::mat4& value)
+{
+	glUniformMatrix4fv(handle, 1, GL_FALSE, &value[0][0]);
+}
+
 const std::string& GlslShaderProgram::getName() const
 {
 	return name_;
@@ -205,6 +247,33 @@ void GlslShaderProgram::generateBindings()
 	}
 }
 
+/**
+ * Looks up the locations of all of the active uniforms, and the block index of each binding, so that we don't have to ask OpenGL for them
+ * every time the shader program is bound or drawn with.
+ */
+void GlslShaderProgram::cacheUniformLocations()
+{
+	uniformLocationCache_.load( programId_ );
+	
+	uniformBlockIndices_ = std::vector< GLuint >( bindings_.size(), GL_INVALID_INDEX );
+	uniformBlockBindPoints_ = std::vector< GLint >( bindings_.size(), -1 );
+	
+	for ( glmd::uint32 i = 0; i < bindings_.size(); i++ )
+	{
+		const auto& b = bindings_[i];
+		
+		if (b.type == IShader::BindType::BIND_TYPE_LOCATION)
+			continue;
+		
+		uniformBlockIndices_[i] = uniformLocationCache_.getUniformBlockIndex( b.variableName );
+		
+		if ( uniformBlockIndices_[i] == GL_INVALID_INDEX )
+		{
+			LOG_WARN( std::string("Unable to find block index for variable '" + b.variableName + "' in shader program '" + name_ + "'.") );
+		}
+	}
+}
+
 IShader::BindingsMap GlslShaderProgram::getBindings()
 {
 	return bindings_;
@@ -0,0 +1,108 @@
+#include <vector>
+
+#include "glw/shaders/UniformLocationCache.hpp"
+
+#include "common/logger/Logger.hpp"
+
+namespace glr
+{
+namespace shaders
+{
+
+UniformLocationCache::UniformLocationCache()
+{
+}
+
+void UniformLocationCache::clear()
+{
+	uniformLocations_.clear();
+	uniformBlockIndices_.clear();
+}
+
+void UniformLocationCache::addUniform(const std::string& name, GLint location)
+{
+	uniformLocations_[name] = location;
+	
+	// Let arrays be looked up by their name alone, like glGetUniformLocation allows
+	const std::string arraySuffix = std::string("[0]");
+	if ( name.size() > arraySuffix.size() && name.compare(name.size() - arraySuffix.size(), arraySuffix.size(), arraySuffix) == 0 )
+	{
+		uniformLocations_[name.substr(0, name.size() - arraySuffix.size())] = location;
+	}
+}
+
+void UniformLocationCache::addUniformBlock(const std::string& name, GLuint index)
+{
+	uniformBlockIndices_[name] = index;
+}
+
+GLint UniformLocationCache::getUniformLocation(const std::string& name) const
+{
+	auto it = uniformLocations_.find(name);
+	if (it != uniformLocations_.end())
+	{
+		return it->second;
+	}
+	
+	return -1;
+}
+
+GLuint UniformLocationCache::getUniformBlockIndex(const std::string& name) const
+{
+	auto it = uniformBlockIndices_.find(name);
+	if (it != uniformBlockIndices_.end())
+	{
+		return it->second;
+	}
+	
+	return GL_INVALID_INDEX;
+}
+
+void UniformLocationCache::load(GLuint programId)
+{
+	clear();
+	
+	// Uniforms
+	GLint numberOfUniforms = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv(programId, GL_ACTIVE_UNIFORMS, &numberOfUniforms);
+	glGetProgramiv(programId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+	
+	std::vector< GLchar > name = std::vector< GLchar >( maxNameLength + 1 );
+	
+	for ( GLint i = 0; i < numberOfUniforms; i++ )
+	{
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = GL_NONE;
+		glGetActiveUniform(programId, i, (GLsizei) name.size(), &length, &size, &type, &name[0]);
+		
+		// Uniforms that are in a uniform block don't have a location
+		GLint location = glGetUniformLocation(programId, &name[0]);
+		if ( location >= 0 )
+		{
+			addUniform( std::string(&name[0], length), location );
+		}
+	}
+	
+	// Uniform blocks
+	GLint numberOfUniformBlocks = 0;
+	maxNameLength = 0;
+	glGetProgramiv(programId, GL_ACTIVE_UNIFORM_BLOCKS, &numberOfUniformBlocks);
+	glGetProgramiv(programId, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxNameLength);
+	
+	name = std::vector< GLchar >( maxNameLength + 1 );
+	
+	for ( GLint i = 0; i < numberOfUniformBlocks; i++ )
+	{
+		GLsizei length = 0;
+		glGetActiveUniformBlockName(programId, i, (GLsizei) name.size(), &length, &name[0]);
+		
+		addUniformBlock( std::string(&name[0], length), (GLuint) i );
+	}
+	
+	LOG_DEBUG( "Cached " << numberOfUniforms << " uniform(s) and " << numberOfUniformBlocks << " uniform block(s) for shader program " << programId << "." );
+}
+
+}
+}
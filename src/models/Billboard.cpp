@@ -1,6 +1,7 @@
 #include <utility>
 
 #include "models/Billboard.hpp"
+#include "RenderQueue.hpp"
 
 namespace glr
 {
@@ -31,5 +32,16 @@ void Billboard::render(shaders::IShaderProgram& shader)
 	// TODO: Implement
 }
 
+void Billboard::queue(RenderQueue& renderQueue, shaders::IShaderProgram& shader, const glm::mat4& modelMatrix)
+{
+	// TODO: Implement
+}
+
+glw::BoundingBox Billboard::getBoundingBox() const
+{
+	// Billboards always face the camera, so their bounds depend on the view - they are never culled
+	return glw::BoundingBox();
+}
+
 }
 }
@@ -0,0 +1,387 @@
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+
+#include "models/MeshOptimizer.hpp"
+
+/**
+ * Anonymous helper functions.
+ */
+namespace
+{
+
+namespace glmd = glm::detail;
+
+const glmd::uint32 INVALID_INDEX = 0xFFFFFFFF;
+
+// The values Forsyth recommends - the scoring models an LRU cache of 32 vertices, which also works well for smaller FIFO caches
+const glmd::uint32 MODELLED_CACHE_SIZE = 32;
+const glmd::float32 CACHE_DECAY_POWER = 1.5f;
+const glmd::float32 LAST_TRIANGLE_SCORE = 0.75f;
+const glmd::float32 VALENCE_BOOST_SCALE = 2.0f;
+const glmd::float32 VALENCE_BOOST_POWER = 0.5f;
+
+void hashCombine(std::size_t& hash, std::size_t value)
+{
+	hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+}
+
+void hashCombine(std::size_t& hash, glmd::float32 value)
+{
+	// 0 and -0 compare equal, so they have to hash the same
+	if (value == 0.0f)
+		value = 0.0f;
+
+	glmd::uint32 bits;
+	std::memcpy(&bits, &value, sizeof(glmd::uint32));
+
+	hashCombine(hash, (std::size_t)bits);
+}
+
+/**
+ * Hashes every attribute of a vertex in a MeshData (vertices are referenced by their index).
+ */
+struct VertexHash
+{
+	const glr::models::MeshData* data;
+
+	std::size_t operator()(glmd::uint32 v) const
+	{
+		std::size_t hash = 0;
+
+		for (glmd::uint32 i=0; i < 3; i++)
+			hashCombine(hash, data->vertices[v][i]);
+
+		if (v < data->normals.size())
+			for (glmd::uint32 i=0; i < 3; i++)
+				hashCombine(hash, data->normals[v][i]);
+
+		if (v < data->textureCoordinates.size())
+			for (glmd::uint32 i=0; i < 2; i++)
+				hashCombine(hash, data->textureCoordinates[v][i]);
+
+		if (v < data->colors.size())
+			for (glmd::uint32 i=0; i < 4; i++)
+				hashCombine(hash, data->colors[v][i]);
+
+		if (v < data->bones.size())
+		{
+			for (glmd::uint32 i=0; i < 4; i++)
+			{
+				hashCombine(hash, (std::size_t)data->bones[v].boneIds[i]);
+				hashCombine(hash, data->bones[v].weights[i]);
+			}
+		}
+
+		return hash;
+	}
+};
+
+struct VertexEqual
+{
+	const glr::models::MeshData* data;
+
+	bool operator()(glmd::uint32 a, glmd::uint32 b) const
+	{
+		return data->vertices[a] == data->vertices[b]
+			&& (a >= data->normals.size() || data->normals[a] == data->normals[b])
+			&& (a >= data->textureCoordinates.size() || data->textureCoordinates[a] == data->textureCoordinates[b])
+			&& (a >= data->colors.size() || data->colors[a] == data->colors[b])
+			&& (a >= data->bones.size() || (data->bones[a].boneIds == data->bones[b].boneIds && data->bones[a].weights == data->bones[b].weights));
+	}
+};
+
+/**
+ * Replaces values with the values at sources (in order).  Missing values are default constructed; empty attributes are left empty.
+ */
+template<typename T> void gather(std::vector< T >& values, const std::vector< glmd::uint32 >& sources)
+{
+	if (values.empty())
+		return;
+
+	auto gathered = std::vector< T >();
+	gathered.reserve( sources.size() );
+
+	for (auto source : sources)
+		gathered.push_back( source < values.size() ? values[source] : T() );
+
+	values = std::move(gathered);
+}
+
+void gatherVertices(glr::models::MeshData& data, const std::vector< glmd::uint32 >& sources)
+{
+	gather(data.vertices, sources);
+	gather(data.normals, sources);
+	gather(data.textureCoordinates, sources);
+	gather(data.colors, sources);
+	gather(data.bones, sources);
+}
+
+glmd::float32 calculateVertexScore(glmd::int32 cachePosition, glmd::uint32 remainingTriangles)
+{
+	// A vertex that no longer has any triangles doesn't matter
+	if (remainingTriangles == 0)
+		return -1.0f;
+
+	glmd::float32 score = 0.0f;
+
+	if (cachePosition >= 0)
+	{
+		// The vertices of the last triangle get a fixed score, so that the next triangle doesn't just reuse the last one's edge
+		if (cachePosition < 3)
+		{
+			score = LAST_TRIANGLE_SCORE;
+		}
+		else
+		{
+			const glmd::float32 scale = 1.0f / (MODELLED_CACHE_SIZE - 3);
+			score = std::pow(1.0f - (cachePosition - 3) * scale, CACHE_DECAY_POWER);
+		}
+	}
+
+	// Vertices with only a few triangles left are boosted, so that they are finished off (rather than left behind to be loaded again later)
+	score += VALENCE_BOOST_SCALE * std::pow( (glmd::float32)remainingTriangles, -VALENCE_BOOST_POWER );
+
+	return score;
+}
+
+}
+
+namespace glr
+{
+namespace models
+{
+
+void weldVertices(MeshData& data)
+{
+	const glmd::uint32 numberOfVertices = data.vertices.size();
+
+	if (data.indices.empty())
+	{
+		data.indices.resize(numberOfVertices);
+		for (glmd::uint32 i=0; i < numberOfVertices; i++)
+			data.indices[i] = i;
+	}
+
+	// Map each vertex to the first vertex that is identical to it
+	auto uniqueVertices = std::unordered_map< glmd::uint32, glmd::uint32, VertexHash, VertexEqual >( numberOfVertices, VertexHash{ &data }, VertexEqual{ &data } );
+	auto remap = std::vector< glmd::uint32 >( numberOfVertices );
+	auto sources = std::vector< glmd::uint32 >();
+
+	for (glmd::uint32 v=0; v < numberOfVertices; v++)
+	{
+		auto result = uniqueVertices.emplace( v, sources.size() );
+
+		if (result.second)
+			sources.push_back(v);
+
+		remap[v] = result.first->second;
+	}
+
+	for (auto& index : data.indices)
+		index = remap[index];
+
+	gatherVertices(data, sources);
+}
+
+void optimizeVertexCache(std::vector< glmd::uint32 >& indices, glmd::uint32 numberOfVertices)
+{
+	const glmd::uint32 numberOfTriangles = indices.size() / 3;
+
+	if (numberOfTriangles == 0)
+		return;
+
+	// The triangles that use each vertex - vertex v's triangles that haven't been added yet are at
+	// vertexTriangles[ triangleOffsets[v] ] to vertexTriangles[ triangleOffsets[v] + remainingTriangles[v] - 1 ]
+	auto remainingTriangles = std::vector< glmd::uint32 >( numberOfVertices, 0 );
+	for (glmd::uint32 i=0; i < numberOfTriangles * 3; i++)
+		remainingTriangles[ indices[i] ]++;
+
+	auto triangleOffsets = std::vector< glmd::uint32 >( numberOfVertices );
+	glmd::uint32 offset = 0;
+	for (glmd::uint32 v=0; v < numberOfVertices; v++)
+	{
+		triangleOffsets[v] = offset;
+		offset += remainingTriangles[v];
+	}
+
+	auto vertexTriangles = std::vector< glmd::uint32 >( numberOfTriangles * 3 );
+	auto fill = triangleOffsets;
+	for (glmd::uint32 i=0; i < numberOfTriangles * 3; i++)
+		vertexTriangles[ fill[indices[i]]++ ] = i / 3;
+
+	auto cachePositions = std::vector< glmd::int32 >( numberOfVertices, -1 );
+	auto vertexScores = std::vector< glmd::float32 >( numberOfVertices );
+	for (glmd::uint32 v=0; v < numberOfVertices; v++)
+		vertexScores[v] = calculateVertexScore(-1, remainingTriangles[v]);
+
+	auto triangleScores = std::vector< glmd::float32 >( numberOfTriangles );
+	auto isTriangleAdded = std::vector< bool >( numberOfTriangles, false );
+	glmd::uint32 bestTriangle = 0;
+
+	for (glmd::uint32 t=0; t < numberOfTriangles; t++)
+	{
+		triangleScores[t] = vertexScores[ indices[t * 3] ] + vertexScores[ indices[t * 3 + 1] ] + vertexScores[ indices[t * 3 + 2] ];
+
+		if (triangleScores[t] > triangleScores[bestTriangle])
+			bestTriangle = t;
+	}
+
+	auto cache = std::vector< glmd::uint32 >();
+	auto newCache = std::vector< glmd::uint32 >();
+	cache.reserve( MODELLED_CACHE_SIZE + 3 );
+	newCache.reserve( MODELLED_CACHE_SIZE + 3 );
+
+	auto newIndices = std::vector< glmd::uint32 >();
+	newIndices.reserve( indices.size() );
+
+	glmd::uint32 nextUnaddedTriangle = 0;
+
+	for (glmd::uint32 n=0; n < numberOfTriangles; n++)
+	{
+		// If none of the vertices in the cache have any triangles left, start again from the first triangle that hasn't been added
+		if (bestTriangle == INVALID_INDEX)
+		{
+			while (isTriangleAdded[nextUnaddedTriangle])
+				nextUnaddedTriangle++;
+
+			bestTriangle = nextUnaddedTriangle;
+		}
+
+		isTriangleAdded[bestTriangle] = true;
+
+		newCache.clear();
+
+		for (glmd::uint32 i=0; i < 3; i++)
+		{
+			const glmd::uint32 v = indices[bestTriangle * 3 + i];
+			newIndices.push_back(v);
+
+			// Remove the triangle from the vertex's list of remaining triangles
+			glmd::uint32* triangles = &vertexTriangles[ triangleOffsets[v] ];
+			glmd::uint32 j = 0;
+			while (triangles[j] != bestTriangle)
+				j++;
+
+			std::swap( triangles[j], triangles[remainingTriangles[v] - 1] );
+			remainingTriangles[v]--;
+
+			// Degenerate triangles can use a vertex more than once
+			if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+				newCache.push_back(v);
+		}
+
+		// The triangle's vertices move to the front of the cache, and everything else moves back
+		const glmd::uint32 numberOfTriangleVertices = newCache.size();
+
+		for (auto v : cache)
+		{
+			if (std::find(newCache.begin(), newCache.begin() + numberOfTriangleVertices, v) == newCache.begin() + numberOfTriangleVertices)
+				newCache.push_back(v);
+		}
+
+		// Update the scores of every vertex that is (or just was) in the cache, and the scores of their triangles
+		for (glmd::uint32 i=0; i < newCache.size(); i++)
+		{
+			const glmd::uint32 v = newCache[i];
+
+			cachePositions[v] = (i < MODELLED_CACHE_SIZE ? (glmd::int32)i : -1);
+
+			const glmd::float32 score = calculateVertexScore(cachePositions[v], remainingTriangles[v]);
+			const glmd::float32 difference = score - vertexScores[v];
+			vertexScores[v] = score;
+
+			for (glmd::uint32 j=0; j < remainingTriangles[v]; j++)
+				triangleScores[ vertexTriangles[triangleOffsets[v] + j] ] += difference;
+		}
+
+		if (newCache.size() > MODELLED_CACHE_SIZE)
+			newCache.resize(MODELLED_CACHE_SIZE);
+
+		std::swap(cache, newCache);
+
+		// The next triangle is the best one that uses a vertex in the cache
+		bestTriangle = INVALID_INDEX;
+		glmd::float32 bestScore = -1.0f;
+
+		for (auto v : cache)
+		{
+			for (glmd::uint32 j=0; j < remainingTriangles[v]; j++)
+			{
+				const glmd::uint32 t = vertexTriangles[triangleOffsets[v] + j];
+
+				if (triangleScores[t] > bestScore)
+				{
+					bestScore = triangleScores[t];
+					bestTriangle = t;
+				}
+			}
+		}
+	}
+
+	// Any indices after the last whole triangle are kept at the end
+	newIndices.insert( newIndices.end(), indices.begin() + numberOfTriangles * 3, indices.end() );
+
+	indices = std::move(newIndices);
+}
+
+void optimizeVertexFetch(MeshData& data)
+{
+	if (data.indices.empty())
+		return;
+
+	auto remap = std::vector< glmd::uint32 >( data.vertices.size(), INVALID_INDEX );
+	auto sources = std::vector< glmd::uint32 >();
+	sources.reserve( data.vertices.size() );
+
+	for (auto& index : data.indices)
+	{
+		if (remap[index] == INVALID_INDEX)
+		{
+			remap[index] = sources.size();
+			sources.push_back(index);
+		}
+
+		index = remap[index];
+	}
+
+	gatherVertices(data, sources);
+}
+
+void optimizeMesh(MeshData& data)
+{
+	weldVertices(data);
+	optimizeVertexCache(data.indices, data.vertices.size());
+	optimizeVertexFetch(data);
+}
+
+glmd::float32 calculateAverageCacheMissRatio(const std::vector< glmd::uint32 >& indices, glmd::uint32 numberOfVertices, glmd::uint32 cacheSize)
+{
+	const glmd::uint32 numberOfTriangles = indices.size() / 3;
+
+	if (numberOfTriangles == 0)
+		return 0.0f;
+
+	// A FIFO cache holds the last cacheSize vertices that missed - so a vertex is in the cache if fewer than cacheSize misses have happened
+	// since it was loaded
+	auto loadedAt = std::vector< glmd::int64 >( numberOfVertices, -(glmd::int64)cacheSize - 1 );
+	glmd::int64 misses = 0;
+
+	for (glmd::uint32 i=0; i < numberOfTriangles * 3; i++)
+	{
+		const glmd::uint32 v = indices[i];
+
+		if (misses - loadedAt[v] > (glmd::int64)cacheSize)
+		{
+			loadedAt[v] = misses;
+			misses++;
+		}
+	}
+
+	return (glmd::float32)misses / numberOfTriangles;
+}
+
+}
+}
@@ -1,8 +1,10 @@
 #include <utility>
+#include <cassert>
 
 #include "common/utilities/Macros.hpp"
 
 #include "models/Model.hpp"
+#include "RenderQueue.hpp"
 #include "models/ModelLoader.hpp"
 
 #include "glw/IMaterialManager.hpp"
@@ -125,6 +127,11 @@ Model::Model(Id id, std::string newName, const Model& other) : id_(id)
 
 Model::~Model()
 {
+	// Waits for the animation manager to finish updating this model, if it is
+	if (isAnimationInstanceAdded_)
+	{
+		animationManager_->removeAnimationInstance( this );
+	}
 }
 
 void Model::copy(const Model& other)
@@ -148,12 +155,16 @@ void Model::copy(const Model& other)
 	
 	// TODO: Do we want to actually do a copy on this each time?
 	rootBoneNode_ = other.rootBoneNode_;
+	skeleton_ = other.skeleton_;
+	isBonePaletteDirty_ = true;
+	isPoseDirty_ = true;
+	isNodeTracksDirty_ = true;
+	isAnimationInstanceAdded_ = false;
 	
 	globalInverseTransformation_ = other.globalInverseTransformation_;
 	
 	currentAnimation_ = nullptr;
 	
-	indexCache_ = other.indexCache_;
 	animationTime_ = other.animationTime_;
 	startFrame_ = other.startFrame_;
 	endFrame_ = other.endFrame_;
@@ -162,8 +173,18 @@ void Model::copy(const Model& other)
 	if ( other.currentAnimation_ != nullptr )
 	{
 		currentAnimation_ = other.currentAnimation_;
+		addAnimationInstance();
 	}
 
+	// The blend tree holds the playing time of its clips - so each model needs its own copy
+	blendTree_.reset();
+	
+	if ( other.blendTree_ != nullptr )
+	{
+		blendTree_ = std::unique_ptr<glw::BlendTree>( new glw::BlendTree(*other.blendTree_) );
+		addAnimationInstance();
+	}
+	
 	emptyAnimation_ = openGlDevice_->getAnimationManager()->getAnimation( glw::Constants::GLR_IDENTITY_BONES );
 }
 
@@ -180,7 +201,10 @@ void Model::initialize()
 	animationTime_ = 0.0f;
 	startFrame_ = 0;
 	endFrame_ = 0;
-	indexCache_ = std::vector<glmd::uint32>( 3 );
+	
+	compileSkeleton();
+	isPoseDirty_ = true;
+	isAnimationInstanceAdded_ = false;
 	
 	isLocalDataLoaded_ = false;
 	
@@ -191,6 +215,153 @@ void Model::destroy()
 {
 }
 
+void Model::compileSkeleton()
+{
+	skeleton_ = glw::Skeleton( rootBoneNode_ );
+	isBonePaletteDirty_ = true;
+	isNodeTracksDirty_ = true;
+}
+
+void Model::addAnimationInstance()
+{
+	if (!isAnimationInstanceAdded_)
+	{
+		animationManager_->addAnimationInstance( this );
+		isAnimationInstanceAdded_ = true;
+	}
+}
+
+void Model::updateAnimation(glm::detail::float32 timeDelta)
+{
+	std::lock_guard<std::mutex> lock(accessMutex_);
+	
+	if (!isAnimationPlaying())
+	{
+		return;
+	}
+	
+	if (blendTree_ != nullptr)
+	{
+		blendTree_->advance( timeDelta );
+	}
+	else if (timeDelta != 0.0f)
+	{
+		animationTime_ += timeDelta;
+		isPoseDirty_ = true;
+	}
+	
+	calculatePose();
+}
+
+bool Model::isAnimationPlaying() const
+{
+	return (currentAnimation_ != nullptr || blendTree_ != nullptr);
+}
+
+void Model::calculatePose()
+{
+	if (isBonePaletteDirty_)
+	{
+		auto meshBones = std::vector< glw::SkeletonBones >();
+		for ( auto m : meshes_ )
+		{
+			meshBones.push_back( skeleton_.bindBones(m->getBoneData()) );
+		}
+		
+		bonePalette_ = glw::Skeleton::createPalette( meshBones );
+		isBonePaletteDirty_ = false;
+		isPoseDirty_ = true;
+	}
+	
+	// The blend tree binds its own clips to the skeleton (and keeps track of whether its weights or clip times have changed)
+	if (blendTree_ != nullptr)
+	{
+		isPoseDirty_ = isPoseDirty_ || blendTree_->isDirty();
+	}
+	else if (isNodeTracksDirty_)
+	{
+		nodeTracks_ = currentAnimation_->bindNodes( skeleton_ );
+		isNodeTracksDirty_ = false;
+	}
+	
+	if (isPoseDirty_)
+	{
+		// Bones that aren't calculated from a node keep the identity transformation
+		boneTransformations_.assign( bonePalette_.bones.numberOfBones, glm::mat4() );
+		
+		if (blendTree_ != nullptr)
+		{
+			blendTree_->calculatePose( boneTransformations_, globalTransformations_, globalInverseTransformation_, skeleton_, bonePalette_.bones );
+		}
+		else
+		{
+			// The animation is shared with other models (which may be calculating their poses at the same time) - so none of its state is used
+			currentAnimation_->calculatePose( boneTransformations_, globalTransformations_, globalInverseTransformation_, skeleton_, nodeTracks_, bonePalette_.bones, animationTime_, startFrame_, endFrame_ );
+		}
+		
+		isPoseDirty_ = false;
+	}
+}
+
+void Model::updateBonePalette()
+{
+	// Nothing to do if the animation manager has already updated this model (and nothing has changed since)
+	calculatePose();
+	
+	// Only the shared bones are streamed - the other slots are only ever read through a remap table
+	assert( bonePalette_.numberOfSharedBones <= glw::Constants::MAX_NUMBER_OF_BONES_PER_MESH );
+	bonePaletteRange_ = streamBones( boneTransformations_, bonePalette_.numberOfSharedBones );
+}
+
+glw::StreamingBufferRange Model::getBonesRange(glmd::uint32 index)
+{
+	const auto& remap = bonePalette_.remaps[index];
+	
+	if (remap.empty())
+	{
+		return bonePaletteRange_;
+	}
+	
+	if (meshBoneTransformations_.size() < remap.size())
+	{
+		meshBoneTransformations_.resize( remap.size() );
+	}
+	
+	glw::Skeleton::remapBoneTransformations( meshBoneTransformations_, boneTransformations_, remap );
+	
+	return streamBones( meshBoneTransformations_, remap.size() );
+}
+
+void Model::queueBones(RenderQueue& renderQueue, DrawItem& item, glmd::uint32 index, glmd::uint32 firstSharedBone)
+{
+	const auto& remap = bonePalette_.remaps[index];
+	
+	if (remap.empty())
+	{
+		item.firstBone = firstSharedBone;
+		item.numberOfBones = bonePalette_.numberOfSharedBones;
+		return;
+	}
+	
+	if (meshBoneTransformations_.size() < remap.size())
+	{
+		meshBoneTransformations_.resize( remap.size() );
+	}
+	
+	glw::Skeleton::remapBoneTransformations( meshBoneTransformations_, boneTransformations_, remap );
+	
+	item.firstBone = renderQueue.pushBones( meshBoneTransformations_, remap.size() );
+	item.numberOfBones = remap.size();
+}
+
+glw::StreamingBufferRange Model::streamBones(const std::vector< glm::mat4 >& transformations, glmd::uint32 numberOfBones)
+{
+	// The range always covers the whole bone block in the shader
+	const void* data = (numberOfBones > 0 ? &transformations[0] : nullptr);
+	
+	return openGlDevice_->streamUniformData( data, numberOfBones * sizeof(glm::mat4), glw::Constants::MAX_NUMBER_OF_BONES_PER_MESH * sizeof(glm::mat4) );
+}
+
 glw::IMesh* Model::getMesh(glmd::uint32 index) const
 {
 	std::lock_guard<std::mutex> lock(accessMutex_);
@@ -205,6 +376,7 @@ void Model::removeMesh(glmd::uint32 index)
 	meshes_.erase(meshes_.begin() + index);
 	materials_.erase(materials_.begin() + index);
 	textures_.erase(textures_.begin() + index);
+	isBonePaletteDirty_ = true;
 }
 
 void Model::removeMesh(glw::IMesh* mesh)
@@ -216,6 +388,7 @@ void Model::removeMesh(glw::IMesh* mesh)
 	meshes_.erase(meshes_.begin() + index);
 	materials_.erase(materials_.begin() + index);
 	textures_.erase(textures_.begin() + index);
+	isBonePaletteDirty_ = true;
 }
 
 void Model::addMesh(glw::IMesh* mesh)
@@ -227,6 +400,7 @@ void Model::addMesh(glw::IMesh* mesh)
 	meshes_.push_back(mesh);
 	materials_.push_back( nullptr );
 	textures_.push_back( nullptr );
+	isBonePaletteDirty_ = true;
 }
 
 void Model::addMesh(glw::IMesh* mesh, glmd::uint32 index)
@@ -238,6 +412,7 @@ void Model::addMesh(glw::IMesh* mesh, glmd::uint32 index)
 	meshes_.insert(meshes_.begin() + index, mesh);
 	materials_.insert(materials_.begin() + index, nullptr);
 	textures_.insert(textures_.begin() + index, nullptr);
+	isBonePaletteDirty_ = true;
 }
 
 glmd::uint32 Model::getNumberOfMeshes() const
@@ -409,11 +584,14 @@ void Model::playAnimation(glw::IAnimation* animation, glm::detail::float32 anima
 	std::lock_guard<std::mutex> lock(accessMutex_);
 	
 	currentAnimation_ = animation;
+	blendTree_.reset();
 	animationTime_ = animationTime;
 	startFrame_ = 0;
 	endFrame_ = 0;
-
-	indexCache_ = std::vector<glmd::uint32>( 3 );
+	isPoseDirty_ = true;
+	isNodeTracksDirty_ = true;
+	
+	addAnimationInstance();
 }
 
 // TODO: Implement loop
@@ -422,11 +600,14 @@ void Model::playAnimation(glw::IAnimation* animation, glm::detail::uint32 startF
 	std::lock_guard<std::mutex> lock(accessMutex_);
 	
 	currentAnimation_ = animation;
+	blendTree_.reset();
 	animationTime_ = animationTime;
 	startFrame_ = startFrame;
 	endFrame_ = endFrame;
-
-	indexCache_ = std::vector<glmd::uint32>( 3 );
+	isPoseDirty_ = true;
+	isNodeTracksDirty_ = true;
+	
+	addAnimationInstance();
 }
 
 void Model::setAnimationTime(glm::detail::float32 animationTime)
@@ -434,6 +615,7 @@ void Model::setAnimationTime(glm::detail::float32 animationTime)
 	std::lock_guard<std::mutex> lock(accessMutex_);
 	
 	animationTime_ = animationTime;
+	isPoseDirty_ = true;
 }
 
 void Model::stopAnimation()
@@ -441,6 +623,8 @@ void Model::stopAnimation()
 	std::lock_guard<std::mutex> lock(accessMutex_);
 	
 	currentAnimation_ = nullptr;
+	blendTree_.reset();
+	isPoseDirty_ = true;
 }
 
 glw::IAnimation* Model::getPlayingAnimation() const
@@ -450,6 +634,27 @@ glw::IAnimation* Model::getPlayingAnimation() const
 	return currentAnimation_;
 }
 
+void Model::playBlendTree(std::unique_ptr<glw::BlendTree> blendTree)
+{
+	std::lock_guard<std::mutex> lock(accessMutex_);
+	
+	currentAnimation_ = nullptr;
+	blendTree_ = std::move(blendTree);
+	isPoseDirty_ = true;
+	
+	if (blendTree_ != nullptr)
+	{
+		addAnimationInstance();
+	}
+}
+
+glw::BlendTree* Model::getBlendTree() const
+{
+	std::lock_guard<std::mutex> lock(accessMutex_);
+	
+	return blendTree_.get();
+}
+
 std::vector<glw::IAnimation*> Model::getAnimations() const
 {
 	std::lock_guard<std::mutex> lock(accessMutex_);
@@ -530,6 +735,12 @@ void Model::render(shaders::IShaderProgram& shader)
 	// QUESTION: Do I want to lock this????
 	std::lock_guard<std::mutex> lock(accessMutex_);
 	
+	// The pose is calculated (and streamed) once for the whole model - every mesh uses the same bone palette
+	if (isAnimationPlaying() && shader.getBindPointByBindingName( shaders::IShader::BIND_TYPE_BONE ) >= 0)
+	{
+		updateBonePalette();
+	}
+	
 	for ( glm::detail::uint32 i = 0; i < meshes_.size(); i++ )
 	{
 		if ( textures_[i] != nullptr )
@@ -559,18 +770,12 @@ void Model::render(shaders::IShaderProgram& shader)
 			}
 		}		
 		
-		if (currentAnimation_ != nullptr)
+		if (isAnimationPlaying())
 		{
 			GLint bindPoint = shader.getBindPointByBindingName( shaders::IShader::BIND_TYPE_BONE );
 			if (bindPoint >= 0)
 			{
-				currentAnimation_->setAnimationTime( animationTime_ );
-				currentAnimation_->setFrameClampping( startFrame_, endFrame_ );
-				currentAnimation_->calculate(globalInverseTransformation_, rootBoneNode_, meshes_[i]->getBoneData(), indexCache_);
-				currentAnimation_->pushToVideoMemory();
-				//std::cout << "animationTime_: " << animationTime_ << " startFrame_: " << startFrame_ << " endFrame_: " << endFrame_ << std::endl;
-				
-				openGlDevice_->bindBuffer( currentAnimation_->getBufferId(), bindPoint );
+				openGlDevice_->bindBuffer( getBonesRange(i), bindPoint );
 			}
 		}
 		else
@@ -583,7 +788,7 @@ void Model::render(shaders::IShaderProgram& shader)
 			{
 				emptyAnimation_->pushToVideoMemory();
 
-				openGlDevice_->bindBuffer( emptyAnimation_->getBufferId(), bindPoint );
+				openGlDevice_->bindBuffer( emptyAnimation_->getBufferRange(), bindPoint );
 			}
 		}
 		
@@ -591,6 +796,94 @@ void Model::render(shaders::IShaderProgram& shader)
 	}
 }
 
+void Model::queue(RenderQueue& renderQueue, shaders::IShaderProgram& shader, const glm::mat4& modelMatrix)
+{
+	std::lock_guard<std::mutex> lock(accessMutex_);
+	
+	const bool hasBones = (shader.getBindPointByBindingName( shaders::IShader::BIND_TYPE_BONE ) >= 0);
+	
+	// The render queue streams the bones when the meshes are drawn - the bone palette is only added to it once, for every mesh that uses it
+	glmd::uint32 firstSharedBone = 0;
+	
+	if (isAnimationPlaying() && hasBones)
+	{
+		calculatePose();
+		firstSharedBone = renderQueue.pushBones( boneTransformations_, bonePalette_.numberOfSharedBones );
+	}
+	
+	for ( glm::detail::uint32 i = 0; i < meshes_.size(); i++ )
+	{
+		DrawItem item = DrawItem();
+		item.shaderProgram = &shader;
+		item.texture = textures_[i];
+		item.material = materials_[i];
+		item.mesh = meshes_[i];
+		item.modelMatrix = modelMatrix;
+		
+		// Meshes without an animation are given identity bones by the render queue
+		if (isAnimationPlaying() && hasBones)
+		{
+			queueBones( renderQueue, item, i, firstSharedBone );
+		}
+		
+		renderQueue.push( item );
+	}
+}
+
+glw::BoundingBox Model::getBoundingBox() const
+{
+	std::lock_guard<std::mutex> lock(accessMutex_);
+	
+	glw::BoundingBox box = glw::BoundingBox();
+	
+	if (isAnimationPlaying())
+	{
+		return box;
+	}
+	
+	for ( auto m : meshes_ )
+	{
+		if (m != nullptr)
+		{
+			box.expand( m->getBoundingBox() );
+		}
+	}
+	
+	return box;
+}
+
+void Model::replaceResources(const Model& other)
+{
+	if (&other == this)
+	{
+		return;
+	}
+	
+	std::lock(accessMutex_, other.accessMutex_);
+	std::lock_guard<std::mutex> lock(accessMutex_, std::adopt_lock);
+	std::lock_guard<std::mutex> otherLock(other.accessMutex_, std::adopt_lock);
+	
+	filename_ = other.filename_;
+	
+	meshes_ = other.meshes_;
+	textures_ = other.textures_;
+	materials_ = other.materials_;
+	animations_ = other.animations_;
+	
+	rootBoneNode_ = other.rootBoneNode_;
+	skeleton_ = other.skeleton_;
+	isBonePaletteDirty_ = true;
+	globalInverseTransformation_ = other.globalInverseTransformation_;
+	
+	currentAnimation_ = nullptr;
+	blendTree_.reset();
+	animationTime_ = 0.0f;
+	startFrame_ = 0;
+	endFrame_ = 0;
+	
+	isLocalDataLoaded_ = other.isLocalDataLoaded_.load();
+}
+
 void Model::pushToVideoMemory()
 {
 	std::lock_guard<std::mutex> lock(accessMutex_);
@@ -666,7 +959,7 @@ void Model::loadLocalData()
 	
 	if (!filename_.empty())
 	{
-		ModelLoader modelLoader = ModelLoader(openGlDevice_);
+		ModelLoader modelLoader( openGlDevice_ );
 		auto data = modelLoader.loadModelData(name_, filename_);
 		auto& modelData = data.first;
 		auto& animationSet = data.second;
@@ -686,7 +979,8 @@ void Model::loadLocalData()
 			auto mesh = meshManager->getMesh(d.meshData.name);
 			if (mesh == nullptr)
 			{
-				mesh = meshManager->addMesh(d.meshData.name, d.meshData.vertices, d.meshData.normals, d.meshData.textureCoordinates, d.meshData.colors, d.meshData.bones, d.boneData, false);
+				mesh = meshManager->addMesh(d.meshData.name, d.meshData.vertices, d.meshData.normals, d.meshData.textureCoordinates, d.meshData.colors, d.meshData.bones, d.boneData, d.meshData.vertexFormat, false);
+				mesh->setIndices( d.meshData.indices );
 			}
 			
 			meshes_.push_back( mesh );
@@ -719,6 +1013,7 @@ void Model::loadLocalData()
 		
 		// Create bone structure (tree structure)
 		rootBoneNode_ = animationSet.rootBoneNode;
+		compileSkeleton();
 		
 		// Set the global inverse transformation
 		globalInverseTransformation_ = animationSet.globalInverseTransformation;
@@ -1234,6 +1529,8 @@ template<class Archive> void Model::load(Archive& ar, const unsigned int version
 	ar & rootBoneNode_;
 	ar & globalInverseTransformation_;
 	
+	compileSkeleton();
+	
 	{
 		std::map< std::string, glr::glw::IAnimation* >::size_type size = 0;
 		ar & size;
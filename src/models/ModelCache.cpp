@@ -0,0 +1,698 @@
+#include <cstring>
+#include <cstdio>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iterator>
+#include <thread>
+#include <functional>
+#include <utility>
+
+#include "models/ModelCache.hpp"
+
+#include "MappedFile.hpp"
+
+#include "exceptions/IoException.hpp"
+
+#include "common/logger/Logger.hpp"
+
+namespace glr
+{
+namespace models
+{
+
+/** Anonymous helper functions. */
+namespace
+{
+
+// Guards against a corrupt cache file recursing through a bone hierarchy that is deeper than any real skeleton
+const glmd::uint32 MAX_BONE_NODE_DEPTH = 256;
+
+/**
+ * Appends values to a buffer in the model cache layout.
+ */
+class Writer
+{
+public:
+	Writer(std::vector<glmd::uint8>& data) : data_(data)
+	{
+	}
+	
+	template<typename T> void writeValue(const T& value)
+	{
+		const glmd::uint64 offset = data_.size();
+		data_.resize( offset + sizeof(T) );
+		std::memcpy( &data_[offset], &value, sizeof(T) );
+	}
+	
+	template<typename T> void writeArray(const T* values, glmd::uint32 numberOfElements)
+	{
+		data_.resize( (data_.size() + model_cache::ALIGNMENT - 1) / model_cache::ALIGNMENT * model_cache::ALIGNMENT, 0 );
+		
+		ModelCacheArrayHeader header = ModelCacheArrayHeader();
+		header.numberOfElements = numberOfElements;
+		header.elementSize = sizeof(T);
+		writeValue( header );
+		
+		if (numberOfElements > 0)
+		{
+			const glmd::uint64 offset = data_.size();
+			data_.resize( offset + (glmd::uint64)numberOfElements * sizeof(T) );
+			std::memcpy( &data_[offset], values, (glmd::uint64)numberOfElements * sizeof(T) );
+		}
+	}
+	
+	template<typename T> void writeArray(const std::vector<T>& values)
+	{
+		writeArray( values.empty() ? nullptr : &values[0], (glmd::uint32)values.size() );
+	}
+	
+	void writeString(const std::string& value)
+	{
+		writeArray( value.data(), (glmd::uint32)value.size() );
+	}
+
+private:
+	std::vector<glmd::uint8>& data_;
+};
+
+/**
+ * Reads values from a buffer in the model cache layout.  Every read checks that it stays inside of the buffer - once a read fails, the
+ * data is invalid.
+ */
+class Reader
+{
+public:
+	Reader(const glmd::uint8* data, glmd::uint64 size) : data_(data), size_(size), offset_(0)
+	{
+	}
+	
+	template<typename T> bool readValue(T& value)
+	{
+		if (offset_ + sizeof(T) > size_)
+		{
+			return false;
+		}
+		
+		std::memcpy( &value, data_ + offset_, sizeof(T) );
+		offset_ += sizeof(T);
+		
+		return true;
+	}
+	
+	template<typename T> bool readArray(std::vector<T>& values)
+	{
+		glmd::uint32 numberOfElements = 0;
+		const glmd::uint8* elements = readArrayElements( sizeof(T), numberOfElements );
+		
+		if (elements == nullptr)
+		{
+			return false;
+		}
+		
+		values.resize( numberOfElements );
+		
+		if (numberOfElements > 0)
+		{
+			std::memcpy( &values[0], elements, (glmd::uint64)numberOfElements * sizeof(T) );
+		}
+		
+		return true;
+	}
+	
+	bool readString(std::string& value)
+	{
+		glmd::uint32 numberOfElements = 0;
+		const glmd::uint8* elements = readArrayElements( sizeof(char), numberOfElements );
+		
+		if (elements == nullptr)
+		{
+			return false;
+		}
+		
+		value.assign( (const char*)elements, numberOfElements );
+		
+		return true;
+	}
+
+private:
+	const glmd::uint8* data_;
+	glmd::uint64 size_;
+	glmd::uint64 offset_;
+	
+	/**
+	 * Reads the header of the next array, and skips over its elements.
+	 *
+	 * @return The elements of the array, or nullptr if the array is invalid.
+	 */
+	const glmd::uint8* readArrayElements(glmd::uint32 elementSize, glmd::uint32& numberOfElements)
+	{
+		offset_ = (offset_ + model_cache::ALIGNMENT - 1) / model_cache::ALIGNMENT * model_cache::ALIGNMENT;
+		
+		ModelCacheArrayHeader header = ModelCacheArrayHeader();
+		
+		if (!readValue( header ) || header.elementSize != elementSize)
+		{
+			return nullptr;
+		}
+		
+		const glmd::uint64 size = (glmd::uint64)header.numberOfElements * elementSize;
+		
+		if (offset_ + size > size_)
+		{
+			return nullptr;
+		}
+		
+		const glmd::uint8* elements = data_ + offset_;
+		offset_ += size;
+		numberOfElements = header.numberOfElements;
+		
+		return elements;
+	}
+};
+
+/**
+ * Returns true if attribute can be added to format - a corrupt cache file must not make VertexFormat::addAttribute throw.
+ */
+bool isValidAttribute(const glw::VertexFormat& format, const glw::VertexAttribute& attribute)
+{
+	if (attribute.location >= glw::VERTEX_ATTRIBUTE_LOCATION_INSTANCE_MODEL_MATRIX || format.getAttribute( attribute.location ) != nullptr)
+	{
+		return false;
+	}
+	
+	// The type was copied straight out of the file, so may not be one of the enum's values
+	if ((glmd::uint32)attribute.type > glw::VERTEX_ATTRIBUTE_TYPE_UINT8)
+	{
+		return false;
+	}
+	
+	const glmd::uint32 minimumNumberOfComponents = (attribute.type == glw::VERTEX_ATTRIBUTE_TYPE_INT_2_10_10_10 ? 3 : 1);
+	
+	return attribute.numberOfComponents >= minimumNumberOfComponents && attribute.numberOfComponents <= 4;
+}
+
+/**
+ * Returns the material libraries an .obj file imports (its 'mtllib' statements), relative to the directory of the .obj file - Assimp
+ * reads these when it imports the file.
+ */
+std::vector< std::string > findMaterialLibraries(const glmd::uint8* data, glmd::uint64 size)
+{
+	auto materialLibraries = std::vector< std::string >();
+	const std::string statement = "mtllib";
+	
+	glmd::uint64 lineStart = 0;
+	
+	while (lineStart < size)
+	{
+		glmd::uint64 lineEnd = lineStart;
+		while (lineEnd < size && data[lineEnd] != '\n' && data[lineEnd] != '\r')
+		{
+			lineEnd++;
+		}
+		
+		auto line = std::string( (const char*)data + lineStart, lineEnd - lineStart );
+		
+		if (line.compare(0, statement.size(), statement) == 0 && line.size() > statement.size() && std::isspace( (unsigned char)line[statement.size()] ))
+		{
+			// The rest of the line is the filename (which may contain spaces)
+			const auto first = line.find_first_not_of( " \t", statement.size() );
+			const auto last = line.find_last_not_of( " \t" );
+			
+			if (first != std::string::npos)
+			{
+				materialLibraries.push_back( line.substr(first, last - first + 1) );
+			}
+		}
+		
+		lineStart = lineEnd + 1;
+	}
+	
+	return materialLibraries;
+}
+
+bool hasExtension(const std::string& filename, const std::string& extension)
+{
+	if (filename.size() < extension.size())
+	{
+		return false;
+	}
+	
+	for ( glmd::uint32 i = 0; i < extension.size(); i++ )
+	{
+		if (std::tolower( (unsigned char)filename[filename.size() - extension.size() + i] ) != extension[i])
+		{
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+void writeModelData(Writer& writer, const ModelData& modelData)
+{
+	const MeshData& mesh = modelData.meshData;
+	writer.writeString( mesh.name );
+	writer.writeArray( mesh.vertices );
+	writer.writeArray( mesh.normals );
+	writer.writeArray( mesh.textureCoordinates );
+	writer.writeArray( mesh.colors );
+	writer.writeArray( mesh.bones );
+	writer.writeArray( mesh.indices );
+	writer.writeArray( mesh.vertexFormat.getAttributes() );
+	
+	const MaterialData& material = modelData.materialData;
+	writer.writeString( material.name );
+	writer.writeValue( material.fill_mode );
+	writer.writeValue( material.ambient );
+	writer.writeValue( material.diffuse );
+	writer.writeValue( material.specular );
+	writer.writeValue( material.emission );
+	writer.writeValue( material.shininess );
+	writer.writeValue( material.strength );
+	
+	const TextureData& texture = modelData.textureData;
+	writer.writeString( texture.filename );
+	writer.writeValue( texture.settings.textureWrapS );
+	writer.writeValue( texture.settings.textureWrapT );
+	
+	const glw::BoneData& bones = modelData.boneData;
+	writer.writeString( bones.name );
+	writer.writeValue( (glmd::uint32)bones.boneIndexMap.size() );
+	
+	for ( const auto& it : bones.boneIndexMap )
+	{
+		writer.writeString( it.first );
+		writer.writeValue( it.second );
+	}
+	
+	writer.writeValue( (glmd::uint32)bones.boneTransform.size() );
+	
+	for ( const auto& bone : bones.boneTransform )
+	{
+		writer.writeString( bone.name );
+		writer.writeValue( bone.boneOffset );
+	}
+}
+
+bool readModelData(Reader& reader, ModelData& modelData)
+{
+	MeshData& mesh = modelData.meshData;
+	auto attributes = std::vector< glw::VertexAttribute >();
+	
+	if ( !(reader.readString( mesh.name ) && reader.readArray( mesh.vertices ) && reader.readArray( mesh.normals ) && reader.readArray( mesh.textureCoordinates )
+		&& reader.readArray( mesh.colors ) && reader.readArray( mesh.bones ) && reader.readArray( mesh.indices ) && reader.readArray( attributes )) )
+	{
+		return false;
+	}
+	
+	// The offsets and stride are recalculated as the attributes are added
+	mesh.vertexFormat = glw::VertexFormat();
+	
+	for ( const auto& attribute : attributes )
+	{
+		if ( !isValidAttribute( mesh.vertexFormat, attribute ) )
+		{
+			return false;
+		}
+		
+		mesh.vertexFormat.addAttribute( attribute.location, attribute.numberOfComponents, attribute.type );
+	}
+	
+	MaterialData& material = modelData.materialData;
+	
+	if ( !(reader.readString( material.name ) && reader.readValue( material.fill_mode ) && reader.readValue( material.ambient ) && reader.readValue( material.diffuse )
+		&& reader.readValue( material.specular ) && reader.readValue( material.emission ) && reader.readValue( material.shininess ) && reader.readValue( material.strength )) )
+	{
+		return false;
+	}
+	
+	TextureData& texture = modelData.textureData;
+	
+	if ( !(reader.readString( texture.filename ) && reader.readValue( texture.settings.textureWrapS ) && reader.readValue( texture.settings.textureWrapT )) )
+	{
+		return false;
+	}
+	
+	glw::BoneData& bones = modelData.boneData;
+	glmd::uint32 numberOfEntries = 0;
+	
+	if ( !(reader.readString( bones.name ) && reader.readValue( numberOfEntries )) )
+	{
+		return false;
+	}
+	
+	for ( glmd::uint32 i = 0; i < numberOfEntries; i++ )
+	{
+		auto boneName = std::string();
+		glmd::uint32 index = 0;
+		
+		if ( !(reader.readString( boneName ) && reader.readValue( index )) )
+		{
+			return false;
+		}
+		
+		bones.boneIndexMap[boneName] = index;
+	}
+	
+	glmd::uint32 numberOfBones = 0;
+	
+	if ( !reader.readValue( numberOfBones ) )
+	{
+		return false;
+	}
+	
+	for ( glmd::uint32 i = 0; i < numberOfBones; i++ )
+	{
+		glw::Bone bone = glw::Bone();
+		
+		if ( !(reader.readString( bone.name ) && reader.readValue( bone.boneOffset )) )
+		{
+			return false;
+		}
+		
+		bones.boneTransform.push_back( std::move(bone) );
+	}
+	
+	return true;
+}
+
+void writeBoneNode(Writer& writer, const glw::BoneNode& node)
+{
+	writer.writeString( node.name );
+	writer.writeValue( node.transformation );
+	writer.writeValue( (glmd::uint32)node.children.size() );
+	
+	for ( const auto& child : node.children )
+	{
+		writeBoneNode( writer, child );
+	}
+}
+
+bool readBoneNode(Reader& reader, glw::BoneNode& node, glmd::uint32 depth)
+{
+	glmd::uint32 numberOfChildren = 0;
+	
+	if ( depth > MAX_BONE_NODE_DEPTH || !(reader.readString( node.name ) && reader.readValue( node.transformation ) && reader.readValue( numberOfChildren )) )
+	{
+		return false;
+	}
+	
+	for ( glmd::uint32 i = 0; i < numberOfChildren; i++ )
+	{
+		node.children.push_back( glw::BoneNode() );
+		
+		if ( !readBoneNode( reader, node.children.back(), depth + 1 ) )
+		{
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+void writeAnimationSet(Writer& writer, const AnimationSet& animationSet)
+{
+	writer.writeString( animationSet.name );
+	writeBoneNode( writer, animationSet.rootBoneNode );
+	writer.writeValue( animationSet.globalInverseTransformation );
+	writer.writeValue( (glmd::uint32)animationSet.animations.size() );
+	
+	for ( const auto& it : animationSet.animations )
+	{
+		const AnimationData& animation = it.second;
+		
+		writer.writeString( it.first );
+		writer.writeString( animation.name );
+		writer.writeValue( animation.duration );
+		writer.writeValue( animation.ticksPerSecond );
+		writer.writeValue( (glmd::uint32)animation.animatedBoneNodes.size() );
+		
+		for ( const auto& track : animation.animatedBoneNodes )
+		{
+			const glw::AnimatedBoneNode& node = track.second;
+			
+			writer.writeString( track.first );
+			writer.writeString( node.name );
+			writer.writeArray( node.positionTimes );
+			writer.writeArray( node.rotationTimes );
+			writer.writeArray( node.scalingTimes );
+			writer.writeArray( node.positions );
+			writer.writeArray( node.rotations );
+			writer.writeArray( node.scalings );
+		}
+	}
+}
+
+bool readAnimationSet(Reader& reader, AnimationSet& animationSet)
+{
+	glmd::uint32 numberOfAnimations = 0;
+	
+	if ( !(reader.readString( animationSet.name ) && readBoneNode( reader, animationSet.rootBoneNode, 0 ) && reader.readValue( animationSet.globalInverseTransformation )
+		&& reader.readValue( numberOfAnimations )) )
+	{
+		return false;
+	}
+	
+	for ( glmd::uint32 i = 0; i < numberOfAnimations; i++ )
+	{
+		auto animationName = std::string();
+		AnimationData animation = AnimationData();
+		glmd::uint32 numberOfTracks = 0;
+		
+		if ( !(reader.readString( animationName ) && reader.readString( animation.name ) && reader.readValue( animation.duration ) && reader.readValue( animation.ticksPerSecond )
+			&& reader.readValue( numberOfTracks )) )
+		{
+			return false;
+		}
+		
+		for ( glmd::uint32 j = 0; j < numberOfTracks; j++ )
+		{
+			auto trackName = std::string();
+			glw::AnimatedBoneNode node = glw::AnimatedBoneNode();
+			
+			if ( !(reader.readString( trackName ) && reader.readString( node.name ) && reader.readArray( node.positionTimes ) && reader.readArray( node.rotationTimes )
+				&& reader.readArray( node.scalingTimes ) && reader.readArray( node.positions ) && reader.readArray( node.rotations ) && reader.readArray( node.scalings )) )
+			{
+				return false;
+			}
+			
+			animation.animatedBoneNodes[trackName] = std::move(node);
+		}
+		
+		animationSet.animations[animationName] = std::move(animation);
+	}
+	
+	return true;
+}
+
+}
+
+namespace model_cache
+{
+
+glmd::uint64 calculateHash(const glmd::uint8* data, glmd::uint64 size, glmd::uint64 hash)
+{
+	for ( glmd::uint64 i = 0; i < size; i++ )
+	{
+		hash ^= data[i];
+		hash *= 1099511628211ull;
+	}
+	
+	return hash;
+}
+
+glmd::uint64 calculateSourceHash(const std::string& name, const std::string& filename)
+{
+	MappedFile file( filename );
+	
+	glmd::uint64 hash = calculateHash( file.getData(), file.getSize() );
+	
+	// Editing the materials of an .obj file has to give it a new cache file too
+	if ( hasExtension(filename, ".obj") )
+	{
+		const auto separator = filename.find_last_of( "/\\" );
+		const std::string directory = (separator == std::string::npos ? std::string() : filename.substr(0, separator + 1));
+		
+		for ( const auto& materialLibrary : findMaterialLibraries(file.getData(), file.getSize()) )
+		{
+			// A missing material library is hashed as empty - Assimp imports the model with a default material
+			std::ifstream stream( (directory + materialLibrary).c_str(), std::ios::binary );
+			const std::string contents = std::string( std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() );
+			
+			hash = calculateHash( (const glmd::uint8*)materialLibrary.data(), materialLibrary.size(), hash );
+			hash = calculateHash( (const glmd::uint8*)contents.data(), contents.size(), hash );
+		}
+	}
+	
+	hash = calculateHash( (const glmd::uint8*)name.data(), name.size(), hash );
+	hash = calculateHash( (const glmd::uint8*)&VERSION, sizeof(VERSION), hash );
+	
+	return hash;
+}
+
+void write(glmd::uint64 sourceHash, const std::vector< ModelData >& modelData, const AnimationSet& animationSet, std::vector<glmd::uint8>& data)
+{
+	data.clear();
+	
+	Writer writer = Writer( data );
+	
+	ModelCacheFileHeader header = ModelCacheFileHeader();
+	header.magic = FILE_MAGIC;
+	header.version = VERSION;
+	header.sourceHash = sourceHash;
+	header.numberOfMeshes = (glmd::uint32)modelData.size();
+	writer.writeValue( header );
+	
+	for ( const auto& d : modelData )
+	{
+		writeModelData( writer, d );
+	}
+	
+	writeAnimationSet( writer, animationSet );
+	
+	// The size is only known once everything has been written
+	header.size = data.size();
+	std::memcpy( &data[0], &header, sizeof(ModelCacheFileHeader) );
+}
+
+bool read(const glmd::uint8* data, glmd::uint64 size, glmd::uint64 sourceHash, std::vector< ModelData >& modelData, AnimationSet& animationSet)
+{
+	Reader reader = Reader( data, size );
+	
+	ModelCacheFileHeader header = ModelCacheFileHeader();
+	
+	if ( !reader.readValue( header ) || header.magic != FILE_MAGIC || header.version != VERSION || header.sourceHash != sourceHash || header.size != size )
+	{
+		return false;
+	}
+	
+	// Only hand back the data once all of it has been read
+	auto newModelData = std::vector< ModelData >();
+	auto newAnimationSet = AnimationSet();
+	
+	for ( glmd::uint32 i = 0; i < header.numberOfMeshes; i++ )
+	{
+		newModelData.push_back( ModelData() );
+		
+		if ( !readModelData( reader, newModelData.back() ) )
+		{
+			return false;
+		}
+	}
+	
+	if ( !readAnimationSet( reader, newAnimationSet ) )
+	{
+		return false;
+	}
+	
+	modelData = std::move(newModelData);
+	animationSet = std::move(newAnimationSet);
+	
+	return true;
+}
+
+}
+
+ModelCache::ModelCache(std::string directory) : directory_(std::move(directory))
+{
+	if (!directory_.empty() && directory_.back() != '/' && directory_.back() != '\\')
+	{
+		directory_ += '/';
+	}
+}
+
+const std::string& ModelCache::getDirectory() const
+{
+	return directory_;
+}
+
+std::string ModelCache::getCacheFilename(glmd::uint64 sourceHash) const
+{
+	std::stringstream ss;
+	ss << directory_ << std::hex << std::setw(16) << std::setfill('0') << sourceHash << ".glrmodel";
+	
+	return ss.str();
+}
+
+bool ModelCache::load(glmd::uint64 sourceHash, std::vector< ModelData >& modelData, AnimationSet& animationSet) const
+{
+	const std::string filename = getCacheFilename( sourceHash );
+	
+	// A missing cache file is the normal case for a model that hasn't been loaded before - don't go through MappedFile, which logs an error
+	if ( !std::ifstream( filename ).good() )
+	{
+		LOG_DEBUG( "Model cache file '" << filename << "' not found." );
+		return false;
+	}
+	
+	try
+	{
+		MappedFile file( filename );
+		
+		if ( model_cache::read( file.getData(), file.getSize(), sourceHash, modelData, animationSet ) )
+		{
+			return true;
+		}
+	}
+	catch (const exception::IoException&)
+	{
+		// MappedFile has logged why
+	}
+	catch (const std::exception& e)
+	{
+		// The cache is only an optimization - whatever is wrong with the file, the model can still be imported
+		LOG_WARN( "Unable to read model cache file '" << filename << "': " << e.what() );
+	}
+	
+	LOG_WARN( "Model cache file '" << filename << "' is invalid - ignoring it." );
+	
+	return false;
+}
+
+void ModelCache::save(glmd::uint64 sourceHash, const std::vector< ModelData >& modelData, const AnimationSet& animationSet) const
+{
+	auto data = std::vector<glmd::uint8>();
+	model_cache::write( sourceHash, modelData, animationSet, data );
+	
+	const std::string filename = getCacheFilename( sourceHash );
+	
+	// Several threads may be caching the same model - each writes its own temporary file
+	std::stringstream ss;
+	ss << filename << ".tmp" << std::hash<std::thread::id>()( std::this_thread::get_id() );
+	const std::string temporaryFilename = ss.str();
+	
+	std::ofstream stream( temporaryFilename.c_str(), std::ios::binary | std::ios::trunc );
+	stream.write( (const char*)&data[0], data.size() );
+	stream.close();
+	
+	if ( !stream )
+	{
+		std::remove( temporaryFilename.c_str() );
+		
+		const std::string msg = std::string( "Unable to write model cache file: " ) + temporaryFilename;
+		LOG_ERROR( msg );
+		throw exception::IoException( msg );
+	}
+	
+	if ( std::rename( temporaryFilename.c_str(), filename.c_str() ) != 0 )
+	{
+		std::remove( temporaryFilename.c_str() );
+		
+		// Another thread got there first (the contents are the same) - rename won't replace an existing file on every platform
+		if ( std::ifstream( filename ).good() )
+		{
+			return;
+		}
+		
+		const std::string msg = std::string( "Unable to write model cache file: " ) + filename;
+		LOG_ERROR( msg );
+		throw exception::IoException( msg );
+	}
+	
+	LOG_DEBUG( "Wrote model cache file '" << filename << "' (" << data.size() << " bytes)." );
+}
+
+}
+}
@@ -6,6 +6,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <chrono>
 
 // C++ importer interface
 #include <assimp/Importer.hpp>
@@ -36,19 +37,27 @@
 #include "models/AnimationData.hpp"
 #include "models/ModelData.hpp"
 #include "models/MeshData.hpp"
+#include "models/MeshOptimizer.hpp"
 #include "models/TextureData.hpp"
 #include "models/MaterialData.hpp"
+#include "models/ModelCache.hpp"
 
 #include "common/utilities/AssImpUtilities.hpp"
 #include "exceptions/GlException.hpp"
+#include "exceptions/IoException.hpp"
 
 namespace glr
 {
 namespace models
 {
 
-ModelLoader::ModelLoader(glw::IOpenGlDevice* openGlDevice) : openGlDevice_(openGlDevice)
+ModelLoader::ModelLoader(glw::IOpenGlDevice* openGlDevice, const std::string& modelCacheDirectory) : openGlDevice_(openGlDevice)
 {
+	if ( !modelCacheDirectory.empty() )
+	{
+		modelCache_ = std::unique_ptr<ModelCache>( new ModelCache(modelCacheDirectory) );
+	}
+	
 	// get a handle to the predefined STDOUT log stream and attach
 	// it to the logging system. It remains active for all further
 	// calls to aiImportFile(Ex) and aiApplyPostProcessing.
@@ -86,15 +95,58 @@ std::unique_ptr<Model> ModelLoader::loadModel(const std::string& name, const std
 }
 
 std::pair<std::vector< ModelData >, AnimationSet> ModelLoader::loadModelData(const std::string& name, const std::string& filename)
+{
+	const auto start = std::chrono::steady_clock::now();
+	
+	glmd::uint64 sourceHash = 0;
+	
+	if (modelCache_ != nullptr)
+	{
+		auto modelData = std::vector< ModelData >();
+		auto animationSet = AnimationSet();
+		
+		sourceHash = model_cache::calculateSourceHash(name, filename);
+		
+		if ( modelCache_->load(sourceHash, modelData, animationSet) )
+		{
+			const auto time = std::chrono::duration<glmd::float64, std::milli>( std::chrono::steady_clock::now() - start ).count();
+			LOG_INFO( "Loaded model '" << name << "' from the model cache (warm) in " << time << " ms." );
+			
+			return std::pair<std::vector< ModelData >, AnimationSet>( std::move(modelData), std::move(animationSet) );
+		}
+	}
+	
+	auto data = importModelData(name, filename);
+	
+	const auto time = std::chrono::duration<glmd::float64, std::milli>( std::chrono::steady_clock::now() - start ).count();
+	LOG_INFO( "Imported model '" << name << "' (cold) in " << time << " ms." );
+	
+	if (modelCache_ != nullptr)
+	{
+		// Not being able to write the cache only makes the next start slower
+		try
+		{
+			modelCache_->save(sourceHash, data.first, data.second);
+		}
+		catch (const exception::IoException& e)
+		{
+			LOG_WARN( "Unable to cache model '" << name << "': " << e.what() );
+		}
+	}
+	
+	return data;
+}
+
+std::pair<std::vector< ModelData >, AnimationSet> ModelLoader::importModelData(const std::string& name, const std::string& filename)
 {
 	LOG_DEBUG( "Loading model data from file '" << filename << "'." );
 
 	auto modelData = std::vector< ModelData >();
 
-	// We don't currently support aiProcess_JoinIdenticalVertices or aiProcess_FindInvalidData
-	// aiProcess_JoinIdenticalVertices - doesn't work because we don't use vertex index lists (maybe we should?)
-	// aiProcess_FindInvalidData - I think it's due to the reduction of animation tracks containing redundant keys..
-	const aiScene* scene = aiImportFile(filename.c_str(), aiProcessPreset_TargetRealtime_MaxQuality ^ aiProcess_JoinIdenticalVertices ^ aiProcess_FindInvalidData);
+	// We don't currently support aiProcess_FindInvalidData - I think it's due to the reduction of animation tracks containing redundant keys..
+	// aiProcess_JoinIdenticalVertices and aiProcess_ImproveCacheLocality aren't used either - loadMesh() welds the vertices once the bone
+	// weights are attached to them, and then optimizes the welded mesh for the vertex cache (see models/MeshOptimizer.hpp)
+	const aiScene* scene = aiImportFile(filename.c_str(), aiProcessPreset_TargetRealtime_MaxQuality ^ aiProcess_JoinIdenticalVertices ^ aiProcess_ImproveCacheLocality ^ aiProcess_FindInvalidData);
 
 	// Error checking
 	if ( scene == nullptr )
@@ -160,46 +212,24 @@ std::pair<std::vector< ModelData >, AnimationSet> ModelLoader::loadModelData(con
 
 std::unique_ptr<Model> ModelLoader::generateModel(const std::string& name, const std::vector<ModelData>& modelData, const AnimationSet& animationSet, IdManager& idManager)
 {
-	auto meshManager = openGlDevice_->getMeshManager();
-	auto materialManager = openGlDevice_->getMaterialManager();
-	auto textureManager = openGlDevice_->getTextureManager();
-	auto animationManager = openGlDevice_->getAnimationManager();
+	auto meshes = std::vector<glw::IMesh*>( modelData.size() );
+	auto textures = std::vector<glw::ITexture*>( modelData.size() );
+	auto materials = std::vector<glw::IMaterial*>( modelData.size() );
 	
-	auto meshes = std::vector<glw::IMesh*>();
-	auto textures = std::vector<glw::ITexture*>();
-	auto materials = std::vector<glw::IMaterial*>();
-	auto animations = std::vector<glw::IAnimation*>();
-	
-	for ( auto& d : modelData)
+	for ( glmd::uint32 i = 0; i < modelData.size(); i++ )
 	{
-		auto mesh = meshManager->getMesh(d.meshData.name);
-		if (mesh == nullptr)
-			mesh = meshManager->addMesh(d.meshData.name, d.meshData.vertices, d.meshData.normals, d.meshData.textureCoordinates, d.meshData.colors, d.meshData.bones, d.boneData);
-		
-		meshes.push_back( mesh );
-		
-		
-		if ( !d.textureData.filename.empty() )
-		{
-			auto texture = textureManager->getTexture2D(d.textureData.filename);
-			if (texture == nullptr)
-				texture = textureManager->addTexture2D(d.textureData.filename, d.textureData.filename, d.textureData.settings);
-			
-			textures.push_back( texture );
-		}
-		else
-		{
-			textures.push_back( nullptr );
-		}
-
-
-		auto material = materialManager->getMaterial(d.materialData.name);
-		if (material == nullptr)
-			material = materialManager->addMaterial(d.materialData.name, d.materialData.ambient, d.materialData.diffuse, d.materialData.specular, d.materialData.emission, d.materialData.shininess, d.materialData.strength);
-		
-		materials.push_back( material );
+		generateResources( modelData[i], nullptr, meshes[i], textures[i], materials[i] );
 	}
 	
+	return generateModel( name, std::move(meshes), std::move(textures), std::move(materials), animationSet, idManager );
+}
+
+std::unique_ptr<Model> ModelLoader::generateModel(const std::string& name, std::vector<glw::IMesh*> meshes, std::vector<glw::ITexture*> textures, std::vector<glw::IMaterial*> materials, const AnimationSet& animationSet, IdManager& idManager)
+{
+	auto animationManager = openGlDevice_->getAnimationManager();
+	
+	auto animations = std::vector<glw::IAnimation*>();
+	
 	// Create bone structure (tree structure)
 	auto rootBoneNode = animationSet.rootBoneNode;
 	
@@ -240,11 +270,73 @@ std::unique_ptr<Model> ModelLoader::generateModel(const std::string& name, const
 		//std::cout << "anim: " << animation->getName() << std::endl;
 	}
 	
-	std::unique_ptr<Model> model = std::unique_ptr<Model>( new Model(idManager.createId(), name, meshes, textures, materials, animations, rootBoneNode, globalInverseTransformation, openGlDevice_) );
+	std::unique_ptr<Model> model = std::unique_ptr<Model>( new Model(idManager.createId(), name, std::move(meshes), std::move(textures), std::move(materials), animations, rootBoneNode, globalInverseTransformation, openGlDevice_) );
 	
 	return std::move(model);
 }
 
+void ModelLoader::generateResources(const ModelData& modelData, utilities::Image* image, glw::IMesh*& mesh, glw::ITexture*& texture, glw::IMaterial*& material)
+{
+	auto meshManager = openGlDevice_->getMeshManager();
+	auto materialManager = openGlDevice_->getMaterialManager();
+	auto textureManager = openGlDevice_->getTextureManager();
+	
+	const auto& d = modelData;
+	
+	mesh = meshManager->getMesh(d.meshData.name);
+	if (mesh == nullptr)
+	{
+		mesh = meshManager->addMesh(d.meshData.name, d.meshData.vertices, d.meshData.normals, d.meshData.textureCoordinates, d.meshData.colors, d.meshData.bones, d.boneData, d.meshData.vertexFormat, false);
+		mesh->setIndices( d.meshData.indices );
+		mesh->loadLocalData();
+		mesh->allocateVideoMemory();
+		mesh->pushToVideoMemory();
+	}
+	
+	
+	texture = nullptr;
+	if ( !d.textureData.filename.empty() )
+	{
+		texture = textureManager->getTexture2D(d.textureData.filename);
+		if (texture == nullptr)
+		{
+			if (image != nullptr)
+				texture = textureManager->addTexture2D(d.textureData.filename, image, d.textureData.settings);
+			else
+				texture = textureManager->addTexture2D(d.textureData.filename, d.textureData.filename, d.textureData.settings);
+		}
+	}
+	
+	
+	material = materialManager->getMaterial(d.materialData.name);
+	if (material == nullptr)
+		material = materialManager->addMaterial(d.materialData.name, d.materialData.ambient, d.materialData.diffuse, d.materialData.specular, d.materialData.emission, d.materialData.shininess, d.materialData.strength);
+}
+
+std::unique_ptr<utilities::Image> ModelLoader::loadImage(const TextureData& textureData)
+{
+	if ( textureData.filename.empty() )
+	{
+		return std::unique_ptr<utilities::Image>();
+	}
+	
+	const std::string& basepath = openGlDevice_->getOpenGlDeviceSettings().defaultTextureDir;
+	
+	LOG_DEBUG( "Loading texture image '" << textureData.filename << "'." );
+	
+	utilities::ImageLoader il = utilities::ImageLoader();
+	auto image = il.loadImageData(basepath + textureData.filename);
+	
+	if ( image.get() == nullptr )
+	{
+		std::string msg = std::string( "Unable to load texture: " + textureData.filename );
+		LOG_ERROR( msg );
+		throw exception::Exception( msg );
+	}
+	
+	return image;
+}
+
 MeshData ModelLoader::loadMesh(const std::string& name, const std::string& filename, glmd::uint32 index, const aiMesh* mesh, std::map< std::string, glmd::uint32 >& boneIndexMap)
 {
 	MeshData data = MeshData();
@@ -259,10 +351,38 @@ MeshData ModelLoader::loadMesh(const std::string& name, const std::string& filen
 	LOG_DEBUG( "mesh name: " << data.name );
 
 	// Load vertices, normals, texture coordinates, and colors
-	glm::detail::uint32 currentIndex = 0;
+	data.vertices.resize( mesh->mNumVertices );
+	data.normals.resize( mesh->mNumVertices );
+	data.textureCoordinates.resize( mesh->mNumVertices );
+	data.colors.resize( mesh->mNumVertices );
 	
-	std::vector< glmd::uint32 > vertexIndexMap = std::vector< glmd::uint32 >();
-	vertexIndexMap.resize( mesh->mNumVertices );
+	for ( glmd::uint32 i = 0; i < mesh->mNumVertices; i++ )
+	{
+		data.vertices[i] = glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+		
+		if ( mesh->mNormals != 0 )
+		{
+			data.normals[i] = glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z);
+		}
+		
+		if ( mesh->HasTextureCoords(0))
+		{
+			data.textureCoordinates[i] = glm::vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
+		}
+		
+		if ( mesh->mColors[0] != 0 )
+		{
+			data.colors[i] = glm::vec4(
+				(float)mesh->mColors[0][i].a,
+				(float)mesh->mColors[0][i].b,
+				(float)mesh->mColors[0][i].g,
+				(float)mesh->mColors[0][i].r
+				);
+		}
+	}
+	
+	// Load the faces into the index list
+	data.indices.reserve( mesh->mNumFaces * 3 );
 	
 	std::string msg = std::string();
 
@@ -296,52 +416,12 @@ MeshData ModelLoader::loadMesh(const std::string& name, const std::string& filen
 				throw exception::Exception(msg);
 		}
 
-		glm::detail::uint32 numIndices = face->mNumIndices;
-
-		data.vertices.resize(currentIndex + numIndices);
-		data.normals.resize(currentIndex + numIndices);
-		data.textureCoordinates.resize(currentIndex + numIndices);
-		data.colors.resize(currentIndex + numIndices);
-		
-		
-
-		// go through all vertices in face
-		for ( glmd::uint32 i = 0; i < numIndices; i++ )
+		for ( glmd::uint32 i = 0; i < face->mNumIndices; i++ )
 		{
-			// get group index for current index i
-			int vertexIndex = face->mIndices[i];
-
-			vertexIndexMap[ vertexIndex ] = currentIndex + i;
-
-			if ( mesh->mNormals != 0 )
-			{
-				data.vertices[currentIndex + i] = glm::vec3(mesh->mVertices[vertexIndex].x, mesh->mVertices[vertexIndex].y, mesh->mVertices[vertexIndex].z);
-				data.normals[currentIndex + i] = glm::vec3(mesh->mNormals[vertexIndex].x, mesh->mNormals[vertexIndex].y, mesh->mNormals[vertexIndex].z);
-			}
-
-			if ( mesh->HasTextureCoords(0))
-			{
-				data.textureCoordinates[currentIndex + i] = glm::vec2(mesh->mTextureCoords[0][vertexIndex].x, mesh->mTextureCoords[0][vertexIndex].y);
-			}
-
-			if ( mesh->mColors[0] != 0 )
-			{
-				data.colors[currentIndex + i] = glm::vec4(
-					(float)mesh->mColors[0][vertexIndex].a,
-					(float)mesh->mColors[0][vertexIndex].b,
-					(float)mesh->mColors[0][vertexIndex].g,
-					(float)mesh->mColors[0][vertexIndex].r
-					);
-			}
+			data.indices.push_back( face->mIndices[i] );
 		}
-
-		currentIndex += 3;
 	}
 	
-	
-	
-	int temp = 0;
-	
 	// If we have any bones, load them
 	if (mesh->mNumBones > 0)
 	{
@@ -354,16 +434,25 @@ MeshData ModelLoader::loadMesh(const std::string& name, const std::string& filen
 			
 			for (glmd::uint32 j = 0; j < mesh->mBones[i]->mNumWeights; j++)
 			{
-				glmd::uint32 vertexID = vertexIndexMap[ mesh->mBones[i]->mWeights[j].mVertexId ];
+				glmd::uint32 vertexID = mesh->mBones[i]->mWeights[j].mVertexId;
 				glmd::float32 weight = mesh->mBones[i]->mWeights[j].mWeight;
 
-				temp++;
 				data.bones[ vertexID ].addBoneWeight( boneIndex, weight );
 			}
 		}
 	}
 	
-	//std::cout << "Load results: " << mesh->mNumVertices << " " << mesh->mNumBones << " " << temp << " " << data.bones.size() << std::endl;
+	// Merge identical vertices, and reorder the triangles and vertices for the vertex cache
+	const glmd::uint32 numberOfImportedVertices = data.vertices.size();
+	optimizeMesh(data);
+	
+	LOG_DEBUG( "mesh '" << data.name << "': " << numberOfImportedVertices << " vertices welded to " << data.vertices.size() << ", " << (data.indices.size() / 3) << " triangles." );
+	
+	// Imported meshes use the packed vertex layout, as long as every bone id fits in a byte (meshes without bones get no bone attributes)
+	if (boneIndexMap.size() <= 256)
+		data.vertexFormat = glw::createPackedVertexFormat( !data.bones.empty() );
+	else
+		LOG_DEBUG( "mesh '" << data.name << "' references " << boneIndexMap.size() << " bones - using the default vertex format." );
 
 	LOG_DEBUG( "done loading mesh '" << filename << "'." );
 	
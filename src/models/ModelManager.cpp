@@ -1,4 +1,7 @@
 #include <utility>
+#include <set>
+#include <chrono>
+#include <exception>
 
 #include "Configure.hpp"
 
@@ -9,6 +12,7 @@
 #include "models/ModelManager.hpp"
 #include "models/ModelLoader.hpp"
 #include "glw/IOpenGlDevice.hpp"
+#include "glw/ITextureManager.hpp"
 #include "models/IModel.hpp"
 #include "models/Model.hpp"
 
@@ -19,14 +23,14 @@ namespace glr
 namespace models
 {
 
-ModelManager::ModelManager()
+ModelManager::ModelManager() : numberOfAsyncLoadsStarted_(0)
 {
 	openGlDevice_ = nullptr;
 }
 
-ModelManager::ModelManager(glw::IOpenGlDevice* openGlDevice) : openGlDevice_(openGlDevice)
+ModelManager::ModelManager(glw::IOpenGlDevice* openGlDevice, glm::detail::uint32 numberOfLoaderThreads) : openGlDevice_(openGlDevice), numberOfAsyncLoadsStarted_(0)
 {
-	modelLoader_ = std::unique_ptr<ModelLoader>( new ModelLoader(openGlDevice_) );
+	modelLoader_ = std::unique_ptr<ModelLoader>( new ModelLoader(openGlDevice_, openGlDevice_->getOpenGlDeviceSettings().modelCacheDir) );
 	
 	models_ = std::vector< std::unique_ptr<Model> >();
 	modelInstances_ = std::vector< std::unique_ptr<IModel> >();
@@ -39,10 +43,15 @@ ModelManager::ModelManager(glw::IOpenGlDevice* openGlDevice) : openGlDevice_(ope
 	//stream = aiGetPredefinedLogStream(aiDefaultLogStream_FILE,"assimp_log.txt");
 	stream = aiGetPredefinedLogStream(aiDefaultLogStream_STDOUT, nullptr);
 	aiAttachLogStream(&stream);
+	
+	threadPool_ = std::unique_ptr<ThreadPool>( new ThreadPool(numberOfLoaderThreads) );
 }
 
 ModelManager::~ModelManager()
 {
+	// Make sure no worker threads are still loading models
+	threadPool_.reset();
+	
 	// We added a log stream to the library, it's our job to disable it
 	// again. This will definitely release the last resources allocated
 	// by Assimp.
@@ -127,6 +136,198 @@ void ModelManager::loadModel(const std::string& name, const std::string& filenam
 	LOG_DEBUG( "Done loading model '" + filename + "'." );
 }
 
+std::shared_future<IModel*> ModelManager::loadModelAsync(const std::string& name, const std::string& filename)
+{
+	std::lock_guard<std::recursive_mutex> lock(accessMutex_);
+	
+	LOG_DEBUG( "Loading model '" + filename + "' asynchronously." );
+	
+	auto it = asyncLoads_.find(name);
+	
+	if ( it != asyncLoads_.end() )
+	{
+		LOG_DEBUG( "Model is already being loaded." );
+		return it->second->future;
+	}
+	
+	auto model = getModel(name);
+	
+	if ( model != nullptr )
+	{
+		LOG_DEBUG( "Model found...No need to load." );
+		
+		auto promise = std::promise<IModel*>();
+		promise.set_value( model );
+		
+		return promise.get_future().share();
+	}
+	
+	auto load = std::make_shared<AsyncLoad>();
+	load->name = name;
+	load->filename = filename;
+	load->future = load->promise.get_future().share();
+	
+	// The template renders a copy of the placeholder until the load completes
+	auto placeholder = ( placeholderModelName_.empty() ? nullptr : getModel(placeholderModelName_) );
+	
+	if ( placeholder != nullptr )
+	{
+		models_.push_back( std::unique_ptr< Model >( new Model(idManager_.createId(), name, *placeholder) ) );
+	}
+	else
+	{
+		models_.push_back( std::unique_ptr< Model >( new Model(idManager_.createId(), name, openGlDevice_) ) );
+	}
+	
+	load->templateId = models_.back()->getId();
+	asyncLoads_[name] = load;
+	
+	// Loads are started in the order they were requested
+	const auto priority = (glm::detail::float32) numberOfAsyncLoadsStarted_++;
+	threadPool_->enqueue( 0, priority, [=] { this->loadModelData( load ); } );
+	
+	return load->future;
+}
+
+void ModelManager::loadModelData(std::shared_ptr<AsyncLoad> load)
+{
+	try
+	{
+		auto data = modelLoader_->loadModelData( load->name, load->filename );
+		load->modelData = std::move(data.first);
+		load->animationSet = std::move(data.second);
+		
+		// Decode each texture once - textures that already exist, or that are shared with an earlier mesh, are found by name when the
+		// mesh is created
+		auto textureManager = openGlDevice_->getTextureManager();
+		auto decoded = std::set<std::string>();
+		
+		load->images.resize( load->modelData.size() );
+		
+		for ( glm::detail::uint32 i = 0; i < load->modelData.size(); i++ )
+		{
+			const auto& textureData = load->modelData[i].textureData;
+			
+			if ( textureData.filename.empty() || textureManager->getTexture2D(textureData.filename) != nullptr || !decoded.insert(textureData.filename).second )
+			{
+				continue;
+			}
+			
+			load->images[i] = modelLoader_->loadImage( textureData );
+		}
+	}
+	catch (...)
+	{
+		failAsyncLoad( load );
+		return;
+	}
+	
+	openGlWork_.push( [=] { this->generateModel( load ); } );
+}
+
+void ModelManager::generateModel(std::shared_ptr<AsyncLoad> load)
+{
+	try
+	{
+		const glm::detail::uint32 i = load->meshes.size();
+		
+		// Create one mesh per step, so that update() can spread a large model over several frames
+		if ( i < load->modelData.size() )
+		{
+			glw::IMesh* mesh = nullptr;
+			glw::ITexture* texture = nullptr;
+			glw::IMaterial* material = nullptr;
+			
+			modelLoader_->generateResources( load->modelData[i], load->images[i].get(), mesh, texture, material );
+			
+			load->meshes.push_back( mesh );
+			load->textures.push_back( texture );
+			load->materials.push_back( material );
+			
+			// The decoded image is in video memory now
+			load->images[i].reset();
+			
+			openGlWork_.push( [=] { this->generateModel( load ); } );
+			return;
+		}
+		
+		std::lock_guard<std::recursive_mutex> lock(accessMutex_);
+		
+		// The resources are owned by the managers, so the loaded model is only needed until the template and instances have copied them
+		auto model = modelLoader_->generateModel( load->name, load->meshes, load->textures, load->materials, load->animationSet, idManager_ );
+		
+		auto modelTemplate = getModel( load->templateId );
+		
+		if ( modelTemplate != nullptr )
+		{
+			modelTemplate->replaceResources( *model );
+		}
+		
+		for ( auto id : load->instanceIds )
+		{
+			auto instance = dynamic_cast<Model*>( getInstance(id) );
+			
+			if ( instance != nullptr )
+			{
+				instance->replaceResources( *model );
+			}
+		}
+		
+		asyncLoads_.erase( load->name );
+		load->promise.set_value( modelTemplate );
+		
+		LOG_DEBUG( "Done loading model '" + load->filename + "' asynchronously." );
+	}
+	catch (...)
+	{
+		failAsyncLoad( load );
+	}
+}
+
+void ModelManager::failAsyncLoad(std::shared_ptr<AsyncLoad> load)
+{
+	std::lock_guard<std::recursive_mutex> lock(accessMutex_);
+	
+	LOG_ERROR( "Unable to load model '" + load->filename + "' asynchronously." );
+	
+	// The template (and its instances) keep rendering the placeholder
+	asyncLoads_.erase( load->name );
+	load->promise.set_exception( std::current_exception() );
+}
+
+void ModelManager::setPlaceholderModel(const std::string& name)
+{
+	std::lock_guard<std::recursive_mutex> lock(accessMutex_);
+	
+	placeholderModelName_ = name;
+}
+
+void ModelManager::update(glm::detail::float32 timeBudget)
+{
+	const auto start = std::chrono::steady_clock::now();
+	const auto budget = std::chrono::duration<glm::detail::float32, std::milli>( timeBudget );
+	
+	auto work = std::function<void()>();
+	
+	// Work posted while we are running (i.e. the next mesh of a model) is done in this call too, if there is time left
+	while ( openGlWork_.pop(work) )
+	{
+		work();
+		
+		if ( std::chrono::steady_clock::now() - start >= budget )
+		{
+			break;
+		}
+	}
+}
+
+glm::detail::uint32 ModelManager::getNumberOfModelsLoading() const
+{
+	std::lock_guard<std::recursive_mutex> lock(accessMutex_);
+	
+	return asyncLoads_.size();
+}
+
 void ModelManager::destroyModelTemplate(Id id)
 {
 }
@@ -155,6 +356,14 @@ IModel* ModelManager::createInstance(const std::string& name)
 		// Create a COPY of the model template
 		modelInstances_.push_back( std::unique_ptr<IModel>( new Model(idManager_.createId(), std::move(newName), *model) ) );
 		
+		// Instances of a model that is still loading are given the loaded model when the load completes
+		auto it = asyncLoads_.find(name);
+		
+		if ( it != asyncLoads_.end() )
+		{
+			it->second->instanceIds.push_back( modelInstances_.back()->getId() );
+		}
+		
 		return modelInstances_.back().get();
 	}
 
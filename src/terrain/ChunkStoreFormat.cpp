@@ -0,0 +1,108 @@
+#include <cstring>
+
+#ifdef USE_LZ4
+#include <lz4.h>
+#endif
+
+#include "terrain/ChunkStoreFormat.hpp"
+
+namespace glr
+{
+namespace terrain
+{
+namespace chunk_store
+{
+
+glmd::uint32 calculateChecksum(const glmd::uint8* data, glmd::uint32 size)
+{
+	glmd::uint32 hash = 2166136261u;
+
+	for (glmd::uint32 i=0; i < size; i++)
+	{
+		hash ^= data[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+bool isCompressionSupported(ChunkCompression compression)
+{
+	switch (compression)
+	{
+		case CHUNK_COMPRESSION_NONE:
+			return true;
+
+		case CHUNK_COMPRESSION_LZ4:
+#ifdef USE_LZ4
+			return true;
+#else
+			return false;
+#endif
+
+		default:
+			return false;
+	}
+}
+
+ChunkCompression compress(ChunkCompression compression, const std::vector<glmd::uint8>& data, std::vector<glmd::uint8>& stored)
+{
+#ifdef USE_LZ4
+	if (compression == CHUNK_COMPRESSION_LZ4 && !data.empty())
+	{
+		stored.resize( LZ4_compressBound((int)data.size()) );
+
+		const int storedSize = LZ4_compress_default((const char*)&data[0], (char*)&stored[0], (int)data.size(), (int)stored.size());
+
+		if (storedSize > 0 && (glmd::uint32)storedSize < data.size())
+		{
+			stored.resize(storedSize);
+			return CHUNK_COMPRESSION_LZ4;
+		}
+	}
+#endif
+
+	stored = data;
+
+	return CHUNK_COMPRESSION_NONE;
+}
+
+bool decompress(ChunkCompression compression, const glmd::uint8* stored, glmd::uint32 storedSize, std::vector<glmd::uint8>& data)
+{
+	switch (compression)
+	{
+		case CHUNK_COMPRESSION_NONE:
+			if (storedSize != data.size())
+			{
+				return false;
+			}
+
+			if (storedSize > 0)
+			{
+				std::memcpy(&data[0], stored, storedSize);
+			}
+
+			return true;
+
+#ifdef USE_LZ4
+		case CHUNK_COMPRESSION_LZ4:
+		{
+			if (data.empty())
+			{
+				return (storedSize == 0);
+			}
+
+			const int size = LZ4_decompress_safe((const char*)stored, (char*)&data[0], (int)storedSize, (int)data.size());
+
+			return (size >= 0 && (glmd::uint32)size == data.size());
+		}
+#endif
+
+		default:
+			return false;
+	}
+}
+
+}
+}
+}
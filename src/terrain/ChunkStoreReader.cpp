@@ -0,0 +1,373 @@
+#include <cstring>
+#include <sstream>
+
+#include "terrain/ChunkStoreReader.hpp"
+#include "terrain/DensityGrid.hpp"
+
+#include "exceptions/IoException.hpp"
+#include "exceptions/FormatException.hpp"
+
+#include "common/logger/Logger.hpp"
+
+namespace glr
+{
+namespace terrain
+{
+
+/** Anonymous helper functions. */
+namespace
+{
+
+// No real density grid is anywhere near this big - and with a dimension this small, the size of the grid can't overflow
+const glmd::uint64 MAX_DENSITY_GRID_DIMENSION = 1 << 20;
+
+/**
+ * Calculates the size of the (uncompressed) payload described by the counts of header - the header isn't covered by the checksum, so
+ * this is checked before the payload is allocated.
+ *
+ * @return False if the counts are invalid.
+ */
+bool calculatePayloadSize(const ChunkHeader& header, glmd::uint64& size)
+{
+	if (header.payloadType == CHUNK_PAYLOAD_MESH)
+	{
+		size = (glmd::uint64)header.counts[0] * sizeof(glm::vec3) + (glmd::uint64)header.counts[1] * sizeof(glm::vec3)
+			+ (glmd::uint64)header.counts[2] * sizeof(glm::vec4) + (glmd::uint64)header.counts[3] * sizeof(glmd::uint32);
+
+		return true;
+	}
+
+	// The counts are the size and borders of the grid
+	const glmd::uint64 dimension = (glmd::uint64)header.counts[0] + header.counts[1] + header.counts[2];
+
+	if (dimension > MAX_DENSITY_GRID_DIMENSION)
+	{
+		return false;
+	}
+
+	size = dimension * dimension * dimension * sizeof(glmd::float32);
+
+	return true;
+}
+
+}
+
+ChunkStoreReader::ChunkStoreReader(const std::string& filename)
+	: filename_(filename), file_(filename), data_(file_.getData()), size_(file_.getSize()), endOfChunks_(0), isIndexRebuilt_(false)
+{
+	ChunkStoreFileHeader fileHeader = ChunkStoreFileHeader();
+
+	if (size_ >= sizeof(ChunkStoreFileHeader))
+	{
+		std::memcpy(&fileHeader, data_, sizeof(ChunkStoreFileHeader));
+	}
+
+	if (fileHeader.magic != chunk_store::FILE_MAGIC || fileHeader.version != chunk_store::VERSION)
+	{
+		const std::string message = std::string("File is not a chunk store (or is an unsupported version): ") + filename_;
+		LOG_ERROR(message);
+		throw exception::FormatException(message);
+	}
+
+	if (!readIndex())
+	{
+		rebuildIndex();
+	}
+
+	LOG_DEBUG( "Opened chunk store '" << filename_ << "' with " << index_[CHUNK_PAYLOAD_MESH].size() << " meshes and " << index_[CHUNK_PAYLOAD_DENSITY].size() << " density fields." );
+}
+
+ChunkStoreReader::~ChunkStoreReader()
+{
+}
+
+bool ChunkStoreReader::readIndex()
+{
+	if (size_ < sizeof(ChunkStoreFileHeader) + sizeof(ChunkStoreTrailer))
+	{
+		return false;
+	}
+
+	ChunkStoreTrailer trailer = ChunkStoreTrailer();
+	std::memcpy(&trailer, data_ + size_ - sizeof(ChunkStoreTrailer), sizeof(ChunkStoreTrailer));
+
+	// Nothing is added to the (untrusted) offsets and counts of the trailer, so a corrupt trailer can't overflow past these checks
+	if (trailer.magic != chunk_store::INDEX_MAGIC || trailer.indexOffset < sizeof(ChunkStoreFileHeader) || trailer.indexOffset > size_ - sizeof(ChunkStoreTrailer))
+	{
+		return false;
+	}
+
+	const glmd::uint64 indexSize = size_ - sizeof(ChunkStoreTrailer) - trailer.indexOffset;
+
+	if (trailer.numberOfEntries != indexSize / sizeof(ChunkStoreIndexEntry) || indexSize % sizeof(ChunkStoreIndexEntry) != 0)
+	{
+		return false;
+	}
+
+	for (glmd::uint32 i=0; i < trailer.numberOfEntries; i++)
+	{
+		ChunkStoreIndexEntry entry = ChunkStoreIndexEntry();
+		std::memcpy(&entry, data_ + trailer.indexOffset + (glmd::uint64)i * sizeof(ChunkStoreIndexEntry), sizeof(ChunkStoreIndexEntry));
+
+		if (entry.payloadType >= CHUNK_PAYLOAD_COUNT || trailer.indexOffset < sizeof(ChunkHeader) || entry.offset > trailer.indexOffset - sizeof(ChunkHeader))
+		{
+			for ( auto& index : index_ )
+			{
+				index.clear();
+			}
+
+			return false;
+		}
+
+		index_[entry.payloadType][ glm::ivec3(entry.gridX, entry.gridY, entry.gridZ) ] = entry.offset;
+	}
+
+	endOfChunks_ = trailer.indexOffset;
+
+	return true;
+}
+
+void ChunkStoreReader::rebuildIndex()
+{
+	LOG_WARN( "Chunk store '" << filename_ << "' has no valid index - rebuilding it from the chunk headers." );
+
+	isIndexRebuilt_ = true;
+
+	glmd::uint64 offset = sizeof(ChunkStoreFileHeader);
+
+	while (offset + sizeof(ChunkHeader) <= size_)
+	{
+		ChunkHeader header = ChunkHeader();
+		std::memcpy(&header, data_ + offset, sizeof(ChunkHeader));
+
+		const glmd::uint64 end = offset + sizeof(ChunkHeader) + header.storedSize;
+
+		// Either we've reached the (old) index, or the last chunk was only partially written
+		if (header.magic != chunk_store::CHUNK_MAGIC || end > size_)
+		{
+			break;
+		}
+
+		// Later records replace earlier records for the same chunk
+		if (header.payloadType < CHUNK_PAYLOAD_COUNT)
+		{
+			index_[header.payloadType][ glm::ivec3(header.gridX, header.gridY, header.gridZ) ] = offset;
+		}
+
+		offset = end;
+	}
+
+	endOfChunks_ = offset;
+}
+
+bool ChunkStoreReader::hasChunk(const glm::ivec3& coordinates, ChunkPayloadType payloadType) const
+{
+	return (index_[payloadType].find(coordinates) != index_[payloadType].end());
+}
+
+std::vector<glm::ivec3> ChunkStoreReader::getChunkCoordinates(ChunkPayloadType payloadType) const
+{
+	auto coordinates = std::vector<glm::ivec3>();
+	coordinates.reserve( index_[payloadType].size() );
+
+	for ( auto& it : index_[payloadType] )
+	{
+		coordinates.push_back( it.first );
+	}
+
+	return coordinates;
+}
+
+bool ChunkStoreReader::readHeader(const glm::ivec3& coordinates, ChunkPayloadType payloadType, ChunkHeader& header) const
+{
+	auto it = index_[payloadType].find(coordinates);
+
+	if (it == index_[payloadType].end())
+	{
+		return false;
+	}
+
+	// The offset was checked against the file size when the index was loaded
+	std::memcpy(&header, data_ + it->second, sizeof(ChunkHeader));
+
+	return true;
+}
+
+bool ChunkStoreReader::readPayload(const glm::ivec3& coordinates, ChunkPayloadType payloadType, ChunkHeader& header, std::vector<glmd::uint8>& payload) const
+{
+	auto it = index_[payloadType].find(coordinates);
+
+	if (it == index_[payloadType].end())
+	{
+		return false;
+	}
+
+	const glmd::uint64 offset = it->second;
+	std::memcpy(&header, data_ + offset, sizeof(ChunkHeader));
+
+	std::string error;
+	glmd::uint64 expectedSize = 0;
+
+	if (header.magic != chunk_store::CHUNK_MAGIC || header.payloadType != (glmd::uint32)payloadType || glm::ivec3(header.gridX, header.gridY, header.gridZ) != coordinates)
+	{
+		error = "index points at the wrong chunk";
+	}
+	else if (header.storedSize > size_ - offset - sizeof(ChunkHeader))
+	{
+		error = "chunk extends past the end of the file";
+	}
+	else if (!chunk_store::isCompressionSupported((ChunkCompression)header.compression))
+	{
+		error = "chunk is compressed using a method this build doesn't support";
+	}
+	else if (!calculatePayloadSize(header, expectedSize) || expectedSize != header.uncompressedSize)
+	{
+		error = "payload size doesn't match the header";
+	}
+	else
+	{
+		payload.resize(header.uncompressedSize);
+
+		if (!chunk_store::decompress((ChunkCompression)header.compression, data_ + offset + sizeof(ChunkHeader), header.storedSize, payload))
+		{
+			error = "unable to decompress chunk";
+		}
+		else if (header.uncompressedSize > 0 && chunk_store::calculateChecksum(&payload[0], header.uncompressedSize) != header.checksum)
+		{
+			error = "checksum mismatch";
+		}
+	}
+
+	if (!error.empty())
+	{
+		std::stringstream ss;
+		ss << "Corrupt chunk (" << coordinates.x << ", " << coordinates.y << ", " << coordinates.z << ") in chunk store '" << filename_ << "': " << error;
+		LOG_ERROR(ss.str());
+		throw exception::FormatException(ss.str());
+	}
+
+	return true;
+}
+
+bool ChunkStoreReader::readMesh(const glm::ivec3& coordinates, ChunkMeshData& mesh, LevelOfDetail* levelOfDetail) const
+{
+	ChunkHeader header = ChunkHeader();
+	auto payload = std::vector<glmd::uint8>();
+
+	if (!readPayload(coordinates, CHUNK_PAYLOAD_MESH, header, payload))
+	{
+		return false;
+	}
+
+	// readPayload has checked the payload size against the counts - but every vertex needs a normal and texture blending values
+	if (header.counts[1] != header.counts[0] || header.counts[2] != header.counts[0])
+	{
+		const std::string message = std::string("Corrupt mesh in chunk store '") + filename_ + std::string("': vertex attribute counts don't match.");
+		LOG_ERROR(message);
+		throw exception::FormatException(message);
+	}
+
+	const glmd::uint8* data = payload.empty() ? nullptr : &payload[0];
+
+	mesh.vertices.resize(header.counts[0]);
+	mesh.normals.resize(header.counts[1]);
+	mesh.textureBlendingValues.resize(header.counts[2]);
+	mesh.indices.resize(header.counts[3]);
+
+	if (!mesh.vertices.empty())
+	{
+		std::memcpy(&mesh.vertices[0], data, mesh.vertices.size() * sizeof(glm::vec3));
+		data += mesh.vertices.size() * sizeof(glm::vec3);
+	}
+
+	if (!mesh.normals.empty())
+	{
+		std::memcpy(&mesh.normals[0], data, mesh.normals.size() * sizeof(glm::vec3));
+		data += mesh.normals.size() * sizeof(glm::vec3);
+	}
+
+	if (!mesh.textureBlendingValues.empty())
+	{
+		std::memcpy(&mesh.textureBlendingValues[0], data, mesh.textureBlendingValues.size() * sizeof(glm::vec4));
+		data += mesh.textureBlendingValues.size() * sizeof(glm::vec4);
+	}
+
+	if (!mesh.indices.empty())
+	{
+		std::memcpy(&mesh.indices[0], data, mesh.indices.size() * sizeof(glmd::uint32));
+	}
+
+	// Out of range indices would be uploaded to the GPU as is
+	for ( auto index : mesh.indices )
+	{
+		if (index >= mesh.vertices.size())
+		{
+			const std::string message = std::string("Corrupt mesh in chunk store '") + filename_ + std::string("': index out of range.");
+			LOG_ERROR(message);
+			throw exception::FormatException(message);
+		}
+	}
+
+	if (levelOfDetail != nullptr)
+	{
+		*levelOfDetail = (LevelOfDetail)(glmd::int32)header.levelOfDetail;
+	}
+
+	return true;
+}
+
+bool ChunkStoreReader::readDensity(const glm::ivec3& coordinates, DensityGrid& densities) const
+{
+	ChunkHeader header = ChunkHeader();
+	auto payload = std::vector<glmd::uint8>();
+
+	if (!readPayload(coordinates, CHUNK_PAYLOAD_DENSITY, header, payload))
+	{
+		return false;
+	}
+
+	// readPayload has checked the size and borders of the grid against the payload
+	densities.resize((glmd::int32)header.counts[0], (glmd::int32)header.counts[1], (glmd::int32)header.counts[2]);
+
+	if (!payload.empty())
+	{
+		std::memcpy(densities.getData(), &payload[0], payload.size());
+	}
+
+	return true;
+}
+
+std::vector<ChunkStoreIndexEntry> ChunkStoreReader::getIndexEntries() const
+{
+	auto entries = std::vector<ChunkStoreIndexEntry>();
+
+	for (glmd::uint32 payloadType=0; payloadType < CHUNK_PAYLOAD_COUNT; payloadType++)
+	{
+		for ( auto& it : index_[payloadType] )
+		{
+			ChunkStoreIndexEntry entry = ChunkStoreIndexEntry();
+			entry.gridX = it.first.x;
+			entry.gridY = it.first.y;
+			entry.gridZ = it.first.z;
+			entry.payloadType = payloadType;
+			entry.offset = it.second;
+
+			entries.push_back( entry );
+		}
+	}
+
+	return entries;
+}
+
+glmd::uint64 ChunkStoreReader::getEndOfChunks() const
+{
+	return endOfChunks_;
+}
+
+bool ChunkStoreReader::isIndexRebuilt() const
+{
+	return isIndexRebuilt_;
+}
+
+}
+}
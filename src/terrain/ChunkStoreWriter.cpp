@@ -0,0 +1,262 @@
+#include <cstring>
+
+#include "Configure.hpp"
+
+#ifdef OS_WINDOWS
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "terrain/ChunkStoreWriter.hpp"
+#include "terrain/ChunkStoreReader.hpp"
+#include "terrain/DensityGrid.hpp"
+
+#include "exceptions/IoException.hpp"
+
+#include "common/logger/Logger.hpp"
+
+namespace
+{
+
+/**
+ * Cuts the file off at the given size - used to remove anything left over after the index (i.e. a partially written chunk from a
+ * crash).
+ */
+bool truncateFile(const std::string& filename, glmd::uint64 size)
+{
+#ifdef OS_WINDOWS
+	int fd = -1;
+	if (_sopen_s(&fd, filename.c_str(), _O_RDWR | _O_BINARY, _SH_DENYNO, _S_IREAD | _S_IWRITE) != 0)
+	{
+		return false;
+	}
+
+	const bool success = (_chsize_s(fd, (__int64)size) == 0);
+	_close(fd);
+
+	return success;
+#else
+	return (::truncate(filename.c_str(), (off_t)size) == 0);
+#endif
+}
+
+template<typename T>
+void appendToPayload(std::vector<glmd::uint8>& payload, const std::vector<T>& values)
+{
+	if (values.empty())
+	{
+		return;
+	}
+
+	const glmd::uint64 offset = payload.size();
+	payload.resize(offset + values.size() * sizeof(T));
+
+	std::memcpy(&payload[offset], &values[0], values.size() * sizeof(T));
+}
+
+}
+
+namespace glr
+{
+namespace terrain
+{
+
+ChunkStoreWriter::ChunkStoreWriter(const std::string& filename, ChunkCompression compression, bool append)
+	: filename_(filename), compression_(compression), writeOffset_(0)
+{
+	if (!chunk_store::isCompressionSupported(compression_))
+	{
+		LOG_WARN( "Chunk store compression " << compression_ << " is not supported by this build - chunks will be stored uncompressed." );
+		compression_ = CHUNK_COMPRESSION_NONE;
+	}
+
+	const bool exists = std::ifstream(filename_, std::ios::in | std::ios::binary).good();
+
+	if (append && exists)
+	{
+		// Pick up the existing index - new chunks are written over the old index, and a new index is written when we are closed
+		{
+			ChunkStoreReader reader(filename_);
+
+			for ( auto& entry : reader.getIndexEntries() )
+			{
+				index_[entry.payloadType][ glm::ivec3(entry.gridX, entry.gridY, entry.gridZ) ] = entry.offset;
+			}
+
+			writeOffset_ = reader.getEndOfChunks();
+		}
+
+		stream_.open(filename_, std::ios::in | std::ios::out | std::ios::binary);
+	}
+	else
+	{
+		stream_.open(filename_, std::ios::out | std::ios::binary | std::ios::trunc);
+	}
+
+	if (!stream_.is_open())
+	{
+		const std::string message = std::string("Unable to open chunk store for writing: ") + filename_;
+		LOG_ERROR(message);
+		throw exception::IoException(message);
+	}
+
+	stream_.seekp(writeOffset_);
+
+	if (writeOffset_ == 0)
+	{
+		ChunkStoreFileHeader fileHeader = ChunkStoreFileHeader();
+		fileHeader.magic = chunk_store::FILE_MAGIC;
+		fileHeader.version = chunk_store::VERSION;
+
+		write(&fileHeader, sizeof(ChunkStoreFileHeader));
+	}
+}
+
+ChunkStoreWriter::~ChunkStoreWriter()
+{
+	try
+	{
+		close();
+	}
+	catch (const std::exception& e)
+	{
+		LOG_ERROR( "Unable to close chunk store '" << filename_ << "': " << e.what() );
+	}
+}
+
+void ChunkStoreWriter::writeMesh(const glm::ivec3& coordinates, LevelOfDetail levelOfDetail, const ChunkMeshData& mesh)
+{
+	payload_.clear();
+	appendToPayload(payload_, mesh.vertices);
+	appendToPayload(payload_, mesh.normals);
+	appendToPayload(payload_, mesh.textureBlendingValues);
+	appendToPayload(payload_, mesh.indices);
+
+	ChunkHeader header = ChunkHeader();
+	header.gridX = coordinates.x;
+	header.gridY = coordinates.y;
+	header.gridZ = coordinates.z;
+	header.payloadType = CHUNK_PAYLOAD_MESH;
+	header.levelOfDetail = (glmd::uint32)levelOfDetail;
+	header.counts[0] = (glmd::uint32)mesh.vertices.size();
+	header.counts[1] = (glmd::uint32)mesh.normals.size();
+	header.counts[2] = (glmd::uint32)mesh.textureBlendingValues.size();
+	header.counts[3] = (glmd::uint32)mesh.indices.size();
+
+	writeChunk(header);
+}
+
+void ChunkStoreWriter::writeDensity(const glm::ivec3& coordinates, const DensityGrid& densities)
+{
+	const glmd::uint32 size = densities.getNumberOfPoints() * sizeof(glmd::float32);
+
+	payload_.resize(size);
+
+	if (size > 0)
+	{
+		std::memcpy(&payload_[0], densities.getData(), size);
+	}
+
+	ChunkHeader header = ChunkHeader();
+	header.gridX = coordinates.x;
+	header.gridY = coordinates.y;
+	header.gridZ = coordinates.z;
+	header.payloadType = CHUNK_PAYLOAD_DENSITY;
+	header.levelOfDetail = (glmd::uint32)LOD_UNKNOWN;
+	header.counts[0] = (glmd::uint32)densities.getSize();
+	header.counts[1] = (glmd::uint32)densities.getBorderLow();
+	header.counts[2] = (glmd::uint32)densities.getBorderHigh();
+
+	writeChunk(header);
+}
+
+void ChunkStoreWriter::writeChunk(ChunkHeader& header)
+{
+	if (!stream_.is_open())
+	{
+		const std::string message = std::string("Unable to write chunk - chunk store is closed: ") + filename_;
+		LOG_ERROR(message);
+		throw exception::IoException(message);
+	}
+
+	header.magic = chunk_store::CHUNK_MAGIC;
+	header.compression = chunk_store::compress(compression_, payload_, stored_);
+	header.uncompressedSize = (glmd::uint32)payload_.size();
+	header.storedSize = (glmd::uint32)stored_.size();
+	header.checksum = payload_.empty() ? 0 : chunk_store::calculateChecksum(&payload_[0], (glmd::uint32)payload_.size());
+
+	const glmd::uint64 offset = writeOffset_;
+
+	write(&header, sizeof(ChunkHeader));
+
+	if (!stored_.empty())
+	{
+		write(&stored_[0], stored_.size());
+	}
+
+	index_[header.payloadType][ glm::ivec3(header.gridX, header.gridY, header.gridZ) ] = offset;
+}
+
+void ChunkStoreWriter::write(const void* data, glmd::uint64 size)
+{
+	stream_.write((const char*)data, size);
+
+	if (!stream_.good())
+	{
+		const std::string message = std::string("Unable to write to chunk store: ") + filename_;
+		LOG_ERROR(message);
+		throw exception::IoException(message);
+	}
+
+	writeOffset_ += size;
+}
+
+void ChunkStoreWriter::close()
+{
+	if (!stream_.is_open())
+	{
+		return;
+	}
+
+	ChunkStoreTrailer trailer = ChunkStoreTrailer();
+	trailer.indexOffset = writeOffset_;
+	trailer.numberOfEntries = 0;
+	trailer.magic = chunk_store::INDEX_MAGIC;
+
+	for (glmd::uint32 payloadType=0; payloadType < CHUNK_PAYLOAD_COUNT; payloadType++)
+	{
+		for ( auto& it : index_[payloadType] )
+		{
+			ChunkStoreIndexEntry entry = ChunkStoreIndexEntry();
+			entry.gridX = it.first.x;
+			entry.gridY = it.first.y;
+			entry.gridZ = it.first.z;
+			entry.payloadType = payloadType;
+			entry.offset = it.second;
+
+			write(&entry, sizeof(ChunkStoreIndexEntry));
+			trailer.numberOfEntries++;
+		}
+	}
+
+	write(&trailer, sizeof(ChunkStoreTrailer));
+
+	stream_.close();
+
+	// The trailer has to be the last thing in the file
+	if (!truncateFile(filename_, writeOffset_))
+	{
+		LOG_WARN( "Unable to truncate chunk store '" << filename_ << "' - its index will be rebuilt the next time it is opened." );
+	}
+}
+
+glmd::uint32 ChunkStoreWriter::getNumberOfChunks(ChunkPayloadType payloadType) const
+{
+	return (glmd::uint32)index_[payloadType].size();
+}
+
+}
+}
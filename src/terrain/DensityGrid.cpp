@@ -0,0 +1,206 @@
+#include <utility>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+#include "terrain/DensityGrid.hpp"
+
+#include "exceptions/InvalidArgumentException.hpp"
+
+#include "common/logger/Logger.hpp"
+
+namespace glr
+{
+namespace terrain
+{
+
+DensityGrid::DensityGrid() : size_(0), borderLow_(0), borderHigh_(0), dimension_(0), strideX_(0), strideY_(0), data_(nullptr)
+{
+}
+
+DensityGrid::DensityGrid(glmd::int32 size, glmd::int32 borderLow, glmd::int32 borderHigh)
+	: size_(0), borderLow_(0), borderHigh_(0), dimension_(0), strideX_(0), strideY_(0), data_(nullptr)
+{
+	resize(size, borderLow, borderHigh);
+}
+
+DensityGrid::DensityGrid(const DensityGrid& other)
+	: size_(0), borderLow_(0), borderHigh_(0), dimension_(0), strideX_(0), strideY_(0), data_(nullptr)
+{
+	*this = other;
+}
+
+DensityGrid::DensityGrid(DensityGrid&& other)
+	: size_(0), borderLow_(0), borderHigh_(0), dimension_(0), strideX_(0), strideY_(0), data_(nullptr)
+{
+	*this = std::move(other);
+}
+
+DensityGrid::~DensityGrid()
+{
+}
+
+DensityGrid& DensityGrid::operator=(const DensityGrid& other)
+{
+	if (this == &other)
+	{
+		return *this;
+	}
+
+	resize(other.size_, other.borderLow_, other.borderHigh_);
+
+	if (getNumberOfPoints() > 0)
+	{
+		std::memcpy(data_, other.data_, getNumberOfPoints() * sizeof(glmd::float32));
+	}
+
+	return *this;
+}
+
+DensityGrid& DensityGrid::operator=(DensityGrid&& other)
+{
+	if (this == &other)
+	{
+		return *this;
+	}
+
+	size_ = other.size_;
+	borderLow_ = other.borderLow_;
+	borderHigh_ = other.borderHigh_;
+	dimension_ = other.dimension_;
+	strideX_ = other.strideX_;
+	strideY_ = other.strideY_;
+	memory_ = std::move(other.memory_);
+	data_ = other.data_;
+
+	other.size_ = 0;
+	other.borderLow_ = 0;
+	other.borderHigh_ = 0;
+	other.dimension_ = 0;
+	other.strideX_ = 0;
+	other.strideY_ = 0;
+	other.data_ = nullptr;
+
+	return *this;
+}
+
+void DensityGrid::resize(glmd::int32 size, glmd::int32 borderLow, glmd::int32 borderHigh)
+{
+	if (size < 0 || borderLow < 0 || borderHigh < 0)
+	{
+		const std::string message = std::string("Invalid density grid dimensions - size and borders must not be negative.");
+		LOG_ERROR(message);
+		throw exception::InvalidArgumentException(message);
+	}
+
+	const glmd::int32 dimension = size + borderLow + borderHigh;
+
+	// Reuse our memory if the number of points doesn't change
+	const bool reuseMemory = (dimension == dimension_ && memory_.get() != nullptr);
+
+	size_ = size;
+	borderLow_ = borderLow;
+	borderHigh_ = borderHigh;
+	dimension_ = dimension;
+	strideY_ = dimension_;
+	strideX_ = dimension_ * dimension_;
+
+	if (!reuseMemory)
+	{
+		allocate();
+	}
+}
+
+void DensityGrid::allocate()
+{
+	memory_.reset();
+	data_ = nullptr;
+
+	const glmd::uint32 numberOfPoints = getNumberOfPoints();
+
+	if (numberOfPoints == 0)
+	{
+		return;
+	}
+
+	// Over allocate so that we can align the start of the data
+	memory_ = std::unique_ptr<glmd::uint8[]>( new glmd::uint8[numberOfPoints * sizeof(glmd::float32) + ALIGNMENT] );
+
+	std::uintptr_t address = reinterpret_cast<std::uintptr_t>( memory_.get() );
+	address = (address + (ALIGNMENT - 1)) & ~(std::uintptr_t)(ALIGNMENT - 1);
+
+	data_ = reinterpret_cast<glmd::float32*>( address );
+}
+
+void DensityGrid::fill(glmd::float32 value)
+{
+	std::fill(data_, data_ + getNumberOfPoints(), value);
+}
+
+bool DensityGrid::isEmpty() const
+{
+	return (data_ == nullptr);
+}
+
+glmd::int32 DensityGrid::getSize() const
+{
+	return size_;
+}
+
+glmd::int32 DensityGrid::getBorderLow() const
+{
+	return borderLow_;
+}
+
+glmd::int32 DensityGrid::getBorderHigh() const
+{
+	return borderHigh_;
+}
+
+glmd::int32 DensityGrid::getMin() const
+{
+	return -borderLow_;
+}
+
+glmd::int32 DensityGrid::getMax() const
+{
+	return size_ + borderHigh_;
+}
+
+glmd::int32 DensityGrid::getDimension() const
+{
+	return dimension_;
+}
+
+glmd::int32 DensityGrid::getStrideX() const
+{
+	return strideX_;
+}
+
+glmd::int32 DensityGrid::getStrideY() const
+{
+	return strideY_;
+}
+
+glmd::int32 DensityGrid::getStrideZ() const
+{
+	return 1;
+}
+
+glmd::uint32 DensityGrid::getNumberOfPoints() const
+{
+	return (glmd::uint32)(dimension_ * dimension_ * dimension_);
+}
+
+glmd::float32* DensityGrid::getData()
+{
+	return data_;
+}
+
+const glmd::float32* DensityGrid::getData() const
+{
+	return data_;
+}
+
+}
+}
@@ -0,0 +1,547 @@
+#include <cmath>
+#include <algorithm>
+
+#include "terrain/SimplexNoiseFieldFunction.hpp"
+
+#include "exceptions/InvalidArgumentException.hpp"
+
+#include "common/logger/Logger.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#	define GLR_SIMD_X86
+#	include <immintrin.h>
+#	if defined(_MSC_VER)
+#		include <intrin.h>
+		// MSVC lets us use any instruction set in any function
+#		define GLR_TARGET_SSE4_1
+#		define GLR_TARGET_AVX2
+#	else
+		// GCC and Clang need to be told which functions may use instructions that are not enabled for the whole build
+#		define GLR_TARGET_SSE4_1 __attribute__((target("sse4.1")))
+#		define GLR_TARGET_AVX2 __attribute__((target("avx2")))
+#	endif
+#endif
+
+namespace glmd = glm::detail;
+
+/**
+ * Anonymous helper functions.
+ *
+ * The scalar, SSE4.1 and AVX2 versions of each function perform exactly the same operations in exactly the same order, so they
+ * return the same values.
+ */
+namespace
+{
+
+const glmd::float32 F3 = 1.0f / 3.0f;
+const glmd::float32 G3 = 1.0f / 6.0f;
+const glmd::float32 G3_2 = 2.0f * G3;
+const glmd::float32 G3_3 = 3.0f * G3;
+
+// Multipliers for hashing the lattice coordinates
+const glmd::uint32 HASH_X = 0x8DA6B343u;
+const glmd::uint32 HASH_Y = 0xD8163841u;
+const glmd::uint32 HASH_Z = 0xCB1AB31Fu;
+const glmd::uint32 HASH_MIX = 0x5BD1E995u;
+
+glmd::uint32 hash(glmd::int32 i, glmd::int32 j, glmd::int32 k, glmd::uint32 seed)
+{
+	glmd::uint32 h = seed ^ ((glmd::uint32)i * HASH_X) ^ ((glmd::uint32)j * HASH_Y) ^ ((glmd::uint32)k * HASH_Z);
+
+	h ^= h >> 13;
+	h *= HASH_MIX;
+	h ^= h >> 15;
+
+	return h;
+}
+
+/**
+ * Returns the dot product of (x, y, z) with one of the 12 gradients pointing to the edges of a cube (as in Ken Perlin's
+ * 'improved' noise).
+ */
+glmd::float32 gradient(glmd::uint32 h, glmd::float32 x, glmd::float32 y, glmd::float32 z)
+{
+	h &= 15;
+
+	const glmd::float32 u = (h < 8) ? x : y;
+	const glmd::float32 v = (h < 4) ? y : ((h == 12 || h == 14) ? x : z);
+
+	return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+}
+
+glmd::float32 corner(glmd::uint32 h, glmd::float32 x, glmd::float32 y, glmd::float32 z)
+{
+	glmd::float32 t = 0.6f - x*x - y*y - z*z;
+	t = (t < 0.0f) ? 0.0f : t;
+
+	const glmd::float32 t2 = t * t;
+
+	return t2 * t2 * gradient(h, x, y, z);
+}
+
+glmd::float32 simplex(glmd::float32 x, glmd::float32 y, glmd::float32 z, glmd::uint32 seed)
+{
+	// Skew the input space to find which simplex cell we're in
+	const glmd::float32 s = (x + y + z) * F3;
+	const glmd::int32 i = (glmd::int32)std::floor(x + s);
+	const glmd::int32 j = (glmd::int32)std::floor(y + s);
+	const glmd::int32 k = (glmd::int32)std::floor(z + s);
+
+	const glmd::float32 t = (glmd::float32)(i + j + k) * G3;
+	const glmd::float32 x0 = x - ((glmd::float32)i - t);
+	const glmd::float32 y0 = y - ((glmd::float32)j - t);
+	const glmd::float32 z0 = z - ((glmd::float32)k - t);
+
+	// Determine which of the 6 tetrahedra of the cell we're in
+	const bool xy = (x0 >= y0);
+	const bool yz = (y0 >= z0);
+	const bool xz = (x0 >= z0);
+
+	const glmd::int32 i1 = (xy && xz) ? 1 : 0;
+	const glmd::int32 j1 = (!xy && yz) ? 1 : 0;
+	const glmd::int32 k1 = (!xz && !yz) ? 1 : 0;
+	const glmd::int32 i2 = (xy || xz) ? 1 : 0;
+	const glmd::int32 j2 = (!xy || yz) ? 1 : 0;
+	const glmd::int32 k2 = !(xz && yz) ? 1 : 0;
+
+	const glmd::float32 x1 = x0 - (glmd::float32)i1 + G3;
+	const glmd::float32 y1 = y0 - (glmd::float32)j1 + G3;
+	const glmd::float32 z1 = z0 - (glmd::float32)k1 + G3;
+	const glmd::float32 x2 = x0 - (glmd::float32)i2 + G3_2;
+	const glmd::float32 y2 = y0 - (glmd::float32)j2 + G3_2;
+	const glmd::float32 z2 = z0 - (glmd::float32)k2 + G3_2;
+	const glmd::float32 x3 = x0 - 1.0f + G3_3;
+	const glmd::float32 y3 = y0 - 1.0f + G3_3;
+	const glmd::float32 z3 = z0 - 1.0f + G3_3;
+
+	const glmd::float32 n = corner(hash(i, j, k, seed), x0, y0, z0)
+		+ corner(hash(i + i1, j + j1, k + k1, seed), x1, y1, z1)
+		+ corner(hash(i + i2, j + j2, k + k2, seed), x2, y2, z2)
+		+ corner(hash(i + 1, j + 1, k + 1, seed), x3, y3, z3);
+
+	return 32.0f * n;
+}
+
+glmd::float32 fractalNoise(glmd::float32 x, glmd::float32 y, glmd::float32 z, glmd::float32 frequency, glmd::uint32 octaves, glmd::uint32 seed, glmd::float32 normalization)
+{
+	glmd::float32 sum = 0.0f;
+	glmd::float32 amplitude = 1.0f;
+
+	for (glmd::uint32 o=0; o < octaves; o++)
+	{
+		sum += amplitude * simplex(x * frequency, y * frequency, z * frequency, seed + o);
+
+		frequency *= 2.0f;
+		amplitude *= 0.5f;
+	}
+
+	return sum * normalization;
+}
+
+#if defined(GLR_SIMD_X86)
+
+// ---- SSE4.1 (4 points at a time) ---- //
+
+GLR_TARGET_SSE4_1
+inline __m128i hashSse4_1(__m128i i, __m128i j, __m128i k, __m128i seed)
+{
+	__m128i h = _mm_xor_si128(seed, _mm_mullo_epi32(i, _mm_set1_epi32((glmd::int32)HASH_X)));
+	h = _mm_xor_si128(h, _mm_mullo_epi32(j, _mm_set1_epi32((glmd::int32)HASH_Y)));
+	h = _mm_xor_si128(h, _mm_mullo_epi32(k, _mm_set1_epi32((glmd::int32)HASH_Z)));
+
+	h = _mm_xor_si128(h, _mm_srli_epi32(h, 13));
+	h = _mm_mullo_epi32(h, _mm_set1_epi32((glmd::int32)HASH_MIX));
+	h = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+
+	return h;
+}
+
+GLR_TARGET_SSE4_1
+inline __m128 gradientSse4_1(__m128i h, __m128 x, __m128 y, __m128 z)
+{
+	h = _mm_and_si128(h, _mm_set1_epi32(15));
+
+	const __m128 lessThan8 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(8)));
+	const __m128 lessThan4 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+	// h == 12 || h == 14
+	const __m128 is12Or14 = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_or_si128(h, _mm_set1_epi32(2)), _mm_set1_epi32(14)));
+
+	__m128 u = _mm_blendv_ps(y, x, lessThan8);
+	__m128 v = _mm_blendv_ps(_mm_blendv_ps(z, x, is12Or14), y, lessThan4);
+
+	// Flip the sign bits
+	u = _mm_xor_ps(u, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(1)), 31)));
+	v = _mm_xor_ps(v, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(2)), 30)));
+
+	return _mm_add_ps(u, v);
+}
+
+GLR_TARGET_SSE4_1
+inline __m128 cornerSse4_1(__m128i h, __m128 x, __m128 y, __m128 z)
+{
+	__m128 t = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_set1_ps(0.6f), _mm_mul_ps(x, x)), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+	t = _mm_max_ps(t, _mm_setzero_ps());
+
+	const __m128 t2 = _mm_mul_ps(t, t);
+
+	return _mm_mul_ps(_mm_mul_ps(t2, t2), gradientSse4_1(h, x, y, z));
+}
+
+GLR_TARGET_SSE4_1
+inline __m128 simplexSse4_1(__m128 x, __m128 y, __m128 z, __m128i seed)
+{
+	const __m128 s = _mm_mul_ps(_mm_add_ps(_mm_add_ps(x, y), z), _mm_set1_ps(F3));
+	const __m128i i = _mm_cvttps_epi32(_mm_floor_ps(_mm_add_ps(x, s)));
+	const __m128i j = _mm_cvttps_epi32(_mm_floor_ps(_mm_add_ps(y, s)));
+	const __m128i k = _mm_cvttps_epi32(_mm_floor_ps(_mm_add_ps(z, s)));
+
+	const __m128 t = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(_mm_add_epi32(i, j), k)), _mm_set1_ps(G3));
+	const __m128 x0 = _mm_sub_ps(x, _mm_sub_ps(_mm_cvtepi32_ps(i), t));
+	const __m128 y0 = _mm_sub_ps(y, _mm_sub_ps(_mm_cvtepi32_ps(j), t));
+	const __m128 z0 = _mm_sub_ps(z, _mm_sub_ps(_mm_cvtepi32_ps(k), t));
+
+	const __m128 allOnes = _mm_castsi128_ps(_mm_set1_epi32(-1));
+	const __m128 xy = _mm_cmpge_ps(x0, y0);
+	const __m128 yz = _mm_cmpge_ps(y0, z0);
+	const __m128 xz = _mm_cmpge_ps(x0, z0);
+
+	// Each of these is all 1 bits where the offset is 1, and 0 where it is 0
+	const __m128 i1 = _mm_and_ps(xy, xz);
+	const __m128 j1 = _mm_andnot_ps(xy, yz);
+	const __m128 k1 = _mm_andnot_ps(_mm_or_ps(xz, yz), allOnes);
+	const __m128 i2 = _mm_or_ps(xy, xz);
+	const __m128 j2 = _mm_or_ps(_mm_andnot_ps(xy, allOnes), yz);
+	const __m128 k2 = _mm_andnot_ps(_mm_and_ps(xz, yz), allOnes);
+
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 g3 = _mm_set1_ps(G3);
+	const __m128 g3_2 = _mm_set1_ps(G3_2);
+	const __m128 g3_3 = _mm_set1_ps(G3_3);
+
+	const __m128 x1 = _mm_add_ps(_mm_sub_ps(x0, _mm_and_ps(i1, one)), g3);
+	const __m128 y1 = _mm_add_ps(_mm_sub_ps(y0, _mm_and_ps(j1, one)), g3);
+	const __m128 z1 = _mm_add_ps(_mm_sub_ps(z0, _mm_and_ps(k1, one)), g3);
+	const __m128 x2 = _mm_add_ps(_mm_sub_ps(x0, _mm_and_ps(i2, one)), g3_2);
+	const __m128 y2 = _mm_add_ps(_mm_sub_ps(y0, _mm_and_ps(j2, one)), g3_2);
+	const __m128 z2 = _mm_add_ps(_mm_sub_ps(z0, _mm_and_ps(k2, one)), g3_2);
+	const __m128 x3 = _mm_add_ps(_mm_sub_ps(x0, one), g3_3);
+	const __m128 y3 = _mm_add_ps(_mm_sub_ps(y0, one), g3_3);
+	const __m128 z3 = _mm_add_ps(_mm_sub_ps(z0, one), g3_3);
+
+	// Subtracting a mask (-1) adds 1 to the lattice coordinate
+	const __m128i oneInt = _mm_set1_epi32(1);
+	const __m128i h0 = hashSse4_1(i, j, k, seed);
+	const __m128i h1 = hashSse4_1(_mm_sub_epi32(i, _mm_castps_si128(i1)), _mm_sub_epi32(j, _mm_castps_si128(j1)), _mm_sub_epi32(k, _mm_castps_si128(k1)), seed);
+	const __m128i h2 = hashSse4_1(_mm_sub_epi32(i, _mm_castps_si128(i2)), _mm_sub_epi32(j, _mm_castps_si128(j2)), _mm_sub_epi32(k, _mm_castps_si128(k2)), seed);
+	const __m128i h3 = hashSse4_1(_mm_add_epi32(i, oneInt), _mm_add_epi32(j, oneInt), _mm_add_epi32(k, oneInt), seed);
+
+	__m128 n = cornerSse4_1(h0, x0, y0, z0);
+	n = _mm_add_ps(n, cornerSse4_1(h1, x1, y1, z1));
+	n = _mm_add_ps(n, cornerSse4_1(h2, x2, y2, z2));
+	n = _mm_add_ps(n, cornerSse4_1(h3, x3, y3, z3));
+
+	return _mm_mul_ps(_mm_set1_ps(32.0f), n);
+}
+
+/**
+ * Fills densities for as many points as fit in whole SSE registers.
+ *
+ * @return The number of points that were filled.
+ */
+GLR_TARGET_SSE4_1
+glmd::uint32 fractalNoiseSse4_1(const glmd::float32* x, const glmd::float32* y, const glmd::float32* z, glmd::float32* densities, glmd::uint32 count,
+	glmd::float32 baseFrequency, glmd::uint32 octaves, glmd::uint32 seed, glmd::float32 normalization)
+{
+	const glmd::uint32 numberOfPoints = count & ~3u;
+
+	for (glmd::uint32 p=0; p < numberOfPoints; p += 4)
+	{
+		const __m128 px = _mm_loadu_ps(x + p);
+		const __m128 py = _mm_loadu_ps(y + p);
+		const __m128 pz = _mm_loadu_ps(z + p);
+
+		__m128 sum = _mm_setzero_ps();
+		glmd::float32 frequency = baseFrequency;
+		glmd::float32 amplitude = 1.0f;
+
+		for (glmd::uint32 o=0; o < octaves; o++)
+		{
+			const __m128 f = _mm_set1_ps(frequency);
+			const __m128 n = simplexSse4_1(_mm_mul_ps(px, f), _mm_mul_ps(py, f), _mm_mul_ps(pz, f), _mm_set1_epi32((glmd::int32)(seed + o)));
+
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(amplitude), n));
+
+			frequency *= 2.0f;
+			amplitude *= 0.5f;
+		}
+
+		_mm_storeu_ps(densities + p, _mm_mul_ps(sum, _mm_set1_ps(normalization)));
+	}
+
+	return numberOfPoints;
+}
+
+// ---- AVX2 (8 points at a time) ---- //
+
+GLR_TARGET_AVX2
+inline __m256i hashAvx2(__m256i i, __m256i j, __m256i k, __m256i seed)
+{
+	__m256i h = _mm256_xor_si256(seed, _mm256_mullo_epi32(i, _mm256_set1_epi32((glmd::int32)HASH_X)));
+	h = _mm256_xor_si256(h, _mm256_mullo_epi32(j, _mm256_set1_epi32((glmd::int32)HASH_Y)));
+	h = _mm256_xor_si256(h, _mm256_mullo_epi32(k, _mm256_set1_epi32((glmd::int32)HASH_Z)));
+
+	h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+	h = _mm256_mullo_epi32(h, _mm256_set1_epi32((glmd::int32)HASH_MIX));
+	h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+
+	return h;
+}
+
+GLR_TARGET_AVX2
+inline __m256 gradientAvx2(__m256i h, __m256 x, __m256 y, __m256 z)
+{
+	h = _mm256_and_si256(h, _mm256_set1_epi32(15));
+
+	const __m256 lessThan8 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(8), h));
+	const __m256 lessThan4 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(4), h));
+	// h == 12 || h == 14
+	const __m256 is12Or14 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_or_si256(h, _mm256_set1_epi32(2)), _mm256_set1_epi32(14)));
+
+	__m256 u = _mm256_blendv_ps(y, x, lessThan8);
+	__m256 v = _mm256_blendv_ps(_mm256_blendv_ps(z, x, is12Or14), y, lessThan4);
+
+	// Flip the sign bits
+	u = _mm256_xor_ps(u, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1)), 31)));
+	v = _mm256_xor_ps(v, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), 30)));
+
+	return _mm256_add_ps(u, v);
+}
+
+GLR_TARGET_AVX2
+inline __m256 cornerAvx2(__m256i h, __m256 x, __m256 y, __m256 z)
+{
+	__m256 t = _mm256_sub_ps(_mm256_sub_ps(_mm256_sub_ps(_mm256_set1_ps(0.6f), _mm256_mul_ps(x, x)), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+	t = _mm256_max_ps(t, _mm256_setzero_ps());
+
+	const __m256 t2 = _mm256_mul_ps(t, t);
+
+	return _mm256_mul_ps(_mm256_mul_ps(t2, t2), gradientAvx2(h, x, y, z));
+}
+
+GLR_TARGET_AVX2
+inline __m256 simplexAvx2(__m256 x, __m256 y, __m256 z, __m256i seed)
+{
+	const __m256 s = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(x, y), z), _mm256_set1_ps(F3));
+	const __m256i i = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(x, s)));
+	const __m256i j = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(y, s)));
+	const __m256i k = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(z, s)));
+
+	const __m256 t = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_add_epi32(i, j), k)), _mm256_set1_ps(G3));
+	const __m256 x0 = _mm256_sub_ps(x, _mm256_sub_ps(_mm256_cvtepi32_ps(i), t));
+	const __m256 y0 = _mm256_sub_ps(y, _mm256_sub_ps(_mm256_cvtepi32_ps(j), t));
+	const __m256 z0 = _mm256_sub_ps(z, _mm256_sub_ps(_mm256_cvtepi32_ps(k), t));
+
+	const __m256 allOnes = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+	const __m256 xy = _mm256_cmp_ps(x0, y0, _CMP_GE_OQ);
+	const __m256 yz = _mm256_cmp_ps(y0, z0, _CMP_GE_OQ);
+	const __m256 xz = _mm256_cmp_ps(x0, z0, _CMP_GE_OQ);
+
+	// Each of these is all 1 bits where the offset is 1, and 0 where it is 0
+	const __m256 i1 = _mm256_and_ps(xy, xz);
+	const __m256 j1 = _mm256_andnot_ps(xy, yz);
+	const __m256 k1 = _mm256_andnot_ps(_mm256_or_ps(xz, yz), allOnes);
+	const __m256 i2 = _mm256_or_ps(xy, xz);
+	const __m256 j2 = _mm256_or_ps(_mm256_andnot_ps(xy, allOnes), yz);
+	const __m256 k2 = _mm256_andnot_ps(_mm256_and_ps(xz, yz), allOnes);
+
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 g3 = _mm256_set1_ps(G3);
+	const __m256 g3_2 = _mm256_set1_ps(G3_2);
+	const __m256 g3_3 = _mm256_set1_ps(G3_3);
+
+	const __m256 x1 = _mm256_add_ps(_mm256_sub_ps(x0, _mm256_and_ps(i1, one)), g3);
+	const __m256 y1 = _mm256_add_ps(_mm256_sub_ps(y0, _mm256_and_ps(j1, one)), g3);
+	const __m256 z1 = _mm256_add_ps(_mm256_sub_ps(z0, _mm256_and_ps(k1, one)), g3);
+	const __m256 x2 = _mm256_add_ps(_mm256_sub_ps(x0, _mm256_and_ps(i2, one)), g3_2);
+	const __m256 y2 = _mm256_add_ps(_mm256_sub_ps(y0, _mm256_and_ps(j2, one)), g3_2);
+	const __m256 z2 = _mm256_add_ps(_mm256_sub_ps(z0, _mm256_and_ps(k2, one)), g3_2);
+	const __m256 x3 = _mm256_add_ps(_mm256_sub_ps(x0, one), g3_3);
+	const __m256 y3 = _mm256_add_ps(_mm256_sub_ps(y0, one), g3_3);
+	const __m256 z3 = _mm256_add_ps(_mm256_sub_ps(z0, one), g3_3);
+
+	// Subtracting a mask (-1) adds 1 to the lattice coordinate
+	const __m256i oneInt = _mm256_set1_epi32(1);
+	const __m256i h0 = hashAvx2(i, j, k, seed);
+	const __m256i h1 = hashAvx2(_mm256_sub_epi32(i, _mm256_castps_si256(i1)), _mm256_sub_epi32(j, _mm256_castps_si256(j1)), _mm256_sub_epi32(k, _mm256_castps_si256(k1)), seed);
+	const __m256i h2 = hashAvx2(_mm256_sub_epi32(i, _mm256_castps_si256(i2)), _mm256_sub_epi32(j, _mm256_castps_si256(j2)), _mm256_sub_epi32(k, _mm256_castps_si256(k2)), seed);
+	const __m256i h3 = hashAvx2(_mm256_add_epi32(i, oneInt), _mm256_add_epi32(j, oneInt), _mm256_add_epi32(k, oneInt), seed);
+
+	__m256 n = cornerAvx2(h0, x0, y0, z0);
+	n = _mm256_add_ps(n, cornerAvx2(h1, x1, y1, z1));
+	n = _mm256_add_ps(n, cornerAvx2(h2, x2, y2, z2));
+	n = _mm256_add_ps(n, cornerAvx2(h3, x3, y3, z3));
+
+	return _mm256_mul_ps(_mm256_set1_ps(32.0f), n);
+}
+
+/**
+ * Fills densities for as many points as fit in whole AVX registers.
+ *
+ * @return The number of points that were filled.
+ */
+GLR_TARGET_AVX2
+glmd::uint32 fractalNoiseAvx2(const glmd::float32* x, const glmd::float32* y, const glmd::float32* z, glmd::float32* densities, glmd::uint32 count,
+	glmd::float32 baseFrequency, glmd::uint32 octaves, glmd::uint32 seed, glmd::float32 normalization)
+{
+	const glmd::uint32 numberOfPoints = count & ~7u;
+
+	for (glmd::uint32 p=0; p < numberOfPoints; p += 8)
+	{
+		const __m256 px = _mm256_loadu_ps(x + p);
+		const __m256 py = _mm256_loadu_ps(y + p);
+		const __m256 pz = _mm256_loadu_ps(z + p);
+
+		__m256 sum = _mm256_setzero_ps();
+		glmd::float32 frequency = baseFrequency;
+		glmd::float32 amplitude = 1.0f;
+
+		for (glmd::uint32 o=0; o < octaves; o++)
+		{
+			const __m256 f = _mm256_set1_ps(frequency);
+			const __m256 n = simplexAvx2(_mm256_mul_ps(px, f), _mm256_mul_ps(py, f), _mm256_mul_ps(pz, f), _mm256_set1_epi32((glmd::int32)(seed + o)));
+
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(amplitude), n));
+
+			frequency *= 2.0f;
+			amplitude *= 0.5f;
+		}
+
+		_mm256_storeu_ps(densities + p, _mm256_mul_ps(sum, _mm256_set1_ps(normalization)));
+	}
+
+	// Avoid the penalty for switching between AVX and SSE instructions in the code that runs after us
+	_mm256_zeroupper();
+
+	return numberOfPoints;
+}
+
+#endif /* GLR_SIMD_X86 */
+
+}
+
+namespace glr
+{
+namespace terrain
+{
+
+SimdInstructionSet getSupportedSimdInstructionSet()
+{
+#if defined(GLR_SIMD_X86)
+#	if defined(_MSC_VER)
+	int info[4];
+
+	__cpuid(info, 0);
+	const int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	const bool hasSse4_1 = (info[2] & (1 << 19)) != 0;
+	const bool hasOsXsave = (info[2] & (1 << 27)) != 0;
+	const bool hasAvx = (info[2] & (1 << 28)) != 0;
+
+	bool hasAvx2 = false;
+
+	// The OS also has to save the AVX registers when switching threads
+	if (maxLeaf >= 7 && hasOsXsave && hasAvx && (_xgetbv(0) & 6) == 6)
+	{
+		__cpuidex(info, 7, 0);
+		hasAvx2 = (info[1] & (1 << 5)) != 0;
+	}
+#	else
+	__builtin_cpu_init();
+	const bool hasSse4_1 = __builtin_cpu_supports("sse4.1");
+	const bool hasAvx2 = __builtin_cpu_supports("avx2");
+#	endif
+
+	if (hasAvx2)
+	{
+		return SIMD_AVX2;
+	}
+
+	if (hasSse4_1)
+	{
+		return SIMD_SSE4_1;
+	}
+#endif
+
+	return SIMD_NONE;
+}
+
+SimplexNoiseFieldFunction::SimplexNoiseFieldFunction(glm::detail::float32 frequency, glm::detail::uint32 octaves, glm::detail::uint32 seed, SimdInstructionSet maxInstructionSet)
+	: frequency_(frequency), octaves_(octaves), seed_(seed)
+{
+	if (octaves_ == 0)
+	{
+		const std::string message = std::string("Simplex noise field function requires at least 1 octave.");
+		LOG_ERROR(message);
+		throw exception::InvalidArgumentException(message);
+	}
+
+	glmd::float32 totalAmplitude = 0.0f;
+	glmd::float32 amplitude = 1.0f;
+
+	for (glmd::uint32 o=0; o < octaves_; o++)
+	{
+		totalAmplitude += amplitude;
+		amplitude *= 0.5f;
+	}
+
+	normalization_ = 1.0f / totalAmplitude;
+
+	instructionSet_ = std::min(getSupportedSimdInstructionSet(), maxInstructionSet);
+
+	LOG_DEBUG( "Simplex noise field function using SIMD instruction set: " << instructionSet_ );
+}
+
+SimplexNoiseFieldFunction::~SimplexNoiseFieldFunction()
+{
+}
+
+glm::detail::float32 SimplexNoiseFieldFunction::getNoise(glm::detail::float32 x, glm::detail::float32 y, glm::detail::float32 z)
+{
+	return fractalNoise(x, y, z, frequency_, octaves_, seed_, normalization_);
+}
+
+void SimplexNoiseFieldFunction::getNoiseBatch(const glm::detail::float32* x, const glm::detail::float32* y, const glm::detail::float32* z, glm::detail::float32* densities, glm::detail::uint32 count)
+{
+	glmd::uint32 i = 0;
+
+#if defined(GLR_SIMD_X86)
+	switch (instructionSet_)
+	{
+		case SIMD_AVX2:
+			i = fractalNoiseAvx2(x, y, z, densities, count, frequency_, octaves_, seed_, normalization_);
+			break;
+
+		case SIMD_SSE4_1:
+			i = fractalNoiseSse4_1(x, y, z, densities, count, frequency_, octaves_, seed_, normalization_);
+			break;
+
+		default:
+			break;
+	}
+#endif
+
+	// The points that didn't fill a whole register (or all of them, if we don't have SIMD instructions)
+	for (; i < count; i++)
+	{
+		densities[i] = fractalNoise(x[i], y[i], z[i], frequency_, octaves_, seed_, normalization_);
+	}
+}
+
+SimdInstructionSet SimplexNoiseFieldFunction::getInstructionSet() const
+{
+	return instructionSet_;
+}
+
+}
+}
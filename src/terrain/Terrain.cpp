@@ -11,6 +11,7 @@
 #include "terrain/TerrainMesh.hpp"
 #include "terrain/IVoxelChunkMeshGenerator.hpp"
 #include "terrain/VoxelChunkNoiseGenerator.hpp"
+#include "terrain/TerrainEdit.hpp"
 
 #include "glw/IMaterialManager.hpp"
 #include "glw/ITextureManager.hpp"
@@ -99,6 +100,7 @@ void Terrain::initialize()
 	isActive_ = true;
 	isDirty_ = false;
 	levelOfDetail_ = LOD_UNKNOWN;
+	chunkType_ = CHUNK_TYPE_UNKNOWN;
 
 	LOG_DEBUG( "Terrain initialized." );
 }
@@ -139,11 +141,8 @@ void Terrain::updateLod(LevelOfDetail lod)
 		return;
 	}
 	
+	// The mesh is regenerated for the new level of detail by whoever owns the terrain (see TerrainManager::updateTerrainLod())
 	levelOfDetail_ = lod;
-	
-	// TODO: Actually prepare lod mesh, etc.
-	
-	setIsDirty(true);
 }
 
 LevelOfDetail Terrain::getLod() const
@@ -166,6 +165,11 @@ bool Terrain::isEmptyOrSolid() const
 	return isEmptyOrSolid_;
 }
 
+ChunkType Terrain::getChunkType() const
+{
+	return chunkType_;
+}
+
 void Terrain::render()
 {
 	BasicSceneNode::render();
@@ -192,6 +196,11 @@ models::IModel* Terrain::getModel() const
 }
 
 void Terrain::generate(TerrainSettings settings)
+{
+	generate(settings, nullptr);
+}
+
+void Terrain::generate(const TerrainSettings& settings, const DensityGrid* editedDensities)
 {
 	if (fieldFunction_ == nullptr)
 	{
@@ -206,11 +215,11 @@ void Terrain::generate(TerrainSettings settings)
 		throw exception::InvalidArgumentException(msg);
 	}
 	
-	VoxelChunk voxelChunk = VoxelChunk(getGridX(), getGridY(), getGridZ());
-
-	glr::terrain::generateNoise(voxelChunk, length_, width_, height_, *fieldFunction_);
+	auto mesh = ChunkMeshData();
+	ChunkType chunkType = CHUNK_TYPE_UNKNOWN;
 	
-	this->isEmptyOrSolid_ = glr::terrain::determineIfEmptyOrSolid(voxelChunk);
+	this->isEmptyOrSolid_ = !generateMesh(getGridX(), getGridY(), getGridZ(), glm::ivec3(length_, width_, height_), *fieldFunction_, *voxelChunkMeshGenerator_, levelOfDetail_, settings, mesh, editedDensities, &chunkType);
+	this->chunkType_ = chunkType;
 	
 	if (this->isEmptyOrSolid_)
 	{
@@ -218,11 +227,98 @@ void Terrain::generate(TerrainSettings settings)
 		return;
 	}
 	
-	auto vertices = std::vector< glm::vec3 >();
-	auto normals = std::vector< glm::vec3 >();
-	auto textureBlendingValues = std::vector< glm::vec4 >();
+	setMeshData( std::move(mesh.vertices), std::move(mesh.normals), std::move(mesh.textureBlendingValues), std::move(mesh.indices), settings );
+}
+
+bool Terrain::generateMesh(glmd::int32 gridX, glmd::int32 gridY, glmd::int32 gridZ, const glm::ivec3& dimensions, IFieldFunction& fieldFunction,
+	const IVoxelChunkMeshGenerator& voxelChunkMeshGenerator, LevelOfDetail lod, const TerrainSettings& settings, ChunkMeshData& mesh,
+	const DensityGrid* editedDensities, ChunkType* chunkType)
+{
+	VoxelChunk voxelChunk = VoxelChunk(gridX, gridY, gridZ, getMeshStride(lod, settings));
+	
+	// Edited density values can differ from the field function anywhere, so only unedited chunks can be classified without sampling
+	const bool isHomogeneous = (editedDensities == nullptr && glr::terrain::classifyChunk(voxelChunk, dimensions.x, dimensions.y, dimensions.z, fieldFunction));
+	
+	if (!isHomogeneous)
+	{
+		glr::terrain::generateNoise(voxelChunk, dimensions.x, dimensions.y, dimensions.z, fieldFunction);
+		
+		if (editedDensities != nullptr)
+		{
+			glr::terrain::copyEditedDensities(*editedDensities, voxelChunk);
+		}
+	}
+	
+	if (isHomogeneous || glr::terrain::determineIfEmptyOrSolid(voxelChunk))
+	{
+		if (chunkType != nullptr)
+		{
+			*chunkType = voxelChunk.type;
+		}
+		
+		return false;
+	}
 	
-	voxelChunkMeshGenerator_->generateMesh(voxelChunk, length_, width_, height_, vertices, normals, textureBlendingValues);
+	if (chunkType != nullptr)
+	{
+		*chunkType = CHUNK_TYPE_SURFACE;
+	}
+	
+	if (settings.indexedMeshes)
+	{
+		voxelChunkMeshGenerator.generateMesh(voxelChunk, dimensions.x, dimensions.y, dimensions.z, mesh.vertices, mesh.normals, mesh.textureBlendingValues, mesh.indices);
+	}
+	else
+	{
+		voxelChunkMeshGenerator.generateMesh(voxelChunk, dimensions.x, dimensions.y, dimensions.z, mesh.vertices, mesh.normals, mesh.textureBlendingValues);
+	}
+	
+	return !mesh.vertices.empty();
+}
+
+glmd::int32 Terrain::getMeshStride(LevelOfDetail lod, const TerrainSettings& settings)
+{
+	// Only the indexed Marching Cubes generator can mesh a density grid that was sampled at a lower level of detail
+	if (settings.indexedMeshes && settings.smoothingAlgorithm == ALGORITHM_MARCHING_CUBES)
+	{
+		return getLevelOfDetailStride(lod);
+	}
+	
+	return 1;
+}
+
+void Terrain::updateMesh(ChunkMeshData mesh)
+{
+	if (meshData_.get() == nullptr || mesh.vertices.empty())
+	{
+		return;
+	}
+	
+	meshData_->setVertices( std::move(mesh.vertices) );
+	meshData_->setNormals( std::move(mesh.normals) );
+	meshData_->setTextureBlendingData( std::move(mesh.textureBlendingValues) );
+	meshData_->setIndices( std::move(mesh.indices) );
+	
+	// The mesh only reallocates its buffers if the new mesh is bigger than the old one
+	if (meshData_->isVideoMemoryAllocated())
+	{
+		meshData_->pushToVideoMemory();
+	}
+	else
+	{
+		this->setIsDirty( true );
+	}
+}
+
+void Terrain::setMeshData(std::vector< glm::vec3 > vertices, std::vector< glm::vec3 > normals, std::vector< glm::vec4 > textureBlendingValues,
+	std::vector< glm::detail::uint32 > indices, TerrainSettings settings)
+{
+	this->isEmptyOrSolid_ = vertices.empty();
+	
+	if (this->isEmptyOrSolid_)
+	{
+		return;
+	}
 	
 	std::stringstream ss;
 	ss << "terrain_" << this->getGridX() << "_" << this->getGridY() << "_" << this->getGridZ();
@@ -234,6 +330,7 @@ void Terrain::generate(TerrainSettings settings)
 	meshData_->setVertices( vertices );
 	meshData_->setNormals( normals );
 	meshData_->setTextureBlendingData( textureBlendingValues );
+	meshData_->setIndices( indices );
 	
 	const std::string materialName = std::string("terrain_material_1");
 	auto material = openGlDevice_->getMaterialManager()->getMaterial(materialName);
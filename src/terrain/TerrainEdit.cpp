@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <cmath>
+
+#include "terrain/TerrainEdit.hpp"
+#include "terrain/VoxelChunk.hpp"
+#include "terrain/VoxelChunkNoiseGenerator.hpp"
+#include "terrain/Constants.hpp"
+
+/**
+ * Anonymous helper functions.
+ */
+namespace
+{
+
+/**
+ * Returns the region (in world coordinates) whose density values an edit may change.
+ *
+ * This is the bounding box of the edit, grown by one grid point on each side - a cube edge that the new surface passes through
+ * has both of its end points within one grid point of the shape, so this is enough to get the surface interpolation right.
+ */
+void getEditBounds(const glr::terrain::TerrainEdit& edit, glm::vec3& min, glm::vec3& max)
+{
+	const glm::vec3 margin = glm::vec3(glr::terrain::constants::RESOLUTION);
+
+	min = edit.getMin() - margin;
+	max = edit.getMax() + margin;
+}
+
+}
+
+namespace glr
+{
+namespace terrain
+{
+
+glm::vec3 TerrainEdit::getMin() const
+{
+	if (shape == EDIT_SHAPE_SPHERE)
+		return center - glm::vec3(halfExtents.x);
+
+	return center - halfExtents;
+}
+
+glm::vec3 TerrainEdit::getMax() const
+{
+	if (shape == EDIT_SHAPE_SPHERE)
+		return center + glm::vec3(halfExtents.x);
+
+	return center + halfExtents;
+}
+
+glmd::float32 TerrainEdit::getDistance(const glm::vec3& point) const
+{
+	if (shape == EDIT_SHAPE_SPHERE)
+		return glm::length(point - center) - halfExtents.x;
+
+	const glm::vec3 q = glm::abs(point - center) - halfExtents;
+	const glmd::float32 outside = glm::length( glm::max(q, glm::vec3(0.0f)) );
+	const glmd::float32 inside = std::min( std::max(q.x, std::max(q.y, q.z)), 0.0f );
+
+	return outside + inside;
+}
+
+std::vector<glm::ivec3> getChunksAffectedByEdit(const TerrainEdit& edit, const glm::ivec3& dimensions)
+{
+	auto chunks = std::vector<glm::ivec3>();
+
+	glm::vec3 editMin;
+	glm::vec3 editMax;
+	getEditBounds(edit, editMin, editMax);
+
+	// Chunk (0, 0, 0) starts here, and every chunk is chunkSize further along
+	const glm::vec3 worldOrigin = getChunkOrigin(0, 0, 0, dimensions);
+	const glmd::float32 chunkSize = (glmd::float32)constants::SIZE * constants::RESOLUTION;
+
+	// The density grid of a chunk reaches from POINT_FIELD_OFFSET points before the chunk to POINT_FIELD_OVERSET - 1 points after it
+	const glmd::float32 borderLow = (glmd::float32)constants::POINT_FIELD_OFFSET * constants::RESOLUTION;
+	const glmd::float32 borderHigh = (glmd::float32)(constants::POINT_FIELD_OVERSET - 1) * constants::RESOLUTION;
+
+	glm::ivec3 first;
+	glm::ivec3 last;
+
+	for (glmd::int32 i=0; i < 3; i++)
+	{
+		first[i] = (glmd::int32)std::ceil( (editMin[i] - worldOrigin[i] - chunkSize - borderHigh) / chunkSize );
+		last[i] = (glmd::int32)std::floor( (editMax[i] - worldOrigin[i] + borderLow) / chunkSize );
+
+		first[i] = std::max(first[i], 0);
+		last[i] = std::min(last[i], dimensions[i] - 1);
+	}
+
+	for (glmd::int32 x=first.x; x <= last.x; x++)
+	{
+		for (glmd::int32 y=first.y; y <= last.y; y++)
+		{
+			for (glmd::int32 z=first.z; z <= last.z; z++)
+			{
+				chunks.push_back( glm::ivec3(x, y, z) );
+			}
+		}
+	}
+
+	return chunks;
+}
+
+bool applyEdit(const TerrainEdit& edit, DensityGrid& densities, const glm::vec3& origin)
+{
+	glm::vec3 editMin;
+	glm::vec3 editMax;
+	getEditBounds(edit, editMin, editMax);
+
+	// Only visit the points that lie inside the edit bounds
+	glm::ivec3 first;
+	glm::ivec3 last;
+
+	for (glmd::int32 i=0; i < 3; i++)
+	{
+		first[i] = (glmd::int32)std::ceil( (editMin[i] - origin[i]) / constants::RESOLUTION );
+		last[i] = (glmd::int32)std::floor( (editMax[i] - origin[i]) / constants::RESOLUTION );
+
+		first[i] = std::max(first[i], densities.getMin());
+		last[i] = std::min(last[i], densities.getMax() - 1);
+	}
+
+	bool changed = false;
+
+	for (glmd::int32 x=first.x; x <= last.x; x++)
+	{
+		for (glmd::int32 y=first.y; y <= last.y; y++)
+		{
+			for (glmd::int32 z=first.z; z <= last.z; z++)
+			{
+				const glm::vec3 point = origin + glm::vec3((glmd::float32)x, (glmd::float32)y, (glmd::float32)z) * constants::RESOLUTION;
+				const glmd::float32 distance = edit.getDistance(point);
+
+				glmd::float32& density = densities.at(x, y, z);
+				const glmd::float32 previous = density;
+
+				// Constructive solid geometry - density is positive in air and negative in solid terrain
+				if (edit.operation == EDIT_OPERATION_REMOVE)
+					density = std::max(density, -distance);
+				else
+					density = std::min(density, distance);
+
+				if (density != previous)
+					changed = true;
+			}
+		}
+	}
+
+	return changed;
+}
+
+void copyEditedDensities(const DensityGrid& editedDensities, VoxelChunk& chunk)
+{
+	DensityGrid& points = chunk.points;
+
+	const glmd::int32 min = points.getMin();
+	const glmd::int32 max = points.getMax();
+	const glmd::int32 stride = chunk.stride;
+
+	for (glmd::int32 x=min; x < max; x++)
+	{
+		for (glmd::int32 y=min; y < max; y++)
+		{
+			for (glmd::int32 z=min; z < max; z++)
+			{
+				// The point at (x, y, z) in the chunk is at (x, y, z) * stride in the full resolution grid
+				if (editedDensities.isInBounds(x * stride, y * stride, z * stride))
+					points.set(x, y, z, editedDensities.get(x * stride, y * stride, z * stride));
+			}
+		}
+	}
+}
+
+}
+}
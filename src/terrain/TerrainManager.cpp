@@ -1,4 +1,6 @@
 #include <utility>
+#include <chrono>
+#include <algorithm>
 
 #define GLM_FORCE_RADIANS
 #include <glm/gtx/string_cast.hpp>
@@ -6,7 +8,11 @@
 #include "terrain/TerrainManager.hpp"
 #include "terrain/Constants.hpp"
 #include "terrain/VoxelChunkNoiseGenerator.hpp"
-#include "terrain/TerrainMeshSerializer.hpp"
+#include "terrain/VoxelChunk.hpp"
+#include "terrain/TerrainEdit.hpp"
+#include "terrain/TerrainMesh.hpp"
+#include "terrain/ChunkStoreReader.hpp"
+#include "terrain/ChunkStoreWriter.hpp"
 #include "terrain/dual_contouring/VoxelChunkMeshGenerator.hpp"
 #include "terrain/marching_cubes/VoxelChunkMeshGenerator.hpp"
 #include "terrain/ITerrain.hpp"
@@ -25,6 +31,19 @@
 #include "common/logger/Logger.hpp"
 #include "common/utilities/GlmUtilities.hpp"
 
+namespace
+{
+
+glm::detail::int64 getTimeInMicroseconds()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+// Edited terrain is queued ahead of all other terrain (whose priority is its squared distance from the follow target)
+const glm::detail::float32 EDIT_PRIORITY = -1.0f;
+
+}
+
 namespace glr
 {
 namespace terrain
@@ -38,6 +57,8 @@ TerrainManager::TerrainManager(glw::IOpenGlDevice* openGlDevice, IFieldFunction*
 
 TerrainManager::~TerrainManager()
 {
+	// Make sure no worker threads are still using our terrain
+	threadPool_.reset();
 }
 
 void TerrainManager::initialize()
@@ -69,18 +90,34 @@ void TerrainManager::initialize()
 			throw exception::InvalidArgumentException(message);
 	}
 	
-	terrain_ = std::vector< std::unique_ptr<Terrain> >();
-	terrainToBeProcessed_ = std::vector< std::unique_ptr<Terrain> >();
+	terrain_ = TerrainMap();
+	terrainToBeProcessed_ = TerrainMap();
+	cancelledTerrain_ = std::unordered_set< glm::ivec3, ChunkCoordinatesHash >();
+	hasNewCancelledTerrain_ = false;
 	eventListeners_ = std::vector< ITerrainManagerEventListener* >();
 	
 	idManager_ = IdManager();
+	
+	threadPool_ = std::unique_ptr<ThreadPool>( new ThreadPool(terrainSettings_.numberOfThreads) );
+	
+	resetStatistics();
 
 	LOG_DEBUG( "Terrain Manager initialized." );
 }
 
 ITerrain* TerrainManager::getTerrain(glm::detail::int32 x, glm::detail::int32 y, glm::detail::int32 z) const
 {
-	// TODO: Implement
+	const glm::ivec3 coordinates = getGridCoordinates( glm::vec3((glmd::float32)x, (glmd::float32)y, (glmd::float32)z) );
+	
+	std::lock_guard<std::mutex> lock(terrainMutex_);
+	
+	auto it = terrain_.find(coordinates);
+	
+	if (it != terrain_.end())
+	{
+		return it->second.get();
+	}
+	
 	return nullptr;
 }
 
@@ -108,7 +145,9 @@ void TerrainManager::tick()
 {
 	auto followTargetGridLocation = getTargetGridLocation();
 	//std::cout << glm::to_string(followTargetGridLocation) << "    " << glm::to_string(currentGridLocation_) << std::endl;
-	if (followTargetGridLocation != currentGridLocation_)
+	const bool hasMoved = (followTargetGridLocation != currentGridLocation_);
+	
+	if (hasMoved)
 	{
 		{
 			std::lock_guard<std::mutex> lock(gridMutex);
@@ -118,74 +157,291 @@ void TerrainManager::tick()
 		std::cout << "updateTerrainLod START " << std::endl;
 		this->updateTerrainLod();
 		std::cout << "updateTerrainLod END " << std::endl;
+		
+		cancelOutOfRangeTerrain();
+		
+		// Terrain closest to the follow target's new location gets generated first
+		threadPool_->reprioritize( [this](glmd::uint64 key) { return this->getTerrainPriority( getChunkCoordinates(key) ); } );
+	}
+	
+	// Cancelled terrain that the follow target has turned back towards is created again (terrain discarded by a worker thread since the
+	// last tick may already be back in range, even if the follow target hasn't moved to another grid cell)
+	if (hasNewCancelledTerrain_.exchange(false) || hasMoved)
+	{
+		createBackInRangeTerrain();
 	}
 }
 
-void TerrainManager::updateTerrainLod()
+void TerrainManager::cancelOutOfRangeTerrain()
 {
-	for (int i=0; i < terrainSettings_.length; i++)
+	std::lock_guard<std::mutex> lock(terrainToBeProcessedMutex_);
+	
+	auto it = terrainToBeProcessed_.begin();
+	while (it != terrainToBeProcessed_.end())
 	{
-		for (int j=0; j < terrainSettings_.height; j++)
+		Terrain* terrain = it->second.get();
+		
+		if ( isInRange(it->first) )
 		{
-			for (int k=0; k < terrainSettings_.width; k++)
-			{
-				auto terrain = getTerrain(i, j, k);
-				
-				if (terrain != nullptr)
-				{
-					LevelOfDetail lod = getNewTerrainLod(*terrain);
-					terrain->updateLod(lod);
-					
-					auto function = [=] {
-						terrain->prepareOrUpdateGraphics();
-						//this->moveTerrainFromProcessedToReady( terrain );
-					};
-					
-					postOpenGlWork( function );
-				}
-			}
+			++it;
+			continue;
+		}
+		
+		terrain->setIsActive( false );
+		
+		// If the terrain hasn't started generating yet, we can remove it straight away - otherwise, it will be discarded once its
+		// worker thread is finished with it
+		if ( threadPool_->cancel( getChunkKey(terrain->getGridX(), terrain->getGridY(), terrain->getGridZ()) ) > 0 )
+		{
+			LOG_DEBUG("Cancelled generation of terrain: " << terrain->getGridX() << ", " << terrain->getGridY() << ", " << terrain->getGridZ());
+			cancelledTerrain_.insert( it->first );
+			it = terrainToBeProcessed_.erase(it);
+		}
+		else
+		{
+			++it;
 		}
-		//std::cout << "MARK: " << i << std::endl;
 	}
 }
 
-LevelOfDetail TerrainManager::getNewTerrainLod(Terrain& t)
+void TerrainManager::createBackInRangeTerrain()
 {
-	if (isWithinRadius(t, *followTarget_, terrainSettings_.lodHighestRadius))
+	auto backInRange = std::vector< glm::ivec3 >();
+	
 	{
-		return LOD_HIGHEST;
+		std::lock_guard<std::mutex> lock(terrainToBeProcessedMutex_);
+		
+		auto it = cancelledTerrain_.begin();
+		while (it != cancelledTerrain_.end())
+		{
+			if ( isInRange(*it) )
+			{
+				backInRange.push_back( *it );
+				it = cancelledTerrain_.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
 	}
-	else if (isWithinRadius(t, *followTarget_, terrainSettings_.lodHighRadius))
+	
+	for ( auto& coordinates : backInRange )
 	{
-		return LOD_HIGH;
+		LOG_DEBUG("Terrain is back in range: " << coordinates.x << ", " << coordinates.y << ", " << coordinates.z);
+		createTerrain( coordinates, true );
 	}
-	else if (isWithinRadius(t, *followTarget_, terrainSettings_.lodMediumRadius))
+}
+
+void TerrainManager::discardCancelledTerrain(Terrain* terrain)
+{
+	const glm::ivec3 coordinates = glm::ivec3(terrain->getGridX(), terrain->getGridY(), terrain->getGridZ());
+	
 	{
-		return LOD_MEDIUM;
+		std::lock_guard<std::mutex> lock(terrainToBeProcessedMutex_);
+		
+		auto it = terrainToBeProcessed_.find( coordinates );
+		
+		// Make sure it's the same terrain, and not a different one at the same grid coordinates
+		if (it == terrainToBeProcessed_.end() || it->second.get() != terrain)
+		{
+			return;
+		}
+		
+		terrainToBeProcessed_.erase(it);
+		cancelledTerrain_.insert( coordinates );
 	}
-	else if (isWithinRadius(t, *followTarget_, terrainSettings_.lodLowRadius))
+	
+	hasNewCancelledTerrain_ = true;
+}
+
+glm::vec3 TerrainManager::getTerrainCenter(const glm::ivec3& coordinates) const
+{
+	const glmd::float32 chunkSize = (glmd::float32)terrainSettings_.chunkSize;
+	
+	// Chunks are centered around the origin in world coordinates
+	return glm::vec3(
+		(glmd::float32)(coordinates.x - terrainSettings_.length/2) * chunkSize + chunkSize/2.0f,
+		(glmd::float32)(coordinates.y - terrainSettings_.width/2) * chunkSize + chunkSize/2.0f,
+		(glmd::float32)(coordinates.z - terrainSettings_.height/2) * chunkSize + chunkSize/2.0f
+	);
+}
+
+glm::ivec3 TerrainManager::getGridCoordinates(const glm::vec3& position) const
+{
+	const glm::vec3 pos = position / (glmd::float32)terrainSettings_.chunkSize;
+	
+	// Use floor so that points just below 0 end up in the chunk below (and not in the same chunk as points just above 0)
+	return glm::ivec3(
+		(glmd::int32)glm::floor(pos.x) + terrainSettings_.length/2,
+		(glmd::int32)glm::floor(pos.y) + terrainSettings_.width/2,
+		(glmd::int32)glm::floor(pos.z) + terrainSettings_.height/2
+	);
+}
+
+glmd::float32 TerrainManager::getTerrainPriority(const glm::ivec3& coordinates) const
+{
+	glm::vec3 target = glm::vec3();
+	
+	if (followTarget_ != nullptr)
 	{
-		return LOD_LOW;
+		target = followTarget_->getPosition();
 	}
-	else
+	
+	const glm::vec3 distance = getTerrainCenter(coordinates) - target;
+	
+	return glm::dot(distance, distance);
+}
+
+bool TerrainManager::isInRange(const glm::ivec3& coordinates) const
+{
+	return getTerrainPriority(coordinates) <= terrainSettings_.maxViewDistance * terrainSettings_.maxViewDistance;
+}
+
+void TerrainManager::updateTerrainLod()
+{
+	std::lock_guard<std::mutex> lock(terrainMutex_);
+	
+	for (auto& it : terrain_)
 	{
-		return LOD_LOWEST;
+		const LevelOfDetail lod = getNewTerrainLod(it.first);
+		
+		if (lod != it.second->getLod())
+		{
+			changeTerrainLod(it.second.get(), lod);
+		}
 	}
 }
 
-bool TerrainManager::isWithinRadius(Terrain& t, ISceneNode& n, glmd::float32 radius)
+void TerrainManager::changeTerrainLod(Terrain* terrain, LevelOfDetail lod)
 {
-	glm::vec3 pos = t.getPosition();
-	glm::vec3 center = n.getPosition();
+	terrain->updateLod(lod);
 	
-	return utilities::isVec3InSphere(pos, center, radius);
+	const glm::ivec3 coordinates = glm::ivec3(terrain->getGridX(), terrain->getGridY(), terrain->getGridZ());
+	
+	remeshTerrain( terrain, getTerrainPriority(coordinates) );
+}
+
+void TerrainManager::remeshTerrain(Terrain* terrain, glmd::float32 priority)
+{
+	const glm::ivec3 coordinates = glm::ivec3(terrain->getGridX(), terrain->getGridY(), terrain->getGridZ());
+	const glmd::uint64 key = getChunkKey(coordinates);
+	const LevelOfDetail lod = terrain->getLod();
+	
+	// A mesh for the previous level of detail (or density values) that hasn't started generating yet is no longer needed
+	threadPool_->cancel(key);
+	threadPool_->enqueue( key, priority, [=] { this->regenerateTerrainMesh( coordinates, lod ); } );
+}
+
+void TerrainManager::regenerateTerrainMesh(const glm::ivec3& coordinates, LevelOfDetail lod)
+{
+	auto mesh = std::make_shared<ChunkMeshData>();
+	
+	glmd::uint32 version = 0;
+	auto editedDensities = getEditedDensities(coordinates, version);
+	
+	if ( !Terrain::generateMesh(coordinates.x, coordinates.y, coordinates.z, getDimensions(), *fieldFunction_, *voxelChunkMeshGenerator_, lod, terrainSettings_, *mesh, editedDensities.get()) )
+	{
+		// If the surface is too small to show up at this level of detail, we just keep the current mesh - but if an edit removed the
+		// surface altogether, the terrain has nothing left to render
+		if (version == 0 || Terrain::getMeshStride(lod, terrainSettings_) != 1)
+		{
+			return;
+		}
+		
+		auto function = [=] {
+			auto terrain = this->getTerrainAtGrid( coordinates );
+			
+			if (terrain != nullptr && terrain->getLod() == lod && this->getEditVersion(coordinates) == version)
+			{
+				this->sendRemovedTerrainEventToEventListeners( terrain );
+				this->removeTerrain( coordinates );
+			}
+		};
+		
+		postOpenGlWork( function );
+		return;
+	}
+	
+	auto function = [=] {
+		auto terrain = this->getTerrainAtGrid( coordinates );
+		
+		// If the density values were edited again, a newer mesh is already on its way
+		if (terrain != nullptr && terrain->getLod() == lod && this->getEditVersion(coordinates) == version)
+		{
+			terrain->updateMesh( std::move(*mesh) );
+		}
+	};
+	
+	postOpenGlWork( function );
+}
+
+LevelOfDetail TerrainManager::getNewTerrainLod(const glm::ivec3& coordinates) const
+{
+	// The priority is the squared distance between the terrain and the follow target
+	const glmd::float32 distance = getTerrainPriority(coordinates);
+	
+	LevelOfDetail lod = LOD_LOWEST;
+	
+	if (distance <= terrainSettings_.lodHighestRadius * terrainSettings_.lodHighestRadius)
+	{
+		lod = LOD_HIGHEST;
+	}
+	else if (distance <= terrainSettings_.lodHighRadius * terrainSettings_.lodHighRadius)
+	{
+		lod = LOD_HIGH;
+	}
+	else if (distance <= terrainSettings_.lodMediumRadius * terrainSettings_.lodMediumRadius)
+	{
+		lod = LOD_MEDIUM;
+	}
+	else if (distance <= terrainSettings_.lodLowRadius * terrainSettings_.lodLowRadius)
+	{
+		lod = LOD_LOW;
+	}
+	
+	lod = std::min(lod, terrainSettings_.maxLevelOfDetail);
+	lod = std::max(lod, terrainSettings_.minLevelOfDetail);
+	
+	return lod;
 }
 
 void TerrainManager::postOpenGlWork(std::function<void()> work)
 {
-	openGlWorkMutex_.lock();
-	openGlWork_.emplace_back(std::move(work));
-	openGlWorkMutex_.unlock();
+	openGlWork_.push( std::move(work) );
+}
+
+void TerrainManager::countChunk(ChunkType chunkType)
+{
+	switch (chunkType)
+	{
+		case CHUNK_TYPE_EMPTY:
+			numberOfEmptyChunks_++;
+			break;
+		
+		case CHUNK_TYPE_SOLID:
+			numberOfSolidChunks_++;
+			break;
+		
+		case CHUNK_TYPE_SURFACE:
+			numberOfSurfaceChunks_++;
+			break;
+		
+		default:
+			break;
+	}
+}
+
+void TerrainManager::resetStatistics()
+{
+	numberOfChunksGenerated_ = 0;
+	generationStartTime_ = getTimeInMicroseconds();
+	lastChunkGeneratedTime_ = generationStartTime_.load();
+	
+	numberOfEmptyChunks_ = 0;
+	numberOfSolidChunks_ = 0;
+	numberOfSurfaceChunks_ = 0;
+	numberOfChunksSkipped_ = 0;
 }
 
 void TerrainManager::createTerrain(glmd::float32 x, glmd::float32 y, glmd::float32 z, bool initialize)
@@ -204,83 +460,336 @@ void TerrainManager::createTerrain(const glm::ivec3& coordinates, bool initializ
 
 void TerrainManager::createTerrain(glmd::int32 x, glmd::int32 y, glmd::int32 z, bool initialize)
 {
-	// Make sure this terrain doesn't already exist in the render list
-	auto terrain = getTerrain(x, y, z);
+	const glm::ivec3 coordinates = glm::ivec3(x, y, z);
 	
-	if (terrain != nullptr)
+	// Chunks that the field function can show to be entirely empty or solid don't need a Terrain at all (edited chunks can't be
+	// classified this way - remeshEditedTerrain() creates them when an edit gives them a surface)
+	if (initialize && fieldFunction_ != nullptr && getEditVersion(coordinates) == 0)
 	{
-		LOG_DEBUG("Terrain already exists in render list: " << x << ", " << y << ", " << z);
-		return;
+		auto chunk = VoxelChunk(x, y, z);
+		
+		if ( classifyChunk(chunk, terrainSettings_.length, terrainSettings_.width, terrainSettings_.height, *fieldFunction_) )
+		{
+			countChunk(chunk.type);
+			numberOfChunksSkipped_++;
+			return;
+		}
 	}
 	
-	// Check to see if it exists in the 'to be processed' list
-	terrain = getTerrainToBeProcessed(x, y, z);
+	auto terrain = createTerrainToBeProcessed(x, y, z);
 	
-	// If it doesn't, then we create it
 	if (terrain == nullptr)
 	{
+		return;
+	}
+	
+	// terrain manager stuff
+	if (initialize)
+	{
+		threadPool_->enqueue( getChunkKey(x, y, z), getTerrainPriority(coordinates), [=] { this->generateTerrain( terrain ); } );
+	}
+	else
+	{
+		sendAddedTerrainEventToEventListeners(terrain);
+	}
+}
+
+Terrain* TerrainManager::createTerrainToBeProcessed(glmd::int32 x, glmd::int32 y, glmd::int32 z)
+{
+	// Make sure this terrain doesn't already exist in the render list
+	if (getTerrainAtGrid(x, y, z) != nullptr)
+	{
+		LOG_DEBUG("Terrain already exists in render list: " << x << ", " << y << ", " << z);
+		return nullptr;
+	}
+	
+	// Or in the 'to be processed' list
+	if (getTerrainToBeProcessed(x, y, z) != nullptr)
+	{
+		LOG_DEBUG("Terrain already exists in 'to be processed' list: " << x << ", " << y << ", " << z);
+		return nullptr;
+	}
+	
+	Terrain* terrain = nullptr;
+	
+	{
+		std::lock_guard<std::mutex> lock(terrainToBeProcessedMutex_);
+		auto& t = terrainToBeProcessed_[ glm::ivec3(x, y, z) ];
+		t = std::unique_ptr<Terrain>( new Terrain(idManager_.createId(), openGlDevice_, x, y, z, terrainSettings_.length, terrainSettings_.width, terrainSettings_.height, fieldFunction_, voxelChunkMeshGenerator_.get()) );
+		
+		terrain = t.get();
+	}
+	
+	// The terrain is generated at the level of detail it will be rendered at
+	terrain->updateLod( getNewTerrainLod(glm::ivec3(x, y, z)) );
+	
+	auto shader = openGlDevice_->getShaderProgramManager()->getShaderProgram( std::string("voxel") );
+	assert( shader != nullptr );
+	
+	terrain->attach(shader);
+	
+	std::stringstream ss;
+	ss << "terrain_" << terrain->getGridX() << "_" << terrain->getGridY() << "_" << terrain->getGridZ();
+	terrain->setName( ss.str() );
+	
+	return terrain;
+}
+
+void TerrainManager::generateTerrain(Terrain* terrain)
+{
+	glmd::uint32 version = 0;
+	
+	if (terrain->isActive())
+	{
+		const glm::ivec3 coordinates = glm::ivec3(terrain->getGridX(), terrain->getGridY(), terrain->getGridZ());
+		auto editedDensities = getEditedDensities(coordinates, version);
+		
+		terrain->generate(terrainSettings_, editedDensities.get());
+		
+		countChunk( terrain->getChunkType() );
+		numberOfChunksGenerated_++;
+		lastChunkGeneratedTime_ = getTimeInMicroseconds();
+	}
+	
+	finishTerrain( terrain, version );
+}
+
+void TerrainManager::loadTerrain(Terrain* terrain, std::shared_ptr<ChunkStoreReader> chunkStore, glmd::uint32 editVersion)
+{
+	if (terrain->isActive())
+	{
+		const glm::ivec3 coordinates = glm::ivec3(terrain->getGridX(), terrain->getGridY(), terrain->getGridZ());
+		
+		auto mesh = ChunkMeshData();
+		LevelOfDetail lod = LOD_UNKNOWN;
+		
+		try
 		{
-			std::lock_guard<std::mutex> lock(terrainToBeProcessedMutex_);
-			terrainToBeProcessed_.push_back( 
-				std::unique_ptr<Terrain>( new Terrain(idManager_.createId(), openGlDevice_, x, y, z, terrainSettings_.length, terrainSettings_.width, terrainSettings_.height, fieldFunction_, voxelChunkMeshGenerator_.get()) )
-			);
-			
-			terrain = terrainToBeProcessed_.back().get();
+			chunkStore->readMesh(coordinates, mesh, &lod);
+		}
+		catch (const exception::Exception& e)
+		{
+			// A corrupt chunk is discarded (it has been logged already) - it can always be generated again
+			mesh = ChunkMeshData();
 		}
 		
-		auto shader = openGlDevice_->getShaderProgramManager()->getShaderProgram( std::string("voxel") );
-		assert( shader != nullptr );
+		terrain->setMeshData( std::move(mesh.vertices), std::move(mesh.normals), std::move(mesh.textureBlendingValues), std::move(mesh.indices), terrainSettings_ );
 		
-		terrain->attach(shader);
+		if (lod != LOD_UNKNOWN)
+		{
+			terrain->updateLod(lod);
+		}
+	}
+	
+	finishTerrain( terrain, editVersion );
+}
+
+void TerrainManager::finishTerrain(Terrain* terrain, glmd::uint32 editVersion)
+{
+	// Cancelled terrain is no longer needed (unless it comes back into range), and empty or solid terrain has nothing to render - neither
+	// has any video memory allocated yet
+	if (!terrain->isActive())
+	{
+		this->discardCancelledTerrain( terrain );
+		return;
+	}
+	
+	if (terrain->isEmptyOrSolid())
+	{
+		this->removeTerrainToBeProcessedAndReturn( terrain );
+		return;
+	}
+	
+	auto function = [=] {
+		// The terrain may have gone out of range while it was waiting for the OpenGL thread
+		if (!terrain->isActive())
+		{
+			this->discardCancelledTerrain( terrain );
+			return;
+		}
+		
+		terrain->prepareOrUpdateGraphics();
+		this->moveTerrainFromProcessedToReady( terrain );
 		
-		std::stringstream ss;
-		ss << "terrain_" << terrain->getGridX() << "_" << terrain->getGridY() << "_" << terrain->getGridZ();
-		terrain->setName( ss.str() );
+		sendAddedTerrainEventToEventListeners(terrain);
 		
-		// terrain manager stuff
-		if (initialize)
+		const glm::ivec3 coordinates = glm::ivec3(terrain->getGridX(), terrain->getGridY(), terrain->getGridZ());
+		
+		// The follow target may have moved while the terrain was being generated
+		const LevelOfDetail lod = this->getNewTerrainLod( coordinates );
+		
+		if (lod != terrain->getLod())
 		{
-			terrain->generate();
-			
-			if (!terrain->isEmptyOrSolid())
-			{
-				auto function = [=] {
-					terrain->prepareOrUpdateGraphics();
-					this->moveTerrainFromProcessedToReady( terrain );
-				};
-				
-				postOpenGlWork( function );
-				
-				sendAddedTerrainEventToEventListeners(terrain);
-			}
-			else
-			{
-				this->removeTerrainToBeProcessedAndReturn( terrain );
-			}
+			this->changeTerrainLod( terrain, lod );
 		}
-		else
+		// And the terrain may have been edited
+		else if (this->getEditVersion(coordinates) != editVersion)
 		{
-			sendAddedTerrainEventToEventListeners(terrain);
+			this->remeshTerrain( terrain, EDIT_PRIORITY );
 		}
+	};
+	
+	postOpenGlWork( function );
+}
+
+void TerrainManager::applyEdit(const TerrainEdit& edit)
+{
+	if (fieldFunction_ == nullptr)
+	{
+		const std::string message = std::string("Unable to edit terrain - no field function set.");
+		LOG_ERROR(message);
+		throw exception::InvalidArgumentException(message);
 	}
-	else
+	
+	if (edit.halfExtents.x < 0.0f || edit.halfExtents.y < 0.0f || edit.halfExtents.z < 0.0f)
 	{
-		LOG_DEBUG("Terrain already exists in 'to be processed' list: " << x << ", " << y << ", " << z);
+		const std::string message = std::string("Unable to edit terrain - the size of the edit must not be negative.");
+		LOG_ERROR(message);
+		throw exception::InvalidArgumentException(message);
 	}
+	
+	glmd::uint32 numberOfChunksEdited = 0;
+	
+	for ( auto& coordinates : getChunksAffectedByEdit(edit, getDimensions()) )
+	{
+		if ( editChunkDensities(edit, coordinates) )
+		{
+			remeshEditedTerrain( coordinates );
+			numberOfChunksEdited++;
+		}
+	}
+	
+	LOG_DEBUG( "Edited " << numberOfChunksEdited << " terrain chunks." );
 }
 
-void TerrainManager::addTerrain(Terrain* terrain)
+bool TerrainManager::editChunkDensities(const TerrainEdit& edit, const glm::ivec3& coordinates)
 {
-	std::lock_guard<std::mutex> lock(terrainMutex_);
+	const glm::ivec3 dimensions = getDimensions();
+	const glm::vec3 origin = getChunkOrigin(coordinates.x, coordinates.y, coordinates.z, dimensions);
+	
+	{
+		std::lock_guard<std::mutex> lock(editedChunksMutex_);
+		
+		auto it = editedChunks_.find(coordinates);
+		
+		if (it != editedChunks_.end())
+		{
+			return applyEditToEditedChunk(edit, it->second, origin);
+		}
+	}
+	
+	// The first edit of a chunk starts from the field function's values (always at full resolution, whatever the chunk's level of detail)
+	// Generating them is slow, so we do it without holding the lock
+	auto chunk = VoxelChunk(coordinates.x, coordinates.y, coordinates.z);
+	generateNoise(chunk, dimensions.x, dimensions.y, dimensions.z, *fieldFunction_);
+	
+	std::lock_guard<std::mutex> lock(editedChunksMutex_);
+	
+	// Another thread may have edited the chunk while we were generating its density values - keep its entry, and apply our edit on top of it
+	auto it = editedChunks_.find(coordinates);
+	
+	if (it != editedChunks_.end())
+	{
+		return applyEditToEditedChunk(edit, it->second, origin);
+	}
 	
-	terrain_.push_back( std::unique_ptr<Terrain>( terrain ) );
+	// We only keep the density values of chunks that the edit actually changes
+	if ( !glr::terrain::applyEdit(edit, chunk.points, origin) )
+	{
+		return false;
+	}
+	
+	auto& editedChunk = editedChunks_[coordinates];
+	editedChunk.densities = std::move(chunk.points);
+	editedChunk.version = 1;
+	
+	return true;
+}
+
+bool TerrainManager::applyEditToEditedChunk(const TerrainEdit& edit, EditedChunk& editedChunk, const glm::vec3& origin)
+{
+	if ( !glr::terrain::applyEdit(edit, editedChunk.densities, origin) )
+	{
+		return false;
+	}
+	
+	editedChunk.version++;
+	return true;
+}
+
+void TerrainManager::remeshEditedTerrain(const glm::ivec3& coordinates)
+{
+	auto terrain = getTerrainAtGrid(coordinates);
+	
+	if (terrain != nullptr)
+	{
+		remeshTerrain( terrain, EDIT_PRIORITY );
+		return;
+	}
+	
+	// Terrain that is still being generated picks up the edited density values when it starts, or is remeshed once it finishes (see finishTerrain())
+	if (getTerrainToBeProcessed(coordinates) != nullptr || !isInRange(coordinates))
+	{
+		return;
+	}
+	
+	// The chunk was empty or solid before the edit
+	terrain = createTerrainToBeProcessed(coordinates.x, coordinates.y, coordinates.z);
+	
+	if (terrain != nullptr)
+	{
+		threadPool_->enqueue( getChunkKey(coordinates), EDIT_PRIORITY, [=] { this->generateTerrain( terrain ); } );
+	}
+}
+
+std::unique_ptr<DensityGrid> TerrainManager::getEditedDensities(const glm::ivec3& coordinates, glmd::uint32& version) const
+{
+	std::lock_guard<std::mutex> lock(editedChunksMutex_);
+	
+	auto it = editedChunks_.find(coordinates);
+	
+	if (it == editedChunks_.end())
+	{
+		version = 0;
+		return std::unique_ptr<DensityGrid>();
+	}
+	
+	version = it->second.version;
+	
+	return std::unique_ptr<DensityGrid>( new DensityGrid(it->second.densities) );
+}
+
+glmd::uint32 TerrainManager::getEditVersion(const glm::ivec3& coordinates) const
+{
+	std::lock_guard<std::mutex> lock(editedChunksMutex_);
+	
+	auto it = editedChunks_.find(coordinates);
+	
+	if (it == editedChunks_.end())
+	{
+		return 0;
+	}
+	
+	return it->second.version;
+}
+
+glm::ivec3 TerrainManager::getDimensions() const
+{
+	return glm::ivec3(terrainSettings_.length, terrainSettings_.width, terrainSettings_.height);
+}
+
+void TerrainManager::addTerrain(Terrain* terrain)
+{
+	addTerrain( std::unique_ptr<Terrain>( terrain ) );
 }
 
 void TerrainManager::addTerrain(std::unique_ptr<Terrain> terrain)
 {
 	std::lock_guard<std::mutex> lock(terrainMutex_);
 	
-	terrain_.push_back( std::move(terrain) );
+	const glm::ivec3 coordinates = glm::ivec3(terrain->getGridX(), terrain->getGridY(), terrain->getGridZ());
+	
+	terrain_[coordinates] = std::move(terrain);
 }
 
 void TerrainManager::removeTerrain(glmd::float32 x, glmd::float32 y, glmd::float32 z)
@@ -322,13 +831,12 @@ std::unique_ptr<Terrain> TerrainManager::removeTerrainAndReturn(glmd::int32 x, g
 	
 	auto retVal = std::unique_ptr<Terrain>();
 	
-	auto findFunction = [x, y, z](const std::unique_ptr<Terrain>& node) { return (node->getGridX() == x && node->getGridY() == y && node->getGridZ() == z); };
-	
-	auto it = std::find_if(terrain_.begin(), terrain_.end(), findFunction);
+	auto it = terrain_.find( glm::ivec3(x, y, z) );
 	
 	if (it != terrain_.end())
 	{
-		retVal = std::move(*it);
+		removeTerrainProxy( it->first );
+		retVal = std::move(it->second);
 		terrain_.erase(it);
 	}
 	
@@ -341,13 +849,13 @@ std::unique_ptr<Terrain> TerrainManager::removeTerrainAndReturn(Terrain* terrain
 	
 	auto retVal = std::unique_ptr<Terrain>();
 	
-	auto findFunction = [terrain](const std::unique_ptr<Terrain>& node) { return node.get() == terrain; };
-	
-	auto it = std::find_if(terrain_.begin(), terrain_.end(), findFunction);
+	auto it = terrain_.find( glm::ivec3(terrain->getGridX(), terrain->getGridY(), terrain->getGridZ()) );
 	
-	if (it != terrain_.end())
+	// Make sure it's the same terrain, and not a different one at the same grid coordinates
+	if (it != terrain_.end() && it->second.get() == terrain)
 	{
-		retVal = std::move(*it);
+		removeTerrainProxy( it->first );
+		retVal = std::move(it->second);
 		terrain_.erase(it);
 	}
 	
@@ -360,13 +868,11 @@ std::unique_ptr<Terrain> TerrainManager::removeTerrainToBeProcessedAndReturn(glm
 	
 	auto retVal = std::unique_ptr<Terrain>();
 	
-	auto findFunction = [x, y, z](const std::unique_ptr<Terrain>& node) { return (node->getGridX() == x && node->getGridY() == y && node->getGridZ() == z); };
-	
-	auto it = std::find_if(terrainToBeProcessed_.begin(), terrainToBeProcessed_.end(), findFunction);
+	auto it = terrainToBeProcessed_.find( glm::ivec3(x, y, z) );
 	
 	if (it != terrainToBeProcessed_.end())
 	{
-		retVal = std::move(*it);
+		retVal = std::move(it->second);
 		terrainToBeProcessed_.erase(it);
 	}
 	
@@ -379,13 +885,12 @@ std::unique_ptr<Terrain> TerrainManager::removeTerrainToBeProcessedAndReturn(Ter
 	
 	auto retVal = std::unique_ptr<Terrain>();
 	
-	auto findFunction = [terrain](const std::unique_ptr<Terrain>& node) { return node.get() == terrain; };
+	auto it = terrainToBeProcessed_.find( glm::ivec3(terrain->getGridX(), terrain->getGridY(), terrain->getGridZ()) );
 	
-	auto it = std::find_if(terrainToBeProcessed_.begin(), terrainToBeProcessed_.end(), findFunction);
-	
-	if (it != terrainToBeProcessed_.end())
+	// Make sure it's the same terrain, and not a different one at the same grid coordinates
+	if (it != terrainToBeProcessed_.end() && it->second.get() == terrain)
 	{
-		retVal = std::move(*it);
+		retVal = std::move(it->second);
 		terrainToBeProcessed_.erase(it);
 	}
 	
@@ -411,35 +916,25 @@ void TerrainManager::moveTerrainFromProcessedToReady(ITerrain* terrain)
 
 Terrain* TerrainManager::getTerrain(glmd::float32 x, glmd::float32 y, glmd::float32 z)
 {
-	glmd::int32 i = (glmd::int32)(x / (glmd::float32)terrainSettings_.chunkSize);
-	glmd::int32 j = (glmd::int32)(y / (glmd::float32)terrainSettings_.chunkSize);
-	glmd::int32 k = (glmd::int32)(z / (glmd::float32)terrainSettings_.chunkSize);
-	
-	i += terrainSettings_.length/2;
-	j += terrainSettings_.width/2;
-	k += terrainSettings_.height/2;
-	
-	return getTerrain(i, j, k);
+	return getTerrainAtGrid( getGridCoordinates(glm::vec3(x, y, z)) );
 }
 
-Terrain* TerrainManager::getTerrain(const glm::ivec3& coordinates)
+Terrain* TerrainManager::getTerrainAtGrid(const glm::ivec3& coordinates)
 {	
-	return getTerrain(coordinates.x, coordinates.y, coordinates.z);
+	return getTerrainAtGrid(coordinates.x, coordinates.y, coordinates.z);
 }
 
-Terrain* TerrainManager::getTerrain(glmd::int32 x, glmd::int32 y, glmd::int32 z)
+Terrain* TerrainManager::getTerrainAtGrid(glmd::int32 x, glmd::int32 y, glmd::int32 z)
 {
 	std::lock_guard<std::mutex> lock(terrainMutex_);
 	
 	Terrain* retVal = nullptr;
 	
-	auto findFunction = [x, y, z](const std::unique_ptr<Terrain>& node) { return (node->getGridX() == x && node->getGridY() == y && node->getGridZ() == z); };
-	
-	auto it = std::find_if(terrain_.begin(), terrain_.end(), findFunction);
+	auto it = terrain_.find( glm::ivec3(x, y, z) );
 	
 	if (it != terrain_.end())
 	{
-		retVal = it->get();
+		retVal = it->second.get();
 	}
 
 	return retVal;
@@ -447,15 +942,7 @@ Terrain* TerrainManager::getTerrain(glmd::int32 x, glmd::int32 y, glmd::int32 z)
 
 Terrain* TerrainManager::getTerrainToBeProcessed(glmd::float32 x, glmd::float32 y, glmd::float32 z)
 {
-	glmd::int32 i = (glmd::int32)(x / (glmd::float32)terrainSettings_.chunkSize);
-	glmd::int32 j = (glmd::int32)(y / (glmd::float32)terrainSettings_.chunkSize);
-	glmd::int32 k = (glmd::int32)(z / (glmd::float32)terrainSettings_.chunkSize);
-	
-	i += terrainSettings_.length/2;
-	j += terrainSettings_.width/2;
-	k += terrainSettings_.height/2;
-	
-	return getTerrainToBeProcessed(i, j, k);
+	return getTerrainToBeProcessed( getGridCoordinates(glm::vec3(x, y, z)) );
 }
 
 Terrain* TerrainManager::getTerrainToBeProcessed(const glm::ivec3& coordinates)
@@ -469,13 +956,11 @@ Terrain* TerrainManager::getTerrainToBeProcessed(glmd::int32 x, glmd::int32 y, g
 	
 	Terrain* retVal = nullptr;
 	
-	auto findFunction = [x, y, z](const std::unique_ptr<Terrain>& node) { return (node->getGridX() == x && node->getGridY() == y && node->getGridZ() == z); };
-	
-	auto it = std::find_if(terrainToBeProcessed_.begin(), terrainToBeProcessed_.end(), findFunction);
+	auto it = terrainToBeProcessed_.find( glm::ivec3(x, y, z) );
 	
 	if (it != terrainToBeProcessed_.end())
 	{
-		retVal = it->get();
+		retVal = it->second.get();
 	}
 
 	return retVal;
@@ -483,19 +968,14 @@ Terrain* TerrainManager::getTerrainToBeProcessed(glmd::int32 x, glmd::int32 y, g
 
 void TerrainManager::update(glmd::uint32 maxUpdates)
 {
-	glmd::uint32 size = 0;
-	openGlWorkMutex_.lock();
-	size = openGlWork_.size();
-	openGlWorkMutex_.unlock();
-
-	for (glmd::uint32 i=0; i < maxUpdates && i < size; i++)
+	for (glmd::uint32 i=0; i < maxUpdates; i++)
 	{
 		auto work = std::function<void()>();
 
-		openGlWorkMutex_.lock();
-		work = std::move(openGlWork_.front());
-		openGlWork_.pop_front();
-		openGlWorkMutex_.unlock();
+		if ( !openGlWork_.pop(work) )
+		{
+			break;
+		}
 
 		work();
 	}
@@ -505,13 +985,38 @@ void TerrainManager::render()
 {
 	std::lock_guard<std::mutex> lock(terrainMutex_);
 	
-	//int numV = 0;
-	for ( auto& terrain : terrain_ )
+	// Terrain is only reinserted into the bounding volume hierarchy when its mesh grows outside of its fat bounding box
+	for ( auto& it : terrain_ )
+	{
+		auto& proxy = terrainProxies_.emplace( it.first, BoundingVolumeHierarchy::NULL_PROXY ).first->second;
+		proxy = terrainHierarchy_.synchronize( proxy, it.second->getBoundingBox(), it.second.get() );
+		
+		// Terrain without a bounding box (i.e. that hasn't been pushed to video memory yet) can't be culled
+		if (proxy == BoundingVolumeHierarchy::NULL_PROXY)
+		{
+			it.second->render();
+		}
+	}
+	
+	const Frustum frustum = Frustum( openGlDevice_->getProjectionMatrix() * openGlDevice_->getViewMatrix() );
+	
+	cullingStatistics_ = terrainHierarchy_.query( frustum, [](void* terrain) { static_cast<Terrain*>(terrain)->render(); } );
+	cullingStatistics_.visible += terrain_.size() - terrainHierarchy_.getNumberOfProxies();
+}
+
+void TerrainManager::removeTerrainProxy(const glm::ivec3& coordinates)
+{
+	auto it = terrainProxies_.find( coordinates );
+	
+	if (it != terrainProxies_.end())
 	{
-		terrain->render();
-		//numV += terrain->getData()->getVertices().size();
+		if (it->second != BoundingVolumeHierarchy::NULL_PROXY)
+		{
+			terrainHierarchy_.remove( it->second );
+		}
+		
+		terrainProxies_.erase( it );
 	}
-	//std::cout << "DONE: " << numV << std::endl;
 }
 
 void TerrainManager::setFollowTarget(ISceneNode* target)
@@ -531,6 +1036,13 @@ void TerrainManager::generate(bool initialize)
 {
 	removeAllTerrain();
 	
+	{
+		std::lock_guard<std::mutex> lock(terrainToBeProcessedMutex_);
+		cancelledTerrain_.clear();
+	}
+	
+	resetStatistics();
+	
 	for (int i=0; i < terrainSettings_.length; i++)
 	{
 		for (int j=0; j < terrainSettings_.height; j++)
@@ -580,21 +1092,106 @@ void TerrainManager::removeTerrainManagerEventListener(ITerrainManagerEventListe
 
 void TerrainManager::serialize(const std::string& filename)
 {
-	std::ofstream stream(filename, std::ios::out | std::ios::binary);
+	ChunkStoreWriter chunkStore(filename, terrainSettings_.chunkStoreCompression, false);
 	
 	{
 		std::lock_guard<std::mutex> lock(terrainMutex_);
-		for (auto& terrain : terrain_)
+		
+		auto mesh = ChunkMeshData();
+		
+		for (auto& it : terrain_)
+		{
+			auto terrainMesh = it.second->getData();
+			
+			if (terrainMesh == nullptr)
+			{
+				continue;
+			}
+			
+			mesh.vertices = terrainMesh->getVertices();
+			mesh.normals = terrainMesh->getNormals();
+			mesh.textureBlendingValues = terrainMesh->getTextureBlendingData();
+			mesh.indices = terrainMesh->getIndices();
+			
+			chunkStore.writeMesh(it.first, it.second->getLod(), mesh);
+		}
+	}
+	
+	// Edited chunks can't be generated again from the field function, so we save their density values too
+	{
+		std::lock_guard<std::mutex> lock(editedChunksMutex_);
+		
+		for (auto& it : editedChunks_)
 		{
-			std::cout << "Saving..." << std::endl;
-			auto mesh = terrain->getData();
-			glr::terrain::serialize(stream, *mesh);
+			chunkStore.writeDensity(it.first, it.second.densities);
 		}
 	}
+	
+	chunkStore.close();
+	
+	LOG_DEBUG( "Saved " << chunkStore.getNumberOfChunks(CHUNK_PAYLOAD_MESH) << " terrain chunks (" << chunkStore.getNumberOfChunks(CHUNK_PAYLOAD_DENSITY) << " edited) to: " << filename );
 }
 
 void TerrainManager::deserialize(const std::string& filename)
 {
+	// Shared with the worker threads, so that the file stays mapped until the last chunk is loaded
+	auto chunkStore = std::shared_ptr<ChunkStoreReader>( new ChunkStoreReader(filename) );
+	
+	// The density values of edited chunks are loaded up front, since they are needed whenever those chunks are remeshed
+	{
+		std::lock_guard<std::mutex> lock(editedChunksMutex_);
+		
+		for ( auto& c : chunkStore->getChunkCoordinates(CHUNK_PAYLOAD_DENSITY) )
+		{
+			auto densities = DensityGrid();
+			
+			try
+			{
+				if ( !chunkStore->readDensity(c, densities) )
+				{
+					continue;
+				}
+			}
+			catch (const exception::Exception& e)
+			{
+				// A corrupt chunk is discarded (it has been logged already) - the chunk is generated from the field function instead
+				continue;
+			}
+			
+			auto& editedChunk = editedChunks_[c];
+			editedChunk.densities = std::move(densities);
+			editedChunk.version++;
+		}
+	}
+	
+	auto coordinates = chunkStore->getChunkCoordinates(CHUNK_PAYLOAD_MESH);
+	
+	// Chunks closest to the follow target are queued (and loaded) first
+	auto priorities = std::vector< std::pair<glmd::float32, glm::ivec3> >();
+	priorities.reserve( coordinates.size() );
+	
+	for ( auto& c : coordinates )
+	{
+		priorities.push_back( std::make_pair(getTerrainPriority(c), c) );
+	}
+	
+	std::sort(priorities.begin(), priorities.end(), [](const std::pair<glmd::float32, glm::ivec3>& a, const std::pair<glmd::float32, glm::ivec3>& b) { return a.first < b.first; });
+	
+	for ( auto& p : priorities )
+	{
+		const glm::ivec3& c = p.second;
+		
+		auto terrain = createTerrainToBeProcessed(c.x, c.y, c.z);
+		
+		if (terrain != nullptr)
+		{
+			const glmd::uint32 editVersion = getEditVersion(c);
+			
+			threadPool_->enqueue( getChunkKey(c), p.first, [=] { this->loadTerrain( terrain, chunkStore, editVersion ); } );
+		}
+	}
+	
+	LOG_DEBUG( "Loading " << priorities.size() << " terrain chunks from: " << filename );
 }
 
 glm::detail::int32 TerrainManager::getLength() const
@@ -617,5 +1214,42 @@ glm::detail::int32 TerrainManager::getBlockSize() const
 	return terrainSettings_.chunkSize;
 }
 
+glm::detail::uint32 TerrainManager::getNumberOfChunksGenerated() const
+{
+	return numberOfChunksGenerated_;
+}
+
+glm::detail::float32 TerrainManager::getChunksPerSecond() const
+{
+	const glmd::uint32 numberOfChunks = numberOfChunksGenerated_;
+	const glmd::int64 elapsedTime = lastChunkGeneratedTime_ - generationStartTime_;
+	
+	if (numberOfChunks == 0 || elapsedTime <= 0)
+	{
+		return 0.0f;
+	}
+	
+	return (glmd::float32)( (glmd::float64)numberOfChunks / ((glmd::float64)elapsedTime / 1000000.0) );
+}
+
+ChunkStatistics TerrainManager::getChunkStatistics() const
+{
+	auto statistics = ChunkStatistics();
+	
+	statistics.numberOfEmptyChunks = numberOfEmptyChunks_;
+	statistics.numberOfSolidChunks = numberOfSolidChunks_;
+	statistics.numberOfSurfaceChunks = numberOfSurfaceChunks_;
+	statistics.numberOfChunksSkipped = numberOfChunksSkipped_;
+	
+	return statistics;
+}
+
+CullingStatistics TerrainManager::getCullingStatistics() const
+{
+	std::lock_guard<std::mutex> lock(terrainMutex_);
+	
+	return cullingStatistics_;
+}
+
 }
 }
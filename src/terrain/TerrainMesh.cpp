@@ -4,18 +4,16 @@
 
 #include "glw/IOpenGlDevice.hpp"
 
-#include "exceptions/GlException.hpp"
-
 namespace glr
 {
 namespace terrain
 {
 
-TerrainMesh::TerrainMesh(glw::IOpenGlDevice* openGlDevice, std::string name) : Mesh(openGlDevice, std::move(name))
+TerrainMesh::TerrainMesh(glw::IOpenGlDevice* openGlDevice, std::string name) : Mesh(openGlDevice, std::move(name)), shaderVariableLocation_(-1)
 {
 	vertexBoneData_ = std::vector< glw::VertexBoneData >();
 	boneData_ = glw::BoneData();
-	texBlendVboId_ = 0;
+	vertexFormat_ = createVertexFormat(shaderVariableLocation_);
 }
 
 TerrainMesh::TerrainMesh(glw::IOpenGlDevice* openGlDevice,
@@ -36,8 +34,7 @@ TerrainMesh::TerrainMesh(glw::IOpenGlDevice* openGlDevice,
 	colors_ = std::move(colors);
 	vertexBoneData_ = std::vector< glw::VertexBoneData >();
 	boneData_ = glw::BoneData();
-	
-	texBlendVboId_ = 0;
+	vertexFormat_ = createVertexFormat(shaderVariableLocation_);
 	
 	if (initialize)
 	{
@@ -52,32 +49,6 @@ TerrainMesh::~TerrainMesh()
 	freeVideoMemory();
 }
 
-void TerrainMesh::pushToVideoMemory()
-{
-	Mesh::pushToVideoMemory();
-	
-	LOG_DEBUG( "Loading texture blending data into video memory for mesh '" + name_ +"'." );
-
-	glBindVertexArray(vaoId_);
-
-	glBindBuffer(GL_ARRAY_BUFFER, texBlendVboId_);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, texBlendingData_.size() * sizeof(glm::vec4), &texBlendingData_[0]);
-
-	glBindVertexArray(0);
-	
-	glw::GlError err = openGlDevice_->getGlError();
-	if (err.type != GL_NONE)
-	{		
-		std::string msg = std::string( "Error while pushing texture blending data to video memory for mesh '" + name_ + "' in OpenGL: " + err.name);
-		LOG_ERROR( msg );
-		throw exception::GlException( msg );
-	}
-	else
-	{
-		LOG_DEBUG( "Successfully pushed texture blending data to video memory for mesh '" + name_ + "'." );
-	}
-}
-
 void TerrainMesh::pullFromVideoMemory()
 {
 	Mesh::pullFromVideoMemory();
@@ -91,55 +62,12 @@ void TerrainMesh::freeLocalData()
 	texBlendingData_ = std::vector< glm::vec4 >();
 }
 
-void TerrainMesh::freeVideoMemory()
-{	
-	Mesh::freeVideoMemory();
-	
-	if (texBlendVboId_ == 0)
-		return;
-
-	glDeleteBuffers(1, &texBlendVboId_);
-	
-	texBlendVboId_ = 0;
-}
-
-void TerrainMesh::allocateVideoMemory()
+void TerrainMesh::writeVertices(std::vector< glm::detail::uint8 >& vertices, glm::detail::uint32 firstVertex, glm::detail::uint32 numberOfVertices) const
 {
-	Mesh::allocateVideoMemory();
+	Mesh::writeVertices(vertices, firstVertex, numberOfVertices);
 	
-	if (texBlendVboId_ > 0)
-	{
-		std::string msg = std::string( "Mesh already has a texture blend vertex buffer object generated." );
-		LOG_ERROR( msg );
-		throw exception::GlException( msg );
-	}
-	
-	glBindVertexArray(vaoId_);
-
-	// create our vbo
-	glGenBuffers(1, &texBlendVboId_);
-	
-	glBindBuffer(GL_ARRAY_BUFFER, texBlendVboId_);
-	glBufferData(GL_ARRAY_BUFFER, texBlendingData_.size() * sizeof(glm::vec4), nullptr, GL_STATIC_DRAW);
-	glEnableVertexAttribArray(shaderVariableLocation_);
-	glVertexAttribPointer(shaderVariableLocation_, 4, GL_FLOAT, GL_FALSE, 0, 0);
-
-	glBindVertexArray(0);
-	
-	glw::GlError err = openGlDevice_->getGlError();
-	if (err.type != GL_NONE)
-	{
-		// Cleanup
-		freeVideoMemory();
-		
-		std::string msg = std::string( "Error while allocating video memory for mesh '" + name_ + "' in OpenGL: " + err.name);
-		LOG_ERROR( msg );
-		throw exception::GlException( msg );
-	}
-	else
-	{
-		LOG_DEBUG( "Successfully allocated texture blending data in video memory for mesh '" + name_ + "'." );
-	}
+	if (shaderVariableLocation_ >= 0)
+		vertexFormat_.write( (glm::detail::uint32)shaderVariableLocation_, texBlendingData_, vertices, firstVertex, numberOfVertices );
 }
 
 void TerrainMesh::setTextureBlendingData(std::vector< glm::vec4 > texBlendingData)
@@ -151,6 +79,7 @@ void TerrainMesh::setTextureBlendingData(std::vector< glm::vec4 > texBlendingDat
 void TerrainMesh::setShaderVariableLocation(GLint shaderVariableLocation)
 {
 	shaderVariableLocation_ = shaderVariableLocation;
+	setVertexFormat( createVertexFormat(shaderVariableLocation_) );
 }
 
 std::vector< glm::vec4 >& TerrainMesh::getTextureBlendingData()
@@ -163,6 +92,19 @@ GLint TerrainMesh::getShaderVariableLocation() const
 	return shaderVariableLocation_;
 }
 
+glw::VertexFormat TerrainMesh::createVertexFormat(GLint textureBlendingLocation)
+{
+	auto format = glw::VertexFormat();
+	format.addAttribute(glw::VERTEX_ATTRIBUTE_LOCATION_POSITION, 3, glw::VERTEX_ATTRIBUTE_TYPE_FLOAT32);
+	format.addAttribute(glw::VERTEX_ATTRIBUTE_LOCATION_NORMAL, 3, glw::VERTEX_ATTRIBUTE_TYPE_INT_2_10_10_10);
+	
+	// Blending values are weights in [0, 1], so a byte each is plenty
+	if (textureBlendingLocation >= 0)
+		format.addAttribute((glm::detail::uint32)textureBlendingLocation, 4, glw::VERTEX_ATTRIBUTE_TYPE_UNORM8);
+	
+	return format;
+}
+
 }
 }
 
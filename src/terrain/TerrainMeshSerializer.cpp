@@ -29,6 +29,14 @@ void serialize(std::ofstream& stream, TerrainMesh& terrainMesh)
 	
 	for ( auto& v : vertices)
 		stream.write((char*)&v, sizeof(glm::vec3));
+	
+	auto& indices = terrainMesh.getIndices();
+	
+	size = indices.size();
+	stream.write((char*)&size, sizeof(glmd::int32));
+	
+	if (size > 0)
+		stream.write((char*)&indices[0], size * sizeof(glmd::uint32));
 }
 
 void deserialize(std::ifstream& stream, TerrainMesh& terrainMesh)
@@ -42,6 +50,16 @@ void deserialize(std::ifstream& stream, TerrainMesh& terrainMesh)
 		stream.read((char*)&v, sizeof(glm::vec3));
 	
 	terrainMesh.setVertices( vertices );
+	
+	size = 0;
+	stream.read((char*)&size, sizeof(glmd::int32));
+	
+	auto indices = std::vector<glmd::uint32>( size );
+	
+	if (size > 0)
+		stream.read((char*)&indices[0], size * sizeof(glmd::uint32));
+	
+	terrainMesh.setIndices( indices );
 }
 
 /*
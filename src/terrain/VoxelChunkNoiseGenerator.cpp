@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "terrain/VoxelChunkNoiseGenerator.hpp"
 #include "terrain/VoxelChunk.hpp"
 #include "terrain/Constants.hpp"
@@ -10,56 +12,70 @@
 namespace
 {
 
-void allocatePointsMemory(glr::terrain::Points& points)
+void allocatePointsMemory(glr::terrain::DensityGrid& points, glmd::int32 stride)
 {
-	const glmd::int32 max = glr::terrain::constants::SIZE + glr::terrain::constants::POINT_FIELD_OFFSET + glr::terrain::constants::POINT_FIELD_OVERSET;
-	
-	// Make our blocks array the proper size
-	points.resize(max);
-	for (glmd::int32 i = 0; i < max; i++)
-	{
-		points[i].resize(max);
-		for (glmd::int32 j = 0; j < max; j++)
-			points[i][j].resize(max);
-	}
+	// A single allocation for the whole field (reused if the grid already has the right dimensions)
+	points.resize(glr::terrain::constants::SIZE / stride, glr::terrain::constants::POINT_FIELD_OFFSET, glr::terrain::constants::POINT_FIELD_OVERSET);
 }
 
-void computeDensities(glr::terrain::VoxelChunk& chunk, glmd::int32 x, glmd::int32 y, glmd::int32 z, const glm::ivec3 dimensions, glr::terrain::IFieldFunction& fieldFunction)
+// The number of points passed to the field function in each call to getNoiseBatch()
+const glmd::uint32 BATCH_SIZE = 256;
+
+void computePoints(glr::terrain::VoxelChunk& chunk, const glm::ivec3& dimensions, glr::terrain::IFieldFunction& fieldFunction)
 {
-	glmd::float32 fx = (glmd::float32)(chunk.gridX * glr::terrain::constants::SIZE + x) * glr::terrain::constants::RESOLUTION;
-	glmd::float32 fy = (glmd::float32)(chunk.gridY * glr::terrain::constants::SIZE + y) * glr::terrain::constants::RESOLUTION;
-	glmd::float32 fz = (glmd::float32)(chunk.gridZ * glr::terrain::constants::SIZE + z) * glr::terrain::constants::RESOLUTION;
+	const glmd::int32 min = chunk.points.getMin();
+	const glmd::int32 max = chunk.points.getMax();
 	
-	const glmd::int32 pointsPerDimension = glr::terrain::constants::SIZE * glr::terrain::constants::RESOLUTION;
-	
-	// This is making sure that globally our chunks are centered at the origin ((0, 0, 0) in world coodinates)
-	fx -= (glmd::float32)(pointsPerDimension * dimensions.x/2);
-	fy -= (glmd::float32)(pointsPerDimension * dimensions.y/2);
-	fz -= (glmd::float32)(pointsPerDimension * dimensions.z/2);
+	const glm::vec3 origin = glr::terrain::getChunkOrigin(chunk.gridX, chunk.gridY, chunk.gridZ, dimensions);
+	const glmd::float32 spacing = glr::terrain::constants::RESOLUTION * (glmd::float32)chunk.stride;
 	
-	const glmd::int32 xWithOffset = x + glr::terrain::constants::POINT_FIELD_OFFSET;
-	const glmd::int32 yWithOffset = y + glr::terrain::constants::POINT_FIELD_OFFSET;
-	const glmd::int32 zWithOffset = z + glr::terrain::constants::POINT_FIELD_OFFSET;
+	glmd::float32 xs[BATCH_SIZE];
+	glmd::float32 ys[BATCH_SIZE];
+	glmd::float32 zs[BATCH_SIZE];
+	glmd::uint32 count = 0;
 	
-	// Do I need something like the EPSILON_DENSITY?  Error margin or something?  Not 100% why I would need something like this...
-	chunk.points[xWithOffset][yWithOffset][zWithOffset] = fieldFunction.getNoise(fx, fy, fz) + glr::terrain::constants::EPSILON_DENSITY;
-}
-
-void computePoints(glr::terrain::VoxelChunk& chunk, const glm::ivec3& dimensions, glr::terrain::IFieldFunction& fieldFunction)
-{
-	const glmd::int32 min = -1 * glr::terrain::constants::POINT_FIELD_OFFSET;
-	const glmd::int32 max = glr::terrain::constants::SIZE + glr::terrain::constants::POINT_FIELD_OVERSET;
+	// We visit the points in the order they are stored in the density grid (z is the fastest changing dimension), so each batch
+	// of results is written sequentially
+	glmd::float32* densities = chunk.points.getData();
 	
 	for (glmd::int32 x=min; x < max; x++)
 	{
+		const glmd::float32 fx = origin.x + (glmd::float32)x * spacing;
+		
 		for (glmd::int32 y=min; y < max; y++)
 		{
+			const glmd::float32 fy = origin.y + (glmd::float32)y * spacing;
+			
 			for (glmd::int32 z=min; z < max; z++)
 			{
-				computeDensities(chunk, x, y, z, dimensions, fieldFunction);
+				xs[count] = fx;
+				ys[count] = fy;
+				zs[count] = origin.z + (glmd::float32)z * spacing;
+				count++;
+				
+				if (count == BATCH_SIZE)
+				{
+					fieldFunction.getNoiseBatch(xs, ys, zs, densities, count);
+					densities += count;
+					count = 0;
+				}
 			}
 		}
 	}
+	
+	if (count > 0)
+	{
+		fieldFunction.getNoiseBatch(xs, ys, zs, densities, count);
+	}
+	
+	// Do I need something like the EPSILON_DENSITY?  Error margin or something?  Not 100% why I would need something like this...
+	densities = chunk.points.getData();
+	const glmd::uint32 numberOfPoints = chunk.points.getNumberOfPoints();
+	
+	for (glmd::uint32 i=0; i < numberOfPoints; i++)
+	{
+		densities[i] += glr::terrain::constants::EPSILON_DENSITY;
+	}
 }
 
 }
@@ -69,52 +85,104 @@ namespace glr
 namespace terrain
 {
 
+glm::vec3 getChunkOrigin(glm::detail::int32 gridX, glm::detail::int32 gridY, glm::detail::int32 gridZ, const glm::ivec3& dimensions)
+{
+	glmd::float32 fx = (glmd::float32)(gridX * constants::SIZE) * constants::RESOLUTION;
+	glmd::float32 fy = (glmd::float32)(gridY * constants::SIZE) * constants::RESOLUTION;
+	glmd::float32 fz = (glmd::float32)(gridZ * constants::SIZE) * constants::RESOLUTION;
+	
+	const glmd::int32 pointsPerDimension = constants::SIZE * constants::RESOLUTION;
+	
+	// This is making sure that globally our chunks are centered at the origin ((0, 0, 0) in world coodinates)
+	fx -= (glmd::float32)(pointsPerDimension * dimensions.x/2);
+	fy -= (glmd::float32)(pointsPerDimension * dimensions.y/2);
+	fz -= (glmd::float32)(pointsPerDimension * dimensions.z/2);
+	
+	return glm::vec3(fx, fy, fz);
+}
+
 void generateNoise(VoxelChunk& chunk, glm::detail::int32 length, glm::detail::int32 width, glm::detail::int32 height, glr::terrain::IFieldFunction& fieldFunction)
 {
-	allocatePointsMemory(chunk.points);
+	// A stride bigger than the chunk would leave no cubes to mesh
+	chunk.stride = std::max( 1, std::min(chunk.stride, glr::terrain::constants::SIZE) );
+	
+	allocatePointsMemory(chunk.points, chunk.stride);
 	
 	const glm::ivec3 dimensions = glm::ivec3(length, width, height);
 	
 	computePoints(chunk, dimensions, fieldFunction);
 }
 
-#define DENSITY_LOCAL(i, j, k) points[i][j][k]
+bool classifyChunk(VoxelChunk& chunk, glm::detail::int32 length, glm::detail::int32 width, glm::detail::int32 height, glr::terrain::IFieldFunction& fieldFunction)
+{
+	const glm::vec3 origin = getChunkOrigin(chunk.gridX, chunk.gridY, chunk.gridZ, glm::ivec3(length, width, height));
+	
+	// The full resolution density field - lower levels of detail sample a subset of these points for their cubes (their border only
+	// reaches further for normals, which a chunk without cubes never needs)
+	const glm::vec3 min = origin - glm::vec3( (glmd::float32)constants::POINT_FIELD_OFFSET * constants::RESOLUTION );
+	const glm::vec3 max = origin + glm::vec3( (glmd::float32)(constants::SIZE + constants::POINT_FIELD_OVERSET - 1) * constants::RESOLUTION );
+	
+	glmd::float32 minValue = 0.0f;
+	glmd::float32 maxValue = 0.0f;
+	
+	if ( !fieldFunction.getRange(min, max, minValue, maxValue) )
+	{
+		return false;
+	}
+	
+	// The same test as determineIfEmptyOrSolid(), applied to the bounds (generateNoise() adds EPSILON_DENSITY to every point)
+	if (minValue + constants::EPSILON_DENSITY > 0.0f)
+	{
+		chunk.type = CHUNK_TYPE_EMPTY;
+		return true;
+	}
+	
+	if (maxValue + constants::EPSILON_DENSITY <= 0.0f)
+	{
+		chunk.type = CHUNK_TYPE_SOLID;
+		return true;
+	}
+	
+	return false;
+}
+
 bool determineIfEmptyOrSolid(VoxelChunk& chunk)
 {
-	const Points& points = chunk.points;
+	const DensityGrid& points = chunk.points;
 	
 	bool isEmpty = true;
 	bool isSolid = true;
 
-	const glmd::int32 max = constants::SIZE + constants::POINT_FIELD_OFFSET + constants::POINT_FIELD_OVERSET;
+	// The grid is contiguous, so we can walk every point (including the border) in a single loop
+	const glmd::float32* densities = points.getData();
+	const glmd::uint32 numberOfPoints = points.getNumberOfPoints();
 
-	for (glmd::int32 x=0; x < max; x++)
+	for (glmd::uint32 i=0; i < numberOfPoints; i++)
 	{
-		for (glmd::int32 y=0; y < max; y++)
+		if (isEmpty)
 		{
-			for (glmd::int32 z=0; z < max; z++)
-			{
-				if (isEmpty)
-				{
-					if (DENSITY_LOCAL(x, y, z) <= 0.0f)
-						isEmpty = false;
-				}
+			if (densities[i] <= 0.0f)
+				isEmpty = false;
+		}
 
-				if (isSolid)
-				{
-					if (DENSITY_LOCAL(x, y, z) > 0.0f)
-						isSolid = false;
-				}
+		if (isSolid)
+		{
+			if (densities[i] > 0.0f)
+				isSolid = false;
+		}
 
-				if (!isEmpty && !isSolid)
-					return false;
-			}
+		if (!isEmpty && !isSolid)
+		{
+			chunk.type = CHUNK_TYPE_SURFACE;
+			return false;
 		}
 	}
 
 	if (isEmpty && isSolid)
 		assert(0);
 
+	chunk.type = isEmpty ? CHUNK_TYPE_EMPTY : CHUNK_TYPE_SOLID;
+
 	return true;
 }
 
@@ -0,0 +1,177 @@
+#include <cmath>
+
+#include "terrain/dual_contouring/QefSolver.hpp"
+
+/**
+ * Anonymous helper functions.
+ */
+namespace
+{
+
+namespace glmd = glm::detail;
+
+// A 3x3 symmetric matrix converges in a handful of sweeps - we run a fixed number, so the solver never loops for long
+const glmd::int32 NUMBER_OF_SWEEPS = 5;
+
+// Eigenvalues of A^T A below this are treated as zero (the SVD in Qef.cpp drops singular values of A below 0.1, and the eigenvalues of
+// A^T A are the squared singular values of A)
+const glmd::float32 EIGENVALUE_THRESHOLD = 0.1f * 0.1f;
+
+/**
+ * Applies the Jacobi rotation that zeroes a[p][q] to the symmetric matrix a, and accumulates it in the eigenvector matrix v.
+ */
+void rotate(glmd::float32 a[3][3], glmd::float32 v[3][3], glmd::int32 p, glmd::int32 q)
+{
+	const glmd::float32 apq = a[p][q];
+
+	if (std::fabs(apq) < 1e-20f)
+		return;
+
+	const glmd::float32 theta = (a[q][q] - a[p][p]) / (2.0f * apq);
+	const glmd::float32 t = (theta >= 0.0f ? 1.0f : -1.0f) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0f));
+	const glmd::float32 c = 1.0f / std::sqrt(t * t + 1.0f);
+	const glmd::float32 s = t * c;
+
+	a[p][p] -= t * apq;
+	a[q][q] += t * apq;
+	a[p][q] = 0.0f;
+	a[q][p] = 0.0f;
+
+	// The third row/column of the matrix
+	const glmd::int32 k = 3 - p - q;
+	const glmd::float32 akp = a[k][p];
+	const glmd::float32 akq = a[k][q];
+
+	a[k][p] = a[p][k] = c * akp - s * akq;
+	a[k][q] = a[q][k] = s * akp + c * akq;
+
+	for (glmd::int32 i=0; i < 3; i++)
+	{
+		const glmd::float32 vip = v[i][p];
+		const glmd::float32 viq = v[i][q];
+
+		v[i][p] = c * vip - s * viq;
+		v[i][q] = s * vip + c * viq;
+	}
+}
+
+/**
+ * Diagonalizes the symmetric matrix a with cyclic Jacobi sweeps.  Afterwards, the diagonal of a holds the eigenvalues, and the columns of v
+ * the matching eigenvectors.
+ */
+void diagonalize(glmd::float32 a[3][3], glmd::float32 v[3][3])
+{
+	for (glmd::int32 i=0; i < 3; i++)
+		for (glmd::int32 j=0; j < 3; j++)
+			v[i][j] = (i == j ? 1.0f : 0.0f);
+
+	for (glmd::int32 sweep=0; sweep < NUMBER_OF_SWEEPS; sweep++)
+	{
+		rotate(a, v, 0, 1);
+		rotate(a, v, 0, 2);
+		rotate(a, v, 1, 2);
+	}
+}
+
+}
+
+namespace glr
+{
+namespace terrain
+{
+namespace dual_contouring
+{
+
+QefSolver::QefSolver() : atb_(glm::vec3()), btb_(0.0f), massPointSum_(glm::vec3()), numberOfPoints_(0)
+{
+	for (glmd::int32 i=0; i < 6; i++)
+		ata_[i] = 0.0f;
+}
+
+void QefSolver::add(const glm::vec3& point, const glm::vec3& normal)
+{
+	ata_[0] += normal.x * normal.x;
+	ata_[1] += normal.x * normal.y;
+	ata_[2] += normal.x * normal.z;
+	ata_[3] += normal.y * normal.y;
+	ata_[4] += normal.y * normal.z;
+	ata_[5] += normal.z * normal.z;
+
+	const glmd::float32 b = glm::dot(normal, point);
+
+	atb_ += normal * b;
+	btb_ += b * b;
+
+	massPointSum_ += point;
+	numberOfPoints_++;
+}
+
+glm::vec3 QefSolver::solve() const
+{
+	const glm::vec3 massPoint = getMassPoint();
+
+	if (numberOfPoints_ == 0)
+		return massPoint;
+
+	glmd::float32 a[3][3] = {
+		{ ata_[0], ata_[1], ata_[2] },
+		{ ata_[1], ata_[3], ata_[4] },
+		{ ata_[2], ata_[4], ata_[5] }
+	};
+
+	// We solve for the offset from the mass point, so that the directions the pseudo inverse drops leave the result at the mass point
+	const glm::vec3 rhs = atb_ - glm::vec3(
+		a[0][0] * massPoint.x + a[0][1] * massPoint.y + a[0][2] * massPoint.z,
+		a[1][0] * massPoint.x + a[1][1] * massPoint.y + a[1][2] * massPoint.z,
+		a[2][0] * massPoint.x + a[2][1] * massPoint.y + a[2][2] * massPoint.z
+	);
+
+	glmd::float32 v[3][3];
+	diagonalize(a, v);
+
+	// offset = V * D^+ * V^T * rhs
+	glm::vec3 offset = glm::vec3();
+
+	for (glmd::int32 i=0; i < 3; i++)
+	{
+		const glmd::float32 eigenvalue = a[i][i];
+
+		if (std::fabs(eigenvalue) < EIGENVALUE_THRESHOLD)
+			continue;
+
+		const glm::vec3 eigenvector = glm::vec3(v[0][i], v[1][i], v[2][i]);
+
+		offset += eigenvector * (glm::dot(eigenvector, rhs) / eigenvalue);
+	}
+
+	return massPoint + offset;
+}
+
+glmd::float32 QefSolver::getError(const glm::vec3& position) const
+{
+	// x^T A^T A x - 2 x^T A^T b + b^T b
+	const glm::vec3 ataPosition = glm::vec3(
+		ata_[0] * position.x + ata_[1] * position.y + ata_[2] * position.z,
+		ata_[1] * position.x + ata_[3] * position.y + ata_[4] * position.z,
+		ata_[2] * position.x + ata_[4] * position.y + ata_[5] * position.z
+	);
+
+	return glm::dot(position, ataPosition) - 2.0f * glm::dot(position, atb_) + btb_;
+}
+
+glm::vec3 QefSolver::getMassPoint() const
+{
+	if (numberOfPoints_ == 0)
+		return glm::vec3();
+
+	return massPointSum_ / (glmd::float32)numberOfPoints_;
+}
+
+glmd::int32 QefSolver::getNumberOfPoints() const
+{
+	return numberOfPoints_;
+}
+
+}
+}
+}
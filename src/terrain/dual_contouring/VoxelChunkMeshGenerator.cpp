@@ -1,3 +1,4 @@
+#include <utility>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -5,7 +6,7 @@
 
 #include "terrain/dual_contouring/VoxelChunkMeshGenerator.hpp"
 
-#include "terrain/dual_contouring/Qef.hpp"
+#include "terrain/dual_contouring/QefSolver.hpp"
 #include "terrain/Interpolation.hpp"
 
 #include "terrain/Constants.hpp"
@@ -69,13 +70,13 @@ glmd::int32 edgeTable_[256] = {
  * 
  * @return True if space is totally empty or solid; false otherwise.
  */
-bool VoxelChunkMeshGenerator::isEmptyOrSolid(const Points& points) const
+bool VoxelChunkMeshGenerator::isEmptyOrSolid(const DensityGrid& points) const
 {
 	bool isEmpty = true;
 	bool isSolid = true;
 	
-	const glmd::int32 min = constants::POINT_FIELD_OFFSET;
-	const glmd::int32 max = settings_.blockSize + 1 + constants::POINT_FIELD_OFFSET;
+	const glmd::int32 min = 0;
+	const glmd::int32 max = settings_.blockSize + 1;
 	
 	for (glmd::int32 x=min; x < max; x++)
 	{
@@ -83,15 +84,17 @@ bool VoxelChunkMeshGenerator::isEmptyOrSolid(const Points& points) const
 		{
 			for (glmd::int32 z=min; z < max; z++)
 			{
+				const glmd::float32 density = points.get(x, y, z);
+				
 				if (isEmpty)
 				{
-					if (points[x][y][z] <= 0.0f)
+					if (density <= 0.0f)
 						isEmpty = false;
 				}
 				
 				if (isSolid)
 				{
-					if (points[x][y][z] > 0.0f)
+					if (density > 0.0f)
 						isSolid = false;
 				}
 				
@@ -110,13 +113,13 @@ bool VoxelChunkMeshGenerator::isEmptyOrSolid(const Points& points) const
 /**
  * Get noise at the point x, y, z on the grid with the given coordinates.
  */
-glmd::float32 VoxelChunkMeshGenerator::getInterpolatedNoise(const Points& points, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, glmd::float32 x, glmd::float32 y, glmd::float32 z) const
+glmd::float32 VoxelChunkMeshGenerator::getInterpolatedNoise(const DensityGrid& points, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, glmd::float32 x, glmd::float32 y, glmd::float32 z) const
 {
 	return fieldFunction_->getNoise(x, y, z);
 
 	// Note: Below was an attempt at using trilinear interpolation to get the interpolated noise value
 	/*
-#define DENSITY_AT(i,j,k) points[iXStart+i+constants::POINT_FIELD_OFFSET][iYStart+j+constants::POINT_FIELD_OFFSET][iZStart+k+constants::POINT_FIELD_OFFSET]
+#define DENSITY_AT(i,j,k) points.get(iXStart+i, iYStart+j, iZStart+k)
 #define POSITION_X_AT(i) ((glmd::float32)(i*settings_.resolution) + (glmd::float32)(settings_.chunkSize*gridX))
 #define POSITION_Y_AT(i) ((glmd::float32)(i*settings_.resolution) + (glmd::float32)(settings_.chunkSize*gridY))
 #define POSITION_Z_AT(i) ((glmd::float32)(i*settings_.resolution) + (glmd::float32)(settings_.chunkSize*gridZ))
@@ -206,14 +209,19 @@ glmd::float32 VoxelChunkMeshGenerator::getInterpolatedNoise(const Points& points
 /**
  * Calculate the normal for the provided point.
  */
-glm::vec3 VoxelChunkMeshGenerator::calculateNormal(const glm::vec3& point, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const Points& densityValues) const
+glm::vec3 VoxelChunkMeshGenerator::calculateNormal(const glm::vec3& point, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const DensityGrid& densityValues) const
 {
-	glmd::float32 d = getInterpolatedNoise(densityValues, gridCoords, dimensions, point.x, point.y, point.z);
-	glmd::float32 nx = getInterpolatedNoise(densityValues, gridCoords, dimensions, point.x + glr::terrain::constants::EPSILON_VALUE, point.y, point.z) - d;
-	glmd::float32 ny = getInterpolatedNoise(densityValues, gridCoords, dimensions, point.x, point.y + glr::terrain::constants::EPSILON_VALUE, point.z) - d;
-	glmd::float32 nz = getInterpolatedNoise(densityValues, gridCoords, dimensions, point.x, point.y, point.z + glr::terrain::constants::EPSILON_VALUE) - d;
+	const glmd::float32 e = glr::terrain::constants::EPSILON_VALUE;
+	
+	// The point, and the point moved a little along each axis
+	const glmd::float32 xs[4] = { point.x, point.x + e, point.x, point.x };
+	const glmd::float32 ys[4] = { point.y, point.y, point.y + e, point.y };
+	const glmd::float32 zs[4] = { point.z, point.z, point.z, point.z + e };
+	glmd::float32 densities[4];
 	
-	glm::vec3 normal = glm::vec3(nx, ny, nz);
+	fieldFunction_->getNoiseBatch(xs, ys, zs, densities, 4);
+	
+	glm::vec3 normal = glm::vec3(densities[1] - densities[0], densities[2] - densities[0], densities[3] - densities[0]);
 
 	if (normal == glm::vec3(0.0f, 0.0f, 0.0f))
 		return glm::vec3(0.0f, 1.0f, 0.0f);
@@ -224,7 +232,7 @@ glm::vec3 VoxelChunkMeshGenerator::calculateNormal(const glm::vec3& point, const
 /**
  * Find the intersection along the x-axis where the line segment between p0 and p1 would intersect with the isosurface.
  */
-void VoxelChunkMeshGenerator::intersectXAxis(Point& p0, Point& p1, Point& out, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const Points& densityValues) const
+void VoxelChunkMeshGenerator::intersectXAxis(Point& p0, Point& p1, Point& out, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const DensityGrid& densityValues) const
 {
 	glmd::float32 fa, fb;
 	glmd::float32 xa, xb;
@@ -310,7 +318,7 @@ void VoxelChunkMeshGenerator::intersectXAxis(Point& p0, Point& p1, Point& out, c
 /**
  * Find the intersection along the y-axis where the line segment between p0 and p1 would intersect with the isosurface.
  */
-void VoxelChunkMeshGenerator::intersectYAxis(Point& p0, Point& p1, Point& out, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const Points& densityValues) const
+void VoxelChunkMeshGenerator::intersectYAxis(Point& p0, Point& p1, Point& out, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const DensityGrid& densityValues) const
 {
 	glmd::float32 fa, fb;
 	glmd::float32 ya, yb;
@@ -396,7 +404,7 @@ void VoxelChunkMeshGenerator::intersectYAxis(Point& p0, Point& p1, Point& out, c
 /**
  * Find the intersection along the z-axis where the line segment between p0 and p1 would intersect with the isosurface.
  */
-void VoxelChunkMeshGenerator::intersectZAxis(Point& p0, Point& p1, Point& out, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const Points& densityValues) const
+void VoxelChunkMeshGenerator::intersectZAxis(Point& p0, Point& p1, Point& out, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const DensityGrid& densityValues) const
 {
 	glmd::float32 fa, fb;
 	glmd::float32 za, zb;
@@ -478,10 +486,55 @@ void VoxelChunkMeshGenerator::intersectZAxis(Point& p0, Point& p1, Point& out, c
 	out.pos = glm::vec3(x, y, zm);
 }
 
+/**
+ * Returns the Hermite data for the edge of block (x, y, z) between the given corners of the block, intersecting the edge if it isn't
+ * in the cache yet.
+ */
+const VoxelChunkMeshGenerator::HermiteData& VoxelChunkMeshGenerator::getEdgeIntersection(Block& block, glmd::int32 x, glmd::int32 y, glmd::int32 z, const glmd::int32* corner0, const glmd::int32* corner1,
+	HermiteEdgeCache& hermiteEdges, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const DensityGrid& densityValues) const
+{
+	// An edge is identified by its lower grid point and its axis - the same edge seen from a neighbouring block has the same key
+	if (corner1[0] < corner0[0] || corner1[1] < corner0[1] || corner1[2] < corner0[2])
+		std::swap(corner0, corner1);
+	
+	const glmd::int32 axis = (corner0[0] != corner1[0]) ? 0 : ((corner0[1] != corner1[1]) ? 1 : 2);
+	const glmd::int32 dimension = hermiteEdges.dimension;
+	const glmd::int32 key = (((x + corner0[0]) * dimension + (y + corner0[1])) * dimension + (z + corner0[2])) * 3 + axis;
+	
+	if (hermiteEdges.indices[key] >= 0)
+		return hermiteEdges.edges[ hermiteEdges.indices[key] ];
+	
+	Point& p0 = block.points[corner0[0]][corner0[1]][corner0[2]];
+	Point& p1 = block.points[corner1[0]][corner1[1]][corner1[2]];
+	Point intersection;
+	
+	if (fabs(p0.density) < glr::terrain::constants::EPSILON_VALUE)
+		intersection = p0;
+	else if (fabs(p1.density) < glr::terrain::constants::EPSILON_VALUE)
+		intersection = p1;
+	else if (fabs(p0.density - p1.density) < glr::terrain::constants::EPSILON_VALUE)
+		intersection = p0;
+	else if (axis == 0)
+		intersectXAxis(p0, p1, intersection, gridCoords, dimensions, densityValues);
+	else if (axis == 1)
+		intersectYAxis(p0, p1, intersection, gridCoords, dimensions, densityValues);
+	else
+		intersectZAxis(p0, p1, intersection, gridCoords, dimensions, densityValues);
+	
+	HermiteData edge;
+	edge.pos = intersection.pos;
+	edge.normal = calculateNormal(intersection.pos, gridCoords, dimensions, densityValues);
+	
+	hermiteEdges.indices[key] = (glmd::int32)hermiteEdges.edges.size();
+	hermiteEdges.edges.push_back( edge );
+	
+	return hermiteEdges.edges.back();
+}
+
 /**
  * Generate the vertex for the given block at position x, y, z.
  */
-void VoxelChunkMeshGenerator::generateVertex(Blocks& blocks, glmd::int32 x, glmd::int32 y, glmd::int32 z, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const Points& densityValues) const
+void VoxelChunkMeshGenerator::generateVertex(Blocks& blocks, HermiteEdgeCache& hermiteEdges, glmd::int32 x, glmd::int32 y, glmd::int32 z, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const DensityGrid& densityValues) const
 {
 	//
 	// Part 1: Compute intersection points and their normals.
@@ -490,126 +543,43 @@ void VoxelChunkMeshGenerator::generateVertex(Blocks& blocks, glmd::int32 x, glmd
 		{ {0,0,0}, {1,0,0} }, { {1,0,0}, {1,1,0} }, { {1,1,0}, {0,1,0} }, { {0,1,0}, {0,0,0} }, { {0,0,1}, {1,0,1} }, { {1,0,1}, {1,1,1} },
 		{ {1,1,1}, {0,1,1} }, { {0,1,1}, {0,0,1} }, { {0,0,0}, {0,0,1} }, { {1,0,0}, {1,0,1} }, { {1,1,0}, {1,1,1} }, { {0,1,0}, {0,1,1} }
 	};
-
-/*
-	static glmd::int32 intersections[12][2] = {
-		{ 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 }, { 4, 5 }, { 5, 6 },
-		{ 6, 7 }, { 7, 4 }, { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 }
-	};
-*/
-	glmd::int32 edgeInfo = edgeTable_[blocks[x][y][z].index];
-	
-	Point points[12];
-	glm::vec3 normals[12];
-	glm::vec3 massPoint;
-	glmd::int32 numIntersections = 0;
-
-// if (edgeInfo & (1 << n)) --> If the contour intersects the edge, process it
-#define CALCULATE_NORMALS_AND_MASS_POINT(n)\
-	if (edgeInfo & (1 << n))\
-	{\
-		glmd::int32 n1[3];\
-		n1[0] = intersections[n][0][0];\
-		n1[1] = intersections[n][0][1];\
-		n1[2] = intersections[n][0][2];\
-		glmd::int32 n2[3];\
-		n2[0] = intersections[n][1][0];\
-		n2[1] = intersections[n][1][1];\
-		n2[2] = intersections[n][1][2];\
-\
-		if (fabs(blocks[x][y][z].points[n1[0]][n1[1]][n1[2]].density) < glr::terrain::constants::EPSILON_VALUE)\
-			points[n] = blocks[x][y][z].points[n1[0]][n1[1]][n1[2]];\
-		else if (fabs(blocks[x][y][z].points[n2[0]][n2[1]][n2[2]].density) < glr::terrain::constants::EPSILON_VALUE)\
-			points[n] = blocks[x][y][z].points[n2[0]][n2[1]][n2[2]];\
-		else if (fabs(blocks[x][y][z].points[n1[0]][n1[1]][n1[2]].density - blocks[x][y][z].points[n2[0]][n2[1]][n2[2]].density) < glr::terrain::constants::EPSILON_VALUE)\
-			points[n] = blocks[x][y][z].points[n1[0]][n1[1]][n1[2]];\
-		else\
-		{\
-			glm::vec3 vDiff = blocks[x][y][z].points[n1[0]][n1[1]][n1[2]].pos - blocks[x][y][z].points[n2[0]][n2[1]][n2[2]].pos;\
-			vDiff = glm::vec3( fabs(vDiff.x), fabs(vDiff.y), fabs(vDiff.z) );\
-			if (vDiff.x > glr::terrain::constants::EPSILON_VALUE)\
-				intersectXAxis(blocks[x][y][z].points[n1[0]][n1[1]][n1[2]], blocks[x][y][z].points[n2[0]][n2[1]][n2[2]], points[n], gridCoords, dimensions, densityValues);\
-			else if (vDiff.y > glr::terrain::constants::EPSILON_VALUE)\
-				intersectYAxis(blocks[x][y][z].points[n1[0]][n1[1]][n1[2]], blocks[x][y][z].points[n2[0]][n2[1]][n2[2]], points[n], gridCoords, dimensions, densityValues);\
-			else if (vDiff.z > glr::terrain::constants::EPSILON_VALUE)\
-				intersectZAxis(blocks[x][y][z].points[n1[0]][n1[1]][n1[2]], blocks[x][y][z].points[n2[0]][n2[1]][n2[2]], points[n], gridCoords, dimensions, densityValues);\
-		}\
-\
-		normals[n] = calculateNormal(points[n].pos, gridCoords, dimensions, densityValues);\
-\
-		massPoint += points[n].pos;\
-		numIntersections++;\
-	}
-
-/*
-CORNER(0,  0,0,0);
-CORNER(1,  1,0,0);
-CORNER(2,  1,1,0);
-CORNER(3,  0,1,0);
-CORNER(4,  0,0,1);
-CORNER(5,  1,0,1);
-CORNER(6,  1,1,1);
-CORNER(7,  0,1,1);
- */
-	CALCULATE_NORMALS_AND_MASS_POINT(0)
-	CALCULATE_NORMALS_AND_MASS_POINT(1)
-	CALCULATE_NORMALS_AND_MASS_POINT(2)
-	CALCULATE_NORMALS_AND_MASS_POINT(3)
-	CALCULATE_NORMALS_AND_MASS_POINT(4)
-	CALCULATE_NORMALS_AND_MASS_POINT(5)
-	CALCULATE_NORMALS_AND_MASS_POINT(6)
-	CALCULATE_NORMALS_AND_MASS_POINT(7)
-	CALCULATE_NORMALS_AND_MASS_POINT(8)
-	CALCULATE_NORMALS_AND_MASS_POINT(9)
-	CALCULATE_NORMALS_AND_MASS_POINT(10)
-	CALCULATE_NORMALS_AND_MASS_POINT(11)
-	
-	massPoint /= (glmd::float32)numIntersections;
-
-	//
-	// Part 2: Compute the QEF-minimizing point
-	//
 	
+	Block& block = blocks[x][y][z];
+	glmd::int32 edgeInfo = edgeTable_[block.index];
+	
+	// The QEF is accumulated relative to the corner of the block, so that float32 keeps its precision far away from the world origin
+	const glm::vec3 blockOrigin = block.points[0][0][0].pos;
+	
+	auto qef = QefSolver();
 	glm::vec3 newPointNormal = glm::vec3(0.0f, 0.0f, 0.0f);
 	
-	glmd::float64 matrix[12][3];
-	glmd::float64 vector[12];
-	glmd::int32 rows = 0;
-
 	for (glmd::int32 i = 0; i < 12; i++)
 	{
 		// If the contour does not intersect the edge, skip it
 		if (! (edgeInfo & (1 << i)))
 			continue;
-
-		const glm::vec3& normal = normals[i];
-
-		matrix[rows][0] = normal.x;
-		matrix[rows][1] = normal.y;
-		matrix[rows][2] = normal.z;
-
-		glm::vec3 p = points[i].pos - massPoint;
-		vector[rows] = (glmd::float64)glm::dot(normal, p);
-
-		rows++;
-
-		newPointNormal += normal;
+		
+		const HermiteData& edge = getEdgeIntersection(block, x, y, z, intersections[i][0], intersections[i][1], hermiteEdges, gridCoords, dimensions, densityValues);
+		
+		qef.add(edge.pos - blockOrigin, edge.normal);
+		
+		newPointNormal += edge.normal;
 	}
 	
-	glm::vec3 newPointV = evaluate(matrix, vector, rows);
+	//
+	// Part 2: Compute the QEF-minimizing point
+	//
+	block.meshPoint = qef.solve() + blockOrigin;
 	
-	newPointV += massPoint;
-
-	blocks[x][y][z].meshPoint = newPointV;
 	if (newPointNormal == glm::vec3(0.0f, 0.0f, 0.0f))
 		newPointNormal = glm::vec3(0.0f, 1.0f, 0.0f);
-	blocks[x][y][z].meshPointNormal = glm::normalize( newPointNormal );
+	block.meshPointNormal = glm::normalize( newPointNormal );
 }
 
 /**
  * Determine if the cubes along the xz plane at point y have an intersection.  If a cube does, generate the vertex for that block.
  */
-void VoxelChunkMeshGenerator::computeCubes(Blocks& blocks, glmd::int32 y, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const Points& densityValues) const
+void VoxelChunkMeshGenerator::computeCubes(Blocks& blocks, HermiteEdgeCache& hermiteEdges, glmd::int32 y, const glm::ivec3& gridCoords, const glm::ivec3& dimensions, const DensityGrid& densityValues) const
 {	
 	for (glmd::int32 x = 0; x < settings_.blockSize+1; x++)
 	{
@@ -633,6 +603,8 @@ void VoxelChunkMeshGenerator::computeCubes(Blocks& blocks, glmd::int32 y, const
 			// What I think this is doing:
 			// If the configuration of vertices that lie outside the contour does not match any of the
 			// special cases in the edge table, we don't need to create a vertex for this block
+			blocks[x][y][z].vertexIndex = -1;
+			
 			if (edgeTable_[index] == 0)
 			{
 				blocks[x][y][z].index = 0;
@@ -640,7 +612,7 @@ void VoxelChunkMeshGenerator::computeCubes(Blocks& blocks, glmd::int32 y, const
 			}
 			
 			blocks[x][y][z].index = index;
-			generateVertex(blocks, x, y, z, gridCoords, dimensions, densityValues);
+			generateVertex(blocks, hermiteEdges, x, y, z, gridCoords, dimensions, densityValues);
 		}
 
 	}
@@ -729,7 +701,7 @@ void VoxelChunkMeshGenerator::generateTriangles(Blocks& blocks, std::vector<glm:
 /**
  * Set the densities and positions for the blocks, using the provided points (density values) and the grid coordinates.
  */
-void VoxelChunkMeshGenerator::setDensitiesAndPositions(Blocks& blocks, const Points& points, const glm::ivec3& gridCoords, const glm::ivec3& dimensions) const
+void VoxelChunkMeshGenerator::setDensitiesAndPositions(Blocks& blocks, const DensityGrid& points, const glm::ivec3& gridCoords, const glm::ivec3& dimensions) const
 {
 	const glmd::int32 pointsPerDimension = settings_.blockSize * settings_.resolution;
 	
@@ -742,7 +714,7 @@ void VoxelChunkMeshGenerator::setDensitiesAndPositions(Blocks& blocks, const Poi
 	fy -= (glmd::float32)(pointsPerDimension * dimensions.y/2);
 	fz -= (glmd::float32)(pointsPerDimension * dimensions.z/2);
 
-#define SET_DENSITY(x, y, z, i, j, k) blocks[x][y][z].points[i][j][k].density = points[x+i+constants::POINT_FIELD_OFFSET][y+j+constants::POINT_FIELD_OFFSET][z+k+constants::POINT_FIELD_OFFSET];
+#define SET_DENSITY(x, y, z, i, j, k) blocks[x][y][z].points[i][j][k].density = points.get(x+i, y+j, z+k);
 #define SET_POSITION(x, y, z, i, j, k)\
 	blocks[x][y][z].points[i][j][k].pos.x = fx + (glmd::float32)(i * settings_.resolution);\
 	blocks[x][y][z].points[i][j][k].pos.y = fy + (glmd::float32)(j * settings_.resolution);\
@@ -805,9 +777,21 @@ void VoxelChunkMeshGenerator::resizeBlocks(Blocks& blocks) const
 	}
 }
 
+/**
+ * Will clear the provided cache, and size it for the grid points of the blocks.
+ */
+void VoxelChunkMeshGenerator::resetHermiteEdges(HermiteEdgeCache& hermiteEdges) const
+{
+	// The blocks cover grid points 0 to blockSize+1 (inclusive) along each axis
+	hermiteEdges.dimension = settings_.blockSize + 2;
+	
+	hermiteEdges.indices.assign( hermiteEdges.dimension * hermiteEdges.dimension * hermiteEdges.dimension * 3, -1 );
+	hermiteEdges.edges.clear();
+}
+
 void VoxelChunkMeshGenerator::generateMesh(VoxelChunk& chunk, glm::detail::int32 length, glm::detail::int32 width, glm::detail::int32 height, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, std::vector<glm::vec4>& textureBlendingValues) const
 {	
-	const Points& points = chunk.points;
+	const DensityGrid& points = chunk.points;
 	glmd::int32 gridX = chunk.gridX;
 	glmd::int32 gridY = chunk.gridY;
 	glmd::int32 gridZ = chunk.gridZ;
@@ -824,18 +808,136 @@ void VoxelChunkMeshGenerator::generateMesh(VoxelChunk& chunk, glm::detail::int32
 	resizeBlocks(blocks);
 	
 	setDensitiesAndPositions(blocks, points, gridCoords, dimensions);
+	
+	auto hermiteEdges = HermiteEdgeCache();
+	resetHermiteEdges(hermiteEdges);
 
-	computeCubes(blocks, 0, gridCoords, dimensions, points);
+	computeCubes(blocks, hermiteEdges, 0, gridCoords, dimensions, points);
 	
 	for (glmd::int32 y = 1; y < settings_.blockSize+1; y++)
 	{
-		computeCubes(blocks, y, gridCoords, dimensions, points);
+		computeCubes(blocks, hermiteEdges, y, gridCoords, dimensions, points);
 		
 		generateTriangles(blocks, vertices, normals, y-1);
 	}
 	
-	// Calculate texture blending values
-	textureBlendingValues.resize( vertices.size() );
+	calculateTextureBlendingValues(normals, textureBlendingValues);
+}
+
+void VoxelChunkMeshGenerator::generateMesh(VoxelChunk& chunk, glm::detail::int32 length, glm::detail::int32 width, glm::detail::int32 height, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, std::vector<glm::vec4>& textureBlendingValues, std::vector<glm::detail::uint32>& indices) const
+{
+	const DensityGrid& points = chunk.points;
+	
+	if (isEmptyOrSolid(points))
+		return;
+	
+	glm::ivec3 gridCoords = glm::ivec3(chunk.gridX, chunk.gridY, chunk.gridZ);
+	glm::ivec3 dimensions = glm::ivec3(length, width, height);
+	
+	auto blocks = Blocks();
+	
+	resizeBlocks(blocks);
+	
+	setDensitiesAndPositions(blocks, points, gridCoords, dimensions);
+	
+	auto hermiteEdges = HermiteEdgeCache();
+	resetHermiteEdges(hermiteEdges);
+
+	computeCubes(blocks, hermiteEdges, 0, gridCoords, dimensions, points);
+	
+	for (glmd::int32 y = 1; y < settings_.blockSize+1; y++)
+	{
+		computeCubes(blocks, hermiteEdges, y, gridCoords, dimensions, points);
+		
+		generateIndexedTriangles(blocks, vertices, normals, indices, y-1);
+	}
+	
+	calculateTextureBlendingValues(normals, textureBlendingValues);
+}
+
+/**
+ * Generate the indexed triangles along the y coordinate (will move along the xz plane at point y).
+ * 
+ * This follows the same steps as generateTriangles, but references the blocks instead of copying their mesh points.
+ */
+void VoxelChunkMeshGenerator::generateIndexedTriangles(Blocks& blocks, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, std::vector<glm::detail::uint32>& indices, glmd::int32 y) const
+{
+	Block* blocksTemp[4];
+
+	for (glmd::int32 x = 0; x < settings_.blockSize; x++)
+	{
+		for (glmd::int32 z = 0; z < settings_.blockSize; z++)
+		{
+			blocksTemp[0] = &blocks[x][y][z];
+			glmd::int32 cube0_edgeInfo = edgeTable_[blocksTemp[0]->index];
+			glmd::int32 flip_if_nonzero = 0;
+
+			for (glmd::int32 i = 0; i < 3; i++)
+			{
+				if (i == 0 && cube0_edgeInfo & (1 << 10))
+				{
+					blocksTemp[1] = &blocks[x+1][y][z];
+					blocksTemp[2] = &blocks[x+1][y+1][z];
+					blocksTemp[3] = &blocks[x][y+1][z];
+					flip_if_nonzero = (blocksTemp[0]->index & (1 << 6));
+				} else if (i == 1 && cube0_edgeInfo & (1 << 6))
+				{
+					blocksTemp[1] = &blocks[x][y][z+1];
+					blocksTemp[2] = &blocks[x][y+1][z+1];
+					blocksTemp[3] = &blocks[x][y+1][z];
+					flip_if_nonzero = (blocksTemp[0]->index & (1 << 7));
+				} else if (i == 2 && cube0_edgeInfo & (1 << 5))
+				{
+					blocksTemp[1] = &blocks[x+1][y][z];
+					blocksTemp[2] = &blocks[x+1][y][z+1];
+					blocksTemp[3] = &blocks[x][y][z+1];
+					flip_if_nonzero = (blocksTemp[0]->index & (1 << 5));
+				} else
+					continue;
+
+				const glm::detail::uint32 i0 = getBlockVertex(*blocksTemp[0], vertices, normals);
+
+				for (glmd::int32 j = 1; j < 3; j++)
+				{
+					glmd::int32 ja = 0;
+					glmd::int32 jb = 0;
+					if (flip_if_nonzero)
+					{
+						ja = j + 0;
+						jb = j + 1;
+					} else
+					{
+						ja = j + 1;
+						jb = j + 0;
+					}
+
+					indices.push_back( getBlockVertex(*blocksTemp[jb], vertices, normals) );
+					indices.push_back( getBlockVertex(*blocksTemp[ja], vertices, normals) );
+					indices.push_back( i0 );
+				}
+			}
+		}
+	}
+}
+
+glm::detail::uint32 VoxelChunkMeshGenerator::getBlockVertex(Block& block, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals) const
+{
+	if (block.vertexIndex < 0)
+	{
+		vertices.push_back( block.meshPoint );
+		normals.push_back( block.meshPointNormal );
+		block.vertexIndex = (glmd::int32)(vertices.size() - 1);
+	}
+	
+	return (glm::detail::uint32)block.vertexIndex;
+}
+
+/**
+ * Calculate the texture blending values for the provided normals.
+ */
+void VoxelChunkMeshGenerator::calculateTextureBlendingValues(const std::vector<glm::vec3>& normals, std::vector<glm::vec4>& textureBlendingValues) const
+{
+	textureBlendingValues.resize( normals.size() );
 	for ( glmd::uint32 i=0; i < textureBlendingValues.size(); i++)
 	{
 		auto& v = textureBlendingValues[i];
@@ -854,7 +956,7 @@ void VoxelChunkMeshGenerator::generateMesh(VoxelChunk& chunk, glm::detail::int32
 		
 		v.z = 1.0f;
 		v.a = 1.0f;
-	}	
+	}
 }
 
 }
@@ -2,6 +2,9 @@
 #include <sstream>
 #include <fstream>
 #include <mutex>
+#include <algorithm>
+#include <unordered_set>
+#include <unordered_map>
 
 #define GLM_FORCE_RADIANS
 #include <glm/gtx/vector_angle.hpp>
@@ -387,6 +390,28 @@ int triTable[256][16] = {
 {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}
 };
 
+/*
+	int edgeStart[12][4] holds, for each of the 12 edges of a cube, the offset
+	of the lower end point of the edge from the (0, 0, 0) corner of the cube,
+	followed by the axis the edge runs along (0 = x, 1 = y, 2 = z).  Using
+	the lower end point means that neighbouring cubes agree on the identity
+	of a shared edge, which lets us generate each vertex only once.
+*/
+int edgeStart[12][4] = {
+{0, 0, 1, 0},
+{1, 0, 0, 2},
+{0, 0, 0, 0},
+{0, 0, 0, 2},
+{0, 1, 1, 0},
+{1, 1, 0, 2},
+{0, 1, 0, 0},
+{0, 1, 0, 2},
+{0, 0, 1, 1},
+{1, 0, 1, 1},
+{1, 0, 0, 1},
+{0, 0, 0, 1}
+};
+
 /**
  * Determines whether the points provided define a a fully solid space or a totally empty space.
  * 
@@ -394,9 +419,9 @@ int triTable[256][16] = {
  * 
  * @return True if space is totally empty or solid; false otherwise.
  */
-bool VoxelChunkMeshGenerator::isEmptyOrSolid(const Points& points) const
+bool VoxelChunkMeshGenerator::isEmptyOrSolid(const DensityGrid& points) const
 {
-	if (points.size() == 0 || points[0].size() == 0 || points[0][0].size() == 0)
+	if (points.getNumberOfPoints() == 0)
 	{
 		// Error
 		const std::string message = std::string("Invalid point field - must have at least 1 point in all 3 dimensions.");
@@ -407,34 +432,31 @@ bool VoxelChunkMeshGenerator::isEmptyOrSolid(const Points& points) const
 	bool isEmpty = true;
 	bool isSolid = true;
 	
-	for (glmd::int32 x=0; x < points.size(); x++)
+	const glmd::float32* densities = points.getData();
+	const glmd::uint32 numberOfPoints = points.getNumberOfPoints();
+	
+	for (glmd::uint32 i=0; i < numberOfPoints; i++)
 	{
-		for (glmd::int32 y=0; y < points[0].size(); y++)
+		if (isEmpty)
 		{
-			for (glmd::int32 z=0; z < points[0][0].size(); z++)
+			if (densities[i] <= 0.0f)
 			{
-				if (isEmpty)
-				{
-					if (points[x][y][z] <= 0.0f)
-					{
-						isEmpty = false;
-					}
-				}
-				
-				if (isSolid)
-				{
-					if (points[x][y][z] > 0.0f)
-					{
-						isSolid = false;
-					}
-				}
-				
-				if (!isEmpty && !isSolid)
-				{
-					return false;
-				}
+				isEmpty = false;
+			}
+		}
+		
+		if (isSolid)
+		{
+			if (densities[i] > 0.0f)
+			{
+				isSolid = false;
 			}
 		}
+		
+		if (!isEmpty && !isSolid)
+		{
+			return false;
+		}
 	}
 	
 	if (isEmpty && isSolid)
@@ -449,7 +471,7 @@ bool VoxelChunkMeshGenerator::isEmptyOrSolid(const Points& points) const
  * Generate the triangles for cubes (aka 'blocks') along the y coordinate (will move along the xz plane at point y).
  * 
  */
-void VoxelChunkMeshGenerator::generateTriangles(Blocks& blocks, const Points& points, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, glmd::int32 y) const
+void VoxelChunkMeshGenerator::generateTriangles(Blocks& blocks, const DensityGrid& points, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, glmd::int32 y) const
 {
 	for (glmd::int32 x = 0; x < settings_.blockSize; x++)
 	{
@@ -630,25 +652,14 @@ glm::vec3 VoxelChunkMeshGenerator::calculateSimpleNormal(const glm::vec3& p1, co
 /**
  * Calculate the normal for the vertex that lies along the edge defined by vertex (x1, y1, z1) and (x2, y2, z2).
  */
-glm::vec3 VoxelChunkMeshGenerator::calculateNormal(int x1, int y1, int z1, int x2, int y2, int z2, const Points& densityValues) const
+glm::vec3 VoxelChunkMeshGenerator::calculateNormal(int x1, int y1, int z1, int x2, int y2, int z2, const DensityGrid& densityValues) const
 {
-	if (constants::POINT_FIELD_OFFSET <= 0)
-	{
-		if (x1 <=0 || y1 <= 0 || z1 <=0)
-		{
-			return glm::vec3();
-		}
-		if (x2 <=0 || y2 <= 0 || z2 <=0)
-		{
-			return glm::vec3();
-		}
-	}
-	
-	if (x1+1 >= densityValues.size() || y1+1 >= densityValues[0].size() || z1+1 >= densityValues[0][0].size())
+	// Both gradients need their neighbouring points to be inside the density field (including the border)
+	if (!densityValues.isInBounds(x1-1, y1-1, z1-1) || !densityValues.isInBounds(x1+1, y1+1, z1+1))
 	{
 		return glm::vec3();
 	}
-	if (x2+1 >= densityValues.size() || y2+1 >= densityValues[0].size() || z2+1 >= densityValues[0][0].size())
+	if (!densityValues.isInBounds(x2-1, y2-1, z2-1) || !densityValues.isInBounds(x2+1, y2+1, z2+1))
 	{
 		return glm::vec3();
 	}
@@ -656,8 +667,8 @@ glm::vec3 VoxelChunkMeshGenerator::calculateNormal(int x1, int y1, int z1, int x
 	glm::vec3 gradient1 = calculateGradientVector(x1, y1, z1, densityValues);
 	glm::vec3 gradient2 = calculateGradientVector(x2, y2, z2, densityValues);
 	
-	const double valp1 = densityValues[x1+constants::POINT_FIELD_OFFSET][y1+constants::POINT_FIELD_OFFSET][z1+constants::POINT_FIELD_OFFSET];
-	const double valp2 = densityValues[x2+constants::POINT_FIELD_OFFSET][y2+constants::POINT_FIELD_OFFSET][z2+constants::POINT_FIELD_OFFSET];
+	const double valp1 = densityValues.get(x1, y1, z1);
+	const double valp2 = densityValues.get(x2, y2, z2);
 	const double mu = (ISOLEVEL - valp1) / (valp2 - valp1);
 	
 	glm::vec3 out = glm::mix(gradient1, gradient2, mu);
@@ -671,17 +682,9 @@ glm::vec3 VoxelChunkMeshGenerator::calculateNormal(int x1, int y1, int z1, int x
  * 
  * Code based off of: http://www.angelfire.com/linux/myp/MCAdvanced/MCImproved.html
  */
-glm::vec3 VoxelChunkMeshGenerator::calculateGradientVector(int x, int y, int z, const Points& densityValues) const
+glm::vec3 VoxelChunkMeshGenerator::calculateGradientVector(int x, int y, int z, const DensityGrid& densityValues) const
 {
-	if (constants::POINT_FIELD_OFFSET <= 0)
-	{
-		if (x <=0 || y <= 0 || z <=0)
-		{
-			return glm::vec3();
-		}
-	}
-	
-	if (x+1 >= densityValues.size() || y+1 >= densityValues[0].size() || z+1 >= densityValues[0][0].size())
+	if (!densityValues.isInBounds(x-1, y-1, z-1) || !densityValues.isInBounds(x+1, y+1, z+1))
 	{
 		return glm::vec3();
 	}
@@ -689,21 +692,15 @@ glm::vec3 VoxelChunkMeshGenerator::calculateGradientVector(int x, int y, int z,
 	glm::vec3 gradient = glm::vec3();
 	const glm::detail::float32 scale = 1.0f;
 	
-	//gradient.x = (densityValues[x-1][y][z] - densityValues[x+1][y][z]) / scale;
-	//gradient.y = (densityValues[x][y-1][z] - densityValues[x][y+1][z]) / scale;
-	//gradient.z = (densityValues[x][y][z-1] - densityValues[x][y][z+1]) / scale;
-	
-	gradient.x = (
-			densityValues[x-1+constants::POINT_FIELD_OFFSET][y+constants::POINT_FIELD_OFFSET][z+constants::POINT_FIELD_OFFSET]
-			-
-			densityValues[x+1+constants::POINT_FIELD_OFFSET][y+constants::POINT_FIELD_OFFSET][z+constants::POINT_FIELD_OFFSET]
-		) / scale;
-	gradient.y = (densityValues[x+constants::POINT_FIELD_OFFSET][y-1+constants::POINT_FIELD_OFFSET][z+constants::POINT_FIELD_OFFSET] 
-		- densityValues[x+constants::POINT_FIELD_OFFSET][y+1+constants::POINT_FIELD_OFFSET][z+constants::POINT_FIELD_OFFSET]) 
-		/ scale;
-	gradient.z = (densityValues[x+constants::POINT_FIELD_OFFSET][y+constants::POINT_FIELD_OFFSET][z-1+constants::POINT_FIELD_OFFSET] 
-		- densityValues[x+constants::POINT_FIELD_OFFSET][y+constants::POINT_FIELD_OFFSET][z+1+constants::POINT_FIELD_OFFSET]) 
-		/ scale;
+	// Neighbours are a fixed stride away from the center point in the flat density grid
+	const glmd::float32* center = densityValues.getData() + densityValues.getIndex(x, y, z);
+	const glmd::int32 strideX = densityValues.getStrideX();
+	const glmd::int32 strideY = densityValues.getStrideY();
+	const glmd::int32 strideZ = densityValues.getStrideZ();
+	
+	gradient.x = (center[-strideX] - center[strideX]) / scale;
+	gradient.y = (center[-strideY] - center[strideY]) / scale;
+	gradient.z = (center[-strideZ] - center[strideZ]) / scale;
 	
 	return gradient;
 }
@@ -711,7 +708,7 @@ glm::vec3 VoxelChunkMeshGenerator::calculateGradientVector(int x, int y, int z,
 /**
  * Set the densities and positions for the blocks, using the provided points (density values) and the grid coordinates.
  */
-void VoxelChunkMeshGenerator::setDensitiesAndPositions(Blocks& blocks, const Points& points, const glm::ivec3& gridCoords, const glm::ivec3& dimensions) const
+void VoxelChunkMeshGenerator::setDensitiesAndPositions(Blocks& blocks, const DensityGrid& points, const glm::ivec3& gridCoords, const glm::ivec3& dimensions) const
 {
 	const glmd::int32 pointsPerDimension = settings_.blockSize * settings_.resolution;
 	
@@ -724,7 +721,7 @@ void VoxelChunkMeshGenerator::setDensitiesAndPositions(Blocks& blocks, const Poi
 	fy -= (glmd::float32)(pointsPerDimension * dimensions.y/2);
 	fz -= (glmd::float32)(pointsPerDimension * dimensions.z/2);
 	
-#define SET_DENSITY(x, y, z, i, j, k) blocks[x][y][z].points[i][j][k].density = points[x+i+constants::POINT_FIELD_OFFSET][y+j+constants::POINT_FIELD_OFFSET][z+k+constants::POINT_FIELD_OFFSET];
+#define SET_DENSITY(x, y, z, i, j, k) blocks[x][y][z].points[i][j][k].density = points.get(x+i, y+j, z+k);
 #define SET_POSITION(x, y, z, i, j, k)\
 	blocks[x][y][z].points[i][j][k].pos.x = fx + (glmd::float32)(i * settings_.resolution);\
 	blocks[x][y][z].points[i][j][k].pos.y = fy + (glmd::float32)(j * settings_.resolution);\
@@ -791,7 +788,7 @@ void VoxelChunkMeshGenerator::resizeBlocks(Blocks& blocks) const
 
 void VoxelChunkMeshGenerator::generateMesh(VoxelChunk& chunk, glm::detail::int32 length, glm::detail::int32 width, glm::detail::int32 height, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, std::vector<glm::vec4>& textureBlendingValues) const
 {	
-	const Points& points = chunk.points;
+	const DensityGrid& points = chunk.points;
 	glmd::int32 gridX = chunk.gridX;
 	glmd::int32 gridY = chunk.gridY;
 	glmd::int32 gridZ = chunk.gridZ;
@@ -816,8 +813,253 @@ void VoxelChunkMeshGenerator::generateMesh(VoxelChunk& chunk, glm::detail::int32
 		generateTriangles(blocks, points, vertices, normals, y-1);
 	}
 	
-	// Calculate texture blending values
-	textureBlendingValues.resize( vertices.size() );
+	calculateTextureBlendingValues(normals, textureBlendingValues);
+}
+
+void VoxelChunkMeshGenerator::generateMesh(VoxelChunk& chunk, glm::detail::int32 length, glm::detail::int32 width, glm::detail::int32 height, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, std::vector<glm::vec4>& textureBlendingValues, std::vector<glm::detail::uint32>& indices) const
+{
+	const DensityGrid& points = chunk.points;
+	
+	if (isEmptyOrSolid(points))
+	{
+		return;
+	}
+	
+	const glm::vec3 origin = getOrigin( glm::ivec3(chunk.gridX, chunk.gridY, chunk.gridZ), glm::ivec3(length, width, height) );
+	
+	// At lower levels of detail there are fewer, bigger cubes
+	const glmd::int32 size = points.getSize();
+	const glmd::float32 spacing = settings_.resolution * (glmd::float32)chunk.stride;
+	
+	// The edge cache holds two y slices of edges - the slice at the bottom of the current layer of cubes, and the slice at the top
+	const glmd::int32 pointsPerSide = size + 1;
+	const glmd::int32 sliceSize = pointsPerSide * pointsPerSide * 3;
+	auto edgeCache = EdgeCache(2 * sliceSize, -1);
+	
+	for (glmd::int32 y = 0; y < size; y++)
+	{
+		// The top slice still holds the edges from two layers ago - clear it before we reuse it
+		if (y > 0)
+		{
+			const auto topSlice = edgeCache.begin() + ((y + 1) & 1) * sliceSize;
+			std::fill(topSlice, topSlice + sliceSize, -1);
+		}
+		
+		generateIndexedTriangles(points, origin, spacing, edgeCache, vertices, normals, indices, y);
+	}
+	
+	// Vertices where we couldn't calculate a normal from the density field get the average of the normals of the faces that use them
+	auto hasNormal = std::vector<bool>( vertices.size() );
+	for ( glmd::uint32 i=0; i < normals.size(); i++ )
+	{
+		hasNormal[i] = (normals[i] != glm::vec3());
+	}
+	
+	for ( glmd::uint32 i=0; i+2 < indices.size(); i += 3 )
+	{
+		const glm::vec3 faceNormal = calculateSimpleNormal( vertices[indices[i]], vertices[indices[i+1]], vertices[indices[i+2]] );
+		
+		for ( glmd::uint32 j=0; j < 3; j++ )
+		{
+			if (!hasNormal[indices[i+j]])
+			{
+				normals[indices[i+j]] += faceNormal;
+			}
+		}
+	}
+	
+	for ( glmd::uint32 i=0; i < normals.size(); i++ )
+	{
+		if (!hasNormal[i] && normals[i] != glm::vec3())
+		{
+			normals[i] = glm::normalize( normals[i] );
+		}
+	}
+	
+	if (settings_.levelOfDetailSkirts)
+	{
+		// Neighbouring chunks are at most one level of detail apart, and a chunk's surface can be up to one cube away from the 'real' surface
+		const glm::vec3 max = origin + glm::vec3((glmd::float32)size, (glmd::float32)size, (glmd::float32)size) * spacing;
+		
+		generateSkirts(origin, max, 2.0f * spacing, vertices, normals, indices);
+	}
+	
+	calculateTextureBlendingValues(normals, textureBlendingValues);
+}
+
+void VoxelChunkMeshGenerator::generateSkirts(const glm::vec3& min, const glm::vec3& max, glmd::float32 depth, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, std::vector<glm::detail::uint32>& indices) const
+{
+	auto getEdgeKey = [](glm::detail::uint32 a, glm::detail::uint32 b) -> glmd::uint64 { return ((glmd::uint64)a << 32) | (glmd::uint64)b; };
+	
+	// An edge of the mesh is on its boundary if only one triangle uses it - i.e. the edge is only ever traversed in one direction
+	auto edges = std::unordered_set<glmd::uint64>();
+	edges.reserve( indices.size() );
+	
+	const glmd::uint32 numberOfIndices = (glmd::uint32)indices.size();
+	
+	for ( glmd::uint32 i=0; i+2 < numberOfIndices; i += 3 )
+	{
+		edges.insert( getEdgeKey(indices[i], indices[i+1]) );
+		edges.insert( getEdgeKey(indices[i+1], indices[i+2]) );
+		edges.insert( getEdgeKey(indices[i+2], indices[i]) );
+	}
+	
+	// Vertices on a chunk face lie exactly on the face plane (they are interpolated along an edge that lies in that plane)
+	auto isOnSameFace = [&min, &max](const glm::vec3& a, const glm::vec3& b) -> bool {
+		for ( glmd::int32 axis=0; axis < 3; axis++ )
+		{
+			if ((a[axis] == min[axis] && b[axis] == min[axis]) || (a[axis] == max[axis] && b[axis] == max[axis]))
+			{
+				return true;
+			}
+		}
+		
+		return false;
+	};
+	
+	// Each boundary vertex gets a single skirt vertex, which is shared by the skirt triangles on either side of it
+	auto skirtVertices = std::unordered_map<glm::detail::uint32, glm::detail::uint32>();
+	
+	auto getSkirtVertex = [&](glm::detail::uint32 index) -> glm::detail::uint32 {
+		auto it = skirtVertices.find(index);
+		
+		if (it != skirtVertices.end())
+		{
+			return it->second;
+		}
+		
+		const glm::vec3 normal = normals[index];
+		const glm::vec3 direction = (normal != glm::vec3() ? normal : glm::vec3(0.0f, 1.0f, 0.0f));
+		
+		vertices.push_back( vertices[index] - direction * depth );
+		normals.push_back( normal );
+		
+		const glm::detail::uint32 skirtIndex = (glm::detail::uint32)(vertices.size() - 1);
+		skirtVertices[index] = skirtIndex;
+		
+		return skirtIndex;
+	};
+	
+	for ( glmd::uint32 i=0; i+2 < numberOfIndices; i += 3 )
+	{
+		for ( glmd::uint32 j=0; j < 3; j++ )
+		{
+			const glm::detail::uint32 a = indices[i + j];
+			const glm::detail::uint32 b = indices[i + (j + 1) % 3];
+			
+			if (edges.find( getEdgeKey(b, a) ) != edges.end() || !isOnSameFace(vertices[a], vertices[b]))
+			{
+				continue;
+			}
+			
+			const glm::detail::uint32 skirtA = getSkirtVertex(a);
+			const glm::detail::uint32 skirtB = getSkirtVertex(b);
+			
+			// The skirt traverses the edge in the opposite direction to the triangle, so that it faces the same way as the surface
+			indices.push_back( b );
+			indices.push_back( a );
+			indices.push_back( skirtA );
+			
+			indices.push_back( b );
+			indices.push_back( skirtA );
+			indices.push_back( skirtB );
+		}
+	}
+}
+
+/**
+ * Generate the indexed triangles for the cubes along the xz plane at point y.
+ */
+void VoxelChunkMeshGenerator::generateIndexedTriangles(const DensityGrid& points, const glm::vec3& origin, glmd::float32 spacing, EdgeCache& edgeCache, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, std::vector<glm::detail::uint32>& indices, glmd::int32 y) const
+{
+	const glmd::int32 size = points.getSize();
+	
+	for (glmd::int32 x = 0; x < size; x++)
+	{
+		for (glmd::int32 z = 0; z < size; z++)
+		{
+			int cubeindex = 0;
+			if (points.get(x,   y,   z+1) >= ISOLEVEL) cubeindex |= 1;
+			if (points.get(x+1, y,   z+1) >= ISOLEVEL) cubeindex |= 2;
+			if (points.get(x+1, y,   z  ) >= ISOLEVEL) cubeindex |= 4;
+			if (points.get(x,   y,   z  ) >= ISOLEVEL) cubeindex |= 8;
+			if (points.get(x,   y+1, z+1) >= ISOLEVEL) cubeindex |= 16;
+			if (points.get(x+1, y+1, z+1) >= ISOLEVEL) cubeindex |= 32;
+			if (points.get(x+1, y+1, z  ) >= ISOLEVEL) cubeindex |= 64;
+			if (points.get(x,   y+1, z  ) >= ISOLEVEL) cubeindex |= 128;
+			
+			/* Cube is entirely in/out of the surface */
+			if (edgeTable[cubeindex] == 0)
+			{
+				continue;
+			}
+			
+			/* Find (or generate) the vertices where the surface intersects the cube */
+			glm::detail::uint32 vertexIndices[12];
+			for (int e = 0; e < 12; e++)
+			{
+				if (edgeTable[cubeindex] & (1 << e))
+				{
+					vertexIndices[e] = getEdgeVertex(points, origin, spacing, edgeCache, vertices, normals, x + edgeStart[e][0], y + edgeStart[e][1], z + edgeStart[e][2], edgeStart[e][3]);
+				}
+			}
+			
+			/* Create the triangles */
+			for (int i=0; triTable[cubeindex][i] != -1; i += 3)
+			{
+				indices.push_back( vertexIndices[triTable[cubeindex][i  ]] );
+				indices.push_back( vertexIndices[triTable[cubeindex][i+1]] );
+				indices.push_back( vertexIndices[triTable[cubeindex][i+2]] );
+			}
+		}
+	}
+}
+
+glm::detail::uint32 VoxelChunkMeshGenerator::getEdgeVertex(const DensityGrid& points, const glm::vec3& origin, glmd::float32 spacing, EdgeCache& edgeCache, std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, glmd::int32 x, glmd::int32 y, glmd::int32 z, glmd::int32 axis) const
+{
+	const glmd::int32 pointsPerSide = points.getSize() + 1;
+	const glmd::int32 cacheIndex = ((((y & 1) * pointsPerSide + x) * pointsPerSide) + z) * 3 + axis;
+	
+	if (edgeCache[cacheIndex] >= 0)
+	{
+		return (glm::detail::uint32)edgeCache[cacheIndex];
+	}
+	
+	const glmd::int32 x2 = x + (axis == 0 ? 1 : 0);
+	const glmd::int32 y2 = y + (axis == 1 ? 1 : 0);
+	const glmd::int32 z2 = z + (axis == 2 ? 1 : 0);
+	
+	const glm::vec3 p1 = origin + glm::vec3((glmd::float32)x, (glmd::float32)y, (glmd::float32)z) * spacing;
+	const glm::vec3 p2 = origin + glm::vec3((glmd::float32)x2, (glmd::float32)y2, (glmd::float32)z2) * spacing;
+	
+	vertices.push_back( vertexInterp(ISOLEVEL, p1, p2, points.get(x, y, z), points.get(x2, y2, z2)) );
+	normals.push_back( calculateNormal(x, y, z, x2, y2, z2, points) );
+	
+	edgeCache[cacheIndex] = (glmd::int32)(vertices.size() - 1);
+	
+	return (glm::detail::uint32)edgeCache[cacheIndex];
+}
+
+/**
+ * Calculate the world position of the density grid point at local coordinates (0, 0, 0).
+ */
+glm::vec3 VoxelChunkMeshGenerator::getOrigin(const glm::ivec3& gridCoords, const glm::ivec3& dimensions) const
+{
+	const glmd::int32 pointsPerDimension = settings_.blockSize * settings_.resolution;
+	
+	return glm::vec3(
+		(glmd::float32)(gridCoords.x * pointsPerDimension) - (glmd::float32)(pointsPerDimension * dimensions.x/2),
+		(glmd::float32)(gridCoords.y * pointsPerDimension) - (glmd::float32)(pointsPerDimension * dimensions.y/2),
+		(glmd::float32)(gridCoords.z * pointsPerDimension) - (glmd::float32)(pointsPerDimension * dimensions.z/2)
+	);
+}
+
+/**
+ * Calculate the texture blending values for the provided normals.
+ */
+void VoxelChunkMeshGenerator::calculateTextureBlendingValues(const std::vector<glm::vec3>& normals, std::vector<glm::vec4>& textureBlendingValues) const
+{
+	textureBlendingValues.resize( normals.size() );
 	glm::vec3 levelVector = glm::normalize( glm::vec3(1.0f, 0.0f, 1.0f) );
 	for ( glmd::uint32 i=0; i < textureBlendingValues.size(); i++)
 	{
@@ -840,7 +1082,7 @@ void VoxelChunkMeshGenerator::generateMesh(VoxelChunk& chunk, glm::detail::int32
 		
 		v.z = 1.0f;
 		v.a = 1.0f;
-	}	
+	}
 }
 
 }
@@ -0,0 +1,255 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <map>
+#include <string>
+#include <cmath>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include "glw/Skeleton.hpp"
+#include "glw/AnimationTracks.hpp"
+#include "glw/SampledAnimationTracks.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+/**
+ * Returns a chain of numberOfNodes nodes, named "n0", "n1", ...
+ */
+glr::glw::BoneNode createChain(glmd::uint32 numberOfNodes)
+{
+	auto node = glr::glw::BoneNode();
+	node.name = "n" + std::to_string( numberOfNodes - 1 );
+
+	if (numberOfNodes > 1)
+	{
+		node.children.push_back( createChain(numberOfNodes - 1) );
+	}
+
+	return node;
+}
+
+void addKey(glr::glw::AnimatedBoneNode& abn, glmd::float64 time, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scaling)
+{
+	abn.positionTimes.push_back( time );
+	abn.rotationTimes.push_back( time );
+	abn.scalingTimes.push_back( time );
+	abn.positions.push_back( position );
+	abn.rotations.push_back( rotation );
+	abn.scalings.push_back( scaling );
+}
+
+/**
+ * Returns an animation of every node in a chain of numberOfNodes nodes, with a key every tick - smooth motion, like a motion capture clip.
+ */
+std::map< std::string, glr::glw::AnimatedBoneNode > createClip(glmd::uint32 numberOfNodes, glmd::uint32 numberOfKeys)
+{
+	auto animatedBoneNodes = std::map< std::string, glr::glw::AnimatedBoneNode >();
+
+	for (glmd::uint32 i=0; i < numberOfNodes; i++)
+	{
+		auto abn = glr::glw::AnimatedBoneNode();
+		abn.name = "n" + std::to_string( i );
+
+		for (glmd::uint32 k=0; k < numberOfKeys; k++)
+		{
+			const glmd::float32 t = 0.1f * k + i;
+
+			addKey(
+				abn,
+				(glmd::float64)k,
+				glm::vec3( std::sin(t), 0.5f * std::cos(t), 1.0f + 0.1f * i ),
+				glm::angleAxis( std::sin(t), glm::normalize(glm::vec3(1.0f, 0.5f * i, 0.2f)) ),
+				glm::vec3( 1.0f + 0.2f * std::sin(t) )
+			);
+		}
+
+		animatedBoneNodes[ abn.name ] = abn;
+	}
+
+	return animatedBoneNodes;
+}
+
+void checkClose(const glm::mat4& a, const glm::mat4& b, glmd::float32 tolerance)
+{
+	for (glmd::uint32 i=0; i < 4; i++)
+	{
+		for (glmd::uint32 j=0; j < 4; j++)
+		{
+			BOOST_CHECK_SMALL( a[i][j] - b[i][j], tolerance );
+		}
+	}
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(animationCompression)
+
+BOOST_AUTO_TEST_CASE(poseMatchesUncompressedTracks)
+{
+	const auto skeleton = glr::glw::Skeleton( createChain(8) );
+	const auto animatedBoneNodes = createClip( 8, 41 );
+
+	// Resample at a key per tick, so the resampled keys are at the times of the imported keys
+	auto settings = glr::glw::AnimationCompressionSettings();
+	settings.isEnabled = true;
+	settings.sampleRate = 25.0f;
+
+	const auto tracks = glr::glw::AnimationTracks( animatedBoneNodes );
+	const auto sampledTracks = glr::glw::SampledAnimationTracks( animatedBoneNodes, 40.0, 25.0, settings );
+
+	BOOST_CHECK_EQUAL( sampledTracks.getNumberOfTracks(), tracks.getNumberOfTracks() );
+	BOOST_CHECK( sampledTracks.getMemoryUsage() < tracks.getMemoryUsage() / 2 );
+
+	const auto nodeTracks = tracks.bindNodes( skeleton );
+	BOOST_REQUIRE( sampledTracks.bindNodes(skeleton) == nodeTracks );
+
+	// Before the first key, between keys, on a key, and after the last key
+	for ( glmd::float32 time : { -1.0f, 0.0f, 0.3f, 7.0f, 19.5f, 39.9f, 45.0f } )
+	{
+		auto expected = std::vector< glm::mat4 >( skeleton.getNumberOfNodes() );
+		auto globalTransformations = std::vector< glm::mat4 >( skeleton.getNumberOfNodes() );
+
+		tracks.calculateGlobalTransformations( expected, skeleton, nodeTracks, time, 0, 0 );
+		sampledTracks.calculateGlobalTransformations( globalTransformations, skeleton, nodeTracks, time, 0, 0 );
+
+		// The error of each node adds up along the chain
+		for ( glmd::uint32 i=0; i < expected.size(); i++ )
+		{
+			checkClose( globalTransformations[i], expected[i], 0.01f );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(keyReduction)
+{
+	auto abn = glr::glw::AnimatedBoneNode();
+	abn.name = "n0";
+
+	// A linear translation, with constant rotation and scaling
+	for (glmd::uint32 k=0; k <= 48; k++)
+	{
+		addKey( abn, (glmd::float64)k, glm::vec3(0.2f * k, 1.0f, -0.1f * k), glm::angleAxis(0.5f, glm::vec3(0.0f, 1.0f, 0.0f)), glm::vec3(2.0f) );
+	}
+
+	auto animatedBoneNodes = std::map< std::string, glr::glw::AnimatedBoneNode >();
+	animatedBoneNodes[ abn.name ] = abn;
+
+	auto settings = glr::glw::AnimationCompressionSettings();
+	settings.isEnabled = true;
+	settings.sampleRate = 25.0f;
+
+	// 2 translation keys, and a single rotation and scaling key
+	const auto reduced = glr::glw::SampledAnimationTracks( animatedBoneNodes, 48.0, 25.0, settings );
+	BOOST_CHECK_EQUAL( reduced.getNumberOfKeys(), 4u );
+
+	settings.isKeyReductionEnabled = false;
+
+	const auto sampled = glr::glw::SampledAnimationTracks( animatedBoneNodes, 48.0, 25.0, settings );
+	BOOST_CHECK_EQUAL( sampled.getNumberOfKeys(), 3u * 49u );
+
+	const auto tracks = glr::glw::AnimationTracks( animatedBoneNodes );
+
+	for ( glmd::float32 time : { 0.0f, 3.3f, 24.0f, 47.9f } )
+	{
+		glm::mat4 expected = glm::mat4();
+		glm::mat4 transformation = glm::mat4();
+
+		tracks.calculateLocalTransformation( expected, 0, time, 0, 0 );
+
+		reduced.calculateLocalTransformation( transformation, 0, time, 0, 0 );
+		checkClose( transformation, expected, 2e-3f );
+
+		sampled.calculateLocalTransformation( transformation, 0, time, 0, 0 );
+		checkClose( transformation, expected, 2e-3f );
+	}
+}
+
+BOOST_AUTO_TEST_CASE(rotationQuantization)
+{
+	// One rotation for each component being the largest, with the largest component both positive and negative
+	const std::vector< glm::quat > rotations = {
+		glm::normalize( glm::quat(0.9f, 0.1f, -0.3f, 0.2f) ),
+		glm::normalize( glm::quat(-0.9f, 0.1f, -0.3f, 0.2f) ),
+		glm::normalize( glm::quat(0.1f, 0.8f, 0.5f, -0.2f) ),
+		glm::normalize( glm::quat(0.1f, -0.2f, -0.8f, 0.5f) ),
+		glm::normalize( glm::quat(-0.4f, 0.3f, 0.2f, 0.7f) ),
+		glm::normalize( glm::quat(0.5f, 0.5f, 0.5f, 0.5f) )
+	};
+
+	auto animatedBoneNodes = std::map< std::string, glr::glw::AnimatedBoneNode >();
+
+	for ( glmd::uint32 i=0; i < rotations.size(); i++ )
+	{
+		auto abn = glr::glw::AnimatedBoneNode();
+		abn.name = "n" + std::to_string( i );
+		addKey( abn, 0.0, glm::vec3(0.0f), rotations[i], glm::vec3(1.0f) );
+
+		animatedBoneNodes[ abn.name ] = abn;
+	}
+
+	// A track without any keys
+	animatedBoneNodes[ "n6" ] = glr::glw::AnimatedBoneNode();
+
+	auto settings = glr::glw::AnimationCompressionSettings();
+	settings.isEnabled = true;
+
+	const auto sampledTracks = glr::glw::SampledAnimationTracks( animatedBoneNodes, 0.0, 25.0, settings );
+
+	const auto nodeTracks = sampledTracks.bindNodes( glr::glw::Skeleton(createChain(7)) );
+	BOOST_CHECK_EQUAL( nodeTracks[0], -1 );
+
+	for ( glmd::uint32 i=0; i < rotations.size(); i++ )
+	{
+		glm::mat4 transformation = glm::mat4();
+		sampledTracks.calculateLocalTransformation( transformation, i, 0.0f, 0, 0 );
+
+		checkClose( transformation, glm::mat4_cast(rotations[i]), 1e-4f );
+	}
+}
+
+BOOST_AUTO_TEST_CASE(frameClamping)
+{
+	auto abn = glr::glw::AnimatedBoneNode();
+	abn.name = "n0";
+
+	// Keys at uneven times (0, 0.5, 2, 4.5, 8, 12.5)
+	for (glmd::uint32 k=0; k < 6; k++)
+	{
+		const glmd::float32 f = (glmd::float32)k;
+		addKey( abn, k * k * 0.5, glm::vec3(f, 2.0f * f, 0.0f), glm::angleAxis(0.3f * f, glm::vec3(0.0f, 0.0f, 1.0f)), glm::vec3(1.0f) );
+	}
+
+	auto animatedBoneNodes = std::map< std::string, glr::glw::AnimatedBoneNode >();
+	animatedBoneNodes[ abn.name ] = abn;
+
+	auto settings = glr::glw::AnimationCompressionSettings();
+	settings.isEnabled = true;
+
+	const auto sampledTracks = glr::glw::SampledAnimationTracks( animatedBoneNodes, 12.5, 25.0, settings );
+
+	// Keys 2 and 4 are at times 2 and 8 - a time of 7 plays the animation at 2 + fmod(7, 8)
+	glm::mat4 clamped = glm::mat4();
+	glm::mat4 expected = glm::mat4();
+	sampledTracks.calculateLocalTransformation( clamped, 0, 7.0f, 2, 4 );
+	sampledTracks.calculateLocalTransformation( expected, 0, 9.0f, 0, 0 );
+
+	checkClose( clamped, expected, 1e-4f );
+
+	// Frames past the last key (at time 12.5) are clamped to it
+	sampledTracks.calculateLocalTransformation( clamped, 0, 14.0f, 2, 100 );
+	sampledTracks.calculateLocalTransformation( expected, 0, 3.5f, 0, 0 );
+
+	checkClose( clamped, expected, 1e-4f );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
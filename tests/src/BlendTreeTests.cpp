@@ -0,0 +1,349 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <map>
+#include <string>
+#include <cmath>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include "glw/Skeleton.hpp"
+#include "glw/Animation.hpp"
+#include "glw/BlendTree.hpp"
+
+#include "exceptions/InvalidArgumentException.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+glr::glw::BoneNode createNode(const std::string& name, glmd::float32 x)
+{
+	auto node = glr::glw::BoneNode();
+	node.name = name;
+	node.transformation = glm::translate( glm::mat4(1.0f), glm::vec3(x, 1.0f, 0.0f) )
+		* glm::mat4_cast( glm::angleAxis(0.2f * x, glm::normalize(glm::vec3(0.0f, 1.0f, 1.0f))) )
+		* glm::scale( glm::mat4(1.0f), glm::vec3(1.0f, 1.0f + 0.1f * x, 1.0f) );
+
+	return node;
+}
+
+/**
+ * Returns a small humanoid - hips, with a leg and a spine, and an arm and a hand on the spine.
+ */
+glr::glw::BoneNode createHumanoid()
+{
+	auto arm = createNode( "arm", 3.0f );
+	arm.children.push_back( createNode("hand", 4.0f) );
+
+	auto spine = createNode( "spine", 2.0f );
+	spine.children.push_back( arm );
+
+	auto hips = createNode( "hips", 0.0f );
+	hips.children.push_back( createNode("leg", 1.0f) );
+	hips.children.push_back( spine );
+
+	return hips;
+}
+
+/**
+ * Returns an animation of every node except the leg (which keeps its own transformation), with a key every tick - phase makes each clip
+ * move differently.  Clips are 40 ticks long, and played at 25 ticks per second.
+ */
+std::map< std::string, glr::glw::AnimatedBoneNode > createClip(glmd::float32 phase)
+{
+	auto animatedBoneNodes = std::map< std::string, glr::glw::AnimatedBoneNode >();
+
+	for ( const std::string& name : { "hips", "spine", "arm", "hand" } )
+	{
+		auto abn = glr::glw::AnimatedBoneNode();
+		abn.name = name;
+
+		for (glmd::uint32 k=0; k <= 40; k++)
+		{
+			const glmd::float32 t = 0.1f * k + phase + name.size();
+
+			abn.positionTimes.push_back( (glmd::float64)k );
+			abn.rotationTimes.push_back( (glmd::float64)k );
+			abn.scalingTimes.push_back( (glmd::float64)k );
+			abn.positions.push_back( glm::vec3(std::sin(t), 1.0f + std::cos(t), phase) );
+			abn.rotations.push_back( glm::angleAxis(std::sin(t), glm::normalize(glm::vec3(1.0f, phase, 0.5f))) );
+			abn.scalings.push_back( glm::vec3(1.0f + 0.2f * std::sin(t)) );
+		}
+
+		animatedBoneNodes[ name ] = abn;
+	}
+
+	return animatedBoneNodes;
+}
+
+/**
+ * Gives every node of the skeleton a bone, with no offset.
+ */
+glr::glw::BoneData createBoneData(const glr::glw::Skeleton& skeleton)
+{
+	auto boneData = glr::glw::BoneData();
+
+	for ( glmd::uint32 i=0; i < skeleton.getNumberOfNodes(); i++ )
+	{
+		auto bone = glr::glw::Bone();
+		bone.name = skeleton.getNames()[i];
+		bone.boneOffset = glm::mat4();
+
+		boneData.boneIndexMap[ bone.name ] = i;
+		boneData.boneTransform.push_back( bone );
+	}
+
+	return boneData;
+}
+
+/**
+ * The pose of a single animation, calculated without a blend tree.
+ */
+glr::glw::SkeletonPose calculateClipPose(const glr::glw::IAnimation& animation, const glr::glw::Skeleton& skeleton, glmd::float32 time)
+{
+	auto pose = skeleton.getBindPose();
+	animation.calculateLocalPose( pose, animation.bindNodes(skeleton), time, 0, 0 );
+
+	return pose;
+}
+
+void checkClose(const glm::mat4& a, const glm::mat4& b)
+{
+	for (glmd::uint32 i=0; i < 4; i++)
+	{
+		for (glmd::uint32 j=0; j < 4; j++)
+		{
+			BOOST_CHECK_SMALL( a[i][j] - b[i][j], 1e-3f );
+		}
+	}
+}
+
+void checkClose(const glr::glw::SkeletonPose& a, const glr::glw::SkeletonPose& b)
+{
+	BOOST_REQUIRE_EQUAL( a.getNumberOfNodes(), b.getNumberOfNodes() );
+
+	for (glmd::uint32 i=0; i < a.getNumberOfNodes(); i++)
+	{
+		checkClose( a.getTransformation(i), b.getTransformation(i) );
+	}
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(blendTree)
+
+BOOST_AUTO_TEST_CASE(bindPoseMatchesSkeleton)
+{
+	const auto skeleton = glr::glw::Skeleton( createHumanoid() );
+	const auto& bindPose = skeleton.getBindPose();
+
+	BOOST_REQUIRE_EQUAL( bindPose.getNumberOfNodes(), skeleton.getNumberOfNodes() );
+
+	for (glmd::uint32 i=0; i < skeleton.getNumberOfNodes(); i++)
+	{
+		checkClose( bindPose.getTransformation(i), skeleton.getTransformations()[i] );
+	}
+}
+
+BOOST_AUTO_TEST_CASE(clipMatchesAnimation)
+{
+	const auto skeleton = glr::glw::Skeleton( createHumanoid() );
+	const auto bones = skeleton.bindBones( createBoneData(skeleton) );
+	const glm::mat4 globalInverseTransformation = glm::translate( glm::mat4(1.0f), glm::vec3(0.0f, -1.0f, 2.0f) );
+
+	glr::glw::Animation walk( nullptr, "walk", 40.0, 25.0, createClip(0.0f), false );
+
+	auto blendTree = glr::glw::BlendTree();
+	blendTree.addClip( &walk, 0.3f );
+
+	auto expected = std::vector< glm::mat4 >( bones.numberOfBones );
+	auto transformations = std::vector< glm::mat4 >( bones.numberOfBones );
+	auto globalTransformations = std::vector< glm::mat4 >();
+
+	walk.calculatePose( expected, globalTransformations, globalInverseTransformation, skeleton, walk.bindNodes(skeleton), bones, 0.3f, 0, 0 );
+	blendTree.calculatePose( transformations, globalTransformations, globalInverseTransformation, skeleton, bones );
+
+	BOOST_CHECK( !blendTree.isDirty() );
+	BOOST_CHECK_EQUAL( blendTree.getNumberOfActiveClips(), 1u );
+
+	for (glmd::uint32 i=0; i < bones.numberOfBones; i++)
+	{
+		checkClose( transformations[i], expected[i] );
+	}
+}
+
+BOOST_AUTO_TEST_CASE(lerp)
+{
+	const auto skeleton = glr::glw::Skeleton( createHumanoid() );
+
+	glr::glw::Animation walk( nullptr, "walk", 40.0, 25.0, createClip(0.0f), false );
+	glr::glw::Animation run( nullptr, "run", 40.0, 25.0, createClip(1.0f), false );
+
+	auto blendTree = glr::glw::BlendTree();
+	const auto lerp = blendTree.addLerp( blendTree.addClip(&walk, 0.5f), blendTree.addClip(&run, 0.5f) );
+
+	// Only the clip with any weight is evaluated
+	checkClose( blendTree.calculateLocalPose(skeleton), calculateClipPose(walk, skeleton, 0.5f) );
+	BOOST_CHECK_EQUAL( blendTree.getNumberOfActiveClips(), 1u );
+
+	blendTree.setWeight( lerp, 1.0f );
+	BOOST_CHECK( blendTree.isDirty() );
+
+	checkClose( blendTree.calculateLocalPose(skeleton), calculateClipPose(run, skeleton, 0.5f) );
+	BOOST_CHECK_EQUAL( blendTree.getNumberOfActiveClips(), 1u );
+
+	blendTree.setWeight( lerp, 0.25f );
+
+	const auto pose = blendTree.calculateLocalPose( skeleton );
+	const auto walkPose = calculateClipPose( walk, skeleton, 0.5f );
+	const auto runPose = calculateClipPose( run, skeleton, 0.5f );
+
+	BOOST_CHECK_EQUAL( blendTree.getNumberOfActiveClips(), 2u );
+
+	for (glmd::uint32 i=0; i < pose.getNumberOfNodes(); i++)
+	{
+		BOOST_CHECK_SMALL( pose.tx[i] - (0.75f * walkPose.tx[i] + 0.25f * runPose.tx[i]), 1e-4f );
+		BOOST_CHECK_SMALL( pose.sy[i] - (0.75f * walkPose.sy[i] + 0.25f * runPose.sy[i]), 1e-4f );
+
+		const glmd::float32 length = std::sqrt( pose.rx[i] * pose.rx[i] + pose.ry[i] * pose.ry[i] + pose.rz[i] * pose.rz[i] + pose.rw[i] * pose.rw[i] );
+		BOOST_CHECK_SMALL( length - 1.0f, 1e-4f );
+	}
+}
+
+BOOST_AUTO_TEST_CASE(blend)
+{
+	const auto skeleton = glr::glw::Skeleton( createHumanoid() );
+
+	glr::glw::Animation walk( nullptr, "walk", 40.0, 25.0, createClip(0.0f), false );
+	glr::glw::Animation run( nullptr, "run", 40.0, 25.0, createClip(1.0f), false );
+	glr::glw::Animation sprint( nullptr, "sprint", 40.0, 25.0, createClip(2.0f), false );
+
+	auto blendTree = glr::glw::BlendTree();
+	const auto a = blendTree.addClip( &walk, 0.2f );
+	const auto b = blendTree.addClip( &run, 0.4f );
+	const auto c = blendTree.addClip( &sprint, 0.6f );
+	const auto lerp = blendTree.addLerp( a, c, 0.5f );
+	const auto blend = blendTree.addBlend( { a, b, c }, { 2.0f, 0.0f, 2.0f } );
+
+	// Weights are normalized - and the clip with no weight isn't evaluated
+	const auto pose = blendTree.calculateLocalPose( skeleton );
+	BOOST_CHECK_EQUAL( blendTree.getNumberOfActiveClips(), 2u );
+
+	blendTree.setRoot( lerp );
+	checkClose( pose, blendTree.calculateLocalPose(skeleton) );
+
+	blendTree.setRoot( blend );
+	blendTree.setWeights( blend, { 0.0f, 1.0f, 0.0f } );
+	checkClose( blendTree.calculateLocalPose(skeleton), calculateClipPose(run, skeleton, 0.4f) );
+
+	BOOST_CHECK_THROW( blendTree.setWeights(blend, { 1.0f, 1.0f }), glr::exception::InvalidArgumentException );
+	BOOST_CHECK_THROW( blendTree.setWeights(lerp, { 1.0f, 1.0f }), glr::exception::InvalidArgumentException );
+}
+
+BOOST_AUTO_TEST_CASE(additive)
+{
+	const auto skeleton = glr::glw::Skeleton( createHumanoid() );
+
+	glr::glw::Animation walk( nullptr, "walk", 40.0, 25.0, createClip(0.0f), false );
+	glr::glw::Animation lean( nullptr, "lean", 40.0, 25.0, createClip(1.0f), false );
+
+	auto blendTree = glr::glw::BlendTree();
+	const auto base = blendTree.addClip( &walk, 0.5f );
+	const auto additive = blendTree.addClip( &lean, 0.3f );
+	const auto sameAsReference = blendTree.addAdditive( base, additive, additive );
+
+	// Adding the difference between a pose and itself changes nothing
+	checkClose( blendTree.calculateLocalPose(skeleton), calculateClipPose(walk, skeleton, 0.5f) );
+	BOOST_CHECK_EQUAL( blendTree.getNumberOfActiveClips(), 2u );
+
+	// Relative to the bind pose, adding the whole of a pose to the bind pose gives the pose
+	// An animation of a node the skeleton doesn't have plays the bind pose
+	auto tail = createClip( 0.0f )[ "hand" ];
+	tail.name = "tail";
+
+	glr::glw::Animation bindPose( nullptr, "bind", 40.0, 25.0, { { tail.name, tail } }, false );
+	const auto fromBindPose = blendTree.addAdditive( blendTree.addClip(&bindPose), additive );
+
+	checkClose( blendTree.calculateLocalPose(skeleton), calculateClipPose(lean, skeleton, 0.3f) );
+
+	// With no weight, the additive pose isn't evaluated
+	blendTree.setRoot( sameAsReference );
+	blendTree.setWeight( sameAsReference, 0.0f );
+
+	checkClose( blendTree.calculateLocalPose(skeleton), calculateClipPose(walk, skeleton, 0.5f) );
+	BOOST_CHECK_EQUAL( blendTree.getNumberOfActiveClips(), 1u );
+
+	BOOST_CHECK_EQUAL( blendTree.getNumberOfNodes(), fromBindPose + 1 );
+}
+
+BOOST_AUTO_TEST_CASE(layer)
+{
+	const auto skeleton = glr::glw::Skeleton( createHumanoid() );
+
+	glr::glw::Animation walk( nullptr, "walk", 40.0, 25.0, createClip(0.0f), false );
+	glr::glw::Animation wave( nullptr, "wave", 40.0, 25.0, createClip(1.0f), false );
+
+	auto blendTree = glr::glw::BlendTree();
+	blendTree.addLayer( blendTree.addClip(&walk, 0.5f), blendTree.addClip(&wave, 0.2f), { "arm" } );
+
+	const auto pose = blendTree.calculateLocalPose( skeleton );
+	const auto walkPose = calculateClipPose( walk, skeleton, 0.5f );
+	const auto wavePose = calculateClipPose( wave, skeleton, 0.2f );
+
+	// The arm and its descendants are played from the layer - the rest of the skeleton from the base
+	for (glmd::uint32 i=0; i < skeleton.getNumberOfNodes(); i++)
+	{
+		const std::string& name = skeleton.getNames()[i];
+		const bool isMasked = (name == "arm" || name == "hand");
+
+		checkClose( pose.getTransformation(i), (isMasked ? wavePose : walkPose).getTransformation(i) );
+	}
+}
+
+BOOST_AUTO_TEST_CASE(advance)
+{
+	const auto skeleton = glr::glw::Skeleton( createHumanoid() );
+
+	glr::glw::Animation walk( nullptr, "walk", 40.0, 25.0, createClip(0.0f), false );
+
+	auto blendTree = glr::glw::BlendTree();
+	const auto clip = blendTree.addClip( &walk, 0.1f, 2.0f );
+
+	blendTree.calculateLocalPose( skeleton );
+	BOOST_CHECK( !blendTree.isDirty() );
+
+	blendTree.advance( 0.25f );
+	BOOST_CHECK( blendTree.isDirty() );
+
+	checkClose( blendTree.calculateLocalPose(skeleton), calculateClipPose(walk, skeleton, 0.6f) );
+
+	blendTree.setAnimationTime( clip, 1.0f );
+	checkClose( blendTree.calculateLocalPose(skeleton), calculateClipPose(walk, skeleton, 1.0f) );
+}
+
+BOOST_AUTO_TEST_CASE(invalidNodes)
+{
+	glr::glw::Animation walk( nullptr, "walk", 40.0, 25.0, createClip(0.0f), false );
+
+	auto blendTree = glr::glw::BlendTree();
+	const auto clip = blendTree.addClip( &walk );
+
+	BOOST_CHECK_THROW( blendTree.addClip(nullptr), glr::exception::InvalidArgumentException );
+	BOOST_CHECK_THROW( blendTree.addLerp(clip, clip + 1), glr::exception::InvalidArgumentException );
+	BOOST_CHECK_THROW( blendTree.addBlend({ clip }, { 1.0f, 1.0f }), glr::exception::InvalidArgumentException );
+	BOOST_CHECK_THROW( blendTree.setWeight(clip, 1.0f), glr::exception::InvalidArgumentException );
+	BOOST_CHECK_THROW( blendTree.setRoot(clip + 1), glr::exception::InvalidArgumentException );
+
+	BOOST_CHECK_EQUAL( blendTree.getNumberOfNodes(), 1u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
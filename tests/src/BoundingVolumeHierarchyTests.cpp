@@ -0,0 +1,287 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+#include <set>
+
+#include "BoundingVolumeHierarchy.hpp"
+#include "Frustum.hpp"
+#include "glw/BoundingBox.hpp"
+
+namespace glmd = glm::detail;
+
+using glr::glw::BoundingBox;
+
+namespace
+{
+
+BoundingBox createBox(glmd::float32 x, glmd::float32 y, glmd::float32 z, glmd::float32 size)
+{
+	return BoundingBox( glm::vec3(x, y, z), glm::vec3(x + size, y + size, z + size) );
+}
+
+// A deterministic sequence of numbers in [0, 1)
+glmd::float32 nextRandom(glmd::uint32& state)
+{
+	state = state * 1664525u + 1013904223u;
+	return (glmd::float32)(state >> 8) / (glmd::float32)(1u << 24);
+}
+
+void* userData(glmd::uint32 i)
+{
+	return reinterpret_cast<void*>( (size_t)i + 1 );
+}
+
+std::set< void* > queryAll(const glr::BoundingVolumeHierarchy& hierarchy, const glr::Frustum& frustum, glr::CullingStatistics& statistics)
+{
+	std::set< void* > found;
+	statistics = hierarchy.query( frustum, [&found](void* data) { found.insert( data ); } );
+
+	return found;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(boundingVolumeHierarchy)
+
+BOOST_AUTO_TEST_CASE(boundingBox)
+{
+	BoundingBox box = BoundingBox();
+	BOOST_CHECK( box.isEmpty() );
+
+	std::vector< glm::vec3 > points = { glm::vec3(1.0f, -2.0f, 3.0f), glm::vec3(-1.0f, 2.0f, 0.0f), glm::vec3(0.0f, 0.0f, 5.0f) };
+	box = BoundingBox::fromPoints( points );
+
+	BOOST_CHECK( !box.isEmpty() );
+	BOOST_CHECK_EQUAL( box.min.x, -1.0f );
+	BOOST_CHECK_EQUAL( box.min.y, -2.0f );
+	BOOST_CHECK_EQUAL( box.min.z, 0.0f );
+	BOOST_CHECK_EQUAL( box.max.x, 1.0f );
+	BOOST_CHECK_EQUAL( box.max.y, 2.0f );
+	BOOST_CHECK_EQUAL( box.max.z, 5.0f );
+
+	BOOST_CHECK( box.contains(createBox(-0.5f, -0.5f, 0.5f, 1.0f)) );
+	BOOST_CHECK( !box.contains(createBox(0.5f, -0.5f, 0.5f, 1.0f)) );
+
+	box.expand( createBox(4.0f, 4.0f, 4.0f, 1.0f) );
+	BOOST_CHECK_EQUAL( box.max.x, 5.0f );
+	BOOST_CHECK_EQUAL( box.max.y, 5.0f );
+	BOOST_CHECK_EQUAL( box.min.x, -1.0f );
+
+	// Expanding by an empty box changes nothing
+	box.expand( BoundingBox() );
+	BOOST_CHECK_EQUAL( box.max.x, 5.0f );
+	BOOST_CHECK_EQUAL( box.min.z, 0.0f );
+}
+
+BOOST_AUTO_TEST_CASE(boundingBoxTransform)
+{
+	const BoundingBox box = createBox(-1.0f, -1.0f, -1.0f, 2.0f);
+
+	// Scale x by 2 and translate by (5, 0, -3)
+	glm::mat4 matrix = glm::mat4(1.0f);
+	matrix[0][0] = 2.0f;
+	matrix[3][0] = 5.0f;
+	matrix[3][2] = -3.0f;
+
+	BoundingBox transformed = box.transform( matrix );
+	BOOST_CHECK_CLOSE( transformed.min.x, 3.0f, 0.001f );
+	BOOST_CHECK_CLOSE( transformed.max.x, 7.0f, 0.001f );
+	BOOST_CHECK_CLOSE( transformed.min.y, -1.0f, 0.001f );
+	BOOST_CHECK_CLOSE( transformed.max.y, 1.0f, 0.001f );
+	BOOST_CHECK_CLOSE( transformed.min.z, -4.0f, 0.001f );
+	BOOST_CHECK_CLOSE( transformed.max.z, -2.0f, 0.001f );
+
+	// Rotating 45 degrees about z grows the box to hold the rotated corners
+	const glmd::float32 c = std::sqrt( 0.5f );
+	matrix = glm::mat4(1.0f);
+	matrix[0][0] = c;
+	matrix[0][1] = c;
+	matrix[1][0] = -c;
+	matrix[1][1] = c;
+
+	transformed = box.transform( matrix );
+	BOOST_CHECK_CLOSE( transformed.max.x, 2.0f * c, 0.001f );
+	BOOST_CHECK_CLOSE( transformed.min.y, -2.0f * c, 0.001f );
+	BOOST_CHECK_CLOSE( transformed.max.z, 1.0f, 0.001f );
+
+	BOOST_CHECK( BoundingBox().transform(matrix).isEmpty() );
+}
+
+BOOST_AUTO_TEST_CASE(frustum)
+{
+	// The frustum of the identity matrix is the cube [-1, 1]
+	const glr::Frustum frustum = glr::Frustum( glm::mat4(1.0f) );
+
+	BOOST_CHECK_EQUAL( frustum.intersect(createBox(-0.5f, -0.5f, -0.5f, 1.0f)), glr::Frustum::INTERSECTION_INSIDE );
+	BOOST_CHECK_EQUAL( frustum.intersect(createBox(0.5f, -0.5f, -0.5f, 1.0f)), glr::Frustum::INTERSECTION_INTERSECTS );
+	BOOST_CHECK_EQUAL( frustum.intersect(createBox(1.5f, -0.5f, -0.5f, 1.0f)), glr::Frustum::INTERSECTION_OUTSIDE );
+	BOOST_CHECK_EQUAL( frustum.intersect(createBox(-0.5f, -0.5f, -3.0f, 1.0f)), glr::Frustum::INTERSECTION_OUTSIDE );
+	BOOST_CHECK_EQUAL( frustum.intersect(createBox(-5.0f, -5.0f, -5.0f, 10.0f)), glr::Frustum::INTERSECTION_INTERSECTS );
+	BOOST_CHECK_EQUAL( frustum.intersect(BoundingBox()), glr::Frustum::INTERSECTION_INTERSECTS );
+
+	BOOST_CHECK( frustum.isVisible(createBox(0.9f, 0.9f, 0.9f, 1.0f)) );
+	BOOST_CHECK( !frustum.isVisible(createBox(1.1f, 0.0f, 0.0f, 1.0f)) );
+
+	// The left plane is x >= -1
+	const glm::vec4 left = frustum.getPlane( 0 );
+	BOOST_CHECK_CLOSE( left.x, 1.0f, 0.001f );
+	BOOST_CHECK_CLOSE( left.w, 1.0f, 0.001f );
+
+	// Halving x in clip space doubles the width of the frustum
+	glm::mat4 matrix = glm::mat4(1.0f);
+	matrix[0][0] = 0.5f;
+	const glr::Frustum wideFrustum = glr::Frustum( matrix );
+
+	BOOST_CHECK_EQUAL( wideFrustum.intersect(createBox(1.5f, -0.5f, -0.5f, 0.25f)), glr::Frustum::INTERSECTION_INSIDE );
+	BOOST_CHECK_EQUAL( wideFrustum.intersect(createBox(2.5f, -0.5f, -0.5f, 0.25f)), glr::Frustum::INTERSECTION_OUTSIDE );
+
+	// The default frustum contains everything
+	BOOST_CHECK_EQUAL( glr::Frustum().intersect(createBox(1000.0f, -1000.0f, 0.0f, 1.0f)), glr::Frustum::INTERSECTION_INSIDE );
+}
+
+BOOST_AUTO_TEST_CASE(insertAndRemove)
+{
+	auto hierarchy = glr::BoundingVolumeHierarchy( 0.1f );
+	BOOST_CHECK_EQUAL( hierarchy.getHeight(), 0u );
+
+	std::vector< glmd::int32 > proxies;
+
+	for ( glmd::uint32 i = 0; i < 1000; i++ )
+	{
+		proxies.push_back( hierarchy.insert(createBox((glmd::float32)i, 0.0f, 0.0f, 0.5f), userData(i)) );
+		BOOST_CHECK_EQUAL( hierarchy.getUserData(proxies.back()), userData(i) );
+	}
+
+	BOOST_CHECK_EQUAL( hierarchy.getNumberOfProxies(), 1000u );
+
+	// Inserting boxes in order is the worst case for an unbalanced tree - the rotations keep it logarithmic
+	BOOST_CHECK( hierarchy.getHeight() <= 20u );
+
+	// The fat boxes are grown by the margin
+	const BoundingBox& fat = hierarchy.getFatBoundingBox( proxies[10] );
+	BOOST_CHECK_CLOSE( fat.min.x, 9.9f, 0.001f );
+	BOOST_CHECK_CLOSE( fat.max.x, 10.6f, 0.001f );
+
+	for ( glmd::uint32 i = 0; i < 1000; i += 2 )
+	{
+		hierarchy.remove( proxies[i] );
+	}
+
+	BOOST_CHECK_EQUAL( hierarchy.getNumberOfProxies(), 500u );
+	BOOST_CHECK( hierarchy.getHeight() <= 18u );
+
+	// Only the odd boxes are left
+	glr::CullingStatistics statistics;
+	const auto found = queryAll( hierarchy, glr::Frustum(), statistics );
+
+	BOOST_CHECK_EQUAL( found.size(), 500u );
+	BOOST_CHECK_EQUAL( statistics.visible, 500u );
+	BOOST_CHECK_EQUAL( statistics.culled, 0u );
+	BOOST_CHECK( found.count(userData(1)) == 1 );
+	BOOST_CHECK( found.count(userData(2)) == 0 );
+
+	// Removed nodes are reused
+	const glmd::int32 proxy = hierarchy.insert( createBox(0.0f, 0.0f, 0.0f, 1.0f), userData(0) );
+	BOOST_CHECK( proxy < 2000 );
+
+	hierarchy.clear();
+	BOOST_CHECK_EQUAL( hierarchy.getNumberOfProxies(), 0u );
+	BOOST_CHECK_EQUAL( hierarchy.getHeight(), 0u );
+}
+
+BOOST_AUTO_TEST_CASE(update)
+{
+	auto hierarchy = glr::BoundingVolumeHierarchy( 1.0f );
+	const glmd::int32 proxy = hierarchy.insert( createBox(10.0f, 0.0f, 0.0f, 0.5f), userData(0) );
+	hierarchy.insert( createBox(-10.0f, 0.0f, 0.0f, 0.5f), userData(1) );
+
+	// Moving inside of the fat box doesn't change the tree
+	BOOST_CHECK( !hierarchy.update(proxy, createBox(10.5f, 0.0f, 0.0f, 0.5f)) );
+
+	// Moving outside of it reinserts the proxy
+	BOOST_CHECK( hierarchy.update(proxy, createBox(0.0f, 0.0f, 0.0f, 0.5f)) );
+	BOOST_CHECK_CLOSE( hierarchy.getFatBoundingBox(proxy).min.x, -1.0f, 0.001f );
+
+	glr::CullingStatistics statistics;
+	const auto found = queryAll( hierarchy, glr::Frustum(glm::mat4(1.0f)), statistics );
+
+	BOOST_CHECK_EQUAL( found.size(), 1u );
+	BOOST_CHECK( found.count(userData(0)) == 1 );
+	BOOST_CHECK_EQUAL( statistics.visible, 1u );
+	BOOST_CHECK_EQUAL( statistics.culled, 1u );
+}
+
+BOOST_AUTO_TEST_CASE(synchronize)
+{
+	auto hierarchy = glr::BoundingVolumeHierarchy();
+
+	// Objects without a bounding box aren't stored
+	glmd::int32 proxy = hierarchy.synchronize( glr::BoundingVolumeHierarchy::NULL_PROXY, BoundingBox(), userData(0) );
+	BOOST_CHECK_EQUAL( proxy, glr::BoundingVolumeHierarchy::NULL_PROXY );
+	BOOST_CHECK_EQUAL( hierarchy.getNumberOfProxies(), 0u );
+
+	proxy = hierarchy.synchronize( proxy, createBox(0.0f, 0.0f, 0.0f, 1.0f), userData(0) );
+	BOOST_CHECK( proxy != glr::BoundingVolumeHierarchy::NULL_PROXY );
+	BOOST_CHECK_EQUAL( hierarchy.getNumberOfProxies(), 1u );
+
+	BOOST_CHECK_EQUAL( hierarchy.synchronize(proxy, createBox(0.1f, 0.0f, 0.0f, 1.0f), userData(1)), proxy );
+	BOOST_CHECK_EQUAL( hierarchy.getUserData(proxy), userData(1) );
+
+	proxy = hierarchy.synchronize( proxy, BoundingBox(), userData(1) );
+	BOOST_CHECK_EQUAL( proxy, glr::BoundingVolumeHierarchy::NULL_PROXY );
+	BOOST_CHECK_EQUAL( hierarchy.getNumberOfProxies(), 0u );
+}
+
+/**
+ * The hierarchy must find exactly the objects a brute force test of every fat box finds, however the objects have moved.
+ */
+BOOST_AUTO_TEST_CASE(queryMatchesBruteForce)
+{
+	auto hierarchy = glr::BoundingVolumeHierarchy( 0.5f );
+	std::vector< glmd::int32 > proxies;
+	glmd::uint32 state = 12345;
+
+	for ( glmd::uint32 i = 0; i < 2000; i++ )
+	{
+		const auto box = createBox( nextRandom(state) * 20.0f - 10.0f, nextRandom(state) * 20.0f - 10.0f, nextRandom(state) * 20.0f - 10.0f, nextRandom(state) );
+		proxies.push_back( hierarchy.insert(box, userData(i)) );
+	}
+
+	for ( glmd::uint32 i = 0; i < 2000; i += 3 )
+	{
+		const auto box = createBox( nextRandom(state) * 20.0f - 10.0f, nextRandom(state) * 20.0f - 10.0f, nextRandom(state) * 20.0f - 10.0f, nextRandom(state) );
+		hierarchy.update( proxies[i], box );
+	}
+
+	glm::mat4 matrix = glm::mat4(1.0f);
+	matrix[0][0] = 0.25f;
+	matrix[1][1] = 0.5f;
+	matrix[2][2] = 0.2f;
+	matrix[3][0] = 0.5f;
+	const glr::Frustum frustum = glr::Frustum( matrix );
+
+	glr::CullingStatistics statistics;
+	const auto found = queryAll( hierarchy, frustum, statistics );
+
+	std::set< void* > expected;
+	for ( glmd::uint32 i = 0; i < proxies.size(); i++ )
+	{
+		if (frustum.isVisible( hierarchy.getFatBoundingBox(proxies[i]) ))
+		{
+			expected.insert( userData(i) );
+		}
+	}
+
+	BOOST_CHECK( found == expected );
+	BOOST_CHECK_EQUAL( statistics.visible, expected.size() );
+	BOOST_CHECK_EQUAL( statistics.visible + statistics.culled, 2000u );
+	BOOST_CHECK( statistics.culled > 0u );
+	BOOST_CHECK( statistics.visible > 0u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
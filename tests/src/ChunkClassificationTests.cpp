@@ -0,0 +1,155 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "terrain/IFieldFunction.hpp"
+#include "terrain/VoxelChunk.hpp"
+#include "terrain/VoxelChunkNoiseGenerator.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+// A column of three chunks - the bottom one is below the plane, the middle one contains it, and the top one is above it
+const glm::ivec3 DIMENSIONS = glm::ivec3(1, 3, 1);
+
+/**
+ * A flat, horizontal surface - solid below height, and air above it.  Its range is exact.
+ */
+class PlaneFieldFunction : public glr::terrain::IFieldFunction
+{
+public:
+	PlaneFieldFunction(glmd::float32 height = 0.3f) : height_(height)
+	{
+	}
+
+	virtual glmd::float32 getNoise(glmd::float32 x, glmd::float32 y, glmd::float32 z)
+	{
+		return y - height_;
+	}
+
+	virtual bool getRange(const glm::vec3& min, const glm::vec3& max, glmd::float32& minValue, glmd::float32& maxValue)
+	{
+		minValue = min.y - height_;
+		maxValue = max.y - height_;
+
+		return true;
+	}
+
+private:
+	glmd::float32 height_;
+};
+
+/**
+ * The same plane, without a range.
+ */
+class UnboundedPlaneFieldFunction : public glr::terrain::IFieldFunction
+{
+public:
+	virtual glmd::float32 getNoise(glmd::float32 x, glmd::float32 y, glmd::float32 z)
+	{
+		return y - 0.3f;
+	}
+};
+
+/**
+ * Returns the type of the chunk found by sampling its density field.
+ */
+glr::terrain::ChunkType sampleChunkType(glmd::int32 gridY, glr::terrain::IFieldFunction& fieldFunction)
+{
+	auto chunk = glr::terrain::VoxelChunk(0, gridY, 0);
+	glr::terrain::generateNoise(chunk, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, fieldFunction);
+	glr::terrain::determineIfEmptyOrSolid(chunk);
+
+	return chunk.type;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(chunkClassification)
+
+BOOST_AUTO_TEST_CASE(classifiesEmptyAndSolidChunks)
+{
+	auto fieldFunction = PlaneFieldFunction();
+
+	auto below = glr::terrain::VoxelChunk(0, 0, 0);
+	BOOST_CHECK( glr::terrain::classifyChunk(below, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, fieldFunction) );
+	BOOST_CHECK_EQUAL( below.type, glr::terrain::CHUNK_TYPE_SOLID );
+
+	auto above = glr::terrain::VoxelChunk(0, 2, 0);
+	BOOST_CHECK( glr::terrain::classifyChunk(above, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, fieldFunction) );
+	BOOST_CHECK_EQUAL( above.type, glr::terrain::CHUNK_TYPE_EMPTY );
+}
+
+BOOST_AUTO_TEST_CASE(leavesSurfaceChunksUnknown)
+{
+	auto fieldFunction = PlaneFieldFunction();
+
+	auto chunk = glr::terrain::VoxelChunk(0, 1, 0);
+	BOOST_CHECK( !glr::terrain::classifyChunk(chunk, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, fieldFunction) );
+	BOOST_CHECK_EQUAL( chunk.type, glr::terrain::CHUNK_TYPE_UNKNOWN );
+
+	BOOST_CHECK_EQUAL( sampleChunkType(1, fieldFunction), glr::terrain::CHUNK_TYPE_SURFACE );
+}
+
+BOOST_AUTO_TEST_CASE(doesNotSampleTheDensityField)
+{
+	auto fieldFunction = PlaneFieldFunction();
+
+	auto chunk = glr::terrain::VoxelChunk(0, 2, 0);
+	glr::terrain::classifyChunk(chunk, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, fieldFunction);
+
+	BOOST_CHECK( chunk.points.isEmpty() );
+}
+
+BOOST_AUTO_TEST_CASE(unknownRangeIsNeverClassified)
+{
+	auto fieldFunction = UnboundedPlaneFieldFunction();
+
+	for (glmd::int32 y=0; y < DIMENSIONS.y; y++)
+	{
+		auto chunk = glr::terrain::VoxelChunk(0, y, 0);
+		BOOST_CHECK( !glr::terrain::classifyChunk(chunk, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, fieldFunction) );
+		BOOST_CHECK_EQUAL( chunk.type, glr::terrain::CHUNK_TYPE_UNKNOWN );
+	}
+}
+
+BOOST_AUTO_TEST_CASE(agreesWithSampling)
+{
+	auto fieldFunction = PlaneFieldFunction();
+
+	for (glmd::int32 y=0; y < DIMENSIONS.y; y++)
+	{
+		auto chunk = glr::terrain::VoxelChunk(0, y, 0);
+
+		if (glr::terrain::classifyChunk(chunk, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, fieldFunction))
+		{
+			BOOST_CHECK_EQUAL( chunk.type, sampleChunkType(y, fieldFunction) );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(includesTheBorder)
+{
+	const glm::vec3 origin = glr::terrain::getChunkOrigin(0, 1, 0, DIMENSIONS);
+
+	// The last point of the density grid (including the border) is 18 points above the origin of the chunk - a surface just below it
+	// still belongs to the chunk, while one just above it doesn't
+	auto surfaceInBorder = PlaneFieldFunction(origin.y + 17.5f);
+	auto chunk = glr::terrain::VoxelChunk(0, 1, 0);
+	BOOST_CHECK( !glr::terrain::classifyChunk(chunk, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, surfaceInBorder) );
+	BOOST_CHECK_EQUAL( sampleChunkType(1, surfaceInBorder), glr::terrain::CHUNK_TYPE_SURFACE );
+
+	auto surfaceAboveBorder = PlaneFieldFunction(origin.y + 18.5f);
+	BOOST_CHECK( glr::terrain::classifyChunk(chunk, DIMENSIONS.x, DIMENSIONS.y, DIMENSIONS.z, surfaceAboveBorder) );
+	BOOST_CHECK_EQUAL( chunk.type, glr::terrain::CHUNK_TYPE_SOLID );
+	BOOST_CHECK_EQUAL( sampleChunkType(1, surfaceAboveBorder), glr::terrain::CHUNK_TYPE_SOLID );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
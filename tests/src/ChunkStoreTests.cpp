@@ -0,0 +1,390 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <cstddef>
+#include <utility>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "terrain/ChunkStoreReader.hpp"
+#include "terrain/ChunkStoreWriter.hpp"
+#include "terrain/DensityGrid.hpp"
+
+#include "exceptions/FormatException.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const std::string FILENAME = "chunk_store_tests.glrs";
+
+glr::terrain::ChunkMeshData createMesh(glmd::uint32 numberOfVertices, glmd::float32 offset)
+{
+	glr::terrain::ChunkMeshData mesh = glr::terrain::ChunkMeshData();
+
+	for (glmd::uint32 i=0; i < numberOfVertices; i++)
+	{
+		const glmd::float32 f = (glmd::float32)i + offset;
+
+		mesh.vertices.push_back( glm::vec3(f, f * 0.5f, -f) );
+		mesh.normals.push_back( glm::vec3(0.0f, 1.0f, 0.0f) );
+		mesh.textureBlendingValues.push_back( glm::vec4(1.0f, 0.0f, 0.0f, f) );
+		mesh.indices.push_back( numberOfVertices - i - 1 );
+	}
+
+	return mesh;
+}
+
+void checkMeshesAreEqual(const glr::terrain::ChunkMeshData& a, const glr::terrain::ChunkMeshData& b)
+{
+	BOOST_REQUIRE_EQUAL( a.vertices.size(), b.vertices.size() );
+	BOOST_REQUIRE_EQUAL( a.normals.size(), b.normals.size() );
+	BOOST_REQUIRE_EQUAL( a.textureBlendingValues.size(), b.textureBlendingValues.size() );
+	BOOST_REQUIRE_EQUAL( a.indices.size(), b.indices.size() );
+
+	for (glmd::uint32 i=0; i < a.vertices.size(); i++)
+	{
+		BOOST_CHECK( a.vertices[i] == b.vertices[i] );
+		BOOST_CHECK( a.normals[i] == b.normals[i] );
+		BOOST_CHECK( a.textureBlendingValues[i] == b.textureBlendingValues[i] );
+		BOOST_CHECK_EQUAL( a.indices[i], b.indices[i] );
+	}
+}
+
+glmd::uint64 getFileSize(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
+
+	return (glmd::uint64)file.tellg();
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(chunkStore)
+
+BOOST_AUTO_TEST_CASE(writeAndReadMeshes)
+{
+	const glr::terrain::ChunkMeshData mesh1 = createMesh(30, 0.0f);
+	const glr::terrain::ChunkMeshData mesh2 = createMesh(7, 100.0f);
+
+	{
+		glr::terrain::ChunkStoreWriter writer(FILENAME, glr::terrain::CHUNK_COMPRESSION_LZ4, false);
+		writer.writeMesh( glm::ivec3(0, 0, 0), glr::terrain::LOD_HIGH, mesh1 );
+		writer.writeMesh( glm::ivec3(-3, 1, 7), glr::terrain::LOD_LOW, mesh2 );
+		writer.writeMesh( glm::ivec3(1, 0, 0), glr::terrain::LOD_HIGH, glr::terrain::ChunkMeshData() );
+
+		BOOST_CHECK_EQUAL( writer.getNumberOfChunks(glr::terrain::CHUNK_PAYLOAD_MESH), 3u );
+	}
+
+	glr::terrain::ChunkStoreReader reader(FILENAME);
+
+	BOOST_CHECK( !reader.isIndexRebuilt() );
+	BOOST_CHECK_EQUAL( reader.getChunkCoordinates(glr::terrain::CHUNK_PAYLOAD_MESH).size(), 3u );
+	BOOST_CHECK( reader.hasChunk(glm::ivec3(-3, 1, 7), glr::terrain::CHUNK_PAYLOAD_MESH) );
+	BOOST_CHECK( !reader.hasChunk(glm::ivec3(-3, 1, 7), glr::terrain::CHUNK_PAYLOAD_DENSITY) );
+
+	glr::terrain::ChunkMeshData result = glr::terrain::ChunkMeshData();
+	glr::terrain::LevelOfDetail lod = glr::terrain::LOD_UNKNOWN;
+
+	BOOST_REQUIRE( reader.readMesh(glm::ivec3(-3, 1, 7), result, &lod) );
+	checkMeshesAreEqual( result, mesh2 );
+	BOOST_CHECK_EQUAL( lod, glr::terrain::LOD_LOW );
+
+	BOOST_REQUIRE( reader.readMesh(glm::ivec3(0, 0, 0), result, &lod) );
+	checkMeshesAreEqual( result, mesh1 );
+	BOOST_CHECK_EQUAL( lod, glr::terrain::LOD_HIGH );
+
+	BOOST_REQUIRE( reader.readMesh(glm::ivec3(1, 0, 0), result) );
+	BOOST_CHECK( result.vertices.empty() );
+	BOOST_CHECK( result.indices.empty() );
+
+	BOOST_CHECK( !reader.readMesh(glm::ivec3(5, 5, 5), result) );
+}
+
+BOOST_AUTO_TEST_CASE(writeAndReadDensities)
+{
+	glr::terrain::DensityGrid densities(8, 1, 2);
+
+	for (glmd::uint32 i=0; i < densities.getNumberOfPoints(); i++)
+	{
+		densities.getData()[i] = (glmd::float32)i * 0.25f - 10.0f;
+	}
+
+	{
+		glr::terrain::ChunkStoreWriter writer(FILENAME, glr::terrain::CHUNK_COMPRESSION_NONE, false);
+		writer.writeDensity( glm::ivec3(2, -1, 4), densities );
+	}
+
+	glr::terrain::ChunkStoreReader reader(FILENAME);
+
+	glr::terrain::DensityGrid result;
+	BOOST_REQUIRE( reader.readDensity(glm::ivec3(2, -1, 4), result) );
+
+	BOOST_CHECK_EQUAL( result.getSize(), densities.getSize() );
+	BOOST_CHECK_EQUAL( result.getBorderLow(), densities.getBorderLow() );
+	BOOST_CHECK_EQUAL( result.getBorderHigh(), densities.getBorderHigh() );
+	BOOST_REQUIRE_EQUAL( result.getNumberOfPoints(), densities.getNumberOfPoints() );
+
+	for (glmd::uint32 i=0; i < densities.getNumberOfPoints(); i++)
+	{
+		BOOST_CHECK_EQUAL( result.getData()[i], densities.getData()[i] );
+	}
+}
+
+BOOST_AUTO_TEST_CASE(appendReplacesChunks)
+{
+	const glr::terrain::ChunkMeshData mesh1 = createMesh(10, 0.0f);
+	const glr::terrain::ChunkMeshData mesh2 = createMesh(12, 50.0f);
+	const glr::terrain::ChunkMeshData mesh3 = createMesh(4, 75.0f);
+
+	{
+		glr::terrain::ChunkStoreWriter writer(FILENAME, glr::terrain::CHUNK_COMPRESSION_NONE, false);
+		writer.writeMesh( glm::ivec3(0, 0, 0), glr::terrain::LOD_HIGH, mesh1 );
+		writer.writeMesh( glm::ivec3(0, 0, 1), glr::terrain::LOD_HIGH, mesh1 );
+	}
+
+	{
+		glr::terrain::ChunkStoreWriter writer(FILENAME);
+		writer.writeMesh( glm::ivec3(0, 0, 1), glr::terrain::LOD_MEDIUM, mesh2 );
+		writer.writeMesh( glm::ivec3(0, 0, 2), glr::terrain::LOD_HIGH, mesh3 );
+
+		BOOST_CHECK_EQUAL( writer.getNumberOfChunks(glr::terrain::CHUNK_PAYLOAD_MESH), 3u );
+	}
+
+	glr::terrain::ChunkStoreReader reader(FILENAME);
+	BOOST_CHECK( !reader.isIndexRebuilt() );
+	BOOST_CHECK_EQUAL( reader.getChunkCoordinates(glr::terrain::CHUNK_PAYLOAD_MESH).size(), 3u );
+
+	glr::terrain::ChunkMeshData result = glr::terrain::ChunkMeshData();
+	glr::terrain::LevelOfDetail lod = glr::terrain::LOD_UNKNOWN;
+
+	BOOST_REQUIRE( reader.readMesh(glm::ivec3(0, 0, 0), result) );
+	checkMeshesAreEqual( result, mesh1 );
+
+	// The newest record wins
+	BOOST_REQUIRE( reader.readMesh(glm::ivec3(0, 0, 1), result, &lod) );
+	checkMeshesAreEqual( result, mesh2 );
+	BOOST_CHECK_EQUAL( lod, glr::terrain::LOD_MEDIUM );
+
+	BOOST_REQUIRE( reader.readMesh(glm::ivec3(0, 0, 2), result) );
+	checkMeshesAreEqual( result, mesh3 );
+}
+
+BOOST_AUTO_TEST_CASE(missingIndexIsRebuilt)
+{
+	const glr::terrain::ChunkMeshData mesh1 = createMesh(10, 0.0f);
+	const glr::terrain::ChunkMeshData mesh2 = createMesh(3, 20.0f);
+
+	{
+		glr::terrain::ChunkStoreWriter writer(FILENAME, glr::terrain::CHUNK_COMPRESSION_NONE, false);
+		writer.writeMesh( glm::ivec3(4, 0, 0), glr::terrain::LOD_HIGH, mesh1 );
+		writer.writeMesh( glm::ivec3(4, 0, 0), glr::terrain::LOD_HIGH, mesh2 );
+		writer.writeMesh( glm::ivec3(5, 0, 0), glr::terrain::LOD_HIGH, mesh1 );
+	}
+
+	// Chop off the trailer (as if we crashed before the index was written)
+	const glmd::uint64 size = getFileSize(FILENAME);
+
+	std::vector<char> data(size);
+	{
+		std::ifstream file(FILENAME, std::ios::in | std::ios::binary);
+		file.read(&data[0], size);
+	}
+	{
+		std::ofstream file(FILENAME, std::ios::out | std::ios::binary | std::ios::trunc);
+		file.write(&data[0], size - sizeof(glr::terrain::ChunkStoreTrailer));
+	}
+
+	glr::terrain::ChunkStoreReader reader(FILENAME);
+	BOOST_CHECK( reader.isIndexRebuilt() );
+	BOOST_CHECK_EQUAL( reader.getChunkCoordinates(glr::terrain::CHUNK_PAYLOAD_MESH).size(), 2u );
+
+	glr::terrain::ChunkMeshData result = glr::terrain::ChunkMeshData();
+	BOOST_REQUIRE( reader.readMesh(glm::ivec3(4, 0, 0), result) );
+	checkMeshesAreEqual( result, mesh2 );
+}
+
+BOOST_AUTO_TEST_CASE(corruptIndexIsRebuilt)
+{
+	const glr::terrain::ChunkMeshData mesh = createMesh(10, 0.0f);
+
+	auto writeStore = [&]()
+	{
+		glr::terrain::ChunkStoreWriter writer(FILENAME, glr::terrain::CHUNK_COMPRESSION_NONE, false);
+		writer.writeMesh( glm::ivec3(1, 0, 0), glr::terrain::LOD_HIGH, mesh );
+		writer.writeMesh( glm::ivec3(2, 0, 0), glr::terrain::LOD_HIGH, mesh );
+	};
+
+	auto checkStore = [&]()
+	{
+		glr::terrain::ChunkStoreReader reader(FILENAME);
+		BOOST_CHECK( reader.isIndexRebuilt() );
+		BOOST_CHECK_EQUAL( reader.getChunkCoordinates(glr::terrain::CHUNK_PAYLOAD_MESH).size(), 2u );
+
+		glr::terrain::ChunkMeshData result = glr::terrain::ChunkMeshData();
+		BOOST_REQUIRE( reader.readMesh(glm::ivec3(2, 0, 0), result) );
+		checkMeshesAreEqual( result, mesh );
+	};
+
+	// A trailer whose index offset wraps around to the right file size when the index size is added to it
+	writeStore();
+	{
+		const glmd::uint64 size = getFileSize(FILENAME);
+
+		glr::terrain::ChunkStoreTrailer trailer = glr::terrain::ChunkStoreTrailer();
+		std::ifstream(FILENAME, std::ios::in | std::ios::binary).seekg(size - sizeof(trailer)).read((char*)&trailer, sizeof(trailer));
+
+		trailer.numberOfEntries = 1000;
+		trailer.indexOffset = size - sizeof(trailer) - (glmd::uint64)trailer.numberOfEntries * sizeof(glr::terrain::ChunkStoreIndexEntry);
+
+		std::fstream file(FILENAME, std::ios::in | std::ios::out | std::ios::binary);
+		file.seekp( size - sizeof(trailer) );
+		file.write( (const char*)&trailer, sizeof(trailer) );
+	}
+	checkStore();
+
+	// An index entry whose offset wraps around when the size of a chunk header is added to it
+	writeStore();
+	{
+		const glmd::uint64 size = getFileSize(FILENAME);
+
+		glr::terrain::ChunkStoreTrailer trailer = glr::terrain::ChunkStoreTrailer();
+		std::ifstream(FILENAME, std::ios::in | std::ios::binary).seekg(size - sizeof(trailer)).read((char*)&trailer, sizeof(trailer));
+
+		const glmd::uint64 offset = 0xFFFFFFFFFFFFFFF0ull;
+
+		std::fstream file(FILENAME, std::ios::in | std::ios::out | std::ios::binary);
+		file.seekp( trailer.indexOffset + offsetof(glr::terrain::ChunkStoreIndexEntry, offset) );
+		file.write( (const char*)&offset, sizeof(offset) );
+	}
+	checkStore();
+
+	std::remove( FILENAME.c_str() );
+}
+
+BOOST_AUTO_TEST_CASE(corruptChunkThrows)
+{
+	{
+		glr::terrain::ChunkStoreWriter writer(FILENAME, glr::terrain::CHUNK_COMPRESSION_NONE, false);
+		writer.writeMesh( glm::ivec3(0, 0, 0), glr::terrain::LOD_HIGH, createMesh(10, 0.0f) );
+	}
+
+	// Flip a byte in the payload (just after the file and chunk headers)
+	{
+		std::fstream file(FILENAME, std::ios::in | std::ios::out | std::ios::binary);
+		file.seekp( sizeof(glr::terrain::ChunkStoreFileHeader) + sizeof(glr::terrain::ChunkHeader) + 5 );
+		file.put( (char)0x7f );
+	}
+
+	glr::terrain::ChunkStoreReader reader(FILENAME);
+
+	glr::terrain::ChunkMeshData result = glr::terrain::ChunkMeshData();
+	BOOST_CHECK_THROW( reader.readMesh(glm::ivec3(0, 0, 0), result), glr::exception::FormatException );
+}
+
+BOOST_AUTO_TEST_CASE(corruptMeshThrows)
+{
+	auto missingNormal = createMesh(10, 0.0f);
+	missingNormal.normals.pop_back();
+
+	auto indexOutOfRange = createMesh(10, 0.0f);
+	indexOutOfRange.indices[3] = 10;
+
+	// Consistent payloads, but not valid meshes
+	for ( const auto& mesh : { missingNormal, indexOutOfRange } )
+	{
+		{
+			glr::terrain::ChunkStoreWriter writer(FILENAME, glr::terrain::CHUNK_COMPRESSION_NONE, false);
+			writer.writeMesh( glm::ivec3(0, 0, 0), glr::terrain::LOD_HIGH, mesh );
+		}
+
+		glr::terrain::ChunkStoreReader reader(FILENAME);
+
+		glr::terrain::ChunkMeshData result = glr::terrain::ChunkMeshData();
+		BOOST_CHECK_THROW( reader.readMesh(glm::ivec3(0, 0, 0), result), glr::exception::FormatException );
+	}
+
+	// Header sizes that don't match the record or the counts are rejected before the payload is allocated
+	const std::vector< std::pair<glmd::uint32, glmd::uint32> > corruptSizes = { {0xFFFFFFF0u, 0}, {0, 0x7FFFFFFFu}, {0, 1} };
+
+	for ( const auto& sizes : corruptSizes )
+	{
+		{
+			glr::terrain::ChunkStoreWriter writer(FILENAME, glr::terrain::CHUNK_COMPRESSION_NONE, false);
+			writer.writeMesh( glm::ivec3(0, 0, 0), glr::terrain::LOD_HIGH, createMesh(10, 0.0f) );
+		}
+
+		{
+			std::fstream file(FILENAME, std::ios::in | std::ios::out | std::ios::binary);
+			glr::terrain::ChunkHeader header = glr::terrain::ChunkHeader();
+			file.seekg( sizeof(glr::terrain::ChunkStoreFileHeader) );
+			file.read( (char*)&header, sizeof(header) );
+
+			// Adds to the sizes, so that a 0 leaves a size as it is
+			header.uncompressedSize += sizes.first;
+			header.storedSize += sizes.second;
+
+			file.seekp( sizeof(glr::terrain::ChunkStoreFileHeader) );
+			file.write( (const char*)&header, sizeof(header) );
+		}
+
+		glr::terrain::ChunkStoreReader reader(FILENAME);
+
+		glr::terrain::ChunkMeshData result = glr::terrain::ChunkMeshData();
+		BOOST_CHECK_THROW( reader.readMesh(glm::ivec3(0, 0, 0), result), glr::exception::FormatException );
+	}
+
+	std::remove( FILENAME.c_str() );
+}
+
+BOOST_AUTO_TEST_CASE(corruptDensityCountsThrow)
+{
+	// Counts that don't match the payload - including ones that would overflow, or allocate gigabytes, if the grid was resized first
+	const std::vector< glm::uvec3 > corruptCounts = { glm::uvec3(8, 1, 3), glm::uvec3(1024, 1024, 1024), glm::uvec3(0x80000000u, 0x80000000u, 0x80000000u), glm::uvec3(0xFFFFFFFFu, 1, 1) };
+
+	for ( const auto& counts : corruptCounts )
+	{
+		{
+			glr::terrain::ChunkStoreWriter writer(FILENAME, glr::terrain::CHUNK_COMPRESSION_NONE, false);
+			writer.writeDensity( glm::ivec3(0, 0, 0), glr::terrain::DensityGrid(8, 1, 2) );
+		}
+
+		// The counts aren't covered by the checksum
+		{
+			const glmd::uint32 values[3] = { counts.x, counts.y, counts.z };
+
+			std::fstream file(FILENAME, std::ios::in | std::ios::out | std::ios::binary);
+			file.seekp( sizeof(glr::terrain::ChunkStoreFileHeader) + offsetof(glr::terrain::ChunkHeader, counts) );
+			file.write( (const char*)values, sizeof(values) );
+		}
+
+		glr::terrain::ChunkStoreReader reader(FILENAME);
+
+		glr::terrain::DensityGrid result;
+		BOOST_CHECK_THROW( reader.readDensity(glm::ivec3(0, 0, 0), result), glr::exception::FormatException );
+	}
+
+	std::remove( FILENAME.c_str() );
+}
+
+BOOST_AUTO_TEST_CASE(invalidFileThrows)
+{
+	{
+		std::ofstream file(FILENAME, std::ios::out | std::ios::binary | std::ios::trunc);
+		file << "This is not a chunk store";
+	}
+
+	BOOST_CHECK_THROW( glr::terrain::ChunkStoreReader reader(FILENAME), glr::exception::FormatException );
+
+	std::remove( FILENAME.c_str() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,92 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <utility>
+#include <exception>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "terrain/DensityGrid.hpp"
+#include "exceptions/InvalidArgumentException.hpp"
+
+BOOST_AUTO_TEST_SUITE(densityGrid)
+
+BOOST_AUTO_TEST_CASE(dimensions)
+{
+	auto grid = glr::terrain::DensityGrid(16, 1, 3);
+
+	BOOST_CHECK_EQUAL( grid.getSize(), 16 );
+	BOOST_CHECK_EQUAL( grid.getMin(), -1 );
+	BOOST_CHECK_EQUAL( grid.getMax(), 19 );
+	BOOST_CHECK_EQUAL( grid.getDimension(), 20 );
+	BOOST_CHECK_EQUAL( grid.getNumberOfPoints(), 20u * 20u * 20u );
+
+	BOOST_CHECK_EQUAL( grid.getStrideZ(), 1 );
+	BOOST_CHECK_EQUAL( grid.getStrideY(), 20 );
+	BOOST_CHECK_EQUAL( grid.getStrideX(), 400 );
+
+	// The data must be aligned
+	BOOST_CHECK_EQUAL( reinterpret_cast<std::uintptr_t>(grid.getData()) % glr::terrain::DensityGrid::ALIGNMENT, 0u );
+}
+
+BOOST_AUTO_TEST_CASE(localCoordinates)
+{
+	auto grid = glr::terrain::DensityGrid(16, 1, 3);
+	grid.fill(0.0f);
+
+	// (0, 0, 0) is the first point of the chunk - the border starts at -1
+	BOOST_CHECK_EQUAL( grid.getIndex(-1, -1, -1), 0 );
+	BOOST_CHECK_EQUAL( grid.getIndex(0, 0, 0), 400 + 20 + 1 );
+	BOOST_CHECK_EQUAL( grid.getIndex(18, 18, 18), (glm::detail::int32)grid.getNumberOfPoints() - 1 );
+
+	grid.set(3, 4, 5, 1.5f);
+	BOOST_CHECK_EQUAL( grid.get(3, 4, 5), 1.5f );
+	BOOST_CHECK_EQUAL( grid.getData()[grid.getIndex(3, 4, 5)], 1.5f );
+
+	grid.at(-1, 18, 0) = -2.0f;
+	BOOST_CHECK_EQUAL( grid.get(-1, 18, 0), -2.0f );
+
+	BOOST_CHECK( grid.isInBounds(-1, -1, -1) );
+	BOOST_CHECK( grid.isInBounds(18, 18, 18) );
+	BOOST_CHECK( !grid.isInBounds(-2, 0, 0) );
+	BOOST_CHECK( !grid.isInBounds(0, 19, 0) );
+}
+
+BOOST_AUTO_TEST_CASE(copyAndMove)
+{
+	auto grid = glr::terrain::DensityGrid(4, 1, 1);
+	grid.fill(2.0f);
+	grid.set(0, 1, 2, -1.0f);
+
+	auto copy = grid;
+	BOOST_CHECK( copy.getData() != grid.getData() );
+	BOOST_CHECK_EQUAL( copy.get(0, 1, 2), -1.0f );
+	BOOST_CHECK_EQUAL( copy.get(4, 4, 4), 2.0f );
+
+	auto moved = std::move(copy);
+	BOOST_CHECK( copy.isEmpty() );
+	BOOST_CHECK_EQUAL( moved.get(0, 1, 2), -1.0f );
+}
+
+BOOST_AUTO_TEST_CASE(invalidDimensions)
+{
+	bool threwException = false;
+
+	try
+	{
+		auto grid = glr::terrain::DensityGrid(-1, 0, 0);
+	}
+	catch (const glr::exception::InvalidArgumentException& e)
+	{
+		threwException = true;
+	}
+
+	BOOST_CHECK_EQUAL( threwException, true );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,197 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <set>
+#include <array>
+#include <algorithm>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "models/MeshOptimizer.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+/**
+ * Returns an unindexed grid of size x size quads (2 triangles each), with the triangles in row order.
+ */
+glr::models::MeshData createGrid(glmd::uint32 size)
+{
+	auto data = glr::models::MeshData();
+
+	for (glmd::uint32 x=0; x < size; x++)
+	{
+		for (glmd::uint32 z=0; z < size; z++)
+		{
+			const glm::vec3 corners[4] = {
+				glm::vec3((glmd::float32)x, 0.0f, (glmd::float32)z),
+				glm::vec3((glmd::float32)x + 1.0f, 0.0f, (glmd::float32)z),
+				glm::vec3((glmd::float32)x + 1.0f, 0.0f, (glmd::float32)z + 1.0f),
+				glm::vec3((glmd::float32)x, 0.0f, (glmd::float32)z + 1.0f)
+			};
+			const glmd::uint32 triangles[6] = { 0, 1, 2, 0, 2, 3 };
+
+			for (glmd::uint32 i=0; i < 6; i++)
+			{
+				const glm::vec3& corner = corners[ triangles[i] ];
+
+				data.vertices.push_back( corner );
+				data.normals.push_back( glm::vec3(0.0f, 1.0f, 0.0f) );
+				data.textureCoordinates.push_back( glm::vec2(corner.x / size, corner.z / size) );
+				data.colors.push_back( glm::vec4(1.0f) );
+			}
+		}
+	}
+
+	return data;
+}
+
+/**
+ * Returns the triangles of data as sets of vertex positions (so that meshes can be compared regardless of vertex and triangle order).
+ */
+std::multiset< std::array<glmd::float32, 9> > getTriangles(const glr::models::MeshData& data)
+{
+	auto triangles = std::multiset< std::array<glmd::float32, 9> >();
+
+	for (glmd::uint32 t=0; t < data.indices.size() / 3; t++)
+	{
+		std::array< std::array<glmd::float32, 3>, 3 > corners;
+
+		for (glmd::uint32 i=0; i < 3; i++)
+		{
+			const glm::vec3& v = data.vertices[ data.indices[t * 3 + i] ];
+			corners[i] = {{ v.x, v.y, v.z }};
+		}
+
+		// Rotate the triangle so that it starts at its smallest corner (keeping its winding)
+		const glmd::uint32 first = std::min_element(corners.begin(), corners.end()) - corners.begin();
+
+		std::array<glmd::float32, 9> triangle;
+		for (glmd::uint32 i=0; i < 3; i++)
+			std::copy(corners[(first + i) % 3].begin(), corners[(first + i) % 3].end(), triangle.begin() + i * 3);
+
+		triangles.insert(triangle);
+	}
+
+	return triangles;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(meshOptimizer)
+
+BOOST_AUTO_TEST_CASE(weldsIdenticalVertices)
+{
+	auto data = createGrid(4);
+	auto unindexed = data;
+	for (glmd::uint32 i=0; i < unindexed.vertices.size(); i++)
+		unindexed.indices.push_back(i);
+
+	glr::models::weldVertices(data);
+
+	// A 4x4 grid of quads has 5x5 distinct corners
+	BOOST_CHECK_EQUAL( data.vertices.size(), 25 );
+	BOOST_CHECK_EQUAL( data.normals.size(), 25 );
+	BOOST_CHECK_EQUAL( data.textureCoordinates.size(), 25 );
+	BOOST_CHECK_EQUAL( data.indices.size(), 4 * 4 * 6 );
+	BOOST_CHECK( data.bones.empty() );
+
+	BOOST_CHECK( getTriangles(data) == getTriangles(unindexed) );
+}
+
+BOOST_AUTO_TEST_CASE(keepsVerticesWithDifferentAttributes)
+{
+	// The quad's two triangles are vertices 0, 1, 2 and 3, 4, 5 - vertex 3 is a copy of vertex 0, and vertex 4 a copy of vertex 2
+	auto data = createGrid(1);
+
+	// A texture seam keeps vertices 0 and 3 apart
+	data.textureCoordinates[3] = glm::vec2(0.5f, 0.5f);
+
+	glr::models::weldVertices(data);
+
+	BOOST_CHECK_EQUAL( data.vertices.size(), 5 );
+	BOOST_CHECK( data.indices[3] != data.indices[0] );
+	BOOST_CHECK_EQUAL( data.indices[4], data.indices[2] );
+
+	// So do different bone weights
+	data = createGrid(1);
+	data.bones.resize( data.vertices.size() );
+	data.bones[2].addBoneWeight(1, 1.0f);
+
+	glr::models::weldVertices(data);
+
+	BOOST_CHECK_EQUAL( data.vertices.size(), 5 );
+	BOOST_CHECK_EQUAL( data.bones.size(), 5 );
+	BOOST_CHECK_EQUAL( data.indices[3], data.indices[0] );
+	BOOST_CHECK( data.indices[4] != data.indices[2] );
+}
+
+BOOST_AUTO_TEST_CASE(improvesVertexCacheUse)
+{
+	auto data = createGrid(32);
+	glr::models::weldVertices(data);
+
+	const glmd::float32 before = glr::models::calculateAverageCacheMissRatio(data.indices, data.vertices.size());
+	const auto triangles = getTriangles(data);
+
+	glr::models::optimizeVertexCache(data.indices, data.vertices.size());
+
+	const glmd::float32 after = glr::models::calculateAverageCacheMissRatio(data.indices, data.vertices.size());
+
+	// The same triangles, in a better order (a regular grid can't get much below 0.5 misses per triangle)
+	BOOST_CHECK( getTriangles(data) == triangles );
+	BOOST_CHECK( after < before );
+	BOOST_CHECK( after < 0.8f );
+}
+
+BOOST_AUTO_TEST_CASE(averageCacheMissRatio)
+{
+	// Every vertex is used once - every one of them misses
+	auto indices = std::vector< glmd::uint32 >();
+	for (glmd::uint32 i=0; i < 30; i++)
+		indices.push_back(i);
+
+	BOOST_CHECK_CLOSE( glr::models::calculateAverageCacheMissRatio(indices, 30), 3.0f, 1e-4f );
+
+	// The same triangle over and over only misses the first time
+	indices = std::vector< glmd::uint32 >();
+	for (glmd::uint32 i=0; i < 10; i++)
+	{
+		indices.push_back(0);
+		indices.push_back(1);
+		indices.push_back(2);
+	}
+
+	BOOST_CHECK_CLOSE( glr::models::calculateAverageCacheMissRatio(indices, 3), 0.3f, 1e-4f );
+}
+
+BOOST_AUTO_TEST_CASE(ordersVerticesByFirstUse)
+{
+	auto data = createGrid(8);
+	glr::models::optimizeMesh(data);
+
+	const auto triangles = getTriangles(data);
+
+	// Every vertex is referenced, and each one is first referenced after all of the vertices before it
+	glmd::uint32 nextVertex = 0;
+	for (auto index : data.indices)
+	{
+		BOOST_REQUIRE( index <= nextVertex );
+
+		if (index == nextVertex)
+			nextVertex++;
+	}
+
+	BOOST_CHECK_EQUAL( nextVertex, data.vertices.size() );
+	BOOST_CHECK_EQUAL( data.vertices.size(), 81 );
+	BOOST_CHECK( getTriangles(data) == triangles );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
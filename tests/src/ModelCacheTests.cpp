@@ -0,0 +1,421 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "models/ModelCache.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const std::string MODEL_FILENAME = "model_cache_tests.model";
+
+glr::models::ModelData createModelData(const std::string& name, glmd::uint32 numberOfVertices)
+{
+	glr::models::ModelData data = glr::models::ModelData();
+
+	data.meshData.name = name;
+	data.meshData.vertexFormat = glr::glw::createPackedVertexFormat();
+
+	for (glmd::uint32 i=0; i < numberOfVertices; i++)
+	{
+		const glmd::float32 f = (glmd::float32)i;
+
+		data.meshData.vertices.push_back( glm::vec3(f, f * 0.5f, -f) );
+		data.meshData.normals.push_back( glm::vec3(0.0f, 1.0f, 0.0f) );
+		data.meshData.textureCoordinates.push_back( glm::vec2(f * 0.1f, 1.0f) );
+		data.meshData.colors.push_back( glm::vec4(1.0f, 0.5f, 0.0f, 1.0f) );
+
+		glr::glw::VertexBoneData bone = glr::glw::VertexBoneData();
+		bone.addBoneWeight( i % 2, 1.0f );
+		data.meshData.bones.push_back( bone );
+
+		data.meshData.indices.push_back( numberOfVertices - i - 1 );
+	}
+
+	data.materialData.name = name + "_material";
+	data.materialData.fill_mode = GL_FILL;
+	data.materialData.diffuse = glm::vec4(0.25f, 0.5f, 0.75f, 1.0f);
+	data.materialData.shininess = 12.0f;
+	data.materialData.strength = 1.0f;
+
+	data.textureData.filename = name + ".png";
+	data.textureData.settings.textureWrapS = GL_REPEAT;
+
+	data.boneData.name = name + "_bones";
+	data.boneData.boneIndexMap["root"] = 0;
+	data.boneData.boneIndexMap["arm"] = 1;
+	data.boneData.boneTransform.push_back( glr::glw::Bone() );
+	data.boneData.boneTransform.back().name = "root";
+	data.boneData.boneTransform.back().boneOffset = glm::mat4(2.0f);
+	data.boneData.boneTransform.push_back( glr::glw::Bone() );
+	data.boneData.boneTransform.back().name = "arm";
+
+	return data;
+}
+
+glr::models::AnimationSet createAnimationSet()
+{
+	glr::models::AnimationSet animationSet = glr::models::AnimationSet();
+
+	animationSet.name = "animations";
+	animationSet.globalInverseTransformation = glm::mat4(0.5f);
+	animationSet.rootBoneNode.name = "root";
+	animationSet.rootBoneNode.children.push_back( glr::glw::BoneNode() );
+	animationSet.rootBoneNode.children.back().name = "arm";
+	animationSet.rootBoneNode.children.back().transformation = glm::mat4(3.0f);
+	animationSet.rootBoneNode.children.back().children.push_back( glr::glw::BoneNode() );
+	animationSet.rootBoneNode.children.back().children.back().name = "hand";
+
+	glr::models::AnimationData animation = glr::models::AnimationData();
+	animation.name = "wave";
+	animation.duration = 2.0;
+	animation.ticksPerSecond = 24.0;
+
+	glr::glw::AnimatedBoneNode node = glr::glw::AnimatedBoneNode();
+	node.name = "arm";
+
+	for (glmd::uint32 i=0; i < 5; i++)
+	{
+		node.positionTimes.push_back( (glmd::float64)i * 0.5 );
+		node.positions.push_back( glm::vec3((glmd::float32)i, 0.0f, 0.0f) );
+		node.rotationTimes.push_back( (glmd::float64)i * 0.5 );
+		node.rotations.push_back( glm::quat(1.0f, 0.0f, 0.0f, 0.0f) );
+	}
+
+	node.scalingTimes.push_back( 0.0 );
+	node.scalings.push_back( glm::vec3(1.0f) );
+
+	animation.animatedBoneNodes["arm"] = node;
+	animationSet.animations["wave"] = animation;
+
+	return animationSet;
+}
+
+void checkModelDataIsEqual(const glr::models::ModelData& a, const glr::models::ModelData& b)
+{
+	BOOST_CHECK_EQUAL( a.meshData.name, b.meshData.name );
+	BOOST_REQUIRE_EQUAL( a.meshData.vertices.size(), b.meshData.vertices.size() );
+	BOOST_REQUIRE_EQUAL( a.meshData.normals.size(), b.meshData.normals.size() );
+	BOOST_REQUIRE_EQUAL( a.meshData.textureCoordinates.size(), b.meshData.textureCoordinates.size() );
+	BOOST_REQUIRE_EQUAL( a.meshData.colors.size(), b.meshData.colors.size() );
+	BOOST_REQUIRE_EQUAL( a.meshData.bones.size(), b.meshData.bones.size() );
+	BOOST_REQUIRE_EQUAL( a.meshData.indices.size(), b.meshData.indices.size() );
+
+	for (glmd::uint32 i=0; i < a.meshData.vertices.size(); i++)
+	{
+		BOOST_CHECK( a.meshData.vertices[i] == b.meshData.vertices[i] );
+		BOOST_CHECK( a.meshData.normals[i] == b.meshData.normals[i] );
+		BOOST_CHECK( a.meshData.textureCoordinates[i] == b.meshData.textureCoordinates[i] );
+		BOOST_CHECK( a.meshData.colors[i] == b.meshData.colors[i] );
+		BOOST_CHECK( a.meshData.bones[i].boneIds == b.meshData.bones[i].boneIds );
+		BOOST_CHECK( a.meshData.bones[i].weights == b.meshData.bones[i].weights );
+		BOOST_CHECK_EQUAL( a.meshData.indices[i], b.meshData.indices[i] );
+	}
+
+	BOOST_CHECK_EQUAL( a.meshData.vertexFormat.getStride(), b.meshData.vertexFormat.getStride() );
+	BOOST_REQUIRE_EQUAL( a.meshData.vertexFormat.getAttributes().size(), b.meshData.vertexFormat.getAttributes().size() );
+
+	for (glmd::uint32 i=0; i < a.meshData.vertexFormat.getAttributes().size(); i++)
+	{
+		BOOST_CHECK_EQUAL( a.meshData.vertexFormat.getAttributes()[i].location, b.meshData.vertexFormat.getAttributes()[i].location );
+		BOOST_CHECK_EQUAL( a.meshData.vertexFormat.getAttributes()[i].type, b.meshData.vertexFormat.getAttributes()[i].type );
+		BOOST_CHECK_EQUAL( a.meshData.vertexFormat.getAttributes()[i].offset, b.meshData.vertexFormat.getAttributes()[i].offset );
+	}
+
+	BOOST_CHECK_EQUAL( a.materialData.name, b.materialData.name );
+	BOOST_CHECK_EQUAL( a.materialData.fill_mode, b.materialData.fill_mode );
+	BOOST_CHECK( a.materialData.diffuse == b.materialData.diffuse );
+	BOOST_CHECK_EQUAL( a.materialData.shininess, b.materialData.shininess );
+
+	BOOST_CHECK_EQUAL( a.textureData.filename, b.textureData.filename );
+	BOOST_CHECK_EQUAL( a.textureData.settings.textureWrapS, b.textureData.settings.textureWrapS );
+	BOOST_CHECK_EQUAL( a.textureData.settings.textureWrapT, b.textureData.settings.textureWrapT );
+
+	BOOST_CHECK_EQUAL( a.boneData.name, b.boneData.name );
+	BOOST_CHECK( a.boneData.boneIndexMap == b.boneData.boneIndexMap );
+	BOOST_REQUIRE_EQUAL( a.boneData.boneTransform.size(), b.boneData.boneTransform.size() );
+
+	for (glmd::uint32 i=0; i < a.boneData.boneTransform.size(); i++)
+	{
+		BOOST_CHECK_EQUAL( a.boneData.boneTransform[i].name, b.boneData.boneTransform[i].name );
+		BOOST_CHECK( a.boneData.boneTransform[i].boneOffset == b.boneData.boneTransform[i].boneOffset );
+	}
+}
+
+void checkBoneNodesAreEqual(const glr::glw::BoneNode& a, const glr::glw::BoneNode& b)
+{
+	BOOST_CHECK_EQUAL( a.name, b.name );
+	BOOST_CHECK( a.transformation == b.transformation );
+	BOOST_REQUIRE_EQUAL( a.children.size(), b.children.size() );
+
+	for (glmd::uint32 i=0; i < a.children.size(); i++)
+	{
+		checkBoneNodesAreEqual( a.children[i], b.children[i] );
+	}
+}
+
+void checkAnimationSetsAreEqual(const glr::models::AnimationSet& a, const glr::models::AnimationSet& b)
+{
+	BOOST_CHECK_EQUAL( a.name, b.name );
+	BOOST_CHECK( a.globalInverseTransformation == b.globalInverseTransformation );
+	checkBoneNodesAreEqual( a.rootBoneNode, b.rootBoneNode );
+
+	BOOST_REQUIRE_EQUAL( a.animations.size(), b.animations.size() );
+
+	for ( const auto& it : a.animations )
+	{
+		BOOST_REQUIRE( b.animations.find(it.first) != b.animations.end() );
+
+		const glr::models::AnimationData& animationA = it.second;
+		const glr::models::AnimationData& animationB = b.animations.find(it.first)->second;
+
+		BOOST_CHECK_EQUAL( animationA.name, animationB.name );
+		BOOST_CHECK_EQUAL( animationA.duration, animationB.duration );
+		BOOST_CHECK_EQUAL( animationA.ticksPerSecond, animationB.ticksPerSecond );
+		BOOST_REQUIRE_EQUAL( animationA.animatedBoneNodes.size(), animationB.animatedBoneNodes.size() );
+
+		for ( const auto& track : animationA.animatedBoneNodes )
+		{
+			BOOST_REQUIRE( animationB.animatedBoneNodes.find(track.first) != animationB.animatedBoneNodes.end() );
+
+			const glr::glw::AnimatedBoneNode& nodeA = track.second;
+			const glr::glw::AnimatedBoneNode& nodeB = animationB.animatedBoneNodes.find(track.first)->second;
+
+			BOOST_CHECK_EQUAL( nodeA.name, nodeB.name );
+			BOOST_CHECK( nodeA.positionTimes == nodeB.positionTimes );
+			BOOST_CHECK( nodeA.rotationTimes == nodeB.rotationTimes );
+			BOOST_CHECK( nodeA.scalingTimes == nodeB.scalingTimes );
+			BOOST_CHECK( nodeA.positions == nodeB.positions );
+			BOOST_CHECK( nodeA.scalings == nodeB.scalings );
+			BOOST_REQUIRE_EQUAL( nodeA.rotations.size(), nodeB.rotations.size() );
+
+			for (glmd::uint32 i=0; i < nodeA.rotations.size(); i++)
+			{
+				BOOST_CHECK_EQUAL( nodeA.rotations[i].w, nodeB.rotations[i].w );
+				BOOST_CHECK_EQUAL( nodeA.rotations[i].x, nodeB.rotations[i].x );
+				BOOST_CHECK_EQUAL( nodeA.rotations[i].y, nodeB.rotations[i].y );
+				BOOST_CHECK_EQUAL( nodeA.rotations[i].z, nodeB.rotations[i].z );
+			}
+		}
+	}
+}
+
+void writeFile(const std::string& filename, const std::string& contents)
+{
+	std::ofstream file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	file << contents;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(modelCache)
+
+BOOST_AUTO_TEST_CASE(writeAndRead)
+{
+	auto modelData = std::vector< glr::models::ModelData >();
+	modelData.push_back( createModelData("mesh0", 30) );
+	modelData.push_back( createModelData("mesh1", 7) );
+	modelData.push_back( createModelData("empty", 0) );
+	const glr::models::AnimationSet animationSet = createAnimationSet();
+
+	auto data = std::vector<glmd::uint8>();
+	glr::models::model_cache::write( 1234, modelData, animationSet, data );
+
+	auto readModelData = std::vector< glr::models::ModelData >();
+	auto readAnimationSet = glr::models::AnimationSet();
+
+	BOOST_REQUIRE( glr::models::model_cache::read(&data[0], data.size(), 1234, readModelData, readAnimationSet) );
+
+	BOOST_REQUIRE_EQUAL( readModelData.size(), modelData.size() );
+
+	for (glmd::uint32 i=0; i < modelData.size(); i++)
+	{
+		checkModelDataIsEqual( modelData[i], readModelData[i] );
+	}
+
+	checkAnimationSetsAreEqual( animationSet, readAnimationSet );
+}
+
+BOOST_AUTO_TEST_CASE(arraysAreAligned)
+{
+	auto modelData = std::vector< glr::models::ModelData >();
+	modelData.push_back( createModelData("mesh", 3) );
+
+	auto data = std::vector<glmd::uint8>();
+	glr::models::model_cache::write( 0, modelData, glr::models::AnimationSet(), data );
+
+	// The first array is the name of the mesh, right after the file header
+	glr::models::ModelCacheArrayHeader header = glr::models::ModelCacheArrayHeader();
+	std::memcpy( &header, &data[sizeof(glr::models::ModelCacheFileHeader)], sizeof(header) );
+
+	BOOST_CHECK_EQUAL( header.numberOfElements, 4u );
+	BOOST_CHECK_EQUAL( header.elementSize, 1u );
+
+	// The vertices follow - the name is padded to 16 bytes, so that the vertices start on a 16 byte boundary after their header
+	const glmd::uint32 verticesOffset = sizeof(glr::models::ModelCacheFileHeader) + sizeof(glr::models::ModelCacheArrayHeader) + 16 + sizeof(glr::models::ModelCacheArrayHeader);
+	std::memcpy( &header, &data[verticesOffset - sizeof(header)], sizeof(header) );
+
+	BOOST_CHECK_EQUAL( verticesOffset % glr::models::model_cache::ALIGNMENT, 0u );
+	BOOST_CHECK_EQUAL( header.numberOfElements, 3u );
+	BOOST_CHECK_EQUAL( header.elementSize, sizeof(glm::vec3) );
+	BOOST_CHECK_EQUAL( std::memcmp(&data[verticesOffset], &modelData[0].meshData.vertices[0], 3 * sizeof(glm::vec3)), 0 );
+}
+
+BOOST_AUTO_TEST_CASE(invalidDataIsRejected)
+{
+	auto modelData = std::vector< glr::models::ModelData >();
+	modelData.push_back( createModelData("mesh", 10) );
+	const glr::models::AnimationSet animationSet = createAnimationSet();
+
+	auto data = std::vector<glmd::uint8>();
+	glr::models::model_cache::write( 42, modelData, animationSet, data );
+
+	auto readModelData = std::vector< glr::models::ModelData >();
+	auto readAnimationSet = glr::models::AnimationSet();
+
+	// A different source
+	BOOST_CHECK( !glr::models::model_cache::read(&data[0], data.size(), 43, readModelData, readAnimationSet) );
+
+	// Truncated
+	for (glmd::uint32 size = 0; size < data.size(); size += 7)
+	{
+		BOOST_CHECK( !glr::models::model_cache::read(&data[0], size, 42, readModelData, readAnimationSet) );
+	}
+
+	// Another version
+	auto otherVersion = data;
+	otherVersion[4]++;
+	BOOST_CHECK( !glr::models::model_cache::read(&otherVersion[0], otherVersion.size(), 42, readModelData, readAnimationSet) );
+
+	// Corrupt vertex attributes - find them by their array header (an aligned header with their element size and number of elements)
+	const auto& attributes = modelData[0].meshData.vertexFormat.getAttributes();
+	glmd::uint32 attributesOffset = 0;
+
+	for (glmd::uint32 offset = sizeof(glr::models::ModelCacheFileHeader); offset + sizeof(glr::models::ModelCacheArrayHeader) <= data.size() && attributesOffset == 0; offset += glr::models::model_cache::ALIGNMENT)
+	{
+		glr::models::ModelCacheArrayHeader header = glr::models::ModelCacheArrayHeader();
+		std::memcpy( &header, &data[offset], sizeof(header) );
+
+		if (header.elementSize == sizeof(glr::glw::VertexAttribute) && header.numberOfElements == attributes.size())
+		{
+			attributesOffset = offset + sizeof(header);
+		}
+	}
+
+	BOOST_REQUIRE( attributesOffset != 0 );
+
+	auto corruptAttributes = [&](glmd::uint32 location, glmd::uint32 numberOfComponents, glmd::uint32 type)
+	{
+		auto corrupt = data;
+		glr::glw::VertexAttribute attribute = attributes[1];
+		attribute.location = location;
+		attribute.numberOfComponents = numberOfComponents;
+		attribute.type = (glr::glw::VertexAttributeType)type;
+		std::memcpy( &corrupt[attributesOffset + sizeof(attribute)], &attribute, sizeof(attribute) );
+
+		return corrupt;
+	};
+
+	// Sanity check - the unchanged attribute is read fine
+	auto corrupt = corruptAttributes( attributes[1].location, attributes[1].numberOfComponents, attributes[1].type );
+	BOOST_CHECK( glr::models::model_cache::read(&corrupt[0], corrupt.size(), 42, readModelData, readAnimationSet) );
+	readModelData.clear();
+	readAnimationSet = glr::models::AnimationSet();
+
+	corrupt = corruptAttributes( attributes[0].location, attributes[1].numberOfComponents, attributes[1].type );
+	BOOST_CHECK( !glr::models::model_cache::read(&corrupt[0], corrupt.size(), 42, readModelData, readAnimationSet) );
+	corrupt = corruptAttributes( attributes[1].location, 5, attributes[1].type );
+	BOOST_CHECK( !glr::models::model_cache::read(&corrupt[0], corrupt.size(), 42, readModelData, readAnimationSet) );
+	corrupt = corruptAttributes( attributes[1].location, 0, attributes[1].type );
+	BOOST_CHECK( !glr::models::model_cache::read(&corrupt[0], corrupt.size(), 42, readModelData, readAnimationSet) );
+	corrupt = corruptAttributes( attributes[1].location, attributes[1].numberOfComponents, 99 );
+	BOOST_CHECK( !glr::models::model_cache::read(&corrupt[0], corrupt.size(), 42, readModelData, readAnimationSet) );
+	corrupt = corruptAttributes( 1000, attributes[1].numberOfComponents, attributes[1].type );
+	BOOST_CHECK( !glr::models::model_cache::read(&corrupt[0], corrupt.size(), 42, readModelData, readAnimationSet) );
+
+	// Nothing is handed back from a failed read
+	BOOST_CHECK( readModelData.empty() );
+	BOOST_CHECK( readAnimationSet.animations.empty() );
+}
+
+BOOST_AUTO_TEST_CASE(cacheFiles)
+{
+	writeFile( MODEL_FILENAME, "a model" );
+
+	const glmd::uint64 sourceHash = glr::models::model_cache::calculateSourceHash( "model", MODEL_FILENAME );
+
+	// The hash depends on the name the model is loaded with, and the contents of the file
+	BOOST_CHECK( glr::models::model_cache::calculateSourceHash("model2", MODEL_FILENAME) != sourceHash );
+
+	writeFile( MODEL_FILENAME, "an edited model" );
+	BOOST_CHECK( glr::models::model_cache::calculateSourceHash("model", MODEL_FILENAME) != sourceHash );
+
+	std::remove( MODEL_FILENAME.c_str() );
+
+	glr::models::ModelCache cache = glr::models::ModelCache( "./" );
+	std::remove( cache.getCacheFilename(sourceHash).c_str() );
+
+	auto modelData = std::vector< glr::models::ModelData >();
+	modelData.push_back( createModelData("mesh", 10) );
+	const glr::models::AnimationSet animationSet = createAnimationSet();
+
+	auto readModelData = std::vector< glr::models::ModelData >();
+	auto readAnimationSet = glr::models::AnimationSet();
+
+	BOOST_CHECK( !cache.load(sourceHash, readModelData, readAnimationSet) );
+
+	cache.save( sourceHash, modelData, animationSet );
+
+	BOOST_REQUIRE( cache.load(sourceHash, readModelData, readAnimationSet) );
+	BOOST_REQUIRE_EQUAL( readModelData.size(), 1u );
+	checkModelDataIsEqual( modelData[0], readModelData[0] );
+	checkAnimationSetsAreEqual( animationSet, readAnimationSet );
+
+	// Saving a model that is already cached (i.e. from another thread) is harmless
+	cache.save( sourceHash, modelData, animationSet );
+	BOOST_CHECK( cache.load(sourceHash, readModelData, readAnimationSet) );
+
+	std::remove( cache.getCacheFilename(sourceHash).c_str() );
+}
+
+BOOST_AUTO_TEST_CASE(objMaterialLibrariesAreHashed)
+{
+	const std::string objFilename = "model_cache_tests.obj";
+	const std::string mtlFilename = "model_cache_tests materials.mtl";
+
+	writeFile( objFilename, "# a model\nmtllib " + mtlFilename + "  \r\nv 0 0 0\n" );
+	writeFile( mtlFilename, "newmtl a\nKd 1 0 0\n" );
+
+	const glmd::uint64 sourceHash = glr::models::model_cache::calculateSourceHash( "model", objFilename );
+	BOOST_CHECK_EQUAL( glr::models::model_cache::calculateSourceHash("model", objFilename), sourceHash );
+
+	// Editing (or removing) the material library changes the hash, even though the .obj file hasn't changed
+	writeFile( mtlFilename, "newmtl a\nKd 0 1 0\n" );
+	BOOST_CHECK( glr::models::model_cache::calculateSourceHash("model", objFilename) != sourceHash );
+
+	std::remove( mtlFilename.c_str() );
+	BOOST_CHECK( glr::models::model_cache::calculateSourceHash("model", objFilename) != sourceHash );
+
+	std::remove( objFilename.c_str() );
+}
+
+BOOST_AUTO_TEST_CASE(directorySeparatorIsAdded)
+{
+	BOOST_CHECK_EQUAL( glr::models::ModelCache("cache").getCacheFilename(0x12ab), "cache/00000000000012ab.glrmodel" );
+	BOOST_CHECK_EQUAL( glr::models::ModelCache("cache/").getCacheFilename(0x12ab), "cache/00000000000012ab.glrmodel" );
+	BOOST_CHECK_EQUAL( glr::models::ModelCache("").getCacheFilename(0x12ab), "00000000000012ab.glrmodel" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "terrain/dual_contouring/QefSolver.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const glmd::float32 TOLERANCE = 1e-4f;
+
+bool isClose(const glm::vec3& a, const glm::vec3& b)
+{
+	return glm::length(a - b) < TOLERANCE;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(qefSolver)
+
+BOOST_AUTO_TEST_CASE(findsCorner)
+{
+	// Three perpendicular planes meet at a single point
+	const glm::vec3 corner = glm::vec3(0.3f, 0.6f, 0.2f);
+
+	auto qef = glr::terrain::dual_contouring::QefSolver();
+	qef.add(glm::vec3(corner.x, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+	qef.add(glm::vec3(1.0f, corner.y, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	qef.add(glm::vec3(0.0f, 1.0f, corner.z), glm::vec3(0.0f, 0.0f, 1.0f));
+
+	const glm::vec3 position = qef.solve();
+
+	BOOST_CHECK( isClose(position, corner) );
+	BOOST_CHECK( qef.getError(position) < TOLERANCE );
+}
+
+BOOST_AUTO_TEST_CASE(findsRotatedCorner)
+{
+	// The same corner, with the planes rotated so that A^T A isn't diagonal
+	const glm::vec3 corner = glm::vec3(0.5f, 0.4f, 0.7f);
+	const glm::vec3 normals[3] = {
+		glm::normalize( glm::vec3(1.0f, 1.0f, 0.0f) ),
+		glm::normalize( glm::vec3(-1.0f, 1.0f, 0.5f) ),
+		glm::normalize( glm::vec3(0.2f, -0.3f, 1.0f) )
+	};
+
+	auto qef = glr::terrain::dual_contouring::QefSolver();
+
+	for (glmd::int32 i=0; i < 3; i++)
+	{
+		// Any point on each plane will do
+		const glm::vec3 tangent = glm::normalize( glm::cross(normals[i], glm::vec3(0.3f, 0.5f, 0.8f)) );
+		qef.add(corner + tangent * 0.25f, normals[i]);
+	}
+
+	BOOST_CHECK( isClose(qef.solve(), corner) );
+}
+
+BOOST_AUTO_TEST_CASE(edgeResolvesTowardsMassPoint)
+{
+	// Two planes meet along a line parallel to the z axis (x = 0.5, y = 0.5) - the solution is the point on that line closest to the
+	// mass point
+	auto qef = glr::terrain::dual_contouring::QefSolver();
+	qef.add(glm::vec3(0.5f, 0.0f, 0.2f), glm::vec3(1.0f, 0.0f, 0.0f));
+	qef.add(glm::vec3(0.5f, 1.0f, 0.2f), glm::vec3(1.0f, 0.0f, 0.0f));
+	qef.add(glm::vec3(0.0f, 0.5f, 0.8f), glm::vec3(0.0f, 1.0f, 0.0f));
+	qef.add(glm::vec3(1.0f, 0.5f, 0.8f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+	BOOST_CHECK( isClose(qef.solve(), glm::vec3(0.5f, 0.5f, 0.5f)) );
+}
+
+BOOST_AUTO_TEST_CASE(flatSurfaceProjectsMassPoint)
+{
+	auto qef = glr::terrain::dual_contouring::QefSolver();
+	qef.add(glm::vec3(0.0f, 0.25f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	qef.add(glm::vec3(1.0f, 0.25f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	qef.add(glm::vec3(1.0f, 0.25f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	qef.add(glm::vec3(0.0f, 0.25f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+	BOOST_CHECK( isClose(qef.getMassPoint(), glm::vec3(0.5f, 0.25f, 0.5f)) );
+	BOOST_CHECK( isClose(qef.solve(), glm::vec3(0.5f, 0.25f, 0.5f)) );
+}
+
+BOOST_AUTO_TEST_CASE(emptySolverReturnsOrigin)
+{
+	auto qef = glr::terrain::dual_contouring::QefSolver();
+
+	BOOST_CHECK_EQUAL( qef.getNumberOfPoints(), 0 );
+	BOOST_CHECK( isClose(qef.solve(), glm::vec3(0.0f)) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,268 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "RenderQueue.hpp"
+#include "RenderStateTracker.hpp"
+
+#include "glw/Constants.hpp"
+
+#include "exceptions/InvalidArgumentException.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+// Stand-ins for state objects - the queue only compares their addresses
+glr::glw::ITexture* texture(glmd::uint32 i)
+{
+	static char textures[16][16];
+	return reinterpret_cast<glr::glw::ITexture*>( &textures[i][0] );
+}
+
+glr::glw::IMaterial* material(glmd::uint32 i)
+{
+	static char materials[16][16];
+	return reinterpret_cast<glr::glw::IMaterial*>( &materials[i][0] );
+}
+
+glr::DrawItem createItem(glmd::uint32 id)
+{
+	auto item = glr::DrawItem();
+	item.modelMatrix[3][0] = (float) id;
+
+	return item;
+}
+
+glmd::uint32 getId(const glr::DrawItem& item)
+{
+	return (glmd::uint32) item.modelMatrix[3][0];
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(renderQueue)
+
+BOOST_AUTO_TEST_CASE(sortByKey)
+{
+	auto queue = glr::RenderQueue( nullptr );
+
+	const std::vector< glmd::uint64 > keys = { 0x0003000000000000ull, 0x0000000000000005ull, 0x0001000200000000ull, 0xFFFFFFFFFFFFFFFFull, 0ull, 0x0001000100000000ull };
+	for ( glmd::uint32 i = 0; i < keys.size(); i++ )
+		queue.push( createItem(i), keys[i] );
+
+	BOOST_CHECK_EQUAL( queue.getNumberOfItems(), keys.size() );
+
+	queue.sort();
+
+	const std::vector< glmd::uint32 > expected = { 4, 1, 5, 2, 0, 3 };
+	BOOST_REQUIRE_EQUAL( queue.getItems().size(), expected.size() );
+	for ( glmd::uint32 i = 0; i < expected.size(); i++ )
+		BOOST_CHECK_EQUAL( getId(queue.getItems()[i]), expected[i] );
+}
+
+BOOST_AUTO_TEST_CASE(sortIsStable)
+{
+	auto queue = glr::RenderQueue( nullptr );
+
+	// Items with the same key must keep the order they were added in (i.e. for transparent items sorted by depth)
+	for ( glmd::uint32 i = 0; i < 100; i++ )
+		queue.push( createItem(i), (glmd::uint64)(i % 3) << 40 );
+
+	queue.sort();
+
+	const auto& items = queue.getItems();
+	for ( glmd::uint32 i = 1; i < items.size(); i++ )
+	{
+		const glmd::uint32 previous = getId(items[i - 1]);
+		const glmd::uint32 current = getId(items[i]);
+
+		if ( previous % 3 == current % 3 )
+			BOOST_CHECK_LT( previous, current );
+		else
+			BOOST_CHECK_LT( previous % 3, current % 3 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE(clear)
+{
+	auto queue = glr::RenderQueue( nullptr );
+	queue.push( createItem(0), 1 );
+	queue.push( createItem(1), 0 );
+	queue.sort();
+
+	queue.clear();
+	BOOST_CHECK_EQUAL( queue.getNumberOfItems(), 0u );
+
+	queue.push( createItem(2), 0 );
+	queue.sort();
+	BOOST_REQUIRE_EQUAL( queue.getNumberOfItems(), 1u );
+	BOOST_CHECK_EQUAL( getId(queue.getItems()[0]), 2u );
+}
+
+BOOST_AUTO_TEST_CASE(sortKeys)
+{
+	// The shader program decides the order before anything else
+	BOOST_CHECK_LT( glr::RenderQueue::createSortKey(1, texture(5), material(5), nullptr), glr::RenderQueue::createSortKey(2, texture(0), material(0), nullptr) );
+
+	// The same state always gives the same key
+	BOOST_CHECK_EQUAL( glr::RenderQueue::createSortKey(3, texture(1), material(2), nullptr), glr::RenderQueue::createSortKey(3, texture(1), material(2), nullptr) );
+
+	// Different state gives a different key
+	BOOST_CHECK_NE( glr::RenderQueue::createSortKey(3, texture(1), material(2), nullptr), glr::RenderQueue::createSortKey(3, texture(2), material(2), nullptr) );
+	BOOST_CHECK_NE( glr::RenderQueue::createSortKey(3, texture(1), material(2), nullptr), glr::RenderQueue::createSortKey(3, texture(1), material(3), nullptr) );
+}
+
+BOOST_AUTO_TEST_CASE(sortGroupsState)
+{
+	auto queue = glr::RenderQueue( nullptr );
+
+	// 4 textures and 4 materials, interleaved so that every item changes both
+	for ( glmd::uint32 i = 0; i < 64; i++ )
+	{
+		auto item = createItem(i);
+		item.texture = texture(i % 4);
+		item.material = material((i / 4) % 4);
+		queue.push( item );
+	}
+
+	queue.sort();
+
+	auto tracker = glr::RenderStateTracker();
+	for ( const auto& item : queue.getItems() )
+	{
+		tracker.setTexture( item.texture );
+		tracker.setMaterial( item.material );
+		tracker.draw();
+	}
+
+	// Each texture is bound once, and each material once per texture
+	BOOST_CHECK_EQUAL( tracker.getStatistics().drawCalls, 64u );
+	BOOST_CHECK_EQUAL( tracker.getStatistics().textureChanges, 4u );
+	BOOST_CHECK_EQUAL( tracker.getStatistics().materialChanges, 16u );
+}
+
+BOOST_AUTO_TEST_CASE(countInstances)
+{
+	auto mesh = reinterpret_cast<glr::glw::IMesh*>( texture(12) );
+	auto otherMesh = reinterpret_cast<glr::glw::IMesh*>( texture(13) );
+
+	auto items = std::vector< glr::DrawItem >( 10, createItem(0) );
+	for ( auto& item : items )
+	{
+		item.texture = texture(0);
+		item.material = material(0);
+		item.mesh = mesh;
+	}
+
+	// Items 0 - 3 can be instanced, item 4 has bones, items 5 - 6 can be instanced, and items 7 - 9 each use a different state
+	items[4].numberOfBones = 1;
+	items[7].mesh = otherMesh;
+	items[8].texture = texture(1);
+	items[9].material = material(1);
+
+	BOOST_CHECK_EQUAL( glr::RenderQueue::countInstances(items, 0, 100), 4u );
+	BOOST_CHECK_EQUAL( glr::RenderQueue::countInstances(items, 2, 100), 2u );
+	BOOST_CHECK_EQUAL( glr::RenderQueue::countInstances(items, 4, 100), 1u );
+	BOOST_CHECK_EQUAL( glr::RenderQueue::countInstances(items, 5, 100), 2u );
+	BOOST_CHECK_EQUAL( glr::RenderQueue::countInstances(items, 7, 100), 1u );
+	BOOST_CHECK_EQUAL( glr::RenderQueue::countInstances(items, 8, 100), 1u );
+	BOOST_CHECK_EQUAL( glr::RenderQueue::countInstances(items, 9, 100), 1u );
+
+	// Batches are split at the maximum number of instances
+	BOOST_CHECK_EQUAL( glr::RenderQueue::countInstances(items, 0, 3), 3u );
+	BOOST_CHECK_EQUAL( glr::RenderQueue::countInstances(items, 3, 3), 1u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(renderStateTracker)
+
+BOOST_AUTO_TEST_CASE(redundantChanges)
+{
+	auto tracker = glr::RenderStateTracker();
+
+	BOOST_CHECK( tracker.setTexture( texture(0) ) );
+	BOOST_CHECK( !tracker.setTexture( texture(0) ) );
+	BOOST_CHECK( tracker.setTexture( texture(1) ) );
+
+	BOOST_CHECK( tracker.setMaterial( material(0) ) );
+	BOOST_CHECK( !tracker.setMaterial( material(0) ) );
+
+	auto bones = glr::glw::StreamingBufferRange();
+	bones.bufferId = 1;
+	bones.size = 6400;
+	BOOST_CHECK( tracker.setBones( bones ) );
+	BOOST_CHECK( !tracker.setBones( bones ) );
+
+	bones.offset = 6400;
+	BOOST_CHECK( tracker.setBones( bones ) );
+
+	const auto& statistics = tracker.getStatistics();
+	BOOST_CHECK_EQUAL( statistics.textureChanges, 2u );
+	BOOST_CHECK_EQUAL( statistics.materialChanges, 1u );
+	BOOST_CHECK_EQUAL( statistics.boneChanges, 2u );
+	BOOST_CHECK_EQUAL( statistics.redundantChangesSkipped, 3u );
+}
+
+BOOST_AUTO_TEST_CASE(instancedDraws)
+{
+	auto tracker = glr::RenderStateTracker();
+	tracker.draw();
+	tracker.drawInstanced( 50 );
+	tracker.drawInstanced( 2 );
+
+	const auto& statistics = tracker.getStatistics();
+	BOOST_CHECK_EQUAL( statistics.drawCalls, 3u );
+	BOOST_CHECK_EQUAL( statistics.instancedDrawCalls, 2u );
+	BOOST_CHECK_EQUAL( statistics.instances, 52u );
+}
+
+BOOST_AUTO_TEST_CASE(pushBones)
+{
+	auto queue = glr::RenderQueue( nullptr );
+	auto bones = std::vector< glm::mat4 >( glr::glw::Constants::MAX_NUMBER_OF_BONES_PER_MESH + 1, glm::mat4(1.0f) );
+
+	// Bones are appended, so each item's bones start where the previous ones ended
+	BOOST_CHECK_EQUAL( queue.pushBones( bones, 10 ), 0u );
+	BOOST_CHECK_EQUAL( queue.pushBones( bones, 3 ), 10u );
+	BOOST_CHECK_EQUAL( queue.pushBones( bones, 0 ), 13u );
+
+	BOOST_CHECK_THROW( queue.pushBones( bones, bones.size() ), glr::exception::InvalidArgumentException );
+	BOOST_CHECK_THROW( queue.pushBones( std::vector< glm::mat4 >(2), 3 ), glr::exception::InvalidArgumentException );
+
+	// Clearing the queue clears the bones
+	queue.clear();
+	BOOST_CHECK_EQUAL( queue.pushBones( bones, 1 ), 0u );
+}
+
+BOOST_AUTO_TEST_CASE(shaderProgramChangeForgetsBindPointState)
+{
+	auto tracker = glr::RenderStateTracker();
+	auto program1 = reinterpret_cast<glr::shaders::IShaderProgram*>( texture(10) );
+	auto program2 = reinterpret_cast<glr::shaders::IShaderProgram*>( texture(11) );
+
+	BOOST_CHECK( tracker.setShaderProgram( program1 ) );
+	BOOST_CHECK( tracker.setTexture( texture(0) ) );
+	BOOST_CHECK( tracker.setMaterial( material(0) ) );
+	BOOST_CHECK( !tracker.setShaderProgram( program1 ) );
+
+	// The material is bound to a bind point of the shader program, so has to be bound again - but the texture doesn't
+	BOOST_CHECK( tracker.setShaderProgram( program2 ) );
+	BOOST_CHECK( !tracker.setTexture( texture(0) ) );
+	BOOST_CHECK( tracker.setMaterial( material(0) ) );
+
+	BOOST_CHECK_EQUAL( tracker.getStatistics().shaderProgramChanges, 2u );
+
+	tracker.reset();
+	BOOST_CHECK_EQUAL( tracker.getStatistics().shaderProgramChanges, 0u );
+	BOOST_CHECK( tracker.setShaderProgram( program1 ) );
+	BOOST_CHECK( tracker.setTexture( texture(0) ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,136 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <cmath>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "terrain/SimplexNoiseFieldFunction.hpp"
+#include "terrain/VoxelChunk.hpp"
+#include "terrain/VoxelChunkNoiseGenerator.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+/**
+ * A field function that only implements getNoise(), so it uses the default getNoiseBatch().
+ */
+class PlaneFieldFunction : public glr::terrain::IFieldFunction
+{
+public:
+	virtual glmd::float32 getNoise(glmd::float32 x, glmd::float32 y, glmd::float32 z)
+	{
+		return y - 0.25f * x + 0.5f * z;
+	}
+};
+
+void createPoints(std::vector<glmd::float32>& x, std::vector<glmd::float32>& y, std::vector<glmd::float32>& z, glmd::uint32 count)
+{
+	for (glmd::uint32 i=0; i < count; i++)
+	{
+		// Includes negative coordinates, and points that are not on the integer lattice
+		x.push_back( -40.0f + (glmd::float32)i * 0.37f );
+		y.push_back( 13.0f - (glmd::float32)i * 0.11f );
+		z.push_back( (glmd::float32)(i % 17) * 1.9f - 16.0f );
+	}
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(simplexNoiseFieldFunction)
+
+BOOST_AUTO_TEST_CASE(defaultBatchCallsGetNoise)
+{
+	auto fieldFunction = PlaneFieldFunction();
+
+	auto x = std::vector<glmd::float32>();
+	auto y = std::vector<glmd::float32>();
+	auto z = std::vector<glmd::float32>();
+	createPoints(x, y, z, 37);
+
+	auto densities = std::vector<glmd::float32>(x.size());
+	fieldFunction.getNoiseBatch(&x[0], &y[0], &z[0], &densities[0], (glmd::uint32)x.size());
+
+	for (glmd::uint32 i=0; i < x.size(); i++)
+		BOOST_CHECK_EQUAL( densities[i], fieldFunction.getNoise(x[i], y[i], z[i]) );
+}
+
+BOOST_AUTO_TEST_CASE(batchMatchesScalar)
+{
+	// 1003 points, so the SIMD paths also have a partially filled register left over
+	auto x = std::vector<glmd::float32>();
+	auto y = std::vector<glmd::float32>();
+	auto z = std::vector<glmd::float32>();
+	createPoints(x, y, z, 1003);
+
+	const glr::terrain::SimdInstructionSet instructionSets[] = { glr::terrain::SIMD_NONE, glr::terrain::SIMD_SSE4_1, glr::terrain::SIMD_AVX2 };
+
+	for ( auto instructionSet : instructionSets )
+	{
+		auto fieldFunction = glr::terrain::SimplexNoiseFieldFunction(1.0f / 16.0f, 3, 42, instructionSet);
+
+		BOOST_CHECK( fieldFunction.getInstructionSet() <= instructionSet );
+
+		auto densities = std::vector<glmd::float32>(x.size());
+		fieldFunction.getNoiseBatch(&x[0], &y[0], &z[0], &densities[0], (glmd::uint32)x.size());
+
+		for (glmd::uint32 i=0; i < x.size(); i++)
+		{
+			const glmd::float32 expected = fieldFunction.getNoise(x[i], y[i], z[i]);
+
+			BOOST_CHECK_SMALL( densities[i] - expected, 1e-5f );
+			BOOST_CHECK( std::abs(densities[i]) <= 1.5f );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(noiseVariesAndDependsOnSeed)
+{
+	auto a = glr::terrain::SimplexNoiseFieldFunction(1.0f / 16.0f, 1, 1);
+	auto b = glr::terrain::SimplexNoiseFieldFunction(1.0f / 16.0f, 1, 2);
+
+	glmd::uint32 numberDifferent = 0;
+	glmd::float32 min = 1.0f;
+	glmd::float32 max = -1.0f;
+
+	for (glmd::int32 i=0; i < 100; i++)
+	{
+		const glmd::float32 value = a.getNoise((glmd::float32)i * 3.1f, 5.0f, (glmd::float32)i * -1.7f);
+
+		if (value != b.getNoise((glmd::float32)i * 3.1f, 5.0f, (glmd::float32)i * -1.7f))
+			numberDifferent++;
+
+		min = std::min(min, value);
+		max = std::max(max, value);
+	}
+
+	BOOST_CHECK( numberDifferent > 90 );
+	BOOST_CHECK( min < -0.2f );
+	BOOST_CHECK( max > 0.2f );
+}
+
+BOOST_AUTO_TEST_CASE(generateNoiseUsesBatch)
+{
+	auto fieldFunction = glr::terrain::SimplexNoiseFieldFunction();
+
+	auto chunk = glr::terrain::VoxelChunk(1, -1, 2);
+	glr::terrain::generateNoise(chunk, 4, 4, 4, fieldFunction);
+
+	auto reference = glr::terrain::VoxelChunk(1, -1, 2);
+	auto scalarFieldFunction = glr::terrain::SimplexNoiseFieldFunction(1.0f / 32.0f, 4, 0, glr::terrain::SIMD_NONE);
+	glr::terrain::generateNoise(reference, 4, 4, 4, scalarFieldFunction);
+
+	BOOST_REQUIRE_EQUAL( chunk.points.getNumberOfPoints(), reference.points.getNumberOfPoints() );
+
+	for (glmd::uint32 i=0; i < chunk.points.getNumberOfPoints(); i++)
+		BOOST_CHECK_SMALL( chunk.points.getData()[i] - reference.points.getData()[i], 1e-5f );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
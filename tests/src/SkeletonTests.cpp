@@ -0,0 +1,451 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <cmath>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include "glw/Skeleton.hpp"
+#include "glw/AnimationTracks.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+glm::mat4 createTransformation(glmd::float32 x, glmd::float32 angle)
+{
+	return glm::translate( glm::mat4(1.0f), glm::vec3(x, 1.0f, 0.0f) ) * glm::mat4_cast( glm::angleAxis(angle, glm::vec3(0.0f, 0.0f, 1.0f)) );
+}
+
+/**
+ * Returns a tree of depth levels, where every node has 2 children - nodes are named after their path from the root ("n", "n0", "n01", ...).
+ */
+glr::glw::BoneNode createTree(const std::string& name, glmd::uint32 levels)
+{
+	auto node = glr::glw::BoneNode();
+	node.name = name;
+	node.transformation = createTransformation( (glmd::float32)name.size(), 0.1f * name.size() );
+
+	if (levels > 1)
+	{
+		node.children.push_back( createTree(name + "0", levels - 1) );
+		node.children.push_back( createTree(name + "1", levels - 1) );
+	}
+
+	return node;
+}
+
+/**
+ * Returns an animation of every node in the tree, except the nodes ending in "1" (which keep their own transformation).  Keys are at
+ * uneven times, and some tracks have a single key.
+ */
+void createAnimatedBoneNodes(const glr::glw::BoneNode& node, std::map< std::string, glr::glw::AnimatedBoneNode >& animatedBoneNodes)
+{
+	if (node.name.back() != '1')
+	{
+		auto abn = glr::glw::AnimatedBoneNode();
+		abn.name = node.name;
+
+		const glmd::uint32 numberOfKeys = (node.name.size() == 3 ? 1 : 6);
+
+		for (glmd::uint32 i=0; i < numberOfKeys; i++)
+		{
+			const glmd::float64 time = i * i * 0.5;
+			const glmd::float32 f = (glmd::float32)i;
+
+			abn.positionTimes.push_back( time );
+			abn.rotationTimes.push_back( time );
+			abn.scalingTimes.push_back( time );
+			abn.positions.push_back( glm::vec3(f, 2.0f * f, node.name.size()) );
+			abn.rotations.push_back( glm::angleAxis(0.3f * f, glm::normalize(glm::vec3(1.0f, f, 0.5f))) );
+			abn.scalings.push_back( glm::vec3(1.0f + 0.1f * f) );
+		}
+
+		animatedBoneNodes[ node.name ] = abn;
+	}
+
+	for ( auto& child : node.children )
+	{
+		createAnimatedBoneNodes( child, animatedBoneNodes );
+	}
+}
+
+/**
+ * Gives a bone to every node with an even length name, in reverse order of name.
+ */
+glr::glw::BoneData createBoneData(const glr::glw::Skeleton& skeleton)
+{
+	auto boneData = glr::glw::BoneData();
+
+	auto names = std::vector< std::string >();
+	for ( auto& name : skeleton.getNames() )
+	{
+		if (name.size() % 2 == 0)
+		{
+			names.push_back( name );
+		}
+	}
+
+	for ( glmd::uint32 i=0; i < names.size(); i++ )
+	{
+		const std::string& name = names[ names.size() - 1 - i ];
+
+		auto bone = glr::glw::Bone();
+		bone.name = name;
+		bone.boneOffset = createTransformation( -(glmd::float32)i, -0.2f );
+
+		boneData.boneIndexMap[ name ] = i;
+		boneData.boneTransform.push_back( bone );
+	}
+
+	return boneData;
+}
+
+/**
+ * The interpolated value of keys at time, found the simple way.
+ */
+template<class T, class Interpolate> T sample(const std::vector< glmd::float64 >& times, const std::vector< T >& keys, glmd::float32 time, Interpolate interpolate)
+{
+	if (keys.size() == 1 || time <= times[0])
+	{
+		return keys[0];
+	}
+
+	for ( glmd::uint32 i=0; i < times.size() - 1; i++ )
+	{
+		if (time < times[i + 1])
+		{
+			const glmd::float32 factor = (time - (glmd::float32)times[i]) / (glmd::float32)(times[i + 1] - times[i]);
+
+			return interpolate( keys[i], keys[i + 1], factor );
+		}
+	}
+
+	return keys.back();
+}
+
+/**
+ * Calculates the bone transformations by walking the tree - the way animations were calculated before skeletons were compiled.
+ */
+void calculateBoneTransformations(
+	std::vector< glm::mat4 >& transformations,
+	const std::map< std::string, glr::glw::AnimatedBoneNode >& animatedBoneNodes,
+	const glr::glw::BoneNode& node,
+	const glr::glw::BoneData& boneData,
+	glmd::float32 time,
+	const glm::mat4& globalInverseTransformation,
+	const glm::mat4& parentTransformation
+)
+{
+	glm::mat4 transformation = node.transformation;
+
+	auto it = animatedBoneNodes.find( node.name );
+	if ( it != animatedBoneNodes.end() )
+	{
+		const auto& abn = it->second;
+
+		auto lerp = [](const glm::vec3& a, const glm::vec3& b, glmd::float32 f) { return a + f * (b - a); };
+		auto slerp = [](const glm::quat& a, const glm::quat& b, glmd::float32 f) { return glm::normalize( glm::slerp(a, b, f) ); };
+
+		const glm::vec3 scaling = sample( abn.scalingTimes, abn.scalings, time, lerp );
+		const glm::quat rotation = sample( abn.rotationTimes, abn.rotations, time, slerp );
+		const glm::vec3 position = sample( abn.positionTimes, abn.positions, time, lerp );
+
+		transformation = glm::translate( glm::mat4(1.0f), position ) * glm::mat4_cast( rotation ) * glm::scale( glm::mat4(1.0f), scaling );
+	}
+
+	const glm::mat4 globalTransformation = parentTransformation * transformation;
+
+	auto boneIt = boneData.boneIndexMap.find( node.name );
+	if ( boneIt != boneData.boneIndexMap.end() )
+	{
+		transformations[ boneIt->second ] = globalInverseTransformation * globalTransformation * boneData.boneTransform[ boneIt->second ].boneOffset;
+	}
+
+	for ( auto& child : node.children )
+	{
+		calculateBoneTransformations( transformations, animatedBoneNodes, child, boneData, time, globalInverseTransformation, globalTransformation );
+	}
+}
+
+void checkClose(const glm::mat4& a, const glm::mat4& b)
+{
+	for (glmd::uint32 i=0; i < 4; i++)
+	{
+		for (glmd::uint32 j=0; j < 4; j++)
+		{
+			BOOST_CHECK_SMALL( a[i][j] - b[i][j], 1e-3f );
+		}
+	}
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(skeleton)
+
+BOOST_AUTO_TEST_CASE(nodesAreInTopologicalOrder)
+{
+	const auto tree = createTree( "n", 4 );
+	const auto skeleton = glr::glw::Skeleton( tree );
+
+	BOOST_REQUIRE_EQUAL( skeleton.getNumberOfNodes(), 15u );
+	BOOST_CHECK_EQUAL( skeleton.getParents()[0], -1 );
+
+	// Depth first order
+	const std::vector< std::string > expected = { "n", "n0", "n00", "n000", "n001", "n01", "n010", "n011", "n1", "n10" };
+	for ( glmd::uint32 i=0; i < expected.size(); i++ )
+	{
+		BOOST_CHECK_EQUAL( skeleton.getNames()[i], expected[i] );
+	}
+
+	for ( glmd::uint32 i=1; i < skeleton.getNumberOfNodes(); i++ )
+	{
+		const glmd::int32 parent = skeleton.getParents()[i];
+
+		BOOST_REQUIRE( parent >= 0 && parent < (glmd::int32)i );
+
+		// Each node's name is its parent's name and one more digit
+		const std::string& name = skeleton.getNames()[i];
+		BOOST_CHECK_EQUAL( name.substr(0, name.size() - 1), skeleton.getNames()[parent] );
+	}
+
+	BOOST_CHECK_EQUAL( skeleton.findNode("n011"), 7 );
+	BOOST_CHECK_EQUAL( skeleton.findNode("missing"), -1 );
+
+	// Copies share the id - it identifies the contents
+	BOOST_CHECK_EQUAL( glr::glw::Skeleton(skeleton).getId(), skeleton.getId() );
+	BOOST_CHECK( glr::glw::Skeleton(tree).getId() != skeleton.getId() );
+}
+
+BOOST_AUTO_TEST_CASE(bindBones)
+{
+	const auto skeleton = glr::glw::Skeleton( createTree("n", 3) );
+
+	auto boneData = createBoneData( skeleton );
+
+	auto bone = glr::glw::Bone();
+	bone.name = "missing";
+	boneData.boneIndexMap[ bone.name ] = boneData.boneTransform.size();
+	boneData.boneTransform.push_back( bone );
+
+	const auto bones = skeleton.bindBones( boneData );
+
+	BOOST_CHECK_EQUAL( bones.numberOfBones, boneData.boneTransform.size() );
+	BOOST_REQUIRE_EQUAL( bones.nodeIndices.size(), boneData.boneTransform.size() - 1 );
+
+	for ( glmd::uint32 i=0; i < bones.nodeIndices.size(); i++ )
+	{
+		const std::string& name = skeleton.getNames()[ bones.nodeIndices[i] ];
+
+		BOOST_CHECK_EQUAL( bones.boneIndices[i], boneData.boneIndexMap.at(name) );
+		BOOST_CHECK( bones.boneOffsets[i] == boneData.boneTransform[ bones.boneIndices[i] ].boneOffset );
+	}
+}
+
+BOOST_AUTO_TEST_CASE(poseMatchesTreeWalk)
+{
+	const auto tree = createTree( "n", 5 );
+	const auto skeleton = glr::glw::Skeleton( tree );
+	const auto boneData = createBoneData( skeleton );
+	const auto bones = skeleton.bindBones( boneData );
+	const glm::mat4 globalInverseTransformation = createTransformation( 3.0f, 0.7f );
+
+	auto animatedBoneNodes = std::map< std::string, glr::glw::AnimatedBoneNode >();
+	createAnimatedBoneNodes( tree, animatedBoneNodes );
+
+	const auto tracks = glr::glw::AnimationTracks( animatedBoneNodes );
+	const auto nodeTracks = tracks.bindNodes( skeleton );
+
+	BOOST_CHECK_EQUAL( tracks.getNumberOfTracks(), animatedBoneNodes.size() );
+
+	for ( glmd::uint32 i=0; i < skeleton.getNumberOfNodes(); i++ )
+	{
+		const std::string& name = skeleton.getNames()[i];
+		BOOST_CHECK_EQUAL( nodeTracks[i] >= 0, name.back() != '1' );
+	}
+
+	// Before the first key, between keys, on a key, and after the last key
+	for ( glmd::float32 time : { -1.0f, 0.0f, 0.3f, 2.0f, 5.7f, 12.5f, 20.0f } )
+	{
+		auto globalTransformations = std::vector< glm::mat4 >( skeleton.getNumberOfNodes() );
+		auto transformations = std::vector< glm::mat4 >( bones.numberOfBones );
+		tracks.calculateGlobalTransformations( globalTransformations, skeleton, nodeTracks, time, 0, 0, globalInverseTransformation );
+		glr::glw::Skeleton::calculateBoneTransformations( transformations, globalTransformations, bones );
+
+		auto expected = std::vector< glm::mat4 >( boneData.boneTransform.size() );
+		calculateBoneTransformations( expected, animatedBoneNodes, tree, boneData, time, globalInverseTransformation, glm::mat4(1.0f) );
+
+		for ( glmd::uint32 i=0; i < expected.size(); i++ )
+		{
+			checkClose( transformations[i], expected[i] );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(poseMatchesTreeWalkWithMixedKeyCounts)
+{
+	const auto tree = createTree( "n", 4 );
+	const auto skeleton = glr::glw::Skeleton( tree );
+	const auto boneData = createBoneData( skeleton );
+	const auto bones = skeleton.bindBones( boneData );
+	const glm::mat4 globalInverseTransformation = createTransformation( 3.0f, 0.7f );
+
+	auto animatedBoneNodes = std::map< std::string, glr::glw::AnimatedBoneNode >();
+	createAnimatedBoneNodes( tree, animatedBoneNodes );
+
+	// Tracks with a single scaling key, or fewer rotation keys - like tracks imported by Assimp - come before tracks that have all of
+	// their channels at the same times, so the channels of the later tracks start at different offsets
+	for ( auto& kv : animatedBoneNodes )
+	{
+		auto& abn = kv.second;
+
+		if (abn.positionTimes.size() > 1 && kv.first.size() % 2 == 1)
+		{
+			abn.scalingTimes.resize( 1 );
+			abn.scalings.resize( 1 );
+		}
+		else if (abn.positionTimes.size() > 1 && kv.first == "n00")
+		{
+			abn.rotationTimes.resize( 3 );
+			abn.rotations.resize( 3 );
+		}
+	}
+
+	const auto tracks = glr::glw::AnimationTracks( animatedBoneNodes );
+	const auto nodeTracks = tracks.bindNodes( skeleton );
+
+	for ( glmd::float32 time : { 0.0f, 0.3f, 2.0f, 5.7f, 12.5f, 20.0f } )
+	{
+		auto globalTransformations = std::vector< glm::mat4 >( skeleton.getNumberOfNodes() );
+		auto transformations = std::vector< glm::mat4 >( bones.numberOfBones );
+		tracks.calculateGlobalTransformations( globalTransformations, skeleton, nodeTracks, time, 0, 0, globalInverseTransformation );
+		glr::glw::Skeleton::calculateBoneTransformations( transformations, globalTransformations, bones );
+
+		auto expected = std::vector< glm::mat4 >( boneData.boneTransform.size() );
+		calculateBoneTransformations( expected, animatedBoneNodes, tree, boneData, time, globalInverseTransformation, glm::mat4(1.0f) );
+
+		for ( glmd::uint32 i=0; i < expected.size(); i++ )
+		{
+			checkClose( transformations[i], expected[i] );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(frameClamping)
+{
+	const auto tree = createTree( "n", 2 );
+	const auto skeleton = glr::glw::Skeleton( tree );
+
+	auto animatedBoneNodes = std::map< std::string, glr::glw::AnimatedBoneNode >();
+	createAnimatedBoneNodes( tree, animatedBoneNodes );
+
+	const auto tracks = glr::glw::AnimationTracks( animatedBoneNodes );
+	const glmd::int32 track = tracks.bindNodes( skeleton )[0];
+	BOOST_REQUIRE( track >= 0 );
+
+	// Keys 2 and 4 are at times 2 and 8 - a time of 7 plays the animation at 2 + fmod(7, 8)
+	glm::mat4 clamped = glm::mat4();
+	glm::mat4 expected = glm::mat4();
+	tracks.calculateLocalTransformation( clamped, track, 7.0f, 2, 4 );
+	tracks.calculateLocalTransformation( expected, track, 9.0f, 0, 0 );
+
+	checkClose( clamped, expected );
+
+	// Frames past the last key (at time 12.5) are clamped to it
+	tracks.calculateLocalTransformation( clamped, track, 14.0f, 2, 100 );
+	tracks.calculateLocalTransformation( expected, track, 3.5f, 0, 0 );
+
+	checkClose( clamped, expected );
+}
+
+BOOST_AUTO_TEST_CASE(bonePalette)
+{
+	const auto tree = createTree( "n", 5 );
+	const auto skeleton = glr::glw::Skeleton( tree );
+	const glm::mat4 globalInverseTransformation = createTransformation( 3.0f, 0.7f );
+
+	// The same bones as the first mesh, but fewer of them and in another order, plus a bone with a different offset and a missing bone
+	const auto boneData = createBoneData( skeleton );
+
+	auto otherBoneData = glr::glw::BoneData();
+	for ( glmd::uint32 i=0; i < 5; i++ )
+	{
+		auto bone = boneData.boneTransform[ boneData.boneTransform.size() - 1 - i ];
+		if (i == 2)
+		{
+			bone.boneOffset = createTransformation( 5.0f, 0.4f );
+		}
+
+		otherBoneData.boneIndexMap[ bone.name ] = i;
+		otherBoneData.boneTransform.push_back( bone );
+	}
+
+	auto bone = glr::glw::Bone();
+	bone.name = "missing";
+	otherBoneData.boneIndexMap[ bone.name ] = otherBoneData.boneTransform.size();
+	otherBoneData.boneTransform.push_back( bone );
+
+	const std::vector< glr::glw::BoneData > meshBoneData = { boneData, otherBoneData, boneData };
+
+	auto meshBones = std::vector< glr::glw::SkeletonBones >();
+	for ( auto& bd : meshBoneData )
+	{
+		meshBones.push_back( skeleton.bindBones(bd) );
+	}
+
+	const auto palette = glr::glw::Skeleton::createPalette( meshBones );
+
+	// The largest meshes use the palette as is - the other mesh needs a slot for its bone with a different offset, and one for its missing bone
+	BOOST_CHECK_EQUAL( palette.numberOfSharedBones, boneData.boneTransform.size() );
+	BOOST_CHECK_EQUAL( palette.bones.numberOfBones, boneData.boneTransform.size() + 2 );
+	BOOST_REQUIRE_EQUAL( palette.remaps.size(), 3u );
+	BOOST_CHECK( palette.remaps[0].empty() );
+	BOOST_CHECK( palette.remaps[2].empty() );
+	BOOST_REQUIRE_EQUAL( palette.remaps[1].size(), otherBoneData.boneTransform.size() );
+
+	auto animatedBoneNodes = std::map< std::string, glr::glw::AnimatedBoneNode >();
+	createAnimatedBoneNodes( tree, animatedBoneNodes );
+
+	const auto tracks = glr::glw::AnimationTracks( animatedBoneNodes );
+	const auto nodeTracks = tracks.bindNodes( skeleton );
+
+	auto globalTransformations = std::vector< glm::mat4 >( skeleton.getNumberOfNodes() );
+	auto paletteTransformations = std::vector< glm::mat4 >( palette.bones.numberOfBones, glm::mat4() );
+	tracks.calculateGlobalTransformations( globalTransformations, skeleton, nodeTracks, 5.7f, 0, 0, globalInverseTransformation );
+	glr::glw::Skeleton::calculateBoneTransformations( paletteTransformations, globalTransformations, palette.bones );
+
+	// Every mesh gets the same bones from the palette as it would calculating them on its own
+	for ( glmd::uint32 m=0; m < meshBoneData.size(); m++ )
+	{
+		auto transformations = std::vector< glm::mat4 >( meshBoneData[m].boneTransform.size() );
+		if ( palette.remaps[m].empty() )
+		{
+			std::copy( paletteTransformations.begin(), paletteTransformations.begin() + transformations.size(), transformations.begin() );
+		}
+		else
+		{
+			glr::glw::Skeleton::remapBoneTransformations( transformations, paletteTransformations, palette.remaps[m] );
+		}
+
+		auto expected = std::vector< glm::mat4 >( meshBoneData[m].boneTransform.size(), glm::mat4() );
+		calculateBoneTransformations( expected, animatedBoneNodes, tree, meshBoneData[m], 5.7f, globalInverseTransformation, glm::mat4(1.0f) );
+
+		for ( glmd::uint32 i=0; i < expected.size(); i++ )
+		{
+			checkClose( transformations[i], expected[i] );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,292 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <algorithm>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "terrain/IFieldFunction.hpp"
+#include "terrain/TerrainEdit.hpp"
+#include "terrain/TerrainSettings.hpp"
+#include "terrain/VoxelChunk.hpp"
+#include "terrain/VoxelChunkNoiseGenerator.hpp"
+#include "terrain/marching_cubes/VoxelChunkMeshGenerator.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const glmd::float32 PLANE_HEIGHT = 0.3f;
+
+/**
+ * A flat, horizontal surface - solid below PLANE_HEIGHT, and air above it.
+ */
+class PlaneFieldFunction : public glr::terrain::IFieldFunction
+{
+public:
+	virtual glmd::float32 getNoise(glmd::float32 x, glmd::float32 y, glmd::float32 z)
+	{
+		return y - PLANE_HEIGHT;
+	}
+};
+
+/**
+ * Returns a full resolution chunk of the plane, in a world that is a single chunk (centered on the origin).
+ */
+glr::terrain::VoxelChunk createPlaneChunk(glmd::int32 stride = 1)
+{
+	auto fieldFunction = PlaneFieldFunction();
+
+	auto chunk = glr::terrain::VoxelChunk(0, 0, 0, stride);
+	glr::terrain::generateNoise(chunk, 1, 1, 1, fieldFunction);
+
+	return chunk;
+}
+
+bool contains(const std::vector<glm::ivec3>& chunks, const glm::ivec3& coordinates)
+{
+	return std::find(chunks.begin(), chunks.end(), coordinates) != chunks.end();
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(terrainEdit)
+
+BOOST_AUTO_TEST_CASE(signedDistance)
+{
+	const auto sphere = glr::terrain::TerrainEdit(glr::terrain::EDIT_SHAPE_SPHERE, glr::terrain::EDIT_OPERATION_REMOVE, glm::vec3(1.0f, 2.0f, 3.0f), glm::vec3(2.0f));
+
+	BOOST_CHECK_CLOSE( sphere.getDistance(glm::vec3(1.0f, 2.0f, 3.0f)), -2.0f, 0.0001f );
+	BOOST_CHECK_SMALL( sphere.getDistance(glm::vec3(1.0f, 4.0f, 3.0f)), 0.0001f );
+	BOOST_CHECK_CLOSE( sphere.getDistance(glm::vec3(6.0f, 2.0f, 3.0f)), 3.0f, 0.0001f );
+	BOOST_CHECK( sphere.getMin() == glm::vec3(-1.0f, 0.0f, 1.0f) );
+	BOOST_CHECK( sphere.getMax() == glm::vec3(3.0f, 4.0f, 5.0f) );
+
+	const auto box = glr::terrain::TerrainEdit(glr::terrain::EDIT_SHAPE_BOX, glr::terrain::EDIT_OPERATION_ADD, glm::vec3(0.0f), glm::vec3(1.0f, 2.0f, 3.0f));
+
+	BOOST_CHECK_CLOSE( box.getDistance(glm::vec3(0.0f)), -1.0f, 0.0001f );
+	BOOST_CHECK_CLOSE( box.getDistance(glm::vec3(0.0f, 1.5f, 0.0f)), -0.5f, 0.0001f );
+	BOOST_CHECK_CLOSE( box.getDistance(glm::vec3(4.0f, 0.0f, 0.0f)), 3.0f, 0.0001f );
+	// Closest to a corner
+	BOOST_CHECK_CLOSE( box.getDistance(glm::vec3(4.0f, 6.0f, 3.0f)), 5.0f, 0.0001f );
+	BOOST_CHECK( box.getMin() == glm::vec3(-1.0f, -2.0f, -3.0f) );
+	BOOST_CHECK( box.getMax() == glm::vec3(1.0f, 2.0f, 3.0f) );
+}
+
+BOOST_AUTO_TEST_CASE(removeOnlyChangesPointsNearTheEdit)
+{
+	const auto original = createPlaneChunk();
+	auto edited = createPlaneChunk();
+
+	const glm::vec3 origin = glr::terrain::getChunkOrigin(0, 0, 0, glm::ivec3(1, 1, 1));
+	BOOST_CHECK( origin == glm::vec3(-8.0f) );
+
+	const glm::vec3 center = glm::vec3(2.0f, 0.0f, -3.0f);
+	const glmd::float32 radius = 3.0f;
+	const auto edit = glr::terrain::TerrainEdit(glr::terrain::EDIT_SHAPE_SPHERE, glr::terrain::EDIT_OPERATION_REMOVE, center, glm::vec3(radius));
+
+	BOOST_CHECK( glr::terrain::applyEdit(edit, edited.points, origin) );
+
+	const glmd::int32 min = edited.points.getMin();
+	const glmd::int32 max = edited.points.getMax();
+
+	for (glmd::int32 x=min; x < max; x++)
+	{
+		for (glmd::int32 y=min; y < max; y++)
+		{
+			for (glmd::int32 z=min; z < max; z++)
+			{
+				const glm::vec3 p = origin + glm::vec3((glmd::float32)x, (glmd::float32)y, (glmd::float32)z);
+				const glmd::float32 distance = glm::length(p - center);
+
+				// Inside the sphere is air now
+				if (distance < radius)
+					BOOST_CHECK( edited.points.get(x, y, z) > 0.0f );
+
+				// Air stays air
+				if (original.points.get(x, y, z) > 0.0f)
+					BOOST_CHECK( edited.points.get(x, y, z) >= original.points.get(x, y, z) );
+
+				// Nothing outside of the edit (plus one point) is touched
+				const glm::vec3 offset = glm::abs(p - center);
+				if (std::max(offset.x, std::max(offset.y, offset.z)) > radius + 1.0f)
+					BOOST_CHECK_EQUAL( edited.points.get(x, y, z), original.points.get(x, y, z) );
+			}
+		}
+	}
+
+	// Digging out air changes nothing
+	const auto airEdit = glr::terrain::TerrainEdit(glr::terrain::EDIT_SHAPE_SPHERE, glr::terrain::EDIT_OPERATION_REMOVE, glm::vec3(0.0f, 6.0f, 0.0f), glm::vec3(1.0f));
+	BOOST_CHECK( !glr::terrain::applyEdit(airEdit, edited.points, origin) );
+
+	// And neither does an edit outside of the chunk
+	const auto farEdit = glr::terrain::TerrainEdit(glr::terrain::EDIT_SHAPE_SPHERE, glr::terrain::EDIT_OPERATION_REMOVE, glm::vec3(100.0f, 0.0f, 0.0f), glm::vec3(4.0f));
+	BOOST_CHECK( !glr::terrain::applyEdit(farEdit, edited.points, origin) );
+}
+
+BOOST_AUTO_TEST_CASE(addFillsTheShapeWithSolidTerrain)
+{
+	auto edited = createPlaneChunk();
+
+	const glm::vec3 origin = glr::terrain::getChunkOrigin(0, 0, 0, glm::ivec3(1, 1, 1));
+	const auto edit = glr::terrain::TerrainEdit(glr::terrain::EDIT_SHAPE_BOX, glr::terrain::EDIT_OPERATION_ADD, glm::vec3(0.0f, 4.0f, 0.0f), glm::vec3(2.0f, 3.0f, 2.0f));
+
+	BOOST_CHECK( glr::terrain::applyEdit(edit, edited.points, origin) );
+
+	// (0, 4, 0) in world coordinates is (8, 12, 8) in the chunk
+	BOOST_CHECK( edited.points.get(8, 12, 8) < 0.0f );
+	BOOST_CHECK( edited.points.get(9, 6, 7) < 0.0f );
+	BOOST_CHECK( edited.points.get(8, 16, 8) > 0.0f );
+	BOOST_CHECK( edited.points.get(12, 12, 8) > 0.0f );
+
+	// Filling solid terrain changes nothing
+	BOOST_CHECK( !glr::terrain::applyEdit(edit, edited.points, origin) );
+}
+
+BOOST_AUTO_TEST_CASE(affectedChunksIncludeNeighbours)
+{
+	const glm::ivec3 dimensions = glm::ivec3(4, 4, 4);
+
+	// Chunk (2, 2, 2) reaches from (0, 0, 0) to (16, 16, 16) in world coordinates
+	BOOST_CHECK( glr::terrain::getChunkOrigin(2, 2, 2, dimensions) == glm::vec3(0.0f) );
+
+	// In the middle of a chunk
+	auto chunks = glr::terrain::getChunksAffectedByEdit( glr::terrain::TerrainEdit(glr::terrain::EDIT_SHAPE_SPHERE, glr::terrain::EDIT_OPERATION_REMOVE, glm::vec3(8.0f), glm::vec3(2.0f)), dimensions );
+	BOOST_REQUIRE_EQUAL( chunks.size(), 1u );
+	BOOST_CHECK( chunks[0] == glm::ivec3(2, 2, 2) );
+
+	// Near the low face of chunk (2, 2, 2) - chunk (1, 2, 2) has those points in its border
+	chunks = glr::terrain::getChunksAffectedByEdit( glr::terrain::TerrainEdit(glr::terrain::EDIT_SHAPE_SPHERE, glr::terrain::EDIT_OPERATION_REMOVE, glm::vec3(3.5f, 8.0f, 8.0f), glm::vec3(1.0f)), dimensions );
+	BOOST_CHECK_EQUAL( chunks.size(), 2u );
+	BOOST_CHECK( contains(chunks, glm::ivec3(1, 2, 2)) );
+	BOOST_CHECK( contains(chunks, glm::ivec3(2, 2, 2)) );
+
+	// On the corner where 8 chunks meet
+	chunks = glr::terrain::getChunksAffectedByEdit( glr::terrain::TerrainEdit(glr::terrain::EDIT_SHAPE_BOX, glr::terrain::EDIT_OPERATION_ADD, glm::vec3(0.0f), glm::vec3(1.0f)), dimensions );
+	BOOST_CHECK_EQUAL( chunks.size(), 8u );
+
+	// Chunks outside of the world are never returned
+	chunks = glr::terrain::getChunksAffectedByEdit( glr::terrain::TerrainEdit(glr::terrain::EDIT_SHAPE_SPHERE, glr::terrain::EDIT_OPERATION_REMOVE, glm::vec3(-32.0f, 8.0f, 8.0f), glm::vec3(2.0f)), dimensions );
+	BOOST_REQUIRE_EQUAL( chunks.size(), 1u );
+	BOOST_CHECK( chunks[0] == glm::ivec3(0, 2, 2) );
+
+	chunks = glr::terrain::getChunksAffectedByEdit( glr::terrain::TerrainEdit(glr::terrain::EDIT_SHAPE_SPHERE, glr::terrain::EDIT_OPERATION_REMOVE, glm::vec3(200.0f), glm::vec3(2.0f)), dimensions );
+	BOOST_CHECK( chunks.empty() );
+}
+
+BOOST_AUTO_TEST_CASE(everyChangedChunkIsAffected)
+{
+	const glm::ivec3 dimensions = glm::ivec3(3, 3, 3);
+	auto fieldFunction = PlaneFieldFunction();
+
+	const auto edits = std::vector<glr::terrain::TerrainEdit>({
+		glr::terrain::TerrainEdit(glr::terrain::EDIT_SHAPE_SPHERE, glr::terrain::EDIT_OPERATION_REMOVE, glm::vec3(-8.0f, 0.0f, 7.5f), glm::vec3(3.0f)),
+		glr::terrain::TerrainEdit(glr::terrain::EDIT_SHAPE_BOX, glr::terrain::EDIT_OPERATION_ADD, glm::vec3(8.5f, -7.0f, -9.0f), glm::vec3(1.0f, 12.0f, 0.5f))
+	});
+
+	for ( auto& edit : edits )
+	{
+		const auto affected = glr::terrain::getChunksAffectedByEdit(edit, dimensions);
+
+		for (glmd::int32 x=0; x < dimensions.x; x++)
+		{
+			for (glmd::int32 y=0; y < dimensions.y; y++)
+			{
+				for (glmd::int32 z=0; z < dimensions.z; z++)
+				{
+					auto chunk = glr::terrain::VoxelChunk(x, y, z);
+					glr::terrain::generateNoise(chunk, dimensions.x, dimensions.y, dimensions.z, fieldFunction);
+
+					if ( glr::terrain::applyEdit(edit, chunk.points, glr::terrain::getChunkOrigin(x, y, z, dimensions)) )
+						BOOST_CHECK( contains(affected, glm::ivec3(x, y, z)) );
+				}
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(editedDensitiesAreDownsampled)
+{
+	auto edited = createPlaneChunk();
+	edited.points.fill(-5.0f);
+
+	const glmd::int32 stride = 4;
+	auto coarse = createPlaneChunk(stride);
+	const auto original = createPlaneChunk(stride);
+
+	glr::terrain::copyEditedDensities(edited.points, coarse);
+
+	const glmd::int32 min = coarse.points.getMin();
+	const glmd::int32 max = coarse.points.getMax();
+
+	for (glmd::int32 x=min; x < max; x++)
+	{
+		for (glmd::int32 y=min; y < max; y++)
+		{
+			for (glmd::int32 z=min; z < max; z++)
+			{
+				// Coarse points that have no full resolution counterpart keep the field function's value
+				if (edited.points.isInBounds(x * stride, y * stride, z * stride))
+					BOOST_CHECK_EQUAL( coarse.points.get(x, y, z), -5.0f );
+				else
+					BOOST_CHECK_EQUAL( coarse.points.get(x, y, z), original.points.get(x, y, z) );
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(editedChunkIsRemeshedAroundTheEdit)
+{
+	auto settings = glr::terrain::TerrainSettings();
+	settings.levelOfDetailSkirts = false;
+
+	auto meshGenerator = glr::terrain::marching_cubes::VoxelChunkMeshGenerator(settings);
+
+	const glm::vec3 origin = glr::terrain::getChunkOrigin(0, 0, 0, glm::ivec3(1, 1, 1));
+	const glm::vec3 center = glm::vec3(0.0f, PLANE_HEIGHT, 0.0f);
+	const glmd::float32 radius = 4.0f;
+
+	auto edited = createPlaneChunk();
+	glr::terrain::applyEdit( glr::terrain::TerrainEdit(glr::terrain::EDIT_SHAPE_SPHERE, glr::terrain::EDIT_OPERATION_REMOVE, center, glm::vec3(radius)), edited.points, origin );
+
+	// The chunk's noise is generated as usual, and the edited values replace it
+	auto chunk = createPlaneChunk();
+	glr::terrain::copyEditedDensities(edited.points, chunk);
+
+	auto vertices = std::vector<glm::vec3>();
+	auto normals = std::vector<glm::vec3>();
+	auto textureBlendingValues = std::vector<glm::vec4>();
+	auto indices = std::vector<glmd::uint32>();
+
+	meshGenerator.generateMesh(chunk, 1, 1, 1, vertices, normals, textureBlendingValues, indices);
+
+	BOOST_REQUIRE( !vertices.empty() );
+
+	bool hasCrater = false;
+
+	for ( auto& v : vertices )
+	{
+		const glmd::float32 distance = glm::length(v - center);
+
+		// The plane is untouched away from the edit
+		if (distance > radius + 1.5f)
+			BOOST_CHECK_SMALL( v.y - PLANE_HEIGHT, 0.01f );
+
+		// And there is a bowl shaped crater where the sphere was
+		if (v.y < PLANE_HEIGHT - 1.0f)
+		{
+			hasCrater = true;
+			BOOST_CHECK_SMALL( distance - radius, 0.5f );
+		}
+	}
+
+	BOOST_CHECK( hasCrater );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,170 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <cmath>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "terrain/IFieldFunction.hpp"
+#include "terrain/TerrainSettings.hpp"
+#include "terrain/VoxelChunk.hpp"
+#include "terrain/VoxelChunkNoiseGenerator.hpp"
+#include "terrain/marching_cubes/VoxelChunkMeshGenerator.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+const glmd::float32 PLANE_HEIGHT = 0.3f;
+
+/**
+ * A flat, horizontal surface - solid below PLANE_HEIGHT, and air above it.
+ */
+class PlaneFieldFunction : public glr::terrain::IFieldFunction
+{
+public:
+	virtual glmd::float32 getNoise(glmd::float32 x, glmd::float32 y, glmd::float32 z)
+	{
+		return y - PLANE_HEIGHT;
+	}
+};
+
+struct Mesh
+{
+	std::vector<glm::vec3> vertices;
+	std::vector<glm::vec3> normals;
+	std::vector<glm::vec4> textureBlendingValues;
+	std::vector<glmd::uint32> indices;
+};
+
+Mesh generateMesh(glmd::int32 stride, bool skirts)
+{
+	auto settings = glr::terrain::TerrainSettings();
+	settings.levelOfDetailSkirts = skirts;
+
+	auto fieldFunction = PlaneFieldFunction();
+	auto meshGenerator = glr::terrain::marching_cubes::VoxelChunkMeshGenerator(settings);
+
+	// A single chunk, centered on the origin
+	auto chunk = glr::terrain::VoxelChunk(0, 0, 0, stride);
+	glr::terrain::generateNoise(chunk, 1, 1, 1, fieldFunction);
+
+	Mesh mesh = Mesh();
+	meshGenerator.generateMesh(chunk, 1, 1, 1, mesh.vertices, mesh.normals, mesh.textureBlendingValues, mesh.indices);
+
+	return mesh;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(terrainLod)
+
+BOOST_AUTO_TEST_CASE(levelOfDetailStride)
+{
+	BOOST_CHECK_EQUAL( glr::terrain::getLevelOfDetailStride(glr::terrain::LOD_HIGHEST), 1 );
+	BOOST_CHECK_EQUAL( glr::terrain::getLevelOfDetailStride(glr::terrain::LOD_HIGH), 2 );
+	BOOST_CHECK_EQUAL( glr::terrain::getLevelOfDetailStride(glr::terrain::LOD_MEDIUM), 4 );
+	BOOST_CHECK_EQUAL( glr::terrain::getLevelOfDetailStride(glr::terrain::LOD_LOW), 8 );
+	BOOST_CHECK_EQUAL( glr::terrain::getLevelOfDetailStride(glr::terrain::LOD_LOWEST), 16 );
+	BOOST_CHECK_EQUAL( glr::terrain::getLevelOfDetailStride(glr::terrain::LOD_UNKNOWN), 1 );
+}
+
+BOOST_AUTO_TEST_CASE(noiseIsSampledAtStride)
+{
+	auto fieldFunction = PlaneFieldFunction();
+
+	auto fullChunk = glr::terrain::VoxelChunk(0, 0, 0);
+	glr::terrain::generateNoise(fullChunk, 1, 1, 1, fieldFunction);
+
+	auto coarseChunk = glr::terrain::VoxelChunk(0, 0, 0, 4);
+	glr::terrain::generateNoise(coarseChunk, 1, 1, 1, fieldFunction);
+
+	BOOST_REQUIRE_EQUAL( coarseChunk.points.getSize(), fullChunk.points.getSize() / 4 );
+
+	for (glmd::int32 y=0; y <= coarseChunk.points.getSize(); y++)
+	{
+		BOOST_CHECK_CLOSE( coarseChunk.points.get(1, y, 2), fullChunk.points.get(4, y * 4, 8), 0.0001f );
+	}
+
+	// The border is measured in coarse steps
+	BOOST_CHECK_CLOSE( coarseChunk.points.get(0, -1, 0), fullChunk.points.get(0, -1, 0) - 3.0f, 0.0001f );
+
+	// Strides bigger than the chunk are clamped
+	auto clampedChunk = glr::terrain::VoxelChunk(0, 0, 0, 64);
+	glr::terrain::generateNoise(clampedChunk, 1, 1, 1, fieldFunction);
+
+	BOOST_CHECK_EQUAL( clampedChunk.stride, fullChunk.points.getSize() );
+	BOOST_CHECK_EQUAL( clampedChunk.points.getSize(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE(lowerLevelsOfDetailHaveFewerTriangles)
+{
+	for (glmd::int32 stride=1; stride <= 16; stride *= 2)
+	{
+		const Mesh mesh = generateMesh(stride, false);
+
+		// Two triangles for each (stride sized) cube that the plane passes through
+		const glmd::uint32 cubesPerSide = 16 / stride;
+		BOOST_CHECK_EQUAL( mesh.indices.size() / 3, 2 * cubesPerSide * cubesPerSide );
+		BOOST_CHECK_EQUAL( mesh.vertices.size(), (cubesPerSide + 1) * (cubesPerSide + 1) );
+
+		for ( auto& v : mesh.vertices )
+		{
+			BOOST_CHECK_SMALL( v.y - PLANE_HEIGHT, 0.01f );
+			BOOST_CHECK( v.x >= -8.0f && v.x <= 8.0f );
+			BOOST_CHECK( v.z >= -8.0f && v.z <= 8.0f );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(skirtsHangBelowChunkFaces)
+{
+	const glmd::int32 stride = 4;
+
+	const Mesh mesh = generateMesh(stride, false);
+	const Mesh skirtedMesh = generateMesh(stride, true);
+
+	// The surface itself doesn't change
+	BOOST_REQUIRE( skirtedMesh.indices.size() > mesh.indices.size() );
+	for (glmd::uint32 i=0; i < mesh.indices.size(); i++)
+	{
+		BOOST_CHECK_EQUAL( skirtedMesh.indices[i], mesh.indices[i] );
+	}
+
+	// One skirt vertex for each vertex on the edge of the plane, and two skirt triangles for each edge of the plane
+	const glmd::uint32 cubesPerSide = 16 / stride;
+	BOOST_CHECK_EQUAL( skirtedMesh.vertices.size() - mesh.vertices.size(), 4 * cubesPerSide );
+	BOOST_CHECK_EQUAL( (skirtedMesh.indices.size() - mesh.indices.size()) / 3, 2 * 4 * cubesPerSide );
+	BOOST_CHECK_EQUAL( skirtedMesh.normals.size(), skirtedMesh.vertices.size() );
+	BOOST_CHECK_EQUAL( skirtedMesh.textureBlendingValues.size(), skirtedMesh.vertices.size() );
+
+	for (glmd::uint32 i=mesh.vertices.size(); i < skirtedMesh.vertices.size(); i++)
+	{
+		const glm::vec3& v = skirtedMesh.vertices[i];
+
+		// Skirts hang into the ground, two (coarse) cubes deep, along the chunk faces
+		BOOST_CHECK_SMALL( v.y - (PLANE_HEIGHT - 2.0f * stride), 0.01f );
+		BOOST_CHECK( std::abs(v.x) == 8.0f || std::abs(v.z) == 8.0f );
+	}
+
+	// Skirt triangles face the same way as the surface next to them (i.e. outwards, away from the chunk)
+	for (glmd::uint32 i=mesh.indices.size(); i < skirtedMesh.indices.size(); i += 3)
+	{
+		const glm::vec3& a = skirtedMesh.vertices[ skirtedMesh.indices[i] ];
+		const glm::vec3& b = skirtedMesh.vertices[ skirtedMesh.indices[i+1] ];
+		const glm::vec3& c = skirtedMesh.vertices[ skirtedMesh.indices[i+2] ];
+
+		const glm::vec3 faceNormal = glm::cross(b - a, c - a);
+		const glm::vec3 center = (a + b + c) / 3.0f;
+
+		BOOST_CHECK( glm::dot(faceNormal, glm::vec3(center.x, 0.0f, center.z)) > 0.0f );
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,176 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "ThreadPool.hpp"
+#include "MpscQueue.hpp"
+
+namespace glmd = glm::detail;
+
+BOOST_AUTO_TEST_SUITE(threadPool)
+
+BOOST_AUTO_TEST_CASE(runsAllJobs)
+{
+	glr::ThreadPool pool(4);
+	std::atomic<glmd::uint32> count(0);
+
+	BOOST_CHECK_EQUAL( pool.getNumberOfThreads(), 4u );
+
+	for (glmd::uint32 i=0; i < 1000; i++)
+	{
+		pool.enqueue(i, 0.0f, [&count] { count++; });
+	}
+
+	pool.waitForAll();
+
+	BOOST_CHECK_EQUAL( count.load(), 1000u );
+	BOOST_CHECK_EQUAL( pool.getNumberOfQueuedJobs(), 0u );
+}
+
+BOOST_AUTO_TEST_CASE(priorityAndCancellation)
+{
+	glr::ThreadPool pool(1);
+
+	std::mutex orderMutex;
+	auto order = std::vector<glmd::uint64>();
+
+	// Block the only worker thread so that the jobs below queue up behind it
+	std::atomic<bool> isBlocked(true);
+	pool.enqueue(100, 0.0f, [&isBlocked] { while (isBlocked) std::this_thread::sleep_for(std::chrono::milliseconds(1)); });
+
+	// Wait for the blocking job to start running
+	while (pool.getNumberOfQueuedJobs() > 0)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	for (glmd::uint64 key=0; key < 5; key++)
+	{
+		pool.enqueue(key, (glmd::float32)(10 - key), [&orderMutex, &order, key] { std::lock_guard<std::mutex> lock(orderMutex); order.push_back(key); });
+	}
+
+	BOOST_CHECK_EQUAL( pool.cancel(2), 1u );
+	BOOST_CHECK_EQUAL( pool.cancel(2), 0u );
+
+	// Reverse the priorities - key 0 should now run first
+	pool.reprioritize( [](glmd::uint64 key) { return (glmd::float32)key; } );
+
+	isBlocked = false;
+	pool.waitForAll();
+
+	BOOST_REQUIRE_EQUAL( order.size(), 4u );
+	BOOST_CHECK_EQUAL( order[0], 0u );
+	BOOST_CHECK_EQUAL( order[1], 1u );
+	BOOST_CHECK_EQUAL( order[2], 3u );
+	BOOST_CHECK_EQUAL( order[3], 4u );
+}
+
+BOOST_AUTO_TEST_CASE(parallelFor)
+{
+	glr::ThreadPool pool(3);
+
+	const glmd::uint32 count = 1003;
+	auto runs = std::vector< std::atomic<glmd::uint32> >(count);
+	for ( auto& r : runs )
+		r = 0;
+
+	// Boost.Test isn't thread safe - the chunks are checked once they have all run
+	std::mutex threadsMutex;
+	auto threads = std::vector<std::thread::id>();
+	std::atomic<bool> isChunkSizeValid(true);
+
+	const glmd::uint32 numberOfChunks = pool.parallelFor(count, 10, [&](glmd::uint32 begin, glmd::uint32 end) {
+		if (begin >= end || end - begin > 10)
+			isChunkSizeValid = false;
+
+		for (glmd::uint32 i=begin; i < end; i++)
+			runs[i]++;
+
+		std::lock_guard<std::mutex> lock(threadsMutex);
+		threads.push_back( std::this_thread::get_id() );
+	});
+
+	BOOST_CHECK( isChunkSizeValid );
+	BOOST_CHECK_EQUAL( numberOfChunks, 101u );
+	BOOST_CHECK_EQUAL( threads.size(), 101u );
+	BOOST_CHECK( std::all_of(runs.begin(), runs.end(), [](const std::atomic<glmd::uint32>& r) { return r == 1; }) );
+
+	// The calling thread runs a chunk too
+	BOOST_CHECK( std::find(threads.begin(), threads.end(), std::this_thread::get_id()) != threads.end() );
+
+	BOOST_CHECK_EQUAL( pool.parallelFor(0, 10, [](glmd::uint32, glmd::uint32) {}), 0u );
+
+	// An exception is rethrown once every chunk has finished
+	std::atomic<glmd::uint32> numberOfItemsRun(0);
+	BOOST_CHECK_THROW( pool.parallelFor(100, 1, [&numberOfItemsRun](glmd::uint32 begin, glmd::uint32 end) {
+		numberOfItemsRun++;
+
+		if (begin == 50)
+			throw std::runtime_error("chunk failed");
+	}), std::runtime_error );
+
+	BOOST_CHECK_EQUAL( numberOfItemsRun.load(), 100u );
+}
+
+BOOST_AUTO_TEST_CASE(mpscQueueMultipleProducers)
+{
+	const glmd::uint32 numberOfProducers = 4;
+	const glmd::uint32 itemsPerProducer = 10000;
+
+	glr::MpscQueue<glmd::uint32> queue;
+	auto producers = std::vector<std::thread>();
+
+	for (glmd::uint32 p=0; p < numberOfProducers; p++)
+	{
+		producers.push_back( std::thread([&queue, p, itemsPerProducer] {
+			for (glmd::uint32 i=0; i < itemsPerProducer; i++)
+				queue.push( p * itemsPerProducer + i );
+		}) );
+	}
+
+	// Consume while the producers are still running
+	auto values = std::vector<glmd::uint32>();
+	auto lastValueFromProducer = std::vector<glmd::int64>(numberOfProducers, -1);
+	bool isInOrder = true;
+
+	while (values.size() < numberOfProducers * itemsPerProducer)
+	{
+		glmd::uint32 value = 0;
+		if (queue.pop(value))
+		{
+			// Items from a single producer must come out in the order they were pushed
+			const glmd::uint32 producer = value / itemsPerProducer;
+			if ((glmd::int64)value <= lastValueFromProducer[producer])
+				isInOrder = false;
+			lastValueFromProducer[producer] = value;
+
+			values.push_back(value);
+		}
+	}
+
+	for ( auto& t : producers )
+		t.join();
+
+	glmd::uint32 value = 0;
+	BOOST_CHECK( !queue.pop(value) );
+	BOOST_CHECK( queue.empty() );
+	BOOST_CHECK( isInOrder );
+
+	std::sort(values.begin(), values.end());
+	BOOST_CHECK( std::unique(values.begin(), values.end()) == values.end() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
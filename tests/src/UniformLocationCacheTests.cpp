@@ -0,0 +1,62 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include "glw/shaders/UniformLocationCache.hpp"
+
+BOOST_AUTO_TEST_SUITE(uniformLocationCache)
+
+BOOST_AUTO_TEST_CASE(uniforms)
+{
+	auto cache = glr::shaders::UniformLocationCache();
+	cache.addUniform( std::string("modelMatrix"), 2 );
+	cache.addUniform( std::string("pvmMatrix"), 3 );
+
+	BOOST_CHECK_EQUAL( cache.getUniformLocation("modelMatrix"), 2 );
+	BOOST_CHECK_EQUAL( cache.getUniformLocation("pvmMatrix"), 3 );
+	BOOST_CHECK_EQUAL( cache.getUniformLocation("viewMatrix"), -1 );
+	BOOST_CHECK_EQUAL( cache.getUniformLocation(""), -1 );
+}
+
+BOOST_AUTO_TEST_CASE(arrayUniforms)
+{
+	auto cache = glr::shaders::UniformLocationCache();
+	cache.addUniform( std::string("weights[0]"), 7 );
+
+	// Like glGetUniformLocation, arrays can be looked up with or without the '[0]'
+	BOOST_CHECK_EQUAL( cache.getUniformLocation("weights[0]"), 7 );
+	BOOST_CHECK_EQUAL( cache.getUniformLocation("weights"), 7 );
+	BOOST_CHECK_EQUAL( cache.getUniformLocation("[0]"), -1 );
+}
+
+BOOST_AUTO_TEST_CASE(uniformBlocks)
+{
+	auto cache = glr::shaders::UniformLocationCache();
+	cache.addUniformBlock( std::string("Lights"), 0 );
+	cache.addUniformBlock( std::string("Bones"), 1 );
+
+	BOOST_CHECK_EQUAL( cache.getUniformBlockIndex("Lights"), 0u );
+	BOOST_CHECK_EQUAL( cache.getUniformBlockIndex("Bones"), 1u );
+	BOOST_CHECK_EQUAL( cache.getUniformBlockIndex("Materials"), GL_INVALID_INDEX );
+
+	// Uniforms and uniform blocks don't share names
+	BOOST_CHECK_EQUAL( cache.getUniformLocation("Lights"), -1 );
+}
+
+BOOST_AUTO_TEST_CASE(clear)
+{
+	auto cache = glr::shaders::UniformLocationCache();
+	cache.addUniform( std::string("modelMatrix"), 2 );
+	cache.addUniformBlock( std::string("Lights"), 0 );
+
+	cache.clear();
+
+	BOOST_CHECK_EQUAL( cache.getUniformLocation("modelMatrix"), -1 );
+	BOOST_CHECK_EQUAL( cache.getUniformBlockIndex("Lights"), GL_INVALID_INDEX );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
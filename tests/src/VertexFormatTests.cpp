@@ -0,0 +1,232 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "glw/VertexFormat.hpp"
+
+#include "exceptions/InvalidArgumentException.hpp"
+
+namespace glmd = glm::detail;
+
+namespace
+{
+
+template<typename T> T read(const std::vector< glmd::uint8 >& vertices, glmd::uint32 offset)
+{
+	T value;
+	std::memcpy(&value, &vertices[offset], sizeof(T));
+	return value;
+}
+
+/**
+ * Sign extends the 10 bit integer at bit shift of value.
+ */
+glmd::int32 unpack10(glmd::uint32 value, glmd::uint32 shift)
+{
+	glmd::int32 component = (glmd::int32)((value >> shift) & 0x3FF);
+	return (component >= 512 ? component - 1024 : component);
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(vertexFormat)
+
+BOOST_AUTO_TEST_CASE(layout)
+{
+	const auto defaultFormat = glr::glw::createDefaultVertexFormat();
+	const auto packedFormat = glr::glw::createPackedVertexFormat();
+
+	BOOST_CHECK_EQUAL( defaultFormat.getStride(), 80 );
+	BOOST_CHECK_EQUAL( packedFormat.getStride(), 44 );
+
+	// Attributes follow each other in the order they were added
+	BOOST_CHECK_EQUAL( packedFormat.getAttribute(glr::glw::VERTEX_ATTRIBUTE_LOCATION_POSITION)->offset, 0 );
+	BOOST_CHECK_EQUAL( packedFormat.getAttribute(glr::glw::VERTEX_ATTRIBUTE_LOCATION_TEXTURE)->offset, 12 );
+	BOOST_CHECK_EQUAL( packedFormat.getAttribute(glr::glw::VERTEX_ATTRIBUTE_LOCATION_NORMAL)->offset, 16 );
+	BOOST_CHECK_EQUAL( packedFormat.getAttribute(glr::glw::VERTEX_ATTRIBUTE_LOCATION_COLOR)->offset, 20 );
+	BOOST_CHECK_EQUAL( packedFormat.getAttribute(glr::glw::VERTEX_ATTRIBUTE_LOCATION_BONE_IDS)->offset, 24 );
+	BOOST_CHECK_EQUAL( packedFormat.getAttribute(glr::glw::VERTEX_ATTRIBUTE_LOCATION_BONE_WEIGHTS)->offset, 28 );
+
+	// Formats for meshes without bones leave out the bone attributes
+	BOOST_CHECK( defaultFormat.isSkinned() );
+	BOOST_CHECK( packedFormat.isSkinned() );
+	BOOST_CHECK( !glr::glw::createDefaultVertexFormat(false).isSkinned() );
+	BOOST_CHECK( !glr::glw::createPackedVertexFormat(false).isSkinned() );
+	BOOST_CHECK_EQUAL( glr::glw::createDefaultVertexFormat(false).getStride(), 48 );
+	BOOST_CHECK_EQUAL( glr::glw::createPackedVertexFormat(false).getStride(), 24 );
+
+	// Attributes are padded to 4 bytes
+	auto format = glr::glw::VertexFormat();
+	format.addAttribute(0, 3, glr::glw::VERTEX_ATTRIBUTE_TYPE_HALF_FLOAT);
+	format.addAttribute(1, 1, glr::glw::VERTEX_ATTRIBUTE_TYPE_UNORM8);
+
+	BOOST_CHECK_EQUAL( format.getAttribute(1)->offset, 8 );
+	BOOST_CHECK_EQUAL( format.getStride(), 12 );
+	BOOST_CHECK( format.getAttribute(2) == nullptr );
+}
+
+BOOST_AUTO_TEST_CASE(invalidAttributes)
+{
+	auto format = glr::glw::VertexFormat();
+	format.addAttribute(0, 3, glr::glw::VERTEX_ATTRIBUTE_TYPE_FLOAT32);
+
+	BOOST_CHECK_THROW( format.addAttribute(0, 2, glr::glw::VERTEX_ATTRIBUTE_TYPE_FLOAT32), glr::exception::InvalidArgumentException );
+	BOOST_CHECK_THROW( format.addAttribute(1, 5, glr::glw::VERTEX_ATTRIBUTE_TYPE_FLOAT32), glr::exception::InvalidArgumentException );
+	BOOST_CHECK_THROW( format.addAttribute(1, 2, glr::glw::VERTEX_ATTRIBUTE_TYPE_INT_2_10_10_10), glr::exception::InvalidArgumentException );
+}
+
+BOOST_AUTO_TEST_CASE(halfFloat)
+{
+	BOOST_CHECK_EQUAL( glr::glw::packHalfFloat(0.0f), 0x0000 );
+	BOOST_CHECK_EQUAL( glr::glw::packHalfFloat(1.0f), 0x3C00 );
+	BOOST_CHECK_EQUAL( glr::glw::packHalfFloat(-2.0f), 0xC000 );
+	BOOST_CHECK_EQUAL( glr::glw::packHalfFloat(65504.0f), 0x7BFF );
+
+	// Too large, and infinity
+	BOOST_CHECK_EQUAL( glr::glw::packHalfFloat(100000.0f), 0x7C00 );
+	BOOST_CHECK_EQUAL( glr::glw::packHalfFloat(-std::numeric_limits<glmd::float32>::infinity()), 0xFC00 );
+
+	// The smallest subnormal, and a value that underflows to zero
+	BOOST_CHECK_EQUAL( glr::glw::packHalfFloat(5.96046448e-8f), 0x0001 );
+	BOOST_CHECK_EQUAL( glr::glw::packHalfFloat(1e-9f), 0x0000 );
+
+	// Rounds to nearest (the spacing of half floats in [1, 2) is 1/1024), with ties going to even
+	BOOST_CHECK_EQUAL( glr::glw::packHalfFloat(1.0f + 0.75f / 1024.0f), 0x3C01 );
+	BOOST_CHECK_EQUAL( glr::glw::packHalfFloat(1.0f + 0.5f / 1024.0f), 0x3C00 );
+	BOOST_CHECK_EQUAL( glr::glw::packHalfFloat(1.0f + 1.5f / 1024.0f), 0x3C02 );
+
+	// Round trips are within half the spacing (a relative error of 2^-11)
+	for (glmd::float32 value = -4.0f; value <= 4.0f; value += 0.01f)
+		BOOST_CHECK( std::fabs(glr::glw::unpackHalfFloat(glr::glw::packHalfFloat(value)) - value) <= std::fabs(value) / 2048.0f + 1e-7f );
+
+	BOOST_CHECK_EQUAL( glr::glw::unpackHalfFloat(0x0001), 5.96046448e-8f );
+	BOOST_CHECK_EQUAL( glr::glw::unpackHalfFloat(0x7C00), std::numeric_limits<glmd::float32>::infinity() );
+}
+
+BOOST_AUTO_TEST_CASE(int2_10_10_10)
+{
+	const glmd::uint32 value = glr::glw::packInt2_10_10_10( glm::vec4(1.0f, -1.0f, 0.5f, 1.0f) );
+
+	BOOST_CHECK_EQUAL( unpack10(value, 0), 511 );
+	BOOST_CHECK_EQUAL( unpack10(value, 10), -511 );
+	BOOST_CHECK_EQUAL( unpack10(value, 20), 256 );
+	BOOST_CHECK_EQUAL( value >> 30, 1 );
+
+	// Out of range components are clamped
+	const glmd::uint32 clamped = glr::glw::packInt2_10_10_10( glm::vec4(2.0f, -3.0f, 0.0f, -1.0f) );
+
+	BOOST_CHECK_EQUAL( unpack10(clamped, 0), 511 );
+	BOOST_CHECK_EQUAL( unpack10(clamped, 10), -511 );
+	BOOST_CHECK_EQUAL( unpack10(clamped, 20), 0 );
+	BOOST_CHECK_EQUAL( clamped >> 30, 3 );
+}
+
+BOOST_AUTO_TEST_CASE(unorm8)
+{
+	BOOST_CHECK_EQUAL( glr::glw::packUnorm8(0.0f), 0 );
+	BOOST_CHECK_EQUAL( glr::glw::packUnorm8(0.5f), 128 );
+	BOOST_CHECK_EQUAL( glr::glw::packUnorm8(1.0f), 255 );
+	BOOST_CHECK_EQUAL( glr::glw::packUnorm8(-1.0f), 0 );
+	BOOST_CHECK_EQUAL( glr::glw::packUnorm8(2.0f), 255 );
+}
+
+BOOST_AUTO_TEST_CASE(interleave)
+{
+	const auto format = glr::glw::createPackedVertexFormat();
+	const glmd::uint32 stride = format.getStride();
+
+	auto positions = std::vector< glm::vec3 >();
+	positions.push_back( glm::vec3(1.0f, 2.0f, 3.0f) );
+	positions.push_back( glm::vec3(4.0f, 5.0f, 6.0f) );
+
+	auto textureCoordinates = std::vector< glm::vec2 >();
+	textureCoordinates.push_back( glm::vec2(0.5f, 0.25f) );
+	textureCoordinates.push_back( glm::vec2(1.0f, 0.0f) );
+
+	auto bones = std::vector< glr::glw::VertexBoneData >( 2 );
+	bones[1].addBoneWeight(7, 0.75f);
+	bones[1].addBoneWeight(200, 0.25f);
+
+	auto vertices = std::vector< glmd::uint8 >( 2 * stride, 0 );
+	format.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_POSITION, positions, vertices);
+	format.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_TEXTURE, textureCoordinates, vertices);
+	format.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_BONE_IDS, glr::glw::VERTEX_ATTRIBUTE_LOCATION_BONE_WEIGHTS, bones, vertices);
+
+	// Colors aren't set, so only one is written - the second vertex keeps its zeros
+	auto colors = std::vector< glm::vec4 >();
+	colors.push_back( glm::vec4(1.0f, 0.0f, 0.5f, 1.0f) );
+	format.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_COLOR, colors, vertices);
+
+	BOOST_CHECK_EQUAL( read<glmd::float32>(vertices, 0), 1.0f );
+	BOOST_CHECK_EQUAL( read<glmd::float32>(vertices, stride + 8), 6.0f );
+
+	BOOST_CHECK_EQUAL( read<glmd::uint16>(vertices, 12), glr::glw::packHalfFloat(0.5f) );
+	BOOST_CHECK_EQUAL( read<glmd::uint16>(vertices, 14), glr::glw::packHalfFloat(0.25f) );
+	BOOST_CHECK_EQUAL( read<glmd::uint16>(vertices, stride + 12), glr::glw::packHalfFloat(1.0f) );
+
+	BOOST_CHECK_EQUAL( vertices[20], 255 );
+	BOOST_CHECK_EQUAL( vertices[22], 128 );
+	BOOST_CHECK_EQUAL( read<glmd::uint32>(vertices, stride + 20), 0 );
+
+	BOOST_CHECK_EQUAL( vertices[stride + 24], 7 );
+	BOOST_CHECK_EQUAL( vertices[stride + 25], 200 );
+	BOOST_CHECK_EQUAL( read<glmd::float32>(vertices, stride + 28), 0.75f );
+	BOOST_CHECK_EQUAL( read<glmd::float32>(vertices, stride + 32), 0.25f );
+}
+
+BOOST_AUTO_TEST_CASE(writeRange)
+{
+	auto format = glr::glw::VertexFormat();
+	format.addAttribute(0, 1, glr::glw::VERTEX_ATTRIBUTE_TYPE_FLOAT32);
+
+	auto values = std::vector< glm::vec2 >();
+	for (glmd::uint32 i=0; i < 5; i++)
+		values.push_back( glm::vec2((glmd::float32)(i + 1), 0.0f) );
+
+	// Only vertices 1 and 2 are written
+	auto vertices = std::vector< glmd::uint8 >( 5 * format.getStride(), 0 );
+	format.write(0, values, vertices, 1, 2);
+
+	BOOST_CHECK_EQUAL( read<glmd::float32>(vertices, 0), 0.0f );
+	BOOST_CHECK_EQUAL( read<glmd::float32>(vertices, 4), 2.0f );
+	BOOST_CHECK_EQUAL( read<glmd::float32>(vertices, 8), 3.0f );
+	BOOST_CHECK_EQUAL( read<glmd::float32>(vertices, 12), 0.0f );
+
+	// A range past the end of the buffer stops at the last vertex
+	format.write(0, values, vertices, 3, 100);
+	BOOST_CHECK_EQUAL( read<glmd::float32>(vertices, 16), 5.0f );
+
+	format.write(0, values, vertices, 10, 100);
+	BOOST_CHECK_EQUAL( read<glmd::float32>(vertices, 16), 5.0f );
+}
+
+BOOST_AUTO_TEST_CASE(boneIdTooLarge)
+{
+	const auto format = glr::glw::createPackedVertexFormat();
+
+	auto bones = std::vector< glr::glw::VertexBoneData >( 1 );
+	bones[0].addBoneWeight(256, 1.0f);
+
+	auto vertices = std::vector< glmd::uint8 >( format.getStride(), 0 );
+
+	BOOST_CHECK_THROW( format.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_BONE_IDS, glr::glw::VERTEX_ATTRIBUTE_LOCATION_BONE_WEIGHTS, bones, vertices), glr::exception::InvalidArgumentException );
+
+	// The default format stores ids as int32
+	const auto defaultFormat = glr::glw::createDefaultVertexFormat();
+	vertices = std::vector< glmd::uint8 >( defaultFormat.getStride(), 0 );
+	defaultFormat.write(glr::glw::VERTEX_ATTRIBUTE_LOCATION_BONE_IDS, glr::glw::VERTEX_ATTRIBUTE_LOCATION_BONE_WEIGHTS, bones, vertices);
+
+	BOOST_CHECK_EQUAL( read<glmd::int32>(vertices, defaultFormat.getAttribute(glr::glw::VERTEX_ATTRIBUTE_LOCATION_BONE_IDS)->offset), 256 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()